@@ -23,6 +23,8 @@
 #include "Config.h"
 #include "ConfigSettings.h"
 #include "TPM2_Shutdown.h"
+#include "Timing.h"
+#include "Crypt.h"
 
 /**
  *	@brief		This function initializes the applications's view and business layers.
@@ -43,6 +45,7 @@ Controller_Initialize(
 	unsigned int unReturnValue = RC_E_FAIL;
 	unsigned int unConsoleMode = CONSOLE_BUFFER_BIG;
 	BOOL fIsHelpSet = FALSE;
+	unsigned int unLoggingAsync = 0;
 
 	// Logging not initialized yet
 
@@ -87,6 +90,19 @@ Controller_Initialize(
 			(TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_HELP, &fIsHelpSet) && TRUE == fIsHelpSet))
 			break;
 
+		// Switch to asynchronous logging if configured, the log file path is final now
+		if (TRUE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOGGING_ASYNC, &unLoggingAsync) && 0 != unLoggingAsync)
+		{
+			unsigned int unReturnValueLogging = Logging_StartAsync();
+			if (RC_SUCCESS != unReturnValueLogging)
+				LOGGING_WRITE_LEVEL1_FMT(L"Error: Starting asynchronous logging failed, continue with synchronous logging (0x%.8X).", unReturnValueLogging);
+		}
+
+		// Building the firmware catalog index and verifying a firmware folder do not access the TPM
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_BUILD_INDEX_PATH) ||
+				TRUE == PropertyStorage_ExistsElement(PROPERTY_VERIFY_FOLDER_PATH))
+			break;
+
 		// Call the device management initialization
 		unReturnValue = DeviceManagement_Initialize();
 		if (RC_SUCCESS != unReturnValue)
@@ -139,6 +155,24 @@ Controller_Uninitialize()
 				break;
 		}
 
+		// Write the timing summary to the log and the timing report to the file given with -timing
+		Timing_LogSummary();
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_TIMING_PATH))
+		{
+			wchar_t wszTimingPath[MAX_STRING_1024] = {0};
+			unsigned int unTimingPathSize = RG_LEN(wszTimingPath);
+
+			if (TRUE == PropertyStorage_GetValueByKey(PROPERTY_TIMING_PATH, wszTimingPath, &unTimingPathSize))
+			{
+				unsigned int unReturnValueTiming = Timing_WriteReport(wszTimingPath);
+				if (RC_SUCCESS != unReturnValueTiming)
+					LOGGING_WRITE_LEVEL1_FMT(L"Error: Writing the timing report failed (0x%.8X).", unReturnValueTiming);
+			}
+		}
+
+		// Release cached verification keys
+		Crypt_Uninitialize();
+
 		// Check if initialized
 		if (TRUE == DeviceManagement_IsInitialized())
 		{
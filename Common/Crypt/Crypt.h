@@ -30,6 +30,33 @@ extern "C" {
 /// Data type for encryption scheme
 typedef UINT16 CRYPT_ENC_SCHEME;
 
+/// Digests calculated by Crypt_ImageDigests in a single pass over a firmware image
+typedef struct tdIfxCryptImageDigests
+{
+	/// CRC-32 over the CRC range
+	unsigned int unCRC;
+	/// SHA-256 over the signed range
+	BYTE rgbSignedHash[SHA256_DIGEST_SIZE];
+	/// SHA-256 over the firmware block range
+	BYTE rgbFirmwareHash[SHA256_DIGEST_SIZE];
+} IfxCryptImageDigests;
+
+/// The ID of the signing key used to create the firmware image signature (RSA_PUB_MODULUS_KEY_ID_0)
+#define SIG_KEY_ID_1 0x0001
+
+/// Message hash and signature to verify with Crypt_VerifySignatureBatch
+typedef struct tdIfxCryptSignatureCheck
+{
+	/// Message hash buffer
+	const BYTE* rgbMessageHash;
+	/// Size of message hash buffer
+	UINT32 unMessageHashSize;
+	/// Signature buffer
+	const BYTE* rgbSignature;
+	/// Size of the signature buffer
+	UINT32 unSignatureSize;
+} IfxCryptSignatureCheck;
+
 /// Public exponent for firmware image signature
 static const BYTE RSA_PUB_EXPONENT_KEY_ID_0[]	= { 0x01, 0x00, 0x01 };
 
@@ -180,34 +207,65 @@ Crypt_EncryptRSA(
 	_Inout_bytecap_(*PpunEncryptedDataSize)		BYTE*				PrgbEncryptedData);
 
 /**
- *	@brief		Verify the given RSA PKCS#1 RSASSA-PSS signature
- *	@details	This function verifies the given RSA PKCS#1 RSASSA-PSS signature with a RSA 2048-bit public key.
+ *	@brief		Verify the given RSA PKCS#1 RSASSA-PSS signature with a cached key
+ *	@details	This function verifies the given RSA PKCS#1 RSASSA-PSS signature with the public key belonging to the
+ *				signature key ID. The key is built once per process and cached until Crypt_Uninitialize is called.
  *
+ *	@param		PusKeyId				Signature key ID
  *	@param		PrgbMessageHash			Message hash buffer
  *	@param		PunMessageHashSize		Size of message hash buffer
  *	@param		PrgbSignature			Signature buffer
  *	@param		PunSignatureSize		Size of the signature buffer
- *	@param		PrgbModulus				Public modulus buffer
- *	@param		PunModulusSize			Size of public modulus buffer
  *
  *	@retval		RC_SUCCESS				The operation completed successfully.
  *	@retval		RC_E_FAIL				An unexpected error occurred during RSA functionality.
- *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. An input parameter is NULL or empty
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. An input parameter is NULL or empty or the key ID is unknown
  *	@retval		RC_E_VERIFY_SIGNATURE	In case the signature is invalid
  */
 _Check_return_
 unsigned int
-Crypt_VerifySignature(
+Crypt_VerifySignatureByKeyId(
+	_In_								UINT16			PusKeyId,
 	_In_bytecount_(PunMessageHashSize)	const BYTE*		PrgbMessageHash,
 	_In_								const UINT32	PunMessageHashSize,
 	_In_bytecount_(PunSignatureSize)	const BYTE*		PrgbSignature,
-	_In_								const UINT32	PunSignatureSize,
-	_In_bytecount_(PunModulusSize)		const BYTE*		PrgbModulus,
-	_In_								const UINT32	PunModulusSize);
+	_In_								const UINT32	PunSignatureSize);
+
+/**
+ *	@brief		Verify several RSA PKCS#1 RSASSA-PSS signatures with the same cached key
+ *	@details	This function looks up the cached public key belonging to the signature key ID and sets up one verification
+ *				context for it. Each entry is then verified with one EVP_PKEY_verify call. The result of each entry is stored
+ *				in PrgunResults.
+ *
+ *	@param		PusKeyId				Signature key ID
+ *	@param		PunCount				Number of entries in PrgsSignatureChecks and PrgunResults
+ *	@param		PrgsSignatureChecks		Message hashes and signatures to verify
+ *	@param		PrgunResults			Receives RC_SUCCESS, RC_E_VERIFY_SIGNATURE, RC_E_BAD_PARAMETER or RC_E_FAIL for each entry
+ *
+ *	@retval		RC_SUCCESS				All entries were processed. Check PrgunResults for the individual results.
+ *	@retval		RC_E_FAIL				An unexpected error occurred during RSA functionality.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. An input parameter is NULL or empty or the key ID is unknown
+ */
+_Check_return_
+unsigned int
+Crypt_VerifySignatureBatch(
+	_In_	UINT16							PusKeyId,
+	_In_	UINT32							PunCount,
+	_In_	const IfxCryptSignatureCheck*	PrgsSignatureChecks,
+	_Out_	unsigned int*					PrgunResults);
+
+/**
+ *	@brief		Release the resources of the cryptography module
+ *	@details	Frees the cached verification keys.
+ */
+void
+Crypt_Uninitialize();
 
 /**
  *	@brief		Calculate the CRC value of the given data stream
- *	@details	The function calculates bitwise a CRC over a data stream
+ *	@details	The function calculates a CRC over a data stream. It uses a carry-less multiplication engine
+ *				(PCLMULQDQ) where the CPU supports it and a slicing-by-8 table engine otherwise. Both engines are
+ *				checked against the bitwise reference calculation by a self-test on first use.
  *
  *	@param		PpInputData			Data stream for CRC calculation
  *	@param		PnInputDataSize		Size if data to calculate the CRC
@@ -224,6 +282,35 @@ Crypt_CRC(
 	_In_							int				PnInputDataSize,
 	_Inout_							unsigned int*	PpunCRC);
 
+/**
+ *	@brief		Calculate the CRC and SHA-256 digests of a firmware image in a single pass
+ *	@details	The function walks the image once in cache sized chunks and feeds each chunk to the CRC engine
+ *				and to two incremental SHA-256 contexts, one per range. The CRC range and the signed range start at
+ *				the beginning of the image, the firmware block range may start at any offset. Empty ranges are allowed.
+ *
+ *	@param		PrgbImage				Firmware image
+ *	@param		PunImageSize			Size of the firmware image in bytes
+ *	@param		PunCrcSize				Number of bytes covered by the CRC
+ *	@param		PunSignedSize			Number of bytes covered by the signed range SHA-256
+ *	@param		PunFirmwareOffset		Offset of the firmware block range
+ *	@param		PunFirmwareSize			Number of bytes covered by the firmware block range SHA-256
+ *	@param		PpsDigests				Receives the calculated digests
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. It was NULL or a range exceeds the image.
+ */
+_Check_return_
+unsigned int
+Crypt_ImageDigests(
+	_In_bytecount_(PunImageSize)	const BYTE*				PrgbImage,
+	_In_							UINT32					PunImageSize,
+	_In_							UINT32					PunCrcSize,
+	_In_							UINT32					PunSignedSize,
+	_In_							UINT32					PunFirmwareOffset,
+	_In_							UINT32					PunFirmwareSize,
+	_Out_							IfxCryptImageDigests*	PpsDigests);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,10 +19,20 @@
 #include "Crypt.h"
 
 #include <string.h>
+#include <pthread.h>
 #include <openssl/hmac.h>
 #include <openssl/rand.h>
 #include <openssl/rsa.h>
 #include <openssl/sha.h>
+#include <openssl/evp.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/param_build.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 #if OPENSSL_VERSION_NUMBER < 0x10100000L
 
@@ -472,104 +482,709 @@ Crypt_EncryptRSA(
 	return unReturnValue;
 }
 
+/// Maximum number of verification keys kept in the key cache
+#define CRYPT_VERIFY_KEY_CACHE_SIZE 4
+
+/// Entry of the verification key cache
+typedef struct tdIfxCryptVerifyKey
+{
+	/// Signature key ID
+	UINT16 usKeyId;
+	/// Public key built from the modulus and exponent belonging to the key ID
+	EVP_PKEY* pKey;
+} IfxCryptVerifyKey;
+
+/// Verification key cache, filled on first use of a key ID
+static IfxCryptVerifyKey s_rgsVerifyKeys[CRYPT_VERIFY_KEY_CACHE_SIZE];
+/// Number of used entries in the verification key cache
+static unsigned int s_unVerifyKeyCount = 0;
+/// Guards the verification key cache
+static pthread_mutex_t s_sVerifyKeyMutex = PTHREAD_MUTEX_INITIALIZER;
+
 /**
- *	@brief		Verify the given RSA PKCS#1 RSASSA-PSS signature
- *	@details	This function verifies the given RSA PKCS#1 RSASSA-PSS signature with a RSA 2048-bit public key.
+ *	@brief		Create an RSA public key object
+ *	@details	Builds an EVP_PKEY from the given big-endian modulus and public exponent.
  *
+ *	@param		PrgbModulus				Public modulus buffer
+ *	@param		PunModulusSize			Size of public modulus buffer
+ *	@param		PrgbExponent			Public exponent buffer
+ *	@param		PunExponentSize			Size of public exponent buffer
+ *	@param		PppKey					Receives the public key object. Must be freed with EVP_PKEY_free.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_FAIL				An unexpected error occurred during RSA functionality.
+ */
+_Check_return_
+static
+unsigned int
+Crypt_CreateRsaPublicKey(
+	_In_bytecount_(PunModulusSize)		const BYTE*		PrgbModulus,
+	_In_								UINT32			PunModulusSize,
+	_In_bytecount_(PunExponentSize)		const BYTE*		PrgbExponent,
+	_In_								UINT32			PunExponentSize,
+	_Out_								EVP_PKEY**		PppKey)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	BIGNUM* pbnModulus = NULL;
+	BIGNUM* pbnExponent = NULL;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	OSSL_PARAM_BLD* pParamBuilder = NULL;
+	OSSL_PARAM* pParams = NULL;
+	EVP_PKEY_CTX* pContext = NULL;
+#else
+	RSA* pRSAPubKey = NULL;
+#endif
+
+	do
+	{
+		*PppKey = NULL;
+
+		pbnModulus = BN_bin2bn(PrgbModulus, PunModulusSize, NULL);
+		pbnExponent = BN_bin2bn(PrgbExponent, PunExponentSize, NULL);
+		if (NULL == pbnModulus || NULL == pbnExponent)
+			break;
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+		pParamBuilder = OSSL_PARAM_BLD_new();
+		if (NULL == pParamBuilder ||
+				1 != OSSL_PARAM_BLD_push_BN(pParamBuilder, OSSL_PKEY_PARAM_RSA_N, pbnModulus) ||
+				1 != OSSL_PARAM_BLD_push_BN(pParamBuilder, OSSL_PKEY_PARAM_RSA_E, pbnExponent))
+			break;
+		pParams = OSSL_PARAM_BLD_to_param(pParamBuilder);
+		if (NULL == pParams)
+			break;
+
+		pContext = EVP_PKEY_CTX_new_from_name(NULL, "RSA", NULL);
+		if (NULL == pContext ||
+				1 != EVP_PKEY_fromdata_init(pContext) ||
+				1 != EVP_PKEY_fromdata(pContext, PppKey, EVP_PKEY_PUBLIC_KEY, pParams))
+			break;
+#else
+		pRSAPubKey = RSA_new();
+		if (NULL == pRSAPubKey)
+			break;
+		RSA_set0_key(pRSAPubKey, pbnModulus, pbnExponent, NULL);
+		// The RSA object owns the BIGNUMs now
+		pbnModulus = NULL;
+		pbnExponent = NULL;
+
+		*PppKey = EVP_PKEY_new();
+		if (NULL == *PppKey || 1 != EVP_PKEY_assign_RSA(*PppKey, pRSAPubKey))
+			break;
+		// The EVP_PKEY owns the RSA object now
+		pRSAPubKey = NULL;
+#endif
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	if (RC_SUCCESS != unReturnValue && NULL != *PppKey)
+	{
+		EVP_PKEY_free(*PppKey);
+		*PppKey = NULL;
+	}
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	EVP_PKEY_CTX_free(pContext);
+	OSSL_PARAM_free(pParams);
+	OSSL_PARAM_BLD_free(pParamBuilder);
+#else
+	if (NULL != pRSAPubKey)
+		RSA_free(pRSAPubKey);
+#endif
+	BN_free(pbnModulus);
+	BN_free(pbnExponent);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Create a RSASSA-PSS verification context
+ *	@details	Creates an EVP_PKEY_CTX for the given public key which verifies SHA-256 RSASSA-PSS signatures
+ *				with a salt of CRYPT_PSS_PADDING_SALT_SIZE bytes. The context can be used for several verifications.
+ *
+ *	@param		PpKey					Public key
+ *	@param		PppContext				Receives the verification context. Must be freed with EVP_PKEY_CTX_free.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_FAIL				An unexpected error occurred during RSA functionality.
+ */
+_Check_return_
+static
+unsigned int
+Crypt_CreatePssVerifyContext(
+	_In_	EVP_PKEY*		PpKey,
+	_Out_	EVP_PKEY_CTX**	PppContext)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		*PppContext = EVP_PKEY_CTX_new(PpKey, NULL);
+		if (NULL == *PppContext)
+			break;
+
+		if (1 != EVP_PKEY_verify_init(*PppContext) ||
+				1 != EVP_PKEY_CTX_set_rsa_padding(*PppContext, RSA_PKCS1_PSS_PADDING) ||
+				1 != EVP_PKEY_CTX_set_signature_md(*PppContext, EVP_sha256()) ||
+				1 != EVP_PKEY_CTX_set_rsa_pss_saltlen(*PppContext, CRYPT_PSS_PADDING_SALT_SIZE))
+		{
+			EVP_PKEY_CTX_free(*PppContext);
+			*PppContext = NULL;
+			break;
+		}
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Verify a signature with a RSASSA-PSS verification context
+ *	@details	Runs a single EVP_PKEY_verify and maps its result to a return code.
+ *
+ *	@param		PpContext				Verification context created by Crypt_CreatePssVerifyContext
+ *	@param		PrgbMessageHash			Message hash buffer
+ *	@param		PunMessageHashSize		Size of message hash buffer
+ *	@param		PrgbSignature			Signature buffer
+ *	@param		PunSignatureSize		Size of the signature buffer
+ *
+ *	@retval		RC_SUCCESS				The signature is valid.
+ *	@retval		RC_E_FAIL				An unexpected error occurred during RSA functionality.
+ *	@retval		RC_E_VERIFY_SIGNATURE	In case the signature is invalid
+ */
+_Check_return_
+static
+unsigned int
+Crypt_VerifyPss(
+	_In_								EVP_PKEY_CTX*	PpContext,
+	_In_bytecount_(PunMessageHashSize)	const BYTE*		PrgbMessageHash,
+	_In_								UINT32			PunMessageHashSize,
+	_In_bytecount_(PunSignatureSize)	const BYTE*		PrgbSignature,
+	_In_								UINT32			PunSignatureSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	int nResult = EVP_PKEY_verify(PpContext, PrgbSignature, PunSignatureSize, PrgbMessageHash, PunMessageHashSize);
+
+	if (1 == nResult)
+		unReturnValue = RC_SUCCESS;
+	else if (0 == nResult)
+		unReturnValue = RC_E_VERIFY_SIGNATURE;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Get the cached public key for a signature key ID
+ *	@details	Builds the public key on first use of the key ID and keeps it until Crypt_Uninitialize is called.
+ *
+ *	@param		PusKeyId				Signature key ID
+ *	@param		PppKey					Receives the cached public key. Must not be freed by the caller.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_FAIL				An unexpected error occurred during RSA functionality.
+ *	@retval		RC_E_BAD_PARAMETER		The key ID is unknown.
+ */
+_Check_return_
+static
+unsigned int
+Crypt_GetVerifyKey(
+	_In_	UINT16		PusKeyId,
+	_Out_	EVP_PKEY**	PppKey)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned int unIndex = 0;
+	BOOL fLocked = FALSE;
+
+	do
+	{
+		*PppKey = NULL;
+		if (0 != pthread_mutex_lock(&s_sVerifyKeyMutex))
+			break;
+		fLocked = TRUE;
+
+		for (unIndex = 0; unIndex < s_unVerifyKeyCount; unIndex++)
+		{
+			if (PusKeyId == s_rgsVerifyKeys[unIndex].usKeyId)
+			{
+				*PppKey = s_rgsVerifyKeys[unIndex].pKey;
+				break;
+			}
+		}
+		if (NULL != *PppKey)
+		{
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+
+		if (SIG_KEY_ID_1 != PusKeyId)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		if (s_unVerifyKeyCount >= RG_LEN(s_rgsVerifyKeys))
+			break;
+
+		unReturnValue = Crypt_CreateRsaPublicKey(RSA_PUB_MODULUS_KEY_ID_0, sizeof(RSA_PUB_MODULUS_KEY_ID_0), RSA_PUB_EXPONENT_KEY_ID_0, sizeof(RSA_PUB_EXPONENT_KEY_ID_0), PppKey);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		s_rgsVerifyKeys[s_unVerifyKeyCount].usKeyId = PusKeyId;
+		s_rgsVerifyKeys[s_unVerifyKeyCount].pKey = *PppKey;
+		s_unVerifyKeyCount++;
+	}
+	WHILE_FALSE_END;
+
+	if (fLocked)
+		IGNORE_RETURN_VALUE(pthread_mutex_unlock(&s_sVerifyKeyMutex));
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Verify the given RSA PKCS#1 RSASSA-PSS signature with a cached key
+ *	@details	This function verifies the given RSA PKCS#1 RSASSA-PSS signature with the public key belonging to the
+ *				signature key ID. The key is built once per process and cached until Crypt_Uninitialize is called.
+ *
+ *	@param		PusKeyId				Signature key ID
  *	@param		PrgbMessageHash			Message hash buffer
  *	@param		PunMessageHashSize		Size of message hash buffer
  *	@param		PrgbSignature			Signature buffer
  *	@param		PunSignatureSize		Size of the signature buffer
- *	@param		PrgbModulus				Public modulus buffer
- *	@param		PunModulusSize			Size of public modulus buffer
  *
  *	@retval		RC_SUCCESS				The operation completed successfully.
  *	@retval		RC_E_FAIL				An unexpected error occurred during RSA functionality.
- *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. An input parameter is NULL or empty
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. An input parameter is NULL or empty or the key ID is unknown
  *	@retval		RC_E_VERIFY_SIGNATURE	In case the signature is invalid
  */
 _Check_return_
 unsigned int
-Crypt_VerifySignature(
+Crypt_VerifySignatureByKeyId(
+	_In_								UINT16			PusKeyId,
 	_In_bytecount_(PunMessageHashSize)	const BYTE*		PrgbMessageHash,
 	_In_								const UINT32	PunMessageHashSize,
 	_In_bytecount_(PunSignatureSize)	const BYTE*		PrgbSignature,
-	_In_								const UINT32	PunSignatureSize,
-	_In_bytecount_(PunModulusSize)		const BYTE*		PrgbModulus,
-	_In_								const UINT32	PunModulusSize)
+	_In_								const UINT32	PunSignatureSize)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
-	RSA* pRSAPubKey = NULL;
-	BIGNUM* pbnModulus = NULL;
-	BIGNUM* pbnExponent = NULL;
+	EVP_PKEY_CTX* pContext = NULL;
 
 	do
 	{
+		EVP_PKEY* pKey = NULL;
+
 		// Check input parameters
 		if (NULL == PrgbMessageHash || 0 == PunMessageHashSize ||
-				NULL == PrgbSignature || 0 == PunSignatureSize ||
-				NULL == PrgbModulus || 0 == PunModulusSize)
+				NULL == PrgbSignature || 0 == PunSignatureSize)
 		{
 			unReturnValue = RC_E_BAD_PARAMETER;
 			break;
 		}
 
-		// Initialize RSA Public Key object
-		pRSAPubKey = RSA_new();
-		if (NULL == pRSAPubKey)
+		// Get the cached public key object
+		unReturnValue = Crypt_GetVerifyKey(PusKeyId, &pKey);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = Crypt_CreatePssVerifyContext(pKey, &pContext);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		// Verify the signature
+		unReturnValue = Crypt_VerifyPss(pContext, PrgbMessageHash, PunMessageHashSize, PrgbSignature, PunSignatureSize);
+	}
+	WHILE_FALSE_END;
+
+	// Free the verification context, the public key object stays cached
+	EVP_PKEY_CTX_free(pContext);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Verify several RSA PKCS#1 RSASSA-PSS signatures with the same cached key
+ *	@details	This function looks up the cached public key belonging to the signature key ID and sets up one verification
+ *				context for it. Each entry is then verified with one EVP_PKEY_verify call. The result of each entry is stored
+ *				in PrgunResults.
+ *
+ *	@param		PusKeyId				Signature key ID
+ *	@param		PunCount				Number of entries in PrgsSignatureChecks and PrgunResults
+ *	@param		PrgsSignatureChecks		Message hashes and signatures to verify
+ *	@param		PrgunResults			Receives RC_SUCCESS, RC_E_VERIFY_SIGNATURE, RC_E_BAD_PARAMETER or RC_E_FAIL for each entry
+ *
+ *	@retval		RC_SUCCESS				All entries were processed. Check PrgunResults for the individual results.
+ *	@retval		RC_E_FAIL				An unexpected error occurred during RSA functionality.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. An input parameter is NULL or empty or the key ID is unknown
+ */
+_Check_return_
+unsigned int
+Crypt_VerifySignatureBatch(
+	_In_	UINT16							PusKeyId,
+	_In_	UINT32							PunCount,
+	_In_	const IfxCryptSignatureCheck*	PrgsSignatureChecks,
+	_Out_	unsigned int*					PrgunResults)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	EVP_PKEY_CTX* pContext = NULL;
+
+	do
+	{
+		EVP_PKEY* pKey = NULL;
+		UINT32 unIndex = 0;
+
+		// Check input parameters
+		if (0 == PunCount || NULL == PrgsSignatureChecks || NULL == PrgunResults)
 		{
-			unReturnValue = RC_E_FAIL;
+			unReturnValue = RC_E_BAD_PARAMETER;
 			break;
 		}
 
-		pbnModulus = BN_bin2bn(PrgbModulus, PunModulusSize, pbnModulus);
-		if (NULL == pbnModulus)
-		{
-			unReturnValue = RC_E_FAIL;
+		// Get the cached public key object and set up the verification context once for all entries
+		unReturnValue = Crypt_GetVerifyKey(PusKeyId, &pKey);
+		if (RC_SUCCESS != unReturnValue)
 			break;
+
+		unReturnValue = Crypt_CreatePssVerifyContext(pKey, &pContext);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		// Verify the signatures
+		for (unIndex = 0; unIndex < PunCount; unIndex++)
+		{
+			const IfxCryptSignatureCheck* pCheck = &PrgsSignatureChecks[unIndex];
+			if (NULL == pCheck->rgbMessageHash || 0 == pCheck->unMessageHashSize ||
+					NULL == pCheck->rgbSignature || 0 == pCheck->unSignatureSize)
+				PrgunResults[unIndex] = RC_E_BAD_PARAMETER;
+			else
+				PrgunResults[unIndex] = Crypt_VerifyPss(pContext, pCheck->rgbMessageHash, pCheck->unMessageHashSize, pCheck->rgbSignature, pCheck->unSignatureSize);
 		}
+	}
+	WHILE_FALSE_END;
 
-		pbnExponent = BN_bin2bn(RSA_PUB_EXPONENT_KEY_ID_0, sizeof(RSA_PUB_EXPONENT_KEY_ID_0), pbnExponent);
-		if (NULL == pbnExponent)
+	// Free the verification context, the public key object stays cached
+	EVP_PKEY_CTX_free(pContext);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Release the resources of the cryptography module
+ *	@details	Frees the cached verification keys.
+ */
+void
+Crypt_Uninitialize()
+{
+	unsigned int unIndex = 0;
+
+	if (0 == pthread_mutex_lock(&s_sVerifyKeyMutex))
+	{
+		for (unIndex = 0; unIndex < s_unVerifyKeyCount; unIndex++)
 		{
-			BN_free(pbnModulus);
-			unReturnValue = RC_E_FAIL;
-			break;
+			EVP_PKEY_free(s_rgsVerifyKeys[unIndex].pKey);
+			s_rgsVerifyKeys[unIndex].pKey = NULL;
 		}
-		RSA_set0_key(pRSAPubKey, pbnModulus, pbnExponent, NULL);
+		s_unVerifyKeyCount = 0;
+		IGNORE_RETURN_VALUE(pthread_mutex_unlock(&s_sVerifyKeyMutex));
+	}
+}
+
+/// Number of lookup tables used by the slicing-by-8 CRC engine
+#define CRC32_SLICES 8
+/// Minimum number of bytes processed by the carry-less multiplication engine
+#define CRC32_CLMUL_MINIMUM_SIZE 64
+/// Chunk size used by Crypt_ImageDigests to keep each chunk cache resident while it is processed
+#define CRYPT_DIGEST_CHUNK_SIZE (32 * 1024)
 
+/// CRC engine function type; operates on the (non inverted) CRC register
+typedef unsigned int (*PFN_CRYPT_CRC_UPDATE)(unsigned int, const BYTE*, unsigned int);
+
+/// Slicing-by-8 lookup tables
+static unsigned int s_rgunCrcTable[CRC32_SLICES][256];
+/// CRC engine selected by Crypt_CrcInitialize
+static PFN_CRYPT_CRC_UPDATE s_pfnCrcUpdate = NULL;
+/// Guards the one time initialization of the CRC engine
+static pthread_once_t s_sCrcInitOnce = PTHREAD_ONCE_INIT;
+
+/**
+ *	@brief		Bitwise reference CRC engine
+ *	@details	Processes one bit per step. Used as reference for the self-test and as fallback.
+ *
+ *	@param		PunCRC				Current CRC register value
+ *	@param		PrgbData			Data stream
+ *	@param		PunSize				Size of the data stream
+ *
+ *	@returns	The updated CRC register value
+ */
+static
+unsigned int
+Crypt_CrcUpdateBitwise(
+	_In_						unsigned int	PunCRC,
+	_In_bytecount_(PunSize)		const BYTE*		PrgbData,
+	_In_						unsigned int	PunSize)
+{
+	while (PunSize-- != 0)
+	{
+		int nIndex = 0;
+		PunCRC ^= *PrgbData++;
+		for (; nIndex < 8; nIndex++)
 		{
-			BYTE prgbDecryptedDigest[sizeof(RSA_PUB_MODULUS_KEY_ID_0)] = {0};
-			int nReturnValue = -1;
-			nReturnValue = RSA_public_decrypt(PunSignatureSize, PrgbSignature, prgbDecryptedDigest, pRSAPubKey, RSA_NO_PADDING);
-			if (-1 == nReturnValue)
-			{
-				unReturnValue = RC_E_FAIL;
-				break;
-			}
+			PunCRC = (PunCRC >> 1) ^ (-((int)(PunCRC & 1)) & CRC32MASKREV);
+		}
+	}
 
-			// Verify the signature
-			if (1 != RSA_verify_PKCS1_PSS(pRSAPubKey, PrgbMessageHash, EVP_sha256(), prgbDecryptedDigest, CRYPT_PSS_PADDING_SALT_SIZE))
-			{
-				unReturnValue = RC_E_VERIFY_SIGNATURE;
-				break;
-			}
+	return PunCRC;
+}
+
+/**
+ *	@brief		Table driven slicing-by-8 CRC engine
+ *	@details	Processes eight bytes per step using the lookup tables built by Crypt_CrcInitialize.
+ *
+ *	@param		PunCRC				Current CRC register value
+ *	@param		PrgbData			Data stream
+ *	@param		PunSize				Size of the data stream
+ *
+ *	@returns	The updated CRC register value
+ */
+static
+unsigned int
+Crypt_CrcUpdateSlicingBy8(
+	_In_						unsigned int	PunCRC,
+	_In_bytecount_(PunSize)		const BYTE*		PrgbData,
+	_In_						unsigned int	PunSize)
+{
+	while (PunSize >= CRC32_SLICES)
+	{
+		// Assemble the words byte by byte to stay independent of alignment and endianness
+		unsigned int unLow = PunCRC ^ ((unsigned int)PrgbData[0] | ((unsigned int)PrgbData[1] << 8) |
+						((unsigned int)PrgbData[2] << 16) | ((unsigned int)PrgbData[3] << 24));
+		unsigned int unHigh = (unsigned int)PrgbData[4] | ((unsigned int)PrgbData[5] << 8) |
+						((unsigned int)PrgbData[6] << 16) | ((unsigned int)PrgbData[7] << 24);
+
+		PunCRC = s_rgunCrcTable[7][unLow & 0xFF] ^
+				s_rgunCrcTable[6][(unLow >> 8) & 0xFF] ^
+				s_rgunCrcTable[5][(unLow >> 16) & 0xFF] ^
+				s_rgunCrcTable[4][unLow >> 24] ^
+				s_rgunCrcTable[3][unHigh & 0xFF] ^
+				s_rgunCrcTable[2][(unHigh >> 8) & 0xFF] ^
+				s_rgunCrcTable[1][(unHigh >> 16) & 0xFF] ^
+				s_rgunCrcTable[0][unHigh >> 24];
+
+		PrgbData += CRC32_SLICES;
+		PunSize -= CRC32_SLICES;
+	}
+
+	while (PunSize-- != 0)
+	{
+		PunCRC = (PunCRC >> 8) ^ s_rgunCrcTable[0][(PunCRC ^ *PrgbData++) & 0xFF];
+	}
+
+	return PunCRC;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ *	@brief		Carry-less multiplication (PCLMULQDQ) CRC engine
+ *	@details	Folds the data stream in 64 byte blocks into four 128 bit accumulators and reduces
+ *				them with a Barrett reduction. The remainder which is not a multiple of 16 bytes is
+ *				handed to the slicing-by-8 engine. Streams shorter than CRC32_CLMUL_MINIMUM_SIZE
+ *				are processed by the slicing-by-8 engine only.
+ *
+ *	@param		PunCRC				Current CRC register value
+ *	@param		PrgbData			Data stream
+ *	@param		PunSize				Size of the data stream
+ *
+ *	@returns	The updated CRC register value
+ */
+__attribute__((target("pclmul,sse4.1")))
+static
+unsigned int
+Crypt_CrcUpdateClmul(
+	_In_						unsigned int	PunCRC,
+	_In_bytecount_(PunSize)		const BYTE*		PrgbData,
+	_In_						unsigned int	PunSize)
+{
+	if (PunSize >= CRC32_CLMUL_MINIMUM_SIZE)
+	{
+		// Folding constants x^(4*128+32) mod P, x^(4*128-32) mod P, x^(128+32) mod P, x^(128-32) mod P, x^64 mod P (bit reflected)
+		const __m128i sK1K2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+		const __m128i sK3K4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+		const __m128i sK5K0 = _mm_set_epi64x(0x0000000000LL, 0x0163cd6124LL);
+		// Bit reflected polynomial P and Barrett constant mu
+		const __m128i sPoly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+		const __m128i sMask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+		unsigned int unBulkSize = PunSize & ~15U;
+		__m128i sX1, sX2, sX3, sX4, sX5, sX6, sX7, sX8;
+
+		PunSize -= unBulkSize;
+
+		sX1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(PrgbData + 0x00)), _mm_cvtsi32_si128((int)PunCRC));
+		sX2 = _mm_loadu_si128((const __m128i*)(PrgbData + 0x10));
+		sX3 = _mm_loadu_si128((const __m128i*)(PrgbData + 0x20));
+		sX4 = _mm_loadu_si128((const __m128i*)(PrgbData + 0x30));
+		PrgbData += 64;
+		unBulkSize -= 64;
+
+		// Fold 64 bytes per step
+		while (unBulkSize >= 64)
+		{
+			sX5 = _mm_clmulepi64_si128(sX1, sK1K2, 0x00);
+			sX6 = _mm_clmulepi64_si128(sX2, sK1K2, 0x00);
+			sX7 = _mm_clmulepi64_si128(sX3, sK1K2, 0x00);
+			sX8 = _mm_clmulepi64_si128(sX4, sK1K2, 0x00);
+
+			sX1 = _mm_clmulepi64_si128(sX1, sK1K2, 0x11);
+			sX2 = _mm_clmulepi64_si128(sX2, sK1K2, 0x11);
+			sX3 = _mm_clmulepi64_si128(sX3, sK1K2, 0x11);
+			sX4 = _mm_clmulepi64_si128(sX4, sK1K2, 0x11);
+
+			sX1 = _mm_xor_si128(_mm_xor_si128(sX1, sX5), _mm_loadu_si128((const __m128i*)(PrgbData + 0x00)));
+			sX2 = _mm_xor_si128(_mm_xor_si128(sX2, sX6), _mm_loadu_si128((const __m128i*)(PrgbData + 0x10)));
+			sX3 = _mm_xor_si128(_mm_xor_si128(sX3, sX7), _mm_loadu_si128((const __m128i*)(PrgbData + 0x20)));
+			sX4 = _mm_xor_si128(_mm_xor_si128(sX4, sX8), _mm_loadu_si128((const __m128i*)(PrgbData + 0x30)));
+
+			PrgbData += 64;
+			unBulkSize -= 64;
 		}
 
-		unReturnValue = RC_SUCCESS;
+		// Fold the four accumulators into one
+		sX5 = _mm_clmulepi64_si128(sX1, sK3K4, 0x00);
+		sX1 = _mm_clmulepi64_si128(sX1, sK3K4, 0x11);
+		sX1 = _mm_xor_si128(_mm_xor_si128(sX1, sX2), sX5);
+
+		sX5 = _mm_clmulepi64_si128(sX1, sK3K4, 0x00);
+		sX1 = _mm_clmulepi64_si128(sX1, sK3K4, 0x11);
+		sX1 = _mm_xor_si128(_mm_xor_si128(sX1, sX3), sX5);
+
+		sX5 = _mm_clmulepi64_si128(sX1, sK3K4, 0x00);
+		sX1 = _mm_clmulepi64_si128(sX1, sK3K4, 0x11);
+		sX1 = _mm_xor_si128(_mm_xor_si128(sX1, sX4), sX5);
+
+		// Fold the remaining 16 byte blocks
+		while (unBulkSize >= 16)
+		{
+			sX2 = _mm_loadu_si128((const __m128i*)PrgbData);
+			sX5 = _mm_clmulepi64_si128(sX1, sK3K4, 0x00);
+			sX1 = _mm_clmulepi64_si128(sX1, sK3K4, 0x11);
+			sX1 = _mm_xor_si128(_mm_xor_si128(sX1, sX2), sX5);
+			PrgbData += 16;
+			unBulkSize -= 16;
+		}
+
+		// Fold 128 bits to 64 bits
+		sX2 = _mm_clmulepi64_si128(sX1, sK3K4, 0x10);
+		sX3 = sMask32;
+		sX1 = _mm_srli_si128(sX1, 8);
+		sX1 = _mm_xor_si128(sX1, sX2);
+
+		sX2 = _mm_srli_si128(sX1, 4);
+		sX1 = _mm_and_si128(sX1, sX3);
+		sX1 = _mm_clmulepi64_si128(sX1, sK5K0, 0x00);
+		sX1 = _mm_xor_si128(sX1, sX2);
+
+		// Barrett reduction to 32 bits
+		sX2 = _mm_and_si128(sX1, sX3);
+		sX2 = _mm_clmulepi64_si128(sX2, sPoly, 0x10);
+		sX2 = _mm_and_si128(sX2, sX3);
+		sX2 = _mm_clmulepi64_si128(sX2, sPoly, 0x00);
+		sX1 = _mm_xor_si128(sX1, sX2);
+
+		PunCRC = (unsigned int)_mm_extract_epi32(sX1, 1);
 	}
-	WHILE_FALSE_END;
 
-	// Free RSA object and its components (BIGNUM)
-	if (NULL != pRSAPubKey)
-		RSA_free(pRSAPubKey);
+	return Crypt_CrcUpdateSlicingBy8(PunCRC, PrgbData, PunSize);
+}
+#endif /* defined(__x86_64__) || defined(__i386__) */
 
-	return unReturnValue;
+/**
+ *	@brief		Verify a CRC engine against the bitwise reference engine
+ *	@details	Compares the results over a pseudo random data stream for several sizes and alignments,
+ *				including sizes around the block boundaries of the optimized engines.
+ *
+ *	@param		PfnCrcUpdate		CRC engine to check
+ *
+ *	@retval		TRUE				The engine calculates bit-identical results.
+ *	@retval		FALSE				Otherwise.
+ */
+static
+BOOL
+Crypt_CrcSelfTest(
+	_In_	PFN_CRYPT_CRC_UPDATE	PfnCrcUpdate)
+{
+	const BYTE rgbCheck[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+	const unsigned int rgunSizes[] = { 1, 7, 8, 9, 15, 16, 17, 63, 64, 65, 79, 127, 128, 129, 191, 255, 256, 1000, 2048 };
+	BYTE rgbData[2048 + 16];
+	unsigned int unSeed = 0x12345678;
+	unsigned int unIndex = 0;
+	BOOL fResult = TRUE;
+
+	// Standard check value of the CRC-32 polynomial
+	if (0xCBF43926 != ~PfnCrcUpdate(~0U, rgbCheck, sizeof(rgbCheck)))
+		fResult = FALSE;
+
+	for (unIndex = 0; unIndex < sizeof(rgbData); unIndex++)
+	{
+		unSeed = unSeed * 1103515245 + 12345;
+		rgbData[unIndex] = (BYTE)(unSeed >> 16);
+	}
+
+	for (unIndex = 0; unIndex < RG_LEN(rgunSizes) && fResult; unIndex++)
+	{
+		unsigned int unOffset = 0;
+		for (; unOffset < 16 && fResult; unOffset += 5)
+		{
+			if (Crypt_CrcUpdateBitwise(unSeed, rgbData + unOffset, rgunSizes[unIndex]) !=
+					PfnCrcUpdate(unSeed, rgbData + unOffset, rgunSizes[unIndex]))
+				fResult = FALSE;
+		}
+	}
+
+	return fResult;
+}
+
+/**
+ *	@brief		Initialize the CRC engine
+ *	@details	Builds the slicing-by-8 lookup tables and selects the fastest engine supported by the CPU
+ *				which passes the self-test. Falls back to the bitwise engine otherwise.
+ */
+static
+void
+Crypt_CrcInitialize()
+{
+	unsigned int unIndex = 0;
+
+	for (unIndex = 0; unIndex < 256; unIndex++)
+	{
+		BYTE bValue = (BYTE)unIndex;
+		s_rgunCrcTable[0][unIndex] = Crypt_CrcUpdateBitwise(0, &bValue, 1);
+	}
+	for (unIndex = 0; unIndex < 256; unIndex++)
+	{
+		unsigned int unSlice = 1;
+		for (; unSlice < CRC32_SLICES; unSlice++)
+		{
+			unsigned int unPrevious = s_rgunCrcTable[unSlice - 1][unIndex];
+			s_rgunCrcTable[unSlice][unIndex] = (unPrevious >> 8) ^ s_rgunCrcTable[0][unPrevious & 0xFF];
+		}
+	}
+
+	s_pfnCrcUpdate = Crypt_CrcUpdateBitwise;
+	if (Crypt_CrcSelfTest(Crypt_CrcUpdateSlicingBy8))
+		s_pfnCrcUpdate = Crypt_CrcUpdateSlicingBy8;
+#if defined(__x86_64__) || defined(__i386__)
+	if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1") &&
+			Crypt_CrcUpdateSlicingBy8 == s_pfnCrcUpdate &&
+			Crypt_CrcSelfTest(Crypt_CrcUpdateClmul))
+		s_pfnCrcUpdate = Crypt_CrcUpdateClmul;
+#endif
 }
 
 /**
  *	@brief		Calculate the CRC value of the given data stream
- *	@details	The function calculates bitwise a CRC over a data stream
+ *	@details	The function calculates a CRC over a data stream. It uses a carry-less multiplication engine
+ *				(PCLMULQDQ) where the CPU supports it and a slicing-by-8 table engine otherwise. Both engines are
+ *				checked against the bitwise reference calculation by a self-test on first use.
  *
  *	@param		PpInputData			Data stream for CRC calculation
  *	@param		PnInputDataSize		Size if data to calculate the CRC
@@ -603,21 +1218,130 @@ Crypt_CRC(
 		}
 
 		// Calculate CRC value
+		if (0 != pthread_once(&s_sCrcInitOnce, Crypt_CrcInitialize))
+			break;
 		unCRC = ~(*PpunCRC);
-		while (PnInputDataSize-- != 0)
+		unCRC = s_pfnCrcUpdate(unCRC, pbInputData, (unsigned int)PnInputDataSize);
+
+		*PpunCRC = ~unCRC;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Calculate the CRC and SHA-256 digests of a firmware image in a single pass
+ *	@details	The function walks the image once in cache sized chunks and feeds each chunk to the CRC engine
+ *				and to two incremental SHA-256 contexts, one per range. The CRC range and the signed range start at
+ *				the beginning of the image, the firmware block range may start at any offset. Empty ranges are allowed.
+ *
+ *	@param		PrgbImage				Firmware image
+ *	@param		PunImageSize			Size of the firmware image in bytes
+ *	@param		PunCrcSize				Number of bytes covered by the CRC
+ *	@param		PunSignedSize			Number of bytes covered by the signed range SHA-256
+ *	@param		PunFirmwareOffset		Offset of the firmware block range
+ *	@param		PunFirmwareSize			Number of bytes covered by the firmware block range SHA-256
+ *	@param		PpsDigests				Receives the calculated digests
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. It was NULL or a range exceeds the image.
+ */
+_Check_return_
+unsigned int
+Crypt_ImageDigests(
+	_In_bytecount_(PunImageSize)	const BYTE*				PrgbImage,
+	_In_							UINT32					PunImageSize,
+	_In_							UINT32					PunCrcSize,
+	_In_							UINT32					PunSignedSize,
+	_In_							UINT32					PunFirmwareOffset,
+	_In_							UINT32					PunFirmwareSize,
+	_Out_							IfxCryptImageDigests*	PpsDigests)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	EVP_MD_CTX* pSignedContext = NULL;
+	EVP_MD_CTX* pFirmwareContext = NULL;
+
+	do
+	{
+		unsigned int unCRC = ~0U;
+		UINT32 unFirmwareEnd = 0;
+		UINT32 unScanSize = 0;
+		UINT32 unPosition = 0;
+
+		// Check parameters
+		if (NULL == PrgbImage || NULL == PpsDigests ||
+				PunCrcSize > PunImageSize ||
+				PunSignedSize > PunImageSize ||
+				PunFirmwareOffset > PunImageSize ||
+				PunFirmwareSize > PunImageSize - PunFirmwareOffset)
 		{
-			int nIndex = 0;
-			unCRC ^= *pbInputData++;
-			for (; nIndex < 8; nIndex++)
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		memset(PpsDigests, 0, sizeof(IfxCryptImageDigests));
+
+		if (0 != pthread_once(&s_sCrcInitOnce, Crypt_CrcInitialize))
+			break;
+
+		pSignedContext = EVP_MD_CTX_new();
+		pFirmwareContext = EVP_MD_CTX_new();
+		if (NULL == pSignedContext || NULL == pFirmwareContext ||
+				1 != EVP_DigestInit_ex(pSignedContext, EVP_sha256(), NULL) ||
+				1 != EVP_DigestInit_ex(pFirmwareContext, EVP_sha256(), NULL))
+			break;
+
+		// Only walk up to the end of the last range
+		unFirmwareEnd = PunFirmwareOffset + PunFirmwareSize;
+		unScanSize = PunCrcSize > PunSignedSize ? PunCrcSize : PunSignedSize;
+		if (unFirmwareEnd > unScanSize)
+			unScanSize = unFirmwareEnd;
+
+		unReturnValue = RC_SUCCESS;
+		while (unPosition < unScanSize)
+		{
+			UINT32 unChunkEnd = unScanSize - unPosition > CRYPT_DIGEST_CHUNK_SIZE ? unPosition + CRYPT_DIGEST_CHUNK_SIZE : unScanSize;
+
+			if (unPosition < PunCrcSize)
+				unCRC = s_pfnCrcUpdate(unCRC, PrgbImage + unPosition, (unChunkEnd < PunCrcSize ? unChunkEnd : PunCrcSize) - unPosition);
+
+			if (unPosition < PunSignedSize &&
+					1 != EVP_DigestUpdate(pSignedContext, PrgbImage + unPosition, (unChunkEnd < PunSignedSize ? unChunkEnd : PunSignedSize) - unPosition))
+			{
+				unReturnValue = RC_E_FAIL;
+				break;
+			}
+
+			if (unPosition < unFirmwareEnd && unChunkEnd > PunFirmwareOffset)
 			{
-				unCRC = (unCRC >> 1) ^ (-((int)(unCRC & 1)) & CRC32MASKREV);
+				UINT32 unStart = unPosition > PunFirmwareOffset ? unPosition : PunFirmwareOffset;
+				UINT32 unEnd = unChunkEnd < unFirmwareEnd ? unChunkEnd : unFirmwareEnd;
+				if (1 != EVP_DigestUpdate(pFirmwareContext, PrgbImage + unStart, unEnd - unStart))
+				{
+					unReturnValue = RC_E_FAIL;
+					break;
+				}
 			}
+
+			unPosition = unChunkEnd;
 		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
 
-		*PpunCRC = ~unCRC;
-		unReturnValue = RC_SUCCESS;
+		if (1 != EVP_DigestFinal_ex(pSignedContext, PpsDigests->rgbSignedHash, NULL) ||
+				1 != EVP_DigestFinal_ex(pFirmwareContext, PpsDigests->rgbFirmwareHash, NULL))
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+		PpsDigests->unCRC = ~unCRC;
 	}
 	WHILE_FALSE_END;
 
+	EVP_MD_CTX_free(pSignedContext);
+	EVP_MD_CTX_free(pFirmwareContext);
+
 	return unReturnValue;
 }
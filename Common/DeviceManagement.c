@@ -15,8 +15,10 @@
 
 #include "DeviceManagement.h"
 #include "TpmIO.h"
+#include "TpmSimulator.h"
 #include "Logging.h"
 #include "Platform.h"
+#include "Timing.h"
 /// Offset for locality 0
 #define LOCALITY0OFFSET 0xFED40000
 /// TPM Access register bit for active locality
@@ -33,12 +35,21 @@ PFN_TPMIO_Disconnect	s_fpTpmIoDisconnect = NULL;
 /// Function pointer to method for transmitting data to the TPM
 PFN_TPMIO_Transmit		s_fpTpmIoTransmit = NULL;
 
+/// Function pointer to method for sending data to the TPM without waiting for the response
+PFN_TPMIO_Send			s_fpTpmIoSend = NULL;
+
+/// Function pointer to method for receiving the response of data sent to the TPM
+PFN_TPMIO_Receive		s_fpTpmIoReceive = NULL;
+
 /// Function pointer to read a byte from a register of the TPM
 PFN_TPMIO_ReadRegister	s_fpTpmIoReadRegister = NULL;
 
 /// Function pointer to write a byte to a register of the TPM
 PFN_TPMIO_WriteRegister	s_fpTpmIoWriteRegister = NULL;
 
+/// Function pointer to enable or disable transport level retries
+PFN_TPMIO_SetRetry		s_fpTpmIoSetRetry = NULL;
+
 /// Flag indicating TPM connection established or not
 BOOL					s_fTpmConnected = FALSE;
 
@@ -48,23 +59,56 @@ BOOL					s_fInitialized = FALSE;
 /// Flag indicating locality is set or not
 BOOL					s_fIsLocalitySet = FALSE;
 
-/// Caches the last TPM command
-BYTE					g_rgbLastRequest[4096] = {0};
+/// Points to the last TPM command
+const BYTE*				g_pbLastRequest = NULL;
 
-/// Caches the size of the last TPM command
+/// Size of the last TPM command
 unsigned int			g_unSizeLastRequest = 0;
 
-/// Caches the last TPM response
-BYTE					g_rgbLastResponse[4096] = {0};
+/// Points to the last TPM response
+const BYTE*				g_pbLastResponse = NULL;
 
-/// Caches the size of the last TPM response
+/// Size of the last TPM response
 unsigned int			g_unSizeLastResponse = 0;
 
-/// Maximum wait time in TIS protocol for commands of category SMALL_DURATION: 10 seconds
+/// Command buffers used alternately by the TPM commands
+static IfxTpmCommandBuffer s_rgsCommandBuffers[2];
+
+/// Index of the command buffer for the next TPM command
+static unsigned int s_unCommandBuffer = 0;
+
+/**
+ *	@brief		TPM command in transmission
+ *	@details	Holds the properties of a TPM command between DeviceManagement_Send and DeviceManagement_Receive.
+ */
+typedef struct tdIfxTpmPendingCommand
+{
+	/// TPM command code
+	unsigned int		unCommandCode;
+	/// TPM command name (NULL if unknown)
+	const wchar_t*		pwszCommandName;
+	/// Maximum command duration in microseconds
+	unsigned int		unMaxDuration;
+	/// Size of the command in bytes
+	unsigned int		unRequestSize;
+	/// Start time of the transmission
+	unsigned long long	ullStartUs;
+} IfxTpmPendingCommand;
+
+/// Command sent with DeviceManagement_Send
+static IfxTpmPendingCommand s_sPendingCommand;
+
+/// Flag indicating that the response of s_sPendingCommand has not been received yet
+static BOOL s_fCommandPending = FALSE;
+
+/// Flag indicating that failed TPM commands are retried on transport level (see DeviceManagement_SetRetry)
+static BOOL s_fRetry = TRUE;
+
+/// Maximum wait time in TIS protocol and driver transport for commands of category SMALL_DURATION: 10 seconds
 #define SMALL_DURATION 10000000
-/// Maximum wait time in TIS protocol for commands of category MEDIUM_DURATION: 20 seconds
+/// Maximum wait time in TIS protocol and driver transport for commands of category MEDIUM_DURATION: 20 seconds
 #define MEDIUM_DURATION 20000000
-/// Maximum wait time in TIS protocol for commands of category LONG_DURATION: 120 seconds
+/// Maximum wait time in TIS protocol and driver transport for commands of category LONG_DURATION: 120 seconds
 #define LONG_DURATION 120000000
 
 /// List of available TPM1.2 command names and their properties: command code, maximum command duration
@@ -130,6 +174,7 @@ IfxTpmCommand s_sTpm2Commands[] = {
  *	@details	This function initializes the device IO.
  *
  *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		...				Error codes from TpmSimulator_Register
  */
 _Check_return_
 unsigned int
@@ -148,8 +193,16 @@ DeviceManagement_Initialize()
 			s_fpTpmIoConnect		= &TPMIO_Connect;
 			s_fpTpmIoDisconnect		= &TPMIO_Disconnect;
 			s_fpTpmIoTransmit		= &TPMIO_Transmit;
+			s_fpTpmIoSend			= &TPMIO_Send;
+			s_fpTpmIoReceive		= &TPMIO_Receive;
 			s_fpTpmIoReadRegister	= &TPMIO_ReadRegister;
 			s_fpTpmIoWriteRegister	= &TPMIO_WriteRegister;
+			s_fpTpmIoSetRetry		= &TPMIO_SetRetry;
+
+			// Make the simulator transports available to TPMIO_Connect
+			unReturnValue = TpmSimulator_Register();
+			if (RC_SUCCESS != unReturnValue)
+				break;
 			s_fInitialized = TRUE;
 		}
 		unReturnValue = RC_SUCCESS;
@@ -183,6 +236,7 @@ DeviceManagement_Uninitialize()
 			s_fpTpmIoTransmit		= NULL;
 			s_fpTpmIoReadRegister	= NULL;
 			s_fpTpmIoWriteRegister	= NULL;
+			s_fpTpmIoSetRetry		= NULL;
 			s_fInitialized = FALSE;
 		}
 		unReturnValue = RC_SUCCESS;
@@ -341,51 +395,37 @@ DeviceManagement_Disconnect()
 }
 
 /**
- *	@brief		Device transmit function
- *	@details	This function submits the TPM command to the underlying TPM access module (TpmIO interface).
+ *	@brief		Prepares the transmission of a TPM command
+ *	@details	Checks the module state, determines the command name and maximum duration, logs the command and remembers it for troubleshooting.
  *
  *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
  *	@param		PunRequestBufferSize	Size of command request in bytes
- *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
- *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PpsCommand				Receives the command properties
  *
  *	@retval		RC_SUCCESS				The operation completed successfully.
- *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. Invalid buffer or buffer size
  *	@retval		RC_E_NOT_INITIALIZED	The module could not be initialized
  *	@retval		RC_E_NOT_CONNECTED		The connection to the TPM failed
- *	@retval		RC_E_FAIL				An unexpected error occurred.
- *	@retval	...							Error codes from s_fpTpmIoTransmit function
+ *	@retval		...						Error codes from Platform_MemoryCopy
  */
 _Check_return_
+static
 unsigned int
-DeviceManagement_Transmit(
-	_In_bytecount_(PunRequestBufferSize)		const BYTE*		PrgbRequestBuffer,
-	_In_										unsigned int	PunRequestBufferSize,
-	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
-	_Inout_										unsigned int*	PpunResponseBufferSize)
+DeviceManagement_BeginCommand(
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*				PrgbRequestBuffer,
+	_In_										unsigned int			PunRequestBufferSize,
+	_Out_										IfxTpmPendingCommand*	PpsCommand)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 
-	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
-
 	do
 	{
 		unsigned int unCommandCode = 0;
-		unsigned int unTisMaxDuration = LONG_DURATION;
 
-		// Check parameters
-		if (NULL == PrgbRequestBuffer || NULL == PrgbResponseBuffer)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpbRequestBuffer or PpunResponseBufferSize is NULL)");
-			break;
-		}
-		if (0 == PunRequestBufferSize || 0 == PpunResponseBufferSize)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			ERROR_STORE(unReturnValue, L"Parameter PunRequestBufferSize or PpunResponseBufferSize has invalid value 0");
-			break;
-		}
+		PpsCommand->unCommandCode = 0;
+		PpsCommand->pwszCommandName = NULL;
+		PpsCommand->unMaxDuration = LONG_DURATION;
+		PpsCommand->unRequestSize = PunRequestBufferSize;
+		PpsCommand->ullStartUs = 0;
 
 		// Check if module is initialized
 		if (FALSE == DeviceManagement_IsInitialized())
@@ -407,7 +447,6 @@ DeviceManagement_Transmit(
 		// Check if the request buffer holds at least enough bytes for the command length and code
 		if (PunRequestBufferSize >= 10)
 		{
-			unsigned int unShiftedCommandCode = 0;
 			// Get TPM command code
 			unReturnValue = Platform_MemoryCopy(&unCommandCode, sizeof(unCommandCode), (const void*) &PrgbRequestBuffer[6], sizeof(unsigned int));
 			if (RC_SUCCESS != unReturnValue)
@@ -416,9 +455,9 @@ DeviceManagement_Transmit(
 				break;
 			}
 			// Switch command code endianness
-			unShiftedCommandCode = Platform_SwapBytes32(unCommandCode);
+			PpsCommand->unCommandCode = Platform_SwapBytes32(unCommandCode);
 			// Output the corresponding command name
-			DeviceManagement_TpmCommandName(unShiftedCommandCode, &unTisMaxDuration);
+			DeviceManagement_TpmCommandName(PpsCommand->unCommandCode, &PpsCommand->unMaxDuration, &PpsCommand->pwszCommandName);
 		}
 		else
 		{
@@ -428,40 +467,267 @@ DeviceManagement_Transmit(
 		LOGGING_WRITE_LEVEL3_FMT(L"DeviceManagement_Transmit: Sending:  TxLen = %4d", PunRequestBufferSize);
 		LOGGING_WRITEHEX_LEVEL3(PrgbRequestBuffer, PunRequestBufferSize);
 
-		// Cache the request for troubleshooting and clear the last TPM response cache
-		unReturnValue = Platform_MemoryCopy(g_rgbLastRequest, sizeof(g_rgbLastRequest), PrgbRequestBuffer, PunRequestBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
+		// Remember the request for troubleshooting and clear the last TPM response
+		g_pbLastRequest = PrgbRequestBuffer;
 		g_unSizeLastRequest = PunRequestBufferSize;
+		g_pbLastResponse = NULL;
 		g_unSizeLastResponse = 0;
 
-		unReturnValue = s_fpTpmIoTransmit(
-							PrgbRequestBuffer,
-							PunRequestBufferSize,
-							PrgbResponseBuffer,
-							PpunResponseBufferSize,
-							unTisMaxDuration);
+		PpsCommand->ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Finishes the transmission of a TPM command
+ *	@details	Records the command timing, logs the response and remembers it for troubleshooting. The next command uses the other
+ *				command buffer, so the last command and response are not overwritten.
+ *
+ *	@param		PpsCommand				Command properties from DeviceManagement_BeginCommand
+ *	@param		PunTransmitResult		Return value of the TPM I/O function
+ *	@param		PrgbResponseBuffer		Pointer to a byte array holding the TPM command response bytes
+ *	@param		PunResponseBufferSize	Size of TPM command response in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						PunTransmitResult
+ */
+_Check_return_
+static
+unsigned int
+DeviceManagement_EndCommand(
+	_In_									const IfxTpmPendingCommand*	PpsCommand,
+	_In_									unsigned int				PunTransmitResult,
+	_In_bytecount_(PunResponseBufferSize)	const BYTE*					PrgbResponseBuffer,
+	_In_									unsigned int				PunResponseBufferSize)
+{
+	unsigned int unReturnValue = PunTransmitResult;
+
+	// Switch the command buffers
+	s_unCommandBuffer ^= 1;
+
+	do
+	{
+		Timing_RecordCommand(
+			PpsCommand->unCommandCode,
+			PpsCommand->pwszCommandName,
+			PpsCommand->ullStartUs,
+			PpsCommand->unRequestSize,
+			RC_SUCCESS == unReturnValue ? PunResponseBufferSize : 0,
+			unReturnValue);
+		if (RC_SUCCESS != unReturnValue && FALSE == s_fRetry)
+		{
+			// Failures are expected while probing without retries, e.g. while the TPM restarts
+			LOGGING_WRITE_LEVEL4_FMT(L"TPM command failed with (0x%.8x).", unReturnValue);
+			break;
+		}
 		if (RC_SUCCESS != unReturnValue)
 		{
 			ERROR_STORE(unReturnValue, L"Error during TpmIOTransmit");
 
 			// Log the last TPM command/response for troubleshooting
 			LOGGING_WRITE_LEVEL1(L"Last TPM command:");
-			LOGGING_WRITEHEX_LEVEL1(g_rgbLastRequest, g_unSizeLastRequest);
+			LOGGING_WRITEHEX_LEVEL1(g_pbLastRequest, g_unSizeLastRequest);
 			LOGGING_WRITE_LEVEL1(L"Last TPM response:");
-			LOGGING_WRITEHEX_LEVEL1(g_rgbLastResponse, g_unSizeLastResponse);
+			LOGGING_WRITEHEX_LEVEL1(g_pbLastResponse, g_unSizeLastResponse);
+
+			break;
+		}
+
+		LOGGING_WRITE_LEVEL3_FMT(L"DeviceManagement_Transmit: Received:  RxLen = %4d", PunResponseBufferSize);
+		LOGGING_WRITEHEX_LEVEL3(PrgbResponseBuffer, PunResponseBufferSize);
+
+		// Remember the response for troubleshooting
+		g_pbLastResponse = PrgbResponseBuffer;
+		g_unSizeLastResponse = PunResponseBufferSize;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Returns the command buffer for the next TPM command
+ *	@details	The module owns two command buffers and alternates between them after each transmitted command, so the
+ *				last command and response stay available for troubleshooting without copying them. The buffer is not
+ *				cleared and remains valid until the next but one TPM command.
+ *
+ *	@returns	Pointer to the command buffer
+ */
+IfxTpmCommandBuffer*
+DeviceManagement_GetCommandBuffer()
+{
+	return &s_rgsCommandBuffers[s_unCommandBuffer];
+}
+
+/**
+ *	@brief		Device transmit function
+ *	@details	This function submits the TPM command to the underlying TPM access module (TpmIO interface).
+ *
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. Invalid buffer or buffer size
+ *	@retval		RC_E_NOT_INITIALIZED	The module could not be initialized
+ *	@retval		RC_E_NOT_CONNECTED		The connection to the TPM failed
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ *	@retval	...							Error codes from s_fpTpmIoTransmit function
+ */
+_Check_return_
+unsigned int
+DeviceManagement_Transmit(
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*		PrgbRequestBuffer,
+	_In_										unsigned int	PunRequestBufferSize,
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
+	_Inout_										unsigned int*	PpunResponseBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
 
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		IfxTpmPendingCommand sCommand;
+
+		// Check parameters
+		if (NULL == PrgbRequestBuffer || NULL == PrgbResponseBuffer)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpbRequestBuffer or PpunResponseBufferSize is NULL)");
+			break;
+		}
+		if (0 == PunRequestBufferSize || 0 == PpunResponseBufferSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter PunRequestBufferSize or PpunResponseBufferSize has invalid value 0");
+			break;
+		}
+
+		unReturnValue = DeviceManagement_BeginCommand(PrgbRequestBuffer, PunRequestBufferSize, &sCommand);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = s_fpTpmIoTransmit(
+							PrgbRequestBuffer,
+							PunRequestBufferSize,
+							PrgbResponseBuffer,
+							PpunResponseBufferSize,
+							sCommand.unMaxDuration);
+		unReturnValue = DeviceManagement_EndCommand(&sCommand, unReturnValue, PrgbResponseBuffer, *PpunResponseBufferSize);
+	}
+	WHILE_FALSE_END;
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Device send function
+ *	@details	This function submits the TPM command to the underlying TPM access module (TpmIO interface) without waiting for the
+ *				response. The caller can prepare the next command while the TPM executes this one and must call DeviceManagement_Receive
+ *				afterwards. The request buffer is passed to the transport without copying and must stay valid until DeviceManagement_Receive returns.
+ *
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. Invalid buffer or buffer size
+ *	@retval		RC_E_NOT_INITIALIZED	The module could not be initialized
+ *	@retval		RC_E_NOT_CONNECTED		The connection to the TPM failed
+ *	@retval		RC_E_FAIL				The response of the former command has not been received yet.
+ *	@retval	...							Error codes from s_fpTpmIoSend function
+ */
+_Check_return_
+unsigned int
+DeviceManagement_Send(
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*		PrgbRequestBuffer,
+	_In_										unsigned int	PunRequestBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		// Check parameters
+		if (NULL == PrgbRequestBuffer || 0 == PunRequestBufferSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PrgbRequestBuffer is NULL or PunRequestBufferSize is 0)");
+			break;
+		}
+		if (s_fCommandPending)
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE(unReturnValue, L"The response of the former TPM command has not been received yet");
 			break;
 		}
 
-		LOGGING_WRITE_LEVEL3_FMT(L"DeviceManagement_Transmit: Received:  RxLen = %4d", *PpunResponseBufferSize);
-		LOGGING_WRITEHEX_LEVEL3(PrgbResponseBuffer, *PpunResponseBufferSize);
+		unReturnValue = DeviceManagement_BeginCommand(PrgbRequestBuffer, PunRequestBufferSize, &s_sPendingCommand);
+		if (RC_SUCCESS != unReturnValue)
+			break;
 
-		// Cache the response for troubleshooting
-		unReturnValue = Platform_MemoryCopy(g_rgbLastResponse, sizeof(g_rgbLastResponse), PrgbResponseBuffer, *PpunResponseBufferSize);
+		unReturnValue = s_fpTpmIoSend(PrgbRequestBuffer, PunRequestBufferSize);
 		if (RC_SUCCESS != unReturnValue)
+		{
+			unReturnValue = DeviceManagement_EndCommand(&s_sPendingCommand, unReturnValue, NULL, 0);
+			break;
+		}
+		s_fCommandPending = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Device receive function
+ *	@details	This function waits for the response of the TPM command submitted with DeviceManagement_Send.
+ *
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. Invalid buffer or buffer size
+ *	@retval		RC_E_FAIL				No TPM command has been submitted with DeviceManagement_Send.
+ *	@retval	...							Error codes from s_fpTpmIoReceive function
+ */
+_Check_return_
+unsigned int
+DeviceManagement_Receive(
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
+	_Inout_										unsigned int*	PpunResponseBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		// Check parameters
+		if (NULL == PrgbResponseBuffer || NULL == PpunResponseBufferSize || 0 == *PpunResponseBufferSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PrgbResponseBuffer or PpunResponseBufferSize is NULL or *PpunResponseBufferSize is 0)");
+			break;
+		}
+		if (!s_fCommandPending)
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE(unReturnValue, L"No TPM command has been sent");
 			break;
-		g_unSizeLastResponse = *PpunResponseBufferSize;
+		}
+
+		s_fCommandPending = FALSE;
+		unReturnValue = s_fpTpmIoReceive(PrgbResponseBuffer, PpunResponseBufferSize, s_sPendingCommand.unMaxDuration);
+		unReturnValue = DeviceManagement_EndCommand(&s_sPendingCommand, unReturnValue, PrgbResponseBuffer, *PpunResponseBufferSize);
 	}
 	WHILE_FALSE_END;
 
@@ -475,12 +741,14 @@ DeviceManagement_Transmit(
  *	@details	This function determines the TPM command name from the command ordinal and puts it to the log file.
  *
  *	@param		PunCommandCode			TPM command ordinal
- *	@param		PpunMaxDuration			Maximum command duration in microseconds (relevant for memory based access / TIS protocol only)
+ *	@param		PpunMaxDuration			Maximum command duration in microseconds (deadline of the TIS protocol and of the /dev/tpm0 driver transport)
+ *	@param		PpwszCommandName		Receives the TPM command name or NULL if the command code is unknown
  */
 void
 DeviceManagement_TpmCommandName(
-	_In_	unsigned int	PunCommandCode,
-	_Out_	unsigned int*	PpunMaxDuration)
+	_In_	unsigned int		PunCommandCode,
+	_Out_	unsigned int*		PpunMaxDuration,
+	_Out_	const wchar_t**		PpwszCommandName)
 {
 	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
 
@@ -491,6 +759,7 @@ DeviceManagement_TpmCommandName(
 
 		// Initialize output parameters
 		*PpunMaxDuration = LONG_DURATION;
+		*PpwszCommandName = NULL;
 
 		// Determine if it is a TPM1.2 or TPM2.0 command code
 		if (PunCommandCode & 0x00000100)
@@ -512,6 +781,7 @@ DeviceManagement_TpmCommandName(
 			if (prgTpmCommands[unIndex].unCommandCode == PunCommandCode)
 			{
 				*PpunMaxDuration = prgTpmCommands[unIndex].unMaxDuration;
+				*PpwszCommandName = prgTpmCommands[unIndex].pwszCommandName;
 				LOGGING_WRITE_LEVEL3_FMT(L"Sending TPM Command: %ls", prgTpmCommands[unIndex].pwszCommandName);
 				break;
 			}
@@ -656,3 +926,20 @@ DeviceManagement_WriteRegister(
 
 	return unReturnValue;
 }
+
+/**
+ *	@brief		Enable or disable transport level retries
+ *	@details	By default a command which failed on transport level is retried by the transport and its failure is logged
+ *				together with the last TPM command and response. Readiness probes disable the retries so that each probe
+ *				returns within their deadline; failures are logged on level 4 only in this case.
+ *
+ *	@param		PfRetry					TRUE to retry failed commands, FALSE to transmit each command once
+ */
+void
+DeviceManagement_SetRetry(
+	_In_	BOOL	PfRetry)
+{
+	s_fRetry = PfRetry;
+	if (TRUE == DeviceManagement_IsInitialized())
+		s_fpTpmIoSetRetry(PfRetry);
+}
@@ -20,15 +20,28 @@
 extern "C" {
 #endif
 
-/// Caches the last TPM command
-extern BYTE g_rgbLastRequest[4096];
-/// Caches the last TPM command
+/// Points to the last TPM command
+extern const BYTE* g_pbLastRequest;
+/// Size of the last TPM command
 extern unsigned int g_unSizeLastRequest;
-/// Caches the last TPM command
-extern BYTE g_rgbLastResponse[4096];
-/// Caches the last TPM response
+/// Points to the last TPM response
+extern const BYTE* g_pbLastResponse;
+/// Size of the last TPM response
 extern unsigned int g_unSizeLastResponse;
 
+/**
+ *	@brief		TPM command buffer
+ *	@details	Buffer owned by the device management module. TPM commands are marshalled into the request buffer and
+ *				the response is parsed in place from the response buffer.
+ */
+typedef struct tdIfxTpmCommandBuffer
+{
+	/// Request bytes
+	BYTE	rgbRequest[4096];
+	/// Response bytes
+	BYTE	rgbResponse[4096];
+} IfxTpmCommandBuffer;
+
 /**
  *	@brief		Represents a TPM command
  *	@details	Structure that holds the code and the name of a TPM command.
@@ -45,6 +58,7 @@ typedef struct tdIfxTpmCommand
  *	@details	This function initializes the device IO.
  *
  *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		...				Error codes from TpmSimulator_Register
  */
 _Check_return_
 unsigned int
@@ -130,17 +144,70 @@ DeviceManagement_Transmit(
 	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
 	_Inout_										unsigned int*	PpunResponseBufferSize);
 
+/**
+ *	@brief		Returns the command buffer for the next TPM command
+ *	@details	The module owns two command buffers and alternates between them after each transmitted command, so the
+ *				last command and response stay available for troubleshooting without copying them. The buffer is not
+ *				cleared and remains valid until the next but one TPM command.
+ *
+ *	@returns	Pointer to the command buffer
+ */
+IfxTpmCommandBuffer*
+DeviceManagement_GetCommandBuffer();
+
+/**
+ *	@brief		Device send function
+ *	@details	This function submits the TPM command to the underlying TPM access module (TpmIO interface) without waiting for the
+ *				response. The caller can prepare the next command while the TPM executes this one and must call DeviceManagement_Receive
+ *				afterwards. The request buffer is passed to the transport without copying and must stay valid until DeviceManagement_Receive returns.
+ *
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. Invalid buffer or buffer size
+ *	@retval		RC_E_NOT_INITIALIZED	The module could not be initialized
+ *	@retval		RC_E_NOT_CONNECTED		The connection to the TPM failed
+ *	@retval		RC_E_FAIL				The response of the former command has not been received yet.
+ *	@retval	...							Error codes from s_fpTpmIoSend function
+ */
+_Check_return_
+unsigned int
+DeviceManagement_Send(
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*		PrgbRequestBuffer,
+	_In_										unsigned int	PunRequestBufferSize);
+
+/**
+ *	@brief		Device receive function
+ *	@details	This function waits for the response of the TPM command submitted with DeviceManagement_Send.
+ *
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. Invalid buffer or buffer size
+ *	@retval		RC_E_FAIL				No TPM command has been submitted with DeviceManagement_Send.
+ *	@retval	...							Error codes from s_fpTpmIoReceive function
+ */
+_Check_return_
+unsigned int
+DeviceManagement_Receive(
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
+	_Inout_										unsigned int*	PpunResponseBufferSize);
+
 /**
  *	@brief		Function to output TPM command name and return the duration.
  *	@details	This function determines the TPM command name from the command ordinal and puts it to the log file.
  *
  *	@param		PunCommandCode			TPM command ordinal
- *	@param		PpunMaxDuration			Maximum command duration in microseconds (relevant for memory based access / TIS protocol only)
+ *	@param		PpunMaxDuration			Maximum command duration in microseconds (deadline of the TIS protocol and of the /dev/tpm0 driver transport)
+ *	@param		PpwszCommandName		Receives the TPM command name or NULL if the command code is unknown
  */
 void
 DeviceManagement_TpmCommandName(
-	_In_	unsigned int	PunCommandCode,
-	_Out_	unsigned int*	PpunMaxDuration);
+	_In_	unsigned int		PunCommandCode,
+	_Out_	unsigned int*		PpunMaxDuration,
+	_Out_	const wchar_t**		PpwszCommandName);
 
 /**
  *	@brief		Register read function
@@ -182,6 +249,18 @@ DeviceManagement_WriteRegister(
 	_In_	unsigned int	PunRegisterAddress,
 	_In_	BYTE			PbRegisterValue);
 
+/**
+ *	@brief		Enable or disable transport level retries
+ *	@details	By default a command which failed on transport level is retried by the transport and its failure is logged
+ *				together with the last TPM command and response. Readiness probes disable the retries so that each probe
+ *				returns within their deadline; failures are logged on level 4 only in this case.
+ *
+ *	@param		PfRetry					TRUE to retry failed commands, FALSE to transmit each command once
+ */
+void
+DeviceManagement_SetRetry(
+	_In_	BOOL	PfRetry);
+
 #ifdef __cplusplus
 }
 #endif
@@ -116,6 +116,8 @@ Error_MapToFinalCode(
 		case RC_E_FIRMWARE_UPDATE_NOT_FOUND:
 		case RC_E_RESUME_RUNDATA_NOT_FOUND:
 		case RC_E_TPM12_FAILED_SELFTEST:
+		case RC_E_INVALID_BUILD_INDEX_OPTION:
+		case RC_E_INVALID_VERIFY_FOLDER_OPTION:
 			unReturnValue = PunErrorCode;
 			break;
 
@@ -337,6 +339,12 @@ Error_MapFinalCodeToMessage(
 			case RC_E_FIRMWARE_UPDATE_NOT_FOUND:
 				unReturnValue = Platform_StringCopy(PwszErrorMessage, PpunBufferSize, MSG_RC_E_FIRMWARE_UPDATE_NOT_FOUND);
 				break;
+			case RC_E_INVALID_BUILD_INDEX_OPTION:
+				unReturnValue = Platform_StringCopy(PwszErrorMessage, PpunBufferSize, MSG_RC_E_INVALID_BUILD_INDEX_OPTION);
+				break;
+			case RC_E_INVALID_VERIFY_FOLDER_OPTION:
+				unReturnValue = Platform_StringCopy(PwszErrorMessage, PpunBufferSize, MSG_RC_E_INVALID_VERIFY_FOLDER_OPTION);
+				break;
 			case RC_E_RESUME_RUNDATA_NOT_FOUND:
 				unReturnValue = Platform_StringCopy(PwszErrorMessage, PpunBufferSize, MSG_RC_E_RESUME_RUNDATA_NOT_FOUND);
 				break;
@@ -558,6 +566,9 @@ Error_Store(
 	}
 
 	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_EXIT_STRING);
+
+	// Make sure everything logged up to the error is in the log file
+	IGNORE_RETURN_VALUE(Logging_Flush());
 }
 
 /**
@@ -209,7 +209,13 @@
 #define RC_E_RESUME_RUNDATA_NOT_FOUND			RC_E_TPM_FIRMWARE_UPDATE + 0x1A
 #define MSG_RC_E_RESUME_RUNDATA_NOT_FOUND		L"Cannot resume interrupted firmware update with option '-update config-file' because file 'TPMFactoryUpd_RunData.txt' is missing."
 
-// Range from 0x1B to 0x1F can be used for new error codes.
+/// Error code for an invalid build-index option (0xE029551B)
+#define RC_E_INVALID_BUILD_INDEX_OPTION			RC_E_TPM_FIRMWARE_UPDATE + 0x1B
+#define MSG_RC_E_INVALID_BUILD_INDEX_OPTION		L"An invalid value was passed in the <build-index> command line option."
+#define RC_E_INVALID_VERIFY_FOLDER_OPTION		RC_E_TPM_FIRMWARE_UPDATE + 0x1C
+#define MSG_RC_E_INVALID_VERIFY_FOLDER_OPTION	L"An invalid value was passed in the <verify-folder> command line option."
+
+// Range from 0x1D to 0x1F can be used for new error codes.
 
 // Error codes 0x20 and 0x21 is for tool internal use
 
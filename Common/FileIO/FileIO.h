@@ -20,6 +20,32 @@ extern "C" {
 
 #include "StdInclude.h"
 
+/// Identity of a file as reported by the file system
+typedef struct tdIfxFileIdentity
+{
+	/// Device the file resides on
+	unsigned long long ullDevice;
+	/// Inode number of the file
+	unsigned long long ullInode;
+	/// Size of the file in bytes
+	unsigned long long ullSize;
+	/// Last modification time in nanoseconds since the epoch
+	unsigned long long ullModificationTime;
+} IfxFileIdentity;
+
+/**
+ *	@brief		Callback for FileIO_EnumerateDirectory
+ *	@details	Called once for every file in the directory.
+ *
+ *	@param		PwszFileName		Name of the file without the directory part
+ *	@param		PpvContext			Context passed to FileIO_EnumerateDirectory
+ *	@retval		RC_SUCCESS			Continue with the next file.
+ *	@retval		...					Any other value stops the enumeration and is returned by FileIO_EnumerateDirectory.
+ */
+typedef unsigned int (*PFN_FILEIO_ENUMERATE_CALLBACK)(
+	_In_z_	const wchar_t*	PwszFileName,
+	_In_opt_	void*			PpvContext);
+
 /**
  *	@brief		Open a file
  *	@details	Opens a file with the given name and access rights and returns the handle to it in *PppvFileHandle.
@@ -195,6 +221,37 @@ FileIO_GetFileSize(
 	_In_	const void*			PpvFileHandle,
 	_Out_	unsigned long long*	PpullFileSize);
 
+/**
+ *	@brief		Set the buffer of a file
+ *	@details	Makes the file fully buffered using the given caller owned buffer. Must be called before any
+ *				other operation on the file and the buffer must stay valid until the file is closed.
+ *	@param		PpvFileHandle		Handle to an open file
+ *	@param		PrgbBuffer			Buffer to be used by the file
+ *	@param		PunBufferSize		Size of the buffer in bytes
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. PpvFileHandle or PrgbBuffer is NULL or PunBufferSize is 0
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_SetBuffer(
+	_In_							const void*		PpvFileHandle,
+	_Inout_bytecap_(PunBufferSize)	BYTE*			PrgbBuffer,
+	_In_							unsigned int	PunBufferSize);
+
+/**
+ *	@brief		Flush a file
+ *	@details	Writes all buffered data of the given file to the file system
+ *	@param		PpvFileHandle		Handle to an open file
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. PpvFileHandle is NULL
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_Flush(
+	_In_ const void* PpvFileHandle);
+
 /**
  *	@brief		Read the whole content of a file into a byte array
  *	@details	The function opens, reads and closes the file.
@@ -216,6 +273,141 @@ FileIO_ReadFileToBuffer(
 	_Outptr_result_maybenull_	BYTE**			PprgbBuffer,
 	_Out_						unsigned int*	PpunBufferSize);
 
+/**
+ *	@brief		Map the whole content of a file read-only into memory
+ *	@details	The function opens the file, maps it read-only with mmap and closes the file again.
+ *				The kernel is advised that the mapping will be read sequentially. The content is not copied
+ *				and no heap memory is allocated. The mapping must be released with FileIO_UnmapFile.
+ *				Changes of the file show through the mapping and truncating it raises SIGBUS on access, so it is only
+ *				suitable for read-only checks. Use FileIO_ReadFileToBuffer for data which is sent to the TPM.
+ *
+ *	@param		PwszFileName		String containing the file to be mapped
+ *	@param		PprgbBuffer			Pointer to a byte array which receives
+ *									the address of the read-only mapping.
+ *	@param		PpunBufferSize		Number of bytes mapped.
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly. Or the file was too large.
+ *	@retval		RC_E_FAIL			An unexpected error occurred. Or the file was empty.
+ */
+_Check_return_
+unsigned int
+FileIO_MapFile(
+	_In_z_						const wchar_t*	PwszFileName,
+	_Outptr_result_maybenull_	BYTE**			PprgbBuffer,
+	_Out_						unsigned int*	PpunBufferSize);
+
+/**
+ *	@brief		Release a mapping created by FileIO_MapFile
+ *	@details	The function unmaps the memory and resets the pointer to NULL. A NULL mapping is ignored.
+ *
+ *	@param		PprgbBuffer			Pointer to the address of the mapping
+ *	@param		PunBufferSize		Number of bytes mapped as returned by FileIO_MapFile
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was NULL.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_UnmapFile(
+	_Inout_	BYTE**			PprgbBuffer,
+	_In_	unsigned int	PunBufferSize);
+
+/**
+ *	@brief		Get the identity of a file
+ *	@details	The function reports device, inode, size and modification time of the file. Two files with the same
+ *				identity are treated as the same unmodified file.
+ *
+ *	@param		PwszFileName		String containing the file name
+ *	@param		PpsIdentity			Receives the identity of the file
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_FILE_NOT_FOUND	The file does not exist.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_GetFileIdentity(
+	_In_z_	const wchar_t*		PwszFileName,
+	_Out_	IfxFileIdentity*	PpsIdentity);
+
+/**
+ *	@brief		Check that a file is private to the effective user
+ *	@details	The file must be a regular file (not a symbolic link), owned by the effective user and not writable by the
+ *				group or others. Used for files whose content is trusted, e.g. cache files.
+ *
+ *	@param		PwszFileName		String containing the file name
+ *	@retval		RC_SUCCESS			The file is private to the effective user.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_FILE_NOT_FOUND	The file does not exist.
+ *	@retval		RC_E_ACCESS_DENIED	The file is not a regular file, owned by another user or writable by the group or others.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_CheckPrivate(
+	_In_z_	const wchar_t*	PwszFileName);
+
+/**
+ *	@brief		Open a private file for reading and writing and lock it exclusively
+ *	@details	The file is created accessible by the owner only if it does not exist. Symbolic links are not followed and
+ *				the opened file must pass the checks of FileIO_CheckPrivate. The function waits until no other process holds
+ *				the lock. The lock is released when the file is closed with FileIO_Close.
+ *
+ *	@param		PwszFileName		String containing the file name
+ *	@param		PppvFileHandle		Receives the handle of the opened and locked file
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_ACCESS_DENIED	The file is not a regular file, owned by another user or writable by the group or others.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_OpenLocked(
+	_In_z_	const wchar_t*	PwszFileName,
+	_Out_	void**			PppvFileHandle);
+
+/**
+ *	@brief		Replace the content of a file atomically
+ *	@details	The function writes the buffer to a temporary file in the same directory, flushes it to disk and renames it
+ *				over the target file. Readers see either the old or the new content, never a partially written file.
+ *
+ *	@param		PwszFileName		String containing the file to be replaced
+ *	@param		PrgbBuffer			Pointer to a byte buffer
+ *	@param		PunBufferSize		Number of bytes to be written to the file
+ *	@param		PfPrivate			TRUE: The file is accessible by the owner only, FALSE: The permissions of the replaced file are kept
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_WriteFileAtomic(
+	_In_z_							const wchar_t*	PwszFileName,
+	_In_bytecount_(PunBufferSize)	const BYTE*		PrgbBuffer,
+	_In_							unsigned int	PunBufferSize,
+	_In_							BOOL			PfPrivate);
+
+/**
+ *	@brief		Enumerate the files of a directory
+ *	@details	The function calls PfnCallback for every regular file (or link to a regular file) directly in the directory.
+ *				Sub directories are not entered. The order of the files is not defined.
+ *
+ *	@param		PwszDirectory		String containing the directory name
+ *	@param		PfnCallback			Function to be called for every file
+ *	@param		PpvContext			Context passed to PfnCallback
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_FILE_NOT_FOUND	The directory does not exist.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ *	@retval		...					Error codes returned by PfnCallback.
+ */
+_Check_return_
+unsigned int
+FileIO_EnumerateDirectory(
+	_In_z_		const wchar_t*					PwszDirectory,
+	_In_		PFN_FILEIO_ENUMERATE_CALLBACK	PfnCallback,
+	_In_opt_	void*							PpvContext);
+
 /**
  *	@brief		Read the whole content of a file into a wide char array
  *	@details	The function opens, reads and closes the file.
@@ -16,6 +16,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <wchar.h>
+#include <dirent.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
 #include "FileIO.h"
 #include "Platform.h"
 
@@ -726,7 +732,9 @@ FileIO_GetFileSize(
 			break;
 
 		// Restore original file pointer position
-		rewind((FILE*)PpvFileHandle);
+		unReturnValue = FileIO_SetPosition(PpvFileHandle, ullFilePosition);
+		if (RC_SUCCESS != unReturnValue)
+			break;
 
 		// Assign out parameter
 		*PpullFileSize = ullFileSize;
@@ -736,6 +744,61 @@ FileIO_GetFileSize(
 	return unReturnValue;
 }
 
+/**
+ *	@brief		Set the buffer of a file
+ *	@details	Makes the file fully buffered using the given caller owned buffer. Must be called before any
+ *				other operation on the file and the buffer must stay valid until the file is closed.
+ *	@param		PpvFileHandle		Handle to an open file
+ *	@param		PrgbBuffer			Buffer to be used by the file
+ *	@param		PunBufferSize		Size of the buffer in bytes
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. PpvFileHandle or PrgbBuffer is NULL or PunBufferSize is 0
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_SetBuffer(
+	_In_							const void*		PpvFileHandle,
+	_Inout_bytecap_(PunBufferSize)	BYTE*			PrgbBuffer,
+	_In_							unsigned int	PunBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	// Check parameters
+	if (NULL == PpvFileHandle || NULL == PrgbBuffer || 0 == PunBufferSize)
+		unReturnValue = RC_E_BAD_PARAMETER;
+
+	else if (0 == setvbuf((FILE*)PpvFileHandle, (char*)PrgbBuffer, _IOFBF, PunBufferSize))
+		unReturnValue = RC_SUCCESS;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Flush a file
+ *	@details	Writes all buffered data of the given file to the file system
+ *	@param		PpvFileHandle		Handle to an open file
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. PpvFileHandle is NULL
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_Flush(
+	_In_ const void* PpvFileHandle)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	// Check parameters
+	if (NULL == PpvFileHandle)
+		unReturnValue = RC_E_BAD_PARAMETER;
+
+	else if (0 == fflush((FILE*)PpvFileHandle))
+		unReturnValue = RC_SUCCESS;
+
+	return unReturnValue;
+}
+
 /**
  *	@brief		Read the whole content of a file into a byte array
  *	@details	The function opens, reads and closes the file.
@@ -843,6 +906,600 @@ FileIO_ReadFileToBuffer(
 	return unReturnValue;
 }
 
+/**
+ *	@brief		Map the whole content of a file read-only into memory
+ *	@details	The function opens the file, maps it read-only with mmap and closes the file again.
+ *				The kernel is advised that the mapping will be read sequentially. The content is not copied
+ *				and no heap memory is allocated. The mapping must be released with FileIO_UnmapFile.
+ *				Changes of the file show through the mapping and truncating it raises SIGBUS on access, so it is only
+ *				suitable for read-only checks. Use FileIO_ReadFileToBuffer for data which is sent to the TPM.
+ *
+ *	@param		PwszFileName		String containing the file to be mapped
+ *	@param		PprgbBuffer			Pointer to a byte array which receives
+ *									the address of the read-only mapping.
+ *	@param		PpunBufferSize		Number of bytes mapped.
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly. Or the file was too large.
+ *	@retval		RC_E_FAIL			An unexpected error occurred. Or the file was empty.
+ */
+_Check_return_
+unsigned int
+FileIO_MapFile(
+	_In_z_						const wchar_t*	PwszFileName,
+	_Outptr_result_maybenull_	BYTE**			PprgbBuffer,
+	_Out_						unsigned int*	PpunBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	FILE* pFile = NULL;
+
+	do
+	{
+		unsigned long long ullFileSize = 0;
+		void* pvMapping = NULL;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFileName) || NULL == PpunBufferSize || NULL == PprgbBuffer || NULL != *PprgbBuffer)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		*PpunBufferSize = 0;
+
+		// First open the file
+		unReturnValue = FileIO_Open(PwszFileName, (void**)(&pFile), FILE_READ_BINARY);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		if (NULL == pFile)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		// Second get the file size
+		unReturnValue = FileIO_GetFileSize(pFile, &ullFileSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		if (UINT_MAX < ullFileSize) // Callers can only handle limited size
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		if (0 == ullFileSize) // An empty file cannot be mapped
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		// Third map the whole file read-only
+		pvMapping = mmap(NULL, (size_t)ullFileSize, PROT_READ, MAP_PRIVATE, fileno(pFile), 0);
+		if (MAP_FAILED == pvMapping)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		// The content is read front to back, so allow aggressive read-ahead. This is only a hint.
+		IGNORE_RETURN_VALUE(madvise(pvMapping, (size_t)ullFileSize, MADV_SEQUENTIAL));
+
+		*PprgbBuffer = (BYTE*)pvMapping;
+		*PpunBufferSize = (unsigned int)ullFileSize;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	// Check if the file pointer is not NULL and close the file, the mapping stays valid
+	if (NULL != pFile)
+	{
+		unsigned int unReturnValueClose = RC_E_FAIL;
+		unReturnValueClose = FileIO_Close((void**)&pFile);
+		if (RC_SUCCESS != unReturnValueClose && RC_SUCCESS == unReturnValue)
+		{
+			IGNORE_RETURN_VALUE(FileIO_UnmapFile(PprgbBuffer, *PpunBufferSize));
+			*PpunBufferSize = 0;
+			unReturnValue = unReturnValueClose;
+		}
+	}
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Release a mapping created by FileIO_MapFile
+ *	@details	The function unmaps the memory and resets the pointer to NULL. A NULL mapping is ignored.
+ *
+ *	@param		PprgbBuffer			Pointer to the address of the mapping
+ *	@param		PunBufferSize		Number of bytes mapped as returned by FileIO_MapFile
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was NULL.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_UnmapFile(
+	_Inout_	BYTE**			PprgbBuffer,
+	_In_	unsigned int	PunBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		// Check parameters
+		if (NULL == PprgbBuffer)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		// Nothing mapped
+		if (NULL == *PprgbBuffer)
+		{
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+
+		if (0 != munmap(*PprgbBuffer, (size_t)PunBufferSize))
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		*PprgbBuffer = NULL;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Convert a file name to a multibyte string
+ *	@details	The file system functions expect multibyte file names.
+ *
+ *	@param		PwszFileName		String containing the file name
+ *	@param		PpszFileName		Receives the allocated multibyte file name. The caller must free it with Platform_MemoryFree.
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+static
+unsigned int
+FileIO_ConvertFileName(
+	_In_z_	const wchar_t*	PwszFileName,
+	_Out_	char**			PpszFileName)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		size_t sizeFileName = 0;
+		*PpszFileName = NULL;
+
+		// Get the required size for the multibyte string.
+		sizeFileName = wcsrtombs(NULL, &PwszFileName, 0, NULL);
+		if ((size_t) - 1 == sizeFileName)
+			break;
+
+		// Allocate memory for the multibyte string
+		*PpszFileName = (char*)Platform_MemoryAllocateZero((unsigned int)sizeFileName + 1);
+		if (NULL == *PpszFileName)
+			break;
+
+		// Convert the wide character string to a multibyte string.
+		sizeFileName = wcsrtombs(*PpszFileName, &PwszFileName, sizeFileName + 1, NULL);
+		if ((size_t) - 1 == sizeFileName)
+		{
+			Platform_MemoryFree((void**)PpszFileName);
+			break;
+		}
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Get the identity of a file
+ *	@details	The function reports device, inode, size and modification time of the file. Two files with the same
+ *				identity are treated as the same unmodified file.
+ *
+ *	@param		PwszFileName		String containing the file name
+ *	@param		PpsIdentity			Receives the identity of the file
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_FILE_NOT_FOUND	The file does not exist.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_GetFileIdentity(
+	_In_z_	const wchar_t*		PwszFileName,
+	_Out_	IfxFileIdentity*	PpsIdentity)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	char* szFileName = NULL;
+
+	do
+	{
+		struct stat sStat;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFileName) || NULL == PpsIdentity)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		memset(PpsIdentity, 0, sizeof(IfxFileIdentity));
+
+		unReturnValue = FileIO_ConvertFileName(PwszFileName, &szFileName);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		if (0 != stat(szFileName, &sStat))
+		{
+			unReturnValue = (ENOENT == errno) ? RC_E_FILE_NOT_FOUND : RC_E_FAIL;
+			break;
+		}
+
+		PpsIdentity->ullDevice = (unsigned long long)sStat.st_dev;
+		PpsIdentity->ullInode = (unsigned long long)sStat.st_ino;
+		PpsIdentity->ullSize = (unsigned long long)sStat.st_size;
+		PpsIdentity->ullModificationTime = (unsigned long long)sStat.st_mtim.tv_sec * 1000000000ULL + (unsigned long long)sStat.st_mtim.tv_nsec;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&szFileName);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Check the status of a file for FileIO_CheckPrivate
+ *	@details
+ *
+ *	@param		PpsStat				Status of the file
+ *	@retval		RC_SUCCESS			The file is private to the effective user.
+ *	@retval		RC_E_ACCESS_DENIED	The file is not a regular file, owned by another user or writable by the group or others.
+ */
+_Check_return_
+static
+unsigned int
+FileIO_CheckPrivateStat(
+	_In_	const struct stat*	PpsStat)
+{
+	unsigned int unReturnValue = RC_E_ACCESS_DENIED;
+
+	if (S_ISREG(PpsStat->st_mode) &&
+			geteuid() == PpsStat->st_uid &&
+			0 == (PpsStat->st_mode & (S_IWGRP | S_IWOTH)))
+		unReturnValue = RC_SUCCESS;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Check that a file is private to the effective user
+ *	@details	The file must be a regular file (not a symbolic link), owned by the effective user and not writable by the
+ *				group or others. Used for files whose content is trusted, e.g. cache files.
+ *
+ *	@param		PwszFileName		String containing the file name
+ *	@retval		RC_SUCCESS			The file is private to the effective user.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_FILE_NOT_FOUND	The file does not exist.
+ *	@retval		RC_E_ACCESS_DENIED	The file is not a regular file, owned by another user or writable by the group or others.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_CheckPrivate(
+	_In_z_	const wchar_t*	PwszFileName)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	char* szFileName = NULL;
+
+	do
+	{
+		struct stat sStat;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFileName))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		unReturnValue = FileIO_ConvertFileName(PwszFileName, &szFileName);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		// Do not follow symbolic links
+		if (0 != lstat(szFileName, &sStat))
+		{
+			unReturnValue = (ENOENT == errno) ? RC_E_FILE_NOT_FOUND : RC_E_FAIL;
+			break;
+		}
+
+		unReturnValue = FileIO_CheckPrivateStat(&sStat);
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&szFileName);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Open a private file for reading and writing and lock it exclusively
+ *	@details	The file is created accessible by the owner only if it does not exist. Symbolic links are not followed and
+ *				the opened file must pass the checks of FileIO_CheckPrivate. The function waits until no other process holds
+ *				the lock. The lock is released when the file is closed with FileIO_Close.
+ *
+ *	@param		PwszFileName		String containing the file name
+ *	@param		PppvFileHandle		Receives the handle of the opened and locked file
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_ACCESS_DENIED	The file is not a regular file, owned by another user or writable by the group or others.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_OpenLocked(
+	_In_z_	const wchar_t*	PwszFileName,
+	_Out_	void**			PppvFileHandle)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	char* szFileName = NULL;
+	int nFile = -1;
+
+	do
+	{
+		struct stat sStat;
+		FILE* pFile = NULL;
+		int nLock = -1;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFileName) || NULL == PppvFileHandle)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		*PppvFileHandle = NULL;
+
+		unReturnValue = FileIO_ConvertFileName(PwszFileName, &szFileName);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = RC_E_FAIL;
+
+		nFile = open(szFileName, O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+		if (-1 == nFile)
+		{
+			if (ELOOP == errno)
+				unReturnValue = RC_E_ACCESS_DENIED;
+			break;
+		}
+
+		// Check the opened file, not the path, so the file cannot be exchanged in between
+		if (0 != fstat(nFile, &sStat))
+			break;
+		unReturnValue = FileIO_CheckPrivateStat(&sStat);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = RC_E_FAIL;
+
+		// Wait for the lock, retry if interrupted by a signal
+		nLock = flock(nFile, LOCK_EX);
+		while (0 != nLock && EINTR == errno)
+			nLock = flock(nFile, LOCK_EX);
+		if (0 != nLock)
+			break;
+
+		pFile = fdopen(nFile, "r+b");
+		if (NULL == pFile)
+			break;
+		// The stream owns the file descriptor now
+		nFile = -1;
+
+		*PppvFileHandle = pFile;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	if (-1 != nFile)
+		IGNORE_RETURN_VALUE(close(nFile));
+	Platform_MemoryFree((void**)&szFileName);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Replace the content of a file atomically
+ *	@details	The function writes the buffer to a temporary file in the same directory, flushes it to disk and renames it
+ *				over the target file. Readers see either the old or the new content, never a partially written file.
+ *
+ *	@param		PwszFileName		String containing the file to be replaced
+ *	@param		PrgbBuffer			Pointer to a byte buffer
+ *	@param		PunBufferSize		Number of bytes to be written to the file
+ *	@param		PfPrivate			TRUE: The file is accessible by the owner only, FALSE: The permissions of the replaced file are kept
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FileIO_WriteFileAtomic(
+	_In_z_							const wchar_t*	PwszFileName,
+	_In_bytecount_(PunBufferSize)	const BYTE*		PrgbBuffer,
+	_In_							unsigned int	PunBufferSize,
+	_In_							BOOL			PfPrivate)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	char* szFileName = NULL;
+	char* szTempFileName = NULL;
+	int nFile = -1;
+	BOOL fTempFileCreated = FALSE;
+
+	do
+	{
+		const char szTemplateSuffix[] = ".XXXXXX";
+		size_t sizeFileName = 0;
+		unsigned int unWritten = 0;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFileName) || (NULL == PrgbBuffer && 0 != PunBufferSize))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		unReturnValue = FileIO_ConvertFileName(PwszFileName, &szFileName);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = RC_E_FAIL;
+
+		// Create the temporary file next to the target so that rename does not cross file systems
+		sizeFileName = strlen(szFileName);
+		szTempFileName = (char*)Platform_MemoryAllocateZero((unsigned int)(sizeFileName + sizeof(szTemplateSuffix)));
+		if (NULL == szTempFileName)
+			break;
+		memcpy(szTempFileName, szFileName, sizeFileName);
+		memcpy(szTempFileName + sizeFileName, szTemplateSuffix, sizeof(szTemplateSuffix));
+
+		nFile = mkstemp(szTempFileName);
+		if (-1 == nFile)
+			break;
+		fTempFileCreated = TRUE;
+
+		// mkstemp creates the file accessible by the owner only, keep the permissions of the replaced file otherwise
+		if (!PfPrivate)
+		{
+			struct stat sStat;
+			mode_t unMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+			if (0 == stat(szFileName, &sStat))
+				unMode = sStat.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO);
+			if (0 != fchmod(nFile, unMode))
+				break;
+		}
+
+		while (unWritten < PunBufferSize)
+		{
+			ssize_t nResult = write(nFile, PrgbBuffer + unWritten, PunBufferSize - unWritten);
+			if (-1 == nResult)
+			{
+				if (EINTR == errno)
+					continue;
+				break;
+			}
+			unWritten += (unsigned int)nResult;
+		}
+		if (unWritten != PunBufferSize || 0 != fsync(nFile))
+			break;
+
+		if (0 != close(nFile))
+		{
+			nFile = -1;
+			break;
+		}
+		nFile = -1;
+
+		if (0 != rename(szTempFileName, szFileName))
+			break;
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	// Remove the temporary file in case of an error
+	if (-1 != nFile)
+		IGNORE_RETURN_VALUE(close(nFile));
+	if (RC_SUCCESS != unReturnValue && fTempFileCreated)
+		IGNORE_RETURN_VALUE(unlink(szTempFileName));
+
+	Platform_MemoryFree((void**)&szTempFileName);
+	Platform_MemoryFree((void**)&szFileName);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Enumerate the files of a directory
+ *	@details	The function calls PfnCallback for every regular file (or link to a regular file) directly in the directory.
+ *				Sub directories are not entered. The order of the files is not defined.
+ *
+ *	@param		PwszDirectory		String containing the directory name
+ *	@param		PfnCallback			Function to be called for every file
+ *	@param		PpvContext			Context passed to PfnCallback
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function. It was either NULL or not initialized correctly.
+ *	@retval		RC_E_FILE_NOT_FOUND	The directory does not exist.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ *	@retval		...					Error codes returned by PfnCallback.
+ */
+_Check_return_
+unsigned int
+FileIO_EnumerateDirectory(
+	_In_z_		const wchar_t*					PwszDirectory,
+	_In_		PFN_FILEIO_ENUMERATE_CALLBACK	PfnCallback,
+	_In_opt_	void*							PpvContext)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	char* szDirectory = NULL;
+	DIR* pDirectory = NULL;
+
+	do
+	{
+		struct dirent* pEntry = NULL;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszDirectory) || NULL == PfnCallback)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		unReturnValue = FileIO_ConvertFileName(PwszDirectory, &szDirectory);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		pDirectory = opendir(szDirectory);
+		if (NULL == pDirectory)
+		{
+			unReturnValue = (ENOENT == errno) ? RC_E_FILE_NOT_FOUND : RC_E_FAIL;
+			break;
+		}
+
+		while (RC_SUCCESS == unReturnValue && NULL != (pEntry = readdir(pDirectory)))
+		{
+			wchar_t wszFileName[NAME_MAX + 1] = {0};
+			const char* szEntryName = pEntry->d_name;
+
+			// Skip everything except regular files, the type is only checked with fstatat if the file system does not report it
+			if (DT_REG != pEntry->d_type)
+			{
+				struct stat sStat;
+				if ((DT_LNK != pEntry->d_type && DT_UNKNOWN != pEntry->d_type) ||
+						0 != fstatat(dirfd(pDirectory), szEntryName, &sStat, 0) ||
+						!S_ISREG(sStat.st_mode))
+					continue;
+			}
+
+			// Skip names which cannot be represented as a wide character string
+			if ((size_t) - 1 == mbsrtowcs(wszFileName, &szEntryName, RG_LEN(wszFileName) - 1, NULL))
+				continue;
+
+			unReturnValue = PfnCallback(wszFileName, PpvContext);
+		}
+	}
+	WHILE_FALSE_END;
+
+	if (NULL != pDirectory)
+		IGNORE_RETURN_VALUE(closedir(pDirectory));
+	Platform_MemoryFree((void**)&szDirectory);
+
+	return unReturnValue;
+}
+
 /**
  *	@brief		Read the whole content of a file into a wide char array
  *	@details	The function opens, reads and closes the file.
@@ -0,0 +1,746 @@
+﻿/**
+ *	@brief		Implements the firmware catalog index
+ *	@details	Parses the headers of all firmware images in a folder once and keeps them in an index file for the image selection
+ *	@file		FirmwareCatalog.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "FirmwareCatalog.h"
+#include "FileIO.h"
+#include "Crypt.h"
+#include "Logging.h"
+#include "Platform.h"
+
+/// Magic value at the start of the index file ("IFXI")
+#define FIRMWARE_CATALOG_MAGIC				0x49584649
+/// Version of the index file format
+#define FIRMWARE_CATALOG_VERSION			3
+/// Maximum number of firmware images in one index
+#define FIRMWARE_CATALOG_MAX_ENTRIES		4096
+/// Number of entries the entry list grows by
+#define FIRMWARE_CATALOG_ENTRIES_INCREMENT	64
+
+/// Header of the index file. Its size is a multiple of 8 bytes, so that the entries following it are aligned for
+/// their 64-bit fields and can be accessed in place.
+typedef struct tdIfxFirmwareCatalogHeader
+{
+	/// FIRMWARE_CATALOG_MAGIC
+	UINT32 unMagic;
+	/// FIRMWARE_CATALOG_VERSION
+	UINT32 unVersion;
+	/// Size of one entry in bytes
+	UINT32 unEntrySize;
+	/// Number of entries following the header
+	UINT32 unEntryCount;
+	/// CRC over all entries
+	UINT32 unEntriesCrc;
+	/// Reserved, always 0
+	UINT32 unReserved;
+} IfxFirmwareCatalogHeader;
+
+/// Entry of the index file describing one firmware image. Strings are stored as zero terminated UTF-16 code units.
+/// The integer source versions of the image are not stored, they are only checked for a TPM in boot loader mode and
+/// the image is selected by its string source versions like in FirmwareUpdate_IsFirmwareUpdatable.
+typedef struct tdIfxFirmwareCatalogEntry
+{
+	/// Source TPM family
+	UINT8 bSourceTpmFamily;
+	/// Target TPM family
+	UINT8 bTargetTpmFamily;
+	/// Count of the allowed source versions
+	UINT16 usSourceVersionsCount;
+	/// bfTargetState.factoryDefaults of the image
+	UINT8 bTargetFactoryDefaults;
+	/// Reserved, always 0
+	UINT8 bReserved;
+	/// Allowed source versions
+	UINT16 rgusSourceVersions[MAX_SOURCE_VERSIONS_COUNT][FIRMWARE_CATALOG_MAX_VERSION];
+	/// Target version
+	UINT16 rgusTargetVersion[FIRMWARE_CATALOG_MAX_VERSION];
+	/// File name of the image without the folder part
+	UINT16 rgusFileName[FIRMWARE_CATALOG_MAX_FILE_NAME];
+	/// Size of the image file in bytes
+	unsigned long long ullFileSize;
+	/// Last modification time of the image file in nanoseconds since the epoch
+	unsigned long long ullModificationTime;
+	/// SHA-256 digest over the whole image file. Not checked by the lookup, which only compares size and modification time
+	/// to stay cheap. It identifies the indexed image, so the index can be checked against a list of published image digests.
+	BYTE rgbDigest[SHA256_DIGEST_SIZE];
+} IfxFirmwareCatalogEntry;
+
+/// Context of FirmwareCatalog_AddFile
+typedef struct tdIfxFirmwareCatalogBuild
+{
+	/// Firmware folder
+	const wchar_t* pwszFolder;
+	/// Entry list
+	IfxFirmwareCatalogEntry* rgsEntries;
+	/// Number of entries in the list
+	unsigned int unEntryCount;
+	/// Capacity of the entry list
+	unsigned int unEntryCapacity;
+	/// Number of skipped files
+	unsigned int unSkippedCount;
+} IfxFirmwareCatalogBuild;
+
+/**
+ *	@brief		Store a string in an index entry
+ *	@details
+ *
+ *	@param		PwszSource			String to store
+ *	@param		PrgusDestination	Receives the zero terminated UTF-16 code units
+ *	@param		PunCapacity			Capacity of PrgusDestination in code units
+ *
+ *	@retval		TRUE				The string was stored.
+ *	@retval		FALSE				The string is too long or cannot be represented.
+ */
+static
+BOOL
+FirmwareCatalog_StoreString(
+	_In_z_						const wchar_t*	PwszSource,
+	_Out_writes_z_(PunCapacity)	UINT16*			PrgusDestination,
+	_In_						unsigned int	PunCapacity)
+{
+	unsigned int unIndex = 0;
+
+	for (; unIndex < PunCapacity; unIndex++)
+	{
+		if ((unsigned long)PwszSource[unIndex] > 0xFFFF)
+			break;
+		PrgusDestination[unIndex] = (UINT16)PwszSource[unIndex];
+		if (L'\0' == PwszSource[unIndex])
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ *	@brief		Load a string of an index entry
+ *	@details
+ *
+ *	@param		PrgusStored			Zero terminated UTF-16 code units of the index entry
+ *	@param		PunCapacity			Capacity of PrgusStored in code units
+ *	@param		PwszDestination		Receives the zero terminated string, must have a capacity of PunCapacity characters
+ */
+static
+void
+FirmwareCatalog_LoadString(
+	_In_reads_z_(PunCapacity)		const UINT16*	PrgusStored,
+	_In_							unsigned int	PunCapacity,
+	_Out_writes_z_(PunCapacity)		wchar_t*		PwszDestination)
+{
+	unsigned int unIndex = 0;
+
+	for (; unIndex < PunCapacity - 1 && 0 != PrgusStored[unIndex]; unIndex++)
+		PwszDestination[unIndex] = (wchar_t)PrgusStored[unIndex];
+	PwszDestination[unIndex] = L'\0';
+}
+
+/**
+ *	@brief		Check whether a TPM firmware version matches an allowed source version of a firmware image
+ *	@details	The TPM firmware version matches with and without subversion.minor like in FirmwareUpdate_IsFirmwareUpdatable,
+ *				e.g. "7.85.4555.0" matches the allowed source versions "7.85.4555.0" and "7.85.4555".
+ *
+ *	@param		PwszAllowedVersion	Allowed source version of the firmware image
+ *	@param		PwszVersion			TPM firmware version
+ *
+ *	@retval		TRUE				The version matches.
+ *	@retval		FALSE				Otherwise.
+ */
+BOOL
+FirmwareCatalog_MatchesSourceVersion(
+	_In_z_	const wchar_t*	PwszAllowedVersion,
+	_In_z_	const wchar_t*	PwszVersion)
+{
+	BOOL fMatch = FALSE;
+
+	do
+	{
+		unsigned int unLength = 0;
+		unsigned int unShortLength = 0;
+		unsigned int unAllowedLength = 0;
+
+		if (NULL == PwszAllowedVersion || NULL == PwszVersion ||
+				RC_SUCCESS != Platform_StringGetLength(PwszVersion, MAX_NAME, &unLength) ||
+				RC_SUCCESS != Platform_StringGetLength(PwszAllowedVersion, MAX_NAME, &unAllowedLength))
+			break;
+
+		// The version without subversion.minor ends in front of the last dot
+		for (unShortLength = unLength; unShortLength > 0; unShortLength--)
+		{
+			if (L'.' == PwszVersion[unShortLength - 1])
+				break;
+		}
+		if (unShortLength > 0)
+			unShortLength--;
+
+		fMatch =
+			(unAllowedLength == unLength && 0 == Platform_StringCompare(PwszAllowedVersion, PwszVersion, unLength, FALSE)) ||
+			(0 != unShortLength && unAllowedLength == unShortLength &&
+			0 == Platform_StringCompare(PwszAllowedVersion, PwszVersion, unShortLength, FALSE));
+	}
+	WHILE_FALSE_END;
+
+	return fMatch;
+}
+
+/**
+ *	@brief		Read and validate the index file of a firmware folder
+ *	@details
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PprgbIndex			Receives the content of the index file allocated on the heap; must be freed with Platform_MemoryFree
+ *	@param		PpunEntryCount		Receives the number of entries following the header
+ *
+ *	@retval		TRUE				The index file is valid.
+ *	@retval		FALSE				The index file is missing, outdated or corrupt.
+ */
+static
+BOOL
+FirmwareCatalog_ReadIndex(
+	_In_z_						const wchar_t*	PwszFolder,
+	_Outptr_result_maybenull_	BYTE**			PprgbIndex,
+	_Out_						unsigned int*	PpunEntryCount)
+{
+	BOOL fValid = FALSE;
+	unsigned int unIndexSize = 0;
+
+	*PprgbIndex = NULL;
+	*PpunEntryCount = 0;
+
+	do
+	{
+		wchar_t wszIndexPath[MAX_PATH] = {0};
+		unsigned int unIndexPathSize = RG_LEN(wszIndexPath);
+		IfxFirmwareCatalogHeader sHeader = {0};
+		unsigned int unCrc = 0;
+
+		if (RC_SUCCESS != Platform_StringCopy(wszIndexPath, &unIndexPathSize, PwszFolder))
+			break;
+		unIndexPathSize = RG_LEN(wszIndexPath);
+		if (RC_SUCCESS != Platform_StringConcatenatePaths(wszIndexPath, &unIndexPathSize, FIRMWARE_CATALOG_FILE_NAME))
+			break;
+		if (!FileIO_Exists(wszIndexPath))
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Firmware catalog: No index file found (%ls).", wszIndexPath);
+			break;
+		}
+		if (RC_SUCCESS != FileIO_ReadFileToBuffer(wszIndexPath, PprgbIndex, &unIndexSize))
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Firmware catalog: Cannot read the index file (%ls).", wszIndexPath);
+			break;
+		}
+
+		if (unIndexSize >= sizeof(sHeader))
+			IGNORE_RETURN_VALUE(Platform_MemoryCopy(&sHeader, sizeof(sHeader), *PprgbIndex, sizeof(sHeader)));
+		if (FIRMWARE_CATALOG_MAGIC != sHeader.unMagic ||
+				FIRMWARE_CATALOG_VERSION != sHeader.unVersion ||
+				sizeof(IfxFirmwareCatalogEntry) != sHeader.unEntrySize ||
+				sHeader.unEntryCount > FIRMWARE_CATALOG_MAX_ENTRIES ||
+				unIndexSize != sizeof(sHeader) + sHeader.unEntryCount * sizeof(IfxFirmwareCatalogEntry) ||
+				(0 != sHeader.unEntryCount &&
+				(RC_SUCCESS != Crypt_CRC(*PprgbIndex + sizeof(sHeader), (int)(unIndexSize - sizeof(sHeader)), &unCrc) || unCrc != sHeader.unEntriesCrc)))
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Firmware catalog: Ignoring the outdated or corrupt index file (%ls).", wszIndexPath);
+			break;
+		}
+
+		*PpunEntryCount = sHeader.unEntryCount;
+		fValid = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	if (!fValid)
+		Platform_MemoryFree((void**)PprgbIndex);
+
+	return fValid;
+}
+
+/**
+ *	@brief		Check that the image file of an index entry has not been changed since the index was built
+ *	@details	Compares the size and modification time of the image file with the index entry.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PpEntry				Index entry
+ *	@param		PwszFileName		Receives the file name of the entry
+ *	@param		PunFileNameSize		Capacity of PwszFileName in wide characters
+ *	@param		PpunFileNameLength	Receives the length of the file name
+ *
+ *	@retval		TRUE				The entry is current.
+ *	@retval		FALSE				The entry is stale.
+ */
+static
+BOOL
+FirmwareCatalog_IsEntryCurrent(
+	_In_z_							const wchar_t*					PwszFolder,
+	_In_							const IfxFirmwareCatalogEntry*	PpEntry,
+	_Out_writes_z_(PunFileNameSize)	wchar_t*						PwszFileName,
+	_In_							unsigned int					PunFileNameSize,
+	_Out_							unsigned int*					PpunFileNameLength)
+{
+	BOOL fCurrent = FALSE;
+
+	do
+	{
+		wchar_t wszFilePath[MAX_PATH] = {0};
+		unsigned int unFilePathSize = RG_LEN(wszFilePath);
+		IfxFileIdentity sIdentity = {0};
+		unsigned int unLength = 0;
+
+		*PpunFileNameLength = 0;
+		if (PunFileNameSize < FIRMWARE_CATALOG_MAX_FILE_NAME)
+			break;
+		for (unLength = 0; unLength < FIRMWARE_CATALOG_MAX_FILE_NAME - 1 && 0 != PpEntry->rgusFileName[unLength]; unLength++)
+			PwszFileName[unLength] = (wchar_t)PpEntry->rgusFileName[unLength];
+		PwszFileName[unLength] = L'\0';
+
+		if (RC_SUCCESS != Platform_StringCopy(wszFilePath, &unFilePathSize, PwszFolder))
+			break;
+		unFilePathSize = RG_LEN(wszFilePath);
+		if (RC_SUCCESS != Platform_StringConcatenatePaths(wszFilePath, &unFilePathSize, PwszFileName) ||
+				RC_SUCCESS != FileIO_GetFileIdentity(wszFilePath, &sIdentity) ||
+				sIdentity.ullSize != PpEntry->ullFileSize ||
+				sIdentity.ullModificationTime != PpEntry->ullModificationTime)
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Firmware catalog: The index entry for '%ls' is stale, rebuild the index.", PwszFileName);
+			PwszFileName[0] = L'\0';
+			break;
+		}
+
+		*PpunFileNameLength = unLength;
+		fCurrent = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	return fCurrent;
+}
+
+/**
+ *	@brief		Add a file of the firmware folder to the index
+ *	@details	Callback for FileIO_EnumerateDirectory. Files which are not firmware images are counted as skipped.
+ *
+ *	@param		PwszFileName		Name of the file without the folder part
+ *	@param		PpvContext			IfxFirmwareCatalogBuild context
+ *	@retval		RC_SUCCESS			The file was added or skipped.
+ *	@retval		RC_E_FAIL			Too many firmware images or out of memory.
+ */
+_Check_return_
+static
+unsigned int
+FirmwareCatalog_AddFile(
+	_In_z_		const wchar_t*	PwszFileName,
+	_In_opt_	void*			PpvContext)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	IfxFirmwareCatalogBuild* pBuild = (IfxFirmwareCatalogBuild*)PpvContext;
+	BYTE* rgbImage = NULL;
+	unsigned int unImageSize = 0;
+
+	do
+	{
+		wchar_t wszFilePath[MAX_PATH] = {0};
+		unsigned int unFilePathSize = RG_LEN(wszFilePath);
+		IfxFileIdentity sIdentity = {0};
+		IfxFirmwareImage sFirmwareImage = {{0}};
+		IfxFirmwareCatalogEntry* pEntry = NULL;
+		BYTE* pbBuffer = NULL;
+		INT32 nBufferSize = 0;
+		BOOL fStored = TRUE;
+		unsigned int unIndex = 0;
+
+		// Skip the index file itself and temporary files of an interrupted index update
+		if (0 == Platform_StringCompare(PwszFileName, FIRMWARE_CATALOG_FILE_NAME, RG_LEN(FIRMWARE_CATALOG_FILE_NAME) - 1, TRUE))
+			break;
+
+		unReturnValue = Platform_StringCopy(wszFilePath, &unFilePathSize, pBuild->pwszFolder);
+		if (RC_SUCCESS == unReturnValue)
+		{
+			unFilePathSize = RG_LEN(wszFilePath);
+			unReturnValue = Platform_StringConcatenatePaths(wszFilePath, &unFilePathSize, PwszFileName);
+		}
+		if (RC_SUCCESS == unReturnValue)
+			unReturnValue = FileIO_GetFileIdentity(wszFilePath, &sIdentity);
+		if (RC_SUCCESS == unReturnValue)
+			unReturnValue = FileIO_MapFile(wszFilePath, &rgbImage, &unImageSize);
+		if (RC_SUCCESS == unReturnValue)
+		{
+			pbBuffer = rgbImage;
+			nBufferSize = (INT32)unImageSize;
+			unReturnValue = FirmwareImage_Unmarshal(&sFirmwareImage, &pbBuffer, &nBufferSize);
+		}
+		if (RC_SUCCESS != unReturnValue)
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Firmware catalog: Skipping '%ls', it is not a firmware image (0x%.8X).", PwszFileName, unReturnValue);
+			pBuild->unSkippedCount++;
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+
+		// Grow the entry list if required
+		if (pBuild->unEntryCount == pBuild->unEntryCapacity)
+		{
+			IfxFirmwareCatalogEntry* rgsEntries = NULL;
+			unsigned int unEntryCapacity = pBuild->unEntryCapacity + FIRMWARE_CATALOG_ENTRIES_INCREMENT;
+
+			if (unEntryCapacity > FIRMWARE_CATALOG_MAX_ENTRIES)
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE_FMT(unReturnValue, L"The firmware folder contains more than %d firmware images.", FIRMWARE_CATALOG_MAX_ENTRIES);
+				break;
+			}
+			rgsEntries = (IfxFirmwareCatalogEntry*)Platform_MemoryAllocateZero(unEntryCapacity * sizeof(IfxFirmwareCatalogEntry));
+			if (NULL == rgsEntries)
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE(unReturnValue, L"Memory allocation failed.");
+				break;
+			}
+			if (0 != pBuild->unEntryCount)
+				IGNORE_RETURN_VALUE(Platform_MemoryCopy(rgsEntries, unEntryCapacity * sizeof(IfxFirmwareCatalogEntry), pBuild->rgsEntries, pBuild->unEntryCount * sizeof(IfxFirmwareCatalogEntry)));
+			Platform_MemoryFree((void**)&pBuild->rgsEntries);
+			pBuild->rgsEntries = rgsEntries;
+			pBuild->unEntryCapacity = unEntryCapacity;
+		}
+
+		// Fill the entry
+		pEntry = &pBuild->rgsEntries[pBuild->unEntryCount];
+		pEntry->bSourceTpmFamily = sFirmwareImage.bSourceTpmFamily;
+		pEntry->bTargetTpmFamily = sFirmwareImage.bTargetTpmFamily;
+		pEntry->usSourceVersionsCount = sFirmwareImage.usSourceVersionsCount;
+		pEntry->bTargetFactoryDefaults = (UINT8)sFirmwareImage.bfTargetState.factoryDefaults;
+		for (unIndex = 0; unIndex < sFirmwareImage.usSourceVersionsCount && unIndex < MAX_SOURCE_VERSIONS_COUNT; unIndex++)
+			fStored &= FirmwareCatalog_StoreString(sFirmwareImage.rgwszSourceVersions[unIndex], pEntry->rgusSourceVersions[unIndex], FIRMWARE_CATALOG_MAX_VERSION);
+		fStored &= FirmwareCatalog_StoreString(sFirmwareImage.wszTargetVersion, pEntry->rgusTargetVersion, FIRMWARE_CATALOG_MAX_VERSION);
+		fStored &= FirmwareCatalog_StoreString(PwszFileName, pEntry->rgusFileName, FIRMWARE_CATALOG_MAX_FILE_NAME);
+		if (!fStored)
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Firmware catalog: Skipping '%ls', a version or the file name is too long.", PwszFileName);
+			IGNORE_RETURN_VALUE(Platform_MemorySet(pEntry, 0, sizeof(IfxFirmwareCatalogEntry)));
+			pBuild->unSkippedCount++;
+			break;
+		}
+		pEntry->ullFileSize = sIdentity.ullSize;
+		pEntry->ullModificationTime = sIdentity.ullModificationTime;
+		unReturnValue = Crypt_SHA256(rgbImage, unImageSize, pEntry->rgbDigest);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			ERROR_STORE_FMT(unReturnValue, L"Crypt_SHA256 failed for '%ls'.", PwszFileName);
+			break;
+		}
+
+		LOGGING_WRITE_LEVEL3_FMT(L"Firmware catalog: Indexed '%ls' (%ls).", PwszFileName, sFirmwareImage.wszTargetVersion);
+		pBuild->unEntryCount++;
+	}
+	WHILE_FALSE_END;
+
+	IGNORE_RETURN_VALUE(FileIO_UnmapFile(&rgbImage, unImageSize));
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Build the catalog index of a firmware folder
+ *	@details	Parses the header of every file in the folder with FirmwareImage_Unmarshal and writes the source and target
+ *				versions, file name, size and SHA-256 digest of all firmware images to FIRMWARE_CATALOG_FILE_NAME in the same
+ *				folder. Files which are not firmware images are skipped. The index file is replaced atomically.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PpunImageCount		Receives the number of indexed firmware images
+ *	@param		PpunSkippedCount	Receives the number of skipped files
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		RC_E_FILE_NOT_FOUND	The firmware folder does not exist.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ *	@retval		...					Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FirmwareCatalog_Build(
+	_In_z_	const wchar_t*	PwszFolder,
+	_Out_	unsigned int*	PpunImageCount,
+	_Out_	unsigned int*	PpunSkippedCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	IfxFirmwareCatalogBuild sBuild = {0};
+	BYTE* rgbIndex = NULL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		wchar_t wszIndexPath[MAX_PATH] = {0};
+		unsigned int unIndexPathSize = RG_LEN(wszIndexPath);
+		IfxFirmwareCatalogHeader sHeader = {0};
+		unsigned int unEntriesSize = 0;
+		unsigned int unCrc = 0;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFolder) || NULL == PpunImageCount || NULL == PpunSkippedCount)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Bad parameter detected.");
+			break;
+		}
+		*PpunImageCount = 0;
+		*PpunSkippedCount = 0;
+
+		// Parse all files of the folder
+		sBuild.pwszFolder = PwszFolder;
+		unReturnValue = FileIO_EnumerateDirectory(PwszFolder, &FirmwareCatalog_AddFile, &sBuild);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			ERROR_STORE_FMT(unReturnValue, L"The firmware folder '%ls' cannot be read.", PwszFolder);
+			break;
+		}
+
+		// Compose the index file
+		unEntriesSize = sBuild.unEntryCount * sizeof(IfxFirmwareCatalogEntry);
+		if (0 != unEntriesSize)
+		{
+			unReturnValue = Crypt_CRC(sBuild.rgsEntries, (int)unEntriesSize, &unCrc);
+			if (RC_SUCCESS != unReturnValue)
+			{
+				ERROR_STORE(unReturnValue, L"Crypt_CRC returned an unexpected value.");
+				break;
+			}
+		}
+		sHeader.unMagic = FIRMWARE_CATALOG_MAGIC;
+		sHeader.unVersion = FIRMWARE_CATALOG_VERSION;
+		sHeader.unEntrySize = sizeof(IfxFirmwareCatalogEntry);
+		sHeader.unEntryCount = sBuild.unEntryCount;
+		sHeader.unEntriesCrc = unCrc;
+
+		rgbIndex = (BYTE*)Platform_MemoryAllocateZero(sizeof(sHeader) + unEntriesSize);
+		if (NULL == rgbIndex)
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE(unReturnValue, L"Memory allocation failed.");
+			break;
+		}
+		IGNORE_RETURN_VALUE(Platform_MemoryCopy(rgbIndex, sizeof(sHeader) + unEntriesSize, &sHeader, sizeof(sHeader)));
+		if (0 != unEntriesSize)
+			IGNORE_RETURN_VALUE(Platform_MemoryCopy(rgbIndex + sizeof(sHeader), unEntriesSize, sBuild.rgsEntries, unEntriesSize));
+
+		// Write the index file
+		unReturnValue = Platform_StringCopy(wszIndexPath, &unIndexPathSize, PwszFolder);
+		if (RC_SUCCESS == unReturnValue)
+		{
+			unIndexPathSize = RG_LEN(wszIndexPath);
+			unReturnValue = Platform_StringConcatenatePaths(wszIndexPath, &unIndexPathSize, FIRMWARE_CATALOG_FILE_NAME);
+		}
+		if (RC_SUCCESS != unReturnValue)
+		{
+			ERROR_STORE(unReturnValue, L"The index file path is too long.");
+			break;
+		}
+		unReturnValue = FileIO_WriteFileAtomic(wszIndexPath, rgbIndex, sizeof(sHeader) + unEntriesSize, FALSE);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			ERROR_STORE_FMT(unReturnValue, L"The index file '%ls' cannot be written.", wszIndexPath);
+			break;
+		}
+
+		*PpunImageCount = sBuild.unEntryCount;
+		*PpunSkippedCount = sBuild.unSkippedCount;
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&rgbIndex);
+	Platform_MemoryFree((void**)&sBuild.rgsEntries);
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Look up a firmware image in the catalog index of a firmware folder
+ *	@details	Searches the index for an image which can be installed on the given source family and version and updates
+ *				to the given target version. The source version matches with FirmwareCatalog_MatchesSourceVersion. An entry is only returned if the size and modification time of the image file
+ *				still match the index. A missing or corrupt index, a stale entry or no match results in FALSE and the
+ *				caller falls back to the file name convention.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PbSourceFamily		Source TPM family (DEVICE_TYPE_TPM_12 or DEVICE_TYPE_TPM_20)
+ *	@param		PwszSourceVersion	Current TPM firmware version (e.g. "7.85.4555.0")
+ *	@param		PwszTargetVersion	Target TPM firmware version
+ *	@param		PwszFileName		Receives the file name of the firmware image without the folder part
+ *	@param		PpunFileNameSize	In: capacity of PwszFileName in wide characters. Out: length of the file name.
+ *
+ *	@retval		TRUE				A current index entry was found.
+ *	@retval		FALSE				No current index entry was found.
+ */
+_Check_return_
+BOOL
+FirmwareCatalog_Lookup(
+	_In_z_						const wchar_t*	PwszFolder,
+	_In_						BYTE			PbSourceFamily,
+	_In_z_						const wchar_t*	PwszSourceVersion,
+	_In_z_						const wchar_t*	PwszTargetVersion,
+	_Out_z_cap_(*PpunFileNameSize)	wchar_t*		PwszFileName,
+	_Inout_						unsigned int*	PpunFileNameSize)
+{
+	BOOL fFound = FALSE;
+	BYTE* rgbIndex = NULL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		const IfxFirmwareCatalogEntry* rgsEntries = NULL;
+		unsigned int unEntryCount = 0;
+		unsigned int unEntry = 0;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFolder) || NULL == PwszSourceVersion || NULL == PwszTargetVersion ||
+				NULL == PwszFileName || NULL == PpunFileNameSize || 0 == *PpunFileNameSize)
+			break;
+
+		// Read the index file
+		if (!FirmwareCatalog_ReadIndex(PwszFolder, &rgbIndex, &unEntryCount))
+			break;
+		rgsEntries = (const IfxFirmwareCatalogEntry*)(rgbIndex + sizeof(IfxFirmwareCatalogHeader));
+
+		// Search the matching entry
+		for (unEntry = 0; unEntry < unEntryCount && !fFound; unEntry++)
+		{
+			const IfxFirmwareCatalogEntry* pEntry = &rgsEntries[unEntry];
+			wchar_t wszVersion[FIRMWARE_CATALOG_MAX_VERSION] = {0};
+			BOOL fSourceVersionMatch = FALSE;
+			unsigned int unIndex = 0;
+			unsigned int unFileNameLength = 0;
+
+			if (PbSourceFamily != pEntry->bSourceTpmFamily)
+				continue;
+			FirmwareCatalog_LoadString(pEntry->rgusTargetVersion, FIRMWARE_CATALOG_MAX_VERSION, wszVersion);
+			if (0 != Platform_StringCompare(wszVersion, PwszTargetVersion, FIRMWARE_CATALOG_MAX_VERSION, FALSE))
+				continue;
+
+			for (unIndex = 0; unIndex < pEntry->usSourceVersionsCount && unIndex < MAX_SOURCE_VERSIONS_COUNT && !fSourceVersionMatch; unIndex++)
+			{
+				FirmwareCatalog_LoadString(pEntry->rgusSourceVersions[unIndex], FIRMWARE_CATALOG_MAX_VERSION, wszVersion);
+				fSourceVersionMatch = FirmwareCatalog_MatchesSourceVersion(wszVersion, PwszSourceVersion);
+			}
+			if (!fSourceVersionMatch)
+				continue;
+
+			// Check that the image file has not been changed since the index was built
+			if (!FirmwareCatalog_IsEntryCurrent(PwszFolder, pEntry, PwszFileName, *PpunFileNameSize, &unFileNameLength))
+				continue;
+
+			*PpunFileNameSize = unFileNameLength;
+			fFound = TRUE;
+		}
+
+		LOGGING_WRITE_LEVEL2_FMT(L"Firmware catalog: %ls for %ls to %ls.", fFound ? L"Hit" : L"Miss", PwszSourceVersion, PwszTargetVersion);
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&rgbIndex);
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, fFound);
+
+	return fFound;
+}
+
+/**
+ *	@brief		Get all firmware images from the catalog index of a firmware folder
+ *	@details	Returns the current entries of the index. Entries whose image file has been changed or removed since the
+ *				index was built are left out.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PprgsImages			Receives the image list allocated on the heap; must be freed with Platform_MemoryFree
+ *	@param		PpunImageCount		Receives the number of images in the list
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		RC_E_FILE_NOT_FOUND	The folder does not contain a valid index file.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FirmwareCatalog_GetImages(
+	_In_z_						const wchar_t*				PwszFolder,
+	_Outptr_result_maybenull_	IfxFirmwareCatalogImage**	PprgsImages,
+	_Out_						unsigned int*				PpunImageCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	BYTE* rgbIndex = NULL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		const IfxFirmwareCatalogEntry* rgsEntries = NULL;
+		unsigned int unEntryCount = 0;
+		unsigned int unEntry = 0;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFolder) || NULL == PprgsImages || NULL == PpunImageCount)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Bad parameter detected.");
+			break;
+		}
+		*PprgsImages = NULL;
+		*PpunImageCount = 0;
+
+		// Read the index file
+		if (!FirmwareCatalog_ReadIndex(PwszFolder, &rgbIndex, &unEntryCount))
+		{
+			unReturnValue = RC_E_FILE_NOT_FOUND;
+			break;
+		}
+		rgsEntries = (const IfxFirmwareCatalogEntry*)(rgbIndex + sizeof(IfxFirmwareCatalogHeader));
+
+		if (0 != unEntryCount)
+		{
+			*PprgsImages = (IfxFirmwareCatalogImage*)Platform_MemoryAllocateZero(unEntryCount * sizeof(IfxFirmwareCatalogImage));
+			if (NULL == *PprgsImages)
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE(unReturnValue, L"Memory allocation failed.");
+				break;
+			}
+		}
+
+		// Decode the current entries
+		for (unEntry = 0; unEntry < unEntryCount; unEntry++)
+		{
+			const IfxFirmwareCatalogEntry* pEntry = &rgsEntries[unEntry];
+			IfxFirmwareCatalogImage* pImage = &(*PprgsImages)[*PpunImageCount];
+			unsigned int unFileNameLength = 0;
+			unsigned int unIndex = 0;
+
+			if (!FirmwareCatalog_IsEntryCurrent(PwszFolder, pEntry, pImage->wszFileName, RG_LEN(pImage->wszFileName), &unFileNameLength))
+				continue;
+
+			pImage->bSourceTpmFamily = pEntry->bSourceTpmFamily;
+			pImage->bTargetTpmFamily = pEntry->bTargetTpmFamily;
+			pImage->fFactoryDefaults = pEntry->bSourceTpmFamily != pEntry->bTargetTpmFamily || 0 != pEntry->bTargetFactoryDefaults;
+			pImage->ullFileSize = pEntry->ullFileSize;
+			for (unIndex = 0; unIndex < pEntry->usSourceVersionsCount && unIndex < MAX_SOURCE_VERSIONS_COUNT; unIndex++)
+				FirmwareCatalog_LoadString(pEntry->rgusSourceVersions[unIndex], FIRMWARE_CATALOG_MAX_VERSION, pImage->rgwszSourceVersions[unIndex]);
+			pImage->unSourceVersionsCount = unIndex;
+			FirmwareCatalog_LoadString(pEntry->rgusTargetVersion, FIRMWARE_CATALOG_MAX_VERSION, pImage->wszTargetVersion);
+
+			(*PpunImageCount)++;
+		}
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&rgbIndex);
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
@@ -0,0 +1,139 @@
+﻿/**
+ *	@brief		Declares the firmware catalog index
+ *	@details	Maps source family and version of the firmware images in a folder to target version and file name
+ *	@file		FirmwareCatalog.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+#include "FirmwareImage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// File name of the catalog index inside a firmware folder
+#define FIRMWARE_CATALOG_FILE_NAME		L"FirmwareCatalog.idx"
+/// Maximum length of a version string in the index including the terminating zero
+#define FIRMWARE_CATALOG_MAX_VERSION	24
+/// Maximum length of a file name in the index including the terminating zero
+#define FIRMWARE_CATALOG_MAX_FILE_NAME	128
+
+/// Firmware image of the catalog index as returned by FirmwareCatalog_GetImages
+typedef struct tdIfxFirmwareCatalogImage
+{
+	/// Source TPM family
+	BYTE bSourceTpmFamily;
+	/// Target TPM family
+	BYTE bTargetTpmFamily;
+	/// The TPM is reset to factory defaults by the update (bfTargetState.factoryDefaults or a family change)
+	BOOL fFactoryDefaults;
+	/// Count of the allowed source versions
+	unsigned int unSourceVersionsCount;
+	/// Allowed source versions
+	wchar_t rgwszSourceVersions[MAX_SOURCE_VERSIONS_COUNT][FIRMWARE_CATALOG_MAX_VERSION];
+	/// Target version
+	wchar_t wszTargetVersion[FIRMWARE_CATALOG_MAX_VERSION];
+	/// File name of the image without the folder part
+	wchar_t wszFileName[FIRMWARE_CATALOG_MAX_FILE_NAME];
+	/// Size of the image file in bytes
+	unsigned long long ullFileSize;
+} IfxFirmwareCatalogImage;
+
+/**
+ *	@brief		Build the catalog index of a firmware folder
+ *	@details	Parses the header of every file in the folder with FirmwareImage_Unmarshal and writes the source and target
+ *				versions, file name, size and SHA-256 digest of all firmware images to FIRMWARE_CATALOG_FILE_NAME in the same
+ *				folder. Files which are not firmware images are skipped. The index file is replaced atomically.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PpunImageCount		Receives the number of indexed firmware images
+ *	@param		PpunSkippedCount	Receives the number of skipped files
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		RC_E_FILE_NOT_FOUND	The firmware folder does not exist.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ *	@retval		...					Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FirmwareCatalog_Build(
+	_In_z_	const wchar_t*	PwszFolder,
+	_Out_	unsigned int*	PpunImageCount,
+	_Out_	unsigned int*	PpunSkippedCount);
+
+/**
+ *	@brief		Check whether a TPM firmware version matches an allowed source version of a firmware image
+ *	@details	The TPM firmware version matches with and without subversion.minor like in FirmwareUpdate_IsFirmwareUpdatable,
+ *				e.g. "7.85.4555.0" matches the allowed source versions "7.85.4555.0" and "7.85.4555".
+ *
+ *	@param		PwszAllowedVersion	Allowed source version of the firmware image
+ *	@param		PwszVersion			TPM firmware version
+ *
+ *	@retval		TRUE				The version matches.
+ *	@retval		FALSE				Otherwise.
+ */
+BOOL
+FirmwareCatalog_MatchesSourceVersion(
+	_In_z_	const wchar_t*	PwszAllowedVersion,
+	_In_z_	const wchar_t*	PwszVersion);
+
+/**
+ *	@brief		Look up a firmware image in the catalog index of a firmware folder
+ *	@details	Searches the index for an image which can be installed on the given source family and version and updates
+ *				to the given target version. The source version matches with FirmwareCatalog_MatchesSourceVersion. An entry is only returned if the size and modification time of the image file
+ *				still match the index. A missing or corrupt index, a stale entry or no match results in FALSE and the
+ *				caller falls back to the file name convention.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PbSourceFamily		Source TPM family (DEVICE_TYPE_TPM_12 or DEVICE_TYPE_TPM_20)
+ *	@param		PwszSourceVersion	Current TPM firmware version (e.g. "7.85.4555.0")
+ *	@param		PwszTargetVersion	Target TPM firmware version
+ *	@param		PwszFileName		Receives the file name of the firmware image without the folder part
+ *	@param		PpunFileNameSize	In: capacity of PwszFileName in wide characters. Out: length of the file name.
+ *
+ *	@retval		TRUE				A current index entry was found.
+ *	@retval		FALSE				No current index entry was found.
+ */
+_Check_return_
+BOOL
+FirmwareCatalog_Lookup(
+	_In_z_						const wchar_t*	PwszFolder,
+	_In_						BYTE			PbSourceFamily,
+	_In_z_						const wchar_t*	PwszSourceVersion,
+	_In_z_						const wchar_t*	PwszTargetVersion,
+	_Out_z_cap_(*PpunFileNameSize)	wchar_t*		PwszFileName,
+	_Inout_						unsigned int*	PpunFileNameSize);
+
+/**
+ *	@brief		Get all firmware images from the catalog index of a firmware folder
+ *	@details	Returns the current entries of the index. Entries whose image file has been changed or removed since the
+ *				index was built are left out.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PprgsImages			Receives the image list allocated on the heap; must be freed with Platform_MemoryFree
+ *	@param		PpunImageCount		Receives the number of images in the list
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		RC_E_FILE_NOT_FOUND	The folder does not contain a valid index file.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FirmwareCatalog_GetImages(
+	_In_z_						const wchar_t*				PwszFolder,
+	_Outptr_result_maybenull_	IfxFirmwareCatalogImage**	PprgsImages,
+	_Out_						unsigned int*				PpunImageCount);
+
+#ifdef __cplusplus
+}
+#endif
@@ -75,6 +75,31 @@ FirmwareImage_Unmarshal(
 	_Out_	IfxFirmwareImage*	PpTarget,
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnBufferSize)
+{
+	return FirmwareImage_UnmarshalSignedData(PpTarget, NULL, PprgbBuffer, PpnBufferSize);
+}
+
+/**
+ *	@brief		Function to unmarshal a IfxFirmwareImage and its policy parameter block from a byte stream
+ *	@details	Same as FirmwareImage_Unmarshal but additionally returns the policy parameter block that is unmarshalled
+ *				anyway to get the allowed source versions, so callers do not need to unmarshal it a second time.
+ *
+ *	@param		PpTarget				Pointer to the target structure; must be allocated by the caller
+ *	@param		PpsSignedData			Receives the unmarshalled policy parameter block; may be NULL
+ *	@param		PprgbBuffer				Pointer to a byte stream containing the firmware image data; will be increased during execution by the amount of unmarshalled bytes
+ *	@param		PpnBufferSize			Size of elements readable from the byte stream; will be decreased during execution by the amount of unmarshalled bytes
+ *	@retval		RC_SUCCESS				In case the firmware is updatable with the given firmware
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function or an error occurred at unmarshal.
+ *	@retval		RC_E_BUFFER_TOO_SMALL	In case an output buffer is too small for an input byte array
+ *	@retval		RC_E_CORRUPT_FW_IMAGE	The policy parameter block cannot be unmarshalled.
+ */
+_Check_return_
+unsigned int
+FirmwareImage_UnmarshalSignedData(
+	_Out_		IfxFirmwareImage*	PpTarget,
+	_Out_opt_	sSignedData_d*		PpsSignedData,
+	_Inout_		BYTE**				PprgbBuffer,
+	_Inout_		INT32*				PpnBufferSize)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 
@@ -278,11 +303,12 @@ FirmwareImage_Unmarshal(
 		{
 			// Get allowed versions from parameter block and store them in rgunIntSourceVersions
 			// For >= VERSION_3 images the data will be overwritten with section retrieved from metadata.
-			sSignedData_d sSignedData = {0};
+			sSignedData_d sSignedDataLocal = {0};
+			sSignedData_d* pSignedData = NULL != PpsSignedData ? PpsSignedData : &sSignedDataLocal;
 			BYTE* rgbPolicyParameterBlock = PpTarget->rgbPolicyParameterBlock;
 			INT32 nPolicyParameterBlockSize = PpTarget->usPolicyParameterBlockSize;
 			// Unmarshal the block to sSignedData structure
-			unReturnValue = TSS_sSignedData_d_Unmarshal(&sSignedData, &rgbPolicyParameterBlock, &nPolicyParameterBlockSize);
+			unReturnValue = TSS_sSignedData_d_Unmarshal(pSignedData, &rgbPolicyParameterBlock, &nPolicyParameterBlockSize);
 			if (RC_SUCCESS != unReturnValue)
 			{
 				ERROR_STORE_FMT(RC_E_CORRUPT_FW_IMAGE, L"TSS_sSignedData_d_Unmarshal returned an unexpected value. (0x%.8x)", unReturnValue);
@@ -292,12 +318,12 @@ FirmwareImage_Unmarshal(
 			// Get allowed versions from parameter block
 			{
 				unsigned int unIndex = 0;
-				PpTarget->usIntSourceVersionCount = sSignedData.sSignerInfo.sSignedAttributes.sVersions.wEntries;
+				PpTarget->usIntSourceVersionCount = pSignedData->sSignerInfo.sSignedAttributes.sVersions.wEntries;
 				for (unIndex = 0; unIndex < MAX_SOURCE_VERSIONS_COUNT; unIndex++)
 				{
 					if (unIndex < PpTarget->usIntSourceVersionCount)
 					{
-						PpTarget->rgunIntSourceVersions[unIndex] = sSignedData.sSignerInfo.sSignedAttributes.sVersions.Version[unIndex];
+						PpTarget->rgunIntSourceVersions[unIndex] = pSignedData->sSignerInfo.sSignedAttributes.sVersions.Version[unIndex];
 					}
 					else
 					{
@@ -14,6 +14,7 @@
  */
 #pragma once
 #include <StdInclude.h>
+#include "TPM2_FieldUpgradeTypes.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,9 +28,6 @@ static const GUID EFI_IFXTPM_FIRMWARE_IMAGE_GUID =
 static const GUID EFI_IFXTPM_FIRMWARE_IMAGE_2_GUID =
 { 0x1a53667a, 0xfb12, 0x479e, { 0xac, 0x58, 0xec, 0x99, 0x58, 0x86, 0x10, 0x94 } };
 
-/// The ID of the signing key used to create the firmware image signature
-#define SIG_KEY_ID_1 0x0001
-
 /// Indicates TPM1.2 firmware update.
 #define DEVICE_TYPE_TPM_12 0x01
 
@@ -138,6 +136,28 @@ FirmwareImage_Unmarshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnBufferSize);
 
+/**
+ *	@brief		Function to unmarshal a IfxFirmwareImage and its policy parameter block from a byte stream
+ *	@details	Same as FirmwareImage_Unmarshal but additionally returns the policy parameter block that is unmarshalled
+ *				anyway to get the allowed source versions, so callers do not need to unmarshal it a second time.
+ *
+ *	@param		PpTarget				Pointer to the target structure; must be allocated by the caller
+ *	@param		PpsSignedData			Receives the unmarshalled policy parameter block; may be NULL
+ *	@param		PprgbBuffer				Pointer to a byte stream containing the firmware image data; will be increased during execution by the amount of unmarshalled bytes
+ *	@param		PpnBufferSize			Size of elements readable from the byte stream; will be decreased during execution by the amount of unmarshalled bytes
+ *	@retval		RC_SUCCESS				In case the firmware is updatable with the given firmware
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function or an error occurred at unmarshal.
+ *	@retval		RC_E_BUFFER_TOO_SMALL	In case an output buffer is too small for an input byte array
+ *	@retval		RC_E_CORRUPT_FW_IMAGE	The policy parameter block cannot be unmarshalled.
+ */
+_Check_return_
+unsigned int
+FirmwareImage_UnmarshalSignedData(
+	_Out_		IfxFirmwareImage*	PpTarget,
+	_Out_opt_	sSignedData_d*		PpsSignedData,
+	_Inout_		BYTE**				PprgbBuffer,
+	_Inout_		INT32*				PpnBufferSize);
+
 #ifdef __cplusplus
 }
 #endif
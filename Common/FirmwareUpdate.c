@@ -16,6 +16,7 @@
 #include "FirmwareUpdate.h"
 #include "FirmwareImage.h"
 #include "Crypt.h"
+#include "ImageCache.h"
 
 #include "TPM2_Marshal.h"
 #include "TPM2_FlushContext.h"
@@ -47,16 +48,116 @@
 #include "TPM_FieldUpgradeUpdate.h"
 #include "TPM_FieldUpgradeComplete.h"
 
-/// Maximum amount of times to check if TPM switched to boot loader mode after TPM_FieldUpgrade_Start command.
-#define TPM_FU_START_MAX_RETRIES 16U
-/// Default wait time in milliseconds in between two of the above checks.
-#define TPM_FU_START_RETRY_WAIT_TIME 1000
-/// Default wait time in milliseconds after sending TPM_FieldUpgrade_Complete before continuing to give TPM time to finish.
-#define TPM_FU_COMPLETE_WAIT_TIME 2000
+#include "Polling.h"
+#include "Timing.h"
+
+/// Maximum time in milliseconds to wait for the TPM to switch to boot loader mode after TPM_FieldUpgrade_Start command.
+#define TPM_FU_START_TIMEOUT 16000
+/// Time in milliseconds to let the TPM settle after sending TPM_FieldUpgrade_Complete before it is probed.
+#define TPM_FU_COMPLETE_SETTLE_TIME 20
+/// Maximum time in milliseconds to probe the TPM for readiness after TPM_FU_COMPLETE_SETTLE_TIME has elapsed.
+#define TPM_FU_COMPLETE_TIMEOUT (4000 - TPM_FU_COMPLETE_SETTLE_TIME)
+
+/**
+ *	@brief		Snapshot of the TPM state read during the current session
+ *	@details	Holds the results of the read-only TPM queries so that FirmwareUpdate_GetImageInfo, FirmwareUpdate_CheckImage and
+ *				FirmwareUpdate_UpdateImage do not send them again. Every command that changes the TPM state must call
+ *				FirmwareUpdate_InvalidateTpmStateCache afterwards.
+ */
+typedef struct tdIfxTpmStateCache
+{
+	/// TRUE if sTpmState holds the result of FirmwareUpdate_CalculateState
+	BOOL fTpmStateValid;
+	/// TPM state
+	TPM_STATE sTpmState;
+	/// TRUE if the firmware version strings are valid for bfVersionAttributes
+	BOOL fVersionValid;
+	/// TPM state attributes the firmware version strings have been read with
+	BITFIELD_TPM_ATTRIBUTES bfVersionAttributes;
+	/// Firmware version
+	wchar_t wszFirmwareVersion[MAX_NAME];
+	/// Firmware version without subversion.minor
+	wchar_t wszFirmwareVersionShort[MAX_NAME];
+	/// TRUE if sSecurityModuleLogicInfo2 is valid (TPM2.0)
+	BOOL fSecurityModuleLogicInfo2Valid;
+	/// Security Module Logic Info read from TPM2.0
+	sSecurityModuleLogicInfo2_d sSecurityModuleLogicInfo2;
+	/// TRUE if sSecurityModuleLogicInfo is valid (TPM1.2)
+	BOOL fSecurityModuleLogicInfoValid;
+	/// Security Module Logic Info read from TPM1.2
+	sSecurityModuleLogicInfo_d sSecurityModuleLogicInfo;
+} IfxTpmStateCache;
+
+/// TPM state cache of the current session
+static IfxTpmStateCache s_sTpmStateCache;
+
+/**
+ *	@brief		Invalidates the TPM state cache
+ *	@details	Must be called after every command that changes the TPM state (e.g. FieldUpgradeStart, TakeOwnership, OwnerClear,
+ *				HierarchyChangeAuth or physical presence changes). The next query reads the state from the TPM again.
+ */
+void
+FirmwareUpdate_InvalidateTpmStateCache()
+{
+	IGNORE_RETURN_VALUE(Platform_MemorySet(&s_sTpmStateCache, 0, sizeof(s_sTpmStateCache)));
+}
+
+/**
+ *	@brief		Function to read Security Module Logic Info from TPM1.2.
+ *	@details	This function obtains the Security Module Logic Info from TPM1.2 or the boot loader with TPM_FieldUpgradeInfoRequest2.
+ *				The command is retried once on TPM_RESOURCES. A successful result is kept in the TPM state cache.
+ *
+ *	@param		PpSecurityModuleLogicInfo	Pointer to the Security Module Logic Info
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER			An invalid parameter was passed to the function. The parameter is NULL
+ *	@retval		...							Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FirmwareUpdate_Tpm12_GetSecurityModuleLogicInfo(
+	_Out_ sSecurityModuleLogicInfo_d* PpSecurityModuleLogicInfo)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		// Check parameter
+		if (NULL == PpSecurityModuleLogicInfo)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpSecurityModuleLogicInfo is NULL)");
+			break;
+		}
+
+		if (s_sTpmStateCache.fSecurityModuleLogicInfoValid)
+		{
+			unReturnValue = Platform_MemoryCopy(PpSecurityModuleLogicInfo, sizeof(*PpSecurityModuleLogicInfo), &s_sTpmStateCache.sSecurityModuleLogicInfo, sizeof(s_sTpmStateCache.sSecurityModuleLogicInfo));
+			break;
+		}
+
+		unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(PpSecurityModuleLogicInfo);
+		if (TPM_RESOURCES == (unReturnValue ^ RC_TPM_MASK))
+		{
+			// Retry once on TPM_RESOURCES
+			unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(PpSecurityModuleLogicInfo);
+		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = Platform_MemoryCopy(&s_sTpmStateCache.sSecurityModuleLogicInfo, sizeof(s_sTpmStateCache.sSecurityModuleLogicInfo), PpSecurityModuleLogicInfo, sizeof(*PpSecurityModuleLogicInfo));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		s_sTpmStateCache.fSecurityModuleLogicInfoValid = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
 
 /**
  *	@brief		Function to read Security Module Logic Info from TPM2.0.
- *	@details	This function obtains the Security Module Logic Info from TPM2.0.
+ *	@details	This function obtains the Security Module Logic Info from TPM2.0. A successful result is kept in the TPM state cache.
  *
  *	@param		PpSecurityModuleLogicInfo2	Pointer to the Security Module Logic Info
  *
@@ -82,6 +183,12 @@ FirmwareUpdate_Tpm20_GetSecurityModuleLogicInfo2(
 			break;
 		}
 
+		if (s_sTpmStateCache.fSecurityModuleLogicInfo2Valid)
+		{
+			unReturnValue = Platform_MemoryCopy(PpSecurityModuleLogicInfo2, sizeof(*PpSecurityModuleLogicInfo2), &s_sTpmStateCache.sSecurityModuleLogicInfo2, sizeof(s_sTpmStateCache.sSecurityModuleLogicInfo2));
+			break;
+		}
+
 		{
 			// Read out the vendor specific TPM_PT_VENDOR_FIX_SMLI2 property from the TPM.
 			TPMS_VENDOR_CAPABILITY_DATA vendorCapabilityData = {0};
@@ -114,6 +221,11 @@ FirmwareUpdate_Tpm20_GetSecurityModuleLogicInfo2(
 				break;
 			}
 		}
+
+		unReturnValue = Platform_MemoryCopy(&s_sTpmStateCache.sSecurityModuleLogicInfo2, sizeof(s_sTpmStateCache.sSecurityModuleLogicInfo2), PpSecurityModuleLogicInfo2, sizeof(*PpSecurityModuleLogicInfo2));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		s_sTpmStateCache.fSecurityModuleLogicInfo2Valid = TRUE;
 	}
 	WHILE_FALSE_END;
 
@@ -175,12 +287,7 @@ FirmwareUpdate_GetTpmFieldUpgradeCounter(
 		{
 			// TPM1.2
 			sSecurityModuleLogicInfo_d securityModuleLogicInfo = {0};
-			unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
-			if (TPM_RESOURCES == (unReturnValue ^ RC_TPM_MASK))
-			{
-				// Retry once on TPM_RESOURCES
-				unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
-			}
+			unReturnValue = FirmwareUpdate_Tpm12_GetSecurityModuleLogicInfo(&securityModuleLogicInfo);
 			if (RC_SUCCESS != unReturnValue)
 			{
 				if (TPM_BAD_PARAM_SIZE == (unReturnValue ^ RC_TPM_MASK) ||
@@ -208,7 +315,7 @@ FirmwareUpdate_GetTpmFieldUpgradeCounter(
 
 /**
  *	@brief		Function to read the firmware version string from the TPM
- *	@details	This function obtains the firmware version string from the TPM.
+ *	@details	This function obtains the firmware version string from the TPM. The strings are kept in the TPM state cache.
  *
  *	@param		PbfTpmAttributes				TPM state attributes
  *	@param		PwszFirmwareVersion				Wide character string output buffer for the firmware version (must be allocated by the caller)
@@ -248,6 +355,22 @@ FirmwareUpdate_GetTpmFirmwareVersionString(
 			break;
 		}
 
+		// Use the version strings read before in this session with the same TPM state attributes
+		if (s_sTpmStateCache.fVersionValid &&
+				0 == Platform_MemoryCompare(&s_sTpmStateCache.bfVersionAttributes, &PbfTpmAttributes, sizeof(PbfTpmAttributes)))
+		{
+			unReturnValue = Platform_StringCopy(PwszFirmwareVersionShort, PpunFirmwareVersionShortSize, s_sTpmStateCache.wszFirmwareVersionShort);
+			if (RC_SUCCESS != unReturnValue)
+			{
+				ERROR_STORE(unReturnValue, L"Platform_StringCopy returned an unexpected value.");
+				break;
+			}
+			unReturnValue = Platform_StringCopy(PwszFirmwareVersion, PpunFirmwareVersionSize, s_sTpmStateCache.wszFirmwareVersion);
+			if (RC_SUCCESS != unReturnValue)
+				ERROR_STORE(unReturnValue, L"Platform_StringCopy returned an unexpected value.");
+			break;
+		}
+
 		if (PbfTpmAttributes.tpm20)
 		{
 			// Read version from TPM2.0
@@ -348,6 +471,19 @@ FirmwareUpdate_GetTpmFirmwareVersionString(
 			ERROR_STORE_FMT(unReturnValue, L"Unknown TPM state attributes detected. 0x%.8x", PbfTpmAttributes);
 			break;
 		}
+
+		// Remember the version strings for this session
+		{
+			unsigned int unVersionSize = RG_LEN(s_sTpmStateCache.wszFirmwareVersion);
+			unsigned int unVersionShortSize = RG_LEN(s_sTpmStateCache.wszFirmwareVersionShort);
+			s_sTpmStateCache.fVersionValid = FALSE;
+			if (RC_SUCCESS == Platform_StringCopy(s_sTpmStateCache.wszFirmwareVersion, &unVersionSize, PwszFirmwareVersion) &&
+					RC_SUCCESS == Platform_StringCopy(s_sTpmStateCache.wszFirmwareVersionShort, &unVersionShortSize, PwszFirmwareVersionShort))
+			{
+				s_sTpmStateCache.bfVersionAttributes = PbfTpmAttributes;
+				s_sTpmStateCache.fVersionValid = TRUE;
+			}
+		}
 		unReturnValue = RC_SUCCESS;
 	}
 	WHILE_FALSE_END;
@@ -356,160 +492,239 @@ FirmwareUpdate_GetTpmFirmwareVersionString(
 }
 
 /**
- *	@brief		Function to check if the TPM is updatable with the given firmware image
- *	@details	Some parameters like GUID, file content signature, TPM firmware major minor version or file content CRC
- *				are checked to get a decision if the firmware is updatable with the current image.
+ *	@brief		Parses a firmware image
+ *	@details	Unmarshals the header and the policy parameter block of the firmware image. A firmware image that cannot be parsed
+ *				is not an error of the function: fParsed is FALSE in this case and the image is reported as corrupt by the checks.
  *
- *	@param		PbfTpmAttributes			TPM state attributes
- *	@param		PrgbFirmwareImage			Pointer to the firmware image byte stream
- *	@param		PnFirmwareImageSize			Size of the firmware image byte stream
- *	@param		PpsFirmwareImage			Pointer to the unmarshalled firmware image structure (Unmarshalled PrgbFirmwareImage)
- *	@param		PpfValid					TRUE in case the image is valid, FALSE otherwise.
- *	@param		PpbfNewTpmFirmwareInfo		Pointer to a bit field to return info data for the new firmware image.
- *	@param		PpunErrorDetails			Pointer to an unsigned int to return error details. Possible values are:\n
- *												RC_E_FW_UPDATE_BLOCKED in case the field upgrade counter value has been exceeded.\n
- *												RC_E_WRONG_FW_IMAGE in case the TPM is not updatable with the given image.\n
- *												RC_E_CORRUPT_FW_IMAGE in case the firmware image is corrupt.\n
- *												RC_E_NEWER_TOOL_REQUIRED in case a newer version of the tool is required to parse the firmware image.\n
- *												RC_E_WRONG_DECRYPT_KEYS in case the TPM2.0 does not have decrypt keys matching to the firmware image.
+ *	@param		PrgbImage					Firmware image byte stream; must stay valid as long as the parsed image is used
+ *	@param		PunImageSize				Size of firmware image byte stream
+ *	@param		PpsParsedImage				Receives the parsed firmware image
  *
- *	@retval		RC_SUCCESS					The operation completed successfully.
- *	@retval		RC_E_FAIL					An unexpected error occurred.
- *	@retval		RC_E_BAD_PARAMETER			In case of a NULL input parameter
+ *	@retval		RC_SUCCESS					The operation completed successfully. Check fParsed for the result.
+ *	@retval		RC_E_BAD_PARAMETER			An invalid parameter was passed to the function.
  *	@retval		...							Error codes from called functions.
  */
 _Check_return_
 unsigned int
-FirmwareUpdate_IsFirmwareUpdatable(
-	_In_								BITFIELD_TPM_ATTRIBUTES			PbfTpmAttributes,
-	_In_bytecount_(PnFirmwareImageSize)	BYTE*							PrgbFirmwareImage,
-	_In_								int								PnFirmwareImageSize,
-	_In_								IfxFirmwareImage*				PpsFirmwareImage,
-	_Out_								BOOL*							PpfValid,
-	_Out_								BITFIELD_NEW_TPM_FIRMWARE_INFO*	PpbfNewTpmFirmwareInfo,
-	_Out_								UINT32*							PpunErrorDetails)
+FirmwareUpdate_ParseImage(
+	_In_bytecount_(PunImageSize)	BYTE*					PrgbImage,
+	_In_							UINT32					PunImageSize,
+	_Out_							IfxParsedFirmwareImage*	PpsParsedImage)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 
 	do
 	{
-		// Check _Out_ parameters.
-		if (NULL == PpfValid || NULL == PpbfNewTpmFirmwareInfo || NULL == PpunErrorDetails)
+		BYTE* pbBuffer = PrgbImage;
+		INT32 nBufferSize = (INT32)PunImageSize;
+
+		// Check parameters
+		if (NULL == PpsParsedImage)
 		{
 			unReturnValue = RC_E_BAD_PARAMETER;
-			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpfValid or PpbfNewTpmFirmwareInfo or PpunErrorDetails is NULL)");
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpsParsedImage is NULL)");
 			break;
 		}
 
-		// Set default value for _Out_ parameters.
-		*PpfValid = FALSE;
-		*PpunErrorDetails = RC_E_WRONG_FW_IMAGE;
-		unReturnValue = Platform_MemorySet(PpbfNewTpmFirmwareInfo, 0, sizeof(BITFIELD_NEW_TPM_FIRMWARE_INFO));
+		unReturnValue = Platform_MemorySet(PpsParsedImage, 0, sizeof(IfxParsedFirmwareImage));
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
-		// Check _In_ parameters.
-		if (NULL == PrgbFirmwareImage ||
-				0 >= PnFirmwareImageSize ||
-				NULL == PpsFirmwareImage)
+		if (NULL == PrgbImage || 0 == PunImageSize || INT32_MAX < PunImageSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PrgbImage is NULL or PunImageSize is zero or too large)");
+			break;
+		}
+		PpsParsedImage->rgbImage = PrgbImage;
+		PpsParsedImage->unImageSize = PunImageSize;
+
+		// Unmarshal the firmware image structure and the policy parameter block
+		unReturnValue = FirmwareImage_UnmarshalSignedData(&PpsParsedImage->sHeader, &PpsParsedImage->sSignedData, &pbBuffer, &nBufferSize);
+		PpsParsedImage->fParsed = (RC_SUCCESS == unReturnValue);
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Checks the integrity of a firmware image, optionally stopping before the signature verification
+ *	@details	Implements FirmwareUpdate_VerifyImage. If PfDeferSignature is TRUE and the signature of the image has not been
+ *				verified yet, the checks stop right before the signature verification and PpfSignaturePending is set. The caller
+ *				verifies the signature over sVerification.sDigests, stores the verdict in sVerification and calls the function again.
+ *
+ *	@param		PpsParsedImage				Pointer to the parsed firmware image
+ *	@param		PfDeferSignature			TRUE to stop before the signature verification, FALSE to run all checks
+ *	@param		PpunErrorDetails			Pointer to an unsigned int to return the result, see FirmwareUpdate_VerifyImage
+ *	@param		PppwszErrorMessage			Receives a static description of the failed check or the unexpected error, NULL otherwise.
+ *	@param		PpfSignaturePending			Receives TRUE if the checks stopped before the signature verification, FALSE otherwise.
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully. PpunErrorDetails contains the result.
+ *	@retval		RC_E_BAD_PARAMETER			In case of a NULL input parameter
+ *	@retval		...							Error codes from called functions.
+ */
+_Check_return_
+static
+unsigned int
+FirmwareUpdate_CheckImageIntegrity(
+	_Inout_	IfxParsedFirmwareImage*	PpsParsedImage,
+	_In_	BOOL					PfDeferSignature,
+	_Out_	UINT32*					PpunErrorDetails,
+	_Out_	const wchar_t**			PppwszErrorMessage,
+	_Out_	BOOL*					PpfSignaturePending)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		// The signature is 256 bytes long and is located before the CRC
+		int nSizeOfDataForHash = 0;
+		const BYTE* rgbImage = NULL;
+		int nImageSize = 0;
+		const IfxFirmwareImage* pHeader = NULL;
+		IfxFirmwareImageVerification* pVerification = NULL;
+
+		// Check parameters
+		if (NULL == PpunErrorDetails || NULL == PppwszErrorMessage || NULL == PpfSignaturePending)
 		{
 			unReturnValue = RC_E_BAD_PARAMETER;
-			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PrgbFirmwareImage or PpsFirmwareImage is NULL or PnFirmwareImageSize <= 0)");
+			break;
+		}
+		*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
+		*PppwszErrorMessage = NULL;
+		*PpfSignaturePending = FALSE;
+		if (NULL == PpsParsedImage ||
+				NULL == PpsParsedImage->rgbImage ||
+				0 == PpsParsedImage->unImageSize ||
+				INT32_MAX < PpsParsedImage->unImageSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			*PppwszErrorMessage = L"Parameter not initialized correctly (PpsParsedImage or its image byte stream is NULL or empty)";
+			break;
+		}
+		rgbImage = PpsParsedImage->rgbImage;
+		nImageSize = (int)PpsParsedImage->unImageSize;
+		pHeader = &PpsParsedImage->sHeader;
+		pVerification = &PpsParsedImage->sVerification;
+
+		// A firmware image that cannot be parsed is corrupt
+		if (!PpsParsedImage->fParsed)
+		{
+			*PppwszErrorMessage = L"The firmware image file is corrupt or not a firmware image file at all";
+			unReturnValue = RC_SUCCESS;
 			break;
 		}
 
 		// Compare GUID to the expected one.
-		if (0 != Platform_MemoryCompare(&PpsFirmwareImage->unique, &EFI_IFXTPM_FIRMWARE_IMAGE_GUID, sizeof(EFI_IFXTPM_FIRMWARE_IMAGE_GUID)))
+		if (0 != Platform_MemoryCompare(&pHeader->unique, &EFI_IFXTPM_FIRMWARE_IMAGE_GUID, sizeof(EFI_IFXTPM_FIRMWARE_IMAGE_GUID)))
 		{
 			// The tool cannot process the image. Detect whether a newer version of the tool could parse the image.
 			// IMPORTANT: As soon as EFI_IFXTPM_FIRMWARE_IMAGE_2_GUID is supported, update firmware image file format by introducing
 			// a schema version for all future breaking changes. Furthermore, leave GUID the same as long as possible! This enables
 			// all (i.e. older) application versions to return the correct return code RC_E_NEWER_TOOL_REQUIRED in case of an
 			// unsupported firmware image file format even for schema versions introduced after EFI_IFXTPM_FIRMWARE_IMAGE_2_GUID.
-			if (0 == Platform_MemoryCompare(&PpsFirmwareImage->unique, &EFI_IFXTPM_FIRMWARE_IMAGE_2_GUID, sizeof(EFI_IFXTPM_FIRMWARE_IMAGE_2_GUID)))
+			if (0 == Platform_MemoryCompare(&pHeader->unique, &EFI_IFXTPM_FIRMWARE_IMAGE_2_GUID, sizeof(EFI_IFXTPM_FIRMWARE_IMAGE_2_GUID)))
 				// A newer version of the driver is required to process the firmware image
 				*PpunErrorDetails = RC_E_NEWER_TOOL_REQUIRED;
 			else
-			{
-				ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The firmware image file is corrupt or not a firmware image file at all");
-				*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
-			}
+				*PppwszErrorMessage = L"The firmware image file is corrupt or not a firmware image file at all";
 
 			unReturnValue = RC_SUCCESS;
 			break;
 		}
 
-		// Check the CRC at the end of the firmware image
+		// The firmware block must be located within the firmware image
+		if (pHeader->rgbFirmware < rgbImage ||
+				pHeader->rgbFirmware > rgbImage + nImageSize ||
+				pHeader->unFirmwareSize > (UINT32)(rgbImage + nImageSize - pHeader->rgbFirmware) ||
+				nImageSize < (int)sizeof(pHeader->unChecksum))
+		{
+			*PppwszErrorMessage = L"The content of the firmware image file is inconsistent";
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+
+		// Calculate the CRC, the SHA-256 digest of the signed data and the SHA-256 digest of the firmware block in a single pass
+		// unless the caller already knows them for this image
+		nSizeOfDataForHash = nImageSize - sizeof(pHeader->unChecksum) - sizeof(RSA_PUB_MODULUS_KEY_ID_0);
+		if (!pVerification->fDigestsKnown)
 		{
-			unsigned int unCRC = 0;
-			unReturnValue = Crypt_CRC((void*)PrgbFirmwareImage, PnFirmwareImageSize - sizeof(unCRC), &unCRC);
+			unReturnValue = Crypt_ImageDigests(
+								rgbImage,
+								(UINT32)nImageSize,
+								(UINT32)(nImageSize - sizeof(pHeader->unChecksum)),
+								nSizeOfDataForHash > 0 ? (UINT32)nSizeOfDataForHash : 0,
+								(UINT32)(pHeader->rgbFirmware - rgbImage),
+								pHeader->unFirmwareSize,
+								&pVerification->sDigests);
 			if (RC_SUCCESS != unReturnValue)
 			{
-				ERROR_STORE(unReturnValue, L"Crypt_CRC returned an unexpected value");
-				break;
-			}
-			if (PpsFirmwareImage->unChecksum != unCRC)
-			{
-				ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The CRC value in the firmware image file is incorrect");
-				unReturnValue = RC_SUCCESS;
-				*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
+				*PppwszErrorMessage = L"Crypt_ImageDigests returned an unexpected value";
 				break;
 			}
+			pVerification->fDigestsKnown = TRUE;
 		}
 
-		// Check signature on the firmware image file with Infineon code signing public key
+		// Check the CRC at the end of the firmware image
+		if (pHeader->unChecksum != pVerification->sDigests.unCRC)
 		{
-			BYTE rgbHash[SHA256_DIGEST_SIZE] = {0};
-			// The signature is 256 bytes long and is located before the CRC
-			int nSizeOfDataForHash = PnFirmwareImageSize - sizeof(PpsFirmwareImage->unChecksum) - sizeof(RSA_PUB_MODULUS_KEY_ID_0);
+			*PppwszErrorMessage = L"The CRC value in the firmware image file is incorrect";
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
 
+		// Check signature on the firmware image file with Infineon code signing public key
+		{
 			// Check structure version of the firmware image file
-			if (PpsFirmwareImage->usImageStructureVersion < 2)
+			if (pHeader->usImageStructureVersion < 2)
 			{
-				ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The structure of the firmware image file is too old and therefore does not meet the minimum requirements");
+				*PppwszErrorMessage = L"The structure of the firmware image file is too old and therefore does not meet the minimum requirements";
 				unReturnValue = RC_SUCCESS;
-				*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
 				break;
 			}
 
 			// Check if signature key ID is known
-			if (SIG_KEY_ID_1 != PpsFirmwareImage->usSignatureKeyId)
+			if (SIG_KEY_ID_1 != pHeader->usSignatureKeyId)
 			{
-				ERROR_STORE(RC_E_NEWER_TOOL_REQUIRED, L"The signature key ID of the firmware image file is not supported");
-				unReturnValue = RC_SUCCESS;
+				*PppwszErrorMessage = L"The signature key ID of the firmware image file is not supported";
 				*PpunErrorDetails = RC_E_NEWER_TOOL_REQUIRED;
+				unReturnValue = RC_SUCCESS;
 				break;
 			}
 
 			// Check that the firmware image file is large enough to contain a signature
 			if (nSizeOfDataForHash <= 0)
 			{
-				ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The size of the firmware image file signature is too small");
+				*PppwszErrorMessage = L"The size of the firmware image file signature is too small";
 				unReturnValue = RC_SUCCESS;
-				*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
 				break;
 			}
 
-			// Recalculate the SHA-256 digest on which the signature is based
-			unReturnValue = Crypt_SHA256(PrgbFirmwareImage, nSizeOfDataForHash, rgbHash);
-			if (RC_SUCCESS != unReturnValue)
+			// Verify the signature of the firmware image file, also over digests taken from the verified-image cache
+			if (!pVerification->fVerified && PfDeferSignature)
 			{
-				ERROR_STORE(unReturnValue, L"Crypt_SHA256 returned an unexpected value");
+				*PpfSignaturePending = TRUE;
+				unReturnValue = RC_SUCCESS;
 				break;
 			}
-
-			// Verify the signature of the firmware image file
-			unReturnValue = Crypt_VerifySignature(rgbHash, sizeof(rgbHash), PpsFirmwareImage->rgbSignature, sizeof(PpsFirmwareImage->rgbSignature), RSA_PUB_MODULUS_KEY_ID_0, sizeof(RSA_PUB_MODULUS_KEY_ID_0));
-			if (RC_SUCCESS != unReturnValue && RC_E_VERIFY_SIGNATURE != unReturnValue)
+			if (!pVerification->fVerified)
 			{
-				ERROR_STORE(unReturnValue, L"Crypt_VerifySignature returned an unexpected value");
-				break;
+				unReturnValue = Crypt_VerifySignatureByKeyId(pHeader->usSignatureKeyId, pVerification->sDigests.rgbSignedHash, sizeof(pVerification->sDigests.rgbSignedHash), pHeader->rgbSignature, sizeof(pHeader->rgbSignature));
+				if (RC_SUCCESS != unReturnValue && RC_E_VERIFY_SIGNATURE != unReturnValue)
+				{
+					*PppwszErrorMessage = L"Crypt_VerifySignatureByKeyId returned an unexpected value";
+					break;
+				}
+				pVerification->fSignatureValid = (RC_SUCCESS == unReturnValue);
+				pVerification->fVerified = TRUE;
 			}
-			else if (RC_E_VERIFY_SIGNATURE == unReturnValue)
+			if (!pVerification->fSignatureValid)
 			{
-				ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The signature in the firmware image file is invalid");
+				*PppwszErrorMessage = L"The signature in the firmware image file is invalid";
 				unReturnValue = RC_SUCCESS;
-				*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
 				break;
 			}
 		}
@@ -517,61 +732,245 @@ FirmwareUpdate_IsFirmwareUpdatable(
 		// Check consistency of firmware
 		{
 			// Source and target TPM family flags in the firmware image must indicate either TPM1.2 or TPM2.0
-			if (PpsFirmwareImage->bSourceTpmFamily != DEVICE_TYPE_TPM_12 && PpsFirmwareImage->bSourceTpmFamily != DEVICE_TYPE_TPM_20)
+			if ((pHeader->bSourceTpmFamily != DEVICE_TYPE_TPM_12 && pHeader->bSourceTpmFamily != DEVICE_TYPE_TPM_20) ||
+				(pHeader->bTargetTpmFamily != DEVICE_TYPE_TPM_12 && pHeader->bTargetTpmFamily != DEVICE_TYPE_TPM_20))
 			{
-				ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The content of the firmware image file is inconsistent");
+				*PppwszErrorMessage = L"The content of the firmware image file is inconsistent";
 				unReturnValue = RC_SUCCESS;
-				*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
 				break;
 			}
-			if (PpsFirmwareImage->bTargetTpmFamily != DEVICE_TYPE_TPM_12 && PpsFirmwareImage->bTargetTpmFamily != DEVICE_TYPE_TPM_20)
+		}
+
+		// Run checks on policy parameter block
+		{
+			// Verify if the SHA256 digest of the firmware block matches the digest given in the policy parameter block
+			if (0 != Platform_MemoryCompare(PpsParsedImage->sSignedData.sSignerInfo.sSignedAttributes.sMessageDigest.rgbMessageDigest, pVerification->sDigests.rgbFirmwareHash, SHA256_DIGEST_SIZE))
 			{
-				ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The content of the firmware image file is inconsistent");
+				*PppwszErrorMessage = L"The firmware digest in the firmware image file is incorrect";
 				unReturnValue = RC_SUCCESS;
-				*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
 				break;
 			}
 		}
 
-		// Run checks on policy parameter block
+		*PpunErrorDetails = RC_SUCCESS;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Function to check the integrity of a firmware image without accessing the TPM
+ *	@details	Checks GUID, location of the firmware block, CRC, structure version, signature key ID, signature, TPM families
+ *				and the firmware digest in the policy parameter block. The function neither accesses the TPM nor the error stack,
+ *				the log or the verified-image cache, so it can be called for several images in parallel.
+ *
+ *	@param		PpsParsedImage				Pointer to the parsed firmware image. The digests in sVerification are calculated only if
+ *											fDigestsKnown is FALSE (e.g. no earlier call and no verified-image cache hit), the signature
+ *											is verified only if fVerified is FALSE (i.e. no earlier call for this parsed image).
+ *	@param		PpunErrorDetails			Pointer to an unsigned int to return the result. Possible values are:\n
+ *												RC_SUCCESS in case the firmware image is intact.\n
+ *												RC_E_CORRUPT_FW_IMAGE in case the firmware image is corrupt.\n
+ *												RC_E_NEWER_TOOL_REQUIRED in case a newer version of the tool is required to parse the firmware image.
+ *	@param		PppwszErrorMessage			Receives a static description of the failed check or the unexpected error, NULL otherwise.
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully. PpunErrorDetails contains the result.
+ *	@retval		RC_E_BAD_PARAMETER			In case of a NULL input parameter
+ *	@retval		...							Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FirmwareUpdate_VerifyImage(
+	_Inout_	IfxParsedFirmwareImage*	PpsParsedImage,
+	_Out_	UINT32*					PpunErrorDetails,
+	_Out_	const wchar_t**			PppwszErrorMessage)
+{
+	BOOL fSignaturePending = FALSE;
+
+	return FirmwareUpdate_CheckImageIntegrity(PpsParsedImage, FALSE, PpunErrorDetails, PppwszErrorMessage, &fSignaturePending);
+}
+
+/**
+ *	@brief		Function to check the integrity of several firmware images without accessing the TPM
+ *	@details	Runs the checks of FirmwareUpdate_VerifyImage for each image. The signatures of all images which reach the
+ *				signature verification are verified together with Crypt_VerifySignatureBatch, so the public key is looked up
+ *				and the verification context is set up only once for the batch. Like FirmwareUpdate_VerifyImage, the function
+ *				neither accesses the TPM nor the error stack, the log or the verified-image cache.
+ *
+ *	@param		PrgsImageChecks				Images to check. Receive the return value, the result and the error message of
+ *											FirmwareUpdate_VerifyImage for the respective image.
+ *	@param		PunCount					Number of entries in PrgsImageChecks, at most FIRMWARE_UPDATE_VERIFY_BATCH_SIZE
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully. Check the results of the individual images.
+ *	@retval		RC_E_BAD_PARAMETER			In case of a NULL input parameter or an invalid number of images
+ */
+_Check_return_
+unsigned int
+FirmwareUpdate_VerifyImageBatch(
+	_Inout_	IfxFirmwareImageCheck*	PrgsImageChecks,
+	_In_	UINT32					PunCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		IfxCryptSignatureCheck rgsSignatureChecks[FIRMWARE_UPDATE_VERIFY_BATCH_SIZE];
+		unsigned int rgunSignatureResults[FIRMWARE_UPDATE_VERIFY_BATCH_SIZE];
+		UINT32 rgunPending[FIRMWARE_UPDATE_VERIFY_BATCH_SIZE];
+		UINT32 unPendingCount = 0;
+		UINT32 unIndex = 0;
+
+		// Check parameters
+		if (NULL == PrgsImageChecks || 0 == PunCount || FIRMWARE_UPDATE_VERIFY_BATCH_SIZE < PunCount)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		// Run all checks before the signature verification and collect the signatures to verify
+		for (unIndex = 0; unIndex < PunCount; unIndex++)
 		{
-			BYTE* rgbPolicyParameterBlock = NULL;
-			INT32 nPolicyParameterBlockSize = 0;
-			sSignedData_d sSignedData = {0};
+			IfxFirmwareImageCheck* pCheck = &PrgsImageChecks[unIndex];
+			BOOL fSignaturePending = FALSE;
 
-			// Unmarshal the policy parameter block
-			rgbPolicyParameterBlock = PpsFirmwareImage->rgbPolicyParameterBlock;
-			nPolicyParameterBlockSize = PpsFirmwareImage->usPolicyParameterBlockSize;
-			unReturnValue = TSS_sSignedData_d_Unmarshal(&sSignedData, &rgbPolicyParameterBlock, &nPolicyParameterBlockSize);
-			if (RC_SUCCESS != unReturnValue)
+			pCheck->unReturnValue = FirmwareUpdate_CheckImageIntegrity(pCheck->pParsedImage, TRUE, &pCheck->unErrorDetails, &pCheck->pwszErrorMessage, &fSignaturePending);
+			if (RC_SUCCESS == pCheck->unReturnValue && fSignaturePending)
 			{
-				ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The content of the firmware image file is not parsable");
-				unReturnValue = RC_SUCCESS;
-				*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
-				break;
+				rgsSignatureChecks[unPendingCount].rgbMessageHash = pCheck->pParsedImage->sVerification.sDigests.rgbSignedHash;
+				rgsSignatureChecks[unPendingCount].unMessageHashSize = sizeof(pCheck->pParsedImage->sVerification.sDigests.rgbSignedHash);
+				rgsSignatureChecks[unPendingCount].rgbSignature = pCheck->pParsedImage->sHeader.rgbSignature;
+				rgsSignatureChecks[unPendingCount].unSignatureSize = sizeof(pCheck->pParsedImage->sHeader.rgbSignature);
+				rgunPending[unPendingCount] = unIndex;
+				unPendingCount++;
 			}
+		}
 
-			// Calculate the SHA256 digest of the firmware image and verify if it matches the digest given in the policy parameter block
+		if (0 != unPendingCount)
+		{
+			// Verify the collected signatures with the key checked by FirmwareUpdate_CheckImageIntegrity. An entry which failed
+			// unexpectedly stays unverified and is verified again on its own by the remaining checks, which report the error.
+			unsigned int unBatchResult = Crypt_VerifySignatureBatch(SIG_KEY_ID_1, unPendingCount, rgsSignatureChecks, rgunSignatureResults);
+			for (unIndex = 0; unIndex < unPendingCount; unIndex++)
 			{
-				// Recalculate the messageDigest of the firmware block
-				BYTE rgbMessageDigest[SHA256_DIGEST_SIZE] = {0};
-				unReturnValue = Crypt_SHA256(PpsFirmwareImage->rgbFirmware, PpsFirmwareImage->unFirmwareSize, rgbMessageDigest);
-				if (RC_SUCCESS != unReturnValue)
-				{
-					ERROR_STORE(unReturnValue, L"Crypt_SHA256 returned an unexpected value");
-					break;
-				}
+				IfxFirmwareImageCheck* pCheck = &PrgsImageChecks[rgunPending[unIndex]];
+				IfxFirmwareImageVerification* pVerification = &pCheck->pParsedImage->sVerification;
+				BOOL fSignaturePending = FALSE;
 
-				// Compare the messageDigest to the value stored in the policy parameter block
-				if (0 != Platform_MemoryCompare(sSignedData.sSignerInfo.sSignedAttributes.sMessageDigest.rgbMessageDigest, rgbMessageDigest, SHA256_DIGEST_SIZE))
+				if (RC_SUCCESS == unBatchResult &&
+						(RC_SUCCESS == rgunSignatureResults[unIndex] || RC_E_VERIFY_SIGNATURE == rgunSignatureResults[unIndex]))
 				{
-					ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"The firmware digest in the firmware image file is incorrect");
-					unReturnValue = RC_SUCCESS;
-					*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
-					break;
+					pVerification->fSignatureValid = (RC_SUCCESS == rgunSignatureResults[unIndex]);
+					pVerification->fVerified = TRUE;
 				}
+
+				// Run the remaining checks
+				pCheck->unReturnValue = FirmwareUpdate_CheckImageIntegrity(pCheck->pParsedImage, FALSE, &pCheck->unErrorDetails, &pCheck->pwszErrorMessage, &fSignaturePending);
 			}
+		}
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
 
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Function to check if the TPM is updatable with the given firmware image
+ *	@details	Some parameters like GUID, file content signature, TPM firmware major minor version or file content CRC
+ *				are checked to get a decision if the firmware is updatable with the current image.
+ *
+ *	@param		PbfTpmAttributes			TPM state attributes
+ *	@param		PpsParsedImage				Pointer to the parsed firmware image
+ *	@param		PpfValid					TRUE in case the image is valid, FALSE otherwise.
+ *	@param		PpbfNewTpmFirmwareInfo		Pointer to a bit field to return info data for the new firmware image.
+ *	@param		PpunErrorDetails			Pointer to an unsigned int to return error details. Possible values are:\n
+ *												RC_E_FW_UPDATE_BLOCKED in case the field upgrade counter value has been exceeded.\n
+ *												RC_E_WRONG_FW_IMAGE in case the TPM is not updatable with the given image.\n
+ *												RC_E_CORRUPT_FW_IMAGE in case the firmware image is corrupt.\n
+ *												RC_E_NEWER_TOOL_REQUIRED in case a newer version of the tool is required to parse the firmware image.\n
+ *												RC_E_WRONG_DECRYPT_KEYS in case the TPM2.0 does not have decrypt keys matching to the firmware image.
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
+ *	@retval		RC_E_BAD_PARAMETER			In case of a NULL input parameter
+ *	@retval		...							Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FirmwareUpdate_IsFirmwareUpdatable(
+	_In_								BITFIELD_TPM_ATTRIBUTES			PbfTpmAttributes,
+	_Inout_								IfxParsedFirmwareImage*			PpsParsedImage,
+	_Out_								BOOL*							PpfValid,
+	_Out_								BITFIELD_NEW_TPM_FIRMWARE_INFO*	PpbfNewTpmFirmwareInfo,
+	_Out_								UINT32*							PpunErrorDetails)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		const wchar_t* pwszErrorMessage = NULL;
+		BOOL fDigestsKnownBefore = FALSE;
+
+		// Check _Out_ parameters.
+		if (NULL == PpfValid || NULL == PpbfNewTpmFirmwareInfo || NULL == PpunErrorDetails)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpfValid or PpbfNewTpmFirmwareInfo or PpunErrorDetails is NULL)");
+			break;
+		}
+
+		// Set default value for _Out_ parameters.
+		*PpfValid = FALSE;
+		*PpunErrorDetails = RC_E_WRONG_FW_IMAGE;
+		unReturnValue = Platform_MemorySet(PpbfNewTpmFirmwareInfo, 0, sizeof(BITFIELD_NEW_TPM_FIRMWARE_INFO));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		// Check _In_ parameters.
+		if (NULL == PpsParsedImage ||
+				NULL == PpsParsedImage->rgbImage ||
+				0 == PpsParsedImage->unImageSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpsParsedImage or its image byte stream is NULL or empty)");
+			break;
+		}
+
+		// Take the digests from the verified-image cache if it knows this image file and they have not been calculated before.
+		// A hit only skips hashing the image, which is the expensive part of the check. The signature is still verified over
+		// the cached digests on purpose: it is a single RSA-2048 public key operation of some tens of microseconds, and it
+		// keeps a copied or leaked cache key from making the tool accept digests which were not signed with the firmware key.
+		fDigestsKnownBefore = PpsParsedImage->sVerification.fDigestsKnown;
+		if (!fDigestsKnownBefore && PpsParsedImage->fParsed)
+		{
+			fDigestsKnownBefore = ImageCache_Lookup(PpsParsedImage->rgbImage, PpsParsedImage->unImageSize, &PpsParsedImage->sHeader, &PpsParsedImage->sVerification.sDigests);
+			PpsParsedImage->sVerification.fDigestsKnown = fDigestsKnownBefore;
+		}
+
+		// Check the integrity of the firmware image (GUID, CRC, signature, firmware digest, structure version)
+		unReturnValue = FirmwareUpdate_VerifyImage(PpsParsedImage, PpunErrorDetails, &pwszErrorMessage);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			ERROR_STORE_FMT(unReturnValue, L"%ls", NULL != pwszErrorMessage ? pwszErrorMessage : L"FirmwareUpdate_VerifyImage returned an unexpected value");
+			break;
+		}
+
+		// Remember the digests of a correctly signed image in the verified-image cache
+		if (!fDigestsKnownBefore && PpsParsedImage->sVerification.fVerified && PpsParsedImage->sVerification.fSignatureValid)
+			ImageCache_Store(PpsParsedImage->rgbImage, PpsParsedImage->unImageSize, &PpsParsedImage->sHeader, &PpsParsedImage->sVerification.sDigests);
+
+		if (RC_SUCCESS != *PpunErrorDetails)
+		{
+			if (NULL != pwszErrorMessage)
+				ERROR_STORE_FMT(*PpunErrorDetails, L"%ls", pwszErrorMessage);
+			break;
+		}
+		*PpunErrorDetails = RC_E_WRONG_FW_IMAGE;
+
+		// Run TPM specific checks on policy parameter block
+		{
 			// On TPM2.0 check that the TPM and the firmware image use the same key material
 			if (PbfTpmAttributes.tpm20)
 			{
@@ -600,7 +999,7 @@ FirmwareUpdate_IsFirmwareUpdatable(
 				// There should be at least one match
 				for (unIndex = 0; unIndex < sSecurityModuleLogicInfo2.sKeyList.wEntries; unIndex++)
 				{
-					if (sSecurityModuleLogicInfo2.sKeyList.DecryptKeyId[unIndex] == sSignedData.sSignerInfo.sSignedAttributes.DecryptKeyId)
+					if (sSecurityModuleLogicInfo2.sKeyList.DecryptKeyId[unIndex] == PpsParsedImage->sSignedData.sSignerInfo.sSignedAttributes.DecryptKeyId)
 					{
 						fDecryptKeyValid = TRUE;
 						break;
@@ -648,17 +1047,17 @@ FirmwareUpdate_IsFirmwareUpdatable(
 				break;
 
 			// Check if the firmware version is listed in the allowed source versions
-			for (; unIndex < PpsFirmwareImage->usSourceVersionsCount; unIndex++)
+			for (; unIndex < PpsParsedImage->sHeader.usSourceVersionsCount; unIndex++)
 			{
 				// Try the firmware version with subversion.minor first (e.g. 4.40.119.0)
-				if (0 == Platform_StringCompare(wszFirmwareVersion, PpsFirmwareImage->rgwszSourceVersions[unIndex], unFirmwareVersionSize + 1, FALSE))
+				if (0 == Platform_StringCompare(wszFirmwareVersion, PpsParsedImage->sHeader.rgwszSourceVersions[unIndex], unFirmwareVersionSize + 1, FALSE))
 				{
 					fImageAllowed = TRUE;
 					break;
 				}
 
 				// If this does not match, try the firmware version without subversion.minor (e.g. 4.40.119)
-				if (0 == Platform_StringCompare(wszFirmwareVersionShort, PpsFirmwareImage->rgwszSourceVersions[unIndex], unFirmwareVersionShortSize + 1, FALSE))
+				if (0 == Platform_StringCompare(wszFirmwareVersionShort, PpsParsedImage->sHeader.rgwszSourceVersions[unIndex], unFirmwareVersionShortSize + 1, FALSE))
 				{
 					fImageAllowed = TRUE;
 					break;
@@ -685,12 +1084,7 @@ FirmwareUpdate_IsFirmwareUpdatable(
 			BOOL fActiveVersionVerified = FALSE;
 
 			// First get the current running build number from FieldUpgradeInfoRequest2
-			unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
-			if (TPM_RESOURCES == (unReturnValue ^ RC_TPM_MASK))
-			{
-				// Retry once on TPM_RESOURCES
-				unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
-			}
+			unReturnValue = FirmwareUpdate_Tpm12_GetSecurityModuleLogicInfo(&securityModuleLogicInfo);
 			if (RC_SUCCESS != unReturnValue)
 			{
 				ERROR_STORE(unReturnValue, L"TSS_TPM_FieldUpgradeInfoRequest2 returned an unexpected value.");
@@ -712,9 +1106,9 @@ FirmwareUpdate_IsFirmwareUpdatable(
 				// Verify against allowed source versions
 				// VERSION_3 or greater: uses data from meta data section
 				// Others: uses data from parameter block
-				for (unIndex = 0; unIndex < PpsFirmwareImage->usIntSourceVersionCount; unIndex++)
+				for (unIndex = 0; unIndex < PpsParsedImage->sHeader.usIntSourceVersionCount; unIndex++)
 				{
-					if (PpsFirmwareImage->rgunIntSourceVersions[unIndex] == unActiveVersion)
+					if (PpsParsedImage->sHeader.rgunIntSourceVersions[unIndex] == unActiveVersion)
 					{
 						fActiveVersionVerified = TRUE;
 						break;
@@ -731,38 +1125,21 @@ FirmwareUpdate_IsFirmwareUpdatable(
 			}
 
 			// For VERSION_3 firmware images match unique ID between policy parameter block and TPM.
-			if (PpsFirmwareImage->bfCapabilities.invalidFirmwareMode_matchUniqueID)
-			{
-				BYTE* rgbPolicyParameterBlock = NULL;
-				INT32 nPolicyParameterBlockSize = 0;
-				sSignedData_d sSignedData = {0};
-				// Copy pointer and size for unmarshalling
-				rgbPolicyParameterBlock = PpsFirmwareImage->rgbPolicyParameterBlock;
-				nPolicyParameterBlockSize = PpsFirmwareImage->usPolicyParameterBlockSize;
-				// Unmarshal the block to sSignedData structure
-				unReturnValue = TSS_sSignedData_d_Unmarshal(&sSignedData, &rgbPolicyParameterBlock, &nPolicyParameterBlockSize);
-				if (RC_SUCCESS != unReturnValue)
-				{
-					ERROR_STORE_FMT(RC_E_CORRUPT_FW_IMAGE, L"TSS_sSignedData_d_Unmarshal returned an unexpected value. (0x%.8x)", unReturnValue);
-					unReturnValue = RC_E_CORRUPT_FW_IMAGE;
-					break;
-				}
-
-				{
-					// Get the unique ID from policy parameter block.
-					unsigned int unUniqueTPM = 0;
-					unsigned int unUniqueFirmwareImage = sSignedData.sSignerInfo.sSignedAttributes.sFirmwarePackage.StaleVersion & 0x0000000f;
+			if (PpsParsedImage->sHeader.bfCapabilities.invalidFirmwareMode_matchUniqueID)
+			{
+				// Get the unique ID from policy parameter block.
+				unsigned int unUniqueTPM = 0;
+				unsigned int unUniqueFirmwareImage = PpsParsedImage->sSignedData.sSignerInfo.sSignedAttributes.sFirmwarePackage.StaleVersion & 0x0000000f;
 
-					// Get the unique ID from the TPM
-					unUniqueTPM = securityModuleLogicInfo.sProcessFirmwarePackage.StaleVersion & 0x0000000f;
+				// Get the unique ID from the TPM
+				unUniqueTPM = securityModuleLogicInfo.sProcessFirmwarePackage.StaleVersion & 0x0000000f;
 
-					// Match unique ID of policy parameter block and TPM.
-					if (unUniqueFirmwareImage != unUniqueTPM)
-					{
-						unReturnValue = RC_SUCCESS;
-						*PpunErrorDetails = RC_E_WRONG_FW_IMAGE;
-						break;
-					}
+				// Match unique ID of policy parameter block and TPM.
+				if (unUniqueFirmwareImage != unUniqueTPM)
+				{
+					unReturnValue = RC_SUCCESS;
+					*PpunErrorDetails = RC_E_WRONG_FW_IMAGE;
+					break;
 				}
 			}
 		}
@@ -771,12 +1148,12 @@ FirmwareUpdate_IsFirmwareUpdatable(
 		*PpfValid = TRUE;
 
 		// Check if device type changes with an update
-		if (PpsFirmwareImage->bSourceTpmFamily != PpsFirmwareImage->bTargetTpmFamily)
+		if (PpsParsedImage->sHeader.bSourceTpmFamily != PpsParsedImage->sHeader.bTargetTpmFamily)
 		{
 			PpbfNewTpmFirmwareInfo->deviceTypeChange = 1;
 			PpbfNewTpmFirmwareInfo->factoryDefaults = 1;
 		}
-		else if (PpsFirmwareImage->bfTargetState.factoryDefaults)
+		else if (PpsParsedImage->sHeader.bfTargetState.factoryDefaults)
 		{
 			PpbfNewTpmFirmwareInfo->factoryDefaults = 1;
 		}
@@ -790,7 +1167,8 @@ FirmwareUpdate_IsFirmwareUpdatable(
 
 /**
  *	@brief		Returns the TPM state attributes
- *	@details
+ *	@details	The TPM state is read from the TPM once per session and kept in the TPM state cache until
+ *				FirmwareUpdate_InvalidateTpmStateCache is called.
  *
  *	@param		PpsTpmState					Pointer to a variable representing the TPM state
  *
@@ -805,6 +1183,7 @@ FirmwareUpdate_CalculateState(
 	_Out_ TPM_STATE* PpsTpmState)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned long long ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
 
 	do
 	{
@@ -816,6 +1195,13 @@ FirmwareUpdate_CalculateState(
 			break;
 		}
 
+		// Return the TPM state read before in this session
+		if (s_sTpmStateCache.fTpmStateValid)
+		{
+			unReturnValue = Platform_MemoryCopy(PpsTpmState, sizeof(*PpsTpmState), &s_sTpmStateCache.sTpmState, sizeof(s_sTpmStateCache.sTpmState));
+			break;
+		}
+
 		unReturnValue = Platform_MemorySet(PpsTpmState, 0, sizeof(*PpsTpmState));
 		if (RC_SUCCESS != unReturnValue)
 			break;
@@ -873,6 +1259,7 @@ FirmwareUpdate_CalculateState(
 						// Initialize authorization command data structure
 						sAuthSessionData.authHandle = TPM_RS_PW;	// Use password based authorization session
 						sAuthSessionData.sessionAttributes.continueSession = 1;
+						// (Hint: the probe changes the Empty Buffer to the Empty Buffer, so the TPM state cache stays valid)
 						unReturnValue = TSS_TPM2_HierarchyChangeAuth(TPM_RH_PLATFORM, sAuthSessionData, sNewAuth, &sAckAuthSessionData);
 						if (TPM_RC_SUCCESS == unReturnValue)
 						{
@@ -996,12 +1383,7 @@ FirmwareUpdate_CalculateState(
 					{
 						sSecurityModuleLogicInfo_d securityModuleLogicInfo = {0};
 						PpsTpmState->attribs.infineon = 1;
-						unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
-						if (TPM_RESOURCES == (unReturnValue ^ RC_TPM_MASK))
-						{
-							// Retry once on TPM_RESOURCES
-							unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
-						}
+						unReturnValue = FirmwareUpdate_Tpm12_GetSecurityModuleLogicInfo(&securityModuleLogicInfo);
 
 						if (TPM_BAD_PARAM_SIZE == (unReturnValue ^ RC_TPM_MASK) || TPM_BAD_PARAMETER == (unReturnValue ^ RC_TPM_MASK))
 						{
@@ -1054,37 +1436,44 @@ FirmwareUpdate_CalculateState(
 	}
 	WHILE_FALSE_END;
 
+	// Remember the TPM state for this session
+	if (RC_SUCCESS == unReturnValue && !s_sTpmStateCache.fTpmStateValid &&
+			RC_SUCCESS == Platform_MemoryCopy(&s_sTpmStateCache.sTpmState, sizeof(s_sTpmStateCache.sTpmState), PpsTpmState, sizeof(*PpsTpmState)))
+	{
+		s_sTpmStateCache.fTpmStateValid = TRUE;
+	}
+
+	Timing_RecordPhase(TIMING_PHASE_CALCULATE_STATE, ullStartUs);
+
 	return unReturnValue;
 }
 
 /**
  *	@brief		FirmwareUpdate start for TPM2.0.
- *	@details	The function takes the firmware update policy parameter block and the stored policy session and starts the
+ *	@details	The function takes the unmarshalled firmware update policy parameter block and the stored policy session and starts the
  *				firmware update process.
  *
- *	@param		PusPolicyParameterBlockSize		Size of the policy parameter block
- *	@param		PrgbPolicyParameterBlock		Pointer to the policy parameter block byte stream
+ *	@param		PpsSignedData					Pointer to the unmarshalled policy parameter block
  *	@param		PunSessionHandle				Session handle
  *	@param		PfnProgress						Callback function to indicate the progress
  *
  *	@retval		RC_SUCCESS								The operation completed successfully.
- *	@retval		RC_E_BAD_PARAMETER						An invalid parameter was passed to the function. Policy parameter block stream is NULL
+ *	@retval		RC_E_BAD_PARAMETER						An invalid parameter was passed to the function. Policy parameter block is NULL
  *	@retval		RC_E_TPM20_INVALID_POLICY_SESSION		The policy session handle is 0 or invalid or policy authorization failed
  *	@retval		RC_E_TPM20_POLICY_HANDLE_OUT_OF_RANGE	The policy handle value is out of range
  *	@retval		RC_E_TPM20_POLICY_SESSION_NOT_LOADED	The policy session is not loaded to the TPM
- *	@retval		RC_E_CORRUPT_FW_IMAGE					Firmware image is corrupt
  *	@retval		RC_E_FIRMWARE_UPDATE_FAILED				Firmware update started but failed
  *	@retval		RC_E_FAIL								An unexpected error occurred.
  */
 _Check_return_
 unsigned int
 FirmwareUpdate_Start_Tpm20(
-	_In_bytecount_(PusPolicyParameterBlockSize)	BYTE*								PrgbPolicyParameterBlock,
-	_In_										UINT16								PusPolicyParameterBlockSize,
-	_In_										unsigned int						PunSessionHandle,
-	_In_										PFN_FIRMWAREUPDATE_PROGRESSCALLBACK	PfnProgress)
+	_In_	const sSignedData_d*				PpsSignedData,
+	_In_	unsigned int						PunSessionHandle,
+	_In_	PFN_FIRMWAREUPDATE_PROGRESSCALLBACK	PfnProgress)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned long long ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
 
 	do
 	{
@@ -1092,21 +1481,14 @@ FirmwareUpdate_Start_Tpm20(
 		AuthorizationCommandData sAuthSessionData = {0};
 		AcknowledgmentResponseData sAckAuthSessionData = {{0}};
 
-		// Policy parameter block data
-		sSignedData_d sSignedData = {0};
-
-		BYTE* rgbPolicyParameterBlock = NULL;
-		INT32 nPolicyParameterBlockSize = 0;
-
 		// Out parameter
 		unsigned short usStartSize = 0;
 
 		// Check parameters
-		if (NULL == PrgbPolicyParameterBlock ||
-				0 == PusPolicyParameterBlockSize)
+		if (NULL == PpsSignedData)
 		{
 			unReturnValue = RC_E_BAD_PARAMETER;
-			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PrgbPolicyParameterBlock is NULL or PusPolicyParameterBlockSize is zero)");
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpsSignedData is NULL)");
 			break;
 		}
 
@@ -1117,25 +1499,13 @@ FirmwareUpdate_Start_Tpm20(
 			break;
 		}
 
-		// Copy pointer and size for unmarshalling
-		rgbPolicyParameterBlock = PrgbPolicyParameterBlock;
-		nPolicyParameterBlockSize = PusPolicyParameterBlockSize;
-
-		// Unmarshal the block to sSignedData structure
-		unReturnValue = TSS_sSignedData_d_Unmarshal(&sSignedData, &rgbPolicyParameterBlock, &nPolicyParameterBlockSize);
-		if (RC_SUCCESS != unReturnValue)
-		{
-			ERROR_STORE_FMT(RC_E_CORRUPT_FW_IMAGE, L"TSS_sSignedData_d_Unmarshal returned an unexpected value. (0x%.8x)", unReturnValue);
-			unReturnValue = RC_E_CORRUPT_FW_IMAGE;
-			break;
-		}
-
 		// Initialize authorization command data structure
 		sAuthSessionData.authHandle = PunSessionHandle;
 		sAuthSessionData.sessionAttributes.continueSession = 1;
 
 		// Call TPM2_FieldUpgradeStartVendor command
-		unReturnValue = TSS_TPM2_FieldUpgradeStartVendor(TPM_RH_PLATFORM, sAuthSessionData, sSignedData, &usStartSize, &sAckAuthSessionData);
+		unReturnValue = TSS_TPM2_FieldUpgradeStartVendor(TPM_RH_PLATFORM, sAuthSessionData, *PpsSignedData, &usStartSize, &sAckAuthSessionData);
+		FirmwareUpdate_InvalidateTpmStateCache();
 		if ((RC_TPM_MASK | TPM_RC_REFERENCE_S0) == unReturnValue)
 		{
 			// Policy session handle is not loaded to the TPM
@@ -1171,12 +1541,15 @@ FirmwareUpdate_Start_Tpm20(
 	}
 	WHILE_FALSE_END;
 
+	Timing_RecordPhase(TIMING_PHASE_START, ullStartUs);
+
 	return unReturnValue;
 }
 
 /**
  *	@brief		FirmwareUpdate start for TPM1.2.
  *	@details	The function takes the firmware update policy parameter block and starts the firmware update process.
+ *				The policy parameter block has already been unmarshalled and checked by FirmwareUpdate_ParseImage.
  *
  *	@param		PbfTpmAttributes				The operation mode of the TPM.
  *	@param		PrgbPolicyParameterBlock		Pointer to the policy parameter block byte stream
@@ -1186,7 +1559,6 @@ FirmwareUpdate_Start_Tpm20(
  *
  *	@retval		RC_SUCCESS						The operation completed successfully.
  *	@retval		RC_E_BAD_PARAMETER				An invalid parameter was passed to the function. Policy parameter block stream is NULL or policy session handle is not 0.
- *	@retval		RC_E_CORRUPT_FW_IMAGE			Policy parameter block is corrupt and/or cannot be unmarshalled.
  *	@retval		RC_E_FAIL						TPM connection or command error.
  *	@retval		RC_E_TPM12_DEFERREDPP_REQUIRED	Deferred Physical Presence has not been set (TPM1.2 only).
  *	@retval		RC_E_FIRMWARE_UPDATE_FAILED		The update operation was started but failed.
@@ -1201,17 +1573,13 @@ _Check_return_ unsigned int FirmwareUpdate_Start_Tpm12(
 	_In_										PFN_FIRMWAREUPDATE_PROGRESSCALLBACK	PfnProgress)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned long long ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
 
 	do
 	{
 		TPM_NONCE sNonceEven = {{0}};
 		TPM_AUTHHANDLE unAuthHandle = 0;
 		BYTE* pbOwnerAuth = NULL;
-		BYTE* rgbPolicyParameterBlock = NULL;
-		INT32 nPolicyParameterBlockSize = 0;
-
-		// Policy parameter block data
-		sSignedData_d sSignedData = {0};
 
 		// Check parameters
 		if (NULL == PrgbPolicyParameterBlock ||
@@ -1222,19 +1590,6 @@ _Check_return_ unsigned int FirmwareUpdate_Start_Tpm12(
 			break;
 		}
 
-		// Copy pointer and size for unmarshalling
-		rgbPolicyParameterBlock = PrgbPolicyParameterBlock;
-		nPolicyParameterBlockSize = PusPolicyParameterBlockSize;
-
-		// Unmarshal the block to sSignedData structure
-		unReturnValue = TSS_sSignedData_d_Unmarshal(&sSignedData, &rgbPolicyParameterBlock, &nPolicyParameterBlockSize);
-		if (RC_SUCCESS != unReturnValue)
-		{
-			ERROR_STORE_FMT(RC_E_CORRUPT_FW_IMAGE, L"TSS_sSignedData_d_Unmarshal returned an unexpected value. (0x%.8x)", unReturnValue);
-			unReturnValue = RC_E_CORRUPT_FW_IMAGE;
-			break;
-		}
-
 		if (PbfTpmAttributes.tpm12 && PbfTpmAttributes.tpm12owner)
 		{
 			// Get dictionary attack state for TPM_ET_OWNER and return RC_E_TPM12_DA_ACTIVE if TPM Owner is locked out.
@@ -1292,6 +1647,7 @@ _Check_return_ unsigned int FirmwareUpdate_Start_Tpm12(
 		}
 
 		unReturnValue = TSS_TPM_FieldUpgradeStart(PrgbPolicyParameterBlock, PusPolicyParameterBlockSize, pbOwnerAuth, unAuthHandle, &sNonceEven);
+		FirmwareUpdate_InvalidateTpmStateCache();
 		if (RC_SUCCESS != unReturnValue)
 		{
 			if (TPM_BAD_PRESENCE == (unReturnValue ^ RC_TPM_MASK))
@@ -1325,13 +1681,126 @@ _Check_return_ unsigned int FirmwareUpdate_Start_Tpm12(
 	}
 	WHILE_FALSE_END;
 
+	Timing_RecordPhase(TIMING_PHASE_START, ullStartUs);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Readiness probe for the boot loader mode
+ *	@details	Checks with TPM_FieldUpgradeInfoRequest2 whether the TPM has switched to boot loader mode.
+ *
+ *	@param		PpContext				Pointer to a UINT16 receiving the maximum data size for a firmware block
+ *	@param		PpfReady				Receives TRUE if the TPM is in boot loader mode
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_UNSUPPORTED_CHIP	The TPM does not support TPM_FieldUpgradeInfoRequest2.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+static unsigned int
+FirmwareUpdate_ProbeBootLoaderMode(
+	_Inout_opt_	void*	PpContext,
+	_Out_		BOOL*	PpfReady)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		sSecurityModuleLogicInfo_d securityModuleLogicInfo = {0};
+
+		*PpfReady = FALSE;
+
+		// Get the max data size for a firmware update block.
+		unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
+		if (TPM_RESOURCES == (unReturnValue ^ RC_TPM_MASK))
+		{
+			// Retry once on TPM_RESOURCES
+			unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
+		}
+		if (RC_SUCCESS != unReturnValue)
+		{
+			if (TPM_BAD_PARAM_SIZE == (unReturnValue ^ RC_TPM_MASK) ||
+					TPM_BAD_PARAMETER == (unReturnValue ^ RC_TPM_MASK))
+			{
+				ERROR_STORE(unReturnValue, L"TSS_TPM_FieldUpgradeInfoRequest2 returned an unexpected value.");
+				unReturnValue = RC_E_UNSUPPORTED_CHIP;
+			}
+			ERROR_STORE(unReturnValue, L"TSS_TPM_FieldUpgradeInfoRequest2 returned an unexpected value.");
+			break;
+		}
+		*(UINT16*)PpContext = securityModuleLogicInfo.wMaxDataSize;
+
+		// Verify that TPM switched to boot loader mode.
+		if (securityModuleLogicInfo.SecurityModuleStatus == SMS_BTLDR_ACTIVE)
+			*PpfReady = TRUE;
+		else
+			LOGGING_WRITE_LEVEL4(L"TPM is not in boot loader mode yet");
+	}
+	WHILE_FALSE_END;
+
 	return unReturnValue;
 }
 
+/**
+ *	@brief		Readiness probe for the new firmware
+ *	@details	Checks whether the TPM answers commands again after TPM_FieldUpgradeComplete. A TPM2.0 is ready if it
+ *				answers TPM2_GetTestResult with TPM_RC_SUCCESS or TPM_RC_INITIALIZE (TPM2_Startup pending). A TPM1.2
+ *				rejects the TPM2.0 command with TPM_BADTAG and is ready if it answers TPM_GetTestResult with TPM_SUCCESS.
+ *				Any other response code and transport errors mean that the TPM is not ready (yet).
+ *
+ *	@param		PpContext				Not used
+ *	@param		PpfReady				Receives TRUE if the TPM runs the new firmware
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ */
+_Check_return_
+static unsigned int
+FirmwareUpdate_ProbeFirmwareReady(
+	_Inout_opt_	void*	PpContext,
+	_Out_		BOOL*	PpfReady)
+{
+	UNREFERENCED_PARAMETER(PpContext);
+
+	do
+	{
+		TPM2B_MAX_BUFFER sOutData = {0};
+		TPM_RC rcTestResult = 0;
+		unsigned int unReturnValue = RC_E_FAIL;
+
+		*PpfReady = FALSE;
+
+		unReturnValue = TSS_TPM2_GetTestResult(&sOutData, &rcTestResult);
+		if (RC_SUCCESS == unReturnValue || (RC_TPM_MASK | TPM_RC_INITIALIZE) == unReturnValue)
+		{
+			*PpfReady = TRUE;
+			break;
+		}
+
+		if ((RC_TPM_MASK | TPM_BADTAG) == unReturnValue)
+		{
+			BYTE rgbTestResult[MAX_NAME] = {0};
+			unsigned int unTestResultSize = RG_LEN(rgbTestResult);
+			unReturnValue = TSS_TPM_GetTestResult(&unTestResultSize, rgbTestResult);
+			if (RC_SUCCESS == unReturnValue)
+			{
+				*PpfReady = TRUE;
+				break;
+			}
+		}
+
+		LOGGING_WRITE_LEVEL4_FMT(L"TPM is not ready yet (0x%.8x)", unReturnValue);
+	}
+	WHILE_FALSE_END;
+
+	return RC_SUCCESS;
+}
+
 /**
  *	@brief		FirmwareUpdateProcess Update
  *	@details	The function determines the maximum data size for a firmware block and sends the firmware to the TPM
- *				in chunks of maximum data size.
+ *				in chunks of maximum data size. The next block is marshalled into a second request frame while the TPM
+ *				processes the current one.
  *
  *	@param		PunFirmwareBlockSize	Size of the firmware block
  *	@param		PrgbFirmwareBlock		Pointer to the firmware block byte stream
@@ -1357,6 +1826,9 @@ _Check_return_ unsigned int FirmwareUpdate_Update(
 		UINT32 unBlockNumber = 0;
 		UINT32 unCurrentProgress = 1;
 		UINT16 usMaxDataSize = 0;
+		IfxFieldUpgradeUpdateFrame rgsFrames[2];
+		UINT32 unFrame = 0;
+		UINT16 usBlockSize = 0;
 
 		// Check parameters
 		if (NULL == PrgbFirmwareBlock)
@@ -1370,57 +1842,57 @@ _Check_return_ unsigned int FirmwareUpdate_Update(
 		unRemainingBytes = PunFirmwareBlockSize;
 
 		{
-			unsigned int unRetryCounter = 0;
-
-			for (unRetryCounter = 0; unRetryCounter < TPM_FU_START_MAX_RETRIES; unRetryCounter++)
+			// Wait until the TPM has switched to boot loader mode and get the max data size for a firmware update block.
+			BOOL fBootLoaderMode = FALSE;
+			unsigned long long ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
+			unReturnValue = Polling_WaitForCondition(POLLING_WAIT_BOOT_LOADER_MODE, TPM_FU_START_TIMEOUT * 1000, &FirmwareUpdate_ProbeBootLoaderMode, &usMaxDataSize, &fBootLoaderMode);
+			Timing_RecordPhase(TIMING_PHASE_BOOT_LOADER_WAIT, ullStartUs);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+			if (FALSE == fBootLoaderMode)
 			{
-				// Get the max data size for a firmware update block.
-				sSecurityModuleLogicInfo_d securityModuleLogicInfo = {0};
-				unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
-				if (TPM_RESOURCES == (unReturnValue ^ RC_TPM_MASK))
-				{
-					// Retry once on TPM_RESOURCES
-					unReturnValue = TSS_TPM_FieldUpgradeInfoRequest2(&securityModuleLogicInfo);
-				}
-				if (RC_SUCCESS != unReturnValue)
-				{
-					if (TPM_BAD_PARAM_SIZE == (unReturnValue ^ RC_TPM_MASK) ||
-							TPM_BAD_PARAMETER == (unReturnValue ^ RC_TPM_MASK))
-					{
-						ERROR_STORE(unReturnValue, L"TSS_TPM_FieldUpgradeInfoRequest2 returned an unexpected value.");
-						unReturnValue = RC_E_UNSUPPORTED_CHIP;
-					}
-					ERROR_STORE(unReturnValue, L"TSS_TPM_FieldUpgradeInfoRequest2 returned an unexpected value.");
-					break;
-				}
-				usMaxDataSize = securityModuleLogicInfo.wMaxDataSize;
-
-				// Verify that TPM switched to boot loader mode. Wait some time if it did not.
-				if (securityModuleLogicInfo.SecurityModuleStatus != SMS_BTLDR_ACTIVE)
-				{
-					unReturnValue = RC_E_TPM_NO_BOOT_LOADER_MODE;
-					LOGGING_WRITE_LEVEL1_FMT(L"TPM is not in boot loader mode as expected (Count:%d)", unRetryCounter);
-					Platform_Sleep(TPM_FU_START_RETRY_WAIT_TIME);
-					continue;
-				}
-				else
-				{
-					unReturnValue = RC_SUCCESS;
-					break;
-				}
+				unReturnValue = RC_E_TPM_NO_BOOT_LOADER_MODE;
+				LOGGING_WRITE_LEVEL1_FMT(L"TPM is not in boot loader mode as expected after %d ms", TPM_FU_START_TIMEOUT);
+				break;
 			}
+		}
 
+		// Marshal the first data block
+		if (unRemainingBytes > 0)
+		{
+			usBlockSize = unRemainingBytes < usMaxDataSize ? (UINT16)unRemainingBytes : usMaxDataSize;
+			unReturnValue = TSS_TPM_FieldUpgradeUpdate_Marshal(rgbFirmwareBlock, usBlockSize, &rgsFrames[unFrame]);
 			if (RC_SUCCESS != unReturnValue)
+			{
+				ERROR_STORE_FMT(RC_E_FIRMWARE_UPDATE_FAILED, L"TSS_TPM_FieldUpgradeUpdate_Marshal returned an unexpected value while processing block 1. (0x%.8x)", unReturnValue);
+				unReturnValue = RC_E_FIRMWARE_UPDATE_FAILED;
 				break;
+			}
 		}
 
 		// Send the firmware image to the TPM block-by-block.
 		for (unBlockNumber = 1; unRemainingBytes > 0; unBlockNumber++)
 		{
-			UINT16 usBlockSize = unRemainingBytes < usMaxDataSize ? (UINT16)unRemainingBytes : usMaxDataSize;
+			unsigned long long ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
+			unsigned int unMarshalResult = RC_SUCCESS;
+			UINT16 usNextBlockSize = 0;
 
-			// Transmit data block
-			unReturnValue = TSS_TPM_FieldUpgradeUpdate(rgbFirmwareBlock, usBlockSize);
+			// Send data block
+			unReturnValue = TSS_TPM_FieldUpgradeUpdate_Send(&rgsFrames[unFrame]);
+			if (RC_SUCCESS == unReturnValue)
+			{
+				// Marshal the next data block into the other frame while the TPM processes the current one
+				UINT32 unNextRemainingBytes = unRemainingBytes - usBlockSize;
+				if (unNextRemainingBytes > 0)
+				{
+					usNextBlockSize = unNextRemainingBytes < usMaxDataSize ? (UINT16)unNextRemainingBytes : usMaxDataSize;
+					unMarshalResult = TSS_TPM_FieldUpgradeUpdate_Marshal(rgbFirmwareBlock + usBlockSize, usNextBlockSize, &rgsFrames[unFrame ^ 1]);
+				}
+
+				// Receive the response of the data block
+				unReturnValue = TSS_TPM_FieldUpgradeUpdate_Receive();
+			}
+			Timing_RecordPhase(TIMING_PHASE_UPDATE_BLOCK, ullStartUs);
 			if (RC_SUCCESS != unReturnValue)
 			{
 				ERROR_STORE_FMT(RC_E_FIRMWARE_UPDATE_FAILED, L"TSS_TPM_FieldUpgradeUpdate returned an unexpected value while processing block %d. (0x%.8x)", unBlockNumber, unReturnValue);
@@ -1443,6 +1915,17 @@ _Check_return_ unsigned int FirmwareUpdate_Update(
 					PfnProgress(unCurrentProgress);
 				}
 			}
+
+			if (RC_SUCCESS != unMarshalResult)
+			{
+				ERROR_STORE_FMT(RC_E_FIRMWARE_UPDATE_FAILED, L"TSS_TPM_FieldUpgradeUpdate_Marshal returned an unexpected value while processing block %d. (0x%.8x)", unBlockNumber + 1, unMarshalResult);
+				unReturnValue = RC_E_FIRMWARE_UPDATE_FAILED;
+				break;
+			}
+
+			// Switch to the frame holding the next data block
+			usBlockSize = usNextBlockSize;
+			unFrame ^= 1;
 		}
 	}
 	WHILE_FALSE_END;
@@ -1463,6 +1946,7 @@ _Check_return_ unsigned int FirmwareUpdate_Complete(
 	_In_	PFN_FIRMWAREUPDATE_PROGRESSCALLBACK			PfnProgress)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned long long ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
 
 	do
 	{
@@ -1472,6 +1956,7 @@ _Check_return_ unsigned int FirmwareUpdate_Complete(
 		BYTE bCompleteData = 0;
 
 		unReturnValue = TSS_TPM_FieldUpgradeComplete(usCompleteDataSize, &bCompleteData, &usOutCompleteSize);
+		FirmwareUpdate_InvalidateTpmStateCache();
 		if (TPM_RC_SUCCESS != unReturnValue)
 		{
 			BOOL fIgnoreError = FALSE;
@@ -1497,8 +1982,19 @@ _Check_return_ unsigned int FirmwareUpdate_Complete(
 			break;
 		}
 
-		// Wait for TPM to complete update sequence
-		Platform_Sleep(TPM_FU_COMPLETE_WAIT_TIME);
+		// Let the TPM settle shortly, then probe it until it completed the update sequence. The probe runs without
+		// transport level retries, so that a probe for a TPM which is still restarting does not exceed the deadline.
+		Platform_Sleep(TPM_FU_COMPLETE_SETTLE_TIME);
+		{
+			BOOL fFirmwareReady = FALSE;
+			DeviceManagement_SetRetry(FALSE);
+			unReturnValue = Polling_WaitForCondition(POLLING_WAIT_FIRMWARE_READY, TPM_FU_COMPLETE_TIMEOUT * 1000, &FirmwareUpdate_ProbeFirmwareReady, NULL, &fFirmwareReady);
+			DeviceManagement_SetRetry(TRUE);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+			if (FALSE == fFirmwareReady)
+				LOGGING_WRITE_LEVEL1_FMT(L"TPM did not report readiness within %d ms after TPM_FieldUpgradeComplete", TPM_FU_COMPLETE_SETTLE_TIME + TPM_FU_COMPLETE_TIMEOUT);
+		}
 
 		// Set Progress to 100%
 		PfnProgress(100);
@@ -1507,6 +2003,8 @@ _Check_return_ unsigned int FirmwareUpdate_Complete(
 	}
 	WHILE_FALSE_END;
 
+	Timing_RecordPhase(TIMING_PHASE_COMPLETE, ullStartUs);
+
 	return unReturnValue;
 }
 
@@ -1598,8 +2096,7 @@ FirmwareUpdate_GetImageInfo(
  *	@brief		Checks if the firmware image is valid for the TPM
  *	@details	Performs integrity, consistency and content checks to determine if the given firmware image can be applied to the installed TPM.
  *
- *	@param		PrgbImage					Firmware image byte stream
- *	@param		PullImageSize				Size of firmware image byte stream
+ *	@param		PpsParsedImage				Parsed firmware image (see FirmwareUpdate_ParseImage)
  *	@param		PpfValid					TRUE in case the image is valid, FALSE otherwise.
  *	@param		PpbfNewTpmFirmwareInfo		Pointer to a bit field to return info data for the new firmware image.
  *	@param		PpunErrorDetails			Pointer to an unsigned int to return error details. Possible values are:\n
@@ -1620,8 +2117,7 @@ FirmwareUpdate_GetImageInfo(
 _Check_return_
 unsigned int
 FirmwareUpdate_CheckImage(
-	_In_bytecount_(PullImageSize)	BYTE*							PrgbImage,
-	_In_							UINT64							PullImageSize,
+	_Inout_							IfxParsedFirmwareImage*			PpsParsedImage,
 	_Out_							BOOL*							PpfValid,
 	_Out_							BITFIELD_NEW_TPM_FIRMWARE_INFO*	PpbfNewTpmFirmwareInfo,
 	_Out_							UINT32*							PpunErrorDetails)
@@ -1631,19 +2127,15 @@ FirmwareUpdate_CheckImage(
 	do
 	{
 		TPM_STATE sTpmState = {{0}};
-		IfxFirmwareImage sIfxFirmwareImage = {{0}};
-		INT32 nBufferSize = (INT32)PullImageSize;
-		BYTE* pbBuffer = PrgbImage;
 
 		// Check parameters
-		if (NULL == PrgbImage ||
-				0 == PullImageSize ||
+		if (NULL == PpsParsedImage ||
 				NULL == PpfValid ||
 				NULL == PpbfNewTpmFirmwareInfo ||
 				NULL == PpunErrorDetails)
 		{
 			unReturnValue = RC_E_BAD_PARAMETER;
-			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PrgbImage or PpfValid or PpbfNewTpmFirmwareInfo is NULL or PullImageSize is zero)");
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PpsParsedImage or PpfValid or PpbfNewTpmFirmwareInfo or PpunErrorDetails is NULL)");
 			break;
 		}
 
@@ -1685,9 +2177,8 @@ FirmwareUpdate_CheckImage(
 			break;
 		}
 
-		// Unmarshal the firmware image structure
-		unReturnValue = FirmwareImage_Unmarshal(&sIfxFirmwareImage, &pbBuffer, &nBufferSize);
-		if (RC_SUCCESS != unReturnValue)
+		// The firmware image structure could not be unmarshalled
+		if (!PpsParsedImage->fParsed)
 		{
 			unReturnValue = RC_SUCCESS;
 			*PpunErrorDetails = RC_E_CORRUPT_FW_IMAGE;
@@ -1695,8 +2186,7 @@ FirmwareUpdate_CheckImage(
 		}
 
 		// Check if update is possible
-		nBufferSize = (INT32)PullImageSize;
-		unReturnValue = FirmwareUpdate_IsFirmwareUpdatable(sTpmState.attribs, PrgbImage, nBufferSize, &sIfxFirmwareImage, PpfValid, PpbfNewTpmFirmwareInfo, PpunErrorDetails);
+		unReturnValue = FirmwareUpdate_IsFirmwareUpdatable(sTpmState.attribs, PpsParsedImage, PpfValid, PpbfNewTpmFirmwareInfo, PpunErrorDetails);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
@@ -1726,6 +2216,7 @@ FirmwareUpdate_PrepareTPM20Policy(
 	_Out_ TPMI_SH_AUTH_SESSION* PphPolicySession)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned long long ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
 	TPMI_SH_AUTH_SESSION hPolicySession = 0;
 	*PphPolicySession = 0;
 
@@ -1840,6 +2331,8 @@ FirmwareUpdate_PrepareTPM20Policy(
 	if (RC_SUCCESS != unReturnValue && 0 != hPolicySession)
 		IGNORE_RETURN_VALUE(TSS_TPM2_FlushContext(hPolicySession));
 
+	Timing_RecordPhase(TIMING_PHASE_PREPARE_POLICY, ullStartUs);
+
 	return unReturnValue;
 }
 
@@ -1848,7 +2341,7 @@ FirmwareUpdate_PrepareTPM20Policy(
  *	@details	This function initiates TPM Firmware Update via the TPM_FieldUpgrade_Start command depending on the current TPM Operation mode.
  *
  *	@param		PbfTpmAttributes		The current TPM operation mode
- *	@param		PpsIfxFirmwareImage		Pointer to structure containing the firmware image
+ *	@param		PpsParsedImage			Pointer to the parsed firmware image
  *	@param		PpsFirmwareUpdateData	Pointer to structure containing all relevant data for a firmware update
  *
  *	@retval		RC_SUCCESS						The operation completed successfully.
@@ -1861,7 +2354,7 @@ _Check_return_
 unsigned int
 FirmwareUpdate_Start(
 	_In_	BITFIELD_TPM_ATTRIBUTES				PbfTpmAttributes,
-	_In_	const IfxFirmwareImage* const		PpsIfxFirmwareImage,
+	_In_	const IfxParsedFirmwareImage* const	PpsParsedImage,
 	_In_	const IfxFirmwareUpdateData* const	PpsFirmwareUpdateData)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
@@ -1871,8 +2364,7 @@ FirmwareUpdate_Start(
 	if (PbfTpmAttributes.tpm20 && PbfTpmAttributes.infineon && !PbfTpmAttributes.tpm20restartRequired)
 	{
 		unReturnValue = FirmwareUpdate_Start_Tpm20(
-							PpsIfxFirmwareImage->rgbPolicyParameterBlock,
-							PpsIfxFirmwareImage->usPolicyParameterBlockSize,
+							&PpsParsedImage->sSignedData,
 							PpsFirmwareUpdateData->unSessionHandle,
 							PpsFirmwareUpdateData->fnProgressCallback);
 		fUpdateStarted = RC_SUCCESS == unReturnValue ? TRUE : FALSE;
@@ -1890,8 +2382,8 @@ FirmwareUpdate_Start(
 			{
 				unReturnValue = FirmwareUpdate_Start_Tpm12(
 									PbfTpmAttributes,
-									PpsIfxFirmwareImage->rgbPolicyParameterBlock,
-									PpsIfxFirmwareImage->usPolicyParameterBlockSize,
+									PpsParsedImage->sHeader.rgbPolicyParameterBlock,
+									PpsParsedImage->sHeader.usPolicyParameterBlockSize,
 									PpsFirmwareUpdateData->rgbOwnerAuthHash,
 									PpsFirmwareUpdateData->fnProgressCallback);
 				fUpdateStarted = RC_SUCCESS == unReturnValue ? TRUE : FALSE;
@@ -1908,8 +2400,8 @@ FirmwareUpdate_Start(
 			{
 				unReturnValue = FirmwareUpdate_Start_Tpm12(
 									PbfTpmAttributes,
-									PpsIfxFirmwareImage->rgbPolicyParameterBlock,
-									PpsIfxFirmwareImage->usPolicyParameterBlockSize,
+									PpsParsedImage->sHeader.rgbPolicyParameterBlock,
+									PpsParsedImage->sHeader.usPolicyParameterBlockSize,
 									PpsFirmwareUpdateData->rgbOwnerAuthHash,
 									PpsFirmwareUpdateData->fnProgressCallback);
 				fUpdateStarted = RC_SUCCESS == unReturnValue ? TRUE : FALSE;
@@ -1961,9 +2453,7 @@ FirmwareUpdate_UpdateImage(
 	do
 	{
 		TPM_STATE sTpmState = {{0}};
-		IfxFirmwareImage sIfxFirmwareImage = {{0}};
-		INT32 nBufferSize = (INT32)PpsFirmwareUpdateData->unFirmwareImageSize;
-		BYTE* pbBuffer = PpsFirmwareUpdateData->rgbFirmwareImage;
+		const IfxParsedFirmwareImage* pParsedImage = PpsFirmwareUpdateData->pParsedImage;
 
 		// Get TPM operation mode
 		unReturnValue = FirmwareUpdate_CalculateState(&sTpmState);
@@ -1978,23 +2468,22 @@ FirmwareUpdate_UpdateImage(
 			break;
 		}
 
-		// Unmarshal the firmware image structure
-		unReturnValue = FirmwareImage_Unmarshal(&sIfxFirmwareImage, &pbBuffer, &nBufferSize);
-		if (RC_SUCCESS != unReturnValue)
+		// The firmware image structure must have been unmarshalled by FirmwareUpdate_ParseImage
+		if (NULL == pParsedImage || !pParsedImage->fParsed)
 		{
-			ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"Firmware image cannot be parsed. (0x%.8x)");
+			ERROR_STORE(RC_E_CORRUPT_FW_IMAGE, L"Firmware image cannot be parsed.");
 			unReturnValue = RC_E_CORRUPT_FW_IMAGE;
 			break;
 		}
 
 		// Perform the firmware update
 		// Start the firmware update in order to get TPM in Boot Loader Mode
-		unReturnValue = FirmwareUpdate_Start(sTpmState.attribs, &sIfxFirmwareImage, PpsFirmwareUpdateData);
+		unReturnValue = FirmwareUpdate_Start(sTpmState.attribs, pParsedImage, PpsFirmwareUpdateData);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
 		// Transfer new firmware data to TPM
-		unReturnValue = FirmwareUpdate_Update(sIfxFirmwareImage.unFirmwareSize, sIfxFirmwareImage.rgbFirmware, PpsFirmwareUpdateData->fnProgressCallback);
+		unReturnValue = FirmwareUpdate_Update(pParsedImage->sHeader.unFirmwareSize, pParsedImage->sHeader.rgbFirmware, PpsFirmwareUpdateData->fnProgressCallback);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
@@ -16,6 +16,8 @@
 
 #include "StdInclude.h"
 #include "TPM2_Types.h"
+#include "FirmwareImage.h"
+#include "Crypt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -117,9 +119,18 @@ typedef void (*PFN_FIRMWAREUPDATE_UPDATESTARTEDCALLBACK)(
 /// This value indicates that the number of remaining firmware updates is unknown
 #define REMAINING_UPDATES_UNAVAILABLE (unsigned int)(-1)
 
+/**
+ *	@brief		Invalidates the TPM state cache
+ *	@details	Must be called after every command that changes the TPM state (e.g. FieldUpgradeStart, TakeOwnership, OwnerClear,
+ *				HierarchyChangeAuth or physical presence changes). The next query reads the state from the TPM again.
+ */
+void
+FirmwareUpdate_InvalidateTpmStateCache();
+
 /**
  *	@brief		Returns the TPM state attributes
- *	@details
+ *	@details	The TPM state is read from the TPM once per session and kept in the TPM state cache until
+ *				FirmwareUpdate_InvalidateTpmStateCache is called.
  *
  *	@param		PpsTpmState					Pointer to a variable representing the TPM state
  *
@@ -157,12 +168,127 @@ FirmwareUpdate_GetImageInfo(
 	_Inout_									TPM_STATE*					PpsTpmState,
 	_Inout_									unsigned int*				PpunRemainingUpdates);
 
+/// Cryptographic results of FirmwareUpdate_VerifyImage
+typedef struct tdIfxFirmwareImageVerification
+{
+	/// TRUE if fSignatureValid holds the result of the signature verification over sDigests
+	BOOL					fVerified;
+	/// TRUE if sDigests holds the digests of the image (calculated or taken from the verified-image cache)
+	BOOL					fDigestsKnown;
+	/// CRC and SHA-256 digests of the image
+	IfxCryptImageDigests	sDigests;
+	/// Result of the signature verification
+	BOOL					fSignatureValid;
+} IfxFirmwareImageVerification;
+
+/**
+ *	@brief		Parsed firmware image
+ *	@details	Created once per loaded firmware image by FirmwareUpdate_ParseImage and passed through the check, start and update
+ *				steps, so that the header and the policy parameter block are unmarshalled and the image is hashed only once.
+ */
+typedef struct tdIfxParsedFirmwareImage
+{
+	/// Firmware image byte stream (not owned by the structure)
+	BYTE*							rgbImage;
+	/// Size of the firmware image byte stream
+	UINT32							unImageSize;
+	/// TRUE if the header and the policy parameter block were parsed successfully, FALSE if the image is corrupt
+	BOOL							fParsed;
+	/// Unmarshalled firmware image header
+	IfxFirmwareImage				sHeader;
+	/// Unmarshalled policy parameter block
+	sSignedData_d					sSignedData;
+	/// Digests and signature verdict, filled in by the first FirmwareUpdate_VerifyImage call
+	IfxFirmwareImageVerification	sVerification;
+} IfxParsedFirmwareImage;
+
+/// Maximum number of firmware images checked by one FirmwareUpdate_VerifyImageBatch call
+#define FIRMWARE_UPDATE_VERIFY_BATCH_SIZE 16
+
+/// Firmware image to check with FirmwareUpdate_VerifyImageBatch and its result
+typedef struct tdIfxFirmwareImageCheck
+{
+	/// Parsed firmware image
+	IfxParsedFirmwareImage*	pParsedImage;
+	/// Return value of the check, see FirmwareUpdate_VerifyImage
+	unsigned int			unReturnValue;
+	/// Result of the check, see PpunErrorDetails of FirmwareUpdate_VerifyImage
+	UINT32					unErrorDetails;
+	/// Static description of the failed check or the unexpected error, NULL otherwise
+	const wchar_t*			pwszErrorMessage;
+} IfxFirmwareImageCheck;
+
+/**
+ *	@brief		Parses a firmware image
+ *	@details	Unmarshals the header and the policy parameter block of the firmware image. A firmware image that cannot be parsed
+ *				is not an error of the function: fParsed is FALSE in this case and the image is reported as corrupt by the checks.
+ *
+ *	@param		PrgbImage					Firmware image byte stream; must stay valid as long as the parsed image is used
+ *	@param		PunImageSize				Size of firmware image byte stream
+ *	@param		PpsParsedImage				Receives the parsed firmware image
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully. Check fParsed for the result.
+ *	@retval		RC_E_BAD_PARAMETER			An invalid parameter was passed to the function.
+ *	@retval		...							Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FirmwareUpdate_ParseImage(
+	_In_bytecount_(PunImageSize)	BYTE*					PrgbImage,
+	_In_							UINT32					PunImageSize,
+	_Out_							IfxParsedFirmwareImage*	PpsParsedImage);
+
+/**
+ *	@brief		Function to check the integrity of a firmware image without accessing the TPM
+ *	@details	Checks GUID, location of the firmware block, CRC, structure version, signature key ID, signature, TPM families
+ *				and the firmware digest in the policy parameter block. The function neither accesses the TPM nor the error stack,
+ *				the log or the verified-image cache, so it can be called for several images in parallel.
+ *
+ *	@param		PpsParsedImage				Pointer to the parsed firmware image. The digests in sVerification are calculated only if
+ *											fDigestsKnown is FALSE (e.g. no earlier call and no verified-image cache hit), the signature
+ *											is verified only if fVerified is FALSE (i.e. no earlier call for this parsed image).
+ *	@param		PpunErrorDetails			Pointer to an unsigned int to return the result. Possible values are:\n
+ *												RC_SUCCESS in case the firmware image is intact.\n
+ *												RC_E_CORRUPT_FW_IMAGE in case the firmware image is corrupt.\n
+ *												RC_E_NEWER_TOOL_REQUIRED in case a newer version of the tool is required to parse the firmware image.
+ *	@param		PppwszErrorMessage			Receives a static description of the failed check or the unexpected error, NULL otherwise.
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully. PpunErrorDetails contains the result.
+ *	@retval		RC_E_BAD_PARAMETER			In case of a NULL input parameter
+ *	@retval		...							Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FirmwareUpdate_VerifyImage(
+	_Inout_	IfxParsedFirmwareImage*	PpsParsedImage,
+	_Out_	UINT32*					PpunErrorDetails,
+	_Out_	const wchar_t**			PppwszErrorMessage);
+
+/**
+ *	@brief		Function to check the integrity of several firmware images without accessing the TPM
+ *	@details	Runs the checks of FirmwareUpdate_VerifyImage for each image. The signatures of all images which reach the
+ *				signature verification are verified together with Crypt_VerifySignatureBatch, so the public key is looked up
+ *				and the verification context is set up only once for the batch. Like FirmwareUpdate_VerifyImage, the function
+ *				neither accesses the TPM nor the error stack, the log or the verified-image cache.
+ *
+ *	@param		PrgsImageChecks				Images to check. Receive the return value, the result and the error message of
+ *											FirmwareUpdate_VerifyImage for the respective image.
+ *	@param		PunCount					Number of entries in PrgsImageChecks, at most FIRMWARE_UPDATE_VERIFY_BATCH_SIZE
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully. Check the results of the individual images.
+ *	@retval		RC_E_BAD_PARAMETER			In case of a NULL input parameter or an invalid number of images
+ */
+_Check_return_
+unsigned int
+FirmwareUpdate_VerifyImageBatch(
+	_Inout_	IfxFirmwareImageCheck*	PrgsImageChecks,
+	_In_	UINT32					PunCount);
+
 /**
  *	@brief		Checks if the firmware image is valid for the TPM
  *	@details	Performs integrity, consistency and content checks to determine if the given firmware image can be applied to the installed TPM.
  *
- *	@param		PrgbImage					Firmware image byte stream
- *	@param		PullImageSize				Size of firmware image byte stream
+ *	@param		PpsParsedImage				Parsed firmware image (see FirmwareUpdate_ParseImage)
  *	@param		PpfValid					TRUE in case the image is valid, FALSE otherwise.
  *	@param		PpbfNewTpmFirmwareInfo		Pointer to a bit field to return info data for the new firmware image.
  *	@param		PpunErrorDetails			Pointer to an unsigned int to return error details. Possible values are:\n
@@ -183,8 +309,7 @@ FirmwareUpdate_GetImageInfo(
 _Check_return_
 unsigned int
 FirmwareUpdate_CheckImage(
-	_In_bytecount_(PullImageSize)	BYTE*							PrgbImage,
-	_In_							UINT64							PullImageSize,
+	_Inout_							IfxParsedFirmwareImage*			PpsParsedImage,
 	_Out_							BOOL*							PpfValid,
 	_Out_							BITFIELD_NEW_TPM_FIRMWARE_INFO*	PpbfNewTpmFirmwareInfo,
 	_Out_							UINT32*							PpunErrorDetails);
@@ -195,10 +320,8 @@ FirmwareUpdate_CheckImage(
  */
 typedef struct tdIfxFirmwareUpdateData
 {
-	/// Firmware image size
-	UINT32 unFirmwareImageSize;
-	/// Pointer to a Firmware image
-	BYTE* rgbFirmwareImage;
+	/// Parsed firmware image (see FirmwareUpdate_ParseImage)
+	const IfxParsedFirmwareImage* pParsedImage;
 	/// Progress call back function pointer
 	PFN_FIRMWAREUPDATE_PROGRESSCALLBACK fnProgressCallback;
 	/// Update started call back function pointer
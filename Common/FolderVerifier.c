@@ -0,0 +1,510 @@
+﻿/**
+ *	@brief		Implements the firmware folder verification
+ *	@details	Checks the integrity of all firmware images in a folder on a pool of worker threads without accessing the TPM
+ *	@file		FolderVerifier.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "FolderVerifier.h"
+#include "FirmwareUpdate.h"
+#include "FileIO.h"
+#include "Logging.h"
+#include "Platform.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+/// Maximum number of files in one folder
+#define FOLDER_VERIFIER_MAX_FILES		4096
+/// Number of files the file list grows by
+#define FOLDER_VERIFIER_FILES_INCREMENT	64
+
+/// A file of the firmware folder to be verified
+typedef struct tdIfxFolderVerifierFile
+{
+	/// Verification result
+	IfxFolderVerifierResult	sResult;
+	/// Read-only mapping of the file, NULL if the file is not a firmware image
+	BYTE*					rgbImage;
+	/// Parsed firmware image
+	IfxParsedFirmwareImage	sParsedImage;
+} IfxFolderVerifierFile;
+
+/// Context of the folder verification shared by the enumeration callback and the worker threads
+typedef struct tdIfxFolderVerifierContext
+{
+	/// Firmware folder
+	const wchar_t*			pwszFolder;
+	/// File list
+	IfxFolderVerifierFile*	rgsFiles;
+	/// Number of files in the list
+	unsigned int			unFileCount;
+	/// Capacity of the file list
+	unsigned int			unFileCapacity;
+	/// Index of the next file to be verified by a worker thread
+	atomic_uint				unNextFile;
+} IfxFolderVerifierContext;
+
+/**
+ *	@brief		Add a file of the firmware folder to the file list
+ *	@details	Callback for FileIO_EnumerateDirectory. Maps the file and parses the firmware image header. The verification
+ *				itself is left to the worker threads; files which are not firmware images get their result here.
+ *
+ *	@param		PwszFileName		Name of the file without the folder part
+ *	@param		PpvContext			IfxFolderVerifierContext context
+ *	@retval		RC_SUCCESS			The file was added.
+ *	@retval		RC_E_FAIL			Too many files or out of memory.
+ */
+_Check_return_
+static
+unsigned int
+FolderVerifier_AddFile(
+	_In_z_		const wchar_t*	PwszFileName,
+	_In_opt_	void*			PpvContext)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	IfxFolderVerifierContext* pContext = (IfxFolderVerifierContext*)PpvContext;
+
+	do
+	{
+		wchar_t wszFilePath[MAX_PATH] = {0};
+		unsigned int unFilePathSize = RG_LEN(wszFilePath);
+		unsigned int unFileNameSize = 0;
+		IfxFolderVerifierFile* pFile = NULL;
+		IfxErrorData* pErrorStack = NULL;
+
+		// Skip the catalog index and temporary files of an interrupted index update
+		if (0 == Platform_StringCompare(PwszFileName, FIRMWARE_CATALOG_FILE_NAME, RG_LEN(FIRMWARE_CATALOG_FILE_NAME) - 1, TRUE))
+			break;
+
+		// Grow the file list if required
+		if (pContext->unFileCount == pContext->unFileCapacity)
+		{
+			IfxFolderVerifierFile* rgsFiles = NULL;
+			unsigned int unFileCapacity = pContext->unFileCapacity + FOLDER_VERIFIER_FILES_INCREMENT;
+
+			if (unFileCapacity > FOLDER_VERIFIER_MAX_FILES)
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE_FMT(unReturnValue, L"The firmware folder contains more than %d files.", FOLDER_VERIFIER_MAX_FILES);
+				break;
+			}
+			rgsFiles = (IfxFolderVerifierFile*)Platform_MemoryAllocateZero(unFileCapacity * sizeof(IfxFolderVerifierFile));
+			if (NULL == rgsFiles)
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE(unReturnValue, L"Memory allocation failed.");
+				break;
+			}
+			if (0 != pContext->unFileCount)
+				IGNORE_RETURN_VALUE(Platform_MemoryCopy(rgsFiles, unFileCapacity * sizeof(IfxFolderVerifierFile), pContext->rgsFiles, pContext->unFileCount * sizeof(IfxFolderVerifierFile)));
+			Platform_MemoryFree((void**)&pContext->rgsFiles);
+			pContext->rgsFiles = rgsFiles;
+			pContext->unFileCapacity = unFileCapacity;
+		}
+		pFile = &pContext->rgsFiles[pContext->unFileCount];
+		pContext->unFileCount++;
+
+		// A file name which does not fit into the result is reported truncated
+		unFileNameSize = RG_LEN(pFile->sResult.wszFileName);
+		if (RC_SUCCESS != Platform_StringCopy(pFile->sResult.wszFileName, &unFileNameSize, PwszFileName))
+		{
+			IGNORE_RETURN_VALUE(Platform_MemoryCopy(pFile->sResult.wszFileName, sizeof(pFile->sResult.wszFileName), PwszFileName, sizeof(pFile->sResult.wszFileName) - sizeof(wchar_t)));
+			pFile->sResult.wszFileName[RG_LEN(pFile->sResult.wszFileName) - 1] = L'\0';
+		}
+
+		// Map the file
+		pFile->sResult.unResult = Platform_StringCopy(wszFilePath, &unFilePathSize, pContext->pwszFolder);
+		if (RC_SUCCESS == pFile->sResult.unResult)
+		{
+			unFilePathSize = RG_LEN(wszFilePath);
+			pFile->sResult.unResult = Platform_StringConcatenatePaths(wszFilePath, &unFilePathSize, PwszFileName);
+		}
+		if (RC_SUCCESS == pFile->sResult.unResult)
+			pFile->sResult.unResult = FileIO_MapFile(wszFilePath, &pFile->rgbImage, &pFile->sResult.unFileSize);
+		if (RC_SUCCESS != pFile->sResult.unResult)
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Folder verification: Cannot read '%ls' (0x%.8X).", PwszFileName, pFile->sResult.unResult);
+			pFile->sResult.pwszMessage = L"The file cannot be read";
+			break;
+		}
+
+		// Parse the firmware image header. A corrupt header is a result of the file, not an error of the verification,
+		// so remove error entries stored by the parser.
+		pErrorStack = Error_GetStack();
+		if (RC_SUCCESS != FirmwareUpdate_ParseImage(pFile->rgbImage, pFile->sResult.unFileSize, &pFile->sParsedImage) ||
+				!pFile->sParsedImage.fParsed)
+		{
+			while (NULL != Error_GetStack() && pErrorStack != Error_GetStack())
+				Error_ClearFirstItem();
+			LOGGING_WRITE_LEVEL2_FMT(L"Folder verification: '%ls' is not a firmware image.", PwszFileName);
+			IGNORE_RETURN_VALUE(FileIO_UnmapFile(&pFile->rgbImage, pFile->sResult.unFileSize));
+			pFile->sResult.unResult = RC_E_CORRUPT_FW_IMAGE;
+			pFile->sResult.pwszMessage = L"The file is not a firmware image file";
+			break;
+		}
+
+		pFile->sResult.fParsed = TRUE;
+		pFile->sResult.bSourceTpmFamily = pFile->sParsedImage.sHeader.bSourceTpmFamily;
+		pFile->sResult.bTargetTpmFamily = pFile->sParsedImage.sHeader.bTargetTpmFamily;
+		unFileNameSize = RG_LEN(pFile->sResult.wszTargetVersion);
+		IGNORE_RETURN_VALUE(Platform_StringCopy(pFile->sResult.wszTargetVersion, &unFileNameSize, pFile->sParsedImage.sHeader.wszTargetVersion));
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Worker thread of the folder verification
+ *	@details	Takes the next files from the list in batches of up to FIRMWARE_UPDATE_VERIFY_BATCH_SIZE until all files are
+ *				verified, so that the signatures of a batch are verified with a single key lookup and verification context.
+ *				Only FirmwareUpdate_VerifyImageBatch and the platform timer are called, neither the log nor the error stack
+ *				are accessed.
+ *
+ *	@param		PpContext		IfxFolderVerifierContext context
+ */
+static
+void
+FolderVerifier_Worker(
+	_In_ void* PpContext)
+{
+	IfxFolderVerifierContext* pContext = (IfxFolderVerifierContext*)PpContext;
+	unsigned int unFirst = 0;
+
+	while ((unFirst = atomic_fetch_add(&pContext->unNextFile, FIRMWARE_UPDATE_VERIFY_BATCH_SIZE)) < pContext->unFileCount)
+	{
+		IfxFirmwareImageCheck rgsImageChecks[FIRMWARE_UPDATE_VERIFY_BATCH_SIZE];
+		IfxFolderVerifierFile* rgpFiles[FIRMWARE_UPDATE_VERIFY_BATCH_SIZE];
+		unsigned int unCount = 0;
+		unsigned int unIndex = 0;
+		unsigned long long ullStart = 0;
+		unsigned long long ullDurationUs = 0;
+		unsigned int unReturnValue = RC_E_FAIL;
+
+		// Collect the firmware images of the batch
+		for (unIndex = unFirst; unIndex < unFirst + FIRMWARE_UPDATE_VERIFY_BATCH_SIZE && unIndex < pContext->unFileCount; unIndex++)
+		{
+			IfxFolderVerifierFile* pFile = &pContext->rgsFiles[unIndex];
+			if (!pFile->sResult.fParsed)
+				continue;
+			rgsImageChecks[unCount].pParsedImage = &pFile->sParsedImage;
+			rgsImageChecks[unCount].pwszErrorMessage = NULL;
+			rgpFiles[unCount] = pFile;
+			unCount++;
+		}
+		if (0 == unCount)
+			continue;
+
+		ullStart = Platform_GetMonotonicTimeMicroSeconds();
+		unReturnValue = FirmwareUpdate_VerifyImageBatch(rgsImageChecks, unCount);
+		ullDurationUs = (Platform_GetMonotonicTimeMicroSeconds() - ullStart) / unCount;
+		for (unIndex = 0; unIndex < unCount; unIndex++)
+		{
+			IfxFolderVerifierFile* pFile = rgpFiles[unIndex];
+			if (RC_SUCCESS != unReturnValue)
+				pFile->sResult.unResult = unReturnValue;
+			else if (RC_SUCCESS != rgsImageChecks[unIndex].unReturnValue)
+				pFile->sResult.unResult = rgsImageChecks[unIndex].unReturnValue;
+			else
+				pFile->sResult.unResult = rgsImageChecks[unIndex].unErrorDetails;
+			pFile->sResult.pwszMessage = rgsImageChecks[unIndex].pwszErrorMessage;
+			pFile->sResult.ullDurationUs = ullDurationUs;
+		}
+	}
+}
+
+/**
+ *	@brief		Compare two results by file name
+ *	@details	Comparison function for qsort.
+ *
+ *	@param		PpvResult1		First IfxFolderVerifierResult
+ *	@param		PpvResult2		Second IfxFolderVerifierResult
+ *	@returns	< 0, 0 or > 0 like wcscmp
+ */
+static
+int
+FolderVerifier_CompareResults(
+	_In_ const void* PpvResult1,
+	_In_ const void* PpvResult2)
+{
+	return Platform_StringCompare(
+				((const IfxFolderVerifierResult*)PpvResult1)->wszFileName,
+				((const IfxFolderVerifierResult*)PpvResult2)->wszFileName,
+				FIRMWARE_CATALOG_MAX_FILE_NAME,
+				FALSE);
+}
+
+/**
+ *	@brief		Verify all firmware images of a folder
+ *	@details	Parses the header of every file in the folder and checks the integrity of the firmware images with
+ *				FirmwareUpdate_VerifyImageBatch on a pool of worker threads. The TPM is not accessed. The results are sorted by file name.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PunThreadCount		Number of worker threads, 0 to use one thread per processor
+ *	@param		PprgsResults		Receives the results, must be freed with Platform_MemoryFree
+ *	@param		PpunResultCount		Receives the number of results
+ *	@param		PpunThreadCount		Receives the number of worker threads used
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully. Check the results of the individual files.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		RC_E_FILE_NOT_FOUND	The folder does not exist.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FolderVerifier_Verify(
+	_In_z_						const wchar_t*				PwszFolder,
+	_In_						unsigned int				PunThreadCount,
+	_Outptr_result_maybenull_	IfxFolderVerifierResult**	PprgsResults,
+	_Out_						unsigned int*				PpunResultCount,
+	_Out_						unsigned int*				PpunThreadCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	IfxFolderVerifierContext sContext = {0};
+	void* rgpThreads[FOLDER_VERIFIER_MAX_THREADS] = {NULL};
+	unsigned int unIndex = 0;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		IfxFolderVerifierResult* rgsResults = NULL;
+		unsigned int unThreadCount = 0;
+		unsigned int unStartedCount = 0;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFolder) || NULL == PprgsResults || NULL == PpunResultCount || NULL == PpunThreadCount)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Bad parameter detected.");
+			break;
+		}
+		*PprgsResults = NULL;
+		*PpunResultCount = 0;
+		*PpunThreadCount = 0;
+
+		// Collect the files and parse the firmware image headers
+		sContext.pwszFolder = PwszFolder;
+		atomic_init(&sContext.unNextFile, 0);
+		unReturnValue = FileIO_EnumerateDirectory(PwszFolder, FolderVerifier_AddFile, &sContext);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			if (RC_E_FILE_NOT_FOUND != unReturnValue)
+				ERROR_STORE_FMT(unReturnValue, L"FileIO_EnumerateDirectory failed for '%ls'.", PwszFolder);
+			break;
+		}
+
+		// Verify the firmware images on the worker threads
+		unThreadCount = 0 != PunThreadCount ? PunThreadCount : Platform_GetProcessorCount();
+		if (unThreadCount > FOLDER_VERIFIER_MAX_THREADS)
+			unThreadCount = FOLDER_VERIFIER_MAX_THREADS;
+		if (unThreadCount > sContext.unFileCount)
+			unThreadCount = sContext.unFileCount;
+		for (unIndex = 0; unIndex < unThreadCount; unIndex++)
+		{
+			if (RC_SUCCESS != Platform_ThreadCreate(FolderVerifier_Worker, &sContext, &rgpThreads[unStartedCount]))
+			{
+				LOGGING_WRITE_LEVEL1_FMT(L"Folder verification: Starting worker thread %d failed, continuing with %d worker threads.", unIndex + 1, unStartedCount);
+				break;
+			}
+			unStartedCount++;
+		}
+		// Verify on the calling thread if no worker thread could be started
+		if (0 == unStartedCount && 0 != sContext.unFileCount)
+		{
+			FolderVerifier_Worker(&sContext);
+			unStartedCount = 1;
+		}
+		for (unIndex = 0; unIndex < FOLDER_VERIFIER_MAX_THREADS; unIndex++)
+		{
+			if (NULL != rgpThreads[unIndex])
+				IGNORE_RETURN_VALUE(Platform_ThreadJoin(&rgpThreads[unIndex]));
+		}
+		LOGGING_WRITE_LEVEL3_FMT(L"Folder verification: Verified %d files of '%ls' with %d worker threads.", sContext.unFileCount, PwszFolder, unStartedCount);
+
+		// Return the results sorted by file name
+		if (0 != sContext.unFileCount)
+		{
+			rgsResults = (IfxFolderVerifierResult*)Platform_MemoryAllocateZero(sContext.unFileCount * sizeof(IfxFolderVerifierResult));
+			if (NULL == rgsResults)
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE(unReturnValue, L"Memory allocation failed.");
+				break;
+			}
+			for (unIndex = 0; unIndex < sContext.unFileCount; unIndex++)
+				rgsResults[unIndex] = sContext.rgsFiles[unIndex].sResult;
+			qsort(rgsResults, sContext.unFileCount, sizeof(IfxFolderVerifierResult), FolderVerifier_CompareResults);
+		}
+
+		*PprgsResults = rgsResults;
+		*PpunResultCount = sContext.unFileCount;
+		*PpunThreadCount = unStartedCount;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	// Release the mappings
+	for (unIndex = 0; unIndex < sContext.unFileCount; unIndex++)
+		IGNORE_RETURN_VALUE(FileIO_UnmapFile(&sContext.rgsFiles[unIndex].rgbImage, sContext.rgsFiles[unIndex].sResult.unFileSize));
+	Platform_MemoryFree((void**)&sContext.rgsFiles);
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Escape a string for a JSON string value
+ *	@details	Escapes quotation marks, backslashes and control characters. The string is truncated if the escaped
+ *				string does not fit into the destination.
+ *
+ *	@param		PwszSource			String to escape
+ *	@param		PwszDestination		Receives the escaped string
+ *	@param		PunCapacity			Capacity of PwszDestination in wide characters including zero termination
+ */
+static
+void
+FolderVerifier_EscapeJson(
+	_In_z_							const wchar_t*	PwszSource,
+	_Out_writes_z_(PunCapacity)		wchar_t*		PwszDestination,
+	_In_							unsigned int	PunCapacity)
+{
+	const wchar_t rgwcHex[] = L"0123456789ABCDEF";
+	unsigned int unLength = 0;
+
+	for (; L'\0' != *PwszSource; PwszSource++)
+	{
+		wchar_t wc = *PwszSource;
+		if (L'"' == wc || L'\\' == wc)
+		{
+			if (unLength + 2 >= PunCapacity)
+				break;
+			PwszDestination[unLength++] = L'\\';
+			PwszDestination[unLength++] = wc;
+		}
+		else if (wc < 0x20)
+		{
+			if (unLength + 6 >= PunCapacity)
+				break;
+			PwszDestination[unLength++] = L'\\';
+			PwszDestination[unLength++] = L'u';
+			PwszDestination[unLength++] = L'0';
+			PwszDestination[unLength++] = L'0';
+			PwszDestination[unLength++] = rgwcHex[(wc >> 4) & 0xF];
+			PwszDestination[unLength++] = rgwcHex[wc & 0xF];
+		}
+		else
+		{
+			if (unLength + 1 >= PunCapacity)
+				break;
+			PwszDestination[unLength++] = wc;
+		}
+	}
+	PwszDestination[unLength] = L'\0';
+}
+
+/**
+ *	@brief		Writes the results of FolderVerifier_Verify as JSON file
+ *	@details
+ *
+ *	@param		PwszFileName		Path of the JSON file. An existing file is overwritten.
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PrgsResults			Results of FolderVerifier_Verify
+ *	@param		PunResultCount		Number of results
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		...					Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FolderVerifier_WriteReport(
+	_In_z_							const wchar_t*					PwszFileName,
+	_In_z_							const wchar_t*					PwszFolder,
+	_In_opt_						const IfxFolderVerifierResult*	PrgsResults,
+	_In_							unsigned int					PunResultCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	void* pvFile = NULL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		wchar_t wszEscaped[MAX_PATH * 2] = {0};
+		unsigned int unIndex = 0;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFileName) || NULL == PwszFolder || (NULL == PrgsResults && 0 != PunResultCount))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PwszFileName, PwszFolder or PrgsResults)");
+			break;
+		}
+
+		unReturnValue = FileIO_Open(PwszFileName, &pvFile, FILE_WRITE);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			ERROR_STORE_FMT(unReturnValue, L"The verification report file (%ls) could not be created.", PwszFileName);
+			break;
+		}
+
+		FolderVerifier_EscapeJson(PwszFolder, wszEscaped, RG_LEN(wszEscaped));
+		unReturnValue = FileIO_WriteStringf(pvFile, L"{\n\t\"folder\": \"%ls\",\n\t\"images\": [", wszEscaped);
+		for (unIndex = 0; unIndex < PunResultCount && RC_SUCCESS == unReturnValue; unIndex++)
+		{
+			const IfxFolderVerifierResult* pResult = &PrgsResults[unIndex];
+			wchar_t wszMessage[MAX_PATH] = {0};
+
+			FolderVerifier_EscapeJson(pResult->wszFileName, wszEscaped, RG_LEN(wszEscaped));
+			if (NULL != pResult->pwszMessage)
+				FolderVerifier_EscapeJson(pResult->pwszMessage, wszMessage, RG_LEN(wszMessage));
+			unReturnValue = FileIO_WriteStringf(
+				pvFile,
+				L"%ls\n\t\t{\"file\": \"%ls\", \"size\": %u, \"valid\": %ls, \"result\": \"0x%.8X\", \"message\": \"%ls\"",
+				0 == unIndex ? L"" : L",",
+				wszEscaped,
+				pResult->unFileSize,
+				RC_SUCCESS == pResult->unResult ? L"true" : L"false",
+				pResult->unResult,
+				wszMessage);
+			if (RC_SUCCESS == unReturnValue && pResult->fParsed)
+			{
+				FolderVerifier_EscapeJson(pResult->wszTargetVersion, wszEscaped, RG_LEN(wszEscaped));
+				unReturnValue = FileIO_WriteStringf(
+					pvFile,
+					L", \"source_family\": \"%ls\", \"target_family\": \"%ls\", \"target_version\": \"%ls\", \"duration_us\": %llu",
+					DEVICE_TYPE_TPM_20 == pResult->bSourceTpmFamily ? L"2.0" : L"1.2",
+					DEVICE_TYPE_TPM_20 == pResult->bTargetTpmFamily ? L"2.0" : L"1.2",
+					wszEscaped,
+					pResult->ullDurationUs);
+			}
+			if (RC_SUCCESS == unReturnValue)
+				unReturnValue = FileIO_WriteString(pvFile, L"}");
+		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = FileIO_WriteString(pvFile, L"\n\t]\n}\n");
+	}
+	WHILE_FALSE_END;
+
+	if (NULL != pvFile)
+	{
+		unsigned int unCloseReturnValue = FileIO_Close(&pvFile);
+		if (RC_SUCCESS == unReturnValue)
+			unReturnValue = unCloseReturnValue;
+	}
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
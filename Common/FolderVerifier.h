@@ -0,0 +1,98 @@
+﻿/**
+ *	@brief		Declares the firmware folder verification
+ *	@details	Checks the integrity of all firmware images in a folder in parallel without accessing the TPM
+ *	@file		FolderVerifier.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+#include "FirmwareCatalog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Maximum number of worker threads used by FolderVerifier_Verify
+#define FOLDER_VERIFIER_MAX_THREADS		64
+
+/// Verification result of one file of a firmware folder
+typedef struct tdIfxFolderVerifierResult
+{
+	/// File name without the folder part
+	wchar_t			wszFileName[FIRMWARE_CATALOG_MAX_FILE_NAME];
+	/// Size of the file in bytes
+	unsigned int	unFileSize;
+	/// TRUE if the file header could be parsed as a firmware image
+	BOOL			fParsed;
+	/// Source TPM family of the firmware image
+	BYTE			bSourceTpmFamily;
+	/// Target TPM family of the firmware image
+	BYTE			bTargetTpmFamily;
+	/// Target version of the firmware image
+	wchar_t			wszTargetVersion[FIRMWARE_CATALOG_MAX_VERSION];
+	/// RC_SUCCESS if the image is intact, RC_E_CORRUPT_FW_IMAGE, RC_E_NEWER_TOOL_REQUIRED or the code of an unexpected error otherwise
+	unsigned int	unResult;
+	/// Static description of the failed check, NULL if the image is intact
+	const wchar_t*	pwszMessage;
+	/// Duration of the verification in microseconds, the average over the images verified in the same batch
+	unsigned long long ullDurationUs;
+} IfxFolderVerifierResult;
+
+/**
+ *	@brief		Verify all firmware images of a folder
+ *	@details	Parses the header of every file in the folder and checks the integrity of the firmware images with
+ *				FirmwareUpdate_VerifyImageBatch on a pool of worker threads. The TPM is not accessed. The results are sorted by file name.
+ *
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PunThreadCount		Number of worker threads, 0 to use one thread per processor
+ *	@param		PprgsResults		Receives the results, must be freed with Platform_MemoryFree
+ *	@param		PpunResultCount		Receives the number of results
+ *	@param		PpunThreadCount		Receives the number of worker threads used
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully. Check the results of the individual files.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		RC_E_FILE_NOT_FOUND	The folder does not exist.
+ *	@retval		RC_E_FAIL			An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+FolderVerifier_Verify(
+	_In_z_						const wchar_t*				PwszFolder,
+	_In_						unsigned int				PunThreadCount,
+	_Outptr_result_maybenull_	IfxFolderVerifierResult**	PprgsResults,
+	_Out_						unsigned int*				PpunResultCount,
+	_Out_						unsigned int*				PpunThreadCount);
+
+/**
+ *	@brief		Writes the results of FolderVerifier_Verify as JSON file
+ *	@details
+ *
+ *	@param		PwszFileName		Path of the JSON file. An existing file is overwritten.
+ *	@param		PwszFolder			Firmware folder
+ *	@param		PrgsResults			Results of FolderVerifier_Verify
+ *	@param		PunResultCount		Number of results
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		...					Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+FolderVerifier_WriteReport(
+	_In_z_							const wchar_t*					PwszFileName,
+	_In_z_							const wchar_t*					PwszFolder,
+	_In_opt_						const IfxFolderVerifierResult*	PrgsResults,
+	_In_							unsigned int					PunResultCount);
+
+#ifdef __cplusplus
+}
+#endif
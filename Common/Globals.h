@@ -41,6 +41,10 @@
 #define TPM_DEVICE_ACCESS_MEMORY_BASED 1
 /// TPM device access through device driver (for example /dev/tpm0, etc.)
 #define TPM_DEVICE_ACCESS_DRIVER 3
+/// TPM device access through the in-process TPM simulator
+#define TPM_DEVICE_ACCESS_SIMULATOR 4
+/// TPM device access through the TIS registers of the in-process TPM simulator
+#define TPM_DEVICE_ACCESS_SIMULATOR_TIS 5
 /// TPM DEVICE_ACCESS_PATH
 #define TPM_DEVICE_ACCESS_PATH L"/dev/tpm0"
 /// Define for TPM device access mode property string
@@ -111,12 +115,6 @@ typedef unsigned long	DWORD;
 // ------------ Defines for TIS communication ---------------
 /// Maximum number of retries in case of reading errors
 #define MAX_TPM_READ_RETRIES		3
-/// This is the generic time value to sleep between retries in micro seconds
-#define SLEEP_TIME_US				100
-/// This is the time value to sleep between TIS_GetBurstCount() retries in micro seconds
-#define SLEEP_TIME_US_BURSTCOUNT	10
-/// This is the time value to sleep between TIS_IsActiveLocality() retries in micro seconds
-#define SLEEP_TIME_US_CR			10
 /// Default memory address base for TPM device
 #define TPM_DEFAULT_MEM_BASE		0xFED40000U
 /// Default memory address size for TPM device
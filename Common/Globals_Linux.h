@@ -43,6 +43,7 @@
 
 #define _Out_
 #define _Out_bytecap_(x)
+#define _Out_opt_
 #define _Out_opt_bytecap_(x)
 #define _Out_opt_bytecapcount_(x)
 #define _Out_writes_bytes_all_(x)
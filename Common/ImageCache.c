@@ -0,0 +1,538 @@
+﻿/**
+ *	@brief		Implements the verified-image cache
+ *	@details	Keeps the SHA-256 digests of verified firmware images in an authenticated cache file which is replaced atomically
+ *	@file		ImageCache.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ImageCache.h"
+#include "FileIO.h"
+#include "Logging.h"
+#include "Platform.h"
+#include "PropertyStorage.h"
+
+/// Magic value at the start of the cache file ("IFXC")
+#define IMAGE_CACHE_MAGIC			0x43584649
+/// Version of the cache file format
+#define IMAGE_CACHE_VERSION			2
+/// Maximum number of entries kept in the cache file. The oldest entry is dropped first.
+#define IMAGE_CACHE_MAX_ENTRIES		256
+/// Size of the first and the last block of the image covered by the fast hash
+#define IMAGE_CACHE_FAST_HASH_BLOCK	4096
+/// Suffix of the key file next to the cache file. The key file also serves as lock file for the cache file.
+#define IMAGE_CACHE_KEY_SUFFIX		L".key"
+
+/// Header of the cache file
+typedef struct tdIfxImageCacheFileHeader
+{
+	/// IMAGE_CACHE_MAGIC
+	UINT32 unMagic;
+	/// IMAGE_CACHE_VERSION
+	UINT32 unVersion;
+	/// Size of one entry in bytes
+	UINT32 unEntrySize;
+	/// Number of entries following the header
+	UINT32 unEntryCount;
+} IfxImageCacheFileHeader;
+
+/// Cache key identifying an image file
+typedef struct tdIfxImageCacheKey
+{
+	/// Identity of the image file
+	IfxFileIdentity sIdentity;
+	/// CRC over the first block of the image
+	UINT32 unHeadCrc;
+	/// CRC over the last block of the image
+	UINT32 unTailCrc;
+} IfxImageCacheKey;
+
+/// Firmware image header fields kept in a cache entry
+typedef struct tdIfxImageCacheMetadata
+{
+	/// Source TPM family
+	UINT8 bSourceTpmFamily;
+	/// Target TPM family
+	UINT8 bTargetTpmFamily;
+	/// Structure version of the firmware image
+	UINT16 usImageStructureVersion;
+	/// Key identifier for signature
+	UINT16 usSignatureKeyId;
+	/// Size of the policy parameter block
+	UINT16 usPolicyParameterBlockSize;
+	/// Size of the firmware block
+	UINT32 unFirmwareSize;
+	/// Checksum stored in the firmware image
+	UINT32 unChecksum;
+	/// Offset of the firmware block within the image
+	UINT32 unFirmwareOffset;
+} IfxImageCacheMetadata;
+
+/// Entry of the cache file
+typedef struct tdIfxImageCacheEntry
+{
+	/// Cache key
+	IfxImageCacheKey sKey;
+	/// Parsed header of the image
+	IfxImageCacheMetadata sMetadata;
+	/// Digests calculated over the image
+	IfxCryptImageDigests sDigests;
+	/// HMAC over all preceding fields of the entry, keyed with the content of the key file
+	BYTE rgbEntryHmac[SHA1_DIGEST_SIZE];
+} IfxImageCacheEntry;
+
+/// State of the registered image
+typedef struct tdIfxImageCacheState
+{
+	/// Whether an image is registered
+	BOOL fRegistered;
+	/// Whether a cache entry matched the key of the registered image
+	BOOL fFound;
+	/// Cache file name
+	wchar_t wszCachePath[MAX_PATH];
+	/// Key file name
+	wchar_t wszKeyPath[MAX_PATH];
+	/// Registered image content
+	const BYTE* pbImage;
+	/// Size of the registered image content
+	UINT32 unImageSize;
+	/// Cache key of the registered image
+	IfxImageCacheKey sKey;
+	/// Matching cache entry
+	IfxImageCacheEntry sEntry;
+} IfxImageCacheState;
+
+/// State of the registered image
+static IfxImageCacheState s_sImageCache;
+
+/**
+ *	@brief		Calculate the HMAC of a cache entry
+ *	@details	Covers all fields in front of rgbEntryHmac.
+ *
+ *	@param		PpsEntry			Cache entry
+ *	@param		PrgbKey				HMAC key
+ *	@param		PrgbHmac			Receives the HMAC of the entry
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		...					Error codes from Crypt_HMAC
+ */
+_Check_return_
+static
+unsigned int
+ImageCache_EntryHmac(
+	_In_								const IfxImageCacheEntry*	PpsEntry,
+	_In_bytecount_(SHA1_DIGEST_SIZE)	const BYTE					PrgbKey[SHA1_DIGEST_SIZE],
+	_Out_bytecap_(SHA1_DIGEST_SIZE)		BYTE						PrgbHmac[SHA1_DIGEST_SIZE])
+{
+	return Crypt_HMAC((const BYTE*)PpsEntry, (UINT16)offsetof(IfxImageCacheEntry, rgbEntryHmac), PrgbKey, PrgbHmac);
+}
+
+/**
+ *	@brief		Open and lock the key file of the cache and read the HMAC key
+ *	@details	A new random key is generated if the key file is empty, i.e. has just been created. The key file must be
+ *				private to the effective user. The lock is held until the returned handle is closed with FileIO_Close.
+ *
+ *	@param		PppvKeyFile			Receives the handle of the locked key file
+ *	@param		PrgbKey				Receives the HMAC key
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_ACCESS_DENIED	The key file is not private to the effective user.
+ *	@retval		RC_E_FAIL			The key file has an unexpected size or an unexpected error occurred.
+ *	@retval		...					Error codes from FileIO and Crypt functions
+ */
+_Check_return_
+static
+unsigned int
+ImageCache_OpenKeyFile(
+	_Out_								void**	PppvKeyFile,
+	_Out_bytecap_(SHA1_DIGEST_SIZE)		BYTE	PrgbKey[SHA1_DIGEST_SIZE])
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	BYTE* rgbKeyFile = NULL;
+
+	do
+	{
+		unsigned long long ullKeyFileSize = 0;
+		unsigned int unKeyFileSize = 0;
+
+		unReturnValue = FileIO_OpenLocked(s_sImageCache.wszKeyPath, PppvKeyFile);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = FileIO_GetFileSize(*PppvKeyFile, &ullKeyFileSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		if (0 == ullKeyFileSize)
+		{
+			// New key file, any cache file written with another key is ignored
+			unReturnValue = Crypt_GetRandom(SHA1_DIGEST_SIZE, PrgbKey);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+			unReturnValue = FileIO_WriteBuffer(*PppvKeyFile, PrgbKey, SHA1_DIGEST_SIZE);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+			unReturnValue = FileIO_Flush(*PppvKeyFile);
+			break;
+		}
+
+		unReturnValue = FileIO_ReadFileToBuffer(s_sImageCache.wszKeyPath, &rgbKeyFile, &unKeyFileSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		if (SHA1_DIGEST_SIZE != unKeyFileSize)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+		unReturnValue = Platform_MemoryCopy(PrgbKey, SHA1_DIGEST_SIZE, rgbKeyFile, SHA1_DIGEST_SIZE);
+	}
+	WHILE_FALSE_END;
+
+	if (RC_SUCCESS != unReturnValue && NULL != *PppvKeyFile)
+		IGNORE_RETURN_VALUE(FileIO_Close(PppvKeyFile));
+	Platform_MemoryFree((void**)&rgbKeyFile);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Fill the metadata of a cache entry from a parsed firmware image header
+ *	@details
+ *
+ *	@param		PrgbImage			Firmware image content
+ *	@param		PpsFirmwareImage	Parsed firmware image header
+ *	@param		PpsMetadata			Receives the metadata
+ */
+static
+void
+ImageCache_GetMetadata(
+	_In_	const BYTE*					PrgbImage,
+	_In_	const IfxFirmwareImage*		PpsFirmwareImage,
+	_Out_	IfxImageCacheMetadata*		PpsMetadata)
+{
+	IGNORE_RETURN_VALUE(Platform_MemorySet(PpsMetadata, 0, sizeof(IfxImageCacheMetadata)));
+	PpsMetadata->bSourceTpmFamily = PpsFirmwareImage->bSourceTpmFamily;
+	PpsMetadata->bTargetTpmFamily = PpsFirmwareImage->bTargetTpmFamily;
+	PpsMetadata->usImageStructureVersion = PpsFirmwareImage->usImageStructureVersion;
+	PpsMetadata->usSignatureKeyId = PpsFirmwareImage->usSignatureKeyId;
+	PpsMetadata->usPolicyParameterBlockSize = PpsFirmwareImage->usPolicyParameterBlockSize;
+	PpsMetadata->unFirmwareSize = PpsFirmwareImage->unFirmwareSize;
+	PpsMetadata->unChecksum = PpsFirmwareImage->unChecksum;
+	PpsMetadata->unFirmwareOffset = (UINT32)(PpsFirmwareImage->rgbFirmware - PrgbImage);
+}
+
+/**
+ *	@brief		Read the authenticated entries of the cache file
+ *	@details	A missing, outdated or corrupt cache file results in an empty list. Entries with a wrong HMAC are skipped.
+ *				The caller must hold the lock of the key file.
+ *
+ *	@param		PrgbKey				HMAC key
+ *	@param		PrgsEntries			Receives the entries; must have room for IMAGE_CACHE_MAX_ENTRIES entries
+ *	@param		PpunEntryCount		Receives the number of entries
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_ACCESS_DENIED	The cache file is not private to the effective user.
+ */
+_Check_return_
+static
+unsigned int
+ImageCache_ReadEntries(
+	_In_bytecount_(SHA1_DIGEST_SIZE)	const BYTE				PrgbKey[SHA1_DIGEST_SIZE],
+	_Out_								IfxImageCacheEntry*		PrgsEntries,
+	_Out_								unsigned int*			PpunEntryCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	BYTE* rgbFile = NULL;
+	unsigned int unFileSize = 0;
+
+	*PpunEntryCount = 0;
+
+	do
+	{
+		IfxImageCacheFileHeader sHeader = {0};
+		unsigned int unIndex = 0;
+
+		// Only trust a cache file which nobody else can have written
+		unReturnValue = FileIO_CheckPrivate(s_sImageCache.wszCachePath);
+		if (RC_E_ACCESS_DENIED == unReturnValue)
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Warning: Image cache: The cache file is not private to the user and is not used (%ls).", s_sImageCache.wszCachePath);
+			break;
+		}
+		unReturnValue = RC_SUCCESS;
+
+		if (!FileIO_Exists(s_sImageCache.wszCachePath))
+			break;
+		if (RC_SUCCESS != FileIO_ReadFileToBuffer(s_sImageCache.wszCachePath, &rgbFile, &unFileSize))
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Image cache: Cannot read the cache file (%ls).", s_sImageCache.wszCachePath);
+			break;
+		}
+		if (unFileSize < sizeof(sHeader))
+			break;
+
+		IGNORE_RETURN_VALUE(Platform_MemoryCopy(&sHeader, sizeof(sHeader), rgbFile, sizeof(sHeader)));
+		if (IMAGE_CACHE_MAGIC != sHeader.unMagic ||
+				IMAGE_CACHE_VERSION != sHeader.unVersion ||
+				sizeof(IfxImageCacheEntry) != sHeader.unEntrySize ||
+				sHeader.unEntryCount > IMAGE_CACHE_MAX_ENTRIES ||
+				unFileSize != sizeof(sHeader) + sHeader.unEntryCount * sizeof(IfxImageCacheEntry))
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Image cache: Ignoring the outdated or corrupt cache file (%ls).", s_sImageCache.wszCachePath);
+			break;
+		}
+
+		for (unIndex = 0; unIndex < sHeader.unEntryCount; unIndex++)
+		{
+			IfxImageCacheEntry* pEntry = &PrgsEntries[*PpunEntryCount];
+			BYTE rgbHmac[SHA1_DIGEST_SIZE] = {0};
+			IGNORE_RETURN_VALUE(Platform_MemoryCopy(pEntry, sizeof(IfxImageCacheEntry), rgbFile + sizeof(sHeader) + unIndex * sizeof(IfxImageCacheEntry), sizeof(IfxImageCacheEntry)));
+			if (RC_SUCCESS == ImageCache_EntryHmac(pEntry, PrgbKey, rgbHmac) &&
+					0 == Platform_MemoryCompare(rgbHmac, pEntry->rgbEntryHmac, sizeof(rgbHmac)))
+				(*PpunEntryCount)++;
+		}
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&rgbFile);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Register the firmware image file which is about to be checked
+ *	@details	Calculates the cache key of the file (device, inode, size, modification time and a CRC over the first and the
+ *				last block of the image) and looks it up in the cache file. The result is used by ImageCache_Lookup and
+ *				ImageCache_Store for the same image buffer. Does nothing if the cache is disabled or the cache or key file
+ *				is not private to the effective user.
+ *
+ *	@param		PwszFileName		Firmware image file name
+ *	@param		PrgbImage			Firmware image content
+ *	@param		PunImageSize		Size of the firmware image content in bytes
+ */
+void
+ImageCache_RegisterImage(
+	_In_z_							const wchar_t*	PwszFileName,
+	_In_bytecount_(PunImageSize)	const BYTE*		PrgbImage,
+	_In_							UINT32			PunImageSize)
+{
+	IfxImageCacheEntry* rgsEntries = NULL;
+	void* pvKeyFile = NULL;
+
+	IGNORE_RETURN_VALUE(Platform_MemorySet(&s_sImageCache, 0, sizeof(s_sImageCache)));
+
+	do
+	{
+		unsigned int unCachePathSize = RG_LEN(s_sImageCache.wszCachePath);
+		unsigned int unKeyPathSize = RG_LEN(s_sImageCache.wszKeyPath);
+		UINT32 unBlockSize = PunImageSize < IMAGE_CACHE_FAST_HASH_BLOCK ? PunImageSize : IMAGE_CACHE_FAST_HASH_BLOCK;
+		BYTE rgbKey[SHA1_DIGEST_SIZE] = {0};
+		unsigned int unEntryCount = 0;
+		unsigned int unIndex = 0;
+
+		// Check parameters and whether the cache is enabled
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFileName) || NULL == PrgbImage || 0 == PunImageSize)
+			break;
+		if (!PropertyStorage_GetValueByKey(PROPERTY_IMAGE_CACHE_PATH, s_sImageCache.wszCachePath, &unCachePathSize) ||
+				0 == unCachePathSize)
+			break;
+		if (RC_SUCCESS != Platform_StringCopy(s_sImageCache.wszKeyPath, &unKeyPathSize, s_sImageCache.wszCachePath))
+			break;
+		unKeyPathSize = RG_LEN(s_sImageCache.wszKeyPath);
+		if (RC_SUCCESS != Platform_StringConcatenate(s_sImageCache.wszKeyPath, &unKeyPathSize, IMAGE_CACHE_KEY_SUFFIX))
+			break;
+
+		// Calculate the cache key
+		if (RC_SUCCESS != FileIO_GetFileIdentity(PwszFileName, &s_sImageCache.sKey.sIdentity) ||
+				PunImageSize != s_sImageCache.sKey.sIdentity.ullSize ||
+				RC_SUCCESS != Crypt_CRC(PrgbImage, (int)unBlockSize, &s_sImageCache.sKey.unHeadCrc) ||
+				RC_SUCCESS != Crypt_CRC(PrgbImage + PunImageSize - unBlockSize, (int)unBlockSize, &s_sImageCache.sKey.unTailCrc))
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Image cache: Cannot identify the firmware image file (%ls).", PwszFileName);
+			break;
+		}
+
+		// Look up the key while holding the lock
+		rgsEntries = (IfxImageCacheEntry*)Platform_MemoryAllocateZero(IMAGE_CACHE_MAX_ENTRIES * sizeof(IfxImageCacheEntry));
+		if (NULL == rgsEntries)
+			break;
+		if (RC_SUCCESS != ImageCache_OpenKeyFile(&pvKeyFile, rgbKey))
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Warning: Image cache: The key file cannot be used (%ls).", s_sImageCache.wszKeyPath);
+			break;
+		}
+		if (RC_SUCCESS != ImageCache_ReadEntries(rgbKey, rgsEntries, &unEntryCount))
+			break;
+
+		s_sImageCache.pbImage = PrgbImage;
+		s_sImageCache.unImageSize = PunImageSize;
+		s_sImageCache.fRegistered = TRUE;
+		for (unIndex = 0; unIndex < unEntryCount; unIndex++)
+		{
+			if (0 == Platform_MemoryCompare(&rgsEntries[unIndex].sKey, &s_sImageCache.sKey, sizeof(IfxImageCacheKey)))
+			{
+				s_sImageCache.sEntry = rgsEntries[unIndex];
+				s_sImageCache.fFound = TRUE;
+				break;
+			}
+		}
+		LOGGING_WRITE_LEVEL2_FMT(L"Image cache: %ls for %ls.", s_sImageCache.fFound ? L"Hit" : L"Miss", PwszFileName);
+	}
+	WHILE_FALSE_END;
+
+	if (NULL != pvKeyFile)
+		IGNORE_RETURN_VALUE(FileIO_Close(&pvKeyFile));
+	Platform_MemoryFree((void**)&rgsEntries);
+}
+
+/**
+ *	@brief		Look up the digests of a firmware image
+ *	@details	Returns the cached digests if the image buffer was registered with ImageCache_RegisterImage, an authenticated
+ *				cache entry matched its key and the cached header matches the parsed header. The cache only saves hashing
+ *				the image, the caller must still verify the signature over the returned digests.
+ *
+ *	@param		PrgbImage			Firmware image content
+ *	@param		PunImageSize		Size of the firmware image content in bytes
+ *	@param		PpsFirmwareImage	Parsed firmware image header
+ *	@param		PpsDigests			Receives the cached digests
+ *
+ *	@retval		TRUE				Cache hit, the digests need not be calculated.
+ *	@retval		FALSE				Cache miss, the digests must be calculated over the image.
+ */
+BOOL
+ImageCache_Lookup(
+	_In_bytecount_(PunImageSize)	const BYTE*					PrgbImage,
+	_In_							UINT32						PunImageSize,
+	_In_							const IfxFirmwareImage*		PpsFirmwareImage,
+	_Out_							IfxCryptImageDigests*		PpsDigests)
+{
+	BOOL fHit = FALSE;
+
+	do
+	{
+		IfxImageCacheMetadata sMetadata = {0};
+
+		if (!s_sImageCache.fFound ||
+				PrgbImage != s_sImageCache.pbImage ||
+				PunImageSize != s_sImageCache.unImageSize ||
+				NULL == PpsFirmwareImage || NULL == PpsDigests)
+			break;
+
+		// The parsed header must match the cached one, otherwise calculate the digests again
+		ImageCache_GetMetadata(PrgbImage, PpsFirmwareImage, &sMetadata);
+		if (0 != Platform_MemoryCompare(&sMetadata, &s_sImageCache.sEntry.sMetadata, sizeof(sMetadata)))
+		{
+			LOGGING_WRITE_LEVEL2(L"Image cache: The cached header does not match the firmware image.");
+			break;
+		}
+
+		*PpsDigests = s_sImageCache.sEntry.sDigests;
+		fHit = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	return fHit;
+}
+
+/**
+ *	@brief		Store the digests of a firmware image
+ *	@details	Adds or replaces the cache entry of the registered image and rewrites the cache file atomically while holding
+ *				the lock of the key file. Entries written by concurrent runs in the meantime are merged. Only call this
+ *				function for images with a valid signature. Errors are logged and otherwise ignored.
+ *
+ *	@param		PrgbImage			Firmware image content
+ *	@param		PunImageSize		Size of the firmware image content in bytes
+ *	@param		PpsFirmwareImage	Parsed firmware image header
+ *	@param		PpsDigests			Digests calculated over the image
+ */
+void
+ImageCache_Store(
+	_In_bytecount_(PunImageSize)	const BYTE*					PrgbImage,
+	_In_							UINT32						PunImageSize,
+	_In_							const IfxFirmwareImage*		PpsFirmwareImage,
+	_In_							const IfxCryptImageDigests*	PpsDigests)
+{
+	BYTE* rgbFile = NULL;
+	void* pvKeyFile = NULL;
+
+	do
+	{
+		IfxImageCacheFileHeader* pHeader = NULL;
+		IfxImageCacheEntry* rgsEntries = NULL;
+		IfxImageCacheEntry sEntry;
+		BYTE rgbKey[SHA1_DIGEST_SIZE] = {0};
+		unsigned int unEntryCount = 0;
+		unsigned int unIndex = 0;
+		unsigned int unFileSize = sizeof(IfxImageCacheFileHeader) + IMAGE_CACHE_MAX_ENTRIES * sizeof(IfxImageCacheEntry);
+
+		if (!s_sImageCache.fRegistered ||
+				PrgbImage != s_sImageCache.pbImage ||
+				PunImageSize != s_sImageCache.unImageSize ||
+				NULL == PpsFirmwareImage || NULL == PpsDigests)
+			break;
+
+		rgbFile = (BYTE*)Platform_MemoryAllocateZero(unFileSize);
+		if (NULL == rgbFile)
+			break;
+
+		// Hold the lock from reading the current content until the new cache file is in place
+		if (RC_SUCCESS != ImageCache_OpenKeyFile(&pvKeyFile, rgbKey))
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Warning: Image cache: The key file cannot be used (%ls).", s_sImageCache.wszKeyPath);
+			break;
+		}
+
+		// Build the new entry. Clear it completely to get a reproducible entry HMAC over the padding bytes.
+		IGNORE_RETURN_VALUE(Platform_MemorySet(&sEntry, 0, sizeof(sEntry)));
+		sEntry.sKey = s_sImageCache.sKey;
+		ImageCache_GetMetadata(PrgbImage, PpsFirmwareImage, &sEntry.sMetadata);
+		sEntry.sDigests = *PpsDigests;
+		if (RC_SUCCESS != ImageCache_EntryHmac(&sEntry, rgbKey, sEntry.rgbEntryHmac))
+			break;
+
+		// Merge the entry into the current content of the cache file
+		pHeader = (IfxImageCacheFileHeader*)rgbFile;
+		rgsEntries = (IfxImageCacheEntry*)(rgbFile + sizeof(IfxImageCacheFileHeader));
+		if (RC_SUCCESS != ImageCache_ReadEntries(rgbKey, rgsEntries, &unEntryCount))
+			break;
+
+		// Drop an older entry of the same file (device and inode) or the oldest entry if the cache is full
+		for (unIndex = 0; unIndex < unEntryCount; unIndex++)
+		{
+			if (rgsEntries[unIndex].sKey.sIdentity.ullDevice == sEntry.sKey.sIdentity.ullDevice &&
+					rgsEntries[unIndex].sKey.sIdentity.ullInode == sEntry.sKey.sIdentity.ullInode)
+				break;
+		}
+		if (unIndex == unEntryCount && IMAGE_CACHE_MAX_ENTRIES == unEntryCount)
+			unIndex = 0;
+		if (unIndex < unEntryCount)
+		{
+			for (; unIndex + 1 < unEntryCount; unIndex++)
+				rgsEntries[unIndex] = rgsEntries[unIndex + 1];
+			unEntryCount--;
+		}
+		rgsEntries[unEntryCount++] = sEntry;
+
+		pHeader->unMagic = IMAGE_CACHE_MAGIC;
+		pHeader->unVersion = IMAGE_CACHE_VERSION;
+		pHeader->unEntrySize = sizeof(IfxImageCacheEntry);
+		pHeader->unEntryCount = unEntryCount;
+		unFileSize = sizeof(IfxImageCacheFileHeader) + unEntryCount * sizeof(IfxImageCacheEntry);
+
+		if (RC_SUCCESS != FileIO_WriteFileAtomic(s_sImageCache.wszCachePath, rgbFile, unFileSize, TRUE))
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Warning: Image cache: Cannot write the cache file (%ls).", s_sImageCache.wszCachePath);
+			break;
+		}
+
+		s_sImageCache.sEntry = sEntry;
+		s_sImageCache.fFound = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	if (NULL != pvKeyFile)
+		IGNORE_RETURN_VALUE(FileIO_Close(&pvKeyFile));
+	Platform_MemoryFree((void**)&rgbFile);
+}
@@ -0,0 +1,89 @@
+﻿/**
+ *	@brief		Declares the verified-image cache
+ *	@details	On-disk cache of firmware image digests keyed by file identity
+ *	@file		ImageCache.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+#include "FirmwareImage.h"
+#include "Crypt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Define for the verified-image cache file property. The cache is disabled if the property does not exist.
+/// The HMAC key of the cache entries is kept in a file with the suffix ".key" next to the cache file.
+#define PROPERTY_IMAGE_CACHE_PATH		L"ImageCachePath"
+
+/**
+ *	@brief		Register the firmware image file which is about to be checked
+ *	@details	Calculates the cache key of the file (device, inode, size, modification time and a CRC over the first and the
+ *				last block of the image) and looks it up in the cache file. The result is used by ImageCache_Lookup and
+ *				ImageCache_Store for the same image buffer. Does nothing if the cache is disabled or the cache or key file
+ *				is not private to the effective user.
+ *
+ *	@param		PwszFileName		Firmware image file name
+ *	@param		PrgbImage			Firmware image content
+ *	@param		PunImageSize		Size of the firmware image content in bytes
+ */
+void
+ImageCache_RegisterImage(
+	_In_z_							const wchar_t*	PwszFileName,
+	_In_bytecount_(PunImageSize)	const BYTE*		PrgbImage,
+	_In_							UINT32			PunImageSize);
+
+/**
+ *	@brief		Look up the digests of a firmware image
+ *	@details	Returns the cached digests if the image buffer was registered with ImageCache_RegisterImage, an authenticated
+ *				cache entry matched its key and the cached header matches the parsed header. The cache only saves hashing
+ *				the image, the caller must still verify the signature over the returned digests. This is a deliberate
+ *				trade-off: the RSA verification is cheap compared with hashing the image, and the HMAC of an entry only
+ *				proves that it was written with the local cache key, not that the digests were signed with the firmware key.
+ *
+ *	@param		PrgbImage			Firmware image content
+ *	@param		PunImageSize		Size of the firmware image content in bytes
+ *	@param		PpsFirmwareImage	Parsed firmware image header
+ *	@param		PpsDigests			Receives the cached digests
+ *
+ *	@retval		TRUE				Cache hit, the digests need not be calculated.
+ *	@retval		FALSE				Cache miss, the digests must be calculated over the image.
+ */
+BOOL
+ImageCache_Lookup(
+	_In_bytecount_(PunImageSize)	const BYTE*					PrgbImage,
+	_In_							UINT32						PunImageSize,
+	_In_							const IfxFirmwareImage*		PpsFirmwareImage,
+	_Out_							IfxCryptImageDigests*		PpsDigests);
+
+/**
+ *	@brief		Store the digests of a firmware image
+ *	@details	Adds or replaces the cache entry of the registered image and rewrites the cache file atomically while holding
+ *				the lock of the key file. Entries written by concurrent runs in the meantime are merged. Only call this
+ *				function for images with a valid signature. Errors are logged and otherwise ignored.
+ *
+ *	@param		PrgbImage			Firmware image content
+ *	@param		PunImageSize		Size of the firmware image content in bytes
+ *	@param		PpsFirmwareImage	Parsed firmware image header
+ *	@param		PpsDigests			Digests calculated over the image
+ */
+void
+ImageCache_Store(
+	_In_bytecount_(PunImageSize)	const BYTE*					PrgbImage,
+	_In_							UINT32						PunImageSize,
+	_In_							const IfxFirmwareImage*		PpsFirmwareImage,
+	_In_							const IfxCryptImageDigests*	PpsDigests);
+
+#ifdef __cplusplus
+}
+#endif
@@ -19,28 +19,231 @@
 #include "Platform.h"
 #include "Utility.h"
 
+#include <stdatomic.h>
+
+/// Asynchronous log record
+typedef struct tdIfxLoggingRecord
+{
+	/// Module name (string literal)
+	const char*		szModule;
+	/// Function name (string literal)
+	const char*		szFunction;
+	/// Configured logging level at the time the message has been logged
+	unsigned int	unLoggingLevel;
+	/// Logging level of the message
+	unsigned int	unMessageLevel;
+	/// Time the message has been logged at
+	IfxTime			sTime;
+	/// Flag indicating whether the record holds raw data to be written as hex dump
+	BOOL			fHexData;
+	/// Size of the message in elements including the zero termination, or size of the raw data in bytes
+	unsigned int	unSize;
+	/// Message or raw data
+	union
+	{
+		/// Formatted message
+		wchar_t		wszMessage[LOGGING_ASYNC_MESSAGE_SIZE];
+		/// Raw data
+		BYTE		rgbData[LOGGING_ASYNC_MESSAGE_SIZE * sizeof(wchar_t)];
+	} uData;
+} IfxLoggingRecord;
+
 /// Flag indicating whether to write a header into the log file or not
 BOOL g_fLogHeader = TRUE;
 
-/// Flag indicating whether logging is already ongoing
-BOOL s_fInLogging = FALSE;
+/// Configured logging level cached from PROPERTY_LOGGING_LEVEL, see Logging_UpdateLevel
+unsigned int g_unLoggingLevel = LOGGING_DISABLED;
+
+/// Flag indicating whether logging is already ongoing in the current thread
+_Thread_local BOOL s_fInLogging = FALSE;
+
+/// Handle of the log file, kept open until Logging_Close is called or the log file path changes
+static void* s_pLogFile = NULL;
+
+/// Path of the currently opened log file
+static wchar_t s_wszLogFilePath[MAX_STRING_1024] = {0};
+
+/// User-space buffer the log file is written through
+static BYTE s_rgbLogBuffer[LOGGING_BUFFER_SIZE];
+
+/// Flag indicating whether asynchronous logging is active
+static BOOL s_fAsyncLogging = FALSE;
+
+/// Flag indicating whether the current thread is the logging thread
+static _Thread_local BOOL s_fIsLoggingThread = FALSE;
+
+/// Ring buffer of log records passed from the logging caller to the logging thread
+static IfxLoggingRecord* s_rgsLogRing = NULL;
+
+/// Number of records in the ring buffer (a power of two)
+static unsigned int s_unLogRingSize = 0;
+
+/// Index of the next ring buffer record to be filled by the logging caller (only written by the logging caller)
+static atomic_uint s_unLogRingHead = 0;
+
+/// Index of the next ring buffer record to be written by the logging thread (only written by the logging thread)
+static atomic_uint s_unLogRingTail = 0;
+
+/// TRUE while the logging thread waits for records, so that only then the logging caller signals s_pLogCondition
+static atomic_bool s_fLogThreadWaiting = FALSE;
+
+/// Flag signaling the logging thread to write the remaining records and stop (protected by s_pLogCondition)
+static BOOL s_fLogThreadStop = FALSE;
+
+/// Condition the logging thread waits on while the ring buffer is empty and the logging caller waits on until it is empty
+static void* s_pLogCondition = NULL;
+
+/// Handle of the logging thread
+static void* s_pLogThread = NULL;
+
+/// Number of log records dropped because the ring buffer was full
+static unsigned int s_unLogRecordsDropped = 0;
+
+/**
+ *	@brief		This function formats a string and writes it to the log file
+ *	@details
+ *
+ *	@param		PwszFormat				Format string
+ *	@param		...						Parameters needed to format the string
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+static
+unsigned int
+Logging_WriteStringf(
+	_In_z_	const wchar_t*	PwszFormat,
+	...)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		wchar_t wszString[MAX_STRING_1024] = {0};
+		unsigned int unStringSize = RG_LEN(wszString);
+		va_list argptr;
+
+		va_start(argptr, PwszFormat);
+		unReturnValue = Platform_StringFormatV(wszString, &unStringSize, PwszFormat, argptr);
+		va_end(argptr);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = FileIO_WriteString(s_pLogFile, wszString);
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		This function opens the log file in the given mode and attaches the logging buffer to it
+ *	@details
+ *
+ *	@param		PwszLoggingFilePath		Path of the log file
+ *	@param		PunFileAccessMode		FILE_APPEND or FILE_WRITE
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+static
+unsigned int
+Logging_OpenFileInMode(
+	_In_z_	const wchar_t*	PwszLoggingFilePath,
+	_In_	unsigned int	PunFileAccessMode)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		unReturnValue = FileIO_Open(PwszLoggingFilePath, &s_pLogFile, PunFileAccessMode);
+		if (RC_SUCCESS != unReturnValue || NULL == s_pLogFile)
+			break;
+
+		// Must be done before any other operation on the file
+		unReturnValue = FileIO_SetBuffer(s_pLogFile, s_rgbLogBuffer, sizeof(s_rgbLogBuffer));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+	}
+	WHILE_FALSE_END;
+
+	// Do not keep a half initialized handle
+	if (RC_SUCCESS != unReturnValue && NULL != s_pLogFile)
+		IGNORE_RETURN_VALUE(FileIO_Close(&s_pLogFile));
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		This function checks the size of the open log file
+ *	@details	In case the log file has reached the maximum log file size the function reopens the file by using
+ *				override flag. Only called once per application run when the log file is opened, so the log of the
+ *				current run is never cut off.
+ *
+ *	@param		PunMaxFileSize			Maximum log file size in kilobytes (0 == unlimited)
+ *	@param		PpfFileExists			In: Flag if the log file exists\n
+ *										Out: FALSE if the log file has been overwritten
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+static
+unsigned int
+Logging_CheckFileSize(
+	_In_	unsigned int	PunMaxFileSize,
+	_Inout_	BOOL*			PpfFileExists)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+
+	do
+	{
+		unsigned long long ullFileSize = 0;
+
+		// Do actual size check only in case max log file size is not 0 (== unlimited)
+		if (0 == PunMaxFileSize)
+			break;
+
+		// Get file size of actual logging file
+		unReturnValue = FileIO_GetFileSize(s_pLogFile, &ullFileSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		// Check log file size limit and reopen file to overwrite it if necessary
+		if (PunMaxFileSize <= (unsigned int)(ullFileSize / DIV_KILOBYTE))
+		{
+			// Close log file (since it has been opened in append mode)
+			unReturnValue = FileIO_Close(&s_pLogFile);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			// Reopen it (now in write mode)
+			unReturnValue = Logging_OpenFileInMode(s_wszLogFilePath, FILE_WRITE);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			*PpfFileExists = FALSE;
+			g_fLogHeader = TRUE;
+		}
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
 
 /**
  *	@brief		This function writes the logging header to the log file, if it is the first call of the current instance.
  *	@details
  *
  *	@param		PfFileExists			Flag if the log file exists
- *	@param		PpFileHandle			Log file handle
  *	@retval		RC_SUCCESS				The operation completed successfully.
  *	@retval		RC_E_FAIL				An unexpected error occurred.
- *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. The parameter is NULL
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. The log file is not open
  *	@retval		...						Error codes from called functions.
  */
 _Check_return_
 unsigned int
 Logging_WriteHeader(
-	_In_	BOOL	PfFileExists,
-	_In_	void*	PpFileHandle)
+	_In_	BOOL	PfFileExists)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 
@@ -49,8 +252,8 @@ Logging_WriteHeader(
 		wchar_t wszTimeStamp[TIMESTAMP_LENGTH] = {0};
 		unsigned int unTimeStampSize = RG_LEN(wszTimeStamp);
 
-		// Check parameter
-		if (NULL == PpFileHandle)
+		// Check state
+		if (NULL == s_pLogFile)
 		{
 			unReturnValue = RC_E_BAD_PARAMETER;
 			break;
@@ -63,7 +266,7 @@ Logging_WriteHeader(
 			{
 				// In case of appending add new lines to make the restart of the tool more visible
 				// Needs \n\n as format string so it will be auto-converted to \r\n\r\n on UEFI.
-				unReturnValue = FileIO_WriteStringf(PpFileHandle, L"\n\n");
+				unReturnValue = Logging_WriteStringf(L"\n\n");
 				if (RC_SUCCESS != unReturnValue)
 					break;
 			}
@@ -74,7 +277,7 @@ Logging_WriteHeader(
 				break;
 
 			// Write header to log file
-			unReturnValue = FileIO_WriteStringf(PpFileHandle, L"%ls   %ls   Version %ls\n%ls\n\n", IFX_BRAND, TOOL_NAME, APP_VERSION, wszTimeStamp);
+			unReturnValue = Logging_WriteStringf(L"%ls   %ls   Version %ls\n%ls\n\n", IFX_BRAND, TOOL_NAME, APP_VERSION, wszTimeStamp);
 			if (RC_SUCCESS != unReturnValue)
 				break;
 
@@ -90,11 +293,12 @@ Logging_WriteHeader(
 
 /**
  *	@brief		This function opens the logging file
- *	@details	This function opens the logging file, by append an existing or create a new one.
- *				It also checks the file size, if the property storage flag PROPERTY_LOGGING_CHECK_SIZE is set.
- *				In case of the maximum file size is reached the function reopens the file by using override flag.
+ *	@details	This function opens the logging file, by append an existing or create a new one. The file stays open
+ *				for subsequent messages and is only reopened if PROPERTY_LOGGING_PATH changes.
+ *				If the property storage flag PROPERTY_LOGGING_CHECK_SIZE is set, the file size is checked against
+ *				PROPERTY_LOGGING_MAXSIZE and the function reopens the file by using override flag if it has been
+ *				reached. The flag is reset afterwards, so the check is done once per application run.
  *
- *	@param		PppFileHandle			Pointer to store the file handle to. Must be closed by caller in any case.
  *	@param		PpfFileExists			Pointer to store the file exists flag
  *	@retval		RC_SUCCESS				The operation completed successfully.
  *	@retval		RC_E_FAIL				An unexpected error occurred.
@@ -104,7 +308,6 @@ Logging_WriteHeader(
 _Check_return_
 unsigned int
 Logging_OpenFile(
-	_Inout_	void**	PppFileHandle,
 	_Out_	BOOL*	PpfFileExists)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
@@ -125,13 +328,6 @@ Logging_OpenFile(
 		// Set default
 		*PpfFileExists = FALSE;
 
-		// Check in/out parameter
-		if (NULL == PppFileHandle || NULL != *PppFileHandle)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-
 		// Get logging file path
 		if (FALSE == PropertyStorage_GetValueByKey(PROPERTY_LOGGING_PATH, wszLoggingFilePath, &unLoggingFilePathBufferSize))
 		{
@@ -139,24 +335,39 @@ Logging_OpenFile(
 			break;
 		}
 
-		// Check first if file exists and open it in the corresponding mode
-		if (FileIO_Exists(wszLoggingFilePath))
+		if (NULL != s_pLogFile)
 		{
-			*PpfFileExists = TRUE;
-			unReturnValue = FileIO_Open(wszLoggingFilePath, PppFileHandle, FILE_APPEND);
+			// Keep using the open file as long as the path has not changed
+			if (0 == Platform_StringCompare(wszLoggingFilePath, s_wszLogFilePath, RG_LEN(s_wszLogFilePath), FALSE))
+				*PpfFileExists = TRUE;
+			else
+			{
+				unReturnValue = Logging_Close();
+				if (RC_SUCCESS != unReturnValue)
+					break;
+			}
 		}
-		else
-			unReturnValue = FileIO_Open(wszLoggingFilePath, PppFileHandle, FILE_WRITE);
 
-		if (RC_SUCCESS != unReturnValue || NULL == *PppFileHandle)
-			break;
+		if (NULL == s_pLogFile)
+		{
+			unsigned int unLogFilePathSize = RG_LEN(s_wszLogFilePath);
+
+			// Check first if file exists and open it in the corresponding mode
+			*PpfFileExists = FileIO_Exists(wszLoggingFilePath);
+			unReturnValue = Logging_OpenFileInMode(wszLoggingFilePath, *PpfFileExists ? FILE_APPEND : FILE_WRITE);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			unReturnValue = Platform_StringCopy(s_wszLogFilePath, &unLogFilePathSize, wszLoggingFilePath);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+		}
 
 		// Check if PROPERTY_LOGGING_CHECK_SIZE flag is set in PropertyStorage
 		if (TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_LOGGING_CHECK_SIZE, &fFlag) &&
 				TRUE == fFlag)
 		{
 			unsigned int unMaxFileSize = 0;
-			unsigned long long ullFileSize = 0;
 
 			// Get maximum log file size
 			if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOGGING_MAXSIZE, &unMaxFileSize))
@@ -165,31 +376,9 @@ Logging_OpenFile(
 				break;
 			}
 
-			// Do actual size check only in case max log file size is not 0 (== unlimited)
-			if (0 != unMaxFileSize)
-			{
-				// Get file size of actual logging file
-				unReturnValue = FileIO_GetFileSize(*PppFileHandle, &ullFileSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-
-				// Check log file size limit and reopen file to overwrite it if necessary
-				if (unMaxFileSize <= (unsigned int)(ullFileSize / DIV_KILOBYTE))
-				{
-					// Close log file (since it has been opened in append mode)
-					unReturnValue = FileIO_Close(PppFileHandle);
-					if (RC_SUCCESS != unReturnValue)
-						break;
-
-					// Reopen it (now in write mode)
-					unReturnValue = FileIO_Open(wszLoggingFilePath, PppFileHandle, FILE_WRITE);
-					if (RC_SUCCESS != unReturnValue || NULL == *PppFileHandle)
-						break;
-
-					*PpfFileExists = FALSE;
-					g_fLogHeader = TRUE;
-				}
-			}
+			unReturnValue = Logging_CheckFileSize(unMaxFileSize, PpfFileExists);
+			if (RC_SUCCESS != unReturnValue)
+				break;
 
 			// Reset property for enabling log file size check
 			if (FALSE == PropertyStorage_ChangeBooleanValueByKey(PROPERTY_LOGGING_CHECK_SIZE, FALSE))
@@ -198,6 +387,8 @@ Logging_OpenFile(
 				break;
 			}
 		}
+
+		unReturnValue = RC_SUCCESS;
 	}
 	WHILE_FALSE_END;
 
@@ -208,12 +399,14 @@ Logging_OpenFile(
  *	@brief		This writes a message to the log file
  *	@details	This function handles the logging work flow and writes a given message line by line to the
  *				logging file.
- *				It also checks the file size, if the property storage flag PROPERTY_LOGGING_CHECK_SIZE is set.
- *				In case of the maximum file size is reached the function reopens the file by using override flag.
+ *				The message is written through the logging buffer of the open log file. The buffer is flushed
+ *				after level 1 messages, so errors reach the file system immediately.
  *
  *	@param		PszCurrentModule		Character string containing the current module name
  *	@param		PszCurrentFunction		Character string containing the current function name
  *	@param		PunLoggingLevel			Actual configured logging level
+ *	@param		PunMessageLevel			Logging level of the message
+ *	@param		PpTime					Time the message has been logged at (optional, can be NULL for the current time)
  *	@param		PwszMessage				Wide character string containing the message to log
  *	@param		PunMessageSize			Message size including the zero termination
  *	@retval		RC_SUCCESS				The operation completed successfully.
@@ -227,6 +420,8 @@ Logging_WriteMessage(
 	_In_z_							const char*		PszCurrentModule,
 	_In_z_							const char*		PszCurrentFunction,
 	_In_							unsigned int	PunLoggingLevel,
+	_In_							unsigned int	PunMessageLevel,
+	_In_opt_						const IfxTime*	PpTime,
 	_In_z_count_(PunMessageSize)	wchar_t*		PwszMessage,
 	_In_							unsigned int	PunMessageSize)
 {
@@ -235,7 +430,6 @@ Logging_WriteMessage(
 	// If logging is already ongoing avoid endless recursion
 	if (FALSE == s_fInLogging)
 	{
-		void* pFile = NULL;
 		wchar_t* wszLine = NULL;
 
 		// Signal that logging has been started
@@ -255,18 +449,27 @@ Logging_WriteMessage(
 				break;
 			}
 
-			// Retrieve current wszTimeStamp without date here
-			unReturnValue = Utility_GetTimestamp(FALSE, wszTimeStamp, &unTimeStampSize);
+			// Retrieve wszTimeStamp without date here
+			if (NULL == PpTime)
+				unReturnValue = Utility_GetTimestamp(FALSE, wszTimeStamp, &unTimeStampSize);
+			else
+				unReturnValue = Utility_Timestamp2String(PpTime, FALSE, wszTimeStamp, &unTimeStampSize);
 			if (RC_SUCCESS != unReturnValue)
 				break;
 
-			// Try to open the log file
-			unReturnValue = Logging_OpenFile(&pFile, &fFileExists);
-			if (RC_SUCCESS != unReturnValue || NULL == pFile)
-				break;
+			// Make sure the log file is open. While asynchronous logging is active the log file stays open
+			// and the PropertyStorage must not be accessed.
+			if (FALSE == s_fAsyncLogging)
+			{
+				unReturnValue = Logging_OpenFile(&fFileExists);
+				if (RC_SUCCESS != unReturnValue)
+					break;
+			}
+			else
+				fFileExists = TRUE;
 
 			// Write header if necessary
-			unReturnValue = Logging_WriteHeader(fFileExists, pFile);
+			unReturnValue = Logging_WriteHeader(fFileExists);
 			if (RC_SUCCESS != unReturnValue)
 				break;
 
@@ -282,7 +485,8 @@ Logging_WriteMessage(
 				unReturnValue = Utility_StringGetLine(PwszMessage, PunMessageSize, &unIndex, &wszLine, &unLineSize);
 				if (RC_SUCCESS != unReturnValue)
 				{
-					if (RC_E_END_OF_STRING != unReturnValue)
+					// The error stack is not thread safe, so the logging thread must not store errors
+					if (RC_E_END_OF_STRING != unReturnValue && FALSE == s_fIsLoggingThread)
 						ERROR_STORE(unReturnValue, L"Utility_StringGetLine returned an unexpected value.");
 					else
 						unReturnValue = RC_SUCCESS;
@@ -293,7 +497,7 @@ Logging_WriteMessage(
 				// For logging level 3 and 4, also write time-stamp to log file
 				if (PunLoggingLevel >= LOGGING_LEVEL_3)
 				{
-					unReturnValue = FileIO_WriteStringf(pFile, L"%ls ", wszTimeStamp);
+					unReturnValue = Logging_WriteStringf(L"%ls ", wszTimeStamp);
 					if (RC_SUCCESS != unReturnValue)
 						break;
 				}
@@ -332,7 +536,7 @@ Logging_WriteMessage(
 
 					if ((RC_SUCCESS == unReturnValue) && !PLATFORM_STRING_IS_NULL_OR_EMPTY(wszCurrentModuleNormalized) && !PLATFORM_STRING_IS_NULL_OR_EMPTY(wszCurrentFunction))
 					{
-						unReturnValue = FileIO_WriteStringf(pFile, L"%ls - %ls - ", wszCurrentModuleNormalized, wszCurrentFunction);
+						unReturnValue = Logging_WriteStringf(L"%ls - %ls - ", wszCurrentModuleNormalized, wszCurrentFunction);
 						if (RC_SUCCESS != unReturnValue)
 							break;
 					}
@@ -341,14 +545,14 @@ Logging_WriteMessage(
 				// Skip empty lines
 				if (wszLine[0] != L'\0')
 				{
-					unReturnValue = FileIO_WriteString(pFile, wszLine);
+					unReturnValue = FileIO_WriteString(s_pLogFile, wszLine);
 					if (RC_SUCCESS != unReturnValue)
 						break;
 				}
 
 				// Add new line before logging the next line.
 				// Needs \n as format string so it will be auto-converted to \r\n on UEFI.
-				unReturnValue = FileIO_WriteStringf(pFile, L"\n");
+				unReturnValue = Logging_WriteStringf(L"\n");
 				if (RC_SUCCESS != unReturnValue)
 					break;
 			}
@@ -356,9 +560,9 @@ Logging_WriteMessage(
 		}
 		WHILE_FALSE_END;
 
-		// Close file if it is open
-		if (NULL != pFile)
-			unReturnValue = FileIO_Close(&pFile);
+		// Level 1 messages (errors) are written through to the file immediately
+		if (RC_SUCCESS == unReturnValue && LOGGING_LEVEL_1 == PunMessageLevel)
+			unReturnValue = Logging_Flush();
 
 		// Free allocated memory
 		Platform_MemoryFree((void**)&wszLine);
@@ -370,6 +574,352 @@ Logging_WriteMessage(
 	return unReturnValue;
 }
 
+/**
+ *	@brief		Logging thread routine
+ *	@details	Takes the log records from the ring buffer, formats them and writes them to the log file.
+ *				Waits on s_pLogCondition while the ring buffer is empty. Returns after the ring buffer has been
+ *				emptied once the stop flag is set.
+ *
+ *	@param		PpContext				Not used
+ */
+static
+void
+Logging_AsyncThread(
+	_In_opt_ void* PpContext)
+{
+	UNREFERENCED_PARAMETER(PpContext);
+
+	// Drop log messages caused by the logging thread itself, see Logging_WriteLog
+	s_fIsLoggingThread = TRUE;
+
+	do
+	{
+		unsigned int unTail = atomic_load_explicit(&s_unLogRingTail, memory_order_relaxed);
+
+		if (unTail == atomic_load_explicit(&s_unLogRingHead, memory_order_acquire))
+		{
+			BOOL fStop = FALSE;
+
+			// Announce the wait before the ring buffer is checked again with the mutex held. Together with the sequentially
+			// consistent accesses in Logging_CommitRecord either this check sees the new record or the logging caller sees the
+			// flag and signals, which it can only do once the mutex is released by the wait.
+			Platform_ConditionLock(s_pLogCondition);
+			atomic_store(&s_fLogThreadWaiting, TRUE);
+			while (unTail == atomic_load(&s_unLogRingHead) && FALSE == s_fLogThreadStop)
+				Platform_ConditionWait(s_pLogCondition);
+			atomic_store(&s_fLogThreadWaiting, FALSE);
+			fStop = (unTail == atomic_load_explicit(&s_unLogRingHead, memory_order_acquire));
+			Platform_ConditionUnlock(s_pLogCondition);
+
+			// The ring buffer is only empty here if the stop flag is set
+			if (TRUE == fStop)
+				break;
+		}
+		else
+		{
+			IfxLoggingRecord* pRecord = &s_rgsLogRing[unTail % s_unLogRingSize];
+
+			if (TRUE == pRecord->fHexData)
+			{
+				wchar_t wszFormatedHexData[MAX_MESSAGE_SIZE] = {0};
+				unsigned int unFormatedHexDataSize = RG_LEN(wszFormatedHexData);
+
+				if (RC_SUCCESS == Utility_StringWriteHex(
+							pRecord->uData.rgbData, pRecord->unSize,
+							wszFormatedHexData, &unFormatedHexDataSize))
+				{
+					IGNORE_RETURN_VALUE(Logging_WriteMessage(
+											pRecord->szModule,
+											pRecord->szFunction,
+											pRecord->unLoggingLevel,
+											pRecord->unMessageLevel,
+											&pRecord->sTime,
+											wszFormatedHexData, unFormatedHexDataSize + 1));
+				}
+			}
+			else
+			{
+				IGNORE_RETURN_VALUE(Logging_WriteMessage(
+										pRecord->szModule,
+										pRecord->szFunction,
+										pRecord->unLoggingLevel,
+										pRecord->unMessageLevel,
+										&pRecord->sTime,
+										pRecord->uData.wszMessage, pRecord->unSize));
+			}
+
+			// Hand the record back to the logging caller and wake it up if it waits for the ring buffer to be emptied
+			atomic_store_explicit(&s_unLogRingTail, unTail + 1, memory_order_release);
+			if (unTail + 1 == atomic_load_explicit(&s_unLogRingHead, memory_order_acquire))
+			{
+				Platform_ConditionLock(s_pLogCondition);
+				Platform_ConditionSignal(s_pLogCondition);
+				Platform_ConditionUnlock(s_pLogCondition);
+			}
+		}
+	}
+	WHILE_TRUE_END;
+}
+
+/**
+ *	@brief		Gets the next free ring buffer record
+ *	@details	The record must be handed over to the logging thread with Logging_CommitRecord.
+ *				In case the ring buffer is full the dropped record counter is increased.
+ *
+ *	@param		PszCurrentModule		Module name, must be a string literal
+ *	@param		PszCurrentFunction		Function name, must be a string literal
+ *	@param		PunLoggingLevel			Actual configured logging level
+ *	@param		PunMessageLevel			Logging level of the message
+ *	@returns	Pointer to the record or NULL in case the ring buffer is full
+ */
+_Check_return_
+static
+IfxLoggingRecord*
+Logging_AcquireRecord(
+	_In_z_	const char*		PszCurrentModule,
+	_In_z_	const char*		PszCurrentFunction,
+	_In_	unsigned int	PunLoggingLevel,
+	_In_	unsigned int	PunMessageLevel)
+{
+	IfxLoggingRecord* pRecord = NULL;
+
+	do
+	{
+		unsigned int unHead = atomic_load_explicit(&s_unLogRingHead, memory_order_relaxed);
+
+		if (unHead - atomic_load_explicit(&s_unLogRingTail, memory_order_acquire) >= s_unLogRingSize)
+		{
+			s_unLogRecordsDropped++;
+			break;
+		}
+
+		pRecord = &s_rgsLogRing[unHead % s_unLogRingSize];
+		if (RC_SUCCESS != Platform_GetTime(&pRecord->sTime))
+		{
+			pRecord = NULL;
+			break;
+		}
+		pRecord->szModule = PszCurrentModule;
+		pRecord->szFunction = PszCurrentFunction;
+		pRecord->unLoggingLevel = PunLoggingLevel;
+		pRecord->unMessageLevel = PunMessageLevel;
+	}
+	WHILE_FALSE_END;
+
+	return pRecord;
+}
+
+/**
+ *	@brief		Hands the record acquired last with Logging_AcquireRecord over to the logging thread
+ *	@details	Wakes up the logging thread only in case it waits for records, so that a record committed while the
+ *				logging thread is busy costs no mutex operation.
+ */
+static
+void
+Logging_CommitRecord()
+{
+	atomic_store(&s_unLogRingHead, atomic_load_explicit(&s_unLogRingHead, memory_order_relaxed) + 1);
+
+	if (TRUE == atomic_load(&s_fLogThreadWaiting))
+	{
+		Platform_ConditionLock(s_pLogCondition);
+		Platform_ConditionSignal(s_pLogCondition);
+		Platform_ConditionUnlock(s_pLogCondition);
+	}
+}
+
+/**
+ *	@brief		Waits until the logging thread has written all records
+ *	@details	Used before a message is written synchronously while asynchronous logging is active, to keep
+ *				the order of the messages in the log file.
+ */
+static
+void
+Logging_WaitForAsyncIdle()
+{
+	Platform_ConditionLock(s_pLogCondition);
+	while (atomic_load_explicit(&s_unLogRingTail, memory_order_acquire) != atomic_load_explicit(&s_unLogRingHead, memory_order_relaxed))
+		Platform_ConditionWait(s_pLogCondition);
+	Platform_ConditionUnlock(s_pLogCondition);
+}
+
+/**
+ *	@brief		Starts asynchronous logging
+ *	@details	Opens the log file and starts the logging thread. Afterwards Logging_WriteLog and Logging_WriteHex only
+ *				copy the message into a ring buffer and the logging thread formats and writes it. In case the ring
+ *				buffer is full, messages are dropped and the number of dropped messages is logged by Logging_Close.
+ *				The ring buffer is sized from the configured logging level. Does nothing while logging is disabled.
+ *				Changes of PROPERTY_LOGGING_PATH are not taken into account while asynchronous logging is active.
+ *				Messages must be logged from one thread only.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Logging_StartAsync()
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		BOOL fFileExists = FALSE;
+		unsigned int unLoggingLevel = g_unLoggingLevel;
+
+		if (TRUE == s_fAsyncLogging || LOGGING_DISABLED == unLoggingLevel)
+		{
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+
+		// The logging thread must not access the PropertyStorage, so open the log file here
+		unReturnValue = Logging_OpenFile(&fFileExists);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		// Size the ring buffer from the logging level, higher levels log considerably more messages
+		if (unLoggingLevel > LOGGING_MAX_LEVEL)
+			unLoggingLevel = LOGGING_MAX_LEVEL;
+		s_unLogRingSize = LOGGING_ASYNC_RING_SIZE_MIN << (unLoggingLevel - LOGGING_LEVEL_1);
+		s_rgsLogRing = (IfxLoggingRecord*)Platform_MemoryAllocateZero(s_unLogRingSize * sizeof(IfxLoggingRecord));
+		if (NULL == s_rgsLogRing)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		unReturnValue = Platform_ConditionCreate(&s_pLogCondition);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		s_fLogThreadStop = FALSE;
+		s_fAsyncLogging = TRUE;
+		unReturnValue = Platform_ThreadCreate(Logging_AsyncThread, NULL, &s_pLogThread);
+		if (RC_SUCCESS != unReturnValue)
+			s_fAsyncLogging = FALSE;
+	}
+	WHILE_FALSE_END;
+
+	if (FALSE == s_fAsyncLogging)
+	{
+		Platform_ConditionDestroy(&s_pLogCondition);
+		Platform_MemoryFree((void**)&s_rgsLogRing);
+	}
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Stops asynchronous logging
+ *	@details	Lets the logging thread write all remaining records, waits for it to finish, releases the ring
+ *				buffer and logs the number of dropped messages.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+static
+unsigned int
+Logging_StopAsync()
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+
+	if (TRUE == s_fAsyncLogging)
+	{
+		Platform_ConditionLock(s_pLogCondition);
+		s_fLogThreadStop = TRUE;
+		Platform_ConditionSignal(s_pLogCondition);
+		Platform_ConditionUnlock(s_pLogCondition);
+
+		unReturnValue = Platform_ThreadJoin(&s_pLogThread);
+		s_fAsyncLogging = FALSE;
+
+		// The logging thread may still access the ring buffer if it could not be joined
+		if (RC_SUCCESS == unReturnValue)
+		{
+			Platform_ConditionDestroy(&s_pLogCondition);
+			Platform_MemoryFree((void**)&s_rgsLogRing);
+			s_unLogRingSize = 0;
+		}
+
+		if (0 != s_unLogRecordsDropped)
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Asynchronous logging dropped %u messages because the log buffer was full.", s_unLogRecordsDropped);
+			s_unLogRecordsDropped = 0;
+		}
+	}
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Flushes the log file
+ *	@details	Writes all buffered log messages to the log file. Does nothing if the log file is not open.
+ *				While asynchronous logging is active, waits until the logging thread has written all records.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Logging_Flush()
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+
+	if (TRUE == s_fAsyncLogging && FALSE == s_fIsLoggingThread)
+		Logging_WaitForAsyncIdle();
+
+	if (NULL != s_pLogFile)
+		unReturnValue = FileIO_Flush(s_pLogFile);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Closes the log file
+ *	@details	Stops asynchronous logging, flushes and closes the log file. Does nothing if the log file is not open.
+ *				A subsequent log message opens the log file again in append mode.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Logging_Close()
+{
+	unsigned int unReturnValue = Logging_StopAsync();
+
+	if (NULL != s_pLogFile)
+	{
+		unsigned int unReturnValueClose = FileIO_Close(&s_pLogFile);
+		if (RC_SUCCESS == unReturnValue)
+			unReturnValue = unReturnValueClose;
+
+		// Forget the handle in any case, it is not usable anymore
+		s_pLogFile = NULL;
+		s_wszLogFilePath[0] = L'\0';
+	}
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Updates the cached logging level
+ *	@details	Reads PROPERTY_LOGGING_LEVEL into g_unLoggingLevel, which is checked by the logging macros.
+ *				Must be called whenever PROPERTY_LOGGING_LEVEL is changed. Logging is disabled if the property
+ *				does not exist or is not a valid number.
+ */
+void
+Logging_UpdateLevel()
+{
+	unsigned int unLoggingLevel = LOGGING_DISABLED;
+
+	if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOGGING_LEVEL, &unLoggingLevel))
+		unLoggingLevel = LOGGING_DISABLED;
+
+	g_unLoggingLevel = unLoggingLevel;
+}
+
 /**
  *	@brief		Logging function
  *	@details	Writes the given text into the configured log
@@ -393,10 +943,13 @@ Logging_WriteLog(
 
 	do
 	{
-		// Get Logging level
-		if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOGGING_LEVEL, &unConfiguredLoggingLevel))
+		// Messages caused by the logging thread itself are dropped like recursive messages in synchronous mode
+		if (TRUE == s_fIsLoggingThread)
 			break;
 
+		// Get Logging level
+		unConfiguredLoggingLevel = g_unLoggingLevel;
+
 		if (PunLoggingLevel <= unConfiguredLoggingLevel)
 		{
 			va_list argptr;
@@ -408,6 +961,40 @@ Logging_WriteLog(
 				wchar_t wszMessage[MAX_MESSAGE_SIZE] = {0};
 				unsigned int unMessageSize = RG_LEN(wszMessage);
 
+				if (TRUE == s_fAsyncLogging)
+				{
+					// Format the message directly into the ring buffer record
+					IfxLoggingRecord* pRecord = Logging_AcquireRecord(PszCurrentModule, PszCurrentFunction, unConfiguredLoggingLevel, PunLoggingLevel);
+					if (NULL == pRecord)
+						break;
+
+					pRecord->fHexData = FALSE;
+					pRecord->uData.wszMessage[0] = L'\0';
+					unMessageSize = RG_LEN(pRecord->uData.wszMessage);
+					unReturnValue = RC_SUCCESS;
+					if (PwszLoggingMessage[0] != L'\0')
+					{
+						va_start(argptr, PwszLoggingMessage);
+						unReturnValue = Platform_StringFormatV(pRecord->uData.wszMessage, &unMessageSize, PwszLoggingMessage, argptr);
+						va_end(argptr);
+					}
+					else
+						unMessageSize = 0;
+
+					if (RC_SUCCESS == unReturnValue)
+					{
+						pRecord->unSize = unMessageSize + 1;
+						Logging_CommitRecord();
+						break;
+					}
+
+					// Messages not fitting into a record are written synchronously below
+					if (RC_E_BUFFER_TOO_SMALL != unReturnValue)
+						break;
+					Logging_WaitForAsyncIdle();
+					unMessageSize = RG_LEN(wszMessage);
+				}
+
 				// Skip formating if a empty line should be written
 				if (PwszLoggingMessage[0] != L'\0')
 				{
@@ -426,6 +1013,8 @@ Logging_WriteLog(
 									PszCurrentModule,
 									PszCurrentFunction,
 									unConfiguredLoggingLevel,
+									PunLoggingLevel,
+									NULL,
 									wszMessage, unMessageSize + 1);
 				if (RC_SUCCESS != unReturnValue)
 					break;
@@ -462,15 +1051,40 @@ Logging_WriteHex(
 		if (NULL == PrgbHexData || 0 == PunSize)
 			break;
 
-		// Get Logging level
-		if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOGGING_LEVEL, &unConfiguredLoggingLevel))
+		// Messages caused by the logging thread itself are dropped like recursive messages in synchronous mode
+		if (TRUE == s_fIsLoggingThread)
 			break;
 
+		// Get Logging level
+		unConfiguredLoggingLevel = g_unLoggingLevel;
+
 		if (PunLoggingLevel <= unConfiguredLoggingLevel)
 		{
 			wchar_t wszFormatedHexData[MAX_MESSAGE_SIZE] = {0};
 			unsigned int unFormatedHexDataSize = RG_LEN(wszFormatedHexData);
 
+			if (TRUE == s_fAsyncLogging)
+			{
+				// Copy the raw data into the ring buffer record, the logging thread formats it
+				if (PunSize <= sizeof(((IfxLoggingRecord*)NULL)->uData.rgbData))
+				{
+					IfxLoggingRecord* pRecord = Logging_AcquireRecord(PszCurrentModule, PszCurrentFunction, unConfiguredLoggingLevel, PunLoggingLevel);
+					if (NULL == pRecord)
+						break;
+
+					pRecord->fHexData = TRUE;
+					pRecord->unSize = PunSize;
+					unReturnValue = Platform_MemoryCopy(pRecord->uData.rgbData, sizeof(pRecord->uData.rgbData), PrgbHexData, PunSize);
+					if (RC_SUCCESS != unReturnValue)
+						break;
+					Logging_CommitRecord();
+					break;
+				}
+
+				// Data not fitting into a record is written synchronously below
+				Logging_WaitForAsyncIdle();
+			}
+
 			unReturnValue = Utility_StringWriteHex(
 								PrgbHexData, PunSize,
 								wszFormatedHexData, &unFormatedHexDataSize);
@@ -482,6 +1096,8 @@ Logging_WriteHex(
 								PszCurrentModule,
 								PszCurrentFunction,
 								unConfiguredLoggingLevel,
+								PunLoggingLevel,
+								NULL,
 								wszFormatedHexData, unFormatedHexDataSize + 1);
 			if (RC_SUCCESS != unReturnValue)
 				break;
@@ -23,6 +23,9 @@ extern "C" {
 /// Flag indicating whether to write a header into the log file or not
 extern BOOL g_fLogHeader;
 
+/// Configured logging level cached from PROPERTY_LOGGING_LEVEL, see Logging_UpdateLevel
+extern unsigned int g_unLoggingLevel;
+
 /**
  *	Value definitions for logging
  */
@@ -57,37 +60,55 @@ extern BOOL g_fLogHeader;
 /// Divisor for megabyte
 #define DIV_KILOBYTE 1024
 
+/// Size of the user-space buffer the log file is written through
+#define LOGGING_BUFFER_SIZE (64 * 1024)
+
+/// Number of records in the asynchronous logging ring buffer at logging level 1, doubled for each higher level
+#define LOGGING_ASYNC_RING_SIZE_MIN 16
+
+/// Maximum message size in elements of an asynchronous logging record, larger messages are written synchronously
+#define LOGGING_ASYNC_MESSAGE_SIZE 1024
+
 /**
  *	Macro definitions for logging
  */
 
+/// Highest logging level compiled into the binary (e.g. build with CFLAGS=-DLOGGING_MAX_LEVEL=2).
+/// The compiler removes all logging macros of a higher level including the evaluation of their arguments.
+#ifndef LOGGING_MAX_LEVEL
+#define LOGGING_MAX_LEVEL	LOGGING_LEVEL_4
+#endif
+
+/// Macro checking whether messages of the given level are logged, evaluated before any argument of the logging macros
+#define LOGGING_IS_ENABLED(LOGLEVEL)	((LOGLEVEL) <= LOGGING_MAX_LEVEL && (LOGLEVEL) <= g_unLoggingLevel)
+
 /// Macro for writing a message into the log file
-#define LOGGING_WRITE(LOGLEVEL, LOGMESSAGE, ...)	Logging_WriteLog(__FILE__, __func__, LOGLEVEL, LOGMESSAGE, ##__VA_ARGS__);
+#define LOGGING_WRITE(LOGLEVEL, LOGMESSAGE, ...)	(LOGGING_IS_ENABLED(LOGLEVEL) ? Logging_WriteLog(__FILE__, __func__, LOGLEVEL, LOGMESSAGE, ##__VA_ARGS__) : (void)0);
 
 /// Macro for writing a message into the log file only in case current log level is level 1 or higher
-#define LOGGING_WRITE_LEVEL1_FMT(LOGMESSAGE, ...)	Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_1, LOGMESSAGE, ##__VA_ARGS__);
-#define LOGGING_WRITE_LEVEL1(LOGMESSAGE)			Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_1, LOGMESSAGE, NULL);
+#define LOGGING_WRITE_LEVEL1_FMT(LOGMESSAGE, ...)	(LOGGING_IS_ENABLED(LOGGING_LEVEL_1) ? Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_1, LOGMESSAGE, ##__VA_ARGS__) : (void)0);
+#define LOGGING_WRITE_LEVEL1(LOGMESSAGE)			(LOGGING_IS_ENABLED(LOGGING_LEVEL_1) ? Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_1, LOGMESSAGE, NULL) : (void)0);
 
 /// Macro for writing a message into the log file only in case current log level is level 2 or higher
-#define LOGGING_WRITE_LEVEL2_FMT(LOGMESSAGE, ...)	Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_2, LOGMESSAGE, ##__VA_ARGS__);
-#define LOGGING_WRITE_LEVEL2(LOGMESSAGE)			Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_2, LOGMESSAGE, NULL);
+#define LOGGING_WRITE_LEVEL2_FMT(LOGMESSAGE, ...)	(LOGGING_IS_ENABLED(LOGGING_LEVEL_2) ? Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_2, LOGMESSAGE, ##__VA_ARGS__) : (void)0);
+#define LOGGING_WRITE_LEVEL2(LOGMESSAGE)			(LOGGING_IS_ENABLED(LOGGING_LEVEL_2) ? Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_2, LOGMESSAGE, NULL) : (void)0);
 
 /// Macro for writing a message into the log file only in case current log level is level 3 or higher
-#define LOGGING_WRITE_LEVEL3_FMT(LOGMESSAGE, ...)	Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_3, LOGMESSAGE, ##__VA_ARGS__);
-#define LOGGING_WRITE_LEVEL3(LOGMESSAGE)			Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_3, LOGMESSAGE, NULL);
+#define LOGGING_WRITE_LEVEL3_FMT(LOGMESSAGE, ...)	(LOGGING_IS_ENABLED(LOGGING_LEVEL_3) ? Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_3, LOGMESSAGE, ##__VA_ARGS__) : (void)0);
+#define LOGGING_WRITE_LEVEL3(LOGMESSAGE)			(LOGGING_IS_ENABLED(LOGGING_LEVEL_3) ? Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_3, LOGMESSAGE, NULL) : (void)0);
 
 /// Macro for writing a message into the log file only in case current log level is level 4 or higher
-#define LOGGING_WRITE_LEVEL4_FMT(LOGMESSAGE, ...)	Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_4, LOGMESSAGE, ##__VA_ARGS__);
-#define LOGGING_WRITE_LEVEL4(LOGMESSAGE)			Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_4, LOGMESSAGE, NULL);
+#define LOGGING_WRITE_LEVEL4_FMT(LOGMESSAGE, ...)	(LOGGING_IS_ENABLED(LOGGING_LEVEL_4) ? Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_4, LOGMESSAGE, ##__VA_ARGS__) : (void)0);
+#define LOGGING_WRITE_LEVEL4(LOGMESSAGE)			(LOGGING_IS_ENABLED(LOGGING_LEVEL_4) ? Logging_WriteLog(__FILE__, __func__, LOGGING_LEVEL_4, LOGMESSAGE, NULL) : (void)0);
 
 /// Macro for writing a buffer's contents in hex bytes into the log file
-#define LOGGING_WRITEHEX(LOGLEVEL, BUFFER, SIZE)	Logging_WriteHex(__FILE__, __func__, LOGLEVEL, BUFFER, SIZE);
+#define LOGGING_WRITEHEX(LOGLEVEL, BUFFER, SIZE)	(LOGGING_IS_ENABLED(LOGLEVEL) ? Logging_WriteHex(__FILE__, __func__, LOGLEVEL, BUFFER, SIZE) : (void)0);
 
 /// Macro for writing a buffer's contents in hex bytes into the log file only in case current log level is level 1 or higher
-#define LOGGING_WRITEHEX_LEVEL1(BUFFER, SIZE)		Logging_WriteHex(__FILE__, __func__, LOGGING_LEVEL_1, BUFFER, SIZE);
+#define LOGGING_WRITEHEX_LEVEL1(BUFFER, SIZE)		(LOGGING_IS_ENABLED(LOGGING_LEVEL_1) ? Logging_WriteHex(__FILE__, __func__, LOGGING_LEVEL_1, BUFFER, SIZE) : (void)0);
 
 /// Macro for writing a buffer's contents in hex bytes into the log file only in case current log level is level 3 or higher
-#define LOGGING_WRITEHEX_LEVEL3(BUFFER, SIZE)		Logging_WriteHex(__FILE__, __func__, LOGGING_LEVEL_3, BUFFER, SIZE);
+#define LOGGING_WRITEHEX_LEVEL3(BUFFER, SIZE)		(LOGGING_IS_ENABLED(LOGGING_LEVEL_3) ? Logging_WriteHex(__FILE__, __func__, LOGGING_LEVEL_3, BUFFER, SIZE) : (void)0);
 
 /**
  *	Method declarations for logging
@@ -129,6 +150,55 @@ Logging_WriteHex(
 	_In_bytecount_(PunSize)	const BYTE*		PrgbHexData,
 	_In_					unsigned int	PunSize);
 
+/**
+ *	@brief		Updates the cached logging level
+ *	@details	Reads PROPERTY_LOGGING_LEVEL into g_unLoggingLevel, which is checked by the logging macros.
+ *				Must be called whenever PROPERTY_LOGGING_LEVEL is changed. Logging is disabled if the property
+ *				does not exist or is not a valid number.
+ */
+void
+Logging_UpdateLevel();
+
+/**
+ *	@brief		Starts asynchronous logging
+ *	@details	Opens the log file and starts the logging thread. Afterwards Logging_WriteLog and Logging_WriteHex only
+ *				copy the message into a ring buffer and the logging thread formats and writes it. In case the ring
+ *				buffer is full, messages are dropped and the number of dropped messages is logged by Logging_Close.
+ *				The ring buffer is sized from the configured logging level. Does nothing while logging is disabled.
+ *				Changes of PROPERTY_LOGGING_PATH are not taken into account while asynchronous logging is active.
+ *				Messages must be logged from one thread only.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Logging_StartAsync();
+
+/**
+ *	@brief		Flushes the log file
+ *	@details	Writes all buffered log messages to the log file. Does nothing if the log file is not open.
+ *				While asynchronous logging is active, waits until the logging thread has written all records.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Logging_Flush();
+
+/**
+ *	@brief		Closes the log file
+ *	@details	Stops asynchronous logging, flushes and closes the log file. Does nothing if the log file is not open.
+ *				A subsequent log message opens the log file again in append mode.
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Logging_Close();
+
 #ifdef __cplusplus
 }
 #endif
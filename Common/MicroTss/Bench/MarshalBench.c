@@ -0,0 +1,468 @@
+﻿/**
+ *	@brief		Micro-benchmark for the bulk array marshal functions
+ *	@details	Compares the bulk UINT8, UINT16 and UINT32 array marshal and unmarshal functions of TPM2_Marshal.c with the
+ *				former element by element implementation. Checks first that both produce the same results and then measures
+ *				the time per call. Built and run with "make bench" in Common/MicroTss; not part of the TPMFactoryUpd build.
+ *	@file		MarshalBench.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "TPM2_Marshal.h"
+#include "Platform.h"
+
+/// Largest array size used by the checks and the measurement in bytes
+#define MARSHAL_BENCH_MAX_BYTES		1024
+/// Default number of measured calls per function
+#define MARSHAL_BENCH_ITERATIONS	100000
+
+/// Array marshal function with the element type erased
+typedef unsigned int (*PFN_ARRAY_MARSHAL)(const void* PpSource, BYTE** PprgbBuffer, INT32* PpnSize, INT32 PnCount);
+/// Array unmarshal function with the element type erased
+typedef unsigned int (*PFN_ARRAY_UNMARSHAL)(void* PpTarget, BYTE** PprgbBuffer, INT32* PpnSize, INT32 PnCount);
+
+/// Functions of one element type under test
+typedef struct tdMarshalBenchType
+{
+	/// Name of the element type
+	const char* szName;
+	/// Size of one element in the buffer in bytes
+	INT32 nElementSize;
+	/// Element by element reference implementation of the array marshal function
+	PFN_ARRAY_MARSHAL pfnMarshalReference;
+	/// Bulk array marshal function
+	PFN_ARRAY_MARSHAL pfnMarshal;
+	/// Element by element reference implementation of the array unmarshal function
+	PFN_ARRAY_UNMARSHAL pfnUnmarshalReference;
+	/// Bulk array unmarshal function
+	PFN_ARRAY_UNMARSHAL pfnUnmarshal;
+} MarshalBenchType;
+
+/**
+ *	@brief		Element by element UINT8 array marshal function as used before the bulk functions
+ *	@details
+ *
+ *	@param		PpSource	Location of the array to be marshaled
+ *	@param		PprgbBuffer	Location in the output buffer
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from TSS_UINT8_Marshal.
+ */
+static
+unsigned int
+MarshalBench_Uint8MarshalReference(
+	_In_	const void*	PpSource,
+	_Inout_	BYTE**		PprgbBuffer,
+	_Inout_	INT32*		PpnSize,
+	_In_	INT32		PnCount)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	INT32 nPos = 0;
+
+	for (nPos = 0; nPos < PnCount && RC_SUCCESS == unReturnValue; nPos++)
+		unReturnValue = TSS_UINT8_Marshal(&((const UINT8*)PpSource)[nPos], PprgbBuffer, PpnSize);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Element by element UINT8 array unmarshal function as used before the bulk functions
+ *	@details
+ *
+ *	@param		PpTarget	Location of the array to be filled
+ *	@param		PprgbBuffer	Location in the input buffer
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from TSS_UINT8_Unmarshal.
+ */
+static
+unsigned int
+MarshalBench_Uint8UnmarshalReference(
+	_Out_	void*		PpTarget,
+	_Inout_	BYTE**		PprgbBuffer,
+	_Inout_	INT32*		PpnSize,
+	_In_	INT32		PnCount)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	INT32 nPos = 0;
+
+	for (nPos = 0; nPos < PnCount && RC_SUCCESS == unReturnValue; nPos++)
+		unReturnValue = TSS_UINT8_Unmarshal(&((UINT8*)PpTarget)[nPos], PprgbBuffer, PpnSize);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Element by element UINT16 array marshal function as used before the bulk functions
+ *	@details
+ *
+ *	@param		PpSource	Location of the array to be marshaled
+ *	@param		PprgbBuffer	Location in the output buffer
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from TSS_UINT16_Marshal.
+ */
+static
+unsigned int
+MarshalBench_Uint16MarshalReference(
+	_In_	const void*	PpSource,
+	_Inout_	BYTE**		PprgbBuffer,
+	_Inout_	INT32*		PpnSize,
+	_In_	INT32		PnCount)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	INT32 nPos = 0;
+
+	for (nPos = 0; nPos < PnCount && RC_SUCCESS == unReturnValue; nPos++)
+		unReturnValue = TSS_UINT16_Marshal(&((const UINT16*)PpSource)[nPos], PprgbBuffer, PpnSize);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Element by element UINT16 array unmarshal function as used before the bulk functions
+ *	@details
+ *
+ *	@param		PpTarget	Location of the array to be filled
+ *	@param		PprgbBuffer	Location in the input buffer
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from TSS_UINT16_Unmarshal.
+ */
+static
+unsigned int
+MarshalBench_Uint16UnmarshalReference(
+	_Out_	void*		PpTarget,
+	_Inout_	BYTE**		PprgbBuffer,
+	_Inout_	INT32*		PpnSize,
+	_In_	INT32		PnCount)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	INT32 nPos = 0;
+
+	for (nPos = 0; nPos < PnCount && RC_SUCCESS == unReturnValue; nPos++)
+		unReturnValue = TSS_UINT16_Unmarshal(&((UINT16*)PpTarget)[nPos], PprgbBuffer, PpnSize);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Element by element UINT32 array marshal function as used before the bulk functions
+ *	@details
+ *
+ *	@param		PpSource	Location of the array to be marshaled
+ *	@param		PprgbBuffer	Location in the output buffer
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from TSS_UINT32_Marshal.
+ */
+static
+unsigned int
+MarshalBench_Uint32MarshalReference(
+	_In_	const void*	PpSource,
+	_Inout_	BYTE**		PprgbBuffer,
+	_Inout_	INT32*		PpnSize,
+	_In_	INT32		PnCount)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	INT32 nPos = 0;
+
+	for (nPos = 0; nPos < PnCount && RC_SUCCESS == unReturnValue; nPos++)
+		unReturnValue = TSS_UINT32_Marshal(&((const UINT32*)PpSource)[nPos], PprgbBuffer, PpnSize);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Element by element UINT32 array unmarshal function as used before the bulk functions
+ *	@details
+ *
+ *	@param		PpTarget	Location of the array to be filled
+ *	@param		PprgbBuffer	Location in the input buffer
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from TSS_UINT32_Unmarshal.
+ */
+static
+unsigned int
+MarshalBench_Uint32UnmarshalReference(
+	_Out_	void*		PpTarget,
+	_Inout_	BYTE**		PprgbBuffer,
+	_Inout_	INT32*		PpnSize,
+	_In_	INT32		PnCount)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	INT32 nPos = 0;
+
+	for (nPos = 0; nPos < PnCount && RC_SUCCESS == unReturnValue; nPos++)
+		unReturnValue = TSS_UINT32_Unmarshal(&((UINT32*)PpTarget)[nPos], PprgbBuffer, PpnSize);
+
+	return unReturnValue;
+}
+
+/// Adapts TSS_UINT8_Array_Marshal to PFN_ARRAY_MARSHAL
+static unsigned int MarshalBench_Uint8Marshal(const void* PpSource, BYTE** PprgbBuffer, INT32* PpnSize, INT32 PnCount)
+{
+	return TSS_UINT8_Array_Marshal((const UINT8*)PpSource, PprgbBuffer, PpnSize, PnCount);
+}
+
+/// Adapts TSS_UINT8_Array_Unmarshal to PFN_ARRAY_UNMARSHAL
+static unsigned int MarshalBench_Uint8Unmarshal(void* PpTarget, BYTE** PprgbBuffer, INT32* PpnSize, INT32 PnCount)
+{
+	return TSS_UINT8_Array_Unmarshal((UINT8*)PpTarget, PprgbBuffer, PpnSize, PnCount);
+}
+
+/// Adapts TSS_UINT16_Array_Marshal to PFN_ARRAY_MARSHAL
+static unsigned int MarshalBench_Uint16Marshal(const void* PpSource, BYTE** PprgbBuffer, INT32* PpnSize, INT32 PnCount)
+{
+	return TSS_UINT16_Array_Marshal((const UINT16*)PpSource, PprgbBuffer, PpnSize, PnCount);
+}
+
+/// Adapts TSS_UINT16_Array_Unmarshal to PFN_ARRAY_UNMARSHAL
+static unsigned int MarshalBench_Uint16Unmarshal(void* PpTarget, BYTE** PprgbBuffer, INT32* PpnSize, INT32 PnCount)
+{
+	return TSS_UINT16_Array_Unmarshal((UINT16*)PpTarget, PprgbBuffer, PpnSize, PnCount);
+}
+
+/// Adapts TSS_UINT32_Array_Marshal to PFN_ARRAY_MARSHAL
+static unsigned int MarshalBench_Uint32Marshal(const void* PpSource, BYTE** PprgbBuffer, INT32* PpnSize, INT32 PnCount)
+{
+	return TSS_UINT32_Array_Marshal((const UINT32*)PpSource, PprgbBuffer, PpnSize, PnCount);
+}
+
+/// Adapts TSS_UINT32_Array_Unmarshal to PFN_ARRAY_UNMARSHAL
+static unsigned int MarshalBench_Uint32Unmarshal(void* PpTarget, BYTE** PprgbBuffer, INT32* PpnSize, INT32 PnCount)
+{
+	return TSS_UINT32_Array_Unmarshal((UINT32*)PpTarget, PprgbBuffer, PpnSize, PnCount);
+}
+
+/// Element types under test
+static const MarshalBenchType s_rgsTypes[] =
+{
+	{ "UINT8", 1, MarshalBench_Uint8MarshalReference, MarshalBench_Uint8Marshal, MarshalBench_Uint8UnmarshalReference, MarshalBench_Uint8Unmarshal },
+	{ "UINT16", 2, MarshalBench_Uint16MarshalReference, MarshalBench_Uint16Marshal, MarshalBench_Uint16UnmarshalReference, MarshalBench_Uint16Unmarshal },
+	{ "UINT32", 4, MarshalBench_Uint32MarshalReference, MarshalBench_Uint32Marshal, MarshalBench_Uint32UnmarshalReference, MarshalBench_Uint32Unmarshal }
+};
+
+/// Source array, aligned for all element types
+static UINT32 s_rgunSource[MARSHAL_BENCH_MAX_BYTES / sizeof(UINT32)];
+
+/**
+ *	@brief		Check that the bulk and the reference functions of one element type produce the same results
+ *	@details	Marshals and unmarshals arrays of several lengths into buffers which are exactly large enough, larger and one
+ *				byte too small. Return codes, buffer content, buffer position and remaining size must match. For a buffer which
+ *				is too small only the return code is compared: the reference functions write the elements which fit, the bulk
+ *				functions write nothing.
+ *
+ *	@param		PpsType		Element type under test
+ *	@retval		TRUE		The results match.
+ *	@retval		FALSE		The results differ.
+ */
+static
+BOOL
+MarshalBench_CheckType(
+	_In_	const MarshalBenchType*	PpsType)
+{
+	const INT32 rgnCounts[] = { 0, 1, 2, 3, 7, 8, 9, 63, 64, 65, 255, 256 };
+	const INT32 rgnExtraSizes[] = { 0, 7, -1 };
+	BOOL fMatch = TRUE;
+	unsigned int unCount = 0;
+	unsigned int unExtra = 0;
+
+	for (unCount = 0; unCount < RG_LEN(rgnCounts) && fMatch; unCount++)
+	{
+		INT32 nCount = rgnCounts[unCount];
+		if (nCount * PpsType->nElementSize > MARSHAL_BENCH_MAX_BYTES)
+			continue;
+
+		for (unExtra = 0; unExtra < RG_LEN(rgnExtraSizes) && fMatch; unExtra++)
+		{
+			BYTE rgbReference[MARSHAL_BENCH_MAX_BYTES + 8] = {0};
+			BYTE rgbBulk[MARSHAL_BENCH_MAX_BYTES + 8] = {0};
+			UINT32 rgunReference[MARSHAL_BENCH_MAX_BYTES / sizeof(UINT32)] = {0};
+			UINT32 rgunBulk[MARSHAL_BENCH_MAX_BYTES / sizeof(UINT32)] = {0};
+			INT32 nBufferSize = nCount * PpsType->nElementSize + rgnExtraSizes[unExtra];
+			INT32 nSizeReference = nBufferSize;
+			INT32 nSizeBulk = nBufferSize;
+			BYTE* pbReference = rgbReference;
+			BYTE* pbBulk = rgbBulk;
+			unsigned int unReturnReference = RC_E_FAIL;
+			unsigned int unReturnBulk = RC_E_FAIL;
+
+			if (nBufferSize < 0)
+				continue;
+
+			// Marshal
+			unReturnReference = PpsType->pfnMarshalReference(s_rgunSource, &pbReference, &nSizeReference, nCount);
+			unReturnBulk = PpsType->pfnMarshal(s_rgunSource, &pbBulk, &nSizeBulk, nCount);
+			if (unReturnReference != unReturnBulk)
+				fMatch = FALSE;
+			else if (RC_SUCCESS == unReturnBulk &&
+					(nSizeReference != nSizeBulk ||
+					pbReference - rgbReference != pbBulk - rgbBulk ||
+					0 != Platform_MemoryCompare(rgbReference, rgbBulk, sizeof(rgbReference))))
+				fMatch = FALSE;
+			if (!fMatch)
+			{
+				printf("Mismatch: %s array marshal, %d elements, buffer size %d\n", PpsType->szName, nCount, nBufferSize);
+				break;
+			}
+
+			// Unmarshal the marshaled data again
+			nSizeReference = nBufferSize;
+			nSizeBulk = nBufferSize;
+			pbReference = rgbReference;
+			pbBulk = rgbReference;
+			unReturnReference = PpsType->pfnUnmarshalReference(rgunReference, &pbReference, &nSizeReference, nCount);
+			unReturnBulk = PpsType->pfnUnmarshal(rgunBulk, &pbBulk, &nSizeBulk, nCount);
+			if (unReturnReference != unReturnBulk)
+				fMatch = FALSE;
+			else if (RC_SUCCESS == unReturnBulk &&
+					(nSizeReference != nSizeBulk ||
+					pbReference != pbBulk ||
+					0 != Platform_MemoryCompare(rgunReference, rgunBulk, sizeof(rgunReference)) ||
+					0 != Platform_MemoryCompare(rgunBulk, s_rgunSource, (unsigned int)(nCount * PpsType->nElementSize))))
+				fMatch = FALSE;
+			if (!fMatch)
+				printf("Mismatch: %s array unmarshal, %d elements, buffer size %d\n", PpsType->szName, nCount, nBufferSize);
+		}
+	}
+
+	return fMatch;
+}
+
+/**
+ *	@brief		Get a monotonic time stamp
+ *	@details
+ *
+ *	@returns	Time stamp in nanoseconds
+ */
+static
+unsigned long long
+MarshalBench_Now(void)
+{
+	struct timespec sTime;
+
+	IGNORE_RETURN_VALUE(clock_gettime(CLOCK_MONOTONIC, &sTime));
+
+	return (unsigned long long)sTime.tv_sec * 1000000000ULL + (unsigned long long)sTime.tv_nsec;
+}
+
+/**
+ *	@brief		Measure the time of one array marshal and one array unmarshal call over MARSHAL_BENCH_MAX_BYTES bytes
+ *	@details
+ *
+ *	@param		PpfnMarshal		Array marshal function
+ *	@param		PpfnUnmarshal	Array unmarshal function
+ *	@param		PnCount			Number of elements filling MARSHAL_BENCH_MAX_BYTES bytes
+ *	@param		PunIterations	Number of measured calls
+ *	@param		PpdMarshal		Receives the time per marshal call in nanoseconds
+ *	@param		PpdUnmarshal	Receives the time per unmarshal call in nanoseconds
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		...				Error codes from the measured functions.
+ */
+static
+unsigned int
+MarshalBench_Measure(
+	_In_	PFN_ARRAY_MARSHAL	PpfnMarshal,
+	_In_	PFN_ARRAY_UNMARSHAL	PpfnUnmarshal,
+	_In_	INT32				PnCount,
+	_In_	unsigned int		PunIterations,
+	_Out_	double*				PpdMarshal,
+	_Out_	double*				PpdUnmarshal)
+{
+	static BYTE s_rgbBuffer[MARSHAL_BENCH_MAX_BYTES];
+	static UINT32 s_rgunTarget[MARSHAL_BENCH_MAX_BYTES / sizeof(UINT32)];
+	unsigned int unReturnValue = RC_SUCCESS;
+	unsigned long long ullStart = 0;
+	unsigned int unIndex = 0;
+
+	ullStart = MarshalBench_Now();
+	for (unIndex = 0; unIndex < PunIterations && RC_SUCCESS == unReturnValue; unIndex++)
+	{
+		BYTE* pbBuffer = s_rgbBuffer;
+		INT32 nSize = sizeof(s_rgbBuffer);
+		unReturnValue = PpfnMarshal(s_rgunSource, &pbBuffer, &nSize, PnCount);
+	}
+	*PpdMarshal = (double)(MarshalBench_Now() - ullStart) / PunIterations;
+
+	ullStart = MarshalBench_Now();
+	for (unIndex = 0; unIndex < PunIterations && RC_SUCCESS == unReturnValue; unIndex++)
+	{
+		BYTE* pbBuffer = s_rgbBuffer;
+		INT32 nSize = sizeof(s_rgbBuffer);
+		unReturnValue = PpfnUnmarshal(s_rgunTarget, &pbBuffer, &nSize, PnCount);
+	}
+	*PpdUnmarshal = (double)(MarshalBench_Now() - ullStart) / PunIterations;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Main function of the marshal micro-benchmark
+ *	@details	Usage: MarshalBench [iterations]
+ *
+ *	@param		PnArgc		Number of arguments
+ *	@param		PrgszArgv	Arguments
+ *	@retval		0			The bulk functions match the reference implementation.
+ *	@retval		1			The results differ or a function failed.
+ */
+int main(int PnArgc, char* PrgszArgv[])
+{
+	unsigned int unIterations = MARSHAL_BENCH_ITERATIONS;
+	unsigned int unIndex = 0;
+	int nReturnValue = 0;
+
+	if (PnArgc > 1)
+		unIterations = (unsigned int)strtoul(PrgszArgv[1], NULL, 10);
+	if (0 == unIterations)
+		unIterations = MARSHAL_BENCH_ITERATIONS;
+
+	// Fill the source with a pattern which differs in every byte
+	for (unIndex = 0; unIndex < sizeof(s_rgunSource); unIndex++)
+		((BYTE*)s_rgunSource)[unIndex] = (BYTE)(unIndex * 7 + 1);
+
+	printf("Marshal micro-benchmark: %u bytes, %u iterations\n", MARSHAL_BENCH_MAX_BYTES, unIterations);
+	printf("%-8s %-10s %14s %14s %9s\n", "Type", "Function", "Reference ns", "Bulk ns", "Speedup");
+	for (unIndex = 0; unIndex < RG_LEN(s_rgsTypes); unIndex++)
+	{
+		const MarshalBenchType* pType = &s_rgsTypes[unIndex];
+		INT32 nCount = MARSHAL_BENCH_MAX_BYTES / pType->nElementSize;
+		double dMarshalReference = 0, dUnmarshalReference = 0, dMarshal = 0, dUnmarshal = 0;
+
+		if (!MarshalBench_CheckType(pType))
+		{
+			nReturnValue = 1;
+			continue;
+		}
+
+		if (RC_SUCCESS != MarshalBench_Measure(pType->pfnMarshalReference, pType->pfnUnmarshalReference, nCount, unIterations, &dMarshalReference, &dUnmarshalReference) ||
+				RC_SUCCESS != MarshalBench_Measure(pType->pfnMarshal, pType->pfnUnmarshal, nCount, unIterations, &dMarshal, &dUnmarshal))
+		{
+			printf("Error: %s array functions failed\n", pType->szName);
+			nReturnValue = 1;
+			continue;
+		}
+		printf("%-8s %-10s %14.1f %14.1f %8.1fx\n", pType->szName, "Marshal", dMarshalReference, dMarshal, dMarshalReference / dMarshal);
+		printf("%-8s %-10s %14.1f %14.1f %8.1fx\n", pType->szName, "Unmarshal", dUnmarshalReference, dUnmarshal, dUnmarshalReference / dUnmarshal);
+	}
+	printf("Equivalence check: %s\n", 0 == nReturnValue ? "passed" : "FAILED");
+
+	return nReturnValue;
+}
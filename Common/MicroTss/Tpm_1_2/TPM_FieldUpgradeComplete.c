@@ -43,10 +43,9 @@ TSS_TPM_FieldUpgradeComplete(
 
 	do
 	{
-		BYTE rgbRequest[MAX_COMMAND_SIZE] = {0};
-		BYTE rgbResponse[MAX_RESPONSE_SIZE] = {0};
-		BYTE* pbBuffer = rgbRequest;
-		INT32 nSizeRemaining = sizeof(rgbRequest), nSizeResponse = sizeof(rgbResponse);
+		IfxTpmCommandBuffer* psCommandBuffer = DeviceManagement_GetCommandBuffer();
+		BYTE* pbBuffer = psCommandBuffer->rgbRequest;
+		INT32 nSizeRemaining = sizeof(psCommandBuffer->rgbRequest), nSizeResponse = sizeof(psCommandBuffer->rgbResponse);
 
 		// Request parameters
 		TPM_ST tag = TPM_TAG_RQU_COMMAND;
@@ -102,20 +101,20 @@ TSS_TPM_FieldUpgradeComplete(
 			break;
 
 		// Overwrite unCommandSize
-		unCommandSize = sizeof(rgbRequest) - nSizeRemaining;
-		pbBuffer = rgbRequest + 2;
+		unCommandSize = sizeof(psCommandBuffer->rgbRequest) - nSizeRemaining;
+		pbBuffer = psCommandBuffer->rgbRequest + 2;
 		nSizeRemaining = 4;
 		unReturnValue = TSS_UINT32_Marshal(&unCommandSize, &pbBuffer, &nSizeRemaining);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
 		// Transmit the command over TDDL
-		unReturnValue = DeviceManagement_Transmit(rgbRequest, unCommandSize, rgbResponse, (unsigned int*)&nSizeResponse);
+		unReturnValue = DeviceManagement_Transmit(psCommandBuffer->rgbRequest, unCommandSize, psCommandBuffer->rgbResponse, (unsigned int*)&nSizeResponse);
 		if (TPM_RC_SUCCESS != unReturnValue)
 			break;
 
 		// Unmarshal the response
-		pbBuffer = rgbResponse;
+		pbBuffer = psCommandBuffer->rgbResponse;
 		nSizeRemaining = nSizeResponse;
 		unReturnValue = TSS_TPM_ST_Unmarshal(&tag, &pbBuffer, &nSizeRemaining);
 		if (TPM_RC_SUCCESS != unReturnValue)
@@ -35,11 +35,10 @@ TSS_TPM_FieldUpgradeInfoRequest2(
 
 	do
 	{
-		BYTE rgbRequest[MAX_COMMAND_SIZE] = {0};
-		BYTE rgbResponse[MAX_RESPONSE_SIZE] = {0};
+		IfxTpmCommandBuffer* psCommandBuffer = DeviceManagement_GetCommandBuffer();
 		BYTE* pbBuffer = NULL;
-		INT32 nSizeRemaining = sizeof(rgbRequest);
-		UINT32 unSizeResponse = sizeof(rgbResponse);
+		INT32 nSizeRemaining = sizeof(psCommandBuffer->rgbRequest);
+		UINT32 unSizeResponse = sizeof(psCommandBuffer->rgbResponse);
 		UINT16 usTemp = 0;
 		// Request parameters
 		TPM_ST tag = TPM_TAG_RQU_COMMAND;
@@ -57,7 +56,7 @@ TSS_TPM_FieldUpgradeInfoRequest2(
 			break;
 
 		// Marshal the request
-		pbBuffer = rgbRequest;
+		pbBuffer = psCommandBuffer->rgbRequest;
 		unReturnValue = TSS_TPMI_ST_COMMAND_TAG_Marshal(&tag, &pbBuffer, &nSizeRemaining);
 		if (RC_SUCCESS != unReturnValue)
 			break;
@@ -75,19 +74,19 @@ TSS_TPM_FieldUpgradeInfoRequest2(
 			break;
 
 		// Update command size
-		unCommandSize = sizeof(rgbRequest) - nSizeRemaining;
-		pbBuffer = rgbRequest + sizeof(tag);
+		unCommandSize = sizeof(psCommandBuffer->rgbRequest) - nSizeRemaining;
+		pbBuffer = psCommandBuffer->rgbRequest + sizeof(tag);
 		unReturnValue = TSS_UINT32_Marshal(&unCommandSize, &pbBuffer, &nSizeRemaining);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
 		// Transmit the command over TDDL
-		unReturnValue = DeviceManagement_Transmit(rgbRequest, unCommandSize, rgbResponse, &unSizeResponse);
+		unReturnValue = DeviceManagement_Transmit(psCommandBuffer->rgbRequest, unCommandSize, psCommandBuffer->rgbResponse, &unSizeResponse);
 		if (TPM_RC_SUCCESS != unReturnValue)
 			break;
 
 		// Unmarshal the response
-		pbBuffer = rgbResponse;
+		pbBuffer = psCommandBuffer->rgbResponse;
 		nSizeRemaining = unSizeResponse;
 		unReturnValue = TSS_TPM_ST_Unmarshal(&tag, &pbBuffer, &nSizeRemaining);
 		if (TPM_RC_SUCCESS != unReturnValue)
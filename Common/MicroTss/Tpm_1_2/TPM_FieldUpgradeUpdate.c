@@ -18,11 +18,12 @@
 #include "TPM_Types.h"
 
 /**
- *	@brief		Calls TPM_Fieldupgrade.
- *	@details	Transmits the TPM1.2 command TPM_Fieldupgrade with the given data block.
+ *	@brief		Marshals TPM_Fieldupgrade.
+ *	@details	Marshals the TPM1.2 command TPM_Fieldupgrade with the given data block into a request frame.
  *
  *	@param		PpbFieldUpgradeBlock		Pointer on data block to be sent
  *	@param		PunFieldUpgradeBlockSize	Size of data block to be sent in bytes
+ *	@param		PpFrame						Receives the marshalled request
  *
  *	@retval		RC_SUCCESS					The operation completed successfully.
  *	@retval		RC_E_FAIL					An unexpected error occurred.
@@ -30,19 +31,17 @@
  */
 _Check_return_
 unsigned int
-TSS_TPM_FieldUpgradeUpdate(
-	_In_bytecount_(PunFieldUpgradeBlockSize)	const BYTE*		PpbFieldUpgradeBlock,
-	_In_										UINT16			PunFieldUpgradeBlockSize)
+TSS_TPM_FieldUpgradeUpdate_Marshal(
+	_In_bytecount_(PunFieldUpgradeBlockSize)	const BYTE*						PpbFieldUpgradeBlock,
+	_In_										UINT16							PunFieldUpgradeBlockSize,
+	_Out_										IfxFieldUpgradeUpdateFrame*		PpFrame)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 
 	do
 	{
-		BYTE rgbRequest[MAX_COMMAND_SIZE] = {0};
-		BYTE rgbResponse[MAX_RESPONSE_SIZE] = {0};
 		BYTE* pbBuffer = NULL;
-		INT32 nSizeRemaining = sizeof(rgbRequest);
-		UINT32 unSizeResponse = sizeof(rgbResponse);
+		INT32 nSizeRemaining = sizeof(PpFrame->rgbRequest);
 		// Request parameters
 		TPM_ST tag = TPM_TAG_RQU_COMMAND;
 		UINT32 unCommandSize = 0;
@@ -50,12 +49,11 @@ TSS_TPM_FieldUpgradeUpdate(
 		BYTE* pbLRCStart = NULL;
 		SubCmd_d subCommandCode = TPM_FieldUpgradeUpdate;
 		BYTE bLRC = 0;
-		// Response parameters
-		UINT32 unResponseSize = 0;
-		TPM_RC responseCode = TPM_RC_SUCCESS;
+
+		PpFrame->unRequestSize = 0;
 
 		// Marshal the request
-		pbBuffer = rgbRequest;
+		pbBuffer = PpFrame->rgbRequest;
 		unReturnValue = TSS_TPMI_ST_COMMAND_TAG_Marshal(&tag, &pbBuffer, &nSizeRemaining);
 		if (RC_SUCCESS != unReturnValue)
 			break;
@@ -81,20 +79,48 @@ TSS_TPM_FieldUpgradeUpdate(
 			break;
 
 		// Update command size
-		unCommandSize = sizeof(rgbRequest) - nSizeRemaining;
-		pbBuffer = rgbRequest + sizeof(tag);
+		unCommandSize = sizeof(PpFrame->rgbRequest) - nSizeRemaining;
+		pbBuffer = PpFrame->rgbRequest + sizeof(tag);
 		unReturnValue = TSS_UINT32_Marshal(&unCommandSize, &pbBuffer, &nSizeRemaining);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
-		// Transmit the command over TDDL
-		unReturnValue = DeviceManagement_Transmit(rgbRequest, unCommandSize, rgbResponse, &unSizeResponse);
-		if (TPM_RC_SUCCESS != unReturnValue)
-			break;
+		PpFrame->unRequestSize = unCommandSize;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Unmarshals the TPM_Fieldupgrade response.
+ *	@details	Checks the tag, size and return code of a TPM_Fieldupgrade response.
+ *
+ *	@param		PrgbResponse				Pointer on the response
+ *	@param		PunResponseSize				Size of the response in bytes
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_TPM_MASK					The TPM returned an error code (combined with RC_TPM_MASK).
+ *	@retval		...							Error codes from Micro TSS functions
+ */
+_Check_return_
+static
+unsigned int
+TSS_TPM_FieldUpgradeUpdate_Unmarshal(
+	_In_bytecount_(PunResponseSize)	const BYTE*		PrgbResponse,
+	_In_							UINT32			PunResponseSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		BYTE* pbBuffer = (BYTE*)PrgbResponse;
+		INT32 nSizeRemaining = PunResponseSize;
+		// Response parameters
+		TPM_ST tag = 0;
+		UINT32 unResponseSize = 0;
+		TPM_RC responseCode = TPM_RC_SUCCESS;
 
-		// Unmarshal the response
-		pbBuffer = rgbResponse;
-		nSizeRemaining = unSizeResponse;
 		unReturnValue = TSS_TPM_ST_Unmarshal(&tag, &pbBuffer, &nSizeRemaining);
 		if (TPM_RC_SUCCESS != unReturnValue)
 			break;
@@ -112,5 +138,96 @@ TSS_TPM_FieldUpgradeUpdate(
 	}
 	WHILE_FALSE_END;
 
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Sends TPM_Fieldupgrade.
+ *	@details	Submits a marshalled TPM1.2 command TPM_Fieldupgrade to the TPM without waiting for the response.
+ *				The frame must not be modified until TSS_TPM_FieldUpgradeUpdate_Receive returns.
+ *
+ *	@param		PpFrame						Request frame marshalled with TSS_TPM_FieldUpgradeUpdate_Marshal
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		...							Error codes from DeviceManagement_Send
+ */
+_Check_return_
+unsigned int
+TSS_TPM_FieldUpgradeUpdate_Send(
+	_In_	const IfxFieldUpgradeUpdateFrame*	PpFrame)
+{
+	return DeviceManagement_Send(PpFrame->rgbRequest, PpFrame->unRequestSize);
+}
+
+/**
+ *	@brief		Receives the TPM_Fieldupgrade response.
+ *	@details	Waits for the response of the command submitted with TSS_TPM_FieldUpgradeUpdate_Send and checks it.
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
+ *	@retval		...							Error codes from Micro TSS functions
+ */
+_Check_return_
+unsigned int
+TSS_TPM_FieldUpgradeUpdate_Receive()
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		IfxTpmCommandBuffer* psCommandBuffer = DeviceManagement_GetCommandBuffer();
+		UINT32 unSizeResponse = sizeof(psCommandBuffer->rgbResponse);
+
+		unReturnValue = DeviceManagement_Receive(psCommandBuffer->rgbResponse, &unSizeResponse);
+		if (TPM_RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = TSS_TPM_FieldUpgradeUpdate_Unmarshal(psCommandBuffer->rgbResponse, unSizeResponse);
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Calls TPM_Fieldupgrade.
+ *	@details	Transmits the TPM1.2 command TPM_Fieldupgrade with the given data block.
+ *
+ *	@param		PpbFieldUpgradeBlock		Pointer on data block to be sent
+ *	@param		PunFieldUpgradeBlockSize	Size of data block to be sent in bytes
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
+ *	@retval		...							Error codes from Micro TSS functions
+ */
+_Check_return_
+unsigned int
+TSS_TPM_FieldUpgradeUpdate(
+	_In_bytecount_(PunFieldUpgradeBlockSize)	const BYTE*		PpbFieldUpgradeBlock,
+	_In_										UINT16			PunFieldUpgradeBlockSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		IfxFieldUpgradeUpdateFrame sFrame;
+		IfxTpmCommandBuffer* psCommandBuffer = DeviceManagement_GetCommandBuffer();
+		UINT32 unSizeResponse = sizeof(psCommandBuffer->rgbResponse);
+
+		// Marshal the request
+		unReturnValue = TSS_TPM_FieldUpgradeUpdate_Marshal(PpbFieldUpgradeBlock, PunFieldUpgradeBlockSize, &sFrame);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		// Transmit the command over TDDL
+		unReturnValue = DeviceManagement_Transmit(sFrame.rgbRequest, sFrame.unRequestSize, psCommandBuffer->rgbResponse, &unSizeResponse);
+		if (TPM_RC_SUCCESS != unReturnValue)
+			break;
+
+		// Unmarshal the response
+		unReturnValue = TSS_TPM_FieldUpgradeUpdate_Unmarshal(psCommandBuffer->rgbResponse, unSizeResponse);
+	}
+	WHILE_FALSE_END;
+
 	return unReturnValue;
 }
\ No newline at end of file
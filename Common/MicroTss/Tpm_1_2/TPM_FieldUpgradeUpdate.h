@@ -26,6 +26,64 @@
 extern "C" {
 #endif
 
+/**
+ *	@brief		Marshalled TPM_Fieldupgrade request
+ *	@details	Holds a TPM_Fieldupgrade command so that the next block can be prepared while the former one is processed by the TPM.
+ */
+typedef struct tdIfxFieldUpgradeUpdateFrame
+{
+	/// Request bytes
+	BYTE	rgbRequest[MAX_COMMAND_SIZE];
+	/// Size of the request in bytes
+	UINT32	unRequestSize;
+} IfxFieldUpgradeUpdateFrame;
+
+/**
+ *	@brief		Marshals TPM_Fieldupgrade.
+ *	@details	Marshals the TPM1.2 command TPM_Fieldupgrade with the given data block into a request frame.
+ *
+ *	@param		PpbFieldUpgradeBlock		Pointer on data block to be sent
+ *	@param		PunFieldUpgradeBlockSize	Size of data block to be sent in bytes
+ *	@param		PpFrame						Receives the marshalled request
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
+ *	@retval		...							Error codes from Micro TSS functions
+ */
+_Check_return_
+unsigned int
+TSS_TPM_FieldUpgradeUpdate_Marshal(
+	_In_bytecount_(PunFieldUpgradeBlockSize)	const BYTE*						PpbFieldUpgradeBlock,
+	_In_										UINT16							PunFieldUpgradeBlockSize,
+	_Out_										IfxFieldUpgradeUpdateFrame*		PpFrame);
+
+/**
+ *	@brief		Sends TPM_Fieldupgrade.
+ *	@details	Submits a marshalled TPM1.2 command TPM_Fieldupgrade to the TPM without waiting for the response.
+ *				The frame must not be modified until TSS_TPM_FieldUpgradeUpdate_Receive returns.
+ *
+ *	@param		PpFrame						Request frame marshalled with TSS_TPM_FieldUpgradeUpdate_Marshal
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		...							Error codes from DeviceManagement_Send
+ */
+_Check_return_
+unsigned int
+TSS_TPM_FieldUpgradeUpdate_Send(
+	_In_	const IfxFieldUpgradeUpdateFrame*	PpFrame);
+
+/**
+ *	@brief		Receives the TPM_Fieldupgrade response.
+ *	@details	Waits for the response of the command submitted with TSS_TPM_FieldUpgradeUpdate_Send and checks it.
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
+ *	@retval		...							Error codes from Micro TSS functions
+ */
+_Check_return_
+unsigned int
+TSS_TPM_FieldUpgradeUpdate_Receive();
+
 /**
  *	@brief		Calls TPM_Fieldupgrade.
  *	@details	Transmits the TPM1.2 command TPM_Fieldupgrade with the given data block.
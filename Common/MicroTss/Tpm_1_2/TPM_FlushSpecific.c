@@ -41,11 +41,10 @@ TSS_TPM_FlushSpecific(
 	unsigned int unReturnValue = RC_SUCCESS;
 	do
 	{
-		BYTE rgbRequest[MAX_COMMAND_SIZE] = {0};
-		BYTE rgbResponse[MAX_RESPONSE_SIZE] = {0};
+		IfxTpmCommandBuffer* psCommandBuffer = DeviceManagement_GetCommandBuffer();
 		BYTE* pbBuffer = NULL;
-		INT32 nSizeRemaining = sizeof(rgbRequest);
-		INT32 nSizeResponse = sizeof(rgbResponse);
+		INT32 nSizeRemaining = sizeof(psCommandBuffer->rgbRequest);
+		INT32 nSizeResponse = sizeof(psCommandBuffer->rgbResponse);
 		// Request parameters
 		TPM_TAG tag = TPM_TAG_RQU_COMMAND;
 		UINT32 unCommandSize = 0;
@@ -55,7 +54,7 @@ TSS_TPM_FlushSpecific(
 		TPM_RESULT responseCode = TPM_RC_SUCCESS;
 
 		// Marshal the request
-		pbBuffer = rgbRequest;
+		pbBuffer = psCommandBuffer->rgbRequest;
 		unReturnValue = TSS_TPM_TAG_Marshal(&tag, &pbBuffer, &nSizeRemaining);
 		if (RC_SUCCESS != unReturnValue)
 			break;
@@ -73,20 +72,20 @@ TSS_TPM_FlushSpecific(
 			break;
 
 		// Overwrite unCommandSize
-		unCommandSize = sizeof(rgbRequest) - nSizeRemaining;
-		pbBuffer = rgbRequest + 2;
+		unCommandSize = sizeof(psCommandBuffer->rgbRequest) - nSizeRemaining;
+		pbBuffer = psCommandBuffer->rgbRequest + 2;
 		nSizeRemaining = 4;
 		unReturnValue = TSS_UINT32_Marshal(&unCommandSize, &pbBuffer, &nSizeRemaining);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
 		// Transmit the command over TDDL
-		unReturnValue = DeviceManagement_Transmit(rgbRequest, unCommandSize, rgbResponse, (unsigned int*)&nSizeResponse);
+		unReturnValue = DeviceManagement_Transmit(psCommandBuffer->rgbRequest, unCommandSize, psCommandBuffer->rgbResponse, (unsigned int*)&nSizeResponse);
 		if (TPM_RC_SUCCESS != unReturnValue)
 			break;
 
 		// Unmarshal the response
-		pbBuffer = rgbResponse;
+		pbBuffer = psCommandBuffer->rgbResponse;
 		nSizeRemaining = nSizeResponse;
 		unReturnValue = TSS_TPM_TAG_Unmarshal(&tag, &pbBuffer, &nSizeRemaining);
 		if (TPM_RC_SUCCESS != unReturnValue)
@@ -0,0 +1,307 @@
+#!/usr/bin/env python3
+# Copyright 2015 - 2017 Infineon Technologies AG ( www.infineon.com )
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+# 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+# 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Generates the marshal tables TPM2_MarshalTables.c/.h from the TPM2.0 type headers
+#
+# The script parses the structure and union definitions of TPM2_Types.h and TPM2_FieldUpgradeTypes.h and emits one
+# IfxMarshalTable per structure and one IfxMarshalUnion per union that is reachable from MARSHAL_TYPES. Fields are
+# marshalled in declaration order. The wire rules that cannot be derived from the C declarations (count fields, union
+# selectors and union arms) are listed below.
+#
+# Usage: python3 GenerateMarshalTables.py
+#
+
+import os
+import re
+import sys
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+TYPE_HEADERS = ['TPM2_Types.h', 'TPM2_FieldUpgradeTypes.h']
+OUTPUT_NAME = 'TPM2_MarshalTables'
+
+# Structures and unions marshalled through the table driven engine
+MARSHAL_TYPES = [
+	'TPM2B_DIGEST', 'TPM2B_MAX_BUFFER', 'TPM2B_TIMEOUT', 'TPM2B_ENCRYPTED_SECRET',
+	'TPMS_PCR_SELECTION', 'TPMT_TK_AUTH', 'TPMS_ALG_PROPERTY', 'TPMS_TAGGED_PROPERTY', 'TPMS_TAGGED_PCR_SELECT',
+	'TPML_CC', 'TPML_CCA', 'TPML_HANDLE', 'TPML_PCR_SELECTION', 'TPML_ALG_PROPERTY', 'TPML_TAGGED_TPM_PROPERTY',
+	'TPML_TAGGED_PCR_PROPERTY', 'TPML_ECC_CURVE', 'TPMS_CAPABILITY_DATA', 'TPMT_SYM_DEF',
+	'AuthorizationCommandData', 'AcknowledgmentResponseData',
+	'sMessageDigest_d', 'sFirmwarePackage_d', 'sFirmwarePackages_d', 'sVersions_d', 'sSignedAttributes_d',
+	'sSignerInfo_d', 'sSignedData_d', 'sSecurityModuleLogic_d', 'sKeyList_d', 'sSecurityModuleLogicInfo_d',
+	'sSecurityModuleLogicInfo2_d', 'TPML_MAX_BUFFER',
+]
+
+# Arrays directly following one of these fields are counted by it (TPM2B_* and TPML_* convention)
+COUNT_FIELD_NAMES = ['size', 'count', 'sizeofSelect']
+
+# Count fields that do not follow the convention: 'structure.array' -> count field
+# A trailing '!' requires the count to be equal to the array size.
+COUNT_FIELDS = {
+	'sMessageDigest_d.rgbMessageDigest': 'wSize',
+	'sFirmwarePackages_d.FirmwarePackage': 'wEntries',
+	'sKeyList_d.internal2': 'wEntries!',
+	'sKeyList_d.DecryptKeyId': 'wEntries!',
+}
+
+# Union selectors: 'structure.union field' -> selector field
+SELECTORS = {
+	'TPMS_CAPABILITY_DATA.data': 'capability',
+	'TPMT_SYM_DEF.keyBits': 'algorithm',
+	'TPMT_SYM_DEF.mode': 'algorithm',
+}
+
+# Union arms: union -> [(selector value, union member or 'UNION.member' of an overlaid union or None for no data)]
+UNION_ARMS = {
+	'TPMU_CAPABILITIES': [
+		('TPM_CAP_ALGS', 'algorithms'),
+		('TPM_CAP_HANDLES', 'handles'),
+		('TPM_CAP_COMMANDS', 'command'),
+		('TPM_CAP_PP_COMMANDS', 'ppCommands'),
+		('TPM_CAP_AUDIT_COMMANDS', 'auditCommands'),
+		('TPM_CAP_PCRS', 'assignedPCR'),
+		('TPM_CAP_TPM_PROPERTIES', 'tpmProperties'),
+		('TPM_CAP_PCR_PROPERTIES', 'pcrProperties'),
+		('TPM_CAP_ECC_CURVES', 'eccCurves'),
+		('TPM_CAP_VENDOR_PROPERTY', 'TPMU_VENDOR_CAPABILITY.vendorData'),
+	],
+	'TPMU_SYM_KEY_BITS': [
+		('TPM_ALG_AES', 'aes'),
+		('TPM_ALG_SM4', 'sm4'),
+		('TPM_ALG_CAMELLIA', 'camellia'),
+		('TPM_ALG_XOR', 'xor'),
+		('TPM_ALG_NULL', None),
+	],
+	'TPMU_SYM_MODE': [
+		('TPM_ALG_AES', 'aes'),
+		('TPM_ALG_SM4', 'sm4'),
+		('TPM_ALG_CAMELLIA', 'camellia'),
+		('TPM_ALG_NULL', None),
+	],
+}
+
+# Wire size of the base integer types
+INTEGER_TYPES = {
+	'uint8_t': 1, 'int8_t': 1, 'UINT8': 1, 'INT8': 1, 'BYTE': 1,
+	'uint16_t': 2, 'int16_t': 2, 'UINT16': 2, 'INT16': 2,
+	'uint32_t': 4, 'int32_t': 4, 'UINT32': 4, 'INT32': 4, 'BOOL': 4,
+}
+FIELD_TYPES = {1: 'TSS_FIELD_UINT8', 2: 'TSS_FIELD_UINT16', 4: 'TSS_FIELD_UINT32'}
+
+
+class Field:
+	def __init__(self, strType, strName, strBound, nBits):
+		self.strType = strType
+		self.strName = strName
+		self.strBound = strBound
+		self.nBits = nBits
+
+
+class Aggregate:
+	def __init__(self, strKind, strName, rgFields):
+		self.strKind = strKind
+		self.strName = strName
+		self.rgFields = rgFields
+
+	def field(self, strName):
+		for sField in self.rgFields:
+			if sField.strName == strName:
+				return sField
+		fail('%s has no field %s' % (self.strName, strName))
+
+
+def fail(strMessage):
+	sys.stderr.write('GenerateMarshalTables.py: %s\n' % strMessage)
+	sys.exit(1)
+
+
+def parse_headers():
+	mapAliases = {}
+	mapAggregates = {}
+	for strHeader in TYPE_HEADERS:
+		with open(os.path.join(SCRIPT_DIR, strHeader), encoding='utf-8-sig') as sFile:
+			strText = sFile.read()
+		strText = re.sub(r'/\*.*?\*/', ' ', strText, flags=re.S)
+		strText = re.sub(r'//[^\n]*', ' ', strText)
+		for sMatch in re.finditer(r'typedef\s+(\w+)\s+(\w+)\s*;', strText):
+			mapAliases[sMatch.group(2)] = sMatch.group(1)
+		for sMatch in re.finditer(r'typedef\s+(struct|union)\s*\w*\s*\{([^{}]*)\}\s*(\w+)\s*;', strText):
+			rgFields = []
+			for strDecl in sMatch.group(2).split(';'):
+				strDecl = ' '.join(strDecl.split())
+				if not strDecl:
+					continue
+				sDecl = re.match(r'^(?:unsigned\s+)?(\w+)\s+(\w+)\s*(?:\[(.+)\])?\s*(?::\s*(\d+))?$', strDecl)
+				if sDecl is None:
+					fail('cannot parse declaration "%s" in %s' % (strDecl, sMatch.group(3)))
+				rgFields.append(Field(sDecl.group(1), sDecl.group(2), sDecl.group(3), int(sDecl.group(4) or 0)))
+			mapAggregates[sMatch.group(3)] = Aggregate(sMatch.group(1), sMatch.group(3), rgFields)
+	return mapAliases, mapAggregates
+
+
+class Generator:
+	def __init__(self, mapAliases, mapAggregates):
+		self.mapAliases = mapAliases
+		self.mapAggregates = mapAggregates
+		self.rgOrder = []
+
+	def resolve(self, strType):
+		while strType not in INTEGER_TYPES and strType not in self.mapAggregates:
+			if strType not in self.mapAliases:
+				fail('unknown type %s' % strType)
+			strType = self.mapAliases[strType]
+		return strType
+
+	def integer_size(self, strType):
+		strType = self.resolve(strType)
+		if strType in INTEGER_TYPES:
+			return INTEGER_TYPES[strType]
+		sAggregate = self.mapAggregates[strType]
+		nBits = sum(sField.nBits for sField in sAggregate.rgFields)
+		if sAggregate.strKind == 'struct' and all(sField.nBits for sField in sAggregate.rgFields) and nBits // 8 in FIELD_TYPES:
+			return nBits // 8
+		return 0
+
+	def collect(self, strType):
+		strType = self.resolve(strType)
+		if strType in self.rgOrder or self.integer_size(strType):
+			return
+		self.rgOrder.append(strType)
+		sAggregate = self.mapAggregates[strType]
+		if sAggregate.strKind == 'union':
+			if strType not in UNION_ARMS:
+				fail('no union arms defined for %s' % strType)
+			for strSelector, strMember in UNION_ARMS[strType]:
+				if strMember is not None:
+					self.collect(self.arm_member(sAggregate, strMember)[1].strType)
+		else:
+			for sField in sAggregate.rgFields:
+				self.collect(sField.strType)
+
+	def arm_member(self, sUnion, strMember):
+		if '.' in strMember:
+			strOverlay, strMember = strMember.split('.')
+			return strOverlay, self.mapAggregates[strOverlay].field(strMember)
+		return sUnion.strName, sUnion.field(strMember)
+
+	def table_name(self, strType):
+		strType = self.resolve(strType)
+		strName = 'g_s' + (strType[1:] if re.match(r'^s[A-Z]', strType) else strType)
+		if self.mapAggregates[strType].strKind == 'union':
+			return strName + '_Union'
+		return strName + '_Table'
+
+	def element(self, sField):
+		nSize = self.integer_size(sField.strType)
+		if nSize:
+			if sField.strBound is not None and nSize != 4 and self.resolve(sField.strType) not in INTEGER_TYPES:
+				fail('array of bit field type %s is not supported' % sField.strType)
+			return FIELD_TYPES[nSize], 'NULL'
+		strType = self.resolve(sField.strType)
+		if self.mapAggregates[strType].strKind == 'union':
+			return 'TSS_FIELD_UNION', '&' + self.table_name(strType)
+		return 'TSS_FIELD_STRUCT', '&' + self.table_name(strType)
+
+	def field_entry(self, sAggregate, sField, strParent=None):
+		strOwner = strParent or sAggregate.strName
+		strType, strTable = self.element(sField)
+		strReferenceType, strReferenceOffset, strCount, strFlags = 'TSS_FIELD_EMPTY', '0', '1', '0'
+		strKey = '%s.%s' % (sAggregate.strName, sField.strName)
+		if sField.strBound is not None:
+			strCount = sField.strBound
+			strCountField = COUNT_FIELDS.get(strKey)
+			if strCountField is None:
+				nIndex = sAggregate.rgFields.index(sField)
+				if nIndex > 0 and sAggregate.rgFields[nIndex - 1].strName in COUNT_FIELD_NAMES:
+					strCountField = sAggregate.rgFields[nIndex - 1].strName
+			if strCountField is not None:
+				if strCountField.endswith('!'):
+					strCountField, strFlags = strCountField[:-1], 'TSS_FIELD_FLAG_EXACT_COUNT'
+				strReferenceType = FIELD_TYPES[self.integer_size(sAggregate.field(strCountField).strType)]
+				strReferenceOffset = 'offsetof(%s, %s)' % (strOwner, strCountField)
+		elif strType == 'TSS_FIELD_UNION':
+			if strKey not in SELECTORS:
+				fail('no selector defined for %s' % strKey)
+			strReferenceType = FIELD_TYPES[self.integer_size(sAggregate.field(SELECTORS[strKey]).strType)]
+			strReferenceOffset = 'offsetof(%s, %s)' % (strOwner, SELECTORS[strKey])
+		return '{ offsetof(%s, %s), %s, %s, %s, %s, sizeof(%s), %s, %s }' % (
+			strOwner, sField.strName, strType, strReferenceType, strReferenceOffset, strCount, sField.strType, strFlags, strTable)
+
+	def emit_source(self):
+		rgLines = ['#include "%s.h"' % OUTPUT_NAME, '']
+		for strType in self.rgOrder:
+			sAggregate = self.mapAggregates[strType]
+			if sAggregate.strKind == 'union':
+				rgLines.append('static const IfxMarshalUnionArm s_rgs%s_Arms[] =' % strType)
+				rgLines.append('{')
+				for strSelector, strMember in UNION_ARMS[strType]:
+					if strMember is None:
+						strEntry = '{ 0, TSS_FIELD_EMPTY, TSS_FIELD_EMPTY, 0, 0, 0, 0, NULL }'
+					else:
+						strOverlay, sField = self.arm_member(sAggregate, strMember)
+						strEntry = self.field_entry(self.mapAggregates[strOverlay], sField)
+					rgLines.append('\t{ %s, %s },' % (strSelector, strEntry))
+				rgLines.append('};')
+				rgLines.append('const IfxMarshalUnion %s = { %d, s_rgs%s_Arms };' % (self.table_name(strType), len(UNION_ARMS[strType]), strType))
+			else:
+				rgLines.append('static const IfxMarshalField s_rgs%s_Fields[] =' % strType)
+				rgLines.append('{')
+				for sField in sAggregate.rgFields:
+					rgLines.append('\t' + self.field_entry(sAggregate, sField) + ',')
+				rgLines.append('};')
+				rgLines.append('const IfxMarshalTable %s = { sizeof(%s), %d, s_rgs%s_Fields };' % (self.table_name(strType), strType, len(sAggregate.rgFields), strType))
+			rgLines.append('')
+		return rgLines
+
+	def emit_header(self):
+		rgLines = ['#pragma once', '', '#include "TPM2_MarshalTable.h"', '#include "TPM2_FieldUpgradeTypes.h"', '',
+			'#ifdef __cplusplus', 'extern "C" {', '#endif', '']
+		for strType in self.rgOrder:
+			if self.mapAggregates[strType].strKind == 'union':
+				rgLines.append('/// Marshal table of the %s union' % strType)
+				rgLines.append('extern const IfxMarshalUnion %s;' % self.table_name(strType))
+			else:
+				rgLines.append('/// Marshal table of the %s structure' % strType)
+				rgLines.append('extern const IfxMarshalTable %s;' % self.table_name(strType))
+		rgLines += ['', '#ifdef __cplusplus', '}', '#endif']
+		return rgLines
+
+
+def license_header(strFile, strBrief):
+	rgLicense = []
+	with open(os.path.join(SCRIPT_DIR, 'TPM2_FieldUpgradeMarshal.h'), encoding='utf-8-sig') as sFile:
+		for strLine in sFile.read().split('\n'):
+			if strLine.startswith(' *\t@copyright\tAll rights') or rgLicense:
+				rgLicense.append(strLine)
+				if strLine == ' */':
+					break
+	return ['/**', ' *\t@brief\t\t' + strBrief,
+		' *\t@details\tThis file is generated by GenerateMarshalTables.py from %s. Do not edit.' % ' and '.join(TYPE_HEADERS),
+		' *\t@file\t\t' + strFile,
+		' *\t@copyright\tCopyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )', ' *'] + rgLicense
+
+
+def write(strFile, strBrief, rgLines):
+	strText = '\n'.join(license_header(strFile, strBrief) + rgLines).rstrip('\n') + '\n'
+	with open(os.path.join(SCRIPT_DIR, strFile), 'w', encoding='utf-8-sig', newline='\n') as sFile:
+		sFile.write(strText)
+
+
+def main():
+	mapAliases, mapAggregates = parse_headers()
+	sGenerator = Generator(mapAliases, mapAggregates)
+	for strType in MARSHAL_TYPES:
+		sGenerator.collect(strType)
+	write(OUTPUT_NAME + '.h', 'Declares the generated marshal tables of the TPM2.0 structures', sGenerator.emit_header())
+	write(OUTPUT_NAME + '.c', 'Defines the generated marshal tables of the TPM2.0 structures', sGenerator.emit_source())
+
+
+if __name__ == '__main__':
+	main()
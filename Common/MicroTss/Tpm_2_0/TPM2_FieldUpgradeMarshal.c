@@ -16,6 +16,7 @@
 
 #include "TPM2_Marshal.h"
 #include "TPM2_FieldUpgradeMarshal.h"
+#include "TPM2_MarshalTables.h"
 #include "Platform.h"
 
 //********************************************************************************************************
@@ -80,27 +81,7 @@ TSS_sMessageDigest_d_Marshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Marshal wSize
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->wSize, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal rgbMessageDigest
-		unReturnValue = TSS_UINT8_Array_Marshal(PpSource->rgbMessageDigest, PprgbBuffer, PpnBufferSize, PpSource->wSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sMessageDigest_d_Table, PpSource, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -122,35 +103,7 @@ TSS_sMessageDigest_d_Unmarshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sMessageDigest_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Unmarshal wSize
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wSize, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal rgbMessageDigest
-		unReturnValue = TSS_UINT8_Array_Unmarshal(PpTarget->rgbMessageDigest, PprgbBuffer, PpnBufferSize, PpTarget->wSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sMessageDigest_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -176,31 +129,7 @@ TSS_sFirmwarePackage_d_Marshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Marshal FwPackageIdentifier_d (FwPackageIdentifier)
-		unReturnValue = TSS_UINT32_Marshal(&PpSource->FwPackageIdentifier, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal VersionNumber_d (Version)
-		unReturnValue = TSS_VersionNumber_d_Marshal(&PpSource->Version, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal VersionNumber_d (StaleVersion)
-		unReturnValue = TSS_VersionNumber_d_Marshal(&PpSource->StaleVersion, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sFirmwarePackage_d_Table, PpSource, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -222,38 +151,7 @@ TSS_sFirmwarePackage_d_Unmarshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sFirmwarePackage_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Unmarshal FwPackageIdentifier_d (FwPackageIdentifier)
-		unReturnValue = TSS_UINT32_Unmarshal(&PpTarget->FwPackageIdentifier, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal VersionNumber_d (Version)
-		unReturnValue = TSS_VersionNumber_d_Unmarshal(&PpTarget->Version, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal VersionNumber_d (StaleVersion)
-		unReturnValue = TSS_VersionNumber_d_Unmarshal(&PpTarget->StaleVersion, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sFirmwarePackage_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -279,30 +177,7 @@ TSS_sVersions_d_Marshal(
 	_Inout_	BYTE**			PprgbBuffer,
 	_Inout_	INT32*			PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Marshal(&PpSource->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal UINT16 (wEntries)
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->wEntries, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal VersionNumber_d (Version)
-		unReturnValue = TSS_VersionNumber_d_Array_Marshal(PpSource->Version, PprgbBuffer, PpnBufferSize, 8);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sVersions_d_Table, PpSource, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -324,38 +199,7 @@ TSS_sVersions_d_Unmarshal(
 	_Inout_	BYTE**			PprgbBuffer,
 	_Inout_	INT32*			PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sVersions_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal(&PpTarget->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal UINT16 (wEntries)
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wEntries, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal VersionNumber_d (Version)
-		unReturnValue = TSS_VersionNumber_d_Array_Unmarshal(PpTarget->Version, PprgbBuffer, PpnBufferSize, 8);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sVersions_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -381,62 +225,7 @@ TSS_sSignedAttributes_d_Marshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Marshal(PpSource->internal2, PprgbBuffer, PpnBufferSize, sizeof(PpSource->internal2));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal3, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal sMessageDigest_d (sMessageDigest)
-		unReturnValue = TSS_sMessageDigest_d_Marshal(&PpSource->sMessageDigest, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal sFirmwarePackage_d (sFirmwarePackage)
-		unReturnValue = TSS_sFirmwarePackage_d_Marshal(&PpSource->sFirmwarePackage, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Marshal(PpSource->internal6, PprgbBuffer, PpnBufferSize, sizeof(PpSource->internal6));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Marshal(PpSource->internal7, PprgbBuffer, PpnBufferSize, sizeof(PpSource->internal7));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Marshal(PpSource->internal8, PprgbBuffer, PpnBufferSize, sizeof(PpSource->internal8));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal DecryptKeyId_d (DecryptKeyId)
-		unReturnValue = TSS_DecryptKeyId_d_Marshal(&PpSource->DecryptKeyId, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Marshal(PpSource->internal10, PprgbBuffer, PpnBufferSize, sizeof(PpSource->internal10));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal sVersions_d (sVersions)
-		unReturnValue = TSS_sVersions_d_Marshal(&PpSource->sVersions, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Marshal(PpSource->internal12, PprgbBuffer, PpnBufferSize, sizeof(PpSource->internal12));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Marshal(PpSource->internal13, PprgbBuffer, PpnBufferSize, sizeof(PpSource->internal13));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sSignedAttributes_d_Table, PpSource, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -458,71 +247,7 @@ TSS_sSignedAttributes_d_Unmarshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sSignedAttributes_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal2, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal2));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal3, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sMessageDigest_d (sMessageDigest)
-		unReturnValue = TSS_sMessageDigest_d_Unmarshal(&PpTarget->sMessageDigest, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sFirmwarePackage_d (sFirmwarePackage)
-		unReturnValue = TSS_sFirmwarePackage_d_Unmarshal(&PpTarget->sFirmwarePackage, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal6, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal6));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal7, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal7));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal8, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal8));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal DecryptKeyId_d (DecryptKeyId)
-		unReturnValue = TSS_DecryptKeyId_d_Unmarshal(&PpTarget->DecryptKeyId, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal10, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal10));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sVersions_d (sVersions)
-		unReturnValue = TSS_sVersions_d_Unmarshal(&PpTarget->sVersions, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal12, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal12));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal13, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal13));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sSignedAttributes_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -548,44 +273,7 @@ TSS_sSignerInfo_d_Marshal(
 	_Inout_	BYTE**			PprgbBuffer,
 	_Inout_	INT32*			PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT32_Marshal(&PpSource->internal2, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal3, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal4, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal5, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal sSignedAttributes_d (sSignedAttributes)
-		unReturnValue = TSS_sSignedAttributes_d_Marshal(&PpSource->sSignedAttributes, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal7, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT8_Array_Marshal(PpSource->internal8, PprgbBuffer, PpnBufferSize, sizeof(PpSource->internal8));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sSignerInfo_d_Table, PpSource, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -607,53 +295,7 @@ TSS_sSignerInfo_d_Unmarshal(
 	_Inout_	BYTE**			PprgbBuffer,
 	_Inout_	INT32*			PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sSignerInfo_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT32_Unmarshal(&PpTarget->internal2, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal3, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal4, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal5, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sSignedAttributes_d (sSignedAttributes)
-		unReturnValue = TSS_sSignedAttributes_d_Unmarshal(&PpTarget->sSignedAttributes, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal7, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT8_Array_Unmarshal(PpTarget->internal8, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal8));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sSignerInfo_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 //--------------------------------------------------------------------------------------------------------
@@ -679,33 +321,7 @@ TSS_sSignedData_d_Marshal(
 	_Inout_	BYTE**			PprgbBuffer,
 	_Inout_	INT32*			PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->internal2, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal UINT16 (wSignerInfoSize)
-		unReturnValue = TSS_UINT16_Marshal(&PpSource->wSignerInfoSize, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Marshal sSignerInfo_d (sSignerInfo)
-		unReturnValue = TSS_sSignerInfo_d_Marshal(&PpSource->sSignerInfo, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sSignedData_d_Table, PpSource, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -727,42 +343,7 @@ TSS_sSignedData_d_Unmarshal(
 	_Inout_	BYTE**			PprgbBuffer,
 	_Inout_	INT32*			PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sSignedData_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal2, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal UINT16 (wSignerInfoSize)
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wSignerInfoSize, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sSignerInfo_d (sSignerInfo)
-		unReturnValue = TSS_sSignerInfo_d_Unmarshal(&PpTarget->sSignerInfo, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sSignedData_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -784,57 +365,7 @@ TSS_sSecurityModuleLogicInfo_d_Unmarshal(
 	_Inout_	BYTE**							PprgbBuffer,
 	_Inout_	INT32*							PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sSecurityModuleLogicInfo_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal UINT16 (wMaxDataSize)
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wMaxDataSize, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sSecurityModuleLogic_d (sSecurityModuleLogic)
-		unReturnValue = TSS_sSecurityModuleLogic_d_Unmarshal(&PpTarget->sSecurityModuleLogic, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal SecurityModuleStatus_d (SecurityModuleStatus)
-		unReturnValue = TSS_SecurityModuleStatus_d_Unmarshal(&PpTarget->SecurityModuleStatus, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sFirmwarePackage_d (sProcessFirmwarePackage)
-		unReturnValue = TSS_sFirmwarePackage_d_Unmarshal(&PpTarget->sProcessFirmwarePackage, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal6, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal7, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal7));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal UINT16 (wFieldUpgradeCounter)
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wFieldUpgradeCounter, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sSecurityModuleLogicInfo_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -856,61 +387,7 @@ TSS_sSecurityModuleLogicInfo2_d_Unmarshal(
 	_Inout_	BYTE**							PprgbBuffer,
 	_Inout_	INT32*							PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sSecurityModuleLogicInfo2_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal UINT16 (wMaxDataSize)
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wMaxDataSize, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sSecurityModuleLogic_d (sSecurityModuleLogic)
-		unReturnValue = TSS_sSecurityModuleLogic_d_Unmarshal(&PpTarget->sSecurityModuleLogic, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal SecurityModuleStatus_d (SecurityModuleStatus)
-		unReturnValue = TSS_SecurityModuleStatus_d_Unmarshal(&PpTarget->SecurityModuleStatus, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sFirmwarePackage_d (sProcessFirmwarePackage)
-		unReturnValue = TSS_sFirmwarePackage_d_Unmarshal(&PpTarget->sProcessFirmwarePackage, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal6, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal7, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal7));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal UINT16 (wFieldUpgradeCounter)
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wFieldUpgradeCounter, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sKeyList_d (sKeyList)
-		unReturnValue = TSS_sKeyList_d_Unmarshal(&PpTarget->sKeyList, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sSecurityModuleLogicInfo2_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -932,57 +409,7 @@ TSS_sKeyList_d_Unmarshal(
 	_Inout_	BYTE**		PprgbBuffer,
 	_Inout_	INT32*		PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sKeyList_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Unmarshal UINT16 (wEntries)
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wEntries, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		if (PpTarget->wEntries != 4)
-		{
-			unReturnValue = RC_E_FAIL;
-			break;
-		}
-		{
-			unsigned int unCounter = 0;
-			for (unCounter = 0; unCounter < PpTarget->wEntries; unCounter++)
-			{
-				unReturnValue = TSS_UINT32_Unmarshal(&PpTarget->internal2[unCounter], PprgbBuffer, PpnBufferSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-			if (RC_SUCCESS != unReturnValue)
-				break;
-			for (unCounter = 0; unCounter < PpTarget->wEntries; unCounter++)
-			{
-				// Unmarshal DecryptKeyId_d (DecryptKeyId)
-				unReturnValue = TSS_DecryptKeyId_d_Unmarshal(&PpTarget->DecryptKeyId[unCounter], PprgbBuffer, PpnBufferSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-			if (RC_SUCCESS != unReturnValue)
-				break;
-		}
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sKeyList_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -1004,45 +431,7 @@ TSS_sSecurityModuleLogic_d_Unmarshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sSecurityModuleLogic_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->internal1, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT32_Unmarshal(&PpTarget->internal2, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal(PpTarget->internal3, PprgbBuffer, PpnBufferSize, sizeof(PpTarget->internal3));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sFirmwarePackage_d (sBootloaderFirmwarePackage)
-		unReturnValue = TSS_sFirmwarePackage_d_Unmarshal(&PpTarget->sBootloaderFirmwarePackage, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Unmarshal sFirmwarePackages_d (sFirmwareConfiguration)
-		unReturnValue = TSS_sFirmwarePackages_d_Unmarshal(&PpTarget->sFirmwareConfiguration, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sSecurityModuleLogic_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -1064,43 +453,7 @@ TSS_sFirmwarePackages_d_Unmarshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(sFirmwarePackages_d));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Unmarshal UINT16 (wEntries)
-		unReturnValue = TSS_UINT16_Unmarshal(&PpTarget->wEntries, PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-
-		if (PpTarget->wEntries > 0)
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PpTarget->wEntries; nPos++)
-			{
-				// Unmarshal sFirmwarePackage_d (FirmwarePackage)
-				unReturnValue = TSS_sFirmwarePackage_d_Unmarshal((sFirmwarePackage_d*)&PpTarget->FirmwarePackage[nPos], PprgbBuffer, PpnBufferSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sFirmwarePackages_d_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -1122,34 +475,7 @@ TSS_TPML_MAX_BUFFER_Unmarshal(
 	_Inout_	BYTE **PprgbBuffer,
 	_Inout_	INT32 *PpnBufferSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_MAX_BUFFER));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnBufferSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnBufferSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-
-		unReturnValue = TSS_TPM2B_MAX_BUFFER_Array_Unmarshal((TPM2B_MAX_BUFFER*)&PpTarget->buffer, PprgbBuffer, PpnBufferSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_MAX_BUFFER_Table, PpTarget, PprgbBuffer, PpnBufferSize);
 }
 
 /**
@@ -1169,5 +495,5 @@ TSS_TPMU_VENDOR_CAPABILITY_Unmarshal(
 	_Inout_	BYTE **PprgbBuffer,
 	_Inout_	INT32 *PpnBufferSize)
 {
-	return TSS_TPML_MAX_BUFFER_Unmarshal((TPML_MAX_BUFFER *) & ((TPMU_VENDOR_CAPABILITY*)PpTarget)->vendorData, PprgbBuffer, PpnBufferSize);
+	return TSS_Table_Unmarshal(&g_sTPML_MAX_BUFFER_Table, &((TPMU_VENDOR_CAPABILITY*)PpTarget)->vendorData, PprgbBuffer, PpnBufferSize);
 }
@@ -61,6 +61,33 @@
 #include "Platform.h"
 #include "../StdInclude.h"
 #include "TPM2_FieldUpgradeMarshal.h"
+#include "TPM2_MarshalTables.h"
+
+/**
+ *	@brief		Checks the buffer size for an array
+ *	@details	Checks once for the whole array that the buffer holds the given number of elements, so the array
+ *				functions can copy or convert all elements in one pass.
+ *
+ *	@param		PnCount			Number of elements
+ *	@param		PnElementSize	Size of one element in the buffer in bytes
+ *	@param		PnSize			Number of octets remaining in the buffer
+ *
+ *	@retval		RC_SUCCESS				The buffer is large enough or the array is empty.
+ *	@retval		RC_E_BUFFER_TOO_SMALL	The buffer is too small.
+ */
+_Check_return_
+static
+unsigned int
+TSS_Array_CheckSize(
+	_In_	INT32	PnCount,
+	_In_	INT32	PnElementSize,
+	_In_	INT32	PnSize)
+{
+	if (PnCount > 0 && (PnSize < 0 || PnCount > PnSize / PnElementSize))
+		return RC_E_BUFFER_TOO_SMALL;
+	return RC_SUCCESS;
+}
+
 /**
  *	@brief		Marshals a UINT8 type
  *	@details	Refer to: Table 3 - Definition of Base Types
@@ -173,23 +200,26 @@ TSS_UINT8_Array_Marshal(
 	_In_	INT32			PnCount)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
-	// Check parameters
-	if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-	{
-		unReturnValue = RC_E_BAD_PARAMETER;
-	}
-	else
+	do
 	{
-		INT32 nPos;
-		unReturnValue = RC_SUCCESS;
-		// Marshal byte by byte to the buffer
-		for (nPos = 0; nPos < PnCount; nPos++)
+		// Check parameters
+		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
 		{
-			unReturnValue = TSS_UINT8_Marshal(&PpSource[nPos], PprgbBuffer, PpnSize);
-			if (RC_SUCCESS != unReturnValue)
-				break;
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
 		}
+		// Check size once for the whole array
+		unReturnValue = TSS_Array_CheckSize(PnCount, 1, *PpnSize);
+		if (RC_SUCCESS != unReturnValue || PnCount <= 0)
+			break;
+		// Copy the whole array to the buffer
+		unReturnValue = Platform_MemoryCopy(*PprgbBuffer, (unsigned int)*PpnSize, PpSource, (unsigned int)PnCount);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		*PprgbBuffer += PnCount;
+		*PpnSize -= PnCount;
 	}
+	WHILE_FALSE_END;
 	return unReturnValue;
 }
 
@@ -231,15 +261,16 @@ TSS_UINT8_Array_Unmarshal(
 			unReturnValue = RC_E_BAD_PARAMETER;
 			break;
 		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_UINT8_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
+		// Check size once for the whole array
+		unReturnValue = TSS_Array_CheckSize(PnCount, 1, *PpnSize);
+		if (RC_SUCCESS != unReturnValue || PnCount <= 0)
+			break;
+		// Copy the whole array from the buffer
+		unReturnValue = Platform_MemoryCopy(PpTarget, (unsigned int)PnCount, *PprgbBuffer, (unsigned int)PnCount);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		*PprgbBuffer += PnCount;
+		*PpnSize -= PnCount;
 	}
 	WHILE_FALSE_END;
 	return unReturnValue;
@@ -307,25 +338,7 @@ TSS_BYTE_Array_Marshal(
 	_Inout_	INT32*			PpnSize,
 	_In_	INT32			PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	// Check parameters
-	if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-	{
-		unReturnValue = RC_E_BAD_PARAMETER;
-	}
-	else
-	{
-		INT32 nPos;
-		unReturnValue = RC_SUCCESS;
-		// Marshal byte by byte to the buffer
-		for (nPos = 0; nPos < PnCount; nPos++)
-		{
-			unReturnValue = TSS_BYTE_Marshal(&PpSource[nPos], PprgbBuffer, PpnSize);
-			if (RC_SUCCESS != unReturnValue)
-				break;
-		}
-	}
-	return unReturnValue;
+	return TSS_UINT8_Array_Marshal((const UINT8*) PpSource, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -348,36 +361,7 @@ TSS_BYTE_Array_Unmarshal(
 	_Inout_	INT32*		PpnSize,
 	_In_	INT32		PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(BYTE));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_BYTE_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_UINT8_Array_Unmarshal((UINT8*) PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -513,6 +497,109 @@ TSS_UINT16_Unmarshal(
 	return unReturnValue;
 }
 
+/**
+ *	@brief		Marshals a UINT16 array
+ *	@details	Refer to: Table 3 - Definition of Base Types
+ *
+ *	@param		PpSource	Location containing the value that is to be marshaled in to the designated buffer
+ *	@param		PprgbBuffer	Location in the output buffer where the first octet of the TYPE is to be placed
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_UINT16_Array_Marshal(
+	_In_	const UINT16*		PpSource,
+	_Inout_	BYTE**				PprgbBuffer,
+	_Inout_	INT32*				PpnSize,
+	_In_	INT32				PnCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	do
+	{
+		// Check parameters
+		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		// Check size once for the whole array
+		unReturnValue = TSS_Array_CheckSize(PnCount, 2, *PpnSize);
+		if (RC_SUCCESS != unReturnValue || PnCount <= 0)
+			break;
+		{
+			BYTE* pbBuffer = *PprgbBuffer;
+			INT32 nPos;
+			// Convert the elements to big endian in one pass
+			for (nPos = 0; nPos < PnCount; nPos++, pbBuffer += 2)
+				UINT16_TO_BYTE_ARRAY(PpSource[nPos], pbBuffer);
+			*PprgbBuffer = pbBuffer;
+			*PpnSize -= PnCount * 2;
+		}
+	}
+	WHILE_FALSE_END;
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Unmarshals a UINT16 array
+ *	@details	Refer to: Table 3 - Definition of Base Types
+ *
+ *	@param		PpTarget	Location into which the data from **PprgbBuffer is placed
+ *	@param		PprgbBuffer	Location in the output buffer containing the most significant octet (MSO) of *PpTarget
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_UINT16_Array_Unmarshal(
+	_Out_	UINT16*		PpTarget,
+	_Inout_	BYTE**		PprgbBuffer,
+	_Inout_	INT32*		PpnSize,
+	_In_	INT32		PnCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	do
+	{
+		// Check and initialize _Out_ parameters
+		if (NULL == PpTarget)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(UINT16));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		// Check _Inout_ parameters
+		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		// Check size once for the whole array
+		unReturnValue = TSS_Array_CheckSize(PnCount, 2, *PpnSize);
+		if (RC_SUCCESS != unReturnValue || PnCount <= 0)
+			break;
+		{
+			const BYTE* pbBuffer = *PprgbBuffer;
+			INT32 nPos;
+			// Convert the elements from big endian in one pass
+			for (nPos = 0; nPos < PnCount; nPos++, pbBuffer += 2)
+				PpTarget[nPos] = BYTE_ARRAY_TO_UINT16(pbBuffer);
+			*PprgbBuffer += PnCount * 2;
+			*PpnSize -= PnCount * 2;
+		}
+	}
+	WHILE_FALSE_END;
+	return unReturnValue;
+}
+
 /**
  *	@brief		Marshals a UINT32 type
  *	@details	Refer to: Table 3 - Definition of Base Types
@@ -625,23 +712,29 @@ TSS_UINT32_Array_Marshal(
 	_In_	INT32				PnCount)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
-	// Check parameters
-	if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-	{
-		unReturnValue = RC_E_BAD_PARAMETER;
-	}
-	else
+	do
 	{
-		INT32 nPos;
-		unReturnValue = RC_SUCCESS;
-		// Marshal byte by byte to the buffer
-		for (nPos = 0; nPos < PnCount; nPos++)
+		// Check parameters
+		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		// Check size once for the whole array
+		unReturnValue = TSS_Array_CheckSize(PnCount, 4, *PpnSize);
+		if (RC_SUCCESS != unReturnValue || PnCount <= 0)
+			break;
 		{
-			unReturnValue = TSS_UINT32_Marshal(&PpSource[nPos], PprgbBuffer, PpnSize);
-			if (RC_SUCCESS != unReturnValue)
-				break;
+			BYTE* pbBuffer = *PprgbBuffer;
+			INT32 nPos;
+			// Convert the elements to big endian in one pass
+			for (nPos = 0; nPos < PnCount; nPos++, pbBuffer += 4)
+				UINT32_TO_BYTE_ARRAY(PpSource[nPos], pbBuffer);
+			*PprgbBuffer = pbBuffer;
+			*PpnSize -= PnCount * 4;
 		}
 	}
+	WHILE_FALSE_END;
 	return unReturnValue;
 }
 
@@ -683,14 +776,18 @@ TSS_UINT32_Array_Unmarshal(
 			unReturnValue = RC_E_BAD_PARAMETER;
 			break;
 		}
+		// Check size once for the whole array
+		unReturnValue = TSS_Array_CheckSize(PnCount, 4, *PpnSize);
+		if (RC_SUCCESS != unReturnValue || PnCount <= 0)
+			break;
 		{
+			const BYTE* pbBuffer = *PprgbBuffer;
 			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_UINT32_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
+			// Convert the elements from big endian in one pass
+			for (nPos = 0; nPos < PnCount; nPos++, pbBuffer += 4)
+				PpTarget[nPos] = BYTE_ARRAY_TO_UINT32(pbBuffer);
+			*PprgbBuffer += PnCount * 4;
+			*PpnSize -= PnCount * 4;
 		}
 	}
 	WHILE_FALSE_END;
@@ -864,36 +961,7 @@ TSS_TPM_ECC_CURVE_Array_Unmarshal(
 	_Inout_	INT32*				PpnSize,
 	_In_	INT32				PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPM_ECC_CURVE));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPM_ECC_CURVE_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_UINT16_Array_Unmarshal((UINT16*) PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -958,36 +1026,7 @@ TSS_TPM_CC_Array_Unmarshal(
 	_Inout_	INT32*		PpnSize,
 	_In_	INT32		PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPM_CC));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPM_CC_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_UINT32_Array_Unmarshal((UINT32*) PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -1220,36 +1259,7 @@ TSS_TPM_HANDLE_Array_Unmarshal(
 	_Inout_	INT32*			PpnSize,
 	_In_	INT32			PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPM_HANDLE));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPM_HANDLE_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_UINT32_Array_Unmarshal((UINT32*) PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -1356,36 +1366,7 @@ TSS_TPMA_CC_Array_Unmarshal(
 	_Inout_	INT32*		PpnSize,
 	_In_	INT32		PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMA_CC));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPMA_CC_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_UINT32_Array_Unmarshal((UINT32*) PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -1742,38 +1723,7 @@ TSS_TPM2B_DIGEST_Marshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Check size for PpnSize parameter
-		if (*PpnSize < (INT32) sizeof(PpSource->size))
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal size
-		unReturnValue = TSS_UINT16_Marshal((UINT16 *) & (PpSource->size), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check size for array
-		if (*PpnSize < (INT32) PpSource->size)
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal array
-		unReturnValue = TSS_BYTE_Array_Marshal((BYTE *) & (PpSource->buffer), PprgbBuffer, PpnSize, PpSource->size);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sTPM2B_DIGEST_Table, PpSource, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -1794,33 +1744,7 @@ TSS_TPM2B_DIGEST_Unmarshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPM2B_DIGEST));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal((UINT16 *) & (PpTarget->size), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal((BYTE *) & (PpTarget->buffer), PprgbBuffer, PpnSize, PpTarget->size);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPM2B_DIGEST_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -1925,33 +1849,7 @@ TSS_TPM2B_MAX_BUFFER_Unmarshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPM2B_MAX_BUFFER));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal((UINT16 *) & (PpTarget->size), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal((BYTE *) & (PpTarget->buffer), PprgbBuffer, PpnSize, PpTarget->size);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPM2B_MAX_BUFFER_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -1974,36 +1872,7 @@ TSS_TPM2B_MAX_BUFFER_Array_Unmarshal(
 	_Inout_	INT32*					PpnSize,
 	_In_	INT32					PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPM2B_MAX_BUFFER));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPM2B_MAX_BUFFER_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Array_Unmarshal(&g_sTPM2B_MAX_BUFFER_Table, PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -2024,33 +1893,7 @@ TSS_TPM2B_TIMEOUT_Unmarshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPM2B_TIMEOUT));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT16_Unmarshal((UINT16 *) & (PpTarget->size), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal((BYTE *) & (PpTarget->buffer), PprgbBuffer, PpnSize, PpTarget->size);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPM2B_TIMEOUT_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2071,36 +1914,7 @@ TSS_TPMS_PCR_SELECTION_Unmarshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_PCR_SELECTION));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_TPMI_ALG_HASH_Unmarshal((TPMI_ALG_HASH *) & (PpTarget->hash), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT8_Unmarshal((UINT8 *) & (PpTarget->sizeofSelect), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal((BYTE *) & (PpTarget->pcrSelect), PprgbBuffer, PpnSize, PpTarget->sizeofSelect);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPMS_PCR_SELECTION_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2123,36 +1937,7 @@ TSS_TPMS_PCR_SELECTION_Array_Unmarshal(
 	_Inout_	INT32*					PpnSize,
 	_In_	INT32					PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_PCR_SELECTION));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPMS_PCR_SELECTION_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Array_Unmarshal(&g_sTPMS_PCR_SELECTION_Table, PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -2173,36 +1958,7 @@ TSS_TPMT_TK_AUTH_Unmarshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMT_TK_AUTH));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_TPM_ST_Unmarshal((TPM_ST *) & (PpTarget->tag), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMI_RH_HIERARCHY_Unmarshal((TPMI_RH_HIERARCHY *) & (PpTarget->hierarchy), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPM2B_DIGEST_Unmarshal((TPM2B_DIGEST *) & (PpTarget->digest), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPMT_TK_AUTH_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2223,33 +1979,7 @@ TSS_TPMS_ALG_PROPERTY_Unmarshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_ALG_PROPERTY));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_TPM_ALG_ID_Unmarshal((TPM_ALG_ID *) & (PpTarget->alg), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMA_ALGORITHM_Unmarshal((TPMA_ALGORITHM *) & (PpTarget->algProperties), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPMS_ALG_PROPERTY_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2272,36 +2002,7 @@ TSS_TPMS_ALG_PROPERTY_Array_Unmarshal(
 	_Inout_	INT32*					PpnSize,
 	_In_	INT32					PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_ALG_PROPERTY));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPMS_ALG_PROPERTY_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Array_Unmarshal(&g_sTPMS_ALG_PROPERTY_Table, PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -2322,33 +2023,7 @@ TSS_TPMS_TAGGED_PROPERTY_Unmarshal(
 	_Inout_	BYTE**						PprgbBuffer,
 	_Inout_	INT32*						PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_TAGGED_PROPERTY));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_TPM_PT_Unmarshal((TPM_PT *) & (PpTarget->property), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->value), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPMS_TAGGED_PROPERTY_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2371,36 +2046,7 @@ TSS_TPMS_TAGGED_PROPERTY_Array_Unmarshal(
 	_Inout_	INT32*						PpnSize,
 	_In_	INT32						PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_TAGGED_PROPERTY));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPMS_TAGGED_PROPERTY_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Array_Unmarshal(&g_sTPMS_TAGGED_PROPERTY_Table, PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -2421,36 +2067,7 @@ TSS_TPMS_TAGGED_PCR_SELECT_Unmarshal(
 	_Inout_	BYTE**						PprgbBuffer,
 	_Inout_	INT32*						PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_TAGGED_PCR_SELECT));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_TPM_PT_Unmarshal((TPM_PT *) & (PpTarget->tag), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_UINT8_Unmarshal((UINT8 *) & (PpTarget->sizeofSelect), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_BYTE_Array_Unmarshal((BYTE *) & (PpTarget->pcrSelect), PprgbBuffer, PpnSize, PpTarget->sizeofSelect);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPMS_TAGGED_PCR_SELECT_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2473,36 +2090,7 @@ TSS_TPMS_TAGGED_PCR_SELECT_Array_Unmarshal(
 	_Inout_	INT32*						PpnSize,
 	_In_	INT32						PnCount)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_TAGGED_PCR_SELECT));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		{
-			INT32 nPos;
-			for (nPos = 0; nPos < PnCount; nPos++)
-			{
-				unReturnValue = TSS_TPMS_TAGGED_PCR_SELECT_Unmarshal(&PpTarget[nPos], PprgbBuffer, PpnSize);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Array_Unmarshal(&g_sTPMS_TAGGED_PCR_SELECT_Table, PpTarget, PprgbBuffer, PpnSize, PnCount);
 }
 
 /**
@@ -2523,33 +2111,7 @@ TSS_TPML_CC_Unmarshal(
 	_Inout_	BYTE**		PprgbBuffer,
 	_Inout_	INT32*		PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_CC));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPM_CC_Array_Unmarshal((TPM_CC *) & (PpTarget->commandCodes), PprgbBuffer, PpnSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_CC_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2570,33 +2132,7 @@ TSS_TPML_CCA_Unmarshal(
 	_Inout_	BYTE**			PprgbBuffer,
 	_Inout_	INT32*			PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_CCA));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMA_CC_Array_Unmarshal((TPMA_CC *) & (PpTarget->commandAttributes), PprgbBuffer, PpnSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_CCA_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2617,33 +2153,7 @@ TSS_TPML_HANDLE_Unmarshal(
 	_Inout_	BYTE**			PprgbBuffer,
 	_Inout_	INT32*			PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_HANDLE));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPM_HANDLE_Array_Unmarshal((TPM_HANDLE *) & (PpTarget->handle), PprgbBuffer, PpnSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_HANDLE_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2664,33 +2174,7 @@ TSS_TPML_PCR_SELECTION_Unmarshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_PCR_SELECTION));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMS_PCR_SELECTION_Array_Unmarshal((TPMS_PCR_SELECTION *) & (PpTarget->pcrSelections), PprgbBuffer, PpnSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_PCR_SELECTION_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2711,33 +2195,7 @@ TSS_TPML_ALG_PROPERTY_Unmarshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_ALG_PROPERTY));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMS_ALG_PROPERTY_Array_Unmarshal((TPMS_ALG_PROPERTY *) & (PpTarget->algProperties), PprgbBuffer, PpnSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_ALG_PROPERTY_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2758,33 +2216,7 @@ TSS_TPML_TAGGED_TPM_PROPERTY_Unmarshal(
 	_Inout_	BYTE**							PprgbBuffer,
 	_Inout_	INT32*							PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_TAGGED_TPM_PROPERTY));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMS_TAGGED_PROPERTY_Array_Unmarshal((TPMS_TAGGED_PROPERTY *) & (PpTarget->tpmProperty), PprgbBuffer, PpnSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_TAGGED_TPM_PROPERTY_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2805,33 +2237,7 @@ TSS_TPML_TAGGED_PCR_PROPERTY_Unmarshal(
 	_Inout_	BYTE**							PprgbBuffer,
 	_Inout_	INT32*							PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_TAGGED_PCR_PROPERTY));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMS_TAGGED_PCR_SELECT_Array_Unmarshal((TPMS_TAGGED_PCR_SELECT *) & (PpTarget->pcrProperty), PprgbBuffer, PpnSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_TAGGED_PCR_PROPERTY_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2852,33 +2258,7 @@ TSS_TPML_ECC_CURVE_Unmarshal(
 	_Inout_	BYTE**				PprgbBuffer,
 	_Inout_	INT32*				PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPML_ECC_CURVE));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_UINT32_Unmarshal((UINT32 *) & (PpTarget->count), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPM_ECC_CURVE_Array_Unmarshal((TPM_ECC_CURVE *) & (PpTarget->eccCurves), PprgbBuffer, PpnSize, PpTarget->count);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPML_ECC_CURVE_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2901,32 +2281,7 @@ TSS_TPMU_CAPABILITIES_Unmarshal(
 	_Inout_	INT32*					PpnSize,
 	_In_	UINT32					PunSelector)
 {
-	switch (PunSelector) {
-		case TPM_CAP_ALGS:
-			return TSS_TPML_ALG_PROPERTY_Unmarshal((TPML_ALG_PROPERTY *) & (PpTarget->algorithms), PprgbBuffer, PpnSize);
-		case TPM_CAP_HANDLES:
-			return TSS_TPML_HANDLE_Unmarshal((TPML_HANDLE *) & (PpTarget->handles), PprgbBuffer, PpnSize);
-		case TPM_CAP_COMMANDS:
-			return TSS_TPML_CCA_Unmarshal((TPML_CCA *) & (PpTarget->command), PprgbBuffer, PpnSize);
-		case TPM_CAP_PP_COMMANDS:
-			return TSS_TPML_CC_Unmarshal((TPML_CC *) & (PpTarget->ppCommands), PprgbBuffer, PpnSize);
-		case TPM_CAP_AUDIT_COMMANDS:
-			return TSS_TPML_CC_Unmarshal((TPML_CC *) & (PpTarget->auditCommands), PprgbBuffer, PpnSize);
-		case TPM_CAP_PCRS:
-			return TSS_TPML_PCR_SELECTION_Unmarshal((TPML_PCR_SELECTION *) & (PpTarget->assignedPCR), PprgbBuffer, PpnSize);
-		case TPM_CAP_TPM_PROPERTIES:
-			return TSS_TPML_TAGGED_TPM_PROPERTY_Unmarshal((TPML_TAGGED_TPM_PROPERTY *) & (PpTarget->tpmProperties), PprgbBuffer, PpnSize);
-		case TPM_CAP_PCR_PROPERTIES:
-			return TSS_TPML_TAGGED_PCR_PROPERTY_Unmarshal((TPML_TAGGED_PCR_PROPERTY *) & (PpTarget->pcrProperties), PprgbBuffer, PpnSize);
-		case TPM_CAP_ECC_CURVES:
-			return TSS_TPML_ECC_CURVE_Unmarshal((TPML_ECC_CURVE *) & (PpTarget->eccCurves), PprgbBuffer, PpnSize);
-		// Vendor specific capability handling is done in a vendor specific implementation
-		case TPM_CAP_VENDOR_PROPERTY:
-			return TSS_TPMU_VENDOR_CAPABILITY_Unmarshal(PpTarget, PprgbBuffer, PpnSize);
-		default:
-			assert(FALSE);
-			return RC_E_FAIL;
-	}
+	return TSS_Table_UnmarshalUnion(&g_sTPMU_CAPABILITIES_Union, PpTarget, PprgbBuffer, PpnSize, PunSelector);
 }
 
 /**
@@ -2947,33 +2302,7 @@ TSS_TPMS_CAPABILITY_DATA_Unmarshal(
 	_Inout_	BYTE**						PprgbBuffer,
 	_Inout_	INT32*						PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(TPMS_CAPABILITY_DATA));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_TPM_CAP_Unmarshal((TPM_CAP *) & (PpTarget->capability), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMU_CAPABILITIES_Unmarshal((TPMU_CAPABILITIES *) & (PpTarget->data), PprgbBuffer, PpnSize, PpTarget->capability);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sTPMS_CAPABILITY_DATA_Table, PpTarget, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -2996,21 +2325,7 @@ TSS_TPMU_SYM_KEY_BITS_Marshal(
 	_Inout_	INT32*						PpnSize,
 	_In_	UINT32						PunSelector)
 {
-	switch (PunSelector) {
-		case TPM_ALG_AES:
-			return TSS_TPMI_AES_KEY_BITS_Marshal((TPMI_AES_KEY_BITS *) & (PpSource->aes), PprgbBuffer, PpnSize);
-		case TPM_ALG_SM4:
-			return TSS_TPMI_SM4_KEY_BITS_Marshal((TPMI_SM4_KEY_BITS *) & (PpSource->sm4), PprgbBuffer, PpnSize);
-		case TPM_ALG_CAMELLIA:
-			return TSS_TPMI_CAMELLIA_KEY_BITS_Marshal((TPMI_CAMELLIA_KEY_BITS *) & (PpSource->camellia), PprgbBuffer, PpnSize);
-		case TPM_ALG_XOR:
-			return TSS_TPMI_ALG_HASH_Marshal((TPMI_ALG_HASH *) & (PpSource->xor), PprgbBuffer, PpnSize);
-		case TPM_ALG_NULL:
-			return RC_SUCCESS;
-		default:
-			assert(FALSE);
-			return RC_E_FAIL;
-	}
+	return TSS_Table_MarshalUnion(&g_sTPMU_SYM_KEY_BITS_Union, PpSource, PprgbBuffer, PpnSize, PunSelector);
 }
 
 /**
@@ -3033,19 +2348,7 @@ TSS_TPMU_SYM_MODE_Marshal(
 	_Inout_	INT32*					PpnSize,
 	_In_	UINT32					PunSelector)
 {
-	switch (PunSelector) {
-		case TPM_ALG_AES:
-			return TSS_TPMI_ALG_SYM_MODE_Marshal((TPMI_ALG_SYM_MODE *) & (PpSource->aes), PprgbBuffer, PpnSize);
-		case TPM_ALG_SM4:
-			return TSS_TPMI_ALG_SYM_MODE_Marshal((TPMI_ALG_SYM_MODE *) & (PpSource->sm4), PprgbBuffer, PpnSize);
-		case TPM_ALG_CAMELLIA:
-			return TSS_TPMI_ALG_SYM_MODE_Marshal((TPMI_ALG_SYM_MODE *) & (PpSource->camellia), PprgbBuffer, PpnSize);
-		case TPM_ALG_NULL:
-			return RC_SUCCESS;
-		default:
-			assert(FALSE);
-			return RC_E_FAIL;
-	}
+	return TSS_Table_MarshalUnion(&g_sTPMU_SYM_MODE_Union, PpSource, PprgbBuffer, PpnSize, PunSelector);
 }
 
 /**
@@ -3066,48 +2369,7 @@ TSS_TPMT_SYM_DEF_Marshal(
 	_Inout_	BYTE**					PprgbBuffer,
 	_Inout_	INT32*					PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Check size for PpnSize parameter
-		if (*PpnSize < (INT32) sizeof(PpSource->algorithm))
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal size
-		unReturnValue = TSS_TPMI_ALG_SYM_Marshal((TPMI_ALG_SYM *) & (PpSource->algorithm), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check size for array
-		if (*PpnSize < (INT32) PpSource->algorithm)
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal array
-		unReturnValue = TSS_TPMU_SYM_KEY_BITS_Marshal((TPMU_SYM_KEY_BITS *) & (PpSource->keyBits), PprgbBuffer, PpnSize, PpSource->algorithm);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check size for array
-		if (*PpnSize < (INT32) PpSource->algorithm)
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal array
-		unReturnValue = TSS_TPMU_SYM_MODE_Marshal((TPMU_SYM_MODE *) & (PpSource->mode), PprgbBuffer, PpnSize, PpSource->algorithm);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sTPMT_SYM_DEF_Table, PpSource, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -3128,38 +2390,7 @@ TSS_TPM2B_ENCRYPTED_SECRET_Marshal(
 	_Inout_	BYTE**								PprgbBuffer,
 	_Inout_	INT32*								PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Check size for PpnSize parameter
-		if (*PpnSize < (INT32) sizeof(PpSource->size))
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal size
-		unReturnValue = TSS_UINT16_Marshal((UINT16 *) & (PpSource->size), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check size for array
-		if (*PpnSize < (INT32) PpSource->size)
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal array
-		unReturnValue = TSS_BYTE_Array_Marshal((BYTE *) & (PpSource->secret), PprgbBuffer, PpnSize, PpSource->size);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sTPM2B_ENCRYPTED_SECRET_Table, PpSource, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -3180,58 +2411,7 @@ TSS_AuthorizationCommandData_Marshal(
 	_Inout_	BYTE**								PprgbBuffer,
 	_Inout_	INT32*								PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check parameters
-		if ((NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		// Check size for PpnSize parameter
-		if (*PpnSize < (INT32) sizeof(PpSource->authHandle))
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal size
-		unReturnValue = TSS_TPMI_SH_AUTH_SESSION_Marshal((TPMI_SH_AUTH_SESSION *) & (PpSource->authHandle), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check size for PpnSize parameter
-		if (*PpnSize < (INT32) sizeof(PpSource->nonceCaller))
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal size
-		unReturnValue = TSS_TPM2B_NONCE_Marshal((TPM2B_NONCE *) & (PpSource->nonceCaller), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check size for PpnSize parameter
-		if (*PpnSize < (INT32) sizeof(PpSource->sessionAttributes))
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal size
-		unReturnValue = TSS_TPMA_SESSION_Marshal((TPMA_SESSION *) & (PpSource->sessionAttributes), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check size for PpnSize parameter
-		if (*PpnSize < (INT32) sizeof(PpSource->hmac))
-		{
-			unReturnValue = RC_E_BUFFER_TOO_SMALL;
-			break;
-		}
-		// Marshal size
-		unReturnValue = TSS_TPM2B_AUTH_Marshal((TPM2B_AUTH *) & (PpSource->hmac), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Marshal(&g_sAuthorizationCommandData_Table, PpSource, PprgbBuffer, PpnSize);
 }
 
 /**
@@ -3252,34 +2432,5 @@ TSS_AcknowledgmentResponseData_Unmarshal(
 	_Inout_	BYTE**							PprgbBuffer,
 	_Inout_	INT32*							PpnSize)
 {
-	unsigned int unReturnValue = RC_E_FAIL;
-	do
-	{
-		// Check and initialize _Out_ parameters
-		if (NULL == PpTarget)
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = Platform_MemorySet(PpTarget, 0x00, sizeof(AcknowledgmentResponseData));
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		// Check _Inout_ parameters
-		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
-		{
-			unReturnValue = RC_E_BAD_PARAMETER;
-			break;
-		}
-		unReturnValue = TSS_TPM2B_NONCE_Unmarshal((TPM2B_NONCE *) & (PpTarget->nonceTPM), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPMA_SESSION_Unmarshal((TPMA_SESSION *) & (PpTarget->sessionAttributes), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-		unReturnValue = TSS_TPM2B_AUTH_Unmarshal((TPM2B_AUTH *) & (PpTarget->hmac), PprgbBuffer, PpnSize);
-		if (RC_SUCCESS != unReturnValue)
-			break;
-	}
-	WHILE_FALSE_END;
-	return unReturnValue;
+	return TSS_Table_Unmarshal(&g_sAcknowledgmentResponseData_Table, PpTarget, PprgbBuffer, PpnSize);
 }
\ No newline at end of file
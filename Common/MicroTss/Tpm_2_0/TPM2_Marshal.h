@@ -282,6 +282,46 @@ TSS_UINT16_Unmarshal(
 	_Inout_	BYTE**		PprgbBuffer,
 	_Inout_	INT32*		PpnSize);
 
+/**
+ *	@brief		Marshals a UINT16 array
+ *	@details	Refer to: Table 3 - Definition of Base Types
+ *
+ *	@param		PpSource	Location containing the value that is to be marshaled in to the designated buffer
+ *	@param		PprgbBuffer	Location in the output buffer where the first octet of the TYPE is to be placed
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_UINT16_Array_Marshal(
+	_In_	const UINT16*		PpSource,
+	_Inout_	BYTE**				PprgbBuffer,
+	_Inout_	INT32*				PpnSize,
+	_In_	INT32				PnCount);
+
+/**
+ *	@brief		Unmarshals a UINT16 array
+ *	@details	Refer to: Table 3 - Definition of Base Types
+ *
+ *	@param		PpTarget	Location into which the data from **PprgbBuffer is placed
+ *	@param		PprgbBuffer	Location in the output buffer containing the most significant octet (MSO) of *PpTarget
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_UINT16_Array_Unmarshal(
+	_Out_	UINT16*		PpTarget,
+	_Inout_	BYTE**		PprgbBuffer,
+	_Inout_	INT32*		PpnSize,
+	_In_	INT32		PnCount);
+
 /**
  *	@brief		Marshals a UINT32 type
  *	@details	Refer to: Table 3 - Definition of Base Types
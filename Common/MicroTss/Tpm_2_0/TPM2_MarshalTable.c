@@ -0,0 +1,502 @@
+﻿/**
+ *	@brief		Implements the table driven marshalling engine
+ *	@details	The module interprets the marshal tables generated by GenerateMarshalTables.py. Each structure is
+ *				processed by one loop over its fields, arrays of integers are handled by the bulk array functions.
+ *	@file		TPM2_MarshalTable.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "TPM2_MarshalTable.h"
+#include "TPM2_Marshal.h"
+#include "Platform.h"
+
+/**
+ *	@brief		Reads a count or selector field
+ *	@details	Reads the field referenced by a marshal table field from the structure in memory.
+ *
+ *	@param		PpsField		Marshal table field
+ *	@param		PpbStructure	Structure containing the count or selector field
+ *
+ *	@returns	Value of the count or selector field
+ */
+static
+UINT32
+TSS_Table_ReadReference(
+	_In_	const IfxMarshalField*	PpsField,
+	_In_	const BYTE*				PpbStructure)
+{
+	const BYTE* pbReference = PpbStructure + PpsField->usReferenceOffset;
+	UINT32 unValue = PpsField->usCount;
+	switch (PpsField->bReferenceType)
+	{
+		case TSS_FIELD_UINT8:
+			unValue = *pbReference;
+			break;
+		case TSS_FIELD_UINT16:
+			unValue = *(const UINT16*)pbReference;
+			break;
+		case TSS_FIELD_UINT32:
+			unValue = *(const UINT32*)pbReference;
+			break;
+		default:
+			break;
+	}
+	return unValue;
+}
+
+/**
+ *	@brief		Determines the number of elements of a field
+ *	@details	Returns the fixed number of elements or the value of the count field after checking it against the array size.
+ *
+ *	@param		PpsField		Marshal table field
+ *	@param		PpbStructure	Structure containing the field
+ *	@param		PunTooLarge		Error code to return if the count field exceeds the array size
+ *	@param		PpnCount		Receives the number of elements
+ *
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		RC_E_FAIL		The count field does not match an array with an exact size.
+ *	@retval		PunTooLarge		The count field exceeds the array size.
+ */
+_Check_return_
+static
+unsigned int
+TSS_Table_GetCount(
+	_In_	const IfxMarshalField*	PpsField,
+	_In_	const BYTE*				PpbStructure,
+	_In_	unsigned int			PunTooLarge,
+	_Out_	INT32*					PpnCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	do
+	{
+		UINT32 unCount = PpsField->usCount;
+
+		if (TSS_FIELD_UNION != PpsField->bType && TSS_FIELD_EMPTY != PpsField->bReferenceType)
+		{
+			unCount = TSS_Table_ReadReference(PpsField, PpbStructure);
+			if (0 != (PpsField->bFlags & TSS_FIELD_FLAG_EXACT_COUNT) && unCount != (UINT32)PpsField->usCount)
+			{
+				unReturnValue = RC_E_FAIL;
+				break;
+			}
+			if (unCount > (UINT32)PpsField->usCount)
+			{
+				unReturnValue = PunTooLarge;
+				break;
+			}
+		}
+
+		*PpnCount = (INT32)unCount;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Finds the union arm for a selector
+ *
+ *	@param		PpsUnion		Marshal table of the union
+ *	@param		PunSelector		Selector of the union arm
+ *
+ *	@returns	Field of the union arm or NULL if the selector is unknown
+ */
+static
+const IfxMarshalField*
+TSS_Table_FindArm(
+	_In_	const IfxMarshalUnion*	PpsUnion,
+	_In_	UINT32					PunSelector)
+{
+	const IfxMarshalField* psArm = NULL;
+	UINT16 usArm;
+	for (usArm = 0; usArm < PpsUnion->usArms && NULL == psArm; usArm++)
+	{
+		if (PpsUnion->psArms[usArm].unSelector == PunSelector)
+			psArm = &PpsUnion->psArms[usArm].sField;
+	}
+	return psArm;
+}
+
+/**
+ *	@brief		Marshals the fields of a structure
+ *	@details	Loops over the marshal table fields. Nested structures and union arms are handled recursively.
+ *
+ *	@param		PpsFields		Marshal table fields
+ *	@param		PusFields		Number of fields
+ *	@param		PpbSource		Structure (or union) in memory
+ *	@param		PprgbBuffer		Location in the output buffer where the first octet is to be placed
+ *	@param		PpnSize			Number of octets remaining in **PprgbBuffer
+ *
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		...				Error codes from called functions.
+ */
+_Check_return_
+static
+unsigned int
+TSS_Table_MarshalFields(
+	_In_	const IfxMarshalField*	PpsFields,
+	_In_	UINT16					PusFields,
+	_In_	const BYTE*				PpbSource,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	UINT16 usField;
+
+	for (usField = 0; usField < PusFields && RC_SUCCESS == unReturnValue; usField++)
+	{
+		const IfxMarshalField* psField = &PpsFields[usField];
+		const BYTE* pbField = PpbSource + psField->usOffset;
+		INT32 nCount = 0;
+
+		unReturnValue = TSS_Table_GetCount(psField, PpbSource, RC_E_BAD_PARAMETER, &nCount);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		switch (psField->bType)
+		{
+			case TSS_FIELD_UINT8:
+				unReturnValue = TSS_UINT8_Array_Marshal(pbField, PprgbBuffer, PpnSize, nCount);
+				break;
+			case TSS_FIELD_UINT16:
+				unReturnValue = TSS_UINT16_Array_Marshal((const UINT16*)pbField, PprgbBuffer, PpnSize, nCount);
+				break;
+			case TSS_FIELD_UINT32:
+				unReturnValue = TSS_UINT32_Array_Marshal((const UINT32*)pbField, PprgbBuffer, PpnSize, nCount);
+				break;
+			case TSS_FIELD_STRUCT:
+			{
+				const IfxMarshalTable* psTable = (const IfxMarshalTable*)psField->pvTable;
+				INT32 nPos;
+				for (nPos = 0; nPos < nCount && RC_SUCCESS == unReturnValue; nPos++)
+					unReturnValue = TSS_Table_MarshalFields(psTable->psFields, psTable->usFields, pbField + nPos * psField->usElementSize, PprgbBuffer, PpnSize);
+				break;
+			}
+			case TSS_FIELD_UNION:
+			{
+				const IfxMarshalField* psArm = TSS_Table_FindArm((const IfxMarshalUnion*)psField->pvTable, TSS_Table_ReadReference(psField, PpbSource));
+				if (NULL == psArm)
+					unReturnValue = RC_E_FAIL;
+				else
+					unReturnValue = TSS_Table_MarshalFields(psArm, 1, pbField, PprgbBuffer, PpnSize);
+				break;
+			}
+			case TSS_FIELD_EMPTY:
+				break;
+			default:
+				unReturnValue = RC_E_FAIL;
+				break;
+		}
+	}
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Unmarshals the fields of a structure
+ *	@details	Loops over the marshal table fields. Nested structures and union arms are handled recursively.
+ *
+ *	@param		PpsFields		Marshal table fields
+ *	@param		PusFields		Number of fields
+ *	@param		PpbTarget		Structure (or union) in memory
+ *	@param		PprgbBuffer		Location in the input buffer containing the first octet
+ *	@param		PpnSize			Number of octets remaining in **PprgbBuffer
+ *
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		...				Error codes from called functions.
+ */
+_Check_return_
+static
+unsigned int
+TSS_Table_UnmarshalFields(
+	_In_	const IfxMarshalField*	PpsFields,
+	_In_	UINT16					PusFields,
+	_Inout_	BYTE*					PpbTarget,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize)
+{
+	unsigned int unReturnValue = RC_SUCCESS;
+	UINT16 usField;
+
+	for (usField = 0; usField < PusFields && RC_SUCCESS == unReturnValue; usField++)
+	{
+		const IfxMarshalField* psField = &PpsFields[usField];
+		BYTE* pbField = PpbTarget + psField->usOffset;
+		INT32 nCount = 0;
+
+		unReturnValue = TSS_Table_GetCount(psField, PpbTarget, RC_E_BUFFER_TOO_SMALL, &nCount);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		switch (psField->bType)
+		{
+			case TSS_FIELD_UINT8:
+				unReturnValue = TSS_UINT8_Array_Unmarshal(pbField, PprgbBuffer, PpnSize, nCount);
+				break;
+			case TSS_FIELD_UINT16:
+				unReturnValue = TSS_UINT16_Array_Unmarshal((UINT16*)pbField, PprgbBuffer, PpnSize, nCount);
+				break;
+			case TSS_FIELD_UINT32:
+				unReturnValue = TSS_UINT32_Array_Unmarshal((UINT32*)pbField, PprgbBuffer, PpnSize, nCount);
+				break;
+			case TSS_FIELD_STRUCT:
+			{
+				const IfxMarshalTable* psTable = (const IfxMarshalTable*)psField->pvTable;
+				INT32 nPos;
+				for (nPos = 0; nPos < nCount && RC_SUCCESS == unReturnValue; nPos++)
+					unReturnValue = TSS_Table_UnmarshalFields(psTable->psFields, psTable->usFields, pbField + nPos * psField->usElementSize, PprgbBuffer, PpnSize);
+				break;
+			}
+			case TSS_FIELD_UNION:
+			{
+				const IfxMarshalField* psArm = TSS_Table_FindArm((const IfxMarshalUnion*)psField->pvTable, TSS_Table_ReadReference(psField, PpbTarget));
+				if (NULL == psArm)
+					unReturnValue = RC_E_FAIL;
+				else
+					unReturnValue = TSS_Table_UnmarshalFields(psArm, 1, pbField, PprgbBuffer, PpnSize);
+				break;
+			}
+			case TSS_FIELD_EMPTY:
+				break;
+			default:
+				unReturnValue = RC_E_FAIL;
+				break;
+		}
+	}
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Marshals a structure described by a marshal table
+ *	@details	Interprets the marshal table and marshals the fields of the structure in wire order.
+ *
+ *	@param		PpsTable	Marshal table of the structure
+ *	@param		PpSource	Location containing the value that is to be marshaled in to the designated buffer
+ *	@param		PprgbBuffer	Location in the output buffer where the first octet of the TYPE is to be placed
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed or a count field exceeds the size of its array.
+ *	@retval		RC_E_FAIL				A count field does not match an array with an exact size or a union selector is unknown.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_Table_Marshal(
+	_In_	const IfxMarshalTable*	PpsTable,
+	_In_	const void*				PpSource,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	do
+	{
+		// Check parameters
+		if ((NULL == PpsTable) || (NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		unReturnValue = TSS_Table_MarshalFields(PpsTable->psFields, PpsTable->usFields, (const BYTE*)PpSource, PprgbBuffer, PpnSize);
+	}
+	WHILE_FALSE_END;
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Unmarshals a structure described by a marshal table
+ *	@details	Clears the structure, interprets the marshal table and unmarshals the fields of the structure in wire order.
+ *
+ *	@param		PpsTable	Marshal table of the structure
+ *	@param		PpTarget	Location into which the data from **PprgbBuffer is placed
+ *	@param		PprgbBuffer	Location in the output buffer containing the most significant octet (MSO) of *PpTarget
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_BUFFER_TOO_SMALL	A count field exceeds the size of its array.
+ *	@retval		RC_E_FAIL				A count field does not match an array with an exact size or a union selector is unknown.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_Table_Unmarshal(
+	_In_	const IfxMarshalTable*	PpsTable,
+	_Out_	void*					PpTarget,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	do
+	{
+		// Check and initialize _Out_ parameters
+		if ((NULL == PpsTable) || (NULL == PpTarget))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		unReturnValue = Platform_MemorySet(PpTarget, 0x00, PpsTable->usSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		// Check _Inout_ parameters
+		if ((NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		unReturnValue = TSS_Table_UnmarshalFields(PpsTable->psFields, PpsTable->usFields, (BYTE*)PpTarget, PprgbBuffer, PpnSize);
+	}
+	WHILE_FALSE_END;
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Unmarshals an array of structures described by a marshal table
+ *	@details	Unmarshals the given number of structures one after the other.
+ *
+ *	@param		PpsTable	Marshal table of the structure
+ *	@param		PpTarget	Location into which the data from **PprgbBuffer is placed
+ *	@param		PprgbBuffer	Location in the output buffer containing the most significant octet (MSO) of *PpTarget
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from TSS_Table_Unmarshal.
+ */
+_Check_return_
+unsigned int
+TSS_Table_Array_Unmarshal(
+	_In_	const IfxMarshalTable*	PpsTable,
+	_Out_	void*					PpTarget,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize,
+	_In_	INT32					PnCount)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	do
+	{
+		INT32 nPos;
+
+		// Check parameters
+		if ((NULL == PpsTable) || (NULL == PpTarget))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		unReturnValue = RC_SUCCESS;
+		for (nPos = 0; nPos < PnCount && RC_SUCCESS == unReturnValue; nPos++)
+			unReturnValue = TSS_Table_Unmarshal(PpsTable, (BYTE*)PpTarget + nPos * PpsTable->usSize, PprgbBuffer, PpnSize);
+	}
+	WHILE_FALSE_END;
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Marshals a union described by a marshal table
+ *	@details	Marshals the union arm that belongs to the selector.
+ *
+ *	@param		PpsUnion	Marshal table of the union
+ *	@param		PpSource	Location containing the value that is to be marshaled in to the designated buffer
+ *	@param		PprgbBuffer	Location in the output buffer where the first octet of the TYPE is to be placed
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PunSelector	Selector of the union arm
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				The selector is unknown.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_Table_MarshalUnion(
+	_In_	const IfxMarshalUnion*	PpsUnion,
+	_In_	const void*				PpSource,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize,
+	_In_	UINT32					PunSelector)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	do
+	{
+		const IfxMarshalField* psArm = NULL;
+
+		// Check parameters
+		if ((NULL == PpsUnion) || (NULL == PpSource) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		psArm = TSS_Table_FindArm(PpsUnion, PunSelector);
+		if (NULL == psArm)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+		unReturnValue = TSS_Table_MarshalFields(psArm, 1, (const BYTE*)PpSource, PprgbBuffer, PpnSize);
+	}
+	WHILE_FALSE_END;
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Unmarshals a union described by a marshal table
+ *	@details	Clears and unmarshals the union arm that belongs to the selector.
+ *
+ *	@param		PpsUnion	Marshal table of the union
+ *	@param		PpTarget	Location into which the data from **PprgbBuffer is placed
+ *	@param		PprgbBuffer	Location in the output buffer containing the most significant octet (MSO) of *PpTarget
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PunSelector	Selector of the union arm
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				The selector is unknown.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_Table_UnmarshalUnion(
+	_In_	const IfxMarshalUnion*	PpsUnion,
+	_Inout_	void*					PpTarget,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize,
+	_In_	UINT32					PunSelector)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	do
+	{
+		const IfxMarshalField* psArm = NULL;
+
+		// Check parameters
+		if ((NULL == PpsUnion) || (NULL == PpTarget) || (NULL == PprgbBuffer) || (NULL == *PprgbBuffer) || (NULL == PpnSize))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		psArm = TSS_Table_FindArm(PpsUnion, PunSelector);
+		if (NULL == psArm)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+		// Clear the union arm
+		if (TSS_FIELD_EMPTY != psArm->bType)
+		{
+			unReturnValue = Platform_MemorySet((BYTE*)PpTarget + psArm->usOffset, 0x00, (unsigned int)psArm->usCount * psArm->usElementSize);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+		}
+		unReturnValue = TSS_Table_UnmarshalFields(psArm, 1, (BYTE*)PpTarget, PprgbBuffer, PpnSize);
+	}
+	WHILE_FALSE_END;
+	return unReturnValue;
+}
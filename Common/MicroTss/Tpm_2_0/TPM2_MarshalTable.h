@@ -0,0 +1,228 @@
+﻿/**
+ *	@brief		Declares the table driven marshalling engine
+ *	@details	The module marshals and unmarshals structures described by static marshal tables. The tables are
+ *				generated from the TPM2.0 type headers by GenerateMarshalTables.py.
+ *	@file		TPM2_MarshalTable.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+#include "TPM2_Types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	@brief		Field types of a marshal table
+ *	@details	The integer types are marshalled in big endian byte order with the given number of octets.
+ */
+typedef enum tdTSS_FIELD_TYPE
+{
+	/// No data on the wire (for example a union arm for TPM_ALG_NULL)
+	TSS_FIELD_EMPTY = 0,
+	/// 8 bit integer
+	TSS_FIELD_UINT8 = 1,
+	/// 16 bit integer
+	TSS_FIELD_UINT16 = 2,
+	/// 32 bit integer
+	TSS_FIELD_UINT32 = 4,
+	/// Structure described by an IfxMarshalTable
+	TSS_FIELD_STRUCT = 5,
+	/// Union described by an IfxMarshalUnion and selected by a former field
+	TSS_FIELD_UNION = 6
+} TSS_FIELD_TYPE;
+
+/// The number of elements in the count field must be equal to the size of the array
+#define TSS_FIELD_FLAG_EXACT_COUNT	0x01
+
+/**
+ *	@brief		Marshal table field
+ *	@details	Describes one field of a structure. Arrays either have a fixed number of elements or a count field,
+ *				unions have a selector field. Count and selector fields are marshalled before the field they refer to.
+ */
+typedef struct tdIfxMarshalField
+{
+	/// Offset of the field in the structure
+	UINT16			usOffset;
+	/// Type of one element (TSS_FIELD_TYPE)
+	BYTE			bType;
+	/// Type of the count or selector field (TSS_FIELD_UINT8/16/32) or TSS_FIELD_EMPTY for a fixed number of elements
+	BYTE			bReferenceType;
+	/// Offset of the count or selector field in the structure
+	UINT16			usReferenceOffset;
+	/// Number of elements in the structure (maximum number of elements for arrays with a count field)
+	UINT16			usCount;
+	/// Size of one element in the structure in bytes
+	UINT16			usElementSize;
+	/// Field flags (TSS_FIELD_FLAG_*)
+	BYTE			bFlags;
+	/// IfxMarshalTable for TSS_FIELD_STRUCT or IfxMarshalUnion for TSS_FIELD_UNION, NULL otherwise
+	const void*		pvTable;
+} IfxMarshalField;
+
+/**
+ *	@brief		Marshal table of a structure
+ *	@details	Lists the fields of a structure in wire order.
+ */
+typedef struct tdIfxMarshalTable
+{
+	/// Size of the structure in bytes
+	UINT16					usSize;
+	/// Number of fields
+	UINT16					usFields;
+	/// Fields in wire order
+	const IfxMarshalField*	psFields;
+} IfxMarshalTable;
+
+/**
+ *	@brief		Marshal table union arm
+ *	@details	Field that is marshalled if the selector has the given value.
+ */
+typedef struct tdIfxMarshalUnionArm
+{
+	/// Selector value
+	UINT32			unSelector;
+	/// Field to marshal (offset relative to the union)
+	IfxMarshalField	sField;
+} IfxMarshalUnionArm;
+
+/**
+ *	@brief		Marshal table of a union
+ *	@details	Lists the union arms with their selector values.
+ */
+typedef struct tdIfxMarshalUnion
+{
+	/// Number of arms
+	UINT16						usArms;
+	/// Union arms
+	const IfxMarshalUnionArm*	psArms;
+} IfxMarshalUnion;
+
+/**
+ *	@brief		Marshals a structure described by a marshal table
+ *	@details	Interprets the marshal table and marshals the fields of the structure in wire order.
+ *
+ *	@param		PpsTable	Marshal table of the structure
+ *	@param		PpSource	Location containing the value that is to be marshaled in to the designated buffer
+ *	@param		PprgbBuffer	Location in the output buffer where the first octet of the TYPE is to be placed
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed or a count field exceeds the size of its array.
+ *	@retval		RC_E_FAIL				A count field does not match an array with an exact size or a union selector is unknown.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_Table_Marshal(
+	_In_	const IfxMarshalTable*	PpsTable,
+	_In_	const void*				PpSource,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize);
+
+/**
+ *	@brief		Unmarshals a structure described by a marshal table
+ *	@details	Clears the structure, interprets the marshal table and unmarshals the fields of the structure in wire order.
+ *
+ *	@param		PpsTable	Marshal table of the structure
+ *	@param		PpTarget	Location into which the data from **PprgbBuffer is placed
+ *	@param		PprgbBuffer	Location in the output buffer containing the most significant octet (MSO) of *PpTarget
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_BUFFER_TOO_SMALL	A count field exceeds the size of its array.
+ *	@retval		RC_E_FAIL				A count field does not match an array with an exact size or a union selector is unknown.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_Table_Unmarshal(
+	_In_	const IfxMarshalTable*	PpsTable,
+	_Out_	void*					PpTarget,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize);
+
+/**
+ *	@brief		Unmarshals an array of structures described by a marshal table
+ *	@details	Unmarshals the given number of structures one after the other.
+ *
+ *	@param		PpsTable	Marshal table of the structure
+ *	@param		PpTarget	Location into which the data from **PprgbBuffer is placed
+ *	@param		PprgbBuffer	Location in the output buffer containing the most significant octet (MSO) of *PpTarget
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PnCount		Number of elements
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from TSS_Table_Unmarshal.
+ */
+_Check_return_
+unsigned int
+TSS_Table_Array_Unmarshal(
+	_In_	const IfxMarshalTable*	PpsTable,
+	_Out_	void*					PpTarget,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize,
+	_In_	INT32					PnCount);
+
+/**
+ *	@brief		Marshals a union described by a marshal table
+ *	@details	Marshals the union arm that belongs to the selector.
+ *
+ *	@param		PpsUnion	Marshal table of the union
+ *	@param		PpSource	Location containing the value that is to be marshaled in to the designated buffer
+ *	@param		PprgbBuffer	Location in the output buffer where the first octet of the TYPE is to be placed
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PunSelector	Selector of the union arm
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				The selector is unknown.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_Table_MarshalUnion(
+	_In_	const IfxMarshalUnion*	PpsUnion,
+	_In_	const void*				PpSource,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize,
+	_In_	UINT32					PunSelector);
+
+/**
+ *	@brief		Unmarshals a union described by a marshal table
+ *	@details	Clears and unmarshals the union arm that belongs to the selector.
+ *
+ *	@param		PpsUnion	Marshal table of the union
+ *	@param		PpTarget	Location into which the data from **PprgbBuffer is placed
+ *	@param		PprgbBuffer	Location in the output buffer containing the most significant octet (MSO) of *PpTarget
+ *	@param		PpnSize		Number of octets remaining in **PprgbBuffer
+ *	@param		PunSelector	Selector of the union arm
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				The selector is unknown.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+TSS_Table_UnmarshalUnion(
+	_In_	const IfxMarshalUnion*	PpsUnion,
+	_Inout_	void*					PpTarget,
+	_Inout_	BYTE**					PprgbBuffer,
+	_Inout_	INT32*					PpnSize,
+	_In_	UINT32					PunSelector);
+
+#ifdef __cplusplus
+}
+#endif
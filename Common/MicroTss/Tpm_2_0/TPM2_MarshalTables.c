@@ -0,0 +1,325 @@
+﻿/**
+ *	@brief		Defines the generated marshal tables of the TPM2.0 structures
+ *	@details	This file is generated by GenerateMarshalTables.py from TPM2_Types.h and TPM2_FieldUpgradeTypes.h. Do not edit.
+ *	@file		TPM2_MarshalTables.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "TPM2_MarshalTables.h"
+
+static const IfxMarshalField s_rgsTPM2B_DIGEST_Fields[] =
+{
+	{ offsetof(TPM2B_DIGEST, size), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT16), 0, NULL },
+	{ offsetof(TPM2B_DIGEST, buffer), TSS_FIELD_UINT8, TSS_FIELD_UINT16, offsetof(TPM2B_DIGEST, size), sizeof(TPMU_HA), sizeof(BYTE), 0, NULL },
+};
+const IfxMarshalTable g_sTPM2B_DIGEST_Table = { sizeof(TPM2B_DIGEST), 2, s_rgsTPM2B_DIGEST_Fields };
+
+static const IfxMarshalField s_rgsTPM2B_MAX_BUFFER_Fields[] =
+{
+	{ offsetof(TPM2B_MAX_BUFFER, size), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT16), 0, NULL },
+	{ offsetof(TPM2B_MAX_BUFFER, buffer), TSS_FIELD_UINT8, TSS_FIELD_UINT16, offsetof(TPM2B_MAX_BUFFER, size), MAX_DIGEST_BUFFER, sizeof(BYTE), 0, NULL },
+};
+const IfxMarshalTable g_sTPM2B_MAX_BUFFER_Table = { sizeof(TPM2B_MAX_BUFFER), 2, s_rgsTPM2B_MAX_BUFFER_Fields };
+
+static const IfxMarshalField s_rgsTPM2B_TIMEOUT_Fields[] =
+{
+	{ offsetof(TPM2B_TIMEOUT, size), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT16), 0, NULL },
+	{ offsetof(TPM2B_TIMEOUT, buffer), TSS_FIELD_UINT8, TSS_FIELD_UINT16, offsetof(TPM2B_TIMEOUT, size), sizeof(UINT64), sizeof(BYTE), 0, NULL },
+};
+const IfxMarshalTable g_sTPM2B_TIMEOUT_Table = { sizeof(TPM2B_TIMEOUT), 2, s_rgsTPM2B_TIMEOUT_Fields };
+
+static const IfxMarshalField s_rgsTPM2B_ENCRYPTED_SECRET_Fields[] =
+{
+	{ offsetof(TPM2B_ENCRYPTED_SECRET, size), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT16), 0, NULL },
+	{ offsetof(TPM2B_ENCRYPTED_SECRET, secret), TSS_FIELD_UINT8, TSS_FIELD_UINT16, offsetof(TPM2B_ENCRYPTED_SECRET, size), sizeof(TPMU_ENCRYPTED_SECRET), sizeof(BYTE), 0, NULL },
+};
+const IfxMarshalTable g_sTPM2B_ENCRYPTED_SECRET_Table = { sizeof(TPM2B_ENCRYPTED_SECRET), 2, s_rgsTPM2B_ENCRYPTED_SECRET_Fields };
+
+static const IfxMarshalField s_rgsTPMS_PCR_SELECTION_Fields[] =
+{
+	{ offsetof(TPMS_PCR_SELECTION, hash), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_ALG_HASH), 0, NULL },
+	{ offsetof(TPMS_PCR_SELECTION, sizeofSelect), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT8), 0, NULL },
+	{ offsetof(TPMS_PCR_SELECTION, pcrSelect), TSS_FIELD_UINT8, TSS_FIELD_UINT8, offsetof(TPMS_PCR_SELECTION, sizeofSelect), PCR_SELECT_MAX, sizeof(BYTE), 0, NULL },
+};
+const IfxMarshalTable g_sTPMS_PCR_SELECTION_Table = { sizeof(TPMS_PCR_SELECTION), 3, s_rgsTPMS_PCR_SELECTION_Fields };
+
+static const IfxMarshalField s_rgsTPMT_TK_AUTH_Fields[] =
+{
+	{ offsetof(TPMT_TK_AUTH, tag), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM_ST), 0, NULL },
+	{ offsetof(TPMT_TK_AUTH, hierarchy), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_RH_HIERARCHY), 0, NULL },
+	{ offsetof(TPMT_TK_AUTH, digest), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM2B_DIGEST), 0, &g_sTPM2B_DIGEST_Table },
+};
+const IfxMarshalTable g_sTPMT_TK_AUTH_Table = { sizeof(TPMT_TK_AUTH), 3, s_rgsTPMT_TK_AUTH_Fields };
+
+static const IfxMarshalField s_rgsTPMS_ALG_PROPERTY_Fields[] =
+{
+	{ offsetof(TPMS_ALG_PROPERTY, alg), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM_ALG_ID), 0, NULL },
+	{ offsetof(TPMS_ALG_PROPERTY, algProperties), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMA_ALGORITHM), 0, NULL },
+};
+const IfxMarshalTable g_sTPMS_ALG_PROPERTY_Table = { sizeof(TPMS_ALG_PROPERTY), 2, s_rgsTPMS_ALG_PROPERTY_Fields };
+
+static const IfxMarshalField s_rgsTPMS_TAGGED_PROPERTY_Fields[] =
+{
+	{ offsetof(TPMS_TAGGED_PROPERTY, property), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM_PT), 0, NULL },
+	{ offsetof(TPMS_TAGGED_PROPERTY, value), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+};
+const IfxMarshalTable g_sTPMS_TAGGED_PROPERTY_Table = { sizeof(TPMS_TAGGED_PROPERTY), 2, s_rgsTPMS_TAGGED_PROPERTY_Fields };
+
+static const IfxMarshalField s_rgsTPMS_TAGGED_PCR_SELECT_Fields[] =
+{
+	{ offsetof(TPMS_TAGGED_PCR_SELECT, tag), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM_PT), 0, NULL },
+	{ offsetof(TPMS_TAGGED_PCR_SELECT, sizeofSelect), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT8), 0, NULL },
+	{ offsetof(TPMS_TAGGED_PCR_SELECT, pcrSelect), TSS_FIELD_UINT8, TSS_FIELD_UINT8, offsetof(TPMS_TAGGED_PCR_SELECT, sizeofSelect), PCR_SELECT_MAX, sizeof(BYTE), 0, NULL },
+};
+const IfxMarshalTable g_sTPMS_TAGGED_PCR_SELECT_Table = { sizeof(TPMS_TAGGED_PCR_SELECT), 3, s_rgsTPMS_TAGGED_PCR_SELECT_Fields };
+
+static const IfxMarshalField s_rgsTPML_CC_Fields[] =
+{
+	{ offsetof(TPML_CC, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+	{ offsetof(TPML_CC, commandCodes), TSS_FIELD_UINT32, TSS_FIELD_UINT32, offsetof(TPML_CC, count), MAX_CAP_CC, sizeof(TPM_CC), 0, NULL },
+};
+const IfxMarshalTable g_sTPML_CC_Table = { sizeof(TPML_CC), 2, s_rgsTPML_CC_Fields };
+
+static const IfxMarshalField s_rgsTPML_CCA_Fields[] =
+{
+	{ offsetof(TPML_CCA, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+	{ offsetof(TPML_CCA, commandAttributes), TSS_FIELD_UINT32, TSS_FIELD_UINT32, offsetof(TPML_CCA, count), MAX_CAP_CC, sizeof(TPMA_CC), 0, NULL },
+};
+const IfxMarshalTable g_sTPML_CCA_Table = { sizeof(TPML_CCA), 2, s_rgsTPML_CCA_Fields };
+
+static const IfxMarshalField s_rgsTPML_HANDLE_Fields[] =
+{
+	{ offsetof(TPML_HANDLE, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+	{ offsetof(TPML_HANDLE, handle), TSS_FIELD_UINT32, TSS_FIELD_UINT32, offsetof(TPML_HANDLE, count), MAX_CAP_HANDLES, sizeof(TPM_HANDLE), 0, NULL },
+};
+const IfxMarshalTable g_sTPML_HANDLE_Table = { sizeof(TPML_HANDLE), 2, s_rgsTPML_HANDLE_Fields };
+
+static const IfxMarshalField s_rgsTPML_PCR_SELECTION_Fields[] =
+{
+	{ offsetof(TPML_PCR_SELECTION, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+	{ offsetof(TPML_PCR_SELECTION, pcrSelections), TSS_FIELD_STRUCT, TSS_FIELD_UINT32, offsetof(TPML_PCR_SELECTION, count), HASH_COUNT, sizeof(TPMS_PCR_SELECTION), 0, &g_sTPMS_PCR_SELECTION_Table },
+};
+const IfxMarshalTable g_sTPML_PCR_SELECTION_Table = { sizeof(TPML_PCR_SELECTION), 2, s_rgsTPML_PCR_SELECTION_Fields };
+
+static const IfxMarshalField s_rgsTPML_ALG_PROPERTY_Fields[] =
+{
+	{ offsetof(TPML_ALG_PROPERTY, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+	{ offsetof(TPML_ALG_PROPERTY, algProperties), TSS_FIELD_STRUCT, TSS_FIELD_UINT32, offsetof(TPML_ALG_PROPERTY, count), MAX_CAP_ALGS, sizeof(TPMS_ALG_PROPERTY), 0, &g_sTPMS_ALG_PROPERTY_Table },
+};
+const IfxMarshalTable g_sTPML_ALG_PROPERTY_Table = { sizeof(TPML_ALG_PROPERTY), 2, s_rgsTPML_ALG_PROPERTY_Fields };
+
+static const IfxMarshalField s_rgsTPML_TAGGED_TPM_PROPERTY_Fields[] =
+{
+	{ offsetof(TPML_TAGGED_TPM_PROPERTY, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+	{ offsetof(TPML_TAGGED_TPM_PROPERTY, tpmProperty), TSS_FIELD_STRUCT, TSS_FIELD_UINT32, offsetof(TPML_TAGGED_TPM_PROPERTY, count), MAX_TPM_PROPERTIES, sizeof(TPMS_TAGGED_PROPERTY), 0, &g_sTPMS_TAGGED_PROPERTY_Table },
+};
+const IfxMarshalTable g_sTPML_TAGGED_TPM_PROPERTY_Table = { sizeof(TPML_TAGGED_TPM_PROPERTY), 2, s_rgsTPML_TAGGED_TPM_PROPERTY_Fields };
+
+static const IfxMarshalField s_rgsTPML_TAGGED_PCR_PROPERTY_Fields[] =
+{
+	{ offsetof(TPML_TAGGED_PCR_PROPERTY, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+	{ offsetof(TPML_TAGGED_PCR_PROPERTY, pcrProperty), TSS_FIELD_STRUCT, TSS_FIELD_UINT32, offsetof(TPML_TAGGED_PCR_PROPERTY, count), MAX_PCR_PROPERTIES, sizeof(TPMS_TAGGED_PCR_SELECT), 0, &g_sTPMS_TAGGED_PCR_SELECT_Table },
+};
+const IfxMarshalTable g_sTPML_TAGGED_PCR_PROPERTY_Table = { sizeof(TPML_TAGGED_PCR_PROPERTY), 2, s_rgsTPML_TAGGED_PCR_PROPERTY_Fields };
+
+static const IfxMarshalField s_rgsTPML_ECC_CURVE_Fields[] =
+{
+	{ offsetof(TPML_ECC_CURVE, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(UINT32), 0, NULL },
+	{ offsetof(TPML_ECC_CURVE, eccCurves), TSS_FIELD_UINT16, TSS_FIELD_UINT32, offsetof(TPML_ECC_CURVE, count), MAX_ECC_CURVES, sizeof(TPM_ECC_CURVE), 0, NULL },
+};
+const IfxMarshalTable g_sTPML_ECC_CURVE_Table = { sizeof(TPML_ECC_CURVE), 2, s_rgsTPML_ECC_CURVE_Fields };
+
+static const IfxMarshalField s_rgsTPMS_CAPABILITY_DATA_Fields[] =
+{
+	{ offsetof(TPMS_CAPABILITY_DATA, capability), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM_CAP), 0, NULL },
+	{ offsetof(TPMS_CAPABILITY_DATA, data), TSS_FIELD_UNION, TSS_FIELD_UINT32, offsetof(TPMS_CAPABILITY_DATA, capability), 1, sizeof(TPMU_CAPABILITIES), 0, &g_sTPMU_CAPABILITIES_Union },
+};
+const IfxMarshalTable g_sTPMS_CAPABILITY_DATA_Table = { sizeof(TPMS_CAPABILITY_DATA), 2, s_rgsTPMS_CAPABILITY_DATA_Fields };
+
+static const IfxMarshalUnionArm s_rgsTPMU_CAPABILITIES_Arms[] =
+{
+	{ TPM_CAP_ALGS, { offsetof(TPMU_CAPABILITIES, algorithms), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_ALG_PROPERTY), 0, &g_sTPML_ALG_PROPERTY_Table } },
+	{ TPM_CAP_HANDLES, { offsetof(TPMU_CAPABILITIES, handles), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_HANDLE), 0, &g_sTPML_HANDLE_Table } },
+	{ TPM_CAP_COMMANDS, { offsetof(TPMU_CAPABILITIES, command), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_CCA), 0, &g_sTPML_CCA_Table } },
+	{ TPM_CAP_PP_COMMANDS, { offsetof(TPMU_CAPABILITIES, ppCommands), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_CC), 0, &g_sTPML_CC_Table } },
+	{ TPM_CAP_AUDIT_COMMANDS, { offsetof(TPMU_CAPABILITIES, auditCommands), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_CC), 0, &g_sTPML_CC_Table } },
+	{ TPM_CAP_PCRS, { offsetof(TPMU_CAPABILITIES, assignedPCR), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_PCR_SELECTION), 0, &g_sTPML_PCR_SELECTION_Table } },
+	{ TPM_CAP_TPM_PROPERTIES, { offsetof(TPMU_CAPABILITIES, tpmProperties), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_TAGGED_TPM_PROPERTY), 0, &g_sTPML_TAGGED_TPM_PROPERTY_Table } },
+	{ TPM_CAP_PCR_PROPERTIES, { offsetof(TPMU_CAPABILITIES, pcrProperties), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_TAGGED_PCR_PROPERTY), 0, &g_sTPML_TAGGED_PCR_PROPERTY_Table } },
+	{ TPM_CAP_ECC_CURVES, { offsetof(TPMU_CAPABILITIES, eccCurves), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_ECC_CURVE), 0, &g_sTPML_ECC_CURVE_Table } },
+	{ TPM_CAP_VENDOR_PROPERTY, { offsetof(TPMU_VENDOR_CAPABILITY, vendorData), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPML_MAX_BUFFER), 0, &g_sTPML_MAX_BUFFER_Table } },
+};
+const IfxMarshalUnion g_sTPMU_CAPABILITIES_Union = { 10, s_rgsTPMU_CAPABILITIES_Arms };
+
+static const IfxMarshalField s_rgsTPML_MAX_BUFFER_Fields[] =
+{
+	{ offsetof(TPML_MAX_BUFFER, count), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(uint32_t), 0, NULL },
+	{ offsetof(TPML_MAX_BUFFER, buffer), TSS_FIELD_STRUCT, TSS_FIELD_UINT32, offsetof(TPML_MAX_BUFFER, count), 1, sizeof(TPM2B_MAX_BUFFER), 0, &g_sTPM2B_MAX_BUFFER_Table },
+};
+const IfxMarshalTable g_sTPML_MAX_BUFFER_Table = { sizeof(TPML_MAX_BUFFER), 2, s_rgsTPML_MAX_BUFFER_Fields };
+
+static const IfxMarshalField s_rgsTPMT_SYM_DEF_Fields[] =
+{
+	{ offsetof(TPMT_SYM_DEF, algorithm), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_ALG_SYM), 0, NULL },
+	{ offsetof(TPMT_SYM_DEF, keyBits), TSS_FIELD_UNION, TSS_FIELD_UINT16, offsetof(TPMT_SYM_DEF, algorithm), 1, sizeof(TPMU_SYM_KEY_BITS), 0, &g_sTPMU_SYM_KEY_BITS_Union },
+	{ offsetof(TPMT_SYM_DEF, mode), TSS_FIELD_UNION, TSS_FIELD_UINT16, offsetof(TPMT_SYM_DEF, algorithm), 1, sizeof(TPMU_SYM_MODE), 0, &g_sTPMU_SYM_MODE_Union },
+};
+const IfxMarshalTable g_sTPMT_SYM_DEF_Table = { sizeof(TPMT_SYM_DEF), 3, s_rgsTPMT_SYM_DEF_Fields };
+
+static const IfxMarshalUnionArm s_rgsTPMU_SYM_KEY_BITS_Arms[] =
+{
+	{ TPM_ALG_AES, { offsetof(TPMU_SYM_KEY_BITS, aes), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_AES_KEY_BITS), 0, NULL } },
+	{ TPM_ALG_SM4, { offsetof(TPMU_SYM_KEY_BITS, sm4), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_SM4_KEY_BITS), 0, NULL } },
+	{ TPM_ALG_CAMELLIA, { offsetof(TPMU_SYM_KEY_BITS, camellia), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_CAMELLIA_KEY_BITS), 0, NULL } },
+	{ TPM_ALG_XOR, { offsetof(TPMU_SYM_KEY_BITS, xor), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_ALG_HASH), 0, NULL } },
+	{ TPM_ALG_NULL, { 0, TSS_FIELD_EMPTY, TSS_FIELD_EMPTY, 0, 0, 0, 0, NULL } },
+};
+const IfxMarshalUnion g_sTPMU_SYM_KEY_BITS_Union = { 5, s_rgsTPMU_SYM_KEY_BITS_Arms };
+
+static const IfxMarshalUnionArm s_rgsTPMU_SYM_MODE_Arms[] =
+{
+	{ TPM_ALG_AES, { offsetof(TPMU_SYM_MODE, aes), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_ALG_SYM_MODE), 0, NULL } },
+	{ TPM_ALG_SM4, { offsetof(TPMU_SYM_MODE, sm4), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_ALG_SYM_MODE), 0, NULL } },
+	{ TPM_ALG_CAMELLIA, { offsetof(TPMU_SYM_MODE, camellia), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_ALG_SYM_MODE), 0, NULL } },
+	{ TPM_ALG_NULL, { 0, TSS_FIELD_EMPTY, TSS_FIELD_EMPTY, 0, 0, 0, 0, NULL } },
+};
+const IfxMarshalUnion g_sTPMU_SYM_MODE_Union = { 4, s_rgsTPMU_SYM_MODE_Arms };
+
+static const IfxMarshalField s_rgsAuthorizationCommandData_Fields[] =
+{
+	{ offsetof(AuthorizationCommandData, authHandle), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMI_SH_AUTH_SESSION), 0, NULL },
+	{ offsetof(AuthorizationCommandData, nonceCaller), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM2B_NONCE), 0, &g_sTPM2B_DIGEST_Table },
+	{ offsetof(AuthorizationCommandData, sessionAttributes), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMA_SESSION), 0, NULL },
+	{ offsetof(AuthorizationCommandData, hmac), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM2B_AUTH), 0, &g_sTPM2B_DIGEST_Table },
+};
+const IfxMarshalTable g_sAuthorizationCommandData_Table = { sizeof(AuthorizationCommandData), 4, s_rgsAuthorizationCommandData_Fields };
+
+static const IfxMarshalField s_rgsAcknowledgmentResponseData_Fields[] =
+{
+	{ offsetof(AcknowledgmentResponseData, nonceTPM), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM2B_NONCE), 0, &g_sTPM2B_DIGEST_Table },
+	{ offsetof(AcknowledgmentResponseData, sessionAttributes), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 1, sizeof(TPMA_SESSION), 0, NULL },
+	{ offsetof(AcknowledgmentResponseData, hmac), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(TPM2B_AUTH), 0, &g_sTPM2B_DIGEST_Table },
+};
+const IfxMarshalTable g_sAcknowledgmentResponseData_Table = { sizeof(AcknowledgmentResponseData), 3, s_rgsAcknowledgmentResponseData_Fields };
+
+static const IfxMarshalField s_rgssMessageDigest_d_Fields[] =
+{
+	{ offsetof(sMessageDigest_d, wSize), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sMessageDigest_d, rgbMessageDigest), TSS_FIELD_UINT8, TSS_FIELD_UINT16, offsetof(sMessageDigest_d, wSize), 32, sizeof(uint8_t), 0, NULL },
+};
+const IfxMarshalTable g_sMessageDigest_d_Table = { sizeof(sMessageDigest_d), 2, s_rgssMessageDigest_d_Fields };
+
+static const IfxMarshalField s_rgssFirmwarePackage_d_Fields[] =
+{
+	{ offsetof(sFirmwarePackage_d, FwPackageIdentifier), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(uint32_t), 0, NULL },
+	{ offsetof(sFirmwarePackage_d, Version), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(VersionNumber_d), 0, NULL },
+	{ offsetof(sFirmwarePackage_d, StaleVersion), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(VersionNumber_d), 0, NULL },
+};
+const IfxMarshalTable g_sFirmwarePackage_d_Table = { sizeof(sFirmwarePackage_d), 3, s_rgssFirmwarePackage_d_Fields };
+
+static const IfxMarshalField s_rgssFirmwarePackages_d_Fields[] =
+{
+	{ offsetof(sFirmwarePackages_d, wEntries), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sFirmwarePackages_d, FirmwarePackage), TSS_FIELD_STRUCT, TSS_FIELD_UINT16, offsetof(sFirmwarePackages_d, wEntries), MAX_NUM_FW_PACKAGES_DEVICE, sizeof(sFirmwarePackage_d), 0, &g_sFirmwarePackage_d_Table },
+};
+const IfxMarshalTable g_sFirmwarePackages_d_Table = { sizeof(sFirmwarePackages_d), 2, s_rgssFirmwarePackages_d_Fields };
+
+static const IfxMarshalField s_rgssVersions_d_Fields[] =
+{
+	{ offsetof(sVersions_d, internal1), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(uint32_t), 0, NULL },
+	{ offsetof(sVersions_d, wEntries), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sVersions_d, Version), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 8, sizeof(VersionNumber_d), 0, NULL },
+};
+const IfxMarshalTable g_sVersions_d_Table = { sizeof(sVersions_d), 3, s_rgssVersions_d_Fields };
+
+static const IfxMarshalField s_rgssSignedAttributes_d_Fields[] =
+{
+	{ offsetof(sSignedAttributes_d, internal1), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignedAttributes_d, internal2), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 6, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSignedAttributes_d, internal3), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignedAttributes_d, sMessageDigest), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sMessageDigest_d), 0, &g_sMessageDigest_d_Table },
+	{ offsetof(sSignedAttributes_d, sFirmwarePackage), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sFirmwarePackage_d), 0, &g_sFirmwarePackage_d_Table },
+	{ offsetof(sSignedAttributes_d, internal6), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 34, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSignedAttributes_d, internal7), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 34, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSignedAttributes_d, internal8), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 16, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSignedAttributes_d, DecryptKeyId), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(DecryptKeyId_d), 0, NULL },
+	{ offsetof(sSignedAttributes_d, internal10), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 20, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSignedAttributes_d, sVersions), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sVersions_d), 0, &g_sVersions_d_Table },
+	{ offsetof(sSignedAttributes_d, internal12), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 66, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSignedAttributes_d, internal13), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 42, sizeof(uint8_t), 0, NULL },
+};
+const IfxMarshalTable g_sSignedAttributes_d_Table = { sizeof(sSignedAttributes_d), 13, s_rgssSignedAttributes_d_Fields };
+
+static const IfxMarshalField s_rgssSignerInfo_d_Fields[] =
+{
+	{ offsetof(sSignerInfo_d, internal1), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignerInfo_d, internal2), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(uint32_t), 0, NULL },
+	{ offsetof(sSignerInfo_d, internal3), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignerInfo_d, internal4), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignerInfo_d, internal5), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignerInfo_d, sSignedAttributes), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sSignedAttributes_d), 0, &g_sSignedAttributes_d_Table },
+	{ offsetof(sSignerInfo_d, internal7), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignerInfo_d, internal8), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 256, sizeof(uint8_t), 0, NULL },
+};
+const IfxMarshalTable g_sSignerInfo_d_Table = { sizeof(sSignerInfo_d), 8, s_rgssSignerInfo_d_Fields };
+
+static const IfxMarshalField s_rgssSignedData_d_Fields[] =
+{
+	{ offsetof(sSignedData_d, internal1), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignedData_d, internal2), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignedData_d, wSignerInfoSize), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSignedData_d, sSignerInfo), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sSignerInfo_d), 0, &g_sSignerInfo_d_Table },
+};
+const IfxMarshalTable g_sSignedData_d_Table = { sizeof(sSignedData_d), 4, s_rgssSignedData_d_Fields };
+
+static const IfxMarshalField s_rgssSecurityModuleLogic_d_Fields[] =
+{
+	{ offsetof(sSecurityModuleLogic_d, internal1), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogic_d, internal2), TSS_FIELD_UINT32, TSS_FIELD_EMPTY, 0, 1, sizeof(uint32_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogic_d, internal3), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 34, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogic_d, sBootloaderFirmwarePackage), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sFirmwarePackage_d), 0, &g_sFirmwarePackage_d_Table },
+	{ offsetof(sSecurityModuleLogic_d, sFirmwareConfiguration), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sFirmwarePackages_d), 0, &g_sFirmwarePackages_d_Table },
+};
+const IfxMarshalTable g_sSecurityModuleLogic_d_Table = { sizeof(sSecurityModuleLogic_d), 5, s_rgssSecurityModuleLogic_d_Fields };
+
+static const IfxMarshalField s_rgssKeyList_d_Fields[] =
+{
+	{ offsetof(sKeyList_d, wEntries), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sKeyList_d, internal2), TSS_FIELD_UINT32, TSS_FIELD_UINT16, offsetof(sKeyList_d, wEntries), 4, sizeof(uint32_t), TSS_FIELD_FLAG_EXACT_COUNT, NULL },
+	{ offsetof(sKeyList_d, DecryptKeyId), TSS_FIELD_UINT32, TSS_FIELD_UINT16, offsetof(sKeyList_d, wEntries), 4, sizeof(DecryptKeyId_d), TSS_FIELD_FLAG_EXACT_COUNT, NULL },
+};
+const IfxMarshalTable g_sKeyList_d_Table = { sizeof(sKeyList_d), 3, s_rgssKeyList_d_Fields };
+
+static const IfxMarshalField s_rgssSecurityModuleLogicInfo_d_Fields[] =
+{
+	{ offsetof(sSecurityModuleLogicInfo_d, internal1), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo_d, wMaxDataSize), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo_d, sSecurityModuleLogic), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sSecurityModuleLogic_d), 0, &g_sSecurityModuleLogic_d_Table },
+	{ offsetof(sSecurityModuleLogicInfo_d, SecurityModuleStatus), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(SecurityModuleStatus_d), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo_d, sProcessFirmwarePackage), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sFirmwarePackage_d), 0, &g_sFirmwarePackage_d_Table },
+	{ offsetof(sSecurityModuleLogicInfo_d, internal6), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo_d, internal7), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 6, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo_d, wFieldUpgradeCounter), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+};
+const IfxMarshalTable g_sSecurityModuleLogicInfo_d_Table = { sizeof(sSecurityModuleLogicInfo_d), 8, s_rgssSecurityModuleLogicInfo_d_Fields };
+
+static const IfxMarshalField s_rgssSecurityModuleLogicInfo2_d_Fields[] =
+{
+	{ offsetof(sSecurityModuleLogicInfo2_d, internal1), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo2_d, wMaxDataSize), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo2_d, sSecurityModuleLogic), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sSecurityModuleLogic_d), 0, &g_sSecurityModuleLogic_d_Table },
+	{ offsetof(sSecurityModuleLogicInfo2_d, SecurityModuleStatus), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(SecurityModuleStatus_d), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo2_d, sProcessFirmwarePackage), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sFirmwarePackage_d), 0, &g_sFirmwarePackage_d_Table },
+	{ offsetof(sSecurityModuleLogicInfo2_d, internal6), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo2_d, internal7), TSS_FIELD_UINT8, TSS_FIELD_EMPTY, 0, 6, sizeof(uint8_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo2_d, wFieldUpgradeCounter), TSS_FIELD_UINT16, TSS_FIELD_EMPTY, 0, 1, sizeof(uint16_t), 0, NULL },
+	{ offsetof(sSecurityModuleLogicInfo2_d, sKeyList), TSS_FIELD_STRUCT, TSS_FIELD_EMPTY, 0, 1, sizeof(sKeyList_d), 0, &g_sKeyList_d_Table },
+};
+const IfxMarshalTable g_sSecurityModuleLogicInfo2_d_Table = { sizeof(sSecurityModuleLogicInfo2_d), 9, s_rgssSecurityModuleLogicInfo2_d_Fields };
@@ -0,0 +1,99 @@
+﻿/**
+ *	@brief		Declares the generated marshal tables of the TPM2.0 structures
+ *	@details	This file is generated by GenerateMarshalTables.py from TPM2_Types.h and TPM2_FieldUpgradeTypes.h. Do not edit.
+ *	@file		TPM2_MarshalTables.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "TPM2_MarshalTable.h"
+#include "TPM2_FieldUpgradeTypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Marshal table of the TPM2B_DIGEST structure
+extern const IfxMarshalTable g_sTPM2B_DIGEST_Table;
+/// Marshal table of the TPM2B_MAX_BUFFER structure
+extern const IfxMarshalTable g_sTPM2B_MAX_BUFFER_Table;
+/// Marshal table of the TPM2B_TIMEOUT structure
+extern const IfxMarshalTable g_sTPM2B_TIMEOUT_Table;
+/// Marshal table of the TPM2B_ENCRYPTED_SECRET structure
+extern const IfxMarshalTable g_sTPM2B_ENCRYPTED_SECRET_Table;
+/// Marshal table of the TPMS_PCR_SELECTION structure
+extern const IfxMarshalTable g_sTPMS_PCR_SELECTION_Table;
+/// Marshal table of the TPMT_TK_AUTH structure
+extern const IfxMarshalTable g_sTPMT_TK_AUTH_Table;
+/// Marshal table of the TPMS_ALG_PROPERTY structure
+extern const IfxMarshalTable g_sTPMS_ALG_PROPERTY_Table;
+/// Marshal table of the TPMS_TAGGED_PROPERTY structure
+extern const IfxMarshalTable g_sTPMS_TAGGED_PROPERTY_Table;
+/// Marshal table of the TPMS_TAGGED_PCR_SELECT structure
+extern const IfxMarshalTable g_sTPMS_TAGGED_PCR_SELECT_Table;
+/// Marshal table of the TPML_CC structure
+extern const IfxMarshalTable g_sTPML_CC_Table;
+/// Marshal table of the TPML_CCA structure
+extern const IfxMarshalTable g_sTPML_CCA_Table;
+/// Marshal table of the TPML_HANDLE structure
+extern const IfxMarshalTable g_sTPML_HANDLE_Table;
+/// Marshal table of the TPML_PCR_SELECTION structure
+extern const IfxMarshalTable g_sTPML_PCR_SELECTION_Table;
+/// Marshal table of the TPML_ALG_PROPERTY structure
+extern const IfxMarshalTable g_sTPML_ALG_PROPERTY_Table;
+/// Marshal table of the TPML_TAGGED_TPM_PROPERTY structure
+extern const IfxMarshalTable g_sTPML_TAGGED_TPM_PROPERTY_Table;
+/// Marshal table of the TPML_TAGGED_PCR_PROPERTY structure
+extern const IfxMarshalTable g_sTPML_TAGGED_PCR_PROPERTY_Table;
+/// Marshal table of the TPML_ECC_CURVE structure
+extern const IfxMarshalTable g_sTPML_ECC_CURVE_Table;
+/// Marshal table of the TPMS_CAPABILITY_DATA structure
+extern const IfxMarshalTable g_sTPMS_CAPABILITY_DATA_Table;
+/// Marshal table of the TPMU_CAPABILITIES union
+extern const IfxMarshalUnion g_sTPMU_CAPABILITIES_Union;
+/// Marshal table of the TPML_MAX_BUFFER structure
+extern const IfxMarshalTable g_sTPML_MAX_BUFFER_Table;
+/// Marshal table of the TPMT_SYM_DEF structure
+extern const IfxMarshalTable g_sTPMT_SYM_DEF_Table;
+/// Marshal table of the TPMU_SYM_KEY_BITS union
+extern const IfxMarshalUnion g_sTPMU_SYM_KEY_BITS_Union;
+/// Marshal table of the TPMU_SYM_MODE union
+extern const IfxMarshalUnion g_sTPMU_SYM_MODE_Union;
+/// Marshal table of the AuthorizationCommandData structure
+extern const IfxMarshalTable g_sAuthorizationCommandData_Table;
+/// Marshal table of the AcknowledgmentResponseData structure
+extern const IfxMarshalTable g_sAcknowledgmentResponseData_Table;
+/// Marshal table of the sMessageDigest_d structure
+extern const IfxMarshalTable g_sMessageDigest_d_Table;
+/// Marshal table of the sFirmwarePackage_d structure
+extern const IfxMarshalTable g_sFirmwarePackage_d_Table;
+/// Marshal table of the sFirmwarePackages_d structure
+extern const IfxMarshalTable g_sFirmwarePackages_d_Table;
+/// Marshal table of the sVersions_d structure
+extern const IfxMarshalTable g_sVersions_d_Table;
+/// Marshal table of the sSignedAttributes_d structure
+extern const IfxMarshalTable g_sSignedAttributes_d_Table;
+/// Marshal table of the sSignerInfo_d structure
+extern const IfxMarshalTable g_sSignerInfo_d_Table;
+/// Marshal table of the sSignedData_d structure
+extern const IfxMarshalTable g_sSignedData_d_Table;
+/// Marshal table of the sSecurityModuleLogic_d structure
+extern const IfxMarshalTable g_sSecurityModuleLogic_d_Table;
+/// Marshal table of the sKeyList_d structure
+extern const IfxMarshalTable g_sKeyList_d_Table;
+/// Marshal table of the sSecurityModuleLogicInfo_d structure
+extern const IfxMarshalTable g_sSecurityModuleLogicInfo_d_Table;
+/// Marshal table of the sSecurityModuleLogicInfo2_d structure
+extern const IfxMarshalTable g_sSecurityModuleLogicInfo2_d_Table;
+
+#ifdef __cplusplus
+}
+#endif
@@ -18,6 +18,7 @@
 #include <time.h>
 #include <wctype.h>
 #include <unistd.h>
+#include <pthread.h>
 #include "StdInclude.h"
 #include "Platform.h"
 
@@ -835,6 +836,311 @@ Platform_SleepMicroSeconds(
 	usleep(PunSleepTime);
 }
 
+/**
+ *	@brief		Gets a monotonic time stamp in microseconds
+ *	@details	The time stamp is not related to the wall clock time and is not affected by changes of the system time.
+ *				It is only suitable to measure time intervals.
+ *
+ *	@returns	Monotonic time stamp in microseconds
+ */
+unsigned long long
+Platform_GetMonotonicTimeMicroSeconds()
+{
+	struct timespec sTimespec;
+
+	if (0 != clock_gettime(CLOCK_MONOTONIC, &sTimespec))
+		return 0;
+
+	return (unsigned long long)sTimespec.tv_sec * 1000000ULL + (unsigned long long)sTimespec.tv_nsec / 1000ULL;
+}
+
+/// Thread handle as returned by Platform_ThreadCreate
+typedef struct tdIfxPlatformThread
+{
+	/// POSIX thread
+	pthread_t					sThread;
+	/// Routine executed by the thread
+	PFN_PLATFORM_THREAD_ROUTINE	pfnRoutine;
+	/// Context passed to the routine
+	void*						pContext;
+} IfxPlatformThread;
+
+/**
+ *	@brief		Start routine of the POSIX thread
+ *	@details	Calls the routine given to Platform_ThreadCreate.
+ *
+ *	@param		PpThread		Thread handle
+ *	@returns	Always NULL
+ */
+static
+void*
+Platform_ThreadStart(
+	_In_ void* PpThread)
+{
+	IfxPlatformThread* pThread = (IfxPlatformThread*)PpThread;
+
+	pThread->pfnRoutine(pThread->pContext);
+
+	return NULL;
+}
+
+/**
+ *	@brief		Starts a thread
+ *	@details	Starts a new thread executing the given routine. The thread must be joined with Platform_ThreadJoin.
+ *
+ *	@param		PfnRoutine				Routine to be executed by the thread
+ *	@param		PpContext				Context passed to the routine (optional, can be NULL)
+ *	@param		PppThread				Receives the handle of the started thread
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+Platform_ThreadCreate(
+	_In_		PFN_PLATFORM_THREAD_ROUTINE	PfnRoutine,
+	_In_opt_	void*						PpContext,
+	_Out_		void**						PppThread)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	IfxPlatformThread* pThread = NULL;
+
+	do
+	{
+		// Check parameters
+		if (NULL == PfnRoutine || NULL == PppThread)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		*PppThread = NULL;
+
+		pThread = (IfxPlatformThread*)Platform_MemoryAllocateZero(sizeof(IfxPlatformThread));
+		if (NULL == pThread)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		pThread->pfnRoutine = PfnRoutine;
+		pThread->pContext = PpContext;
+		if (0 != pthread_create(&pThread->sThread, NULL, Platform_ThreadStart, pThread))
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		*PppThread = pThread;
+		pThread = NULL;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&pThread);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Waits for a thread to finish
+ *	@details	Waits until the given thread has returned from its routine and releases the thread handle.
+ *
+ *	@param		PppThread				Handle of the thread, set to NULL in case of success
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+Platform_ThreadJoin(
+	_Inout_ void** PppThread)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		// Check parameters
+		if (NULL == PppThread || NULL == *PppThread)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		if (0 != pthread_join(((IfxPlatformThread*)*PppThread)->sThread, NULL))
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		Platform_MemoryFree(PppThread);
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/// Condition handle as returned by Platform_ConditionCreate
+typedef struct tdIfxPlatformCondition
+{
+	/// POSIX mutex protecting the state the condition is about
+	pthread_mutex_t				sMutex;
+	/// POSIX condition variable
+	pthread_cond_t				sCondition;
+} IfxPlatformCondition;
+
+/**
+ *	@brief		Creates a condition
+ *	@details	A condition combines a mutex with a condition variable. Threads wait on the condition with
+ *				Platform_ConditionWait until another thread calls Platform_ConditionSignal. The condition must be
+ *				released with Platform_ConditionDestroy.
+ *
+ *	@param		PppCondition			Receives the handle of the created condition
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+Platform_ConditionCreate(
+	_Out_ void** PppCondition)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	IfxPlatformCondition* pCondition = NULL;
+
+	do
+	{
+		// Check parameters
+		if (NULL == PppCondition)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		*PppCondition = NULL;
+
+		pCondition = (IfxPlatformCondition*)Platform_MemoryAllocateZero(sizeof(IfxPlatformCondition));
+		if (NULL == pCondition)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		if (0 != pthread_mutex_init(&pCondition->sMutex, NULL))
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		if (0 != pthread_cond_init(&pCondition->sCondition, NULL))
+		{
+			pthread_mutex_destroy(&pCondition->sMutex);
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		*PppCondition = pCondition;
+		pCondition = NULL;
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&pCondition);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Releases a condition
+ *	@details	No thread may wait on the condition anymore.
+ *
+ *	@param		PppCondition			Handle of the condition, set to NULL
+ */
+void
+Platform_ConditionDestroy(
+	_Inout_ void** PppCondition)
+{
+	if (NULL != PppCondition && NULL != *PppCondition)
+	{
+		IfxPlatformCondition* pCondition = (IfxPlatformCondition*)*PppCondition;
+
+		pthread_cond_destroy(&pCondition->sCondition);
+		pthread_mutex_destroy(&pCondition->sMutex);
+		Platform_MemoryFree(PppCondition);
+	}
+}
+
+/**
+ *	@brief		Locks the mutex of a condition
+ *	@details
+ *
+ *	@param		PpCondition				Handle of the condition
+ */
+void
+Platform_ConditionLock(
+	_In_ void* PpCondition)
+{
+	pthread_mutex_lock(&((IfxPlatformCondition*)PpCondition)->sMutex);
+}
+
+/**
+ *	@brief		Unlocks the mutex of a condition
+ *	@details
+ *
+ *	@param		PpCondition				Handle of the condition
+ */
+void
+Platform_ConditionUnlock(
+	_In_ void* PpCondition)
+{
+	pthread_mutex_unlock(&((IfxPlatformCondition*)PpCondition)->sMutex);
+}
+
+/**
+ *	@brief		Waits for a condition to be signaled
+ *	@details	The mutex of the condition must be locked by the caller. It is unlocked while waiting and locked again
+ *				before the function returns. Spurious wake ups are possible, so the caller must check its state again.
+ *
+ *	@param		PpCondition				Handle of the condition
+ */
+void
+Platform_ConditionWait(
+	_In_ void* PpCondition)
+{
+	IfxPlatformCondition* pCondition = (IfxPlatformCondition*)PpCondition;
+
+	pthread_cond_wait(&pCondition->sCondition, &pCondition->sMutex);
+}
+
+/**
+ *	@brief		Signals a condition
+ *	@details	Wakes up all threads waiting on the condition. The mutex of the condition must be locked by the caller.
+ *
+ *	@param		PpCondition				Handle of the condition
+ */
+void
+Platform_ConditionSignal(
+	_In_ void* PpCondition)
+{
+	pthread_cond_broadcast(&((IfxPlatformCondition*)PpCondition)->sCondition);
+}
+
+/**
+ *	@brief		Gets the number of online processors
+ *	@details	Used to size worker pools.
+ *
+ *	@returns	Number of processors that are currently online, at least 1
+ */
+unsigned int
+Platform_GetProcessorCount()
+{
+	long lProcessorCount = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (lProcessorCount < 1)
+		return 1;
+
+	return (unsigned int)lProcessorCount;
+}
+
 /**
  *	@brief		Swaps a UINT16
  *	@details
@@ -380,6 +380,127 @@ void
 Platform_SleepMicroSeconds(
 	_In_ unsigned int PunSleepTime);
 
+/**
+ *	@brief		Gets a monotonic time stamp in microseconds
+ *	@details	The time stamp is not related to the wall clock time and is not affected by changes of the system time.
+ *				It is only suitable to measure time intervals.
+ *
+ *	@returns	Monotonic time stamp in microseconds
+ */
+unsigned long long
+Platform_GetMonotonicTimeMicroSeconds();
+
+/// Routine executed by a thread started with Platform_ThreadCreate
+typedef void (*PFN_PLATFORM_THREAD_ROUTINE)(void* PpContext);
+
+/**
+ *	@brief		Starts a thread
+ *	@details	Starts a new thread executing the given routine. The thread must be joined with Platform_ThreadJoin.
+ *
+ *	@param		PfnRoutine				Routine to be executed by the thread
+ *	@param		PpContext				Context passed to the routine (optional, can be NULL)
+ *	@param		PppThread				Receives the handle of the started thread
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+Platform_ThreadCreate(
+	_In_		PFN_PLATFORM_THREAD_ROUTINE	PfnRoutine,
+	_In_opt_	void*						PpContext,
+	_Out_		void**						PppThread);
+
+/**
+ *	@brief		Waits for a thread to finish
+ *	@details	Waits until the given thread has returned from its routine and releases the thread handle.
+ *
+ *	@param		PppThread				Handle of the thread, set to NULL in case of success
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+Platform_ThreadJoin(
+	_Inout_ void** PppThread);
+
+/**
+ *	@brief		Creates a condition
+ *	@details	A condition combines a mutex with a condition variable. Threads wait on the condition with
+ *				Platform_ConditionWait until another thread calls Platform_ConditionSignal. The condition must be
+ *				released with Platform_ConditionDestroy.
+ *
+ *	@param		PppCondition			Receives the handle of the created condition
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+Platform_ConditionCreate(
+	_Out_ void** PppCondition);
+
+/**
+ *	@brief		Releases a condition
+ *	@details	No thread may wait on the condition anymore.
+ *
+ *	@param		PppCondition			Handle of the condition, set to NULL
+ */
+void
+Platform_ConditionDestroy(
+	_Inout_ void** PppCondition);
+
+/**
+ *	@brief		Locks the mutex of a condition
+ *	@details
+ *
+ *	@param		PpCondition				Handle of the condition
+ */
+void
+Platform_ConditionLock(
+	_In_ void* PpCondition);
+
+/**
+ *	@brief		Unlocks the mutex of a condition
+ *	@details
+ *
+ *	@param		PpCondition				Handle of the condition
+ */
+void
+Platform_ConditionUnlock(
+	_In_ void* PpCondition);
+
+/**
+ *	@brief		Waits for a condition to be signaled
+ *	@details	The mutex of the condition must be locked by the caller. It is unlocked while waiting and locked again
+ *				before the function returns. Spurious wake ups are possible, so the caller must check its state again.
+ *
+ *	@param		PpCondition				Handle of the condition
+ */
+void
+Platform_ConditionWait(
+	_In_ void* PpCondition);
+
+/**
+ *	@brief		Signals a condition
+ *	@details	Wakes up all threads waiting on the condition. The mutex of the condition must be locked by the caller.
+ *
+ *	@param		PpCondition				Handle of the condition
+ */
+void
+Platform_ConditionSignal(
+	_In_ void* PpCondition);
+
+/**
+ *	@brief		Gets the number of online processors
+ *	@details	Used to size worker pools.
+ *
+ *	@returns	Number of processors that are currently online, at least 1
+ */
+unsigned int
+Platform_GetProcessorCount();
+
 /**
  *	@brief		Swaps a UINT16
  *	@details
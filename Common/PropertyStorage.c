@@ -1,7 +1,8 @@
 ﻿/**
  *	@brief		Implements property storage methods
  *	@details	This module provides a storage for all properties collected during the
- *				program execution.
+ *				program execution. Keys are interned into an open addressing hash table and
+ *				values are converted to their typed representations once when written.
  *	@file		PropertyStorage.c
  *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
  *
@@ -13,95 +14,457 @@
  *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
-
 #include "PropertyStorage.h"
 #include "Utility.h"
 
-/// Pointer to the first element in the list
-IfxPropertyElement* s_pvHead = NULL;
+/// Array of all interned elements; the position of an element never changes, so (index + 1) serves as its handle
+static IfxPropertyElement* s_rgsElements = NULL;
+
+/// Number of interned elements in s_rgsElements
+static unsigned int s_unElementCount = 0;
+
+/// Number of elements s_rgsElements has been allocated for
+static unsigned int s_unElementCapacity = 0;
+
+/// Open addressing hash index over the interned keys; each slot holds a handle or PROPERTY_STORAGE_INVALID_HANDLE if unused
+static unsigned int* s_rgunHashIndex = NULL;
 
-/// Pointer to the last element in the list
-IfxPropertyElement* s_pvTail = NULL;
+/// Number of slots in s_rgunHashIndex (always a power of two and twice the element capacity)
+static unsigned int s_unHashIndexSize = 0;
 
 /**
- *	@brief		Add a key value pair to the PropertyStorage
- *	@details	Operation fails in case an element with same key already exists.
+ *	@brief		Calculate the hash value of a key
+ *	@details	Local helper method calculating a FNV-1a hash over the wide characters of the key.
  *
- *	@param		PwszKey			Unique key identifier for the PropertyElement to be added\n
+ *	@param		PwszKey			Key to calculate the hash for\n
  *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_KEY
- *	@param		PwszValue		Pointer to a wide char array containing the value\n
- *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_VALUE
  *
- *	@retval		TRUE		If the element has been added
- *	@retval		FALSE		If the element could not be added, e.g. because element with same key already exists
+ *	@returns	The hash value of the key
+ */
+_Check_return_
+static
+unsigned int
+PropertyStorage_HashKey(
+	_In_z_ const wchar_t* PwszKey)
+{
+	unsigned int unHash = PROPERTY_STORAGE_HASH_OFFSET_BASIS;
+	unsigned int unIndex = 0;
+
+	for (unIndex = 0; unIndex < PROPERTY_STORAGE_MAX_KEY && L'\0' != PwszKey[unIndex]; unIndex++)
+	{
+		unHash ^= (unsigned int)PwszKey[unIndex];
+		unHash *= PROPERTY_STORAGE_HASH_PRIME;
+	}
+
+	return unHash;
+}
+
+/**
+ *	@brief		Insert an interned element into the hash index
+ *	@details	Local helper method. The hash index must have at least one unused slot.
+ *
+ *	@param		PunHandle		Handle of the element to be inserted
+ */
+static
+void
+PropertyStorage_InsertIntoHashIndex(
+	_In_ unsigned int PunHandle)
+{
+	unsigned int unMask = s_unHashIndexSize - 1;
+	unsigned int unSlot = s_rgsElements[PunHandle - 1].unHash & unMask;
+
+	// Linear probing until an unused slot has been found
+	while (PROPERTY_STORAGE_INVALID_HANDLE != s_rgunHashIndex[unSlot])
+		unSlot = (unSlot + 1) & unMask;
+
+	s_rgunHashIndex[unSlot] = PunHandle;
+}
+
+/**
+ *	@brief		Grow the element array and the hash index
+ *	@details	Local helper method doubling the capacity of the PropertyStorage and rebuilding the hash index.
+ *				Existing handles stay valid.
+ *
+ *	@retval		TRUE		If the capacity has been increased
+ *	@retval		FALSE		If memory allocation failed
  */
 _Check_return_
+static
 BOOL
-PropertyStorage_AddKeyValuePair(
-	_In_z_	const wchar_t*	PwszKey,
-	_In_z_	const wchar_t*	PwszValue)
+PropertyStorage_Grow()
 {
 	BOOL fReturnValue = FALSE;
-	IfxPropertyElement* pElement = NULL;
+	IfxPropertyElement* rgsElements = NULL;
+	unsigned int* rgunHashIndex = NULL;
+
+	do
+	{
+		unsigned int unElementCapacity = (0 == s_unElementCapacity) ? PROPERTY_STORAGE_INITIAL_CAPACITY : s_unElementCapacity * 2;
+		unsigned int unHashIndexSize = unElementCapacity * 2;
+		unsigned int unHandle = 0;
+
+		// Allocate new element array and hash index
+		rgsElements = (IfxPropertyElement*)Platform_MemoryAllocateZero(unElementCapacity * sizeof(IfxPropertyElement));
+		rgunHashIndex = (unsigned int*)Platform_MemoryAllocateZero(unHashIndexSize * sizeof(unsigned int));
+		if (NULL == rgsElements ||
+				NULL == rgunHashIndex)
+			break;
+
+		// Take over existing elements
+		if (0 != s_unElementCount &&
+				RC_SUCCESS != Platform_MemoryCopy(rgsElements, unElementCapacity * sizeof(IfxPropertyElement), s_rgsElements, s_unElementCount * sizeof(IfxPropertyElement)))
+			break;
+
+		Platform_MemoryFree((void**)&s_rgsElements);
+		Platform_MemoryFree((void**)&s_rgunHashIndex);
+		s_rgsElements = rgsElements;
+		s_unElementCapacity = unElementCapacity;
+		s_rgunHashIndex = rgunHashIndex;
+		s_unHashIndexSize = unHashIndexSize;
+		rgsElements = NULL;
+		rgunHashIndex = NULL;
+
+		// Rebuild hash index
+		for (unHandle = 1; unHandle <= s_unElementCount; unHandle++)
+			PropertyStorage_InsertIntoHashIndex(unHandle);
+
+		fReturnValue = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	// Cleanup in case of error
+	Platform_MemoryFree((void**)&rgsElements);
+	Platform_MemoryFree((void**)&rgunHashIndex);
+
+	return fReturnValue;
+}
+
+/**
+ *	@brief		Find the handle of an interned key
+ *	@details	Local helper method searching the hash index for the given key.
+ *
+ *	@param		PwszKey			Key identifier to be searched for\n
+ *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_KEY
+ *	@param		PunHash			Hash value of the key
+ *
+ *	@returns	The handle of the interned key if found, PROPERTY_STORAGE_INVALID_HANDLE otherwise
+ */
+_Check_return_
+static
+unsigned int
+PropertyStorage_FindHandle(
+	_In_z_	const wchar_t*	PwszKey,
+	_In_	unsigned int	PunHash)
+{
+	unsigned int unReturnHandle = PROPERTY_STORAGE_INVALID_HANDLE;
+
+	if (0 != s_unHashIndexSize)
+	{
+		unsigned int unMask = s_unHashIndexSize - 1;
+		unsigned int unSlot = PunHash & unMask;
+
+		// Probe until the key or an unused slot has been found
+		while (PROPERTY_STORAGE_INVALID_HANDLE != s_rgunHashIndex[unSlot])
+		{
+			IfxPropertyElement* pElement = &s_rgsElements[s_rgunHashIndex[unSlot] - 1];
+			if (pElement->unHash == PunHash &&
+					0 == Platform_StringCompare(PwszKey, pElement->wszKey, PROPERTY_STORAGE_MAX_KEY, FALSE))
+			{
+				unReturnHandle = s_rgunHashIndex[unSlot];
+				break;
+			}
+			unSlot = (unSlot + 1) & unMask;
+		}
+	}
+
+	return unReturnHandle;
+}
+
+/**
+ *	@brief		Intern a key
+ *	@details	Local helper method returning the handle of the given key. Unknown keys are added without a value.
+ *
+ *	@param		PwszKey			Key identifier to be interned\n
+ *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_KEY
+ *
+ *	@returns	The handle of the interned key, PROPERTY_STORAGE_INVALID_HANDLE in case of an error
+ */
+_Check_return_
+static
+unsigned int
+PropertyStorage_InternKey(
+	_In_z_ const wchar_t* PwszKey)
+{
+	unsigned int unReturnHandle = PROPERTY_STORAGE_INVALID_HANDLE;
 
 	do
 	{
 		unsigned int unLength = 0;
+		unsigned int unHash = 0;
+		IfxPropertyElement* pElement = NULL;
 
-		// Check parameters
-		if (NULL == PwszKey ||
-				NULL == PwszValue)
+		// Check parameter
+		if (NULL == PwszKey)
 			break;
 
-		// Check length of key and value
-		if (RC_E_BUFFER_TOO_SMALL == Platform_StringGetLength(PwszKey, PROPERTY_STORAGE_MAX_KEY, &unLength) ||
-				RC_E_BUFFER_TOO_SMALL == Platform_StringGetLength(PwszValue, PROPERTY_STORAGE_MAX_VALUE, &unLength))
+		// Check length of key
+		if (RC_E_BUFFER_TOO_SMALL == Platform_StringGetLength(PwszKey, PROPERTY_STORAGE_MAX_KEY, &unLength))
 			break;
 
-		// Abort if element with same key already exists
-		if (PropertyStorage_ExistsElement(PwszKey))
+		// Return the handle of an already interned key
+		unHash = PropertyStorage_HashKey(PwszKey);
+		unReturnHandle = PropertyStorage_FindHandle(PwszKey, unHash);
+		if (PROPERTY_STORAGE_INVALID_HANDLE != unReturnHandle)
 			break;
 
-		// Allocate memory for one property element
-		pElement = (IfxPropertyElement*)Platform_MemoryAllocateZero(sizeof(IfxPropertyElement));
-		if (NULL == pElement)
+		// Grow storage if required
+		if (s_unElementCount == s_unElementCapacity &&
+				FALSE == PropertyStorage_Grow())
 			break;
 
-		// Copy key to element
+		// Copy key to the next unused element
+		pElement = &s_rgsElements[s_unElementCount];
 		unLength = PROPERTY_STORAGE_MAX_KEY;
 		if (RC_SUCCESS != Platform_StringCopy(pElement->wszKey, &unLength, PwszKey))
 			break;
+		pElement->unHash = unHash;
 
-		// Copy value to element
-		unLength = PROPERTY_STORAGE_MAX_VALUE;
-		if (RC_SUCCESS != Platform_StringCopy(pElement->wszValue, &unLength, PwszValue))
-			break;
+		s_unElementCount++;
+		PropertyStorage_InsertIntoHashIndex(s_unElementCount);
+		unReturnHandle = s_unElementCount;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnHandle;
+}
+
+/**
+ *	@brief		Get an element identified by a handle
+ *	@details	Local helper method to get the element with the given handle, if it currently has a value.
+ *
+ *	@param		PunHandle		Handle of the PropertyElement
+ *
+ *	@returns	The element if it exists, NULL otherwise
+ */
+_Check_return_
+static
+IfxPropertyElement*
+PropertyStorage_GetElementByHandle(
+	_In_ unsigned int PunHandle)
+{
+	IfxPropertyElement* pReturnElement = NULL;
+
+	if (PROPERTY_STORAGE_INVALID_HANDLE != PunHandle &&
+			PunHandle <= s_unElementCount &&
+			s_rgsElements[PunHandle - 1].fExists)
+		pReturnElement = &s_rgsElements[PunHandle - 1];
 
-		// If list is empty, add it to the list
-		if (NULL == s_pvHead)
+	return pReturnElement;
+}
+
+/**
+ *	@brief		Get an element identified by a key
+ *	@details	Local helper method to get the element with the given key.
+ *
+ *	@param		PwszKey			Key identifier for the PropertyElement to be changed\n
+ *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_KEY
+ *
+ *	@returns	The element if found, NULL otherwise
+ */
+_Check_return_
+IfxPropertyElement*
+PropertyStorage_GetElementByKey(
+	_In_z_ const wchar_t* PwszKey)
+{
+	IfxPropertyElement* pReturnElement = NULL;
+
+	// Check parameter
+	if (NULL != PwszKey)
+		pReturnElement = PropertyStorage_GetElementByHandle(PropertyStorage_FindHandle(PwszKey, PropertyStorage_HashKey(PwszKey)));
+
+	return pReturnElement;
+}
+
+/**
+ *	@brief		Parse an unsigned number
+ *	@details	Local helper method parsing a decimal or hexadecimal number. In contrast to the Utility parse functions
+ *				it does not store an error, because values are converted speculatively to all typed representations.
+ *
+ *	@param		PwszValue		Number to be parsed (without hex prefix)\n
+ *								null-terminated wide char array
+ *	@param		PunBase			Base of the number (10 or 16)
+ *	@param		PullMaximum		Maximum allowed value
+ *	@param		PpullValue		Pointer to an unsigned long long receiving the parsed value
+ *
+ *	@retval		TRUE		If the value has been parsed
+ *	@retval		FALSE		If the value contains an invalid character or exceeds PullMaximum
+ */
+_Check_return_
+static
+BOOL
+PropertyStorage_ParseNumber(
+	_In_z_	const wchar_t*		PwszValue,
+	_In_	unsigned int		PunBase,
+	_In_	unsigned long long	PullMaximum,
+	_Out_	unsigned long long*	PpullValue)
+{
+	BOOL fReturnValue = TRUE;
+	unsigned int unIndex = 0;
+
+	*PpullValue = 0;
+
+	for (unIndex = 0; unIndex < PROPERTY_STORAGE_MAX_VALUE && L'\0' != PwszValue[unIndex]; unIndex++)
+	{
+		wchar_t wchChar = PwszValue[unIndex];
+		unsigned int unDigit = 0;
+
+		// Get the next character and convert it to an integer
+		if (wchChar >= L'0' && wchChar <= L'9')
+			unDigit = wchChar - L'0';
+		else if (16 == PunBase && wchChar >= L'A' && wchChar <= L'F')
+			unDigit = wchChar - L'A' + 10;
+		else if (16 == PunBase && wchChar >= L'a' && wchChar <= L'f')
+			unDigit = wchChar - L'a' + 10;
+		else
 		{
-			s_pvHead = pElement;
-			s_pvTail = pElement;
+			fReturnValue = FALSE;
+			break;
 		}
-		else
+
+		// Check for overflow
+		if (*PpullValue > (PullMaximum - unDigit) / PunBase)
 		{
-			// Update link of the last element in the list
-			s_pvTail->pvNextElement = pElement;
+			fReturnValue = FALSE;
+			break;
+		}
+
+		*PpullValue = *PpullValue * PunBase + unDigit;
+	}
 
-			// Update links in the element to add
-			pElement->pvPreviousElement = s_pvTail;
+	if (FALSE == fReturnValue)
+		*PpullValue = 0;
+
+	return fReturnValue;
+}
+
+/**
+ *	@brief		Set the value of an element
+ *	@details	Local helper method copying the value and converting it to its typed representations once.
+ *
+ *	@param		PpElement		Element to be set
+ *	@param		PwszValue		Pointer to a wide char array containing the value\n
+ *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_VALUE
+ *
+ *	@retval		TRUE		If the value has been set
+ *	@retval		FALSE		If the value could not be set
+ */
+_Check_return_
+static
+BOOL
+PropertyStorage_SetElementValue(
+	_Inout_	IfxPropertyElement*	PpElement,
+	_In_z_	const wchar_t*		PwszValue)
+{
+	BOOL fReturnValue = FALSE;
 
-			// Update last list element link
-			s_pvTail = pElement;
+	do
+	{
+		unsigned int unValueSize = PROPERTY_STORAGE_MAX_VALUE;
+		int nIndex = -1;
+		unsigned long long ullValue = 0;
+
+		// Copy value to element
+		if (RC_SUCCESS != Platform_StringCopy(PpElement->wszValue, &unValueSize, PwszValue))
+			break;
+
+		// Increment size by one due to null-termination
+		if (PROPERTY_STORAGE_MAX_VALUE > unValueSize)
+			unValueSize++;
+
+		// Convert value to BOOL, if possible
+		PpElement->fBooleanValid = TRUE;
+		if (0 == Platform_StringCompare(L"TRUE", PpElement->wszValue, unValueSize, TRUE))
+			PpElement->fBooleanValue = TRUE;
+		else if (0 == Platform_StringCompare(L"FALSE", PpElement->wszValue, unValueSize, TRUE))
+			PpElement->fBooleanValue = FALSE;
+		else
+			PpElement->fBooleanValid = FALSE;
+
+		// Convert value to unsigned integer (as hex value if it contains an 'x'), if possible
+		PpElement->fUIntegerValid = FALSE;
+		if (RC_SUCCESS == Utility_StringContainsWChar(PpElement->wszValue, unValueSize, L'x', &nIndex))
+		{
+			if (nIndex == -1)
+				PpElement->fUIntegerValid =
+					L'\0' != PpElement->wszValue[0] &&
+					PropertyStorage_ParseNumber(PpElement->wszValue, 10, UINT_MAX, &ullValue);
+			else
+				PpElement->fUIntegerValid = PropertyStorage_ParseNumber(
+					(L'0' == PpElement->wszValue[0] && (L'x' == PpElement->wszValue[1] || L'X' == PpElement->wszValue[1])) ? &PpElement->wszValue[2] : PpElement->wszValue,
+					16, UINT_MAX, &ullValue);
 		}
+		PpElement->unUIntegerValue = PpElement->fUIntegerValid ? (unsigned int)ullValue : 0;
 
+		// Convert value to unsigned long long, if possible
+		PpElement->fULongLongValid =
+			L'\0' != PpElement->wszValue[0] &&
+			PropertyStorage_ParseNumber(PpElement->wszValue, 10, UINT64_MAX, &ullValue);
+		PpElement->ullULongLongValue = PpElement->fULongLongValid ? ullValue : 0;
+
+		PpElement->fExists = TRUE;
 		fReturnValue = TRUE;
 	}
 	WHILE_FALSE_END;
 
-	// Cleanup in case of error
-	if (!fReturnValue)
-		Platform_MemoryFree((void**)&pElement);
+	return fReturnValue;
+}
+
+/**
+ *	@brief		Add a key value pair to the PropertyStorage
+ *	@details	Operation fails in case an element with same key already exists.
+ *
+ *	@param		PwszKey			Unique key identifier for the PropertyElement to be added\n
+ *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_KEY
+ *	@param		PwszValue		Pointer to a wide char array containing the value\n
+ *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_VALUE
+ *
+ *	@retval		TRUE		If the element has been added
+ *	@retval		FALSE		If the element could not be added, e.g. because element with same key already exists
+ */
+_Check_return_
+BOOL
+PropertyStorage_AddKeyValuePair(
+	_In_z_	const wchar_t*	PwszKey,
+	_In_z_	const wchar_t*	PwszValue)
+{
+	BOOL fReturnValue = FALSE;
+
+	do
+	{
+		unsigned int unLength = 0;
+		unsigned int unHandle = PROPERTY_STORAGE_INVALID_HANDLE;
+
+		// Check parameters
+		if (NULL == PwszKey ||
+				NULL == PwszValue)
+			break;
+
+		// Check length of value (key length is checked while interning)
+		if (RC_E_BUFFER_TOO_SMALL == Platform_StringGetLength(PwszValue, PROPERTY_STORAGE_MAX_VALUE, &unLength))
+			break;
+
+		// Get handle of the key
+		unHandle = PropertyStorage_InternKey(PwszKey);
+		if (PROPERTY_STORAGE_INVALID_HANDLE == unHandle)
+			break;
+
+		// Abort if element with same key already exists
+		if (s_rgsElements[unHandle - 1].fExists)
+			break;
+
+		fReturnValue = PropertyStorage_SetElementValue(&s_rgsElements[unHandle - 1], PwszValue);
+	}
+	WHILE_FALSE_END;
 
 	return fReturnValue;
 }
@@ -153,45 +516,6 @@ PropertyStorage_AddKeyUIntegerValuePair(
 	return fReturnValue;
 }
 
-/**
- *	@brief		Get an element identified by a key
- *	@details	Local helper method to get the element with the given key.
- *
- *	@param		PwszKey			Key identifier for the PropertyElement to be changed\n
- *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_KEY
- *
- *	@returns	The element if found, NULL otherwise
- */
-_Check_return_
-IfxPropertyElement*
-PropertyStorage_GetElementByKey(
-	_In_z_ const wchar_t* PwszKey)
-{
-	IfxPropertyElement* pReturnElement = NULL;
-
-	// Check parameter
-	if (NULL != PwszKey)
-	{
-		// Search list for element
-		IfxPropertyElement* pIteratorElement = s_pvHead;
-		while (NULL != pIteratorElement)
-		{
-			// Check if current element contains the given key
-			if (0 == Platform_StringCompare(PwszKey, pIteratorElement->wszKey, PROPERTY_STORAGE_MAX_KEY, FALSE))
-			{
-				// If yes, return it
-				pReturnElement = pIteratorElement;
-				break;
-			}
-
-			// Update iterator
-			pIteratorElement = pIteratorElement->pvNextElement;
-		}
-	}
-
-	return pReturnElement;
-}
-
 /**
  *	@brief		Change the value of an element identified by a key
  *	@details
@@ -227,11 +551,7 @@ PropertyStorage_ChangeValueByKey(
 			break;
 
 		// Change value
-		{
-			unsigned int unValueSize = PROPERTY_STORAGE_MAX_VALUE;
-			if (RC_SUCCESS == Platform_StringCopy(pElement->wszValue, &unValueSize, PwszValue))
-				fReturnValue = TRUE;
-		}
+		fReturnValue = PropertyStorage_SetElementValue(pElement, PwszValue);
 	}
 	WHILE_FALSE_END;
 
@@ -305,40 +625,12 @@ PropertyStorage_GetValueByKey(
 	_Out_z_cap_(*PpunValueSize)	wchar_t*		PwszValue,
 	_Inout_						unsigned int*	PpunValueSize)
 {
-	BOOL fReturnValue = FALSE;
-
-	do
-	{
-		IfxPropertyElement* pElement = NULL;
-
-		// Check parameters
-		if (NULL == PwszKey ||
-				NULL == PwszValue ||
-				NULL == PpunValueSize ||
-				0 == *PpunValueSize)
-			break;
-
-		// Get element to be read from, if existing
-		pElement = PropertyStorage_GetElementByKey(PwszKey);
-		if (NULL == pElement)
-			break;
+	unsigned int unHandle = PROPERTY_STORAGE_INVALID_HANDLE;
 
-		// Get value
-		if (RC_SUCCESS == Platform_StringCopy(PwszValue, PpunValueSize, pElement->wszValue))
-			fReturnValue = TRUE;
-	}
-	WHILE_FALSE_END;
-
-	if (FALSE == fReturnValue)
-	{
-		// Reset out parameters
-		if (NULL != PwszValue)
-			PwszValue[0] = L'\0';
-		if (NULL != PpunValueSize)
-			*PpunValueSize = 0;
-	}
+	if (NULL != PwszKey)
+		unHandle = PropertyStorage_FindHandle(PwszKey, PropertyStorage_HashKey(PwszKey));
 
-	return fReturnValue;
+	return PropertyStorage_GetValueByHandle(unHandle, PwszValue, PpunValueSize);
 }
 
 /**
@@ -358,42 +650,12 @@ PropertyStorage_GetBooleanValueByKey(
 	_In_z_	const wchar_t*	PwszKey,
 	_Out_	BOOL*			PpfValue)
 {
-	BOOL fReturnValue = FALSE;
-
-	do
-	{
-		wchar_t wszValue[PROPERTY_STORAGE_MAX_VALUE] = {0};
-		unsigned int unValueSize = RG_LEN(wszValue);
-
-		// Check parameters
-		if (NULL == PwszKey ||
-				NULL == PpfValue)
-			break;
-
-		*PpfValue = FALSE;
+	unsigned int unHandle = PROPERTY_STORAGE_INVALID_HANDLE;
 
-		if (FALSE == PropertyStorage_GetValueByKey(PwszKey, wszValue, &unValueSize))
-			break;
-
-		// Increment size by one due to null-termination
-		if (PROPERTY_STORAGE_MAX_VALUE > unValueSize)
-			unValueSize++;
-
-		// Convert value to BOOL, if possible
-		if (0 == Platform_StringCompare(L"TRUE", wszValue, unValueSize, TRUE))
-		{
-			*PpfValue = TRUE;
-			fReturnValue = TRUE;
-		}
-		else if (0 == Platform_StringCompare(L"FALSE", wszValue, unValueSize, TRUE))
-		{
-			*PpfValue = FALSE;
-			fReturnValue = TRUE;
-		}
-	}
-	WHILE_FALSE_END;
+	if (NULL != PwszKey)
+		unHandle = PropertyStorage_FindHandle(PwszKey, PropertyStorage_HashKey(PwszKey));
 
-	return fReturnValue;
+	return PropertyStorage_GetBooleanValueByHandle(unHandle, PpfValue);
 }
 
 /**
@@ -413,51 +675,12 @@ PropertyStorage_GetUIntegerValueByKey(
 	_In_z_	const wchar_t*		PwszKey,
 	_Out_	unsigned int*		PpunValue)
 {
-	BOOL fReturnValue = FALSE;
-
-	do
-	{
-		wchar_t wszValue[PROPERTY_STORAGE_MAX_VALUE] = {0};
-		unsigned int unValueSize = RG_LEN(wszValue);
-		int nIndex = -1;
+	unsigned int unHandle = PROPERTY_STORAGE_INVALID_HANDLE;
 
-		// Check parameters
-		if (NULL == PwszKey ||
-				NULL == PpunValue)
-			break;
-
-		if (FALSE == PropertyStorage_GetValueByKey(PwszKey, wszValue, &unValueSize))
-			break;
-
-		// Increment size by one due to null-termination
-		if (PROPERTY_STORAGE_MAX_VALUE > unValueSize)
-			unValueSize++;
-
-		// Convert String to Integer
-		if (RC_SUCCESS == Utility_StringContainsWChar(wszValue, unValueSize, L'x', &nIndex))
-		{
-			if (nIndex == -1)
-			{
-				// Convert as decimal value
-				if (RC_SUCCESS == Utility_StringParseUInteger(wszValue, unValueSize, PpunValue))
-					fReturnValue = TRUE;
-			}
-			else
-			{
-				// Convert as hex value
-				if (RC_SUCCESS == Utility_UIntegerParseHexString(wszValue, PpunValue))
-					fReturnValue = TRUE;
-			}
-		}
-	}
-	WHILE_FALSE_END;
-
-	if (FALSE == fReturnValue)
-		// Reset out parameters
-		if (NULL != PpunValue)
-			*PpunValue = 0;
+	if (NULL != PwszKey)
+		unHandle = PropertyStorage_FindHandle(PwszKey, PropertyStorage_HashKey(PwszKey));
 
-	return fReturnValue;
+	return PropertyStorage_GetUIntegerValueByHandle(unHandle, PpunValue);
 }
 
 /**
@@ -480,7 +703,7 @@ PropertyStorage_ExistsElement(
 
 /**
  *	@brief		Removes the PropertyElement identified by a given key
- *	@details
+ *	@details	The key stays interned, so handles obtained by PropertyStorage_Lookup remain valid.
  *
  *	@param		PwszKey			Key identifier for the PropertyElement to be removed\n
  *								null-terminated wide char array
@@ -507,24 +730,9 @@ PropertyStorage_RemoveElement(
 		pElement = PropertyStorage_GetElementByKey(PwszKey);
 		if (NULL != pElement)
 		{
-			// Get previous and next elements
-			IfxPropertyElement* pPrev = pElement->pvPreviousElement;
-			IfxPropertyElement* pNext = pElement->pvNextElement;
-
-			// Hang out the element now
-			if (NULL != pPrev)
-				pPrev->pvNextElement = pNext;
-			if (NULL != pNext)
-				pNext->pvPreviousElement = pPrev;
-
-			// Check if element to be removed is the first or last element
-			if (s_pvHead == pElement)
-				s_pvHead = pNext;
-			if (s_pvTail == pElement)
-				s_pvTail = pPrev;
-
-			// Free memory of element to be removed
-			Platform_MemoryFree((void**)&pElement);
+			// Clear the value but keep the interned key
+			pElement->fExists = FALSE;
+			pElement->wszValue[0] = L'\0';
 
 			fReturnValue = TRUE;
 		}
@@ -536,30 +744,18 @@ PropertyStorage_RemoveElement(
 
 /**
  *	@brief		Clears the whole property list
- *	@details
+ *	@details	The keys stay interned, so handles obtained by PropertyStorage_Lookup remain valid.
  */
 void
 PropertyStorage_ClearElements()
 {
-	// Start with the first element
-	IfxPropertyElement* pIteratorElement = s_pvHead;
+	unsigned int unIndex = 0;
 
-	// Walk along until the end of the list has been reached
-	while (NULL != pIteratorElement)
+	for (unIndex = 0; unIndex < s_unElementCount; unIndex++)
 	{
-		// Remember pointer of current element
-		IfxPropertyElement* pElement = pIteratorElement;
-
-		// Update iterator
-		pIteratorElement = pIteratorElement->pvNextElement;
-
-		// Free memory of current element
-		Platform_MemoryFree((void**)&pElement);
+		s_rgsElements[unIndex].fExists = FALSE;
+		s_rgsElements[unIndex].wszValue[0] = L'\0';
 	}
-
-	// Clear pointers to first and last element
-	s_pvHead = NULL;
-	s_pvTail = NULL;
 }
 
 /**
@@ -632,35 +828,195 @@ BOOL
 PropertyStorage_GetULongLongValueByKey(
 	_In_z_	const wchar_t*		PwszKey,
 	_Out_	unsigned long long*	PpullValue)
+{
+	unsigned int unHandle = PROPERTY_STORAGE_INVALID_HANDLE;
+
+	if (NULL != PwszKey)
+		unHandle = PropertyStorage_FindHandle(PwszKey, PropertyStorage_HashKey(PwszKey));
+
+	return PropertyStorage_GetULongLongValueByHandle(unHandle, PpullValue);
+}
+
+/**
+ *	@brief		Get a handle for the given key
+ *	@details	The key is interned if it is not yet known, so a handle can be obtained before the element is added.
+ *				The handle stays valid for the whole program execution, also when the element is removed and added again.
+ *				Callers querying the same property repeatedly can keep the handle and use the PropertyStorage_Get*ByHandle
+ *				functions to avoid hashing and comparing the key on each access.
+ *
+ *	@param		PwszKey			Key identifier for the PropertyElement\n
+ *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_KEY
+ *	@param		PpunHandle		Pointer to an unsigned integer receiving the handle
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If no handle could be obtained, e.g. because the key is too long
+ */
+_Check_return_
+BOOL
+PropertyStorage_Lookup(
+	_In_z_	const wchar_t*	PwszKey,
+	_Out_	unsigned int*	PpunHandle)
+{
+	BOOL fReturnValue = FALSE;
+
+	if (NULL != PpunHandle)
+	{
+		*PpunHandle = PropertyStorage_InternKey(PwszKey);
+		fReturnValue = (PROPERTY_STORAGE_INVALID_HANDLE != *PpunHandle);
+	}
+
+	return fReturnValue;
+}
+
+/**
+ *	@brief		Get a copy of the PropertyElement's value with the given handle
+ *	@details
+ *
+ *	@param		PunHandle		Handle of the PropertyElement obtained by PropertyStorage_Lookup
+ *	@param		PwszValue		Pointer to a wide char array containing the PropertyElement value
+ *	@param		PpunValueSize	In: the capacity of the wide char array in elements (incl. termination zero)\n
+ *								Out: the length of the string copied to (without termination zero)
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If the value could not be retrieved, e.g. because the element has no value
+ */
+_Check_return_
+BOOL
+PropertyStorage_GetValueByHandle(
+	_In_						unsigned int	PunHandle,
+	_Out_z_cap_(*PpunValueSize)	wchar_t*		PwszValue,
+	_Inout_						unsigned int*	PpunValueSize)
 {
 	BOOL fReturnValue = FALSE;
 
 	do
 	{
-		wchar_t wszValue[PROPERTY_STORAGE_MAX_VALUE] = {0};
-		unsigned int unValueSize = RG_LEN(wszValue);
+		IfxPropertyElement* pElement = NULL;
 
 		// Check parameters
-		if (NULL == PwszKey || NULL == PpullValue)
+		if (NULL == PwszValue ||
+				NULL == PpunValueSize ||
+				0 == *PpunValueSize)
 			break;
 
-		if (FALSE == PropertyStorage_GetValueByKey(PwszKey, wszValue, &unValueSize))
+		// Get element to be read from, if existing
+		pElement = PropertyStorage_GetElementByHandle(PunHandle);
+		if (NULL == pElement)
 			break;
 
-		// Increment size by one due to null-termination
-		if (PROPERTY_STORAGE_MAX_VALUE > unValueSize)
-			unValueSize++;
-
-		// Convert String to Integer
-		if (RC_SUCCESS == Utility_StringParseULongLong(wszValue, unValueSize, PpullValue))
+		// Get value
+		if (RC_SUCCESS == Platform_StringCopy(PwszValue, PpunValueSize, pElement->wszValue))
 			fReturnValue = TRUE;
 	}
 	WHILE_FALSE_END;
 
 	if (FALSE == fReturnValue)
+	{
 		// Reset out parameters
-		if (NULL != PpullValue)
-			*PpullValue = 0;
+		if (NULL != PwszValue)
+			PwszValue[0] = L'\0';
+		if (NULL != PpunValueSize)
+			*PpunValueSize = 0;
+	}
+
+	return fReturnValue;
+}
+
+/**
+ *	@brief		Get the value of the PropertyElement with the given handle casted to a BOOL
+ *	@details
+ *
+ *	@param		PunHandle		Handle of the PropertyElement obtained by PropertyStorage_Lookup
+ *	@param		PpfValue		Pointer to a BOOL containing the PropertyElement value
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If the value could not be retrieved, e.g. because the element has no value
+ */
+_Check_return_
+BOOL
+PropertyStorage_GetBooleanValueByHandle(
+	_In_	unsigned int	PunHandle,
+	_Out_	BOOL*			PpfValue)
+{
+	BOOL fReturnValue = FALSE;
+
+	if (NULL != PpfValue)
+	{
+		IfxPropertyElement* pElement = PropertyStorage_GetElementByHandle(PunHandle);
+
+		*PpfValue = FALSE;
+		if (NULL != pElement && pElement->fBooleanValid)
+		{
+			*PpfValue = pElement->fBooleanValue;
+			fReturnValue = TRUE;
+		}
+	}
+
+	return fReturnValue;
+}
+
+/**
+ *	@brief		Get the value of the PropertyElement with the given handle casted to an unsigned integer
+ *	@details
+ *
+ *	@param		PunHandle		Handle of the PropertyElement obtained by PropertyStorage_Lookup
+ *	@param		PpunValue		Pointer to an unsigned integer containing the PropertyElement value
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If the value could not be retrieved, e.g. because the element has no value
+ */
+_Check_return_
+BOOL
+PropertyStorage_GetUIntegerValueByHandle(
+	_In_	unsigned int	PunHandle,
+	_Out_	unsigned int*	PpunValue)
+{
+	BOOL fReturnValue = FALSE;
+
+	if (NULL != PpunValue)
+	{
+		IfxPropertyElement* pElement = PropertyStorage_GetElementByHandle(PunHandle);
+
+		*PpunValue = 0;
+		if (NULL != pElement && pElement->fUIntegerValid)
+		{
+			*PpunValue = pElement->unUIntegerValue;
+			fReturnValue = TRUE;
+		}
+	}
+
+	return fReturnValue;
+}
+
+/**
+ *	@brief		Get the value of the PropertyElement with the given handle casted to an unsigned long long
+ *	@details
+ *
+ *	@param		PunHandle		Handle of the PropertyElement obtained by PropertyStorage_Lookup
+ *	@param		PpullValue		Pointer to an unsigned long long containing the PropertyElement value
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If the value could not be retrieved, e.g. because the element has no value
+ */
+_Check_return_
+BOOL
+PropertyStorage_GetULongLongValueByHandle(
+	_In_	unsigned int		PunHandle,
+	_Out_	unsigned long long*	PpullValue)
+{
+	BOOL fReturnValue = FALSE;
+
+	if (NULL != PpullValue)
+	{
+		IfxPropertyElement* pElement = PropertyStorage_GetElementByHandle(PunHandle);
+
+		*PpullValue = 0;
+		if (NULL != pElement && pElement->fULongLongValid)
+		{
+			*PpullValue = pElement->ullULongLongValue;
+			fReturnValue = TRUE;
+		}
+	}
 
 	return fReturnValue;
 }
\ No newline at end of file
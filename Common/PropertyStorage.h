@@ -26,20 +26,42 @@ extern "C" {
 /// Define property storage max value size
 #define PROPERTY_STORAGE_MAX_VALUE	MAX_PATH + 1
 
+/// Initial number of elements the PropertyStorage is allocated for
+#define PROPERTY_STORAGE_INITIAL_CAPACITY	64
+/// Handle value of an unknown key
+#define PROPERTY_STORAGE_INVALID_HANDLE		0
+/// FNV-1a offset basis used for hashing keys
+#define PROPERTY_STORAGE_HASH_OFFSET_BASIS	0x811C9DC5
+/// FNV-1a prime used for hashing keys
+#define PROPERTY_STORAGE_HASH_PRIME			0x01000193
+
 /**
- *	@brief		This structure is used to store a property in a double linked list
- *	@details	Each element has a unique key and a value.
+ *	@brief		This structure is used to store a property in the PropertyStorage hash table
+ *	@details	Each element has a unique key and a value. The value is converted to its typed
+ *				representations once when written, so typed getters do not need to parse it again.
  */
 typedef struct tdIfxPropertyElement
 {
-	/// Pointer to the previous IfxPropertyElement (NULL if the first element)
-	struct tdIfxPropertyElement*	pvPreviousElement;
-	/// Pointer to the next IfxPropertyElement (NULL if the last element)
-	struct tdIfxPropertyElement*	pvNextElement;
 	/// Key to identify the IfxPropertyElement
 	wchar_t							wszKey[PROPERTY_STORAGE_MAX_KEY];
+	/// Hash value of the key
+	unsigned int					unHash;
+	/// Flag indicating whether the IfxPropertyElement currently has a value
+	BOOL							fExists;
 	/// Value for the IfxPropertyElement
 	wchar_t							wszValue[PROPERTY_STORAGE_MAX_VALUE];
+	/// Flag indicating whether the value is a valid boolean
+	BOOL							fBooleanValid;
+	/// Value converted to a boolean
+	BOOL							fBooleanValue;
+	/// Flag indicating whether the value is a valid unsigned integer
+	BOOL							fUIntegerValid;
+	/// Value converted to an unsigned integer
+	unsigned int					unUIntegerValue;
+	/// Flag indicating whether the value is a valid unsigned long long
+	BOOL							fULongLongValid;
+	/// Value converted to an unsigned long long
+	unsigned long long				ullULongLongValue;
 } IfxPropertyElement;
 
 /**
@@ -287,6 +309,93 @@ PropertyStorage_GetULongLongValueByKey(
 	_In_z_	const wchar_t*		PwszKey,
 	_Out_	unsigned long long*	PpullValue);
 
+/**
+ *	@brief		Get a handle for the given key
+ *	@details	The key is interned if it is not yet known, so a handle can be obtained before the element is added.
+ *				The handle stays valid for the whole program execution, also when the element is removed and added again.
+ *				Callers querying the same property repeatedly can keep the handle and use the PropertyStorage_Get*ByHandle
+ *				functions to avoid hashing and comparing the key on each access.
+ *
+ *	@param		PwszKey			Key identifier for the PropertyElement\n
+ *								null-terminated wide char array; max length PROPERTY_STORAGE_MAX_KEY
+ *	@param		PpunHandle		Pointer to an unsigned integer receiving the handle
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If no handle could be obtained, e.g. because the key is too long
+ */
+_Check_return_
+BOOL
+PropertyStorage_Lookup(
+	_In_z_	const wchar_t*	PwszKey,
+	_Out_	unsigned int*	PpunHandle);
+
+/**
+ *	@brief		Get a copy of the PropertyElement's value with the given handle
+ *	@details
+ *
+ *	@param		PunHandle		Handle of the PropertyElement obtained by PropertyStorage_Lookup
+ *	@param		PwszValue		Pointer to a wide char array containing the PropertyElement value
+ *	@param		PpunValueSize	In: the capacity of the wide char array in elements (incl. termination zero)\n
+ *								Out: the length of the string copied to (without termination zero)
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If the value could not be retrieved, e.g. because the element has no value
+ */
+_Check_return_
+BOOL
+PropertyStorage_GetValueByHandle(
+	_In_						unsigned int	PunHandle,
+	_Out_z_cap_(*PpunValueSize)	wchar_t*		PwszValue,
+	_Inout_						unsigned int*	PpunValueSize);
+
+/**
+ *	@brief		Get the value of the PropertyElement with the given handle casted to a BOOL
+ *	@details
+ *
+ *	@param		PunHandle		Handle of the PropertyElement obtained by PropertyStorage_Lookup
+ *	@param		PpfValue		Pointer to a BOOL containing the PropertyElement value
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If the value could not be retrieved, e.g. because the element has no value
+ */
+_Check_return_
+BOOL
+PropertyStorage_GetBooleanValueByHandle(
+	_In_	unsigned int	PunHandle,
+	_Out_	BOOL*			PpfValue);
+
+/**
+ *	@brief		Get the value of the PropertyElement with the given handle casted to an unsigned integer
+ *	@details
+ *
+ *	@param		PunHandle		Handle of the PropertyElement obtained by PropertyStorage_Lookup
+ *	@param		PpunValue		Pointer to an unsigned integer containing the PropertyElement value
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If the value could not be retrieved, e.g. because the element has no value
+ */
+_Check_return_
+BOOL
+PropertyStorage_GetUIntegerValueByHandle(
+	_In_	unsigned int	PunHandle,
+	_Out_	unsigned int*	PpunValue);
+
+/**
+ *	@brief		Get the value of the PropertyElement with the given handle casted to an unsigned long long
+ *	@details
+ *
+ *	@param		PunHandle		Handle of the PropertyElement obtained by PropertyStorage_Lookup
+ *	@param		PpullValue		Pointer to an unsigned long long containing the PropertyElement value
+ *
+ *	@retval		TRUE		If the operation was successful
+ *	@retval		FALSE		If the value could not be retrieved, e.g. because the element has no value
+ */
+_Check_return_
+BOOL
+PropertyStorage_GetULongLongValueByHandle(
+	_In_	unsigned int		PunHandle,
+	_Out_	unsigned long long*	PpullValue);
+
 #ifdef __cplusplus
 }
 #endif
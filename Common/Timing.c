@@ -0,0 +1,434 @@
+﻿/**
+ *	@brief		Implements the timing instrumentation
+ *	@details	This module records the duration of firmware update phases and the latency of TPM commands.
+ *	@file		Timing.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "Timing.h"
+#include "Platform.h"
+#include "Polling.h"
+
+/// Number of sub-buckets per power of two in the latency histogram (as bit count)
+#define TIMING_HISTOGRAM_SUB_BITS	3
+/// Number of sub-buckets per power of two in the latency histogram
+#define TIMING_HISTOGRAM_SUB_COUNT	(1U << TIMING_HISTOGRAM_SUB_BITS)
+/// Number of buckets in the latency histogram (covers 0 to 2^32-1 microseconds)
+#define TIMING_HISTOGRAM_BUCKETS	((32 - TIMING_HISTOGRAM_SUB_BITS + 1) * TIMING_HISTOGRAM_SUB_COUNT)
+/// Maximum number of distinct TPM commands recorded
+#define TIMING_MAX_COMMANDS			64
+
+/**
+ *	@brief		Duration statistics of a phase
+ */
+typedef struct tdIfxTimingPhase
+{
+	/// Number of recorded durations
+	unsigned int unCount;
+	/// Sum of the recorded durations in microseconds
+	unsigned long long ullTotalUs;
+	/// Minimum duration in microseconds
+	unsigned long long ullMinUs;
+	/// Maximum duration in microseconds
+	unsigned long long ullMaxUs;
+} IfxTimingPhase;
+
+/**
+ *	@brief		Latency statistics of a TPM command
+ */
+typedef struct tdIfxTimingCommand
+{
+	/// TPM command ordinal
+	unsigned int unCommandCode;
+	/// TPM command name (can be NULL)
+	const wchar_t* pwszCommandName;
+	/// Number of failed transmissions
+	unsigned int unErrors;
+	/// Sum of request bytes
+	unsigned long long ullRequestBytes;
+	/// Sum of response bytes
+	unsigned long long ullResponseBytes;
+	/// Latency statistics
+	IfxTimingPhase sLatency;
+	/// Latency histogram
+	unsigned int rgunHistogram[TIMING_HISTOGRAM_BUCKETS];
+} IfxTimingCommand;
+
+/// Names of the phases for the timing report
+static const wchar_t* s_rgwszPhaseNames[TIMING_PHASE_COUNT] =
+{
+	L"CalculateState",
+	L"PrepareTPM20Policy",
+	L"Start",
+	L"BootLoaderWait",
+	L"UpdateBlock",
+	L"Complete"
+};
+
+/// Phase statistics
+static IfxTimingPhase s_rgsPhases[TIMING_PHASE_COUNT];
+
+/// Command statistics
+static IfxTimingCommand s_rgsCommands[TIMING_MAX_COMMANDS];
+
+/// Number of used entries in s_rgsCommands
+static unsigned int s_unCommandCount = 0;
+
+/**
+ *	@brief		Adds a duration to duration statistics
+ *	@details
+ *
+ *	@param		PpStatistics		Duration statistics
+ *	@param		PullDurationUs		Duration in microseconds
+ */
+static
+void
+Timing_AddDuration(
+	_Inout_	IfxTimingPhase*		PpStatistics,
+	_In_	unsigned long long	PullDurationUs)
+{
+	if (0 == PpStatistics->unCount || PullDurationUs < PpStatistics->ullMinUs)
+		PpStatistics->ullMinUs = PullDurationUs;
+	if (PullDurationUs > PpStatistics->ullMaxUs)
+		PpStatistics->ullMaxUs = PullDurationUs;
+	PpStatistics->ullTotalUs += PullDurationUs;
+	PpStatistics->unCount++;
+}
+
+/**
+ *	@brief		Returns the histogram bucket of a duration
+ *	@details	Durations below TIMING_HISTOGRAM_SUB_COUNT microseconds have a bucket of their own. Above, every power
+ *				of two is split into TIMING_HISTOGRAM_SUB_COUNT buckets, which limits the relative error to 1/8.
+ *
+ *	@param		PullDurationUs		Duration in microseconds
+ *
+ *	@retval		Bucket index
+ */
+static
+unsigned int
+Timing_GetBucket(
+	_In_	unsigned long long	PullDurationUs)
+{
+	unsigned int unValue = PullDurationUs > 0xFFFFFFFFULL ? 0xFFFFFFFFU : (unsigned int)PullDurationUs;
+	unsigned int unMsb = 0;
+
+	if (unValue < TIMING_HISTOGRAM_SUB_COUNT)
+		return unValue;
+
+	while ((unValue >> unMsb) > 1)
+		unMsb++;
+
+	return (unMsb - TIMING_HISTOGRAM_SUB_BITS + 1) * TIMING_HISTOGRAM_SUB_COUNT +
+		((unValue >> (unMsb - TIMING_HISTOGRAM_SUB_BITS)) & (TIMING_HISTOGRAM_SUB_COUNT - 1));
+}
+
+/**
+ *	@brief		Returns the largest duration of a histogram bucket
+ *	@details
+ *
+ *	@param		PunBucket			Bucket index
+ *
+ *	@retval		Upper bound of the bucket in microseconds
+ */
+static
+unsigned long long
+Timing_GetBucketUpperBound(
+	_In_	unsigned int	PunBucket)
+{
+	unsigned int unMsb = 0;
+	unsigned long long ullLowerBound = 0;
+
+	if (PunBucket < TIMING_HISTOGRAM_SUB_COUNT)
+		return PunBucket;
+
+	unMsb = PunBucket / TIMING_HISTOGRAM_SUB_COUNT + TIMING_HISTOGRAM_SUB_BITS - 1;
+	ullLowerBound = (1ULL << unMsb) + (unsigned long long)(PunBucket % TIMING_HISTOGRAM_SUB_COUNT) * (1ULL << (unMsb - TIMING_HISTOGRAM_SUB_BITS));
+
+	return ullLowerBound + (1ULL << (unMsb - TIMING_HISTOGRAM_SUB_BITS)) - 1;
+}
+
+/**
+ *	@brief		Returns a percentile of the latency of a TPM command
+ *	@details	The result is the upper bound of the histogram bucket which holds the percentile, limited to the
+ *				recorded minimum and maximum.
+ *
+ *	@param		PpCommand			Command statistics
+ *	@param		PunPercent			Percentile (1 to 100)
+ *
+ *	@retval		Latency in microseconds
+ */
+static
+unsigned long long
+Timing_GetPercentile(
+	_In_	const IfxTimingCommand*	PpCommand,
+	_In_	unsigned int			PunPercent)
+{
+	unsigned long long ullRank = ((unsigned long long)PpCommand->sLatency.unCount * PunPercent + 99) / 100;
+	unsigned long long ullSeen = 0;
+	unsigned long long ullValue = PpCommand->sLatency.ullMaxUs;
+	unsigned int unBucket = 0;
+
+	for (unBucket = 0; unBucket < TIMING_HISTOGRAM_BUCKETS; unBucket++)
+	{
+		ullSeen += PpCommand->rgunHistogram[unBucket];
+		if (ullSeen >= ullRank && 0 != ullSeen)
+		{
+			ullValue = Timing_GetBucketUpperBound(unBucket);
+			break;
+		}
+	}
+
+	if (ullValue < PpCommand->sLatency.ullMinUs)
+		ullValue = PpCommand->sLatency.ullMinUs;
+	if (ullValue > PpCommand->sLatency.ullMaxUs)
+		ullValue = PpCommand->sLatency.ullMaxUs;
+
+	return ullValue;
+}
+
+/**
+ *	@brief		Records the duration of a phase
+ *	@details	The phase ends with the call of this function.
+ *
+ *	@param		PePhase				Phase
+ *	@param		PullStartUs			Monotonic time stamp of the start of the phase in microseconds
+ */
+void
+Timing_RecordPhase(
+	_In_	TIMING_PHASE		PePhase,
+	_In_	unsigned long long	PullStartUs)
+{
+	if (PePhase < TIMING_PHASE_COUNT)
+		Timing_AddDuration(&s_rgsPhases[PePhase], Platform_GetMonotonicTimeMicroSeconds() - PullStartUs);
+}
+
+/**
+ *	@brief		Records the latency of a TPM command
+ *	@details	The command ends with the call of this function.
+ *
+ *	@param		PunCommandCode			TPM command ordinal (0 if unknown)
+ *	@param		PwszCommandName			TPM command name (optional, can be NULL)
+ *	@param		PullStartUs				Monotonic time stamp of the start of the command in microseconds
+ *	@param		PunRequestSize			Size of the command request in bytes
+ *	@param		PunResponseSize			Size of the command response in bytes
+ *	@param		PunReturnCode			Return code of the transmission
+ */
+void
+Timing_RecordCommand(
+	_In_		unsigned int		PunCommandCode,
+	_In_opt_	const wchar_t*		PwszCommandName,
+	_In_		unsigned long long	PullStartUs,
+	_In_		unsigned int		PunRequestSize,
+	_In_		unsigned int		PunResponseSize,
+	_In_		unsigned int		PunReturnCode)
+{
+	unsigned long long ullDurationUs = Platform_GetMonotonicTimeMicroSeconds() - PullStartUs;
+	IfxTimingCommand* pCommand = NULL;
+	unsigned int unIndex = 0;
+
+	// Find the entry of the command or add a new one
+	for (unIndex = 0; unIndex < s_unCommandCount; unIndex++)
+	{
+		if (s_rgsCommands[unIndex].unCommandCode == PunCommandCode)
+		{
+			pCommand = &s_rgsCommands[unIndex];
+			break;
+		}
+	}
+	if (NULL == pCommand)
+	{
+		if (TIMING_MAX_COMMANDS == s_unCommandCount)
+			return;
+		pCommand = &s_rgsCommands[s_unCommandCount++];
+		pCommand->unCommandCode = PunCommandCode;
+		pCommand->pwszCommandName = PwszCommandName;
+	}
+
+	if (RC_SUCCESS != PunReturnCode)
+		pCommand->unErrors++;
+	pCommand->ullRequestBytes += PunRequestSize;
+	pCommand->ullResponseBytes += PunResponseSize;
+	Timing_AddDuration(&pCommand->sLatency, ullDurationUs);
+	pCommand->rgunHistogram[Timing_GetBucket(ullDurationUs)]++;
+}
+
+/**
+ *	@brief		Writes the timing summary table to the log
+ *	@details	The summary is written with logging level 3.
+ */
+void
+Timing_LogSummary()
+{
+	unsigned int unIndex = 0;
+
+	LOGGING_WRITE_LEVEL3(L"Phase                 Count     Total(us)       Min(us)       Max(us)");
+	for (unIndex = 0; unIndex < TIMING_PHASE_COUNT; unIndex++)
+	{
+		const IfxTimingPhase* pPhase = &s_rgsPhases[unIndex];
+		if (0 == pPhase->unCount)
+			continue;
+
+		LOGGING_WRITE_LEVEL3_FMT(
+			L"%-20ls %6u %13llu %13llu %13llu",
+			s_rgwszPhaseNames[unIndex],
+			pPhase->unCount,
+			pPhase->ullTotalUs,
+			pPhase->ullMinUs,
+			pPhase->ullMaxUs);
+	}
+
+	LOGGING_WRITE_LEVEL3(L"Command                          Code  Count Errors   Min(us)   Avg(us)   P50(us)   P99(us)   Max(us)  Request  Response");
+	for (unIndex = 0; unIndex < s_unCommandCount; unIndex++)
+	{
+		const IfxTimingCommand* pCommand = &s_rgsCommands[unIndex];
+
+		LOGGING_WRITE_LEVEL3_FMT(
+			L"%-24ls 0x%.8X %6u %6u %9llu %9llu %9llu %9llu %9llu %8llu %9llu",
+			NULL != pCommand->pwszCommandName ? pCommand->pwszCommandName : L"Unknown",
+			pCommand->unCommandCode,
+			pCommand->sLatency.unCount,
+			pCommand->unErrors,
+			pCommand->sLatency.ullMinUs,
+			pCommand->sLatency.ullTotalUs / pCommand->sLatency.unCount,
+			Timing_GetPercentile(pCommand, 50),
+			Timing_GetPercentile(pCommand, 99),
+			pCommand->sLatency.ullMaxUs,
+			pCommand->ullRequestBytes,
+			pCommand->ullResponseBytes);
+	}
+}
+
+/**
+ *	@brief		Writes the timing report as JSON file
+ *	@details	The file contains the phase durations, the per-command latency statistics and the polling statistics
+ *				of the TPM state transitions.
+ *
+ *	@param		PwszFileName		Path of the JSON file. An existing file is overwritten.
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		...					Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Timing_WriteReport(
+	_In_z_	const wchar_t*	PwszFileName)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	void* pvFile = NULL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		unsigned int unIndex = 0;
+		BOOL fFirst = TRUE;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFileName))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized correctly (PwszFileName is NULL or empty)");
+			break;
+		}
+
+		unReturnValue = FileIO_Open(PwszFileName, &pvFile, FILE_WRITE);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			ERROR_STORE_FMT(unReturnValue, L"The timing report file (%ls) could not be created.", PwszFileName);
+			break;
+		}
+
+		unReturnValue = FileIO_WriteString(pvFile, L"{\n\t\"phases\": [");
+		for (unIndex = 0; unIndex < TIMING_PHASE_COUNT && RC_SUCCESS == unReturnValue; unIndex++)
+		{
+			const IfxTimingPhase* pPhase = &s_rgsPhases[unIndex];
+			if (0 == pPhase->unCount)
+				continue;
+
+			unReturnValue = FileIO_WriteStringf(
+				pvFile,
+				L"%ls\n\t\t{\"name\": \"%ls\", \"count\": %u, \"total_us\": %llu, \"min_us\": %llu, \"max_us\": %llu}",
+				fFirst ? L"" : L",",
+				s_rgwszPhaseNames[unIndex],
+				pPhase->unCount,
+				pPhase->ullTotalUs,
+				pPhase->ullMinUs,
+				pPhase->ullMaxUs);
+			fFirst = FALSE;
+		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = FileIO_WriteString(pvFile, L"\n\t],\n\t\"commands\": [");
+		for (unIndex = 0; unIndex < s_unCommandCount && RC_SUCCESS == unReturnValue; unIndex++)
+		{
+			const IfxTimingCommand* pCommand = &s_rgsCommands[unIndex];
+
+			unReturnValue = FileIO_WriteStringf(
+				pvFile,
+				L"%ls\n\t\t{\"name\": \"%ls\", \"code\": \"0x%.8X\", \"count\": %u, \"errors\": %u, \"min_us\": %llu, \"avg_us\": %llu, \"p50_us\": %llu, \"p99_us\": %llu, \"max_us\": %llu, \"request_bytes\": %llu, \"response_bytes\": %llu}",
+				0 == unIndex ? L"" : L",",
+				NULL != pCommand->pwszCommandName ? pCommand->pwszCommandName : L"Unknown",
+				pCommand->unCommandCode,
+				pCommand->sLatency.unCount,
+				pCommand->unErrors,
+				pCommand->sLatency.ullMinUs,
+				pCommand->sLatency.ullTotalUs / pCommand->sLatency.unCount,
+				Timing_GetPercentile(pCommand, 50),
+				Timing_GetPercentile(pCommand, 99),
+				pCommand->sLatency.ullMaxUs,
+				pCommand->ullRequestBytes,
+				pCommand->ullResponseBytes);
+		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = FileIO_WriteString(pvFile, L"\n\t],\n\t\"waits\": [");
+		fFirst = TRUE;
+		for (unIndex = 0; unIndex < POLLING_WAIT_TYPE_COUNT && RC_SUCCESS == unReturnValue; unIndex++)
+		{
+			IfxPollingStatistics sStatistics = {0};
+			const wchar_t* pwszName = NULL;
+
+			if (RC_SUCCESS != Polling_GetStatistics((POLLING_WAIT_TYPE)unIndex, &sStatistics, &pwszName) || 0 == sStatistics.unWaits)
+				continue;
+
+			unReturnValue = FileIO_WriteStringf(
+				pvFile,
+				L"%ls\n\t\t{\"name\": \"%ls\", \"count\": %u, \"timeouts\": %u, \"polls\": %llu, \"max_polls\": %u, \"avg_us\": %llu, \"max_us\": %llu}",
+				fFirst ? L"" : L",",
+				pwszName,
+				sStatistics.unWaits,
+				sStatistics.unTimeouts,
+				sStatistics.ullPolls,
+				sStatistics.unMaxPolls,
+				sStatistics.ullTotalTimeUs / sStatistics.unWaits,
+				sStatistics.ullMaxTimeUs);
+			fFirst = FALSE;
+		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = FileIO_WriteString(pvFile, L"\n\t]\n}\n");
+	}
+	WHILE_FALSE_END;
+
+	if (NULL != pvFile)
+	{
+		unsigned int unCloseReturnValue = FileIO_Close(&pvFile);
+		if (RC_SUCCESS == unReturnValue)
+			unReturnValue = unCloseReturnValue;
+	}
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
@@ -0,0 +1,101 @@
+﻿/**
+ *	@brief		Declares the timing instrumentation
+ *	@details	This module records the duration of firmware update phases and the latency of TPM commands.
+ *	@file		Timing.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	@brief		Firmware update phases
+ *	@details	Enumerates the phases of a firmware update whose wall-clock time is recorded.
+ */
+typedef enum tdTIMING_PHASE
+{
+	/// FirmwareUpdate_CalculateState
+	TIMING_PHASE_CALCULATE_STATE = 0,
+	/// FirmwareUpdate_PrepareTPM20Policy
+	TIMING_PHASE_PREPARE_POLICY = 1,
+	/// FirmwareUpdate_Start_Tpm20 or FirmwareUpdate_Start_Tpm12
+	TIMING_PHASE_START = 2,
+	/// Wait for the TPM to switch to boot loader mode
+	TIMING_PHASE_BOOT_LOADER_WAIT = 3,
+	/// A single TPM_FieldUpgradeUpdate block
+	TIMING_PHASE_UPDATE_BLOCK = 4,
+	/// FirmwareUpdate_Complete
+	TIMING_PHASE_COMPLETE = 5,
+	/// Number of phases
+	TIMING_PHASE_COUNT = 6
+} TIMING_PHASE;
+
+/**
+ *	@brief		Records the duration of a phase
+ *	@details	The phase ends with the call of this function.
+ *
+ *	@param		PePhase				Phase
+ *	@param		PullStartUs			Monotonic time stamp of the start of the phase in microseconds
+ */
+void
+Timing_RecordPhase(
+	_In_	TIMING_PHASE		PePhase,
+	_In_	unsigned long long	PullStartUs);
+
+/**
+ *	@brief		Records the latency of a TPM command
+ *	@details	The command ends with the call of this function.
+ *
+ *	@param		PunCommandCode			TPM command ordinal (0 if unknown)
+ *	@param		PwszCommandName			TPM command name (optional, can be NULL)
+ *	@param		PullStartUs				Monotonic time stamp of the start of the command in microseconds
+ *	@param		PunRequestSize			Size of the command request in bytes
+ *	@param		PunResponseSize			Size of the command response in bytes
+ *	@param		PunReturnCode			Return code of the transmission
+ */
+void
+Timing_RecordCommand(
+	_In_		unsigned int		PunCommandCode,
+	_In_opt_	const wchar_t*		PwszCommandName,
+	_In_		unsigned long long	PullStartUs,
+	_In_		unsigned int		PunRequestSize,
+	_In_		unsigned int		PunResponseSize,
+	_In_		unsigned int		PunReturnCode);
+
+/**
+ *	@brief		Writes the timing summary table to the log
+ *	@details	The summary is written with logging level 3.
+ */
+void
+Timing_LogSummary();
+
+/**
+ *	@brief		Writes the timing report as JSON file
+ *	@details	The file contains the phase durations and the per-command latency statistics.
+ *
+ *	@param		PwszFileName		Path of the JSON file. An existing file is overwritten.
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		...					Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Timing_WriteReport(
+	_In_z_	const wchar_t*	PwszFileName);
+
+#ifdef __cplusplus
+}
+#endif
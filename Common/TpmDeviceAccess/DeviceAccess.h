@@ -15,6 +15,33 @@
 
 #include "StdInclude.h"
 
+/// Function pointer to a handler reading a byte from a register instead of the mapped memory
+typedef
+BYTE
+(*PFN_DEVICE_ACCESS_READ_BYTE)(
+	unsigned int	PunMemoryAddress);
+/// Function pointer to a handler writing a byte to a register instead of the mapped memory
+typedef
+void
+(*PFN_DEVICE_ACCESS_WRITE_BYTE)(
+	unsigned int	PunMemoryAddress,
+	BYTE			PbData);
+
+/**
+ *	@brief		Set handlers for the register accesses
+ *	@details	While handlers are set, all accesses (including word, double word and FIFO accesses) are split into
+ *				byte accesses and routed to the handlers instead of the memory mapped by DeviceAccess_Initialize.
+ *				This allows to run the TIS protocol against a simulated TPM. Pass NULL to restore the memory access.
+ *				Must not be called while the device access is initialized.
+ *
+ *	@param		PfnReadByte		Handler for reading a byte (NULL to restore the memory access)
+ *	@param		PfnWriteByte	Handler for writing a byte (NULL to restore the memory access)
+ */
+void
+DeviceAccess_SetRegisterHandlers(
+	_In_opt_	PFN_DEVICE_ACCESS_READ_BYTE		PfnReadByte,
+	_In_opt_	PFN_DEVICE_ACCESS_WRITE_BYTE	PfnWriteByte);
+
 /**
  *	@brief		Initialize the device access
  *	@details
@@ -86,3 +113,55 @@ void
 DeviceAccess_WriteWord(
 	_In_	unsigned int	PunMemoryAddress,
 	_In_	unsigned short	PusData);
+
+/**
+ *	@brief		Read a DWord from the specified memory address
+ *	@details
+ *
+ *	@param		PunMemoryAddress	Memory address
+ *	@returns	Data value read from specified memory
+ */
+_Check_return_
+UINT32
+DeviceAccess_ReadDWord(
+	_In_	unsigned int	PunMemoryAddress);
+
+/**
+ *	@brief		Read a block of data from a FIFO register at the specified memory address
+ *	@details	The FIFO register is read repeatedly using accesses of PbAccessWidth bytes. Any remaining bytes
+ *				which do not fill a complete access are read using byte accesses. The address range is checked only once.
+ *
+ *	@param		PunMemoryAddress	Memory address of the FIFO register
+ *	@param		PbAccessWidth		Access width in bytes (sizeof(BYTE) or sizeof(UINT32))
+ *	@param		PrgbData			Buffer receiving the data
+ *	@param		PunDataSize			Number of bytes to read
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ */
+_Check_return_
+unsigned int
+DeviceAccess_ReadFifo(
+	_In_							unsigned int	PunMemoryAddress,
+	_In_							BYTE			PbAccessWidth,
+	_Out_bytecap_(PunDataSize)		BYTE*			PrgbData,
+	_In_							unsigned int	PunDataSize);
+
+/**
+ *	@brief		Write a block of data to a FIFO register at the specified memory address
+ *	@details	The FIFO register is written repeatedly using accesses of PbAccessWidth bytes. Any remaining bytes
+ *				which do not fill a complete access are written using byte accesses. The address range is checked only once.
+ *
+ *	@param		PunMemoryAddress	Memory address of the FIFO register
+ *	@param		PbAccessWidth		Access width in bytes (sizeof(BYTE) or sizeof(UINT32))
+ *	@param		PrgbData			Data to write
+ *	@param		PunDataSize			Number of bytes to write
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ */
+_Check_return_
+unsigned int
+DeviceAccess_WriteFifo(
+	_In_							unsigned int	PunMemoryAddress,
+	_In_							BYTE			PbAccessWidth,
+	_In_bytecount_(PunDataSize)		const BYTE*		PrgbData,
+	_In_							unsigned int	PunDataSize);
@@ -20,9 +20,38 @@
 
 static UINT32 s_unFileHandle = 0;
 static BYTE *s_bMemPtr = NULL;
+static PFN_DEVICE_ACCESS_READ_BYTE s_pfnReadByte = NULL;
+static PFN_DEVICE_ACCESS_WRITE_BYTE s_pfnWriteByte = NULL;
 
 #define DEV_TPM_MEM "/dev/mem"
 
+/**
+ *	@brief		Set handlers for the register accesses
+ *	@details	While handlers are set, all accesses (including word, double word and FIFO accesses) are split into
+ *				byte accesses and routed to the handlers instead of the memory mapped by DeviceAccess_Initialize.
+ *				This allows to run the TIS protocol against a simulated TPM. Pass NULL to restore the memory access.
+ *				Must not be called while the device access is initialized.
+ *
+ *	@param		PfnReadByte		Handler for reading a byte (NULL to restore the memory access)
+ *	@param		PfnWriteByte	Handler for writing a byte (NULL to restore the memory access)
+ */
+void
+DeviceAccess_SetRegisterHandlers(
+	_In_opt_	PFN_DEVICE_ACCESS_READ_BYTE		PfnReadByte,
+	_In_opt_	PFN_DEVICE_ACCESS_WRITE_BYTE	PfnWriteByte)
+{
+	if (NULL == PfnReadByte || NULL == PfnWriteByte)
+	{
+		s_pfnReadByte = NULL;
+		s_pfnWriteByte = NULL;
+	}
+	else
+	{
+		s_pfnReadByte = PfnReadByte;
+		s_pfnWriteByte = PfnWriteByte;
+	}
+}
+
 /**
  *	@brief		Initialize the device access
  *	@details
@@ -42,6 +71,13 @@ DeviceAccess_Initialize(
 
 	do
 	{
+		// Nothing to map if the register accesses are handled
+		if (NULL != s_pfnReadByte)
+		{
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+
 		s_unFileHandle = open(DEV_TPM_MEM, O_RDWR);
 		if (s_unFileHandle == (UINT32) - 1)
 		{
@@ -86,17 +122,29 @@ DeviceAccess_Uninitialize(
 	unsigned int unReturnValue = RC_E_FAIL;
 	UNREFERENCED_PARAMETER(PbLocality);
 
-	munmap(s_bMemPtr, TPM_DEFAULT_MEM_SIZE);
-
-	if (close(s_unFileHandle) == -1)
-	{
-		LOGGING_WRITE_LEVEL1_FMT(L"Error: Close device pseudo file %s failed with errno %d (%s).", DEV_TPM_MEM, errno, strerror(errno));
-		unReturnValue = RC_E_INTERNAL;
-	}
-	else
+	do
 	{
-		unReturnValue = RC_SUCCESS;
+		// Nothing was mapped if the register accesses are handled
+		if (NULL != s_pfnReadByte)
+		{
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+
+		munmap(s_bMemPtr, TPM_DEFAULT_MEM_SIZE);
+
+		if (close(s_unFileHandle) == -1)
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: Close device pseudo file %s failed with errno %d (%s).", DEV_TPM_MEM, errno, strerror(errno));
+			unReturnValue = RC_E_INTERNAL;
+		}
+		else
+		{
+			unReturnValue = RC_SUCCESS;
+		}
 	}
+	WHILE_FALSE_END;
+
 	return unReturnValue;
 }
 
@@ -118,6 +166,10 @@ DeviceAccess_ReadByte(
 	{
 		LOGGING_WRITE_LEVEL4_FMT(L"Error: DeviceAccess_ReadByte: Memory address %0.4X is invalid!", PunMemoryAddress);
 	}
+	else if (NULL != s_pfnReadByte)
+	{
+		bPortValue = s_pfnReadByte(PunMemoryAddress);
+	}
 	else
 	{
 		bPortValue = s_bMemPtr[PunMemoryAddress - TPM_DEFAULT_MEM_BASE];
@@ -145,6 +197,10 @@ DeviceAccess_WriteByte(
 	{
 		LOGGING_WRITE_LEVEL4_FMT(L"Error: DeviceAccess_WriteByte: Memory address %0.4X is invalid!", PunMemoryAddress);
 	}
+	else if (NULL != s_pfnWriteByte)
+	{
+		s_pfnWriteByte(PunMemoryAddress, PbData);
+	}
 	else
 	{
 		s_bMemPtr[PunMemoryAddress - TPM_DEFAULT_MEM_BASE] = PbData;
@@ -169,6 +225,11 @@ DeviceAccess_ReadWord(
 	{
 		LOGGING_WRITE_LEVEL4_FMT(L"Error: DeviceAccess_ReadWord: Memory address %0.4X is invalid!", PunMemoryAddress);
 	}
+	else if (NULL != s_pfnReadByte)
+	{
+		// TIS registers are little endian
+		usPortValue = (UINT16)(s_pfnReadByte(PunMemoryAddress) | (s_pfnReadByte(PunMemoryAddress + 1) << 8));
+	}
 	else
 	{
 		unReturnValue = Platform_MemoryCopy(&usPortValue, sizeof(UINT16), (const void*) & s_bMemPtr[PunMemoryAddress - TPM_DEFAULT_MEM_BASE], sizeof(UINT16));
@@ -201,6 +262,11 @@ DeviceAccess_WriteWord(
 	{
 		LOGGING_WRITE_LEVEL4_FMT(L"Error: DeviceAccess_WriteWord: Memory address %0.4X is invalid!", PunMemoryAddress);
 	}
+	else if (NULL != s_pfnWriteByte)
+	{
+		s_pfnWriteByte(PunMemoryAddress, (BYTE)PusData);
+		s_pfnWriteByte(PunMemoryAddress + 1, (BYTE)(PusData >> 8));
+	}
 	else
 	{
 		unReturnValue = Platform_MemoryCopy(& s_bMemPtr[PunMemoryAddress - TPM_DEFAULT_MEM_BASE], sizeof(UINT16), (const void*) & PusData, sizeof(unsigned short));
@@ -210,3 +276,179 @@ DeviceAccess_WriteWord(
 		}
 	}
 }
+
+/**
+ *	@brief		Read a DWord from the specified memory address
+ *	@details
+ *
+ *	@param		PunMemoryAddress	Memory address
+ *	@returns	Data value read from specified memory
+ */
+_Check_return_
+UINT32
+DeviceAccess_ReadDWord(
+	_In_	unsigned int	PunMemoryAddress)
+{
+	UINT32 unPortValue = 0;
+
+	if (PunMemoryAddress < TPM_DEFAULT_MEM_BASE || PunMemoryAddress > (TPM_DEFAULT_MEM_BASE + TPM_DEFAULT_MEM_SIZE - sizeof(UINT32)))
+	{
+		LOGGING_WRITE_LEVEL4_FMT(L"Error: DeviceAccess_ReadDWord: Memory address %0.4X is invalid!", PunMemoryAddress);
+	}
+	else if (NULL != s_pfnReadByte)
+	{
+		unsigned int unIndex = 0;
+		for (unIndex = sizeof(UINT32); unIndex > 0; unIndex--)
+			unPortValue = (unPortValue << 8) | s_pfnReadByte(PunMemoryAddress + unIndex - 1);
+	}
+	else
+	{
+		unPortValue = *(volatile UINT32*)&s_bMemPtr[PunMemoryAddress - TPM_DEFAULT_MEM_BASE];
+	}
+
+	LOGGING_WRITE_LEVEL4_FMT(L"DeviceAccess_ReadDWord: Address: %0.4X: %0.8X", PunMemoryAddress, unPortValue);
+	return unPortValue;
+}
+
+/**
+ *	@brief		Read a block of data from a FIFO register at the specified memory address
+ *	@details	The FIFO register is read repeatedly using accesses of PbAccessWidth bytes. Any remaining bytes
+ *				which do not fill a complete access are read using byte accesses. The address range is checked only once.
+ *
+ *	@param		PunMemoryAddress	Memory address of the FIFO register
+ *	@param		PbAccessWidth		Access width in bytes (sizeof(BYTE) or sizeof(UINT32))
+ *	@param		PrgbData			Buffer receiving the data
+ *	@param		PunDataSize			Number of bytes to read
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ */
+_Check_return_
+unsigned int
+DeviceAccess_ReadFifo(
+	_In_							unsigned int	PunMemoryAddress,
+	_In_							BYTE			PbAccessWidth,
+	_Out_bytecap_(PunDataSize)		BYTE*			PrgbData,
+	_In_							unsigned int	PunDataSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		unsigned int unPosition = 0;
+		volatile BYTE* pbFifo = NULL;
+
+		if (NULL == PrgbData ||
+				(sizeof(BYTE) != PbAccessWidth && sizeof(UINT32) != PbAccessWidth) ||
+				PunMemoryAddress < TPM_DEFAULT_MEM_BASE ||
+				PunMemoryAddress > (TPM_DEFAULT_MEM_BASE + TPM_DEFAULT_MEM_SIZE - PbAccessWidth))
+		{
+			LOGGING_WRITE_LEVEL4_FMT(L"Error: DeviceAccess_ReadFifo: Memory address %0.4X or access width %d is invalid!", PunMemoryAddress, PbAccessWidth);
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		if (NULL != s_pfnReadByte)
+		{
+			// Handled register accesses are always byte accesses
+			for (; unPosition < PunDataSize; unPosition++)
+				PrgbData[unPosition] = s_pfnReadByte(PunMemoryAddress);
+		}
+		else
+		{
+			pbFifo = &s_bMemPtr[PunMemoryAddress - TPM_DEFAULT_MEM_BASE];
+
+			if (sizeof(UINT32) == PbAccessWidth)
+			{
+				for (; unPosition + sizeof(UINT32) <= PunDataSize; unPosition += sizeof(UINT32))
+				{
+					UINT32 unValue = *(volatile UINT32*)pbFifo;
+					memcpy(&PrgbData[unPosition], &unValue, sizeof(UINT32));
+				}
+			}
+
+			// Remaining bytes (or all bytes in case of byte access)
+			for (; unPosition < PunDataSize; unPosition++)
+				PrgbData[unPosition] = *pbFifo;
+		}
+
+		LOGGING_WRITE_LEVEL4_FMT(L"DeviceAccess_ReadFifo: Address: %0.4X: %d bytes (access width %d)", PunMemoryAddress, PunDataSize, PbAccessWidth);
+		LOGGING_WRITEHEX(LOGGING_LEVEL_4, PrgbData, PunDataSize);
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Write a block of data to a FIFO register at the specified memory address
+ *	@details	The FIFO register is written repeatedly using accesses of PbAccessWidth bytes. Any remaining bytes
+ *				which do not fill a complete access are written using byte accesses. The address range is checked only once.
+ *
+ *	@param		PunMemoryAddress	Memory address of the FIFO register
+ *	@param		PbAccessWidth		Access width in bytes (sizeof(BYTE) or sizeof(UINT32))
+ *	@param		PrgbData			Data to write
+ *	@param		PunDataSize			Number of bytes to write
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ */
+_Check_return_
+unsigned int
+DeviceAccess_WriteFifo(
+	_In_							unsigned int	PunMemoryAddress,
+	_In_							BYTE			PbAccessWidth,
+	_In_bytecount_(PunDataSize)		const BYTE*		PrgbData,
+	_In_							unsigned int	PunDataSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		unsigned int unPosition = 0;
+		volatile BYTE* pbFifo = NULL;
+
+		if (NULL == PrgbData ||
+				(sizeof(BYTE) != PbAccessWidth && sizeof(UINT32) != PbAccessWidth) ||
+				PunMemoryAddress < TPM_DEFAULT_MEM_BASE ||
+				PunMemoryAddress > (TPM_DEFAULT_MEM_BASE + TPM_DEFAULT_MEM_SIZE - PbAccessWidth))
+		{
+			LOGGING_WRITE_LEVEL4_FMT(L"Error: DeviceAccess_WriteFifo: Memory address %0.4X or access width %d is invalid!", PunMemoryAddress, PbAccessWidth);
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		LOGGING_WRITE_LEVEL4_FMT(L"DeviceAccess_WriteFifo: Address: %0.4X: %d bytes (access width %d)", PunMemoryAddress, PunDataSize, PbAccessWidth);
+		LOGGING_WRITEHEX(LOGGING_LEVEL_4, PrgbData, PunDataSize);
+
+		if (NULL != s_pfnWriteByte)
+		{
+			// Handled register accesses are always byte accesses
+			for (; unPosition < PunDataSize; unPosition++)
+				s_pfnWriteByte(PunMemoryAddress, PrgbData[unPosition]);
+		}
+		else
+		{
+			pbFifo = &s_bMemPtr[PunMemoryAddress - TPM_DEFAULT_MEM_BASE];
+
+			if (sizeof(UINT32) == PbAccessWidth)
+			{
+				for (; unPosition + sizeof(UINT32) <= PunDataSize; unPosition += sizeof(UINT32))
+				{
+					UINT32 unValue = 0;
+					memcpy(&unValue, &PrgbData[unPosition], sizeof(UINT32));
+					*(volatile UINT32*)pbFifo = unValue;
+				}
+			}
+
+			// Remaining bytes (or all bytes in case of byte access)
+			for (; unPosition < PunDataSize; unPosition++)
+				*pbFifo = PrgbData[unPosition];
+		}
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
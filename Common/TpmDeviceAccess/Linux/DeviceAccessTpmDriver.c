@@ -18,32 +18,52 @@
 #include "Logging.h"
 #include "Platform.h"
 #include "PropertyStorage.h"
+#include "Polling.h"
 
 #define DEV_TPM "/dev/tpm0"
 
+/// Maximum time in milliseconds to retry writing a command while the driver reports EBUSY
+#define DEV_TPM_BUSY_TIMEOUT 4000
+
+/// Time in microseconds to wait before polling again after the driver returned an empty response
+#define DEV_TPM_EMPTY_READ_SLEEP 1000
+
 /**
  *	@brief		Initialize the device access via config setting DEVICE_PATH
  *	@details	Default value is /dev/tpm0. If an invalid device path is configured
  *				the tool will return "No connection to the TPM or TPM not found (0xE0295200)".
+ *				The device is opened in non-blocking mode. Completion of a command is awaited with poll().
  *
- *	@retval		RC_SUCCESS		The operation completed successfully.
- *	@retval		RC_E_INTERNAL	The operation failed.
- *	@retval		RC_E_NO_TPM		In case of an open call to /dev/tpm0 failed
+ *	@param		PpnFileHandle	Pointer to an integer receiving the file descriptor of the opened device
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		RC_E_INTERNAL		The operation failed.
+ *	@retval		RC_E_NO_TPM			In case of an open call to /dev/tpm0 failed
  */
 _Check_return_
 unsigned int
-DeviceAccessTpmDriver_Initialize()
+DeviceAccessTpmDriver_Initialize(
+	_Out_	int*	PpnFileHandle)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 	LOGGING_WRITE_LEVEL4(L"Using Kernel-Driver");
 
 	do
 	{
-		UINT32 unFileHandle = 0;
+		int nFileHandle = -1;
 		char szDevicePath[PROPERTY_STORAGE_MAX_VALUE] = {0};
 		wchar_t wszDevicePath[PROPERTY_STORAGE_MAX_VALUE] = {0};
 		UINT32 unDevicePathSize = RG_LEN(wszDevicePath);
 
+		// Check parameters
+		if (NULL == PpnFileHandle)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		*PpnFileHandle = -1;
+
 		if (FALSE == PropertyStorage_GetValueByKey(PROPERTY_TPM_DEVICE_ACCESS_PATH, wszDevicePath, &unDevicePathSize))
 		{
 			unReturnValue = RC_E_INTERNAL;
@@ -53,8 +73,8 @@ DeviceAccessTpmDriver_Initialize()
 
 		unDevicePathSize = wcstombs(szDevicePath, wszDevicePath, unDevicePathSize + 1 );
 
-		unFileHandle = open(szDevicePath, O_RDWR);
-		if (unFileHandle == (UINT32) - 1)
+		nFileHandle = open(szDevicePath, O_RDWR | O_NONBLOCK);
+		if (-1 == nFileHandle)
 		{
 			int nErrorNumber = errno;
 			if (EBUSY == nErrorNumber)
@@ -68,13 +88,7 @@ DeviceAccessTpmDriver_Initialize()
 			break;
 		}
 
-		if (!PropertyStorage_AddKeyUIntegerValuePair(PROPERTY_DEV_TPM_HANDLE, unFileHandle))
-		{
-			unReturnValue = RC_E_INTERNAL;
-			LOGGING_WRITE_LEVEL1_FMT(L"Error: Storing device handle failed (%.8x).", unReturnValue);
-			break;
-		}
-
+		*PpnFileHandle = nFileHandle;
 		unReturnValue = RC_SUCCESS;
 	}
 	WHILE_FALSE_END;
@@ -86,37 +100,34 @@ DeviceAccessTpmDriver_Initialize()
  *	@brief		UnInitialize the device access
  *	@details
  *
+ *	@param		PnFileHandle	File descriptor of the opened device
+ *
  *	@retval		RC_SUCCESS		The operation completed successfully.
- *	@retval		RC_E_INTERNAL	If the DEV_TPM_HANDLE is not present in the property PropertyStorage
+ *	@retval		RC_E_INTERNAL	If the file descriptor is invalid
  *	@retval		RC_E_FAIL		An unexpected error occurred.
  */
 _Check_return_
 unsigned int
-DeviceAccessTpmDriver_Uninitialize()
+DeviceAccessTpmDriver_Uninitialize(
+	_In_	int		PnFileHandle)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 	do
 	{
-		UINT32 unFileHandle = 0;
-
-		if (!PropertyStorage_GetUIntegerValueByKey(PROPERTY_DEV_TPM_HANDLE, &unFileHandle) ||
-				0 == unFileHandle)
+		if (0 > PnFileHandle)
 		{
 			unReturnValue = RC_E_INTERNAL;
-			LOGGING_WRITE_LEVEL1_FMT(L"Error: Retrieving device handle failed (%.8x).", unReturnValue);
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: Invalid device handle (%.8x).", unReturnValue);
 			break;
 		}
 
-		if (close(unFileHandle) == -1)
+		if (close(PnFileHandle) == -1)
 		{
 			unReturnValue = RC_E_FAIL;
 			LOGGING_WRITE_LEVEL1_FMT(L"Error: Close device pseudo file failed with errno %d (%s).", errno, strerror(errno));
 			break;
 		}
 
-		if (!PropertyStorage_RemoveElement(PROPERTY_DEV_TPM_HANDLE))
-			LOGGING_WRITE_LEVEL3_FMT(L"Error: Removing device handle (%.8x).", unReturnValue);
-
 		unReturnValue = RC_SUCCESS;
 	}
 	WHILE_FALSE_END;
@@ -124,68 +135,258 @@ DeviceAccessTpmDriver_Uninitialize()
 	return unReturnValue;
 }
 
+/**
+ *	@brief		Wait for an event on the device
+ *	@details	Waits with poll() until the requested event is signaled on the device or the deadline is reached.
+ *				Interrupted waits are resumed with the remaining time.
+ *
+ *	@param		PnFileHandle			File descriptor of the opened device
+ *	@param		PsEvents				Events to wait for (POLLIN or POLLOUT)
+ *	@param		PullDeadlineUs			Monotonic time stamp of the deadline in microseconds, 0 to wait without deadline
+ *
+ *	@retval		RC_SUCCESS					The event has been signaled.
+ *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	The deadline has been reached.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
+ */
+_Check_return_
+static
+unsigned int
+DeviceAccessTpmDriver_Wait(
+	_In_	int					PnFileHandle,
+	_In_	short				PsEvents,
+	_In_	unsigned long long	PullDeadlineUs)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	while (1)
+	{
+		struct pollfd sPollFd;
+		int nTimeoutMs = -1;
+		int nResult = 0;
+
+		sPollFd.fd = PnFileHandle;
+		sPollFd.events = PsEvents;
+		sPollFd.revents = 0;
+
+		if (0 != PullDeadlineUs)
+		{
+			unsigned long long ullNowUs = Platform_GetMonotonicTimeMicroSeconds();
+			if (ullNowUs >= PullDeadlineUs)
+			{
+				unReturnValue = RC_E_TPM_NO_DATA_AVAILABLE;
+				break;
+			}
+			// Round up, otherwise poll() returns shortly before the deadline
+			nTimeoutMs = (int)((PullDeadlineUs - ullNowUs + 999) / 1000);
+		}
+
+		nResult = poll(&sPollFd, 1, nTimeoutMs);
+		if (-1 == nResult)
+		{
+			if (EINTR == errno)
+				continue;
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: DeviceAccess_Wait: Poll failed with errno %d (%s).", errno, strerror(errno));
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		// Errors and hang-ups of the device are reported by the following read() or write()
+		if (0 != sPollFd.revents)
+		{
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+	}
+
+	return unReturnValue;
+}
+
 /**
  *	@brief		TPM transmit function
  *	@details	This function submits the TPM command to the underlying TPM.
  *
+ *	@param		PnFileHandle			File descriptor of the opened device
  *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
  *	@param		PunRequestBufferSize	Size of command request in bytes
  *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
  *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds, 0 to wait without deadline
+ *	@param		PfRetryBusy				TRUE to retry the write while the driver reports EBUSY, see DeviceAccessTpmDriver_Send
  *
- *	@retval		RC_SUCCESS				The operation completed successfully.
- *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
- *	@retval		RC_E_INTERNAL			If the DEV_TPM_HANDLE is not present in the property PropertyStorage
- *	@retval		RC_E_FAIL				An unexpected error occurred.
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER			An invalid parameter was passed to the function.
+ *	@retval		RC_E_INTERNAL				If the file descriptor is invalid
+ *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	The response was not available within the maximum duration.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
  */
 _Check_return_
 unsigned int
 DeviceAccessTpmDriver_Transmit(
+	_In_										int				PnFileHandle,
 	_In_bytecount_(PunRequestBufferSize)		const BYTE*		PrgbRequestBuffer,
 	_In_										unsigned int	PunRequestBufferSize,
 	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
-	_Inout_										unsigned int*	PpunResponseBufferSize)
+	_Inout_										unsigned int*	PpunResponseBufferSize,
+	_In_										unsigned int	PunMaxDuration,
+	_In_										BOOL			PfRetryBusy)
+{
+	unsigned int unReturnValue = DeviceAccessTpmDriver_Send(PnFileHandle, PrgbRequestBuffer, PunRequestBufferSize, PfRetryBusy);
+	if (RC_SUCCESS == unReturnValue)
+		unReturnValue = DeviceAccessTpmDriver_Receive(PnFileHandle, PrgbResponseBuffer, PpunResponseBufferSize, PunMaxDuration);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		TPM send function
+ *	@details	Writes the TPM command to the device. The response must be read with DeviceAccessTpmDriver_Receive.
+ *				Allows the caller to do other work while the TPM executes the command. While the driver reports EBUSY
+ *				the write is retried with sub-millisecond backoff for up to DEV_TPM_BUSY_TIMEOUT milliseconds unless PfRetryBusy
+ *				is FALSE.
+ *
+ *	@param		PnFileHandle			File descriptor of the opened device
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *	@param		PfRetryBusy				TRUE to retry the write while the driver reports EBUSY
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_INTERNAL			If the file descriptor is invalid
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+DeviceAccessTpmDriver_Send(
+	_In_									int				PnFileHandle,
+	_In_bytecount_(PunRequestBufferSize)	const BYTE*		PrgbRequestBuffer,
+	_In_									unsigned int	PunRequestBufferSize,
+	_In_									BOOL			PfRetryBusy)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 
 	do
 	{
-		UINT32 unFileHandle = 0;
 		int nBytes = 0;
-		int nWriteRetryCounter = 0;
+		int nErrorNumber = 0;
+		IfxPoll sPoll;
 
 		// Check parameters
-		if (NULL == PrgbRequestBuffer || NULL == PrgbResponseBuffer || NULL == PpunResponseBufferSize)
+		if (NULL == PrgbRequestBuffer)
 		{
 			unReturnValue = RC_E_BAD_PARAMETER;
 			break;
 		}
 
-		if (!PropertyStorage_GetUIntegerValueByKey(PROPERTY_DEV_TPM_HANDLE, &unFileHandle) ||
-				0 == unFileHandle)
+		if (0 > PnFileHandle)
 		{
 			unReturnValue = RC_E_INTERNAL;
-			LOGGING_WRITE_LEVEL1_FMT(L"Error: Retrieving device handle failed (%.8x).", unReturnValue);
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: Invalid device handle (%.8x).", unReturnValue);
 			break;
 		}
 
-		while (1) {
-			nBytes = write(unFileHandle, PrgbRequestBuffer, PunRequestBufferSize);
-			if (nBytes == -1 && errno == EBUSY && ++nWriteRetryCounter < 5) {
-				LOGGING_WRITE_LEVEL1(L"Error: DeviceAccess_Transmit: Write failed with EBUSY, retrying.");
-				Platform_Sleep(1000);
-			} else {
+		Polling_Start(&sPoll, POLLING_WAIT_DRIVER_BUSY, DEV_TPM_BUSY_TIMEOUT * 1000);
+		while (1)
+		{
+			nBytes = write(PnFileHandle, PrgbRequestBuffer, PunRequestBufferSize);
+			nErrorNumber = (-1 == nBytes) ? errno : 0;
+			if (EINTR == nErrorNumber)
+				continue;
+			if ((EBUSY != nErrorNumber && EAGAIN != nErrorNumber) || FALSE == PfRetryBusy || FALSE == Polling_Wait(&sPoll))
 				break;
-			}
 		}
+		Polling_Finish(&sPoll);
+
+		if (0 != sPoll.unPolls)
+			LOGGING_WRITE_LEVEL3_FMT(L"DeviceAccess_Transmit: Write retried %u times while the device was busy.", sPoll.unPolls);
 
 		if (nBytes == -1 || nBytes != (int)PunRequestBufferSize)
 		{
-			LOGGING_WRITE_LEVEL1_FMT(L"Error: DeviceAccess_Transmit: Write failed with errno %d (%s).", errno, strerror(errno));
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: DeviceAccess_Transmit: Write failed with errno %d (%s).", nErrorNumber, strerror(nErrorNumber));
 			unReturnValue = RC_E_FAIL;
 			break;
 		}
-		nBytes = read(unFileHandle, PrgbResponseBuffer, *PpunResponseBufferSize);
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		TPM receive function
+ *	@details	Reads the response of the TPM command written with DeviceAccessTpmDriver_Send. Waits with poll() until
+ *				the response is available or the maximum duration of the command has elapsed. An empty read means that the
+ *				response is not ready yet, so the function waits again until the deadline.
+ *
+ *	@param		PnFileHandle			File descriptor of the opened device
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds, 0 to wait without deadline
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER			An invalid parameter was passed to the function.
+ *	@retval		RC_E_INTERNAL				If the file descriptor is invalid
+ *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	The response was not available within the maximum duration.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+DeviceAccessTpmDriver_Receive(
+	_In_									int				PnFileHandle,
+	_Out_bytecap_(*PpunResponseBufferSize)	BYTE*			PrgbResponseBuffer,
+	_Inout_									unsigned int*	PpunResponseBufferSize,
+	_In_									unsigned int	PunMaxDuration)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		int nBytes = 0;
+		unsigned long long ullDeadlineUs = 0;
+
+		// Check parameters
+		if (NULL == PrgbResponseBuffer || NULL == PpunResponseBufferSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		if (0 > PnFileHandle)
+		{
+			unReturnValue = RC_E_INTERNAL;
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: Invalid device handle (%.8x).", unReturnValue);
+			break;
+		}
+
+		if (0 != PunMaxDuration)
+			ullDeadlineUs = Platform_GetMonotonicTimeMicroSeconds() + PunMaxDuration;
+
+		while (1)
+		{
+			unReturnValue = DeviceAccessTpmDriver_Wait(PnFileHandle, POLLIN, ullDeadlineUs);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			nBytes = read(PnFileHandle, PrgbResponseBuffer, *PpunResponseBufferSize);
+			if (-1 == nBytes && (EINTR == errno || EAGAIN == errno))
+				continue;
+			if (0 == nBytes)
+			{
+				// Response not ready yet, back off instead of spinning on a device which signals readiness early
+				Platform_SleepMicroSeconds(DEV_TPM_EMPTY_READ_SLEEP);
+				continue;
+			}
+			break;
+		}
+
+		if (RC_E_TPM_NO_DATA_AVAILABLE == unReturnValue)
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: DeviceAccess_Transmit: No response within %u microseconds.", PunMaxDuration);
+			break;
+		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
 		if (nBytes == -1)
 		{
 			LOGGING_WRITE_LEVEL1_FMT(L"Error: DeviceAccess_Transmit: Read failed with errno %d (%s).", errno, strerror(errno));
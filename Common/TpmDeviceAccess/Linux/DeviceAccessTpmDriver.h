@@ -1,6 +1,10 @@
 ﻿/**
  *	@brief		Declares the Device access routines via /dev/tpm0
- *	@details
+ *	@details	A pending command cannot be canceled. A cancel file descriptor was deliberately left out: the only sensible
+ *				source of a cancellation is a SIGINT or SIGTERM handler, and such a handler would also have to keep the
+ *				TPM_FieldUpgrade* commands from being aborted, because an interrupted firmware update can leave the TPM
+ *				without a working firmware. The per-command deadline of DeviceAccessTpmDriver_Receive bounds the wait
+ *				for a hung TPM instead.
  *	@file		Linux/DeviceAccessTpmDriver.h
  *	@copyright	Copyright 2016 - 2017 Infineon Technologies AG ( www.infineon.com )
  *
@@ -13,52 +17,113 @@
  *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-/// Define for the PropertyStorage key Device TPM Handle
-#define PROPERTY_DEV_TPM_HANDLE L"DevTpmHandle"
-
 /**
  *	@brief		Initialize the device access via config setting DEVICE_PATH
  *	@details	Default value is /dev/tpm0. If an invalid device path is configured
  *				the tool will return "No connection to the TPM or TPM not found (0xE0295200)".
  *
- *	@retval		RC_SUCCESS		The operation completed successfully.
- *	@retval		RC_E_INTERNAL	The operation failed.
- *	@retval		RC_E_NO_TPM		In case of an open call to /dev/tpm0 failed
+ *	@param		PpnFileHandle	Pointer to an integer receiving the file descriptor of the opened device
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		RC_E_INTERNAL		The operation failed.
+ *	@retval		RC_E_NO_TPM			In case of an open call to /dev/tpm0 failed
  */
 _Check_return_
 unsigned int
-DeviceAccessTpmDriver_Initialize();
+DeviceAccessTpmDriver_Initialize(
+	_Out_	int*	PpnFileHandle);
 
 /**
  *	@brief		UnInitialize the device access
  *	@details
  *
+ *	@param		PnFileHandle	File descriptor of the opened device
+ *
  *	@retval		RC_SUCCESS		The operation completed successfully.
- *	@retval		RC_E_INTERNAL	If the DEV_TPM_HANDLE is not present in the property PropertyStorage
+ *	@retval		RC_E_INTERNAL	If the file descriptor is invalid
  *	@retval		RC_E_FAIL		An unexpected error occurred.
  */
 _Check_return_
 unsigned int
-DeviceAccessTpmDriver_Uninitialize();
+DeviceAccessTpmDriver_Uninitialize(
+	_In_	int		PnFileHandle);
 
 /**
  *	@brief		TPM transmit function
  *	@details	This function submits the TPM command to the underlying TPM.
  *
+ *	@param		PnFileHandle			File descriptor of the opened device
  *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
  *	@param		PunRequestBufferSize	Size of command request in bytes
  *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
  *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds, 0 to wait without deadline
+ *	@param		PfRetryBusy				TRUE to retry the write while the driver reports EBUSY, see DeviceAccessTpmDriver_Send
  *
- *	@retval		RC_SUCCESS				The operation completed successfully.
- *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
- *	@retval		RC_E_INTERNAL			If the DEV_TPM_HANDLE is not present in the property PropertyStorage
- *	@retval		RC_E_FAIL				An unexpected error occurred.
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER			An invalid parameter was passed to the function.
+ *	@retval		RC_E_INTERNAL				If the file descriptor is invalid
+ *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	The response was not available within the maximum duration.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
  */
 _Check_return_
 unsigned int
 DeviceAccessTpmDriver_Transmit(
+	_In_										int				PnFileHandle,
 	_In_bytecount_(PunRequestBufferSize)		const BYTE*		PrgbRequestBuffer,
 	_In_										unsigned int	PunRequestBufferSize,
 	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
-	_Inout_										unsigned int*	PpunResponseBufferSize);
\ No newline at end of file
+	_Inout_										unsigned int*	PpunResponseBufferSize,
+	_In_										unsigned int	PunMaxDuration,
+	_In_										BOOL			PfRetryBusy);
+
+/**
+ *	@brief		TPM send function
+ *	@details	Writes the TPM command to the device. The response must be read with DeviceAccessTpmDriver_Receive.
+ *				Allows the caller to do other work while the TPM executes the command. While the driver reports EBUSY
+ *				the write is retried with sub-millisecond backoff for up to DEV_TPM_BUSY_TIMEOUT milliseconds unless PfRetryBusy
+ *				is FALSE.
+ *
+ *	@param		PnFileHandle			File descriptor of the opened device
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *	@param		PfRetryBusy				TRUE to retry the write while the driver reports EBUSY
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_INTERNAL			If the file descriptor is invalid
+ *	@retval		RC_E_FAIL				An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+DeviceAccessTpmDriver_Send(
+	_In_									int				PnFileHandle,
+	_In_bytecount_(PunRequestBufferSize)	const BYTE*		PrgbRequestBuffer,
+	_In_									unsigned int	PunRequestBufferSize,
+	_In_									BOOL			PfRetryBusy);
+
+/**
+ *	@brief		TPM receive function
+ *	@details	Reads the response of the TPM command written with DeviceAccessTpmDriver_Send. Waits with poll() until
+ *				the response is available or the maximum duration of the command has elapsed. An empty read means that the
+ *				response is not ready yet, so the function waits again until the deadline.
+ *
+ *	@param		PnFileHandle			File descriptor of the opened device
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds, 0 to wait without deadline
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER			An invalid parameter was passed to the function.
+ *	@retval		RC_E_INTERNAL				If the file descriptor is invalid
+ *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	The response was not available within the maximum duration.
+ *	@retval		RC_E_FAIL					An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+DeviceAccessTpmDriver_Receive(
+	_In_									int				PnFileHandle,
+	_Out_bytecap_(*PpunResponseBufferSize)	BYTE*			PrgbResponseBuffer,
+	_Inout_									unsigned int*	PpunResponseBufferSize,
+	_In_									unsigned int	PunMaxDuration);
\ No newline at end of file
@@ -15,29 +15,543 @@
 
 #include "StdInclude.h"
 #include "TpmIO.h"
+#include "TpmTransport.h"
 #include "Logging.h"
 #include "DeviceAccess.h"
 #include "DeviceAccessTpmDriver.h"
 #include "Platform.h"
 #include "TPM_TIS.h"
+#include "Polling.h"
 #include "PropertyStorage.h"
 
-/// Maximum amount of times to retry the TPM command in case the TPM is not responsive.
-#define TPM_FU_MAX_RETRIES 5U
-/// Default wait time in milliseconds in between two of the above checks.
-#define TPM_FU_RETRY_WAIT_TIME 1000
-/// Global flag to signalize if module is connected or disconnected
-BOOL g_fConnected = 0;
+/// Maximum time in milliseconds to retry the TPM command in case the TPM is not responsive.
+#define TPM_FU_RETRY_TIMEOUT 5000
 /// Define for locality configuration setting property
 #define PROPERTY_LOCALITY				L"Locality"
 
+/**
+ *	@brief		Initialize the /dev/tpm0 driver transport
+ *	@details	Opens the configured TPM device and stores its file descriptor in the transport state.
+ *
+ *	@param		PpState		Transport state
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from DeviceAccessTpmDriver_Initialize
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_DriverInitialize(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	unsigned int unReturnValue = DeviceAccessTpmDriver_Initialize(&PpState->nFileHandle);
+	if (RC_SUCCESS != unReturnValue)
+		LOGGING_WRITE_LEVEL1_FMT(L"Error initializing LowLevelIO: 0x%.8X", unReturnValue);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Uninitialize the /dev/tpm0 driver transport
+ *	@details	Closes the TPM device.
+ *
+ *	@param		PpState		Transport state
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from DeviceAccessTpmDriver_Uninitialize
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_DriverUninitialize(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	unsigned int unReturnValue = DeviceAccessTpmDriver_Uninitialize(PpState->nFileHandle);
+	PpState->nFileHandle = -1;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Transmit a TPM command through the /dev/tpm0 driver transport
+ *	@details	The command is retried with growing intervals in case the TPM is not responsive. A command which did not
+ *				complete within its maximum duration is not retried. If retries are disabled with
+ *				TPMIO_SetRetry, the command is transmitted once and a failure is only logged on level 4.
+ *
+ *	@param		PpState					Transport state
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from DeviceAccessTpmDriver_Transmit
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_DriverTransmit(
+	_Inout_										IfxTpmTransportState*	PpState,
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*				PrgbRequestBuffer,
+	_In_										unsigned int			PunRequestBufferSize,
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*					PrgbResponseBuffer,
+	_Inout_										unsigned int*			PpunResponseBufferSize,
+	_In_										unsigned int			PunMaxDuration)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	IfxPoll sPoll;
+
+	Polling_Start(&sPoll, POLLING_WAIT_TRANSMIT_RETRY, TPM_FU_RETRY_TIMEOUT * 1000);
+	do
+	{
+		unReturnValue = DeviceAccessTpmDriver_Transmit(
+							PpState->nFileHandle,
+							PrgbRequestBuffer,
+							(UINT16)PunRequestBufferSize,
+							PrgbResponseBuffer,
+							PpunResponseBufferSize,
+							PunMaxDuration,
+							!PpState->fNoRetry);
+		if (RC_SUCCESS == unReturnValue || RC_E_TPM_NO_DATA_AVAILABLE == unReturnValue)
+			break;
+		if (PpState->fNoRetry)
+		{
+			LOGGING_WRITE_LEVEL4_FMT(L"TPM communication failed with (0x%.8x), not retrying.", unReturnValue);
+			break;
+		}
+
+		// Retry with growing intervals in case TPM is not responsive
+		LOGGING_WRITE_LEVEL1_FMT(L"Error: TPM communication failed with (0x%.8x).", unReturnValue);
+		LOGGING_WRITE_LEVEL1_FMT(L"TPM might not be ready at the moment (Count:%d)", sPoll.unPolls);
+	}
+	while (TRUE == Polling_Wait(&sPoll));
+	Polling_Finish(&sPoll);
+
+	if (RC_SUCCESS != unReturnValue && !PpState->fNoRetry)
+		LOGGING_WRITE_LEVEL1(L"Transmission of data via /dev/tpm0 failed!");
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Send the pending TPM command through the /dev/tpm0 driver transport
+ *	@details	Writes the command to the device without waiting for the response. A failed write is only logged;
+ *				TPMIO_DriverReceive transmits the command again with the retries of TPMIO_DriverTransmit in this case.
+ *
+ *	@param		PpState					Transport state
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_DriverSend(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	unsigned int unReturnValue = DeviceAccessTpmDriver_Send(PpState->nFileHandle, PpState->pbPendingRequest, PpState->unPendingRequestSize, !PpState->fNoRetry);
+	if (RC_SUCCESS == unReturnValue)
+		PpState->fPendingRequestSent = TRUE;
+	else
+		LOGGING_WRITE_LEVEL1_FMT(L"Error: TPM communication failed with (0x%.8x).", unReturnValue);
+
+	return RC_SUCCESS;
+}
+
+/**
+ *	@brief		Receive the response of the pending TPM command through the /dev/tpm0 driver transport
+ *	@details	Waits for the response until the maximum duration of the command has elapsed and reads it from the device.
+ *				If the command could not be written or the response could not be read, the command is transmitted again
+ *				with the retries of TPMIO_DriverTransmit. A timed out command is not transmitted again.
+ *
+ *	@param		PpState					Transport state
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from DeviceAccessTpmDriver_Receive and TPMIO_DriverTransmit
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_DriverReceive(
+	_Inout_									IfxTpmTransportState*	PpState,
+	_Out_bytecap_(*PpunResponseBufferSize)	BYTE*					PrgbResponseBuffer,
+	_Inout_									unsigned int*			PpunResponseBufferSize,
+	_In_									unsigned int			PunMaxDuration)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned int unResponseBufferSize = *PpunResponseBufferSize;
+
+	if (PpState->fPendingRequestSent)
+	{
+		unReturnValue = DeviceAccessTpmDriver_Receive(PpState->nFileHandle, PrgbResponseBuffer, PpunResponseBufferSize, PunMaxDuration);
+		if (RC_SUCCESS != unReturnValue)
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: TPM communication failed with (0x%.8x).", unReturnValue);
+	}
+
+	if (RC_SUCCESS != unReturnValue && RC_E_TPM_NO_DATA_AVAILABLE != unReturnValue)
+	{
+		*PpunResponseBufferSize = unResponseBufferSize;
+		unReturnValue = TPMIO_DriverTransmit(
+							PpState,
+							PpState->pbPendingRequest,
+							PpState->unPendingRequestSize,
+							PrgbResponseBuffer,
+							PpunResponseBufferSize,
+							PunMaxDuration);
+	}
+
+	return unReturnValue;
+}
+
+#if !(defined (__aarch64__) || defined (__arm__))
+/**
+ *	@brief		Initialize the memory based transport
+ *	@details	Maps the TPM register space for the configured locality and checks the presence of a TPM.
+ *
+ *	@param		PpState		Transport state
+ *
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		RC_E_FAIL		The locality could not be retrieved.
+ *	@retval		RC_E_NOT_READY	TPM.ACCESS is not valid.
+ *	@retval		...				Error codes from DeviceAccess_Initialize and TIS
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_MemoryBasedInitialize(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		unsigned int unLocality = 0;
+		BOOL bFlag = FALSE;
+
+		// Get the selected locality for TPM access
+		if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOCALITY, &unLocality))
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+		PpState->bLocality = (BYTE)unLocality;
+
+		unReturnValue = DeviceAccess_Initialize(PpState->bLocality);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Error initializing LowLevelIO: 0x%.8X", unReturnValue);
+			break;
+		}
+
+		LOGGING_WRITE_LEVEL4_FMT(L"Using Locality: %d", PpState->bLocality);
+
+		// Check the presence of a TPM first
+		// Check whether TPM.ACCESS.VALID
+		unReturnValue = TIS_IsAccessValid(PpState->bLocality, &bFlag);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			LOGGING_WRITE_LEVEL1_FMT(L"Error TIS access is not valid: 0x%.8X", unReturnValue);
+			break;
+		}
+
+		if (!bFlag)
+		{
+			unReturnValue = RC_E_NOT_READY;
+			LOGGING_WRITE_LEVEL1_FMT(L"Error TIS is not ready: 0x%.8X", unReturnValue);
+			break;
+		}
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Uninitialize the memory based transport
+ *	@details	Unmaps the TPM register space.
+ *
+ *	@param		PpState		Transport state
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from DeviceAccess_Uninitialize
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_MemoryBasedUninitialize(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	return DeviceAccess_Uninitialize(PpState->bLocality);
+}
+
+/**
+ *	@brief		Transmit a TPM command through the memory based transport
+ *	@details	The command is transmitted using the TIS protocol.
+ *
+ *	@param		PpState					Transport state
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from TIS_TransceiveLPC
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_MemoryBasedTransmit(
+	_Inout_										IfxTpmTransportState*	PpState,
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*				PrgbRequestBuffer,
+	_In_										unsigned int			PunRequestBufferSize,
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*					PrgbResponseBuffer,
+	_Inout_										unsigned int*			PpunResponseBufferSize,
+	_In_										unsigned int			PunMaxDuration)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	UINT16 usResponseBufferSize = (*PpunResponseBufferSize > 0xFFFF) ? 0xFFFF : (UINT16)*PpunResponseBufferSize;
+
+	unReturnValue = TIS_TransceiveLPC(
+						PpState->bLocality,
+						PrgbRequestBuffer,
+						(UINT16)PunRequestBufferSize,
+						PrgbResponseBuffer,
+						&usResponseBufferSize,
+						PunMaxDuration);
+	*PpunResponseBufferSize = usResponseBufferSize;
+
+	if (RC_SUCCESS != unReturnValue)
+		LOGGING_WRITE_LEVEL1(L"Transmission of data via TIS failed!");
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Send the pending TPM command through the memory based transport
+ *	@details	Writes the command to the TIS FIFO and sets TPM.STS.tpmGo without waiting for the response.
+ *
+ *	@param		PpState					Transport state
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from TIS_SendLPC
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_MemoryBasedSend(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	unsigned int unReturnValue = TIS_SendLPC(PpState->bLocality, PpState->pbPendingRequest, (UINT16)PpState->unPendingRequestSize);
+	if (RC_SUCCESS == unReturnValue)
+		PpState->fPendingRequestSent = TRUE;
+	else
+		LOGGING_WRITE_LEVEL1(L"Transmission of data via TIS failed!");
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Receive the response of the pending TPM command through the memory based transport
+ *	@details
+ *
+ *	@param		PpState					Transport state
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from TIS_ReceiveLPC
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_MemoryBasedReceive(
+	_Inout_									IfxTpmTransportState*	PpState,
+	_Out_bytecap_(*PpunResponseBufferSize)	BYTE*					PrgbResponseBuffer,
+	_Inout_									unsigned int*			PpunResponseBufferSize,
+	_In_									unsigned int			PunMaxDuration)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	UINT16 usResponseBufferSize = (*PpunResponseBufferSize > 0xFFFF) ? 0xFFFF : (UINT16)*PpunResponseBufferSize;
+
+	unReturnValue = TIS_ReceiveLPC(PpState->bLocality, PrgbResponseBuffer, &usResponseBufferSize, PunMaxDuration);
+	*PpunResponseBufferSize = usResponseBufferSize;
+
+	if (RC_SUCCESS != unReturnValue)
+		LOGGING_WRITE_LEVEL1(L"Transmission of data via TIS failed!");
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Read a byte from a register through the memory based transport
+ *	@details
+ *
+ *	@param		PpState					Transport state
+ *	@param		PunRegisterAddress		Register address
+ *	@param		PpbRegisterValue		Pointer to a byte to store the register value
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_MemoryBasedReadRegister(
+	_Inout_	IfxTpmTransportState*	PpState,
+	_In_	unsigned int			PunRegisterAddress,
+	_Out_	BYTE*					PpbRegisterValue)
+{
+	UNREFERENCED_PARAMETER(PpState);
+
+	// Read byte from register address
+	*PpbRegisterValue = DeviceAccess_ReadByte(PunRegisterAddress);
+
+	return RC_SUCCESS;
+}
+
+/**
+ *	@brief		Write a byte to a register through the memory based transport
+ *	@details
+ *
+ *	@param		PpState					Transport state
+ *	@param		PunRegisterAddress		Register address
+ *	@param		PbRegisterValue			Byte to write to the register address
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ */
+_Check_return_
+static
+unsigned int
+TPMIO_MemoryBasedWriteRegister(
+	_Inout_	IfxTpmTransportState*	PpState,
+	_In_	unsigned int			PunRegisterAddress,
+	_In_	BYTE					PbRegisterValue)
+{
+	UNREFERENCED_PARAMETER(PpState);
+
+	// Write byte to register address
+	DeviceAccess_WriteByte(PunRegisterAddress, PbRegisterValue);
+
+	return RC_SUCCESS;
+}
+
+/// Memory based transport using the TIS protocol
+static const IfxTpmTransport s_sTransportMemoryBased =
+{
+	TPM_DEVICE_ACCESS_MEMORY_BASED,
+	L"memory access routines",
+	&TPMIO_MemoryBasedInitialize,
+	&TPMIO_MemoryBasedUninitialize,
+	&TPMIO_MemoryBasedTransmit,
+	&TPMIO_MemoryBasedReadRegister,
+	&TPMIO_MemoryBasedWriteRegister,
+	&TPMIO_MemoryBasedSend,
+	&TPMIO_MemoryBasedReceive
+};
+#endif
+
+/// Transport using the /dev/tpm0 driver (register access is not supported)
+static const IfxTpmTransport s_sTransportDriver =
+{
+	TPM_DEVICE_ACCESS_DRIVER,
+	L"/dev/tpm0 driver",
+	&TPMIO_DriverInitialize,
+	&TPMIO_DriverUninitialize,
+	&TPMIO_DriverTransmit,
+	NULL,
+	NULL,
+	&TPMIO_DriverSend,
+	&TPMIO_DriverReceive
+};
+
+/// Registered transports (unused entries are NULL)
+static const IfxTpmTransport* s_rgpTransports[TPMIO_MAX_TRANSPORTS] =
+{
+	&s_sTransportDriver,
+#if !(defined (__aarch64__) || defined (__arm__))
+	&s_sTransportMemoryBased,
+#endif
+};
+
+/// Transport selected in TPMIO_Connect (NULL if not connected)
+static const IfxTpmTransport* s_pTransport = NULL;
+
+/// State of the selected transport
+static IfxTpmTransportState s_sTransportState = { -1, 0, NULL, NULL, 0, FALSE, FALSE };
+
+/**
+ *	@brief		Register a transport
+ *	@details	The transport is used by TPMIO_Connect if its device access mode is configured. A transport registered
+ *				for an already registered device access mode replaces the former one. Must not be called while connected.
+ *
+ *	@param		PpTransport				Pointer to the transport to register; must stay valid for the program execution
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_ALREADY_CONNECTED	If TPM I/O is connected
+ *	@retval		RC_E_BUFFER_TOO_SMALL	If TPMIO_MAX_TRANSPORTS transports are already registered
+ */
+_Check_return_
+unsigned int
+TPMIO_RegisterTransport(
+	_In_	const IfxTpmTransport*	PpTransport)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		unsigned int unIndex = 0;
+
+		// Check parameters
+		if (NULL == PpTransport ||
+				NULL == PpTransport->wszName ||
+				NULL == PpTransport->pfnInitialize ||
+				NULL == PpTransport->pfnUninitialize ||
+				NULL == PpTransport->pfnTransmit ||
+				(NULL == PpTransport->pfnSend) != (NULL == PpTransport->pfnReceive))
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		// The transport must not be changed while connected
+		if (NULL != s_pTransport)
+		{
+			unReturnValue = RC_E_ALREADY_CONNECTED;
+			break;
+		}
+
+		// Replace the transport for the same device access mode or use the first free entry
+		unReturnValue = RC_E_BUFFER_TOO_SMALL;
+		for (unIndex = 0; unIndex < TPMIO_MAX_TRANSPORTS; unIndex++)
+		{
+			if (NULL == s_rgpTransports[unIndex] ||
+					s_rgpTransports[unIndex]->unDeviceAccessMode == PpTransport->unDeviceAccessMode)
+			{
+				s_rgpTransports[unIndex] = PpTransport;
+				unReturnValue = RC_SUCCESS;
+				break;
+			}
+		}
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
 /**
  *	@brief		TPM connect function
- *	@details	This function handles the connect to the underlying TPM.
+ *	@details	This function handles the connect to the underlying TPM. The transport for the configured device
+ *				access mode is selected once here; all further calls are dispatched through it.
  *
  *	@retval		RC_SUCCESS					The operation completed successfully.
  *	@retval		RC_E_ALREADY_CONNECTED		If TPM I/O is already connected
  *	@retval		RC_E_COMPONENT_NOT_FOUND	No IFX TPM found
+ *	@retval		RC_E_INVALID_SETTING		No transport is registered for the configured device access mode
  *	@retval		...							Error codes from DeviceAccess_Initialize and TIS
  */
 _Check_return_
@@ -51,6 +565,9 @@ TPMIO_Connect()
 	do
 	{
 		UINT32 unTpmDeviceAccessModeCfg = 0;
+		const IfxTpmTransport* pTransport = NULL;
+		unsigned int unIndex = 0;
+
 		if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_TPM_DEVICE_ACCESS_MODE, &unTpmDeviceAccessModeCfg))
 		{
 			unReturnValue = RC_E_INTERNAL;
@@ -59,87 +576,39 @@ TPMIO_Connect()
 		}
 
 		// Check if already connected
-		if (FALSE != g_fConnected)
+		if (NULL != s_pTransport)
 		{
 			unReturnValue = RC_E_ALREADY_CONNECTED;
 			break;
 		}
 
-		// Try to connect to the TPM and check return code
-		LOGGING_WRITE_LEVEL4(L"Connecting to TPM...");
-
-		switch (unTpmDeviceAccessModeCfg)
+		// Select the transport for the configured device access mode
+		for (unIndex = 0; unIndex < TPMIO_MAX_TRANSPORTS && NULL != s_rgpTransports[unIndex]; unIndex++)
 		{
-			case TPM_DEVICE_ACCESS_DRIVER:
-			{
-				unReturnValue = DeviceAccessTpmDriver_Initialize();
-				if (RC_SUCCESS != unReturnValue)
-				{
-					LOGGING_WRITE_LEVEL1_FMT(L"Error initializing LowLevelIO: 0x%.8X", unReturnValue);
-					break;
-				}
-
-				LOGGING_WRITE_LEVEL4(L"Using /dev/tpm0 driver");
-
-				break;
-			}
-
-			case TPM_DEVICE_ACCESS_MEMORY_BASED:
-#if !(defined (__aarch64__) || defined (__arm__))
-			{
-				unsigned int unLocality = 0;
-				BOOL bFlag = FALSE;
-
-				// Check if already connected
-				if (FALSE != g_fConnected)
-				{
-					unReturnValue = RC_E_ALREADY_CONNECTED;
-					break;
-				}
-
-				// Get the selected locality for TPM access
-				if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOCALITY, &unLocality))
-				{
-					unReturnValue = RC_E_FAIL;
-					break;
-				}
-
-				unReturnValue = DeviceAccess_Initialize((BYTE)unLocality);
-				if (RC_SUCCESS != unReturnValue)
-				{
-					LOGGING_WRITE_LEVEL1_FMT(L"Error initializing LowLevelIO: 0x%.8X", unReturnValue);
-					break;
-				}
-
-				LOGGING_WRITE_LEVEL4(L"Using memory access routines");
-				LOGGING_WRITE_LEVEL4_FMT(L"Using Locality: %d", unLocality);
-
-				// Check the presence of a TPM first
-				// Check whether TPM.ACCESS.VALID
-				unReturnValue = TIS_IsAccessValid((BYTE)unLocality, &bFlag);
-				if (RC_SUCCESS != unReturnValue)
-				{
-					LOGGING_WRITE_LEVEL1_FMT(L"Error TIS access is not valid: 0x%.8X", unReturnValue);
-					break;
-				}
-
-				if (!bFlag)
-				{
-					unReturnValue = RC_E_NOT_READY;
-					LOGGING_WRITE_LEVEL1_FMT(L"Error TIS is not ready: 0x%.8X", unReturnValue);
-					break;
-				}
-				break;
-			}
-#endif
-			default:
+			if (s_rgpTransports[unIndex]->unDeviceAccessMode == unTpmDeviceAccessModeCfg)
 			{
-				unReturnValue = RC_E_INVALID_SETTING;
-				LOGGING_WRITE_LEVEL1_FMT(L"Error: An Unknown or unsupported device access routine is configured (0x%.8x).", unReturnValue);
+				pTransport = s_rgpTransports[unIndex];
 				break;
 			}
 		}
+		if (NULL == pTransport)
+		{
+			unReturnValue = RC_E_INVALID_SETTING;
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: An Unknown or unsupported device access routine is configured (0x%.8x).", unReturnValue);
+			break;
+		}
 
+		// Try to connect to the TPM and check return code
+		LOGGING_WRITE_LEVEL4(L"Connecting to TPM...");
+		LOGGING_WRITE_LEVEL4_FMT(L"Using %ls", pTransport->wszName);
+
+		s_sTransportState.nFileHandle = -1;
+		s_sTransportState.bLocality = 0;
+		s_sTransportState.pvContext = NULL;
+		s_sTransportState.pbPendingRequest = NULL;
+		s_sTransportState.unPendingRequestSize = 0;
+		s_sTransportState.fPendingRequestSent = FALSE;
+		unReturnValue = pTransport->pfnInitialize(&s_sTransportState);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
@@ -159,7 +628,7 @@ TPMIO_Connect()
 
 		LOGGING_WRITE_LEVEL4(L"Connected to TPM");
 
-		g_fConnected = TRUE;
+		s_pTransport = pTransport;
 	}
 	WHILE_FALSE_END;
 
@@ -186,59 +655,25 @@ TPMIO_Disconnect()
 
 	do
 	{
-		UINT32 unTpmDeviceAccessModeCfg = 0;
-
 		// Check if connected to the TPM
-		if (FALSE == g_fConnected)
+		if (NULL == s_pTransport)
 		{
 			unReturnValue = RC_E_NOT_CONNECTED;
 			break;
 		}
 
-		if (!(	PropertyStorage_GetUIntegerValueByKey(PROPERTY_TPM_DEVICE_ACCESS_MODE, &unTpmDeviceAccessModeCfg) &&
-				(TPM_DEVICE_ACCESS_MEMORY_BASED == unTpmDeviceAccessModeCfg ||
-				 TPM_DEVICE_ACCESS_DRIVER == unTpmDeviceAccessModeCfg)))
-		{
-			unReturnValue = RC_E_INTERNAL;
-			LOGGING_WRITE_LEVEL1_FMT(L"Error: Retrieving device handle failed (%.8x).", unReturnValue);
-			break;
-		}
+		// Dump the wait statistics collected during this connection
+		Polling_LogStatistics();
 
 		// Try to disconnect the TPM and check return code
 		LOGGING_WRITE_LEVEL4(L"Disconnecting from TPM...");
 
-		switch (unTpmDeviceAccessModeCfg)
-		{
-			case TPM_DEVICE_ACCESS_MEMORY_BASED:
-			{
-				unsigned int unLocality = 0;
-
-				// Check if a startup is required
-				if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOCALITY, &unLocality))
-				{
-					unReturnValue = RC_E_FAIL;
-					break;
-				}
-				unReturnValue = DeviceAccess_Uninitialize((BYTE)unLocality);
-				if (RC_SUCCESS != unReturnValue)
-					break;
+		// Drop a command whose response has not been received
+		s_sTransportState.pbPendingRequest = NULL;
 
-				break;
-			}
-			case TPM_DEVICE_ACCESS_DRIVER:
-			{
-				unReturnValue = DeviceAccessTpmDriver_Uninitialize();
-				break;
-			}
-			default:
-			{
-				unReturnValue = RC_E_INTERNAL;
-				LOGGING_WRITE_LEVEL1_FMT(L"Error: Unknown device access mode configured (0x%.8x).", unReturnValue);
-				break;
-			}
-		}
+		unReturnValue = s_pTransport->pfnUninitialize(&s_sTransportState);
 
-		g_fConnected = FALSE;
+		s_pTransport = NULL;
 	}
 	WHILE_FALSE_END;
 
@@ -255,7 +690,7 @@ TPMIO_Disconnect()
  *	@param		PunRequestBufferSize	Size of command request in bytes
  *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
  *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
- *	@param		PunMaxDuration			The maximum duration of the command in microseconds (relevant for memory based access / TIS protocol only)
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds (deadline of the TIS protocol and of the /dev/tpm0 driver transport)
  *
  *	@retval		RC_SUCCESS				The operation completed successfully.
  *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
@@ -277,8 +712,6 @@ TPMIO_Transmit(
 
 	do
 	{
-		UINT32 unTpmDeviceAccessModeCfg = 0;
-
 		// Check parameters
 		if (NULL == PrgbRequestBuffer || NULL == PrgbResponseBuffer || NULL == PpunResponseBufferSize)
 		{
@@ -286,83 +719,159 @@ TPMIO_Transmit(
 			break;
 		}
 		// Check if connected to the TPM
-		if (FALSE == g_fConnected)
+		if (NULL == s_pTransport)
 		{
 			unReturnValue = RC_E_NOT_CONNECTED;
 			break;
 		}
 
-		if (!(	PropertyStorage_GetUIntegerValueByKey(PROPERTY_TPM_DEVICE_ACCESS_MODE, &unTpmDeviceAccessModeCfg) &&
-				(TPM_DEVICE_ACCESS_MEMORY_BASED == unTpmDeviceAccessModeCfg ||
-				 TPM_DEVICE_ACCESS_DRIVER == unTpmDeviceAccessModeCfg)))
+		unReturnValue = s_pTransport->pfnTransmit(
+							&s_sTransportState,
+							PrgbRequestBuffer,
+							PunRequestBufferSize,
+							PrgbResponseBuffer,
+							PpunResponseBufferSize,
+							PunMaxDuration);
+	}
+	WHILE_FALSE_END;
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		TPM send function
+ *	@details	This function submits the TPM command to the underlying TPM without waiting for the response. The caller can
+ *				do other work while the TPM executes the command and must call TPMIO_Receive afterwards. The request buffer is
+ *				used without copying and must stay valid until TPMIO_Receive returns. If the transport cannot send a command
+ *				without waiting, the command is transmitted in TPMIO_Receive.
+ *
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_NOT_CONNECTED		If the TPM I/O is not connected to the TPM
+ *	@retval		RC_E_FAIL				The response of the former command has not been received yet.
+ *	@retval		...						Error codes from the transport
+ */
+_Check_return_
+unsigned int
+TPMIO_Send(
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*		PrgbRequestBuffer,
+	_In_										unsigned int	PunRequestBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		// Check parameters
+		if (NULL == PrgbRequestBuffer || 0 == PunRequestBufferSize)
 		{
-			unReturnValue = RC_E_INTERNAL;
-			LOGGING_WRITE_LEVEL1_FMT(L"Error: Retrieving device handle failed (%.8x).", unReturnValue);
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		// Check if connected to the TPM
+		if (NULL == s_pTransport)
+		{
+			unReturnValue = RC_E_NOT_CONNECTED;
+			break;
+		}
+		// Only one command can be pending
+		if (NULL != s_sTransportState.pbPendingRequest)
+		{
+			unReturnValue = RC_E_FAIL;
 			break;
 		}
 
-		switch (unTpmDeviceAccessModeCfg)
+		s_sTransportState.pbPendingRequest = PrgbRequestBuffer;
+		s_sTransportState.unPendingRequestSize = PunRequestBufferSize;
+		s_sTransportState.fPendingRequestSent = FALSE;
+
+		// Without pfnSend the command is transmitted in TPMIO_Receive
+		unReturnValue = RC_SUCCESS;
+		if (NULL != s_pTransport->pfnSend)
 		{
-			case TPM_DEVICE_ACCESS_MEMORY_BASED:
-			{
-				unsigned int unLocality = 0;
-				// Check if a startup is required
-				if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOCALITY, &unLocality))
-				{
-					unReturnValue = RC_E_FAIL;
-					break;
-				}
-
-				unReturnValue = TIS_TransceiveLPC(
-									(BYTE)unLocality,
-									PrgbRequestBuffer,
-									(UINT16)PunRequestBufferSize,
-									PrgbResponseBuffer,
-									(UINT16*)PpunResponseBufferSize,
-									PunMaxDuration);
-
-				if (RC_SUCCESS != unReturnValue)
-					LOGGING_WRITE_LEVEL1(L"Transmission of data via TIS failed!");
+			unReturnValue = s_pTransport->pfnSend(&s_sTransportState);
+			if (RC_SUCCESS != unReturnValue)
+				s_sTransportState.pbPendingRequest = NULL;
+		}
+	}
+	WHILE_FALSE_END;
 
-				break;
-			}
-			case TPM_DEVICE_ACCESS_DRIVER:
-			{
-				unsigned int unRetryCounter = 0;
-
-				for (unRetryCounter = 0; unRetryCounter < TPM_FU_MAX_RETRIES; unRetryCounter++)
-				{
-					unReturnValue = DeviceAccessTpmDriver_Transmit(
-										PrgbRequestBuffer,
-										(UINT16)PunRequestBufferSize,
-										PrgbResponseBuffer,
-										PpunResponseBufferSize);
-					// Retry after some time in case TPM is not responsive
-					if (RC_SUCCESS != unReturnValue)
-					{
-						LOGGING_WRITE_LEVEL1_FMT(L"Error: TPM communication failed with (0x%.8x).", unReturnValue);
-						LOGGING_WRITE_LEVEL1_FMT(L"TPM might not be ready at the moment (Count:%d)", unRetryCounter);
-						Platform_Sleep(TPM_FU_RETRY_WAIT_TIME);
-						continue;
-					}
-					else
-					{
-						break;
-					}
-				}
-
-				if (RC_SUCCESS != unReturnValue)
-					LOGGING_WRITE_LEVEL1(L"Transmission of data via /dev/tpm0 failed!");
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
 
-				break;
-			}
-			default:
-			{
-				unReturnValue = RC_E_INTERNAL;
-				LOGGING_WRITE_LEVEL1_FMT(L"Error: Unknown device access mode configured (0x%.8x).", unReturnValue);
-				break;
-			}
+	return unReturnValue;
+}
+
+/**
+ *	@brief		TPM receive function
+ *	@details	This function waits for the response of the TPM command submitted with TPMIO_Send.
+ *
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds (deadline of the TIS protocol and of the /dev/tpm0 driver transport)
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_NOT_CONNECTED		If the TPM I/O is not connected to the TPM
+ *	@retval		RC_E_FAIL				No command has been submitted with TPMIO_Send.
+ *	@retval		...						Error codes from the transport
+ */
+_Check_return_
+unsigned int
+TPMIO_Receive(
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
+	_Inout_										unsigned int*	PpunResponseBufferSize,
+	_In_										unsigned int	PunMaxDuration)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		// Check parameters
+		if (NULL == PrgbResponseBuffer || NULL == PpunResponseBufferSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		// Check if connected to the TPM
+		if (NULL == s_pTransport)
+		{
+			unReturnValue = RC_E_NOT_CONNECTED;
+			break;
+		}
+		// Check if a command has been sent
+		if (NULL == s_sTransportState.pbPendingRequest)
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+
+		if (NULL != s_pTransport->pfnReceive)
+		{
+			unReturnValue = s_pTransport->pfnReceive(
+								&s_sTransportState,
+								PrgbResponseBuffer,
+								PpunResponseBufferSize,
+								PunMaxDuration);
+		}
+		else
+		{
+			unReturnValue = s_pTransport->pfnTransmit(
+								&s_sTransportState,
+								s_sTransportState.pbPendingRequest,
+								s_sTransportState.unPendingRequestSize,
+								PrgbResponseBuffer,
+								PpunResponseBufferSize,
+								PunMaxDuration);
 		}
+		s_sTransportState.pbPendingRequest = NULL;
 	}
 	WHILE_FALSE_END;
 
@@ -380,6 +889,8 @@ TPMIO_Transmit(
  *
  *	@retval		RC_SUCCESS				The operation completed successfully.
  *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_NOT_CONNECTED		If the TPM I/O is not connected to the TPM
+ *	@retval		RC_E_NOT_SUPPORTED_FEATURE	If the transport does not support register access
  *	@retval		...						Error codes from called functions
  */
 _Check_return_
@@ -394,8 +905,6 @@ TPMIO_ReadRegister(
 
 	do
 	{
-		UINT32 unTpmDeviceAccessModeCfg = 0;
-
 		// Check parameters
 		if (NULL == PpbRegisterValue)
 		{
@@ -403,38 +912,22 @@ TPMIO_ReadRegister(
 			break;
 		}
 
-		if (!(	PropertyStorage_GetUIntegerValueByKey(PROPERTY_TPM_DEVICE_ACCESS_MODE, &unTpmDeviceAccessModeCfg) &&
-				(TPM_DEVICE_ACCESS_MEMORY_BASED == unTpmDeviceAccessModeCfg ||
-				 TPM_DEVICE_ACCESS_DRIVER == unTpmDeviceAccessModeCfg)))
+		// Check if connected to the TPM
+		if (NULL == s_pTransport)
 		{
-			unReturnValue = RC_E_INTERNAL;
-			LOGGING_WRITE_LEVEL1_FMT(L"Error: Retrieving device handle failed (%.8x).", unReturnValue);
+			unReturnValue = RC_E_NOT_CONNECTED;
 			break;
 		}
 
-		switch (unTpmDeviceAccessModeCfg)
+		if (NULL == s_pTransport->pfnReadRegister)
 		{
-			case TPM_DEVICE_ACCESS_MEMORY_BASED:
-			{
-				// Read byte from register address
-				*PpbRegisterValue = DeviceAccess_ReadByte(PunRegisterAddress);
-				unReturnValue = RC_SUCCESS;
-				break;
-			}
-			case TPM_DEVICE_ACCESS_DRIVER:
-			{
-				*PpbRegisterValue = 0;
-				unReturnValue = RC_E_NOT_SUPPORTED_FEATURE;
-				LOGGING_WRITE_LEVEL1_FMT(L"Error: Read/Write register is not supported while using the /dev/tpm0 driver (0x%.8x).", unReturnValue);
-				break;
-			}
-			default:
-			{
-				unReturnValue = RC_E_INTERNAL;
-				LOGGING_WRITE_LEVEL1_FMT(L"Error: Unknown device access routine configured (0x%.8x).", unReturnValue);
-				break;
-			}
+			*PpbRegisterValue = 0;
+			unReturnValue = RC_E_NOT_SUPPORTED_FEATURE;
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: Read/Write register is not supported while using the %ls (0x%.8x).", s_pTransport->wszName, unReturnValue);
+			break;
 		}
+
+		unReturnValue = s_pTransport->pfnReadRegister(&s_sTransportState, PunRegisterAddress, PpbRegisterValue);
 	}
 	WHILE_FALSE_END;
 
@@ -451,6 +944,8 @@ TPMIO_ReadRegister(
  *	@param		PbRegisterValue			Byte to write to the register address
  *
  *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_NOT_CONNECTED		If the TPM I/O is not connected to the TPM
+ *	@retval		RC_E_NOT_SUPPORTED_FEATURE	If the transport does not support register access
  *	@retval		...						Error codes from called functions
  */
 _Check_return_
@@ -465,39 +960,21 @@ TPMIO_WriteRegister(
 
 	do
 	{
-		UINT32 unTpmDeviceAccessModeCfg = 0;
-
-		if (!(	PropertyStorage_GetUIntegerValueByKey(PROPERTY_TPM_DEVICE_ACCESS_MODE, &unTpmDeviceAccessModeCfg) &&
-				(TPM_DEVICE_ACCESS_MEMORY_BASED == unTpmDeviceAccessModeCfg ||
-				 TPM_DEVICE_ACCESS_DRIVER == unTpmDeviceAccessModeCfg)))
+		// Check if connected to the TPM
+		if (NULL == s_pTransport)
 		{
-			unReturnValue = RC_E_INTERNAL;
-			LOGGING_WRITE_LEVEL1_FMT(L"Error: Retrieving device handle failed (%.8x).", unReturnValue);
+			unReturnValue = RC_E_NOT_CONNECTED;
 			break;
 		}
 
-		switch (unTpmDeviceAccessModeCfg)
+		if (NULL == s_pTransport->pfnWriteRegister)
 		{
-			case TPM_DEVICE_ACCESS_MEMORY_BASED:
-			{
-				// Write byte to register address
-				DeviceAccess_WriteByte(PunRegisterAddress, PbRegisterValue);
-				unReturnValue = RC_SUCCESS;
-				break;
-			}
-			case TPM_DEVICE_ACCESS_DRIVER:
-			{
-				unReturnValue = RC_E_NOT_SUPPORTED_FEATURE;
-				LOGGING_WRITE_LEVEL1_FMT(L"Error: Read/Write register feature is not supported while using the /dev/tpm0 driver (0x%.8x).", unReturnValue);
-				break;
-			}
-			default:
-			{
-				unReturnValue = RC_E_INTERNAL;
-				LOGGING_WRITE_LEVEL1_FMT(L"Error: Unknown device access routine configured (0x%.8x).", unReturnValue);
-				break;
-			}
+			unReturnValue = RC_E_NOT_SUPPORTED_FEATURE;
+			LOGGING_WRITE_LEVEL1_FMT(L"Error: Read/Write register feature is not supported while using the %ls (0x%.8x).", s_pTransport->wszName, unReturnValue);
+			break;
 		}
+
+		unReturnValue = s_pTransport->pfnWriteRegister(&s_sTransportState, PunRegisterAddress, PbRegisterValue);
 	}
 	WHILE_FALSE_END;
 
@@ -505,3 +982,17 @@ TPMIO_WriteRegister(
 
 	return unReturnValue;
 }
+
+/**
+ *	@brief		Enable or disable transport level retries
+ *	@details	By default a transport retries a command which failed on transport level, e.g. while the TPM restarts.
+ *				Readiness probes disable the retries so that each probe returns within the deadline of the caller.
+ *
+ *	@param		PfRetry					TRUE to retry failed commands, FALSE to transmit each command once
+ */
+void
+TPMIO_SetRetry(
+	_In_		BOOL				PfRetry)
+{
+	s_sTransportState.fNoRetry = !PfRetry;
+}
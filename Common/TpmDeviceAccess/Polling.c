@@ -0,0 +1,302 @@
+﻿/**
+ *	@brief		Implements the polling strategy functions used to wait for TPM state transitions
+ *	@details
+ *	@file		TpmDeviceAccess/Polling.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Polling.h"
+#include "Platform.h"
+#include "Logging.h"
+
+/**
+ *	@brief		Polling strategies per wait type
+ *	@details	Most TIS state transitions complete within a few microseconds on memory based access. Thus these
+ *				strategies spin shortly before they fall back to sleeping. Waits for whole TPM commands or TPM mode
+ *				changes take milliseconds to seconds and start sleeping right away. The TPM driver reports EBUSY only
+ *				until the response of the previous command has been collected, so its retries stay below a millisecond.
+ */
+static const IfxPollingStrategy s_rgsStrategies[POLLING_WAIT_TYPE_COUNT] =
+{
+	// POLLING_WAIT_LOCALITY
+	{50, 10, 1000},
+	// POLLING_WAIT_COMMAND_READY
+	{50, 10, 1000},
+	// POLLING_WAIT_BURST_COUNT
+	{100, 10, 500},
+	// POLLING_WAIT_STS_VALID
+	{50, 10, 1000},
+	// POLLING_WAIT_DATA_AVAILABLE
+	{20, 50, 2000},
+	// POLLING_WAIT_TRANSMIT_RETRY
+	{0, 1000, 250000},
+	// POLLING_WAIT_BOOT_LOADER_MODE
+	{0, 10000, 250000},
+	// POLLING_WAIT_FIRMWARE_READY
+	{0, 10000, 250000},
+	// POLLING_WAIT_DRIVER_BUSY
+	{0, 100, 800}
+};
+
+/**
+ *	@brief		Polling statistics per wait type
+ */
+static IfxPollingStatistics s_rgsStatistics[POLLING_WAIT_TYPE_COUNT];
+
+/**
+ *	@brief		Names of the wait types for logging purposes
+ */
+static const wchar_t* s_rgwszWaitTypeNames[POLLING_WAIT_TYPE_COUNT] =
+{
+	L"Locality",
+	L"CommandReady",
+	L"BurstCount",
+	L"StsValid",
+	L"DataAvailable",
+	L"TransmitRetry",
+	L"BootLoaderMode",
+	L"FirmwareReady",
+	L"DriverBusy"
+};
+
+/**
+ *	@brief		Starts a wait
+ *	@details	Takes the start time stamp and calculates the deadline.
+ *
+ *	@param		PpPoll				Wait state to initialize
+ *	@param		PeWaitType			Wait type
+ *	@param		PunTimeoutUs		Timeout of the wait in microseconds
+ */
+void
+Polling_Start(
+	_Out_	IfxPoll*			PpPoll,
+	_In_	POLLING_WAIT_TYPE	PeWaitType,
+	_In_	unsigned int		PunTimeoutUs)
+{
+	if (NULL != PpPoll)
+	{
+		PpPoll->eWaitType = (PeWaitType < POLLING_WAIT_TYPE_COUNT) ? PeWaitType : POLLING_WAIT_STS_VALID;
+		PpPoll->ullStartUs = Platform_GetMonotonicTimeMicroSeconds();
+		PpPoll->ullDeadlineUs = PpPoll->ullStartUs + PunTimeoutUs;
+		PpPoll->unSleepUs = s_rgsStrategies[PpPoll->eWaitType].unInitialSleepUs;
+		PpPoll->unPolls = 0;
+		PpPoll->fTimedOut = FALSE;
+	}
+}
+
+/**
+ *	@brief		Waits before the next poll
+ *	@details	Counts the poll which has just been done. Returns immediately during the busy-spin phase and sleeps
+ *				with exponential backoff afterwards. A sleep never exceeds the deadline.
+ *
+ *	@param		PpPoll				Wait state
+ *
+ *	@retval		TRUE				The caller shall poll again.
+ *	@retval		FALSE				The deadline has been reached. The caller shall stop polling.
+ */
+_Check_return_
+BOOL
+Polling_Wait(
+	_Inout_	IfxPoll*	PpPoll)
+{
+	BOOL fPollAgain = FALSE;
+
+	do
+	{
+		unsigned long long ullNowUs = 0;
+		const IfxPollingStrategy* pStrategy = NULL;
+
+		if (NULL == PpPoll)
+			break;
+
+		PpPoll->unPolls++;
+
+		ullNowUs = Platform_GetMonotonicTimeMicroSeconds();
+		if (ullNowUs >= PpPoll->ullDeadlineUs)
+		{
+			PpPoll->fTimedOut = TRUE;
+			break;
+		}
+
+		pStrategy = &s_rgsStrategies[PpPoll->eWaitType];
+		if (ullNowUs - PpPoll->ullStartUs >= pStrategy->unSpinTimeUs)
+		{
+			unsigned int unSleepUs = PpPoll->unSleepUs;
+
+			// Do not sleep beyond the deadline
+			if ((unsigned long long)unSleepUs > PpPoll->ullDeadlineUs - ullNowUs)
+				unSleepUs = (unsigned int)(PpPoll->ullDeadlineUs - ullNowUs);
+
+			if (0 != unSleepUs)
+				Platform_SleepMicroSeconds(unSleepUs);
+
+			// Exponential backoff
+			PpPoll->unSleepUs *= 2;
+			if (PpPoll->unSleepUs > pStrategy->unMaxSleepUs || 0 == PpPoll->unSleepUs)
+				PpPoll->unSleepUs = pStrategy->unMaxSleepUs;
+		}
+
+		fPollAgain = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	return fPollAgain;
+}
+
+/**
+ *	@brief		Finishes a wait
+ *	@details	Adds the number of polls and the elapsed time of the wait to the statistics of its wait type.
+ *
+ *	@param		PpPoll				Wait state
+ */
+void
+Polling_Finish(
+	_Inout_	IfxPoll*	PpPoll)
+{
+	if (NULL != PpPoll && PpPoll->eWaitType < POLLING_WAIT_TYPE_COUNT)
+	{
+		IfxPollingStatistics* pStatistics = &s_rgsStatistics[PpPoll->eWaitType];
+		unsigned long long ullElapsedUs = Platform_GetMonotonicTimeMicroSeconds() - PpPoll->ullStartUs;
+		// The final (successful or failed) poll has not been counted by Polling_Wait
+		unsigned int unPolls = PpPoll->fTimedOut ? PpPoll->unPolls : PpPoll->unPolls + 1;
+
+		pStatistics->unWaits++;
+		if (PpPoll->fTimedOut)
+			pStatistics->unTimeouts++;
+		pStatistics->ullPolls += unPolls;
+		if (unPolls > pStatistics->unMaxPolls)
+			pStatistics->unMaxPolls = unPolls;
+		pStatistics->ullTotalTimeUs += ullElapsedUs;
+		if (ullElapsedUs > pStatistics->ullMaxTimeUs)
+			pStatistics->ullMaxTimeUs = ullElapsedUs;
+	}
+}
+
+/**
+ *	@brief		Waits until a readiness probe reports the condition as met
+ *	@details	Calls the probe according to the polling strategy of the wait type until it reports readiness, fails
+ *				or the timeout elapses. Running into the timeout is not an error; it is reported through PpfReady.
+ *
+ *	@param		PeWaitType			Wait type
+ *	@param		PunTimeoutUs		Timeout of the wait in microseconds
+ *	@param		PfnProbe			Readiness probe
+ *	@param		PpContext			Context passed to the probe (optional, can be NULL)
+ *	@param		PpfReady			Receives TRUE if the probe reported readiness, FALSE on timeout
+ *
+ *	@retval		RC_SUCCESS			The probe reported readiness or the timeout elapsed.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		...					Error codes from the probe.
+ */
+_Check_return_
+unsigned int
+Polling_WaitForCondition(
+	_In_		POLLING_WAIT_TYPE	PeWaitType,
+	_In_		unsigned int		PunTimeoutUs,
+	_In_		PFN_POLLING_PROBE	PfnProbe,
+	_Inout_opt_	void*				PpContext,
+	_Out_		BOOL*				PpfReady)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		IfxPoll sPoll;
+
+		// Check parameters
+		if (PeWaitType >= POLLING_WAIT_TYPE_COUNT || NULL == PfnProbe || NULL == PpfReady)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		*PpfReady = FALSE;
+		Polling_Start(&sPoll, PeWaitType, PunTimeoutUs);
+		do
+		{
+			unReturnValue = PfnProbe(PpContext, PpfReady);
+			if (RC_SUCCESS != unReturnValue || TRUE == *PpfReady)
+				break;
+		}
+		while (TRUE == Polling_Wait(&sPoll));
+		Polling_Finish(&sPoll);
+
+		if (RC_SUCCESS == unReturnValue && FALSE == *PpfReady)
+			LOGGING_WRITE_LEVEL1_FMT(L"Wait %ls: Condition not met after %u us", s_rgwszWaitTypeNames[PeWaitType], PunTimeoutUs);
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Returns the statistics of a wait type
+ *	@details	Used for the wait section of the timing report.
+ *
+ *	@param		PeWaitType			Wait type
+ *	@param		PpStatistics		Receives the statistics
+ *	@param		PppwszName			Receives the name of the wait type
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ */
+_Check_return_
+unsigned int
+Polling_GetStatistics(
+	_In_	POLLING_WAIT_TYPE		PeWaitType,
+	_Out_	IfxPollingStatistics*	PpStatistics,
+	_Out_	const wchar_t**			PppwszName)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		// Check parameters
+		if (PeWaitType >= POLLING_WAIT_TYPE_COUNT || NULL == PpStatistics || NULL == PppwszName)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+
+		*PpStatistics = s_rgsStatistics[PeWaitType];
+		*PppwszName = s_rgwszWaitTypeNames[PeWaitType];
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Writes the statistics of all wait types to the log
+ *	@details	The statistics are written with logging level 3.
+ */
+void
+Polling_LogStatistics()
+{
+	unsigned int unIndex = 0;
+
+	for (unIndex = 0; unIndex < POLLING_WAIT_TYPE_COUNT; unIndex++)
+	{
+		IfxPollingStatistics* pStatistics = &s_rgsStatistics[unIndex];
+		if (0 == pStatistics->unWaits)
+			continue;
+
+		LOGGING_WRITE_LEVEL3_FMT(
+			L"Wait %ls: %u waits, %u timeouts, %llu polls (max %u), avg %llu us, max %llu us",
+			s_rgwszWaitTypeNames[unIndex],
+			pStatistics->unWaits,
+			pStatistics->unTimeouts,
+			pStatistics->ullPolls,
+			pStatistics->unMaxPolls,
+			pStatistics->ullTotalTimeUs / pStatistics->unWaits,
+			pStatistics->ullMaxTimeUs);
+	}
+}
@@ -0,0 +1,212 @@
+﻿/**
+ *	@brief		Declares the polling strategy functions used to wait for TPM state transitions
+ *	@details
+ *	@file		TpmDeviceAccess/Polling.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	@brief		Wait type enumeration
+ *	@details	Enumerates the kinds of TPM state transitions the tool waits for. Each wait type has its own
+ *				polling strategy and statistics.
+ */
+typedef enum tdPOLLING_WAIT_TYPE
+{
+	/// Wait for TPM.ACCESS.activeLocality
+	POLLING_WAIT_LOCALITY = 0,
+	/// Wait for TPM.STS.commandReady
+	POLLING_WAIT_COMMAND_READY = 1,
+	/// Wait for TPM.STS.burstCount > 0
+	POLLING_WAIT_BURST_COUNT = 2,
+	/// Wait for TPM.STS.stsValid together with the expected state of TPM.STS.Expect or TPM.STS.dataAvail
+	POLLING_WAIT_STS_VALID = 3,
+	/// Wait for TPM.STS.dataAvail after command execution has been started
+	POLLING_WAIT_DATA_AVAILABLE = 4,
+	/// Wait before retrying a TPM command which failed on transport level
+	POLLING_WAIT_TRANSMIT_RETRY = 5,
+	/// Wait for the TPM to switch to boot loader mode after TPM_FieldUpgradeStart
+	POLLING_WAIT_BOOT_LOADER_MODE = 6,
+	/// Wait for the TPM to run the new firmware after TPM_FieldUpgradeComplete
+	POLLING_WAIT_FIRMWARE_READY = 7,
+	/// Wait before retrying a write to the TPM driver which reported EBUSY
+	POLLING_WAIT_DRIVER_BUSY = 8,
+	/// Number of wait types
+	POLLING_WAIT_TYPE_COUNT = 9
+} POLLING_WAIT_TYPE;
+
+/**
+ *	@brief		Polling strategy
+ *	@details	The condition is polled back to back until unSpinTimeUs has elapsed. Afterwards the poller sleeps
+ *				between two polls, starting with unInitialSleepUs and doubling the sleep time up to unMaxSleepUs.
+ *				A strategy with unSpinTimeUs set to 0 and unInitialSleepUs equal to unMaxSleepUs is a fixed sleep interval.
+ */
+typedef struct tdIfxPollingStrategy
+{
+	/// Duration of the busy-spin phase in microseconds
+	unsigned int unSpinTimeUs;
+	/// First sleep time after the busy-spin phase in microseconds
+	unsigned int unInitialSleepUs;
+	/// Upper limit for the sleep time in microseconds
+	unsigned int unMaxSleepUs;
+} IfxPollingStrategy;
+
+/**
+ *	@brief		Polling statistics of a wait type
+ *	@details
+ */
+typedef struct tdIfxPollingStatistics
+{
+	/// Number of completed waits
+	unsigned int unWaits;
+	/// Number of waits which ran into the timeout
+	unsigned int unTimeouts;
+	/// Sum of polls of all waits
+	unsigned long long ullPolls;
+	/// Maximum number of polls of a single wait
+	unsigned int unMaxPolls;
+	/// Sum of the elapsed time of all waits in microseconds
+	unsigned long long ullTotalTimeUs;
+	/// Maximum elapsed time of a single wait in microseconds
+	unsigned long long ullMaxTimeUs;
+} IfxPollingStatistics;
+
+/**
+ *	@brief		State of a single wait
+ *	@details	Initialized by Polling_Start and used by Polling_Wait and Polling_Finish.
+ */
+typedef struct tdIfxPoll
+{
+	/// Wait type
+	POLLING_WAIT_TYPE eWaitType;
+	/// Monotonic time stamp of the start of the wait in microseconds
+	unsigned long long ullStartUs;
+	/// Monotonic time stamp of the deadline in microseconds
+	unsigned long long ullDeadlineUs;
+	/// Sleep time for the next sleep in microseconds
+	unsigned int unSleepUs;
+	/// Number of polls so far
+	unsigned int unPolls;
+	/// Flag indicating whether the deadline has been reached
+	BOOL fTimedOut;
+} IfxPoll;
+
+/**
+ *	@brief		Readiness probe callback
+ *	@details	Called by Polling_WaitForCondition to check whether the awaited condition is met.
+ *
+ *	@param		PpContext			Context passed to Polling_WaitForCondition
+ *	@param		PpfReady			Receives TRUE if the condition is met, FALSE otherwise
+ *
+ *	@retval		RC_SUCCESS			The probe completed. *PpfReady holds the result.
+ *	@retval		...					Any other value aborts the wait and is returned by Polling_WaitForCondition.
+ */
+typedef unsigned int (*PFN_POLLING_PROBE)(
+	_Inout_opt_	void*	PpContext,
+	_Out_		BOOL*	PpfReady);
+
+/**
+ *	@brief		Starts a wait
+ *	@details	Takes the start time stamp and calculates the deadline.
+ *
+ *	@param		PpPoll				Wait state to initialize
+ *	@param		PeWaitType			Wait type
+ *	@param		PunTimeoutUs		Timeout of the wait in microseconds
+ */
+void
+Polling_Start(
+	_Out_	IfxPoll*			PpPoll,
+	_In_	POLLING_WAIT_TYPE	PeWaitType,
+	_In_	unsigned int		PunTimeoutUs);
+
+/**
+ *	@brief		Waits before the next poll
+ *	@details	Counts the poll which has just been done. Returns immediately during the busy-spin phase and sleeps
+ *				with exponential backoff afterwards. A sleep never exceeds the deadline.
+ *
+ *	@param		PpPoll				Wait state
+ *
+ *	@retval		TRUE				The caller shall poll again.
+ *	@retval		FALSE				The deadline has been reached. The caller shall stop polling.
+ */
+_Check_return_
+BOOL
+Polling_Wait(
+	_Inout_	IfxPoll*	PpPoll);
+
+/**
+ *	@brief		Finishes a wait
+ *	@details	Adds the number of polls and the elapsed time of the wait to the statistics of its wait type.
+ *
+ *	@param		PpPoll				Wait state
+ */
+void
+Polling_Finish(
+	_Inout_	IfxPoll*	PpPoll);
+
+/**
+ *	@brief		Waits until a readiness probe reports the condition as met
+ *	@details	Calls the probe according to the polling strategy of the wait type until it reports readiness, fails
+ *				or the timeout elapses. Running into the timeout is not an error; it is reported through PpfReady.
+ *
+ *	@param		PeWaitType			Wait type
+ *	@param		PunTimeoutUs		Timeout of the wait in microseconds
+ *	@param		PfnProbe			Readiness probe
+ *	@param		PpContext			Context passed to the probe (optional, can be NULL)
+ *	@param		PpfReady			Receives TRUE if the probe reported readiness, FALSE on timeout
+ *
+ *	@retval		RC_SUCCESS			The probe reported readiness or the timeout elapsed.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ *	@retval		...					Error codes from the probe.
+ */
+_Check_return_
+unsigned int
+Polling_WaitForCondition(
+	_In_		POLLING_WAIT_TYPE	PeWaitType,
+	_In_		unsigned int		PunTimeoutUs,
+	_In_		PFN_POLLING_PROBE	PfnProbe,
+	_Inout_opt_	void*				PpContext,
+	_Out_		BOOL*				PpfReady);
+
+/**
+ *	@brief		Returns the statistics of a wait type
+ *	@details	Used for the wait section of the timing report.
+ *
+ *	@param		PeWaitType			Wait type
+ *	@param		PpStatistics		Receives the statistics
+ *	@param		PppwszName			Receives the name of the wait type
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER	An invalid parameter was passed to the function.
+ */
+_Check_return_
+unsigned int
+Polling_GetStatistics(
+	_In_	POLLING_WAIT_TYPE		PeWaitType,
+	_Out_	IfxPollingStatistics*	PpStatistics,
+	_Out_	const wchar_t**			PppwszName);
+
+/**
+ *	@brief		Writes the statistics of all wait types to the log
+ *	@details	The statistics are written with logging level 3.
+ */
+void
+Polling_LogStatistics();
+
+#ifdef __cplusplus
+}
+#endif
@@ -35,6 +35,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <poll.h>
 #include <string.h>
 
 #include "Globals_Linux.h"
@@ -15,6 +15,7 @@
 
 #include "TPM_TIS.h"
 #include "DeviceAccess.h"
+#include "Polling.h"
 #include "Platform.h"
 #include "Logging.h"
 
@@ -34,6 +35,10 @@ static BYTE s_bStatusRegister = 0xFF;
  *	@brief		Determines whether the value of s_bStatusRegister could be read.
  */
 static BOOL s_fStatusRegisterValid = FALSE;
+/**
+ *	@brief		Caches the access width in bytes used for FIFO transfers. 0 if not yet determined.
+ */
+static BYTE s_bFifoAccessWidth = 0;
 
 /**
  *	@brief		Represents a TPM register descriptor
@@ -111,6 +116,53 @@ static IfxTpmRegister s_sAccessRegister[] =
 	} \
 } \
 
+/**
+ *	@brief		Returns the base address of the register space of a locality
+ *	@details
+ *
+ *	@param		PbLocality		Locality value
+ *	@param		PpunAddress		Pointer to the base address
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_LOCALITY_NOT_SUPPORTED	Given locality is not supported
+ */
+_Check_return_
+static UINT32
+TIS_GetLocalityAddress(
+	_In_	BYTE	PbLocality,
+	_Out_	UINT32*	PpunAddress)
+{
+	UINT32 unReturnCode = RC_SUCCESS;
+
+	switch (PbLocality)
+	{
+		case TIS_LOCALITY_0:
+			*PpunAddress = TIS_LOCALITY0OFFSET;
+			break;
+
+		case TIS_LOCALITY_1:
+			*PpunAddress = TIS_LOCALITY1OFFSET;
+			break;
+
+		case TIS_LOCALITY_2:
+			*PpunAddress = TIS_LOCALITY2OFFSET;
+			break;
+
+		case TIS_LOCALITY_3:
+			*PpunAddress = TIS_LOCALITY3OFFSET;
+			break;
+
+		case TIS_LOCALITY_4:
+			*PpunAddress = TIS_LOCALITY4OFFSET;
+			break;
+
+		default:
+			unReturnCode = RC_E_LOCALITY_NOT_SUPPORTED;
+	}
+
+	return unReturnCode;
+}
+
 /**
  *	@brief		Read the value of a TIS register
  *	@details
@@ -143,32 +195,7 @@ TIS_ReadRegister(
 			break;
 		}
 
-		switch (PbLocality)
-		{
-			case TIS_LOCALITY_0:
-				unAddress = TIS_LOCALITY0OFFSET;
-				break;
-
-			case TIS_LOCALITY_1:
-				unAddress = TIS_LOCALITY1OFFSET;
-				break;
-
-			case TIS_LOCALITY_2:
-				unAddress = TIS_LOCALITY2OFFSET;
-				break;
-
-			case TIS_LOCALITY_3:
-				unAddress = TIS_LOCALITY3OFFSET;
-				break;
-
-			case TIS_LOCALITY_4:
-				unAddress = TIS_LOCALITY4OFFSET;
-				break;
-
-			default:
-				unReturnCode = RC_E_LOCALITY_NOT_SUPPORTED;
-		}
-
+		unReturnCode = TIS_GetLocalityAddress(PbLocality, &unAddress);
 		if (RC_SUCCESS != unReturnCode)
 		{
 			PpValue = NULL;
@@ -188,6 +215,10 @@ TIS_ReadRegister(
 				*(UINT16*)PpValue = DeviceAccess_ReadWord(unAddress);
 				break;
 
+			case sizeof(UINT32):
+				*(UINT32*)PpValue = DeviceAccess_ReadDWord(unAddress);
+				break;
+
 			default:
 				// Invalid Register Size requested
 				unReturnCode = RC_E_BAD_PARAMETER;
@@ -225,32 +256,7 @@ TIS_WriteRegister(
 
 	do
 	{
-		switch (PbLocality)
-		{
-			case TIS_LOCALITY_0:
-				unAddress = TIS_LOCALITY0OFFSET;
-				break;
-
-			case TIS_LOCALITY_1:
-				unAddress = TIS_LOCALITY1OFFSET;
-				break;
-
-			case TIS_LOCALITY_2:
-				unAddress = TIS_LOCALITY2OFFSET;
-				break;
-
-			case TIS_LOCALITY_3:
-				unAddress = TIS_LOCALITY3OFFSET;
-				break;
-
-			case TIS_LOCALITY_4:
-				unAddress = TIS_LOCALITY4OFFSET;
-				break;
-
-			default:
-				unReturnCode = RC_E_LOCALITY_NOT_SUPPORTED;
-		}
-
+		unReturnCode = TIS_GetLocalityAddress(PbLocality, &unAddress);
 		if (RC_SUCCESS != unReturnCode)
 			break;
 
@@ -711,6 +717,123 @@ TIS_Retry(
 	return TIS_WriteStsRegister(PbLocality, TIS_TPM_STS_RETRY);
 }
 
+/**
+ *	@brief		Returns the access width to be used for FIFO transfers
+ *	@details	TIS 1.3 and PTP FIFO interfaces which report a data transfer size other than legacy accept
+ *				multi-byte accesses to the extended data FIFO. All other interfaces are accessed byte by byte.
+ *				The result is determined once and cached.
+ *
+ *	@param		PbLocality		Locality value
+ *
+ *	@returns	The access width in bytes (sizeof(BYTE) or sizeof(UINT32))
+ */
+_Check_return_
+static BYTE
+TIS_GetFifoAccessWidth(
+	_In_	BYTE	PbLocality)
+{
+	if (0 == s_bFifoAccessWidth)
+	{
+		UINT32 unCapability = 0;
+		UINT32 unVersion = 0;
+
+		s_bFifoAccessWidth = sizeof(BYTE);
+		if (RC_SUCCESS == TIS_ReadRegister(PbLocality, TIS_TPM_INTF_CAPABILITY, sizeof(UINT32), &unCapability) && 0xFFFFFFFF != unCapability)
+		{
+			unVersion = unCapability & TIS_TPM_INTF_CAPABILITY_VERSION_MASK;
+			if ((TIS_TPM_INTF_CAPABILITY_VERSION_TIS13 == unVersion || TIS_TPM_INTF_CAPABILITY_VERSION_FIFO == unVersion) &&
+					TIS_TPM_INTF_CAPABILITY_TRANSFER_SIZE_LEGACY != (unCapability & TIS_TPM_INTF_CAPABILITY_TRANSFER_SIZE_MASK))
+				s_bFifoAccessWidth = sizeof(UINT32);
+		}
+
+		LOGGING_WRITE_LEVEL4_FMT(L"TIS interface capability: 0x%.8X, FIFO access width: %d", unCapability, s_bFifoAccessWidth);
+	}
+
+	return s_bFifoAccessWidth;
+}
+
+/**
+ *	@brief		Write a block of bytes to the data FIFO
+ *	@details	Writes the bytes to the TPM FIFO using the widest access the TPM interface supports. The caller is
+ *				responsible for not exceeding the current burst count.
+ *
+ *	@param		PbLocality		Locality value
+ *	@param		PrgbByteBuf		Bytes to write
+ *	@param		PusLen			Number of bytes to write
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_LOCALITY_NOT_SUPPORTED	Given locality is not supported
+ *	@retval		...							Error codes from DeviceAccess_WriteFifo function
+ */
+_Check_return_
+UINT32
+TIS_WriteFifo(
+	_In_					BYTE		PbLocality,
+	_In_bytecount_(PusLen)	const BYTE*	PrgbByteBuf,
+	_In_					UINT16		PusLen)
+{
+	UINT32 unReturnCode = RC_SUCCESS;
+	UINT32 unAddress = 0;
+
+	do
+	{
+		BYTE bAccessWidth = 0;
+
+		unReturnCode = TIS_GetLocalityAddress(PbLocality, &unAddress);
+		if (RC_SUCCESS != unReturnCode)
+			break;
+
+		bAccessWidth = TIS_GetFifoAccessWidth(PbLocality);
+		unAddress |= (sizeof(UINT32) == bAccessWidth) ? TIS_TPM_XDATA_FIFO : TIS_TPM_DATA_FIFO;
+
+		unReturnCode = DeviceAccess_WriteFifo(unAddress, bAccessWidth, PrgbByteBuf, PusLen);
+	}
+	WHILE_FALSE_END;
+
+	return unReturnCode;
+}
+
+/**
+ *	@brief		Read a block of bytes from the data FIFO
+ *	@details	Reads the bytes from the TPM FIFO using the widest access the TPM interface supports. The caller is
+ *				responsible for not exceeding the current burst count.
+ *
+ *	@param		PbLocality		Locality value
+ *	@param		PrgbByteBuf		Buffer receiving the bytes
+ *	@param		PusLen			Number of bytes to read
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_LOCALITY_NOT_SUPPORTED	Given locality is not supported
+ *	@retval		...							Error codes from DeviceAccess_ReadFifo function
+ */
+_Check_return_
+UINT32
+TIS_ReadFifo(
+	_In_					BYTE	PbLocality,
+	_Out_bytecap_(PusLen)	BYTE*	PrgbByteBuf,
+	_In_					UINT16	PusLen)
+{
+	UINT32 unReturnCode = RC_SUCCESS;
+	UINT32 unAddress = 0;
+
+	do
+	{
+		BYTE bAccessWidth = 0;
+
+		unReturnCode = TIS_GetLocalityAddress(PbLocality, &unAddress);
+		if (RC_SUCCESS != unReturnCode)
+			break;
+
+		bAccessWidth = TIS_GetFifoAccessWidth(PbLocality);
+		unAddress |= (sizeof(UINT32) == bAccessWidth) ? TIS_TPM_XDATA_FIFO : TIS_TPM_DATA_FIFO;
+
+		unReturnCode = DeviceAccess_ReadFifo(unAddress, bAccessWidth, PrgbByteBuf, PusLen);
+	}
+	WHILE_FALSE_END;
+
+	return unReturnCode;
+}
+
 /**
  *	@brief		Send data block to the TPM
  *	@details	Send a data block to the TPM TIS data FIFO under consideration of the
@@ -744,12 +867,11 @@ TIS_SendLPC(
 {
 	UINT32 unReturnCode = RC_SUCCESS;
 	BYTE bValue = 0;
-	BYTE i = 0;
 	BOOL bFlag = FALSE;
 	UINT16 usBurstCount = 0;
 	UINT16 usTxSize = 0;
-	UINT32 unTimeOut = 0;
 	UINT32 unPosition = 0;
+	IfxPoll sPoll;
 
 	do
 	{
@@ -768,29 +890,25 @@ TIS_SendLPC(
 			break;
 
 		// Check whether requested Locality is active, timeout after TIMEOUT_A
-		unTimeOut = (TIMEOUT_A * 1000) / SLEEP_TIME_US_CR;
+		Polling_Start(&sPoll, POLLING_WAIT_LOCALITY, TIMEOUT_A * 1000);
 		do
 		{
 			unReturnCode = TIS_IsActiveLocality(PbLocality, &bFlag);
 			if (RC_SUCCESS != unReturnCode)
 			{
 				TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Failed to test the active locality (0x%.8x)", unReturnCode);
-				unTimeOut = 0;	// Stop immediately on error
+				break;	// Stop immediately on error
 			}
-			else if (TRUE == bFlag)
-				unTimeOut = 0;	// Stop immediately if flag is set
-			else
+			if (TRUE == bFlag)
+				break;	// Stop immediately if flag is set
+			if (FALSE == Polling_Wait(&sPoll))
 			{
-				Platform_SleepMicroSeconds(SLEEP_TIME_US_CR);
-				unTimeOut = unTimeOut - 1;
-				if (0 == unTimeOut)
-				{
-					unReturnCode = RC_E_LOCALITY_NOT_ACTIVE;
-					TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Locality 0x%.2X not active after 750ms (0x%.8x)", PbLocality, unReturnCode);
-				}
+				unReturnCode = RC_E_LOCALITY_NOT_ACTIVE;
+				TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Locality 0x%.2X not active after 750ms (0x%.8x)", PbLocality, unReturnCode);
 			}
 		}
-		while (unTimeOut > 0);
+		while (RC_SUCCESS == unReturnCode);
+		Polling_Finish(&sPoll);
 		if (RC_SUCCESS != unReturnCode)
 			break;
 
@@ -803,29 +921,25 @@ TIS_SendLPC(
 				break;
 
 			// Check whether the TPM can receive a command, timeout after TIMEOUT_B
-			unTimeOut = (TIMEOUT_B * 1000) / SLEEP_TIME_US;
+			Polling_Start(&sPoll, POLLING_WAIT_COMMAND_READY, TIMEOUT_B * 1000);
 			do
 			{
 				unReturnCode = TIS_IsCommandReady(PbLocality, &bFlag);
 				if (RC_SUCCESS != unReturnCode)
 				{
 					TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Failed to read the command ready flag (0x%.8x)", unReturnCode);
-					unTimeOut = 0;	// Stop immediately on error
+					break;	// Stop immediately on error
 				}
-				else if (TRUE == bFlag)
-					unTimeOut = 0;	// Stop immediately if flag is set
-				else
+				if (TRUE == bFlag)
+					break;	// Stop immediately if flag is set
+				if (FALSE == Polling_Wait(&sPoll))
 				{
-					Platform_SleepMicroSeconds(SLEEP_TIME_US);
-					unTimeOut = unTimeOut - 1;
-					if (0 == unTimeOut)
-					{
-						unReturnCode = RC_E_NOT_READY;
-						TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Command ready flag not set after 2000ms (0x%.8x)", unReturnCode);
-					}
+					unReturnCode = RC_E_NOT_READY;
+					TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Command ready flag not set after 2000ms (0x%.8x)", unReturnCode);
 				}
 			}
-			while (unTimeOut > 0);
+			while (RC_SUCCESS == unReturnCode);
+			Polling_Finish(&sPoll);
 		}
 		if (RC_SUCCESS != unReturnCode)
 			break;
@@ -835,85 +949,61 @@ TIS_SendLPC(
 			do
 			{
 				// Read the BurstCount register, timeout after TIMEOUT_C if it remains 0
-				unTimeOut = (TIMEOUT_C * 1000) / SLEEP_TIME_US_BURSTCOUNT;
+				Polling_Start(&sPoll, POLLING_WAIT_BURST_COUNT, TIMEOUT_C * 1000);
 				do
 				{
 					unReturnCode = TIS_GetBurstCount(PbLocality, &usBurstCount);
 					if (RC_SUCCESS != unReturnCode)
 					{
 						TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Failed to read the burst count (0x%.8x)", unReturnCode);
-						unTimeOut = 0;	// Stop immediately on error
+						break;	// Stop immediately on error
 					}
-					else if (0 < usBurstCount)
-						unTimeOut = 0;
-					else
+					if (0 < usBurstCount)
+						break;
+					if (FALSE == Polling_Wait(&sPoll))
 					{
-						Platform_SleepMicroSeconds(SLEEP_TIME_US_BURSTCOUNT);
-						unTimeOut = unTimeOut - 1;
-						if (0 == unTimeOut)
-						{
-							unReturnCode = RC_E_NOT_READY;
-							TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Burst count not > 0 after 750ms. Burst count: 0x%.4X (0x%.8x)", usBurstCount, unReturnCode);
-						}
+						unReturnCode = RC_E_NOT_READY;
+						TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Burst count not > 0 after 750ms. Burst count: 0x%.4X (0x%.8x)", usBurstCount, unReturnCode);
 					}
 				}
-				while (unTimeOut > 0);
+				while (RC_SUCCESS == unReturnCode);
+				Polling_Finish(&sPoll);
 				if (RC_SUCCESS != unReturnCode)
 					break;
 
-				if (usTxSize > usBurstCount)
-				{
-					for (i = 0; i < usBurstCount; i++)
-					{
-						// All OK, now write Byte to the TPM FIFO
-						unReturnCode = TIS_WriteRegister(PbLocality, TIS_TPM_DATA_FIFO, sizeof(BYTE), (UINT32)*&PrgbByteBuf[unPosition]);
-						if (RC_SUCCESS != unReturnCode)
-							break;
-						unPosition++;
-					}
-					usTxSize -= usBurstCount;
-				}
-				else
-				{
-					for (i = 0; i < (usTxSize - 1); i++)
-					{
-						// All OK, now write Byte(s) to the TPM FIFO
-						unReturnCode = TIS_WriteRegister(PbLocality, TIS_TPM_DATA_FIFO, sizeof(BYTE), (UINT32)*&PrgbByteBuf[unPosition]);
-						if (RC_SUCCESS != unReturnCode)
-							break;
-						unPosition++;
-					}
-					usTxSize = 1;
-				}
+				// Write a complete burst but always keep the last byte for the final stsValid and Expect check
+				if (usBurstCount > usTxSize - 1)
+					usBurstCount = usTxSize - 1;
+
+				// All OK, now write the burst to the TPM FIFO
+				unReturnCode = TIS_WriteFifo(PbLocality, &PrgbByteBuf[unPosition], usBurstCount);
 				if (RC_SUCCESS != unReturnCode)
 					break;
+				unPosition += usBurstCount;
+				usTxSize -= usBurstCount;
 			}
 			while (usTxSize > 1);
 
 			// Last Byte, check stsValid and Expect, timeout after TIMEOUT_C
-			unTimeOut = (TIMEOUT_C * 1000) / SLEEP_TIME_US;
+			Polling_Start(&sPoll, POLLING_WAIT_STS_VALID, TIMEOUT_C * 1000);
 			do
 			{
 				unReturnCode = TIS_ReadStsRegister(PbLocality, &bValue);
 				if (RC_SUCCESS != unReturnCode)
 				{
 					TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Failed to read the STS register before last byte (0x%.8x)", unReturnCode);
-					unTimeOut = 0;	// Stop immediately on error
+					break;	// Stop immediately on error
 				}
-				else if ((bValue & TIS_TPM_STS_VALID) && (bValue & TIS_TPM_STS_EXPECT))
-					unTimeOut = 0;	// Stop immediately if flag is set
-				else
+				if ((bValue & TIS_TPM_STS_VALID) && (bValue & TIS_TPM_STS_EXPECT))
+					break;	// Stop immediately if flag is set
+				if (FALSE == Polling_Wait(&sPoll))
 				{
-					Platform_SleepMicroSeconds(SLEEP_TIME_US);
-					unTimeOut = unTimeOut - 1;
-					if (0 == unTimeOut)
-					{
-						unReturnCode = RC_E_TPM_TRANSMIT_DATA;
-						TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: STS register: TPM did not set stsValid and Expect bits after timeout of 750 ms. Register value: 0x%.2X (0x%.8x)", bValue, unReturnCode);
-					}
+					unReturnCode = RC_E_TPM_TRANSMIT_DATA;
+					TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: STS register: TPM did not set stsValid and Expect bits after timeout of 750 ms. Register value: 0x%.2X (0x%.8x)", bValue, unReturnCode);
 				}
 			}
-			while (unTimeOut > 0);
+			while (RC_SUCCESS == unReturnCode);
+			Polling_Finish(&sPoll);
 			if (RC_SUCCESS != unReturnCode)
 			{
 				// Warning C6031 can be suppressed here, since in case of failure we can't do anything and we
@@ -925,7 +1015,7 @@ TIS_SendLPC(
 				break;
 			}
 			// Transmit the last Byte now
-			unReturnCode = TIS_WriteRegister(PbLocality, TIS_TPM_DATA_FIFO, sizeof(BYTE), (UINT32)*&PrgbByteBuf[unPosition]);
+			unReturnCode = TIS_WriteFifo(PbLocality, &PrgbByteBuf[unPosition], sizeof(BYTE));
 			if (RC_SUCCESS != unReturnCode)
 			{
 				// Warning C6031 can be suppressed here, since in case of failure we can't do anything and we do not
@@ -939,40 +1029,32 @@ TIS_SendLPC(
 		}
 		else // 10 bytes should always be writable.
 		{
-			for (i = 0; i < PusLen; i++)
-			{
-				// All OK, now write Byte to the TPM FIFO
-				unReturnCode = TIS_WriteRegister(PbLocality, TIS_TPM_DATA_FIFO, sizeof(BYTE), (UINT32)*&PrgbByteBuf[unPosition]);
-				if (RC_SUCCESS != unReturnCode)
-					break;
-				unPosition++;
-			}
+			// All OK, now write Bytes to the TPM FIFO
+			unReturnCode = TIS_WriteFifo(PbLocality, PrgbByteBuf, PusLen);
+			if (RC_SUCCESS != unReturnCode)
+				break;
 		}
 
 		// After the last Byte, check stsValid=TRUE and Expect=FALSE, timeout after TIMEOUT_C
-		unTimeOut = (TIMEOUT_C * 1000) / SLEEP_TIME_US;
+		Polling_Start(&sPoll, POLLING_WAIT_STS_VALID, TIMEOUT_C * 1000);
 		do
 		{
 			unReturnCode = TIS_ReadStsRegister(PbLocality, &bValue);
 			if (RC_SUCCESS != unReturnCode)
 			{
 				TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: Failed to read the STS register after last byte (0x%.8x)", unReturnCode);
-				unTimeOut = 0;	// Stop immediately on error
+				break;	// Stop immediately on error
 			}
-			else if ((bValue & TIS_TPM_STS_VALID) && (!(bValue & TIS_TPM_STS_EXPECT)))
-				unTimeOut = 0;	// Stop immediately if condition is met
-			else
+			if ((bValue & TIS_TPM_STS_VALID) && (!(bValue & TIS_TPM_STS_EXPECT)))
+				break;	// Stop immediately if condition is met
+			if (FALSE == Polling_Wait(&sPoll))
 			{
-				Platform_SleepMicroSeconds(SLEEP_TIME_US);
-				unTimeOut = unTimeOut - 1;
-				if (0 == unTimeOut)
-				{
-					unReturnCode = RC_E_TPM_TRANSMIT_DATA;
-					TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: STS register: TPM did not set stsValid and !Expect bit after timeout of 750 ms. Register value: 0x%.2X (0x%.8x)", bValue, unReturnCode);
-				}
+				unReturnCode = RC_E_TPM_TRANSMIT_DATA;
+				TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_SendLPC: STS register: TPM did not set stsValid and !Expect bit after timeout of 750 ms. Register value: 0x%.2X (0x%.8x)", bValue, unReturnCode);
 			}
 		}
-		while (unTimeOut > 0);
+		while (RC_SUCCESS == unReturnCode);
+		Polling_Finish(&sPoll);
 		if (RC_SUCCESS != unReturnCode)
 		{
 			// Warning C6031 can be suppressed here, since in case of failure we can't do anything and we
@@ -1033,9 +1115,8 @@ TIS_ReadLPC(
 	UINT16 usBurstCount = 0;
 	UINT16 usRxSize = 0;
 	UINT16 usBytes2Read = 0;
-	UINT32 unTimeOut = 0;
+	IfxPoll sPoll;
 	BYTE *pbRxData = NULL;
-	BYTE i = 0;
 
 	do
 	{
@@ -1101,23 +1182,19 @@ TIS_ReadLPC(
 			while ((usBytes2Read - usRxSize) > 0)
 			{
 				// Read the BurstCounter whether there are Bytes in the data FIFO
-				unTimeOut = (TIMEOUT_D * 1000) / SLEEP_TIME_US_BURSTCOUNT;
+				Polling_Start(&sPoll, POLLING_WAIT_BURST_COUNT, TIMEOUT_D * 1000);
 				do
 				{
 					unReturnCode = TIS_GetBurstCount(PbLocality, &usBurstCount);
 					if (RC_SUCCESS != unReturnCode)
-						unTimeOut = 0;	// Stop immediately on Error
-					else if (usBurstCount > 0)
-						unTimeOut = 0;
-					else
-					{
-						Platform_SleepMicroSeconds(SLEEP_TIME_US_BURSTCOUNT);
-						unTimeOut = unTimeOut - 1;
-						if (0 == unTimeOut)
-							unReturnCode = RC_E_NOT_READY;
-					}
+						break;	// Stop immediately on Error
+					if (usBurstCount > 0)
+						break;
+					if (FALSE == Polling_Wait(&sPoll))
+						unReturnCode = RC_E_NOT_READY;
 				}
-				while (unTimeOut > 0);
+				while (RC_SUCCESS == unReturnCode);
+				Polling_Finish(&sPoll);
 				if (RC_SUCCESS != unReturnCode)
 				{
 					bRxDone = FALSE;	// It could make sense to retry
@@ -1127,21 +1204,14 @@ TIS_ReadLPC(
 				if (usBurstCount > (usBytes2Read - usRxSize))
 					usBurstCount = usBytes2Read - usRxSize;
 
-				for (i = 0; i < usBurstCount; i++)
-				{
-					unReturnCode = TIS_ReadRegister(PbLocality, TIS_TPM_DATA_FIFO, sizeof(BYTE), pbRxData);
-					if (RC_SUCCESS != unReturnCode)
-						break;
-
-					pbRxData++;
-				}
-
+				unReturnCode = TIS_ReadFifo(PbLocality, pbRxData, usBurstCount);
 				if (RC_SUCCESS != unReturnCode)
 				{
 					bRxDone = FALSE;	// It could make sense to retry
 					break;
 				}
 
+				pbRxData += usBurstCount;
 				usRxSize += usBurstCount;
 
 				// Correct the number of Bytes to be read according to the real parameter size if available
@@ -1164,23 +1234,19 @@ TIS_ReadLPC(
 				break;
 
 			// All Bytes received, check whether this is indicated by the TPM
-			unTimeOut = (TIMEOUT_C * 1000) / SLEEP_TIME_US;
+			Polling_Start(&sPoll, POLLING_WAIT_STS_VALID, TIMEOUT_C * 1000);
 			do
 			{
 				unReturnCode = TIS_ReadStsRegister(PbLocality, &bValue);
 				if (RC_SUCCESS != unReturnCode)
-					unTimeOut = 0;	// Stop immediately on Error
-				else if ((bValue & TIS_TPM_STS_VALID) && (!(bValue & TIS_TPM_STS_AVAIL)))
-					unTimeOut = 0;	// Stop immediately if condition is met
-				else
-				{
-					Platform_SleepMicroSeconds(SLEEP_TIME_US);
-					unTimeOut = unTimeOut - 1;
-					if (0 == unTimeOut)
-						unReturnCode = RC_E_TPM_RECEIVE_DATA;
-				}
+					break;	// Stop immediately on Error
+				if ((bValue & TIS_TPM_STS_VALID) && (!(bValue & TIS_TPM_STS_AVAIL)))
+					break;	// Stop immediately if condition is met
+				if (FALSE == Polling_Wait(&sPoll))
+					unReturnCode = RC_E_TPM_RECEIVE_DATA;
 			}
-			while (unTimeOut > 0);
+			while (RC_SUCCESS == unReturnCode);
+			Polling_Finish(&sPoll);
 			if (RC_SUCCESS != unReturnCode)
 			{
 				bRxDone = FALSE;
@@ -1242,12 +1308,11 @@ TIS_ReadLPC(
 }
 
 /**
- *	@brief		Sends the Transceive Buffer to the TPM and returns the response
- *	@details
+ *	@brief		Waits for the response of a command sent with TIS_SendLPC and reads it
+ *	@details	Polls TPM.STS.dataAvail until the response is available, reads it and releases the locality.
+ *				Allows the caller to do other work between TIS_SendLPC and this function while the TPM executes the command.
  *
  *	@param		PbLocality		Locality value
- *	@param		PrgbTxBuffer	Pointer Transceive buffer
- *	@param		PusTxLen		Length of the Transceive buffer
  *	@param		PrgbRxBuffer	Pointer to a Receive buffer
  *	@param		PpusRxLen		Pointer to the length of the Receive buffer
  *	@param		PunMaxDuration	The maximum duration of the command in microseconds
@@ -1255,62 +1320,45 @@ TIS_ReadLPC(
  *	@retval		RC_SUCCESS					The operation completed successfully.
  *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	TPM no data available
  *	@retval		...							Error codes from:
- *												TIS_SendLPC,
  *												TIS_IsDataAvailable,
  *												TIS_ReadLPC,
  *												TIS_ReleaseActiveLocality function
  */
 _Check_return_
 UINT32
-TIS_TransceiveLPC(
+TIS_ReceiveLPC(
 	_In_						BYTE		PbLocality,
-	_In_bytecount_(PusTxLen)	const BYTE*	PrgbTxBuffer,
-	_In_						UINT16		PusTxLen,
 	_Out_bytecap_(*PpusRxLen)	BYTE*		PrgbRxBuffer,
 	_Inout_						UINT16*		PpusRxLen,
 	_In_						UINT32		PunMaxDuration)
 {
 	UINT32 unReturnCode = RC_SUCCESS;
 	UINT16 usRxSize = 0;
-	UINT32 unTimeOut = 0;
 	BOOL bFlag = FALSE;
+	IfxPoll sPoll;
 
 	do
 	{
-		unReturnCode = TIS_SendLPC(PbLocality, PrgbTxBuffer, PusTxLen);
-		if (RC_SUCCESS != unReturnCode)
-		{
-			TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_TransceiveLPC: TIS_SendLPC failed with (0x%.8x)", unReturnCode);
-			break;
-		}
-
-		// The actual timeout will be higher than PunMaxDuration due to additional time consumed by multiple invocations of
-		// the TIS_IsDataAvailable function.
-		unTimeOut = PunMaxDuration / SLEEP_TIME_US;
+		// Wait for the response, timeout after PunMaxDuration
+		Polling_Start(&sPoll, POLLING_WAIT_DATA_AVAILABLE, PunMaxDuration);
 		do
 		{
 			unReturnCode = TIS_IsDataAvailable(PbLocality, &bFlag);
 			if (RC_SUCCESS != unReturnCode)
 			{
-				TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_TransceiveLPC: TIS_IsDataAvailable failed with (0x%.8x)", unReturnCode);
-				unTimeOut = 0;	// Stop immediately on Error
-			}
-			else if (TRUE == bFlag)
-			{
-				unTimeOut = 0;	// Stop immediately if Flag is set
+				TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_ReceiveLPC: TIS_IsDataAvailable failed with (0x%.8x)", unReturnCode);
+				break;	// Stop immediately on Error
 			}
-			else
+			if (TRUE == bFlag)
+				break;	// Stop immediately if Flag is set
+			if (FALSE == Polling_Wait(&sPoll))
 			{
-				Platform_SleepMicroSeconds(SLEEP_TIME_US);
-				unTimeOut = unTimeOut - 1;
-				if (0 == unTimeOut)
-				{
-					unReturnCode = RC_E_TPM_NO_DATA_AVAILABLE;
-					TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_TransceiveLPC: No data available after timeout of %d microseconds (0x%.8x)", PunMaxDuration, unReturnCode);
-				}
+				unReturnCode = RC_E_TPM_NO_DATA_AVAILABLE;
+				TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_ReceiveLPC: No data available after timeout of %d microseconds (0x%.8x)", PunMaxDuration, unReturnCode);
 			}
 		}
-		while (unTimeOut > 0);
+		while (RC_SUCCESS == unReturnCode);
+		Polling_Finish(&sPoll);
 		if (RC_SUCCESS != unReturnCode)
 			break;
 
@@ -1318,7 +1366,7 @@ TIS_TransceiveLPC(
 		unReturnCode = TIS_ReadLPC(PbLocality, PrgbRxBuffer, &usRxSize);
 		if (RC_SUCCESS != unReturnCode)
 		{
-			TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_TransceiveLPC: TIS_ReadLPC failed with (0x%.8x)", unReturnCode);
+			TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_ReceiveLPC: TIS_ReadLPC failed with (0x%.8x)", unReturnCode);
 			break;
 		}
 
@@ -1331,3 +1379,48 @@ TIS_TransceiveLPC(
 
 	return unReturnCode;
 }
+
+/**
+ *	@brief		Sends the Transceive Buffer to the TPM and returns the response
+ *	@details
+ *
+ *	@param		PbLocality		Locality value
+ *	@param		PrgbTxBuffer	Pointer Transceive buffer
+ *	@param		PusTxLen		Length of the Transceive buffer
+ *	@param		PrgbRxBuffer	Pointer to a Receive buffer
+ *	@param		PpusRxLen		Pointer to the length of the Receive buffer
+ *	@param		PunMaxDuration	The maximum duration of the command in microseconds
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	TPM no data available
+ *	@retval		...							Error codes from:
+ *												TIS_SendLPC,
+ *												TIS_ReceiveLPC function
+ */
+_Check_return_
+UINT32
+TIS_TransceiveLPC(
+	_In_						BYTE		PbLocality,
+	_In_bytecount_(PusTxLen)	const BYTE*	PrgbTxBuffer,
+	_In_						UINT16		PusTxLen,
+	_Out_bytecap_(*PpusRxLen)	BYTE*		PrgbRxBuffer,
+	_Inout_						UINT16*		PpusRxLen,
+	_In_						UINT32		PunMaxDuration)
+{
+	UINT32 unReturnCode = RC_SUCCESS;
+
+	do
+	{
+		unReturnCode = TIS_SendLPC(PbLocality, PrgbTxBuffer, PusTxLen);
+		if (RC_SUCCESS != unReturnCode)
+		{
+			TIS_LOGGING_WRITE_LEVEL1_FMT(L"Error: TIS_TransceiveLPC: TIS_SendLPC failed with (0x%.8x)", unReturnCode);
+			break;
+		}
+
+		unReturnCode = TIS_ReceiveLPC(PbLocality, PrgbRxBuffer, PpusRxLen, PunMaxDuration);
+	}
+	WHILE_FALSE_END;
+
+	return unReturnCode;
+}
@@ -50,8 +50,12 @@
 #define TIS_TPM_STS 0x00000018
 /// Register offset for TPM Burst Count register
 #define TIS_TPM_BURSTCOUNT 0x00000019
+/// Register offset for TPM Interface Capability register
+#define TIS_TPM_INTF_CAPABILITY 0x00000014
 /// Register offset for TPM Data FIFO register
 #define TIS_TPM_DATA_FIFO 0x00000024
+/// Register offset for TPM Extended Data FIFO register (TIS 1.3 and PTP only)
+#define TIS_TPM_XDATA_FIFO 0x00000080
 /// Register offset for TPM Device ID register
 #define TIS_TPM_DID 0x00000F02
 /// Register offset for TPM Vendor ID register
@@ -87,6 +91,17 @@
 /// TPM Status register bit for status retry
 #define TIS_TPM_STS_RETRY 0x02
 
+/// TPM Interface Capability register mask for the interface version
+#define TIS_TPM_INTF_CAPABILITY_VERSION_MASK 0x70000000
+/// TPM Interface Capability register interface version TIS 1.3
+#define TIS_TPM_INTF_CAPABILITY_VERSION_TIS13 0x20000000
+/// TPM Interface Capability register interface version PTP FIFO interface
+#define TIS_TPM_INTF_CAPABILITY_VERSION_FIFO 0x30000000
+/// TPM Interface Capability register mask for the supported data transfer size
+#define TIS_TPM_INTF_CAPABILITY_TRANSFER_SIZE_MASK 0x00000600
+/// TPM Interface Capability register data transfer size legacy (byte access only)
+#define TIS_TPM_INTF_CAPABILITY_TRANSFER_SIZE_LEGACY 0x00000000
+
 /// TPM Vendor ID
 #define TIS_TPM_VID_IFX 0x15D1
 /// TPM Device ID
@@ -347,6 +362,46 @@ UINT32
 TIS_Retry(
 	_In_	BYTE	PbLocality);
 
+/**
+ *	@brief		Write a block of bytes to the data FIFO
+ *	@details	Writes the bytes to the TPM FIFO using the widest access the TPM interface supports. The caller is
+ *				responsible for not exceeding the current burst count.
+ *
+ *	@param		PbLocality		Locality value
+ *	@param		PrgbByteBuf		Bytes to write
+ *	@param		PusLen			Number of bytes to write
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_LOCALITY_NOT_SUPPORTED	Given locality is not supported
+ *	@retval		...							Error codes from DeviceAccess_WriteFifo function
+ */
+_Check_return_
+UINT32
+TIS_WriteFifo(
+	_In_					BYTE		PbLocality,
+	_In_bytecount_(PusLen)	const BYTE*	PrgbByteBuf,
+	_In_					UINT16		PusLen);
+
+/**
+ *	@brief		Read a block of bytes from the data FIFO
+ *	@details	Reads the bytes from the TPM FIFO using the widest access the TPM interface supports. The caller is
+ *				responsible for not exceeding the current burst count.
+ *
+ *	@param		PbLocality		Locality value
+ *	@param		PrgbByteBuf		Buffer receiving the bytes
+ *	@param		PusLen			Number of bytes to read
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_LOCALITY_NOT_SUPPORTED	Given locality is not supported
+ *	@retval		...							Error codes from DeviceAccess_ReadFifo function
+ */
+_Check_return_
+UINT32
+TIS_ReadFifo(
+	_In_					BYTE	PbLocality,
+	_Out_bytecap_(PusLen)	BYTE*	PrgbByteBuf,
+	_In_					UINT16	PusLen);
+
 /**
  *	@brief		Send data block to the TPM
  *	@details	Send a data block to the TPM TIS data FIFO under consideration of the
@@ -411,6 +466,31 @@ TIS_ReadLPC(
 	_Out_bytecap_(*PpusLen)	BYTE*	PrgbByteBuf,
 	_Inout_					UINT16*	PpusLen);
 
+/**
+ *	@brief		Waits for the response of a command sent with TIS_SendLPC and reads it
+ *	@details	Polls TPM.STS.dataAvail until the response is available, reads it and releases the locality.
+ *				Allows the caller to do other work between TIS_SendLPC and this function while the TPM executes the command.
+ *
+ *	@param		PbLocality		Locality value
+ *	@param		PrgbRxBuffer	Pointer to a Receive buffer
+ *	@param		PpusRxLen		Pointer to the length of the Receive buffer
+ *	@param		PunMaxDuration	The maximum duration of the command in microseconds
+ *
+ *	@retval		RC_SUCCESS					The operation completed successfully.
+ *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	TPM no data available
+ *	@retval		...							Error codes from:
+ *												TIS_IsDataAvailable,
+ *												TIS_ReadLPC,
+ *												TIS_ReleaseActiveLocality function
+ */
+_Check_return_
+UINT32
+TIS_ReceiveLPC(
+	_In_						BYTE		PbLocality,
+	_Out_bytecap_(*PpusRxLen)	BYTE*		PrgbRxBuffer,
+	_Inout_						UINT16*		PpusRxLen,
+	_In_						UINT32		PunMaxDuration);
+
 /**
  *	@brief		Sends the Transceive Buffer to the TPM and returns the response
  *	@details
@@ -426,9 +506,7 @@ TIS_ReadLPC(
  *	@retval		RC_E_TPM_NO_DATA_AVAILABLE	TPM no data available
  *	@retval		...							Error codes from:
  *												TIS_SendLPC,
- *												TIS_IsDataAvailable,
- *												TIS_ReadLPC,
- *												TIS_ReleaseActiveLocality function
+ *												TIS_ReceiveLPC function
  */
 _Check_return_
 UINT32
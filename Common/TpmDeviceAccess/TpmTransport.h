@@ -0,0 +1,143 @@
+﻿/**
+ *	@brief		Declares the TPM transport function table
+ *	@details	A transport bundles the functions TPM I/O uses to access the TPM through one device access mode.
+ *	@file		TpmDeviceAccess/TpmTransport.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Maximum number of transports which can be registered
+#define TPMIO_MAX_TRANSPORTS	8
+
+/**
+ *	@brief		Transport state structure
+ *	@details	Holds the state of the transport selected in TPMIO_Connect. It is passed to every transport
+ *				function, so the transports do not need to look up their configuration on each command.
+ */
+typedef struct tdIfxTpmTransportState
+{
+	/// File descriptor of the opened TPM device (-1 if not opened)
+	int				nFileHandle;
+	/// Locality used for the TPM access
+	BYTE			bLocality;
+	/// Transport specific context (e.g. for transports registered at runtime)
+	void*			pvContext;
+	/// Command passed to TPMIO_Send whose response has not been received yet (NULL if none)
+	const BYTE*		pbPendingRequest;
+	/// Size of the pending command in bytes
+	unsigned int	unPendingRequestSize;
+	/// Set by pfnSend if the pending command has been sent to the TPM
+	BOOL			fPendingRequestSent;
+	/// Set by TPMIO_SetRetry to transmit each command once without transport level retries
+	BOOL			fNoRetry;
+} IfxTpmTransportState;
+
+/// Function pointer to method for initializing a transport
+typedef
+unsigned int
+(*PFN_TPM_TRANSPORT_INITIALIZE)(
+	IfxTpmTransportState*	PpState);
+/// Function pointer to method for uninitializing a transport
+typedef
+unsigned int
+(*PFN_TPM_TRANSPORT_UNINITIALIZE)(
+	IfxTpmTransportState*	PpState);
+/// Function pointer to method for transmitting a TPM command through a transport
+typedef
+unsigned int
+(*PFN_TPM_TRANSPORT_TRANSMIT)(
+	IfxTpmTransportState*	PpState,
+	const BYTE*				PrgbRequestBuffer,
+	unsigned int			PunRequestBufferSize,
+	BYTE*					PrgbResponseBuffer,
+	unsigned int*			PpunResponseBufferSize,
+	unsigned int			PunMaxDuration);
+/// Function pointer to method for sending the pending TPM command (PpState->pbPendingRequest) through a transport
+typedef
+unsigned int
+(*PFN_TPM_TRANSPORT_SEND)(
+	IfxTpmTransportState*	PpState);
+/// Function pointer to method for receiving the response of the pending TPM command through a transport
+typedef
+unsigned int
+(*PFN_TPM_TRANSPORT_RECEIVE)(
+	IfxTpmTransportState*	PpState,
+	BYTE*					PrgbResponseBuffer,
+	unsigned int*			PpunResponseBufferSize,
+	unsigned int			PunMaxDuration);
+/// Function pointer to read a byte from a register of the TPM through a transport
+typedef
+unsigned int
+(*PFN_TPM_TRANSPORT_READ_REGISTER)(
+	IfxTpmTransportState*	PpState,
+	unsigned int			PunRegisterAddress,
+	BYTE*					PpbRegisterValue);
+/// Function pointer to write a byte to a register of the TPM through a transport
+typedef
+unsigned int
+(*PFN_TPM_TRANSPORT_WRITE_REGISTER)(
+	IfxTpmTransportState*	PpState,
+	unsigned int			PunRegisterAddress,
+	BYTE					PbRegisterValue);
+
+/**
+ *	@brief		Transport structure
+ *	@details	Function table of a TPM transport. TPMIO_Connect selects the transport registered for the configured
+ *				device access mode once and dispatches all further calls through it.
+ */
+typedef struct tdIfxTpmTransport
+{
+	/// Device access mode (PROPERTY_TPM_DEVICE_ACCESS_MODE) the transport is selected for
+	unsigned int						unDeviceAccessMode;
+	/// Name of the transport used in log messages
+	const wchar_t*						wszName;
+	/// Method for initializing the transport
+	PFN_TPM_TRANSPORT_INITIALIZE		pfnInitialize;
+	/// Method for uninitializing the transport
+	PFN_TPM_TRANSPORT_UNINITIALIZE		pfnUninitialize;
+	/// Method for transmitting a TPM command
+	PFN_TPM_TRANSPORT_TRANSMIT			pfnTransmit;
+	/// Method for reading a register (NULL if not supported)
+	PFN_TPM_TRANSPORT_READ_REGISTER		pfnReadRegister;
+	/// Method for writing a register (NULL if not supported)
+	PFN_TPM_TRANSPORT_WRITE_REGISTER	pfnWriteRegister;
+	/// Method for sending a TPM command without waiting for the response (NULL if not supported, pfnTransmit is used then)
+	PFN_TPM_TRANSPORT_SEND				pfnSend;
+	/// Method for receiving the response of a command sent with pfnSend (must be set if pfnSend is set)
+	PFN_TPM_TRANSPORT_RECEIVE			pfnReceive;
+} IfxTpmTransport;
+
+/**
+ *	@brief		Register a transport
+ *	@details	The transport is used by TPMIO_Connect if its device access mode is configured. A transport registered
+ *				for an already registered device access mode replaces the former one. Must not be called while connected.
+ *
+ *	@param		PpTransport				Pointer to the transport to register; must stay valid for the program execution
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_ALREADY_CONNECTED	If TPM I/O is connected
+ *	@retval		RC_E_BUFFER_TOO_SMALL	If TPMIO_MAX_TRANSPORTS transports are already registered
+ */
+_Check_return_
+unsigned int
+TPMIO_RegisterTransport(
+	_In_	const IfxTpmTransport*	PpTransport);
+
+#ifdef __cplusplus
+}
+#endif
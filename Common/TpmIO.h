@@ -35,6 +35,19 @@ unsigned int
 	BYTE*			PrgbResponseBuffer,
 	unsigned int*	PpunResponseBufferSize,
 	unsigned int	PunMaxDuration);
+/// Function pointer to method for sending data to the TPM without waiting for the response
+typedef
+unsigned int
+(*PFN_TPMIO_Send)(
+	const BYTE*		PrgbRequestBuffer,
+	unsigned int	PunRequestBufferSize);
+/// Function pointer to method for receiving the response of data sent to the TPM
+typedef
+unsigned int
+(*PFN_TPMIO_Receive)(
+	BYTE*			PrgbResponseBuffer,
+	unsigned int*	PpunResponseBufferSize,
+	unsigned int	PunMaxDuration);
 /// Function pointer to read a byte from a register of the TPM
 typedef
 unsigned int
@@ -47,6 +60,11 @@ unsigned int
 (*PFN_TPMIO_WriteRegister)(
 	unsigned int	PunRegisterAddress,
 	BYTE			PbRegisterValue);
+/// Function pointer to enable or disable transport level retries
+typedef
+void
+(*PFN_TPMIO_SetRetry)(
+	BOOL			PfRetry);
 
 /**
  *	@brief		TPM connect function
@@ -81,7 +99,7 @@ TPMIO_Disconnect();
  *	@param		PunRequestBufferSize	Size of command request in bytes
  *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
  *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
- *	@param		PunMaxDuration			The maximum duration of the command in microseconds (relevant for memory based access / TIS protocol only)
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds (deadline of the TIS protocol and of the /dev/tpm0 driver transport)
  *
  *	@retval		RC_SUCCESS				The operation completed successfully.
  *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
@@ -97,6 +115,49 @@ TPMIO_Transmit(
 	_Inout_										unsigned int*	PpunResponseBufferSize,
 	_In_										unsigned int	PunMaxDuration);
 
+/**
+ *	@brief		TPM send function
+ *	@details	This function submits the TPM command to the underlying TPM without waiting for the response. The caller can
+ *				do other work while the TPM executes the command and must call TPMIO_Receive afterwards. The request buffer is
+ *				used without copying and must stay valid until TPMIO_Receive returns. If the transport cannot send a command
+ *				without waiting, the command is transmitted in TPMIO_Receive.
+ *
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_NOT_CONNECTED		If the TPM I/O is not connected to the TPM
+ *	@retval		RC_E_FAIL				The response of the former command has not been received yet.
+ *	@retval		...						Error codes from the transport
+ */
+_Check_return_
+unsigned int
+TPMIO_Send(
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*		PrgbRequestBuffer,
+	_In_										unsigned int	PunRequestBufferSize);
+
+/**
+ *	@brief		TPM receive function
+ *	@details	This function waits for the response of the TPM command submitted with TPMIO_Send.
+ *
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds (deadline of the TIS protocol and of the /dev/tpm0 driver transport)
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_NOT_CONNECTED		If the TPM I/O is not connected to the TPM
+ *	@retval		RC_E_FAIL				No command has been submitted with TPMIO_Send.
+ *	@retval		...						Error codes from the transport
+ */
+_Check_return_
+unsigned int
+TPMIO_Receive(
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*			PrgbResponseBuffer,
+	_Inout_										unsigned int*	PpunResponseBufferSize,
+	_In_										unsigned int	PunMaxDuration);
+
 /**
  *	@brief		Read a byte from a specific address (register)
  *	@details	This function reads a byte from the specified address
@@ -130,6 +191,17 @@ TPMIO_WriteRegister(
 	_In_		unsigned int		PunRegisterAddress,
 	_In_		BYTE				PbRegisterValue);
 
+/**
+ *	@brief		Enable or disable transport level retries
+ *	@details	By default a transport retries a command which failed on transport level, e.g. while the TPM restarts.
+ *				Readiness probes disable the retries so that each probe returns within the deadline of the caller.
+ *
+ *	@param		PfRetry					TRUE to retry failed commands, FALSE to transmit each command once
+ */
+void
+TPMIO_SetRetry(
+	_In_		BOOL				PfRetry);
+
 #ifdef __cplusplus
 }
 #endif
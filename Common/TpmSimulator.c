@@ -0,0 +1,1544 @@
+﻿/**
+ *	@brief		Implements the TPM simulator transports
+ *	@details	In-process model of an Infineon TPM2.0 for running the tool without TPM hardware
+ *	@file		TpmSimulator.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "TpmSimulator.h"
+#include "TpmTransport.h"
+#include "DeviceAccess.h"
+#include "TPM_TIS.h"
+#include "Platform.h"
+
+#include "TPM2_Marshal.h"
+#include "TPM2_FieldUpgradeTypes.h"
+#include "TPM2_FieldUpgradeMarshal.h"
+
+#include "TPM_Types.h"
+
+/// Size of a TPM command or response header (tag, size and command or response code)
+#define TPM_SIMULATOR_HEADER_SIZE					10
+/// Failure injection code of a FieldUpgrade sub command
+#define TPM_SIMULATOR_FIELD_UPGRADE_CODE(SUBCMD)	((TPM_CC_FieldUpgradeCommand << 8) | (SUBCMD))
+/// Default TPM_PT_FIRMWARE_VERSION_1 of the simulated TPM (7.85)
+#define TPM_SIMULATOR_DEFAULT_FIRMWARE_VERSION_1	0x00070055
+/// Default TPM_PT_FIRMWARE_VERSION_2 of the simulated TPM (4555.0)
+#define TPM_SIMULATOR_DEFAULT_FIRMWARE_VERSION_2	0x0011CB00
+/// Default field upgrade counter of the simulated TPM
+#define TPM_SIMULATOR_DEFAULT_FIELD_UPGRADE_COUNTER	64
+/// Maximum FieldUpgradeUpdate block size reported in wMaxDataSize
+#define TPM_SIMULATOR_MAX_DATA_SIZE					1024
+/// Handle of the simulated policy session
+#define TPM_SIMULATOR_POLICY_SESSION				0x03000000
+/// Manufacturer reported in TPM_PT_MANUFACTURER ("IFX")
+#define TPM_SIMULATOR_MANUFACTURER					0x49465800
+/// Burst count of the simulated TIS FIFO
+#define TPM_SIMULATOR_TIS_BURST_COUNT				64
+/// Device identifier of the simulated TIS registers
+#define TPM_SIMULATOR_TIS_DID						0x001B
+/// Revision identifier of the simulated TIS registers
+#define TPM_SIMULATOR_TIS_RID						0x10
+/// Marker for no active locality
+#define TPM_SIMULATOR_TIS_NO_LOCALITY				0xFF
+
+/**
+ *	@brief		States of the simulated TIS interface
+ *	@details
+ */
+typedef enum tdTpmSimulatorTisState
+{
+	/// No command in progress; TPM.STS.commandReady not set
+	TPM_SIMULATOR_TIS_IDLE,
+	/// Ready to receive a command
+	TPM_SIMULATOR_TIS_READY,
+	/// Receiving a command
+	TPM_SIMULATOR_TIS_RECEPTION,
+	/// Response available
+	TPM_SIMULATOR_TIS_COMPLETION
+} TpmSimulatorTisState;
+
+/**
+ *	@brief		State of the simulated TPM
+ *	@details
+ */
+typedef struct tdIfxTpmSimulator
+{
+	/// TPM2_Startup has been executed
+	BOOL					fStarted;
+	/// Security module status (SMS_FWCONFIG_ACTIVE or SMS_BTLDR_ACTIVE)
+	SecurityModuleStatus_d	usSecurityModuleStatus;
+	/// TPM_PT_FIRMWARE_VERSION_1
+	UINT32					unFirmwareVersion1;
+	/// TPM_PT_FIRMWARE_VERSION_2
+	UINT32					unFirmwareVersion2;
+	/// Remaining field upgrades
+	UINT16					usFieldUpgradeCounter;
+	/// Decrypt key identifier reported in the key list
+	DecryptKeyId_d			unDecryptKeyId;
+	/// TPM2_SetPrimaryPolicy has been executed for the platform hierarchy
+	BOOL					fPlatformPolicySet;
+	/// Policy session handle (0 if no session is loaded)
+	TPM_HANDLE				hPolicySession;
+	/// TPM2_PolicySecret has been executed for the policy session
+	BOOL					fPolicySecret;
+	/// TPM2_PolicyCommandCode(TPM2_CC_FieldUpgradeStartVendor) has been executed for the policy session
+	BOOL					fPolicyCommandCode;
+	/// Firmware bytes received by TPM_FieldUpgradeUpdate
+	UINT32					unFirmwareBytes;
+	/// Latency added to every command in microseconds
+	UINT32					unLatency;
+	/// Command code for failure injection (0 if disabled)
+	UINT32					unFailCommand;
+	/// Response code for failure injection
+	UINT32					unFailResponseCode;
+	/// Number of successful executions of the command before the failure is injected
+	UINT32					unFailAfter;
+	/// Number of executions of the failure injection command so far
+	UINT32					unFailMatches;
+	/// Active TIS locality (TPM_SIMULATOR_TIS_NO_LOCALITY if none)
+	BYTE					bTisLocality;
+	/// TIS interface state
+	TpmSimulatorTisState	eTisState;
+	/// TIS command or response buffer
+	BYTE					rgbTisBuffer[MAX_COMMAND_SIZE];
+	/// Received command bytes or available response bytes in rgbTisBuffer
+	unsigned int			unTisSize;
+	/// Read position of the response in rgbTisBuffer
+	unsigned int			unTisPosition;
+} IfxTpmSimulator;
+
+/**
+ *	@brief		Command being executed by the simulated TPM
+ *	@details
+ */
+typedef struct tdIfxTpmSimulatorCommand
+{
+	/// Request tag
+	TPM_ST		tag;
+	/// Request command code
+	TPM_CC		commandCode;
+	/// Current position in the request
+	BYTE*		pbRequest;
+	/// Remaining request bytes
+	INT32		nRequestSize;
+	/// Current position in the response parameters
+	BYTE*		pbResponse;
+	/// Remaining response buffer bytes
+	INT32		nResponseSize;
+} IfxTpmSimulatorCommand;
+
+/// State of the simulated TPM
+static IfxTpmSimulator s_sSimulator = {0};
+
+/**
+ *	@brief		Read a simulator setting
+ *	@details	Falls back to the default value if the property is not set.
+ *
+ *	@param		PwszKey			Property key
+ *	@param		PunDefault		Default value
+ *
+ *	@retval		The value of the property or the default value
+ */
+static
+UINT32
+TpmSimulator_GetSetting(
+	_In_z_	const wchar_t*	PwszKey,
+	_In_	UINT32			PunDefault)
+{
+	unsigned int unValue = 0;
+
+	if (FALSE == PropertyStorage_GetUIntegerValueByKey(PwszKey, &unValue))
+		unValue = PunDefault;
+
+	return unValue;
+}
+
+/**
+ *	@brief		Reset the simulated TPM
+ *	@details	Reads the PROPERTY_SIMULATOR_* properties and powers the simulated TPM up in firmware mode.
+ */
+static
+void
+TpmSimulator_Reset()
+{
+	IGNORE_RETURN_VALUE(Platform_MemorySet(&s_sSimulator, 0x00, sizeof(s_sSimulator)));
+
+	s_sSimulator.usSecurityModuleStatus = SMS_FWCONFIG_ACTIVE;
+	s_sSimulator.unFirmwareVersion1 = TpmSimulator_GetSetting(PROPERTY_SIMULATOR_FIRMWARE_VERSION_1, TPM_SIMULATOR_DEFAULT_FIRMWARE_VERSION_1);
+	s_sSimulator.unFirmwareVersion2 = TpmSimulator_GetSetting(PROPERTY_SIMULATOR_FIRMWARE_VERSION_2, TPM_SIMULATOR_DEFAULT_FIRMWARE_VERSION_2);
+	s_sSimulator.usFieldUpgradeCounter = (UINT16)TpmSimulator_GetSetting(PROPERTY_SIMULATOR_FIELD_UPGRADE_COUNTER, TPM_SIMULATOR_DEFAULT_FIELD_UPGRADE_COUNTER);
+	s_sSimulator.unDecryptKeyId = TpmSimulator_GetSetting(PROPERTY_SIMULATOR_DECRYPT_KEY_ID, 0);
+	s_sSimulator.unLatency = TpmSimulator_GetSetting(PROPERTY_SIMULATOR_LATENCY, 0);
+	s_sSimulator.unFailCommand = TpmSimulator_GetSetting(PROPERTY_SIMULATOR_FAIL_COMMAND, 0);
+	s_sSimulator.unFailResponseCode = TpmSimulator_GetSetting(PROPERTY_SIMULATOR_FAIL_RESPONSE_CODE, TPM_RC_FAILURE);
+	s_sSimulator.unFailAfter = TpmSimulator_GetSetting(PROPERTY_SIMULATOR_FAIL_AFTER, 0);
+	s_sSimulator.bTisLocality = TPM_SIMULATOR_TIS_NO_LOCALITY;
+	s_sSimulator.eTisState = TPM_SIMULATOR_TIS_IDLE;
+
+	LOGGING_WRITE_LEVEL4_FMT(L"TPM simulator: firmware version 0x%.8X 0x%.8X, latency %dus, failure injection command 0x%.8X",
+							s_sSimulator.unFirmwareVersion1, s_sSimulator.unFirmwareVersion2, s_sSimulator.unLatency, s_sSimulator.unFailCommand);
+}
+
+/**
+ *	@brief		Skip the authorization area of a request
+ *	@details	Requests with TPM_ST_NO_SESSIONS do not have an authorization area.
+ *
+ *	@param		PpCommand		Command being executed
+ *	@param		PphSession		Receives the handle of the first session (0 if there is none)
+ *
+ *	@retval		TPM_RC_SUCCESS			The operation completed successfully.
+ *	@retval		TPM_RC_AUTHSIZE			The authorization area is malformed.
+ */
+static
+TPM_RC
+TpmSimulator_SkipAuthorizationArea(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand,
+	_Out_	TPM_HANDLE*				PphSession)
+{
+	TPM_RC responseCode = TPM_RC_AUTHSIZE;
+
+	do
+	{
+		UINT32 unAuthorizationSize = 0;
+
+		*PphSession = 0;
+		if (TPM_ST_SESSIONS != PpCommand->tag)
+		{
+			responseCode = TPM_RC_SUCCESS;
+			break;
+		}
+
+		if (RC_SUCCESS != TSS_UINT32_Unmarshal(&unAuthorizationSize, &PpCommand->pbRequest, &PpCommand->nRequestSize) ||
+				unAuthorizationSize < sizeof(TPM_HANDLE) || unAuthorizationSize > (UINT32)PpCommand->nRequestSize)
+			break;
+		if (RC_SUCCESS != TSS_UINT32_Unmarshal(PphSession, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+			break;
+
+		// Nonce, attributes and HMAC are not evaluated
+		PpCommand->pbRequest += unAuthorizationSize - sizeof(TPM_HANDLE);
+		PpCommand->nRequestSize -= unAuthorizationSize - sizeof(TPM_HANDLE);
+		responseCode = TPM_RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Marshal the response parameter size and the acknowledgment of a command with sessions
+ *	@details	Commands without sessions only marshal their parameters.
+ *
+ *	@param		PpCommand			Command being executed
+ *	@param		PprgbParameters		Response parameters
+ *	@param		PunParametersSize	Size of the response parameters
+ *
+ *	@retval		TPM_RC_SUCCESS		The operation completed successfully.
+ *	@retval		TPM_RC_FAILURE		The response buffer is too small.
+ */
+static
+TPM_RC
+TpmSimulator_MarshalParameters(
+	_Inout_								IfxTpmSimulatorCommand*	PpCommand,
+	_In_bytecount_(PunParametersSize)	const BYTE*				PprgbParameters,
+	_In_								UINT32					PunParametersSize)
+{
+	TPM_RC responseCode = TPM_RC_FAILURE;
+
+	do
+	{
+		if (TPM_ST_SESSIONS == PpCommand->tag &&
+				RC_SUCCESS != TSS_UINT32_Marshal(&PunParametersSize, &PpCommand->pbResponse, &PpCommand->nResponseSize))
+			break;
+		if (0 != PunParametersSize &&
+				RC_SUCCESS != TSS_BYTE_Array_Marshal(PprgbParameters, &PpCommand->pbResponse, &PpCommand->nResponseSize, (INT32)PunParametersSize))
+			break;
+		if (TPM_ST_SESSIONS == PpCommand->tag)
+		{
+			// Acknowledgment: empty nonce, continueSession, empty HMAC
+			UINT16 usEmpty = 0;
+			BYTE bAttributes = 1;
+			if (RC_SUCCESS != TSS_UINT16_Marshal(&usEmpty, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TSS_UINT8_Marshal(&bAttributes, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TSS_UINT16_Marshal(&usEmpty, &PpCommand->pbResponse, &PpCommand->nResponseSize))
+				break;
+		}
+		responseCode = TPM_RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Marshal the Security Module Logic Info
+ *	@details	Marshals sSecurityModuleLogicInfo_d, or sSecurityModuleLogicInfo2_d if the key list is requested.
+ *
+ *	@param		PfKeyList		TRUE to append the key list (sSecurityModuleLogicInfo2_d)
+ *	@param		PprgbBuffer		Marshal position
+ *	@param		PpnBufferSize	Remaining buffer size
+ *
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		...				Error codes from marshal functions
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_MarshalSecurityModuleLogicInfo(
+	_In_	BOOL	PfKeyList,
+	_Inout_	BYTE**	PprgbBuffer,
+	_Inout_	INT32*	PpnBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		sSecurityModuleLogicInfo2_d sInfo;
+		UINT16 usIndex = 0;
+
+		unReturnValue = Platform_MemorySet(&sInfo, 0x00, sizeof(sInfo));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		sInfo.wMaxDataSize = TPM_SIMULATOR_MAX_DATA_SIZE;
+		sInfo.sSecurityModuleLogic.sFirmwareConfiguration.wEntries = 1;
+		sInfo.sSecurityModuleLogic.sFirmwareConfiguration.FirmwarePackage[0].Version = s_sSimulator.unFirmwareVersion1;
+		sInfo.SecurityModuleStatus = s_sSimulator.usSecurityModuleStatus;
+		sInfo.sProcessFirmwarePackage.Version = s_sSimulator.unFirmwareVersion1;
+		sInfo.wFieldUpgradeCounter = s_sSimulator.usFieldUpgradeCounter;
+		sInfo.sKeyList.wEntries = RG_LEN(sInfo.sKeyList.DecryptKeyId);
+		sInfo.sKeyList.DecryptKeyId[0] = s_sSimulator.unDecryptKeyId;
+
+		unReturnValue = TSS_UINT16_Marshal(&sInfo.internal1, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT16_Marshal(&sInfo.wMaxDataSize, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT16_Marshal(&sInfo.sSecurityModuleLogic.internal1, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT32_Marshal(&sInfo.sSecurityModuleLogic.internal2, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_BYTE_Array_Marshal(sInfo.sSecurityModuleLogic.internal3, PprgbBuffer, PpnBufferSize, sizeof(sInfo.sSecurityModuleLogic.internal3));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_sFirmwarePackage_d_Marshal(&sInfo.sSecurityModuleLogic.sBootloaderFirmwarePackage, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT16_Marshal(&sInfo.sSecurityModuleLogic.sFirmwareConfiguration.wEntries, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		for (usIndex = 0; usIndex < sInfo.sSecurityModuleLogic.sFirmwareConfiguration.wEntries && RC_SUCCESS == unReturnValue; usIndex++)
+			unReturnValue = TSS_sFirmwarePackage_d_Marshal(&sInfo.sSecurityModuleLogic.sFirmwareConfiguration.FirmwarePackage[usIndex], PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT16_Marshal(&sInfo.SecurityModuleStatus, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_sFirmwarePackage_d_Marshal(&sInfo.sProcessFirmwarePackage, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT16_Marshal(&sInfo.internal6, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_BYTE_Array_Marshal(sInfo.internal7, PprgbBuffer, PpnBufferSize, sizeof(sInfo.internal7));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT16_Marshal(&sInfo.wFieldUpgradeCounter, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue || FALSE == PfKeyList)
+			break;
+		unReturnValue = TSS_UINT16_Marshal(&sInfo.sKeyList.wEntries, PprgbBuffer, PpnBufferSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT32_Array_Marshal(sInfo.sKeyList.internal2, PprgbBuffer, PpnBufferSize, RG_LEN(sInfo.sKeyList.internal2));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT32_Array_Marshal(sInfo.sKeyList.DecryptKeyId, PprgbBuffer, PpnBufferSize, RG_LEN(sInfo.sKeyList.DecryptKeyId));
+		if (RC_SUCCESS != unReturnValue)
+			break;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Simulate TPM2_Startup
+ *	@details
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_Startup(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_SUCCESS;
+	UINT16 usStartupType = 0;
+
+	if (RC_SUCCESS != TSS_UINT16_Unmarshal(&usStartupType, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+		responseCode = TPM_RC_COMMAND_SIZE;
+	else if (s_sSimulator.fStarted)
+		responseCode = TPM_RC_INITIALIZE;
+	else
+		s_sSimulator.fStarted = TRUE;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate TPM2_GetCapability
+ *	@details	Supports TPM_CAP_TPM_PROPERTIES (manufacturer and firmware version) and TPM_CAP_VENDOR_PROPERTY (TPM_PT_VENDOR_FIX_SMLI2).
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_GetCapability(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_FAILURE;
+
+	do
+	{
+		UINT32 unCapability = 0;
+		UINT32 unProperty = 0;
+		UINT32 unPropertyCount = 0;
+		BYTE bMoreData = 0;
+
+		if (RC_SUCCESS != TSS_UINT32_Unmarshal(&unCapability, &PpCommand->pbRequest, &PpCommand->nRequestSize) ||
+				RC_SUCCESS != TSS_UINT32_Unmarshal(&unProperty, &PpCommand->pbRequest, &PpCommand->nRequestSize) ||
+				RC_SUCCESS != TSS_UINT32_Unmarshal(&unPropertyCount, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+		{
+			responseCode = TPM_RC_COMMAND_SIZE;
+			break;
+		}
+
+		if (TPM_CAP_TPM_PROPERTIES == unCapability)
+		{
+			// Supported properties in ascending order
+			const UINT32 rgunProperties[][2] =
+			{
+				{ TPM_PT_MANUFACTURER, TPM_SIMULATOR_MANUFACTURER },
+				{ TPM_PT_FIRMWARE_VERSION_1, s_sSimulator.unFirmwareVersion1 },
+				{ TPM_PT_FIRMWARE_VERSION_2, s_sSimulator.unFirmwareVersion2 }
+			};
+			UINT32 unFirst = 0;
+			UINT32 unCount = 0;
+			UINT32 unIndex = 0;
+
+			while (unFirst < RG_LEN(rgunProperties) && rgunProperties[unFirst][0] < unProperty)
+				unFirst++;
+			unCount = RG_LEN(rgunProperties) - unFirst;
+			if (unCount > unPropertyCount)
+			{
+				unCount = unPropertyCount;
+				bMoreData = 1;
+			}
+
+			if (RC_SUCCESS != TSS_UINT8_Marshal(&bMoreData, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TSS_UINT32_Marshal(&unCapability, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TSS_UINT32_Marshal(&unCount, &PpCommand->pbResponse, &PpCommand->nResponseSize))
+				break;
+			for (unIndex = unFirst; unIndex < unFirst + unCount; unIndex++)
+			{
+				if (RC_SUCCESS != TSS_UINT32_Array_Marshal(rgunProperties[unIndex], &PpCommand->pbResponse, &PpCommand->nResponseSize, 2))
+					break;
+			}
+			if (unIndex != unFirst + unCount)
+				break;
+		}
+		else if (TPM_CAP_VENDOR_PROPERTY == unCapability && (TPM_PT_VENDOR_FIX_SMLI2) == unProperty)
+		{
+			BYTE rgbInfo[sizeof(sSecurityModuleLogicInfo2_d)];
+			BYTE* pbInfo = rgbInfo;
+			INT32 nInfoSize = sizeof(rgbInfo);
+			UINT32 unCount = 1;
+			UINT16 usSize = 0;
+
+			if (RC_SUCCESS != TpmSimulator_MarshalSecurityModuleLogicInfo(TRUE, &pbInfo, &nInfoSize))
+				break;
+			usSize = (UINT16)(sizeof(rgbInfo) - nInfoSize);
+
+			if (RC_SUCCESS != TSS_UINT8_Marshal(&bMoreData, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TSS_UINT32_Marshal(&unCapability, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TSS_UINT32_Marshal(&unCount, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TSS_UINT16_Marshal(&usSize, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TSS_BYTE_Array_Marshal(rgbInfo, &PpCommand->pbResponse, &PpCommand->nResponseSize, usSize))
+				break;
+		}
+		else
+		{
+			responseCode = TPM_RC_VALUE | TPM_RC_P | TPM_RC_1;
+			break;
+		}
+
+		responseCode = TPM_RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate TPM2_StartAuthSession
+ *	@details	Only one session is simulated; starting a session replaces the former one.
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_StartAuthSession(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_FAILURE;
+
+	do
+	{
+		TPM_HANDLE hSession = TPM_SIMULATOR_POLICY_SESSION;
+		BYTE rgbNonce[16] = {0};
+		UINT16 usNonceSize = sizeof(rgbNonce);
+
+		// Parameters are not evaluated
+		if (RC_SUCCESS != TSS_UINT32_Marshal(&hSession, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+				RC_SUCCESS != TSS_UINT16_Marshal(&usNonceSize, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+				RC_SUCCESS != TSS_BYTE_Array_Marshal(rgbNonce, &PpCommand->pbResponse, &PpCommand->nResponseSize, usNonceSize))
+			break;
+
+		s_sSimulator.hPolicySession = hSession;
+		s_sSimulator.fPolicySecret = FALSE;
+		s_sSimulator.fPolicyCommandCode = FALSE;
+		responseCode = TPM_RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate TPM2_PolicySecret
+ *	@details
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_PolicySecret(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_COMMAND_SIZE;
+
+	do
+	{
+		TPM_HANDLE hAuthorization = 0;
+		TPM_HANDLE hPolicySession = 0;
+		TPM_HANDLE hSession = 0;
+		BYTE rgbParameters[10];
+		BYTE* pbParameters = rgbParameters;
+		INT32 nParametersSize = sizeof(rgbParameters);
+		UINT16 usEmpty = 0;
+		TPM_ST ticketTag = TPM_ST_AUTH_SECRET;
+		TPM_HANDLE hHierarchy = TPM_RH_NULL;
+
+		if (RC_SUCCESS != TSS_UINT32_Unmarshal(&hAuthorization, &PpCommand->pbRequest, &PpCommand->nRequestSize) ||
+				RC_SUCCESS != TSS_UINT32_Unmarshal(&hPolicySession, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+			break;
+		responseCode = TpmSimulator_SkipAuthorizationArea(PpCommand, &hSession);
+		if (TPM_RC_SUCCESS != responseCode)
+			break;
+		if (0 == s_sSimulator.hPolicySession || hPolicySession != s_sSimulator.hPolicySession)
+		{
+			responseCode = TPM_RC_HANDLE | TPM_RC_H | TPM_RC_2;
+			break;
+		}
+
+		// Empty timeout and a NULL ticket
+		if (RC_SUCCESS != TSS_UINT16_Marshal(&usEmpty, &pbParameters, &nParametersSize) ||
+				RC_SUCCESS != TSS_UINT16_Marshal(&ticketTag, &pbParameters, &nParametersSize) ||
+				RC_SUCCESS != TSS_UINT32_Marshal(&hHierarchy, &pbParameters, &nParametersSize) ||
+				RC_SUCCESS != TSS_UINT16_Marshal(&usEmpty, &pbParameters, &nParametersSize))
+		{
+			responseCode = TPM_RC_FAILURE;
+			break;
+		}
+		responseCode = TpmSimulator_MarshalParameters(PpCommand, rgbParameters, sizeof(rgbParameters));
+		if (TPM_RC_SUCCESS != responseCode)
+			break;
+
+		s_sSimulator.fPolicySecret = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate TPM2_PolicyCommandCode
+ *	@details
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_PolicyCommandCode(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_COMMAND_SIZE;
+
+	do
+	{
+		TPM_HANDLE hPolicySession = 0;
+		TPM_HANDLE hSession = 0;
+		TPM_CC commandCode = 0;
+
+		if (RC_SUCCESS != TSS_UINT32_Unmarshal(&hPolicySession, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+			break;
+		responseCode = TpmSimulator_SkipAuthorizationArea(PpCommand, &hSession);
+		if (TPM_RC_SUCCESS != responseCode)
+			break;
+		if (RC_SUCCESS != TSS_TPM_CC_Unmarshal(&commandCode, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+		{
+			responseCode = TPM_RC_COMMAND_SIZE;
+			break;
+		}
+		if (0 == s_sSimulator.hPolicySession || hPolicySession != s_sSimulator.hPolicySession)
+		{
+			responseCode = TPM_RC_HANDLE | TPM_RC_H | TPM_RC_1;
+			break;
+		}
+
+		responseCode = TpmSimulator_MarshalParameters(PpCommand, NULL, 0);
+		if (TPM_RC_SUCCESS != responseCode)
+			break;
+
+		s_sSimulator.fPolicyCommandCode = (TPM2_CC_FieldUpgradeStartVendor == commandCode);
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate TPM2_FlushContext
+ *	@details
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_FlushContext(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_SUCCESS;
+	TPM_HANDLE hFlush = 0;
+
+	if (RC_SUCCESS != TSS_UINT32_Unmarshal(&hFlush, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+		responseCode = TPM_RC_COMMAND_SIZE;
+	else if (0 == s_sSimulator.hPolicySession || hFlush != s_sSimulator.hPolicySession)
+		responseCode = TPM_RC_HANDLE | TPM_RC_P | TPM_RC_1;
+	else
+		s_sSimulator.hPolicySession = 0;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate TPM2_GetTestResult
+ *	@details	The simulated TPM always passes its self test.
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_GetTestResult(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_FAILURE;
+	UINT16 usOutDataSize = 0;
+	TPM_RC testResult = TPM_RC_SUCCESS;
+
+	if (RC_SUCCESS == TSS_UINT16_Marshal(&usOutDataSize, &PpCommand->pbResponse, &PpCommand->nResponseSize) &&
+			RC_SUCCESS == TSS_UINT32_Marshal(&testResult, &PpCommand->pbResponse, &PpCommand->nResponseSize))
+		responseCode = TPM_RC_SUCCESS;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate TPM2_HierarchyChangeAuth and TPM2_SetPrimaryPolicy
+ *	@details	The platform hierarchy authorization is always empty, so the new value is not stored.
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_PlatformHierarchy(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_COMMAND_SIZE;
+
+	do
+	{
+		TPM_HANDLE hAuthorization = 0;
+		TPM_HANDLE hSession = 0;
+
+		if (RC_SUCCESS != TSS_UINT32_Unmarshal(&hAuthorization, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+			break;
+		responseCode = TpmSimulator_SkipAuthorizationArea(PpCommand, &hSession);
+		if (TPM_RC_SUCCESS != responseCode)
+			break;
+		if (TPM_RH_PLATFORM != hAuthorization)
+		{
+			responseCode = TPM_RC_HANDLE | TPM_RC_H | TPM_RC_1;
+			break;
+		}
+
+		responseCode = TpmSimulator_MarshalParameters(PpCommand, NULL, 0);
+		if (TPM_RC_SUCCESS != responseCode)
+			break;
+
+		if (TPM_CC_SetPrimaryPolicy == PpCommand->commandCode)
+			s_sSimulator.fPlatformPolicySet = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate TPM2_FieldUpgradeStartVendor
+ *	@details	Requires the policy session prepared by FirmwareUpdate_PrepareTPM20Policy and switches to boot loader mode.
+ *				The signed data are not verified.
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_FieldUpgradeStartVendor(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_COMMAND_SIZE;
+
+	do
+	{
+		TPM_HANDLE hAuthorization = 0;
+		TPM_HANDLE hSession = 0;
+		SubCmd_d bSubCommand = 0;
+		UINT16 usSize = 0;
+		BYTE rgbParameters[2] = {0};
+
+		if (RC_SUCCESS != TSS_UINT32_Unmarshal(&hAuthorization, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+			break;
+		responseCode = TpmSimulator_SkipAuthorizationArea(PpCommand, &hSession);
+		if (TPM_RC_SUCCESS != responseCode)
+			break;
+		if (RC_SUCCESS != TSS_UINT8_Unmarshal(&bSubCommand, &PpCommand->pbRequest, &PpCommand->nRequestSize) ||
+				RC_SUCCESS != TSS_UINT16_Unmarshal(&usSize, &PpCommand->pbRequest, &PpCommand->nRequestSize) ||
+				usSize > PpCommand->nRequestSize)
+		{
+			responseCode = TPM_RC_COMMAND_SIZE;
+			break;
+		}
+		if (0 == hSession || hSession != s_sSimulator.hPolicySession || !s_sSimulator.fPlatformPolicySet ||
+				!s_sSimulator.fPolicySecret || !s_sSimulator.fPolicyCommandCode)
+		{
+			responseCode = TPM_RC_POLICY_FAIL | TPM_RC_S | TPM_RC_1;
+			break;
+		}
+		if (0 == s_sSimulator.usFieldUpgradeCounter)
+		{
+			responseCode = TPM_RC_VALUE | TPM_RC_P | TPM_RC_1;
+			break;
+		}
+
+		// The response parameter is an empty startSize
+		responseCode = TpmSimulator_MarshalParameters(PpCommand, rgbParameters, sizeof(rgbParameters));
+		if (TPM_RC_SUCCESS != responseCode)
+			break;
+
+		// Switch to boot loader mode, which drops all TPM2.0 state
+		s_sSimulator.usSecurityModuleStatus = SMS_BTLDR_ACTIVE;
+		s_sSimulator.fStarted = FALSE;
+		s_sSimulator.hPolicySession = 0;
+		s_sSimulator.unFirmwareBytes = 0;
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate the TPM1.2 FieldUpgrade vendor command
+ *	@details	Supports TPM_FieldUpgradeInfoRequest2 and, in boot loader mode, TPM_FieldUpgradeUpdate and TPM_FieldUpgradeComplete.
+ *
+ *	@param		PpCommand		Command being executed
+ *	@param		PbSubCommand	FieldUpgrade sub command
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_FieldUpgrade(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand,
+	_In_	SubCmd_d				PbSubCommand)
+{
+	TPM_RC responseCode = TPM_FAIL;
+
+	do
+	{
+		// The LRC covers the sub command, the data and the LRC itself
+		BYTE* pbLRCStart = PpCommand->pbRequest - sizeof(SubCmd_d);
+		UINT32 unLRCSize = (UINT32)PpCommand->nRequestSize + sizeof(SubCmd_d);
+		UINT16 usSize = 0;
+
+		if (RC_SUCCESS != TSS_UINT16_Unmarshal(&usSize, &PpCommand->pbRequest, &PpCommand->nRequestSize))
+		{
+			responseCode = TPM_BAD_PARAM_SIZE;
+			break;
+		}
+
+		if (TPM_FieldUpgradeInfoRequest2 == PbSubCommand)
+		{
+			BYTE* pbSize = PpCommand->pbResponse;
+			INT32 nResponseSize = PpCommand->nResponseSize;
+
+			// Marshal the size after the structure
+			if (RC_SUCCESS != TSS_UINT16_Marshal(&usSize, &PpCommand->pbResponse, &PpCommand->nResponseSize) ||
+					RC_SUCCESS != TpmSimulator_MarshalSecurityModuleLogicInfo(FALSE, &PpCommand->pbResponse, &PpCommand->nResponseSize))
+				break;
+			usSize = (UINT16)(nResponseSize - PpCommand->nResponseSize - sizeof(usSize));
+			if (RC_SUCCESS != TSS_UINT16_Marshal(&usSize, &pbSize, &nResponseSize))
+				break;
+		}
+		else if (TPM_FieldUpgradeUpdate == PbSubCommand || TPM_FieldUpgradeComplete == PbSubCommand)
+		{
+			if (SMS_BTLDR_ACTIVE != s_sSimulator.usSecurityModuleStatus)
+			{
+				responseCode = TPM_BAD_PARAMETER;
+				break;
+			}
+			if (usSize > TPM_SIMULATOR_MAX_DATA_SIZE || usSize + sizeof(BYTE) != (UINT32)PpCommand->nRequestSize)
+			{
+				responseCode = TPM_BAD_PARAM_SIZE;
+				break;
+			}
+			if (0 != TSS_CalcLRC(pbLRCStart, unLRCSize))
+			{
+				responseCode = TPM_BAD_PARAMETER;
+				break;
+			}
+
+			if (TPM_FieldUpgradeUpdate == PbSubCommand)
+				s_sSimulator.unFirmwareBytes += usSize;
+			else
+			{
+				UINT16 usOutCompleteSize = 0;
+				if (RC_SUCCESS != TSS_UINT16_Marshal(&usOutCompleteSize, &PpCommand->pbResponse, &PpCommand->nResponseSize))
+					break;
+
+				// The TPM restarts with the new firmware
+				LOGGING_WRITE_LEVEL4_FMT(L"TPM simulator: firmware update completed (%d bytes)", s_sSimulator.unFirmwareBytes);
+				s_sSimulator.usSecurityModuleStatus = SMS_FWCONFIG_ACTIVE;
+				s_sSimulator.usFieldUpgradeCounter--;
+				s_sSimulator.fPlatformPolicySet = FALSE;
+			}
+		}
+		else
+		{
+			responseCode = TPM_BAD_PARAMETER;
+			break;
+		}
+
+		responseCode = TPM_RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Simulate a TPM2.0 command
+ *	@details
+ *
+ *	@param		PpCommand		Command being executed
+ *
+ *	@retval		TPM response code
+ */
+static
+TPM_RC
+TpmSimulator_ExecuteTpm20(
+	_Inout_	IfxTpmSimulatorCommand*	PpCommand)
+{
+	TPM_RC responseCode = TPM_RC_SUCCESS;
+
+	if (TPM_CC_Startup != PpCommand->commandCode && !s_sSimulator.fStarted)
+		responseCode = TPM_RC_INITIALIZE;
+	else
+	{
+		switch (PpCommand->commandCode)
+		{
+			case TPM_CC_Startup:
+				responseCode = TpmSimulator_Startup(PpCommand);
+				break;
+			case TPM_CC_Shutdown:
+				break;
+			case TPM_CC_GetCapability:
+				responseCode = TpmSimulator_GetCapability(PpCommand);
+				break;
+			case TPM_CC_GetTestResult:
+				responseCode = TpmSimulator_GetTestResult(PpCommand);
+				break;
+			case TPM_CC_HierarchyChangeAuth:
+			case TPM_CC_SetPrimaryPolicy:
+				responseCode = TpmSimulator_PlatformHierarchy(PpCommand);
+				break;
+			case TPM_CC_StartAuthSession:
+				responseCode = TpmSimulator_StartAuthSession(PpCommand);
+				break;
+			case TPM_CC_PolicySecret:
+				responseCode = TpmSimulator_PolicySecret(PpCommand);
+				break;
+			case TPM_CC_PolicyCommandCode:
+				responseCode = TpmSimulator_PolicyCommandCode(PpCommand);
+				break;
+			case TPM_CC_FlushContext:
+				responseCode = TpmSimulator_FlushContext(PpCommand);
+				break;
+			case TPM2_CC_FieldUpgradeStartVendor:
+				responseCode = TpmSimulator_FieldUpgradeStartVendor(PpCommand);
+				break;
+			default:
+				responseCode = TPM_RC_COMMAND_CODE;
+				break;
+		}
+	}
+
+	return responseCode;
+}
+
+/**
+ *	@brief		Execute a command on the simulated TPM
+ *	@details	Applies the configured latency and failure injection. Error responses consist of the header only.
+ *
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function.
+ *	@retval		RC_E_BUFFER_TOO_SMALL	The response buffer cannot hold a response header.
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_Execute(
+	_In_bytecount_(PunRequestBufferSize)	const BYTE*		PrgbRequestBuffer,
+	_In_									unsigned int	PunRequestBufferSize,
+	_Out_bytecap_(*PpunResponseBufferSize)	BYTE*			PrgbResponseBuffer,
+	_Inout_									unsigned int*	PpunResponseBufferSize)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		IfxTpmSimulatorCommand sCommand;
+		TPM_RC responseCode = TPM_RC_SUCCESS;
+		TPM_ST tag = 0;
+		UINT32 unCommandSize = 0;
+		UINT32 unResponseSize = 0;
+		UINT32 unMatchCode = 0;
+		SubCmd_d bSubCommand = 0;
+		BOOL fTpm12Response = FALSE;
+		BYTE* pbHeader = PrgbResponseBuffer;
+		INT32 nHeaderSize = TPM_SIMULATOR_HEADER_SIZE;
+
+		if (NULL == PrgbRequestBuffer || NULL == PrgbResponseBuffer || NULL == PpunResponseBufferSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			break;
+		}
+		if (*PpunResponseBufferSize < TPM_SIMULATOR_HEADER_SIZE)
+		{
+			unReturnValue = RC_E_BUFFER_TOO_SMALL;
+			break;
+		}
+
+		if (0 != s_sSimulator.unLatency)
+			Platform_SleepMicroSeconds(s_sSimulator.unLatency);
+
+		// The unmarshal functions do not modify the buffer
+		sCommand.pbRequest = (BYTE*)PrgbRequestBuffer;
+		sCommand.nRequestSize = (INT32)PunRequestBufferSize;
+		sCommand.pbResponse = PrgbResponseBuffer + TPM_SIMULATOR_HEADER_SIZE;
+		sCommand.nResponseSize = (INT32)(*PpunResponseBufferSize - TPM_SIMULATOR_HEADER_SIZE);
+		sCommand.tag = 0;
+		sCommand.commandCode = 0;
+
+		if (RC_SUCCESS != TSS_TPM_ST_Unmarshal(&sCommand.tag, &sCommand.pbRequest, &sCommand.nRequestSize) ||
+				RC_SUCCESS != TSS_UINT32_Unmarshal(&unCommandSize, &sCommand.pbRequest, &sCommand.nRequestSize) ||
+				RC_SUCCESS != TSS_TPM_CC_Unmarshal(&sCommand.commandCode, &sCommand.pbRequest, &sCommand.nRequestSize) ||
+				unCommandSize != PunRequestBufferSize)
+			responseCode = TPM_RC_COMMAND_SIZE;
+		fTpm12Response = (TPM_TAG_RQU_COMMAND == sCommand.tag || SMS_BTLDR_ACTIVE == s_sSimulator.usSecurityModuleStatus);
+
+		// Determine the failure injection code
+		unMatchCode = sCommand.commandCode;
+		if (TPM_RC_SUCCESS == responseCode && TPM_TAG_RQU_COMMAND == sCommand.tag && TPM_CC_FieldUpgradeCommand == sCommand.commandCode)
+		{
+			if (RC_SUCCESS != TSS_UINT8_Unmarshal(&bSubCommand, &sCommand.pbRequest, &sCommand.nRequestSize))
+				responseCode = TPM_BAD_PARAM_SIZE;
+			unMatchCode = TPM_SIMULATOR_FIELD_UPGRADE_CODE(bSubCommand);
+		}
+
+		if (TPM_RC_SUCCESS != responseCode)
+		{
+			// Malformed header or sub command
+		}
+		else if (0 != s_sSimulator.unFailCommand && unMatchCode == s_sSimulator.unFailCommand && s_sSimulator.unFailMatches++ == s_sSimulator.unFailAfter)
+		{
+			LOGGING_WRITE_LEVEL4_FMT(L"TPM simulator: injecting response code 0x%.8X for command 0x%.8X", s_sSimulator.unFailResponseCode, unMatchCode);
+			responseCode = s_sSimulator.unFailResponseCode;
+		}
+		else if (TPM_TAG_RQU_COMMAND == sCommand.tag)
+		{
+			if (TPM_CC_FieldUpgradeCommand == sCommand.commandCode)
+				responseCode = TpmSimulator_FieldUpgrade(&sCommand, bSubCommand);
+			else
+				responseCode = TPM_BAD_ORDINAL;
+		}
+		else if (SMS_BTLDR_ACTIVE == s_sSimulator.usSecurityModuleStatus)
+			// The boot loader answers TPM2.0 commands like a TPM1.2 which failed its self test
+			responseCode = TPM_FAILEDSELFTEST;
+		else if (TPM_ST_NO_SESSIONS == sCommand.tag || TPM_ST_SESSIONS == sCommand.tag)
+			responseCode = TpmSimulator_ExecuteTpm20(&sCommand);
+		else
+			responseCode = TPM_RC_BAD_TAG;
+
+		// Marshal the header; error responses do not have parameters
+		if (TPM_RC_SUCCESS == responseCode)
+			unResponseSize = *PpunResponseBufferSize - (UINT32)sCommand.nResponseSize;
+		else
+			unResponseSize = TPM_SIMULATOR_HEADER_SIZE;
+		if (fTpm12Response)
+			tag = TPM_TAG_RSP_COMMAND;
+		else if (TPM_RC_SUCCESS == responseCode)
+			tag = sCommand.tag;
+		else
+			tag = TPM_ST_NO_SESSIONS;
+		unReturnValue = TSS_TPM_ST_Marshal(&tag, &pbHeader, &nHeaderSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT32_Marshal(&unResponseSize, &pbHeader, &nHeaderSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = TSS_UINT32_Marshal(&responseCode, &pbHeader, &nHeaderSize);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		*PpunResponseBufferSize = unResponseSize;
+	}
+	WHILE_FALSE_END;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Read a byte from the simulated TIS registers
+ *	@details	Registers of an inactive locality read as 0xFF, except TPM.ACCESS.
+ *
+ *	@param		PunMemoryAddress	Register address
+ *
+ *	@retval		Register value
+ */
+static
+BYTE
+TpmSimulator_TisReadByte(
+	_In_	unsigned int	PunMemoryAddress)
+{
+	BYTE bValue = 0xFF;
+	BYTE bLocality = (BYTE)((PunMemoryAddress - TIS_BASE_ADDRESS) >> 12);
+	unsigned int unRegister = (PunMemoryAddress - TIS_BASE_ADDRESS) & 0xFFF;
+
+	if (PunMemoryAddress < TIS_BASE_ADDRESS || bLocality > TIS_LOCALITY_4)
+	{
+		// Not a TIS register
+	}
+	else if (TIS_TPM_ACCESS == unRegister)
+		bValue = (BYTE)(TIS_TPM_ACCESS_VALID | (bLocality == s_sSimulator.bTisLocality ? TIS_TPM_ACCESS_ACTIVELOCALITY : 0));
+	else if (bLocality != s_sSimulator.bTisLocality)
+	{
+		// Inactive locality
+	}
+	else if (TIS_TPM_STS == unRegister)
+	{
+		bValue = TIS_TPM_STS_VALID;
+		if (TPM_SIMULATOR_TIS_READY == s_sSimulator.eTisState)
+			bValue |= TIS_TPM_STS_CMDRDY;
+		else if (TPM_SIMULATOR_TIS_RECEPTION == s_sSimulator.eTisState)
+		{
+			// Expect more data until the size in the command header has been received
+			if (s_sSimulator.unTisSize < 6 ||
+					s_sSimulator.unTisSize < (unsigned int)((s_sSimulator.rgbTisBuffer[2] << 24) | (s_sSimulator.rgbTisBuffer[3] << 16) |
+							(s_sSimulator.rgbTisBuffer[4] << 8) | s_sSimulator.rgbTisBuffer[5]))
+				bValue |= TIS_TPM_STS_EXPECT;
+		}
+		else if (TPM_SIMULATOR_TIS_COMPLETION == s_sSimulator.eTisState && s_sSimulator.unTisPosition < s_sSimulator.unTisSize)
+			bValue |= TIS_TPM_STS_AVAIL;
+	}
+	else if (TIS_TPM_BURSTCOUNT == unRegister || TIS_TPM_BURSTCOUNT + 1 == unRegister)
+	{
+		unsigned int unBurstCount = 0;
+		if (TPM_SIMULATOR_TIS_READY == s_sSimulator.eTisState || TPM_SIMULATOR_TIS_RECEPTION == s_sSimulator.eTisState)
+			unBurstCount = TPM_SIMULATOR_TIS_BURST_COUNT;
+		else if (TPM_SIMULATOR_TIS_COMPLETION == s_sSimulator.eTisState)
+			{
+			unBurstCount = s_sSimulator.unTisSize - s_sSimulator.unTisPosition;
+			if (unBurstCount > TPM_SIMULATOR_TIS_BURST_COUNT)
+				unBurstCount = TPM_SIMULATOR_TIS_BURST_COUNT;
+		}
+		bValue = (BYTE)(TIS_TPM_BURSTCOUNT == unRegister ? unBurstCount : unBurstCount >> 8);
+	}
+	else if (unRegister >= TIS_TPM_INTF_CAPABILITY && unRegister < TIS_TPM_INTF_CAPABILITY + sizeof(UINT32))
+		// TIS 1.3 interface with legacy (byte) transfer size
+		bValue = (BYTE)(TIS_TPM_INTF_CAPABILITY_VERSION_TIS13 >> ((unRegister - TIS_TPM_INTF_CAPABILITY) * 8));
+	else if ((unRegister >= TIS_TPM_DATA_FIFO && unRegister < TIS_TPM_DATA_FIFO + sizeof(UINT32)) ||
+			(unRegister >= TIS_TPM_XDATA_FIFO && unRegister < TIS_TPM_XDATA_FIFO + 0x40))
+	{
+		if (TPM_SIMULATOR_TIS_COMPLETION == s_sSimulator.eTisState && s_sSimulator.unTisPosition < s_sSimulator.unTisSize)
+			bValue = s_sSimulator.rgbTisBuffer[s_sSimulator.unTisPosition++];
+	}
+	else if (TIS_TPM_VID == unRegister || TIS_TPM_VID + 1 == unRegister)
+		bValue = (BYTE)(TIS_TPM_VID == unRegister ? TIS_TPM_VID_IFX : TIS_TPM_VID_IFX >> 8);
+	else if (TIS_TPM_DID == unRegister || TIS_TPM_DID + 1 == unRegister)
+		bValue = (BYTE)(TIS_TPM_DID == unRegister ? TPM_SIMULATOR_TIS_DID : TPM_SIMULATOR_TIS_DID >> 8);
+	else if (TIS_TPM_RID == unRegister)
+		bValue = TPM_SIMULATOR_TIS_RID;
+	else
+		bValue = 0;
+
+	return bValue;
+}
+
+/**
+ *	@brief		Write a byte to the simulated TIS registers
+ *	@details	TPM.STS.tpmGo executes the received command synchronously.
+ *
+ *	@param		PunMemoryAddress	Register address
+ *	@param		PbData				Register value
+ */
+static
+void
+TpmSimulator_TisWriteByte(
+	_In_	unsigned int	PunMemoryAddress,
+	_In_	BYTE			PbData)
+{
+	BYTE bLocality = (BYTE)((PunMemoryAddress - TIS_BASE_ADDRESS) >> 12);
+	unsigned int unRegister = (PunMemoryAddress - TIS_BASE_ADDRESS) & 0xFFF;
+
+	if (PunMemoryAddress < TIS_BASE_ADDRESS || bLocality > TIS_LOCALITY_4)
+	{
+		// Not a TIS register
+	}
+	else if (TIS_TPM_ACCESS == unRegister)
+	{
+		if ((PbData & TIS_TPM_ACCESS_REQUESTUSE) && TPM_SIMULATOR_TIS_NO_LOCALITY == s_sSimulator.bTisLocality)
+			s_sSimulator.bTisLocality = bLocality;
+		else if ((PbData & TIS_TPM_ACCESS_ACTIVELOCALITY) && bLocality == s_sSimulator.bTisLocality)
+		{
+			s_sSimulator.bTisLocality = TPM_SIMULATOR_TIS_NO_LOCALITY;
+			s_sSimulator.eTisState = TPM_SIMULATOR_TIS_IDLE;
+		}
+	}
+	else if (bLocality != s_sSimulator.bTisLocality)
+	{
+		// Inactive locality
+	}
+	else if (TIS_TPM_STS == unRegister)
+	{
+		if (PbData & TIS_TPM_STS_CMDRDY)
+		{
+			s_sSimulator.eTisState = TPM_SIMULATOR_TIS_READY;
+			s_sSimulator.unTisSize = 0;
+			s_sSimulator.unTisPosition = 0;
+		}
+		else if ((PbData & TIS_TPM_STS_GO) && TPM_SIMULATOR_TIS_RECEPTION == s_sSimulator.eTisState)
+		{
+			BYTE rgbResponse[MAX_RESPONSE_SIZE];
+			unsigned int unResponseSize = sizeof(rgbResponse);
+
+			if (RC_SUCCESS != TpmSimulator_Execute(s_sSimulator.rgbTisBuffer, s_sSimulator.unTisSize, rgbResponse, &unResponseSize))
+				unResponseSize = 0;
+			IGNORE_RETURN_VALUE(Platform_MemoryCopy(s_sSimulator.rgbTisBuffer, sizeof(s_sSimulator.rgbTisBuffer), rgbResponse, unResponseSize));
+			s_sSimulator.unTisSize = unResponseSize;
+			s_sSimulator.unTisPosition = 0;
+			s_sSimulator.eTisState = TPM_SIMULATOR_TIS_COMPLETION;
+		}
+		else if ((PbData & TIS_TPM_STS_RETRY) && TPM_SIMULATOR_TIS_COMPLETION == s_sSimulator.eTisState)
+			s_sSimulator.unTisPosition = 0;
+	}
+	else if ((unRegister >= TIS_TPM_DATA_FIFO && unRegister < TIS_TPM_DATA_FIFO + sizeof(UINT32)) ||
+			(unRegister >= TIS_TPM_XDATA_FIFO && unRegister < TIS_TPM_XDATA_FIFO + 0x40))
+	{
+		if (TPM_SIMULATOR_TIS_READY == s_sSimulator.eTisState)
+			s_sSimulator.eTisState = TPM_SIMULATOR_TIS_RECEPTION;
+		if (TPM_SIMULATOR_TIS_RECEPTION == s_sSimulator.eTisState && s_sSimulator.unTisSize < sizeof(s_sSimulator.rgbTisBuffer))
+			s_sSimulator.rgbTisBuffer[s_sSimulator.unTisSize++] = PbData;
+	}
+}
+
+/**
+ *	@brief		Initialize the command level simulator transport
+ *	@details
+ *
+ *	@param		PpState		Transport state
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_Initialize(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	UNREFERENCED_PARAMETER(PpState);
+
+	TpmSimulator_Reset();
+
+	return RC_SUCCESS;
+}
+
+/**
+ *	@brief		Uninitialize the command level simulator transport
+ *	@details
+ *
+ *	@param		PpState		Transport state
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_Uninitialize(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	UNREFERENCED_PARAMETER(PpState);
+
+	return RC_SUCCESS;
+}
+
+/**
+ *	@brief		Transmit a TPM command to the command level simulator transport
+ *	@details
+ *
+ *	@param		PpState					Transport state
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds (not used by the simulator)
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from TpmSimulator_Execute
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_Transmit(
+	_Inout_										IfxTpmTransportState*	PpState,
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*				PrgbRequestBuffer,
+	_In_										unsigned int			PunRequestBufferSize,
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*					PrgbResponseBuffer,
+	_Inout_										unsigned int*			PpunResponseBufferSize,
+	_In_										unsigned int			PunMaxDuration)
+{
+	UNREFERENCED_PARAMETER(PpState);
+	UNREFERENCED_PARAMETER(PunMaxDuration);
+
+	return TpmSimulator_Execute(PrgbRequestBuffer, PunRequestBufferSize, PrgbResponseBuffer, PpunResponseBufferSize);
+}
+
+/**
+ *	@brief		Initialize the TIS simulator transport
+ *	@details	Routes the register accesses of DeviceAccess to the simulated TIS registers and checks TPM.ACCESS.VALID.
+ *
+ *	@param		PpState		Transport state
+ *
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		RC_E_FAIL		The locality could not be retrieved.
+ *	@retval		RC_E_NOT_READY	TPM.ACCESS is not valid.
+ *	@retval		...				Error codes from DeviceAccess_Initialize and TIS
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_TisInitialize(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	do
+	{
+		unsigned int unLocality = 0;
+		BOOL bFlag = FALSE;
+
+		TpmSimulator_Reset();
+		DeviceAccess_SetRegisterHandlers(&TpmSimulator_TisReadByte, &TpmSimulator_TisWriteByte);
+
+		// Get the selected locality for TPM access
+		if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_LOCALITY, &unLocality))
+		{
+			unReturnValue = RC_E_FAIL;
+			break;
+		}
+		PpState->bLocality = (BYTE)unLocality;
+
+		unReturnValue = DeviceAccess_Initialize(PpState->bLocality);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = TIS_IsAccessValid(PpState->bLocality, &bFlag);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		if (!bFlag)
+		{
+			unReturnValue = RC_E_NOT_READY;
+			break;
+		}
+	}
+	WHILE_FALSE_END;
+
+	if (RC_SUCCESS != unReturnValue)
+		DeviceAccess_SetRegisterHandlers(NULL, NULL);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Uninitialize the TIS simulator transport
+ *	@details	Restores memory based register accesses of DeviceAccess.
+ *
+ *	@param		PpState		Transport state
+ *
+ *	@retval		RC_SUCCESS	The operation completed successfully.
+ *	@retval		...			Error codes from DeviceAccess_Uninitialize
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_TisUninitialize(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	unsigned int unReturnValue = DeviceAccess_Uninitialize(PpState->bLocality);
+	DeviceAccess_SetRegisterHandlers(NULL, NULL);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Transmit a TPM command through the TIS simulator transport
+ *	@details
+ *
+ *	@param		PpState					Transport state
+ *	@param		PrgbRequestBuffer		Pointer to a byte array containing the TPM command request bytes
+ *	@param		PunRequestBufferSize	Size of command request in bytes
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from TIS_TransceiveLPC
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_TisTransmit(
+	_Inout_										IfxTpmTransportState*	PpState,
+	_In_bytecount_(PunRequestBufferSize)		const BYTE*				PrgbRequestBuffer,
+	_In_										unsigned int			PunRequestBufferSize,
+	_Out_bytecap_(*PpunResponseBufferSize)		BYTE*					PrgbResponseBuffer,
+	_Inout_										unsigned int*			PpunResponseBufferSize,
+	_In_										unsigned int			PunMaxDuration)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	UINT16 usResponseSize = *PpunResponseBufferSize > 0xFFFF ? 0xFFFF : (UINT16)*PpunResponseBufferSize;
+
+	unReturnValue = TIS_TransceiveLPC(PpState->bLocality, PrgbRequestBuffer, (UINT16)PunRequestBufferSize, PrgbResponseBuffer, &usResponseSize, PunMaxDuration);
+	if (RC_SUCCESS == unReturnValue)
+		*PpunResponseBufferSize = usResponseSize;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Send the pending TPM command through the TIS simulator transport
+ *	@details
+ *
+ *	@param		PpState					Transport state
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from TIS_SendLPC
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_TisSend(
+	_Inout_	IfxTpmTransportState*	PpState)
+{
+	unsigned int unReturnValue = TIS_SendLPC(PpState->bLocality, PpState->pbPendingRequest, (UINT16)PpState->unPendingRequestSize);
+	if (RC_SUCCESS == unReturnValue)
+		PpState->fPendingRequestSent = TRUE;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Receive the response of the pending TPM command through the TIS simulator transport
+ *	@details
+ *
+ *	@param		PpState					Transport state
+ *	@param		PrgbResponseBuffer		Pointer to a byte array receiving the TPM command response bytes
+ *	@param		PpunResponseBufferSize	Input size of response buffer, output size of TPM command response in bytes
+ *	@param		PunMaxDuration			The maximum duration of the command in microseconds
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		...						Error codes from TIS_ReceiveLPC
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_TisReceive(
+	_Inout_									IfxTpmTransportState*	PpState,
+	_Out_bytecap_(*PpunResponseBufferSize)	BYTE*					PrgbResponseBuffer,
+	_Inout_									unsigned int*			PpunResponseBufferSize,
+	_In_									unsigned int			PunMaxDuration)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	UINT16 usResponseSize = *PpunResponseBufferSize > 0xFFFF ? 0xFFFF : (UINT16)*PpunResponseBufferSize;
+
+	unReturnValue = TIS_ReceiveLPC(PpState->bLocality, PrgbResponseBuffer, &usResponseSize, PunMaxDuration);
+	if (RC_SUCCESS == unReturnValue)
+		*PpunResponseBufferSize = usResponseSize;
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Read a simulated TIS register
+ *	@details
+ *
+ *	@param		PpState				Transport state
+ *	@param		PunRegisterAddress	Address of the register
+ *	@param		PpbRegisterValue	Receives the register value
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_TisReadRegister(
+	_Inout_	IfxTpmTransportState*	PpState,
+	_In_	unsigned int			PunRegisterAddress,
+	_Out_	BYTE*					PpbRegisterValue)
+{
+	UNREFERENCED_PARAMETER(PpState);
+
+	*PpbRegisterValue = DeviceAccess_ReadByte(PunRegisterAddress);
+
+	return RC_SUCCESS;
+}
+
+/**
+ *	@brief		Write a simulated TIS register
+ *	@details
+ *
+ *	@param		PpState				Transport state
+ *	@param		PunRegisterAddress	Address of the register
+ *	@param		PbRegisterValue		Value to write
+ *
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ */
+_Check_return_
+static
+unsigned int
+TpmSimulator_TisWriteRegister(
+	_Inout_	IfxTpmTransportState*	PpState,
+	_In_	unsigned int			PunRegisterAddress,
+	_In_	BYTE					PbRegisterValue)
+{
+	UNREFERENCED_PARAMETER(PpState);
+
+	DeviceAccess_WriteByte(PunRegisterAddress, PbRegisterValue);
+
+	return RC_SUCCESS;
+}
+
+/// Command level simulator transport
+static const IfxTpmTransport s_sTransportSimulator =
+{
+	TPM_DEVICE_ACCESS_SIMULATOR,
+	L"TPM simulator",
+	&TpmSimulator_Initialize,
+	&TpmSimulator_Uninitialize,
+	&TpmSimulator_Transmit,
+	NULL,
+	NULL
+};
+
+/// TIS register level simulator transport
+static const IfxTpmTransport s_sTransportSimulatorTis =
+{
+	TPM_DEVICE_ACCESS_SIMULATOR_TIS,
+	L"TPM simulator (TIS)",
+	&TpmSimulator_TisInitialize,
+	&TpmSimulator_TisUninitialize,
+	&TpmSimulator_TisTransmit,
+	&TpmSimulator_TisReadRegister,
+	&TpmSimulator_TisWriteRegister,
+	&TpmSimulator_TisSend,
+	&TpmSimulator_TisReceive
+};
+
+/**
+ *	@brief		Register the simulator transports
+ *	@details	Registers the transports for TPM_DEVICE_ACCESS_SIMULATOR and TPM_DEVICE_ACCESS_SIMULATOR_TIS with TPM I/O.
+ *
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		...				Error codes from TPMIO_RegisterTransport
+ */
+_Check_return_
+unsigned int
+TpmSimulator_Register()
+{
+	unsigned int unReturnValue = TPMIO_RegisterTransport(&s_sTransportSimulator);
+	if (RC_SUCCESS == unReturnValue)
+		unReturnValue = TPMIO_RegisterTransport(&s_sTransportSimulatorTis);
+
+	return unReturnValue;
+}
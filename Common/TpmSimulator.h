@@ -0,0 +1,57 @@
+﻿/**
+ *	@brief		Declares the TPM simulator transports
+ *	@details	In-process model of an Infineon TPM2.0 for running the tool without TPM hardware
+ *	@file		TpmSimulator.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Define for the simulator latency property (microseconds added to every command)
+#define PROPERTY_SIMULATOR_LATENCY					L"SimulatorLatency"
+/// Define for the simulator failure injection command property (TPM2.0 command code or FieldUpgrade sub command as 0xAAxx)
+#define PROPERTY_SIMULATOR_FAIL_COMMAND				L"SimulatorFailCommand"
+/// Define for the simulator failure injection response code property
+#define PROPERTY_SIMULATOR_FAIL_RESPONSE_CODE		L"SimulatorFailResponseCode"
+/// Define for the simulator failure injection property counting the successful executions before the failure
+#define PROPERTY_SIMULATOR_FAIL_AFTER				L"SimulatorFailAfter"
+/// Define for the simulator TPM_PT_FIRMWARE_VERSION_1 property
+#define PROPERTY_SIMULATOR_FIRMWARE_VERSION_1		L"SimulatorFirmwareVersion1"
+/// Define for the simulator TPM_PT_FIRMWARE_VERSION_2 property
+#define PROPERTY_SIMULATOR_FIRMWARE_VERSION_2		L"SimulatorFirmwareVersion2"
+/// Define for the simulator field upgrade counter property
+#define PROPERTY_SIMULATOR_FIELD_UPGRADE_COUNTER	L"SimulatorFieldUpgradeCounter"
+/// Define for the simulator decrypt key identifier property
+#define PROPERTY_SIMULATOR_DECRYPT_KEY_ID			L"SimulatorDecryptKeyId"
+
+/**
+ *	@brief		Register the simulator transports
+ *	@details	Registers the transports for TPM_DEVICE_ACCESS_SIMULATOR and TPM_DEVICE_ACCESS_SIMULATOR_TIS with TPM I/O.
+ *				Both transports are backed by the same in-process model of an Infineon TPM2.0 which answers the commands
+ *				used by the tool (Startup, GetCapability, policy session, FieldUpgrade vendor commands). The first one
+ *				executes the commands directly, the second one runs the TIS protocol (TPM_TIS.c) against simulated
+ *				TIS registers. The model is configured from the PROPERTY_SIMULATOR_* properties on connect.
+ *
+ *	@retval		RC_SUCCESS		The operation completed successfully.
+ *	@retval		...				Error codes from TPMIO_RegisterTransport
+ */
+_Check_return_
+unsigned int
+TpmSimulator_Register();
+
+#ifdef __cplusplus
+}
+#endif
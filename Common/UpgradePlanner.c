@@ -0,0 +1,330 @@
+﻿/**
+ *	@brief		Implements the firmware upgrade planner
+ *	@details	Searches the catalog index for the sequence of firmware images with the fewest updates to a target version
+ *	@file		UpgradePlanner.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "UpgradePlanner.h"
+#include "FirmwareUpdate.h"
+#include "Logging.h"
+#include "Platform.h"
+
+/// Marks a node which has not been reached with the current number of updates
+#define UPGRADE_PLANNER_UNREACHED			0xFFFFFFFF
+/// Number of edges the edge list grows by
+#define UPGRADE_PLANNER_EDGES_INCREMENT		64
+
+/// Node of the upgrade graph (TPM family and firmware version)
+typedef struct tdIfxUpgradePlannerNode
+{
+	/// TPM family
+	BYTE bTpmFamily;
+	/// TPM firmware version
+	const wchar_t* pwszVersion;
+} IfxUpgradePlannerNode;
+
+/// Edge of the upgrade graph (firmware image installable on the source node)
+typedef struct tdIfxUpgradePlannerEdge
+{
+	/// Index of the source node
+	unsigned int unSourceNode;
+	/// Index of the image, the target node is the node of the image's target version
+	unsigned int unImage;
+} IfxUpgradePlannerEdge;
+
+/**
+ *	@brief		Check whether a firmware image can be installed on a TPM family and firmware version
+ *	@details	The version must match a source version of the image with FirmwareCatalog_MatchesSourceVersion.
+ *
+ *	@param		PpImage				Firmware image
+ *	@param		PbTpmFamily			TPM family
+ *	@param		PwszVersion			TPM firmware version
+ *
+ *	@retval		TRUE				The image can be installed.
+ *	@retval		FALSE				Otherwise.
+ */
+static
+BOOL
+UpgradePlanner_MatchesSource(
+	_In_	const IfxFirmwareCatalogImage*	PpImage,
+	_In_	BYTE							PbTpmFamily,
+	_In_z_	const wchar_t*					PwszVersion)
+{
+	BOOL fMatch = FALSE;
+	unsigned int unIndex = 0;
+
+	if (PbTpmFamily == PpImage->bSourceTpmFamily)
+	{
+		for (unIndex = 0; unIndex < PpImage->unSourceVersionsCount && !fMatch; unIndex++)
+			fMatch = FirmwareCatalog_MatchesSourceVersion(PpImage->rgwszSourceVersions[unIndex], PwszVersion);
+	}
+
+	return fMatch;
+}
+
+/**
+ *	@brief		Compute the upgrade plan from the current TPM firmware to a target firmware version
+ *	@details	Builds a graph of all current images in the catalog index of the firmware folder. The nodes are the TPM
+ *				family and firmware version pairs, each image is an edge from every source version to its target version.
+ *				Source versions match with and without subversion.minor like in FirmwareUpdate_IsFirmwareUpdatable.
+ *				Every update uses up one of the remaining field upgrades, so the plan with the fewest updates wins and the
+ *				estimated duration (UPGRADE_PLANNER_HOP_SECONDS plus the image size at UPGRADE_PLANNER_BYTES_PER_SECOND)
+ *				decides between plans with the same number of updates. Plans with more updates than PunRemainingUpdates
+ *				are rejected.
+ *
+ *	@param		PwszFolder				Firmware folder with the catalog index
+ *	@param		PbSourceFamily			Current TPM family (DEVICE_TYPE_TPM_12 or DEVICE_TYPE_TPM_20)
+ *	@param		PwszSourceVersion		Current TPM firmware version (e.g. "7.85.4555.0")
+ *	@param		PwszTargetVersion		Target TPM firmware version
+ *	@param		PunRemainingUpdates		Remaining field upgrades of the TPM or REMAINING_UPDATES_UNAVAILABLE
+ *	@param		PpsPlan					Receives the upgrade plan
+ *	@retval		RC_SUCCESS						The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER				An invalid parameter was passed to the function.
+ *	@retval		RC_E_FILE_NOT_FOUND				The folder does not contain a valid catalog index.
+ *	@retval		RC_E_FIRMWARE_UPDATE_NOT_FOUND	No plan reaches the target version within the remaining field upgrades.
+ *	@retval		RC_E_FAIL						An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+UpgradePlanner_Plan(
+	_In_z_	const wchar_t*		PwszFolder,
+	_In_	BYTE				PbSourceFamily,
+	_In_z_	const wchar_t*		PwszSourceVersion,
+	_In_z_	const wchar_t*		PwszTargetVersion,
+	_In_	unsigned int		PunRemainingUpdates,
+	_Out_	IfxUpgradePlan*		PpsPlan)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	IfxFirmwareCatalogImage* rgsImages = NULL;
+	IfxUpgradePlannerNode* rgsNodes = NULL;
+	IfxUpgradePlannerEdge* rgsEdges = NULL;
+	unsigned int* rgunImageTargetNode = NULL;
+	unsigned int* rgunSeconds = NULL;
+	unsigned int* rgunPredecessorEdge = NULL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		unsigned int unImageCount = 0;
+		unsigned int unNodeCount = 0;
+		unsigned int unEdgeCount = 0;
+		unsigned int unEdgeCapacity = 0;
+		unsigned int unTargetNode = UPGRADE_PLANNER_UNREACHED;
+		unsigned int unMaxHops = UPGRADE_PLANNER_MAX_HOPS;
+		unsigned int unHops = 0;
+		unsigned int unImage = 0;
+		unsigned int unNode = 0;
+		unsigned int unEdge = 0;
+		BOOL fReached = FALSE;
+
+		// Check parameters
+		if (PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszFolder) || PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszSourceVersion) ||
+				PLATFORM_STRING_IS_NULL_OR_EMPTY(PwszTargetVersion) || NULL == PpsPlan)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Bad parameter detected.");
+			break;
+		}
+		IGNORE_RETURN_VALUE(Platform_MemorySet(PpsPlan, 0, sizeof(IfxUpgradePlan)));
+
+		// Every update uses up one field upgrade
+		if (REMAINING_UPDATES_UNAVAILABLE != PunRemainingUpdates && PunRemainingUpdates < unMaxHops)
+			unMaxHops = PunRemainingUpdates;
+
+		unReturnValue = FirmwareCatalog_GetImages(PwszFolder, &rgsImages, &unImageCount);
+		if (RC_SUCCESS != unReturnValue)
+		{
+			if (RC_E_FILE_NOT_FOUND == unReturnValue)
+				ERROR_STORE_FMT(unReturnValue, L"The firmware folder '%ls' does not contain a valid catalog index. Run -build-index first.", PwszFolder);
+			else
+				ERROR_STORE(unReturnValue, L"FirmwareCatalog_GetImages returned an unexpected value.");
+			break;
+		}
+
+		// Node 0 is the current firmware, the other nodes are the distinct target versions of the images
+		rgsNodes = (IfxUpgradePlannerNode*)Platform_MemoryAllocateZero((unImageCount + 1) * sizeof(IfxUpgradePlannerNode));
+		rgunImageTargetNode = (unsigned int*)Platform_MemoryAllocateZero((unImageCount + 1) * sizeof(unsigned int));
+		if (NULL == rgsNodes || NULL == rgunImageTargetNode)
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE(unReturnValue, L"Memory allocation failed.");
+			break;
+		}
+		rgsNodes[0].bTpmFamily = PbSourceFamily;
+		rgsNodes[0].pwszVersion = PwszSourceVersion;
+		unNodeCount = 1;
+		for (unImage = 0; unImage < unImageCount; unImage++)
+		{
+			for (unNode = 0; unNode < unNodeCount; unNode++)
+			{
+				if (rgsNodes[unNode].bTpmFamily == rgsImages[unImage].bTargetTpmFamily &&
+						0 == Platform_StringCompare(rgsNodes[unNode].pwszVersion, rgsImages[unImage].wszTargetVersion, MAX_NAME, FALSE))
+					break;
+			}
+			if (unNode == unNodeCount)
+			{
+				rgsNodes[unNode].bTpmFamily = rgsImages[unImage].bTargetTpmFamily;
+				rgsNodes[unNode].pwszVersion = rgsImages[unImage].wszTargetVersion;
+				unNodeCount++;
+			}
+			rgunImageTargetNode[unImage] = unNode;
+			if (0 == Platform_StringCompare(rgsImages[unImage].wszTargetVersion, PwszTargetVersion, MAX_NAME, FALSE))
+				unTargetNode = unNode;
+		}
+		if (UPGRADE_PLANNER_UNREACHED == unTargetNode)
+		{
+			unReturnValue = RC_E_FIRMWARE_UPDATE_NOT_FOUND;
+			ERROR_STORE_FMT(unReturnValue, L"No firmware image in the catalog index of '%ls' updates to %ls.", PwszFolder, PwszTargetVersion);
+			break;
+		}
+
+		// Collect the edges: every node an image can be installed on
+		for (unImage = 0; unImage < unImageCount; unImage++)
+		{
+			for (unNode = 0; unNode < unNodeCount; unNode++)
+			{
+				if (!UpgradePlanner_MatchesSource(&rgsImages[unImage], rgsNodes[unNode].bTpmFamily, rgsNodes[unNode].pwszVersion))
+					continue;
+
+				if (unEdgeCount == unEdgeCapacity)
+				{
+					IfxUpgradePlannerEdge* rgsNewEdges = (IfxUpgradePlannerEdge*)Platform_MemoryAllocateZero((unEdgeCapacity + UPGRADE_PLANNER_EDGES_INCREMENT) * sizeof(IfxUpgradePlannerEdge));
+					if (NULL == rgsNewEdges)
+						break;
+					if (0 != unEdgeCount)
+						IGNORE_RETURN_VALUE(Platform_MemoryCopy(rgsNewEdges, (unEdgeCapacity + UPGRADE_PLANNER_EDGES_INCREMENT) * sizeof(IfxUpgradePlannerEdge), rgsEdges, unEdgeCount * sizeof(IfxUpgradePlannerEdge)));
+					Platform_MemoryFree((void**)&rgsEdges);
+					rgsEdges = rgsNewEdges;
+					unEdgeCapacity += UPGRADE_PLANNER_EDGES_INCREMENT;
+				}
+				rgsEdges[unEdgeCount].unSourceNode = unNode;
+				rgsEdges[unEdgeCount].unImage = unImage;
+				unEdgeCount++;
+			}
+			if (unNode != unNodeCount)
+				break;
+		}
+		if (unImage != unImageCount)
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE(unReturnValue, L"Memory allocation failed.");
+			break;
+		}
+
+		// Layer n holds the shortest estimated duration to reach each node with exactly n updates
+		rgunSeconds = (unsigned int*)Platform_MemoryAllocateZero((unMaxHops + 1) * unNodeCount * sizeof(unsigned int));
+		rgunPredecessorEdge = (unsigned int*)Platform_MemoryAllocateZero((unMaxHops + 1) * unNodeCount * sizeof(unsigned int));
+		if (NULL == rgunSeconds || NULL == rgunPredecessorEdge)
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE(unReturnValue, L"Memory allocation failed.");
+			break;
+		}
+		for (unNode = 0; unNode < (unMaxHops + 1) * unNodeCount; unNode++)
+			rgunSeconds[unNode] = UPGRADE_PLANNER_UNREACHED;
+		rgunSeconds[0] = 0;
+		fReached = (0 == unTargetNode);
+
+		// Extend the plans by one update per layer until the target is reached, the first layer reaching it has the fewest updates
+		while (!fReached && unHops < unMaxHops)
+		{
+			const unsigned int* rgunPrevious = &rgunSeconds[unHops * unNodeCount];
+			unsigned int* rgunCurrent = &rgunSeconds[(unHops + 1) * unNodeCount];
+			unsigned int* rgunCurrentEdge = &rgunPredecessorEdge[(unHops + 1) * unNodeCount];
+
+			for (unEdge = 0; unEdge < unEdgeCount; unEdge++)
+			{
+				const IfxFirmwareCatalogImage* pImage = &rgsImages[rgsEdges[unEdge].unImage];
+				unsigned int unTargetOfEdge = rgunImageTargetNode[rgsEdges[unEdge].unImage];
+				unsigned int unSeconds = 0;
+
+				if (UPGRADE_PLANNER_UNREACHED == rgunPrevious[rgsEdges[unEdge].unSourceNode])
+					continue;
+
+				unSeconds = rgunPrevious[rgsEdges[unEdge].unSourceNode] + UPGRADE_PLANNER_HOP_SECONDS +
+							(unsigned int)((pImage->ullFileSize + UPGRADE_PLANNER_BYTES_PER_SECOND - 1) / UPGRADE_PLANNER_BYTES_PER_SECOND);
+				if (unSeconds < rgunCurrent[unTargetOfEdge])
+				{
+					rgunCurrent[unTargetOfEdge] = unSeconds;
+					rgunCurrentEdge[unTargetOfEdge] = unEdge;
+				}
+			}
+
+			unHops++;
+			fReached = (UPGRADE_PLANNER_UNREACHED != rgunCurrent[unTargetNode]);
+		}
+		if (!fReached)
+		{
+			unReturnValue = RC_E_FIRMWARE_UPDATE_NOT_FOUND;
+			if (REMAINING_UPDATES_UNAVAILABLE != PunRemainingUpdates && PunRemainingUpdates < UPGRADE_PLANNER_MAX_HOPS)
+				ERROR_STORE_FMT(unReturnValue, L"No upgrade path from %ls to %ls within the %d remaining firmware updates.", PwszSourceVersion, PwszTargetVersion, PunRemainingUpdates);
+			else
+				ERROR_STORE_FMT(unReturnValue, L"No upgrade path from %ls to %ls within %d firmware updates.", PwszSourceVersion, PwszTargetVersion, UPGRADE_PLANNER_MAX_HOPS);
+			break;
+		}
+
+		// Walk back from the target to compose the plan
+		PpsPlan->unHopCount = unHops;
+		PpsPlan->unEstimatedSeconds = rgunSeconds[unHops * unNodeCount + unTargetNode];
+		for (unNode = unTargetNode; unHops > 0; unHops--)
+		{
+			const IfxUpgradePlannerEdge* pEdge = &rgsEdges[rgunPredecessorEdge[unHops * unNodeCount + unNode]];
+			const IfxFirmwareCatalogImage* pImage = &rgsImages[pEdge->unImage];
+			IfxUpgradePlanHop* pHop = &PpsPlan->rgsHops[unHops - 1];
+			unsigned int unSize = 0;
+
+			pHop->bSourceTpmFamily = pImage->bSourceTpmFamily;
+			pHop->bTargetTpmFamily = pImage->bTargetTpmFamily;
+			pHop->fFactoryDefaults = pImage->fFactoryDefaults;
+			pHop->unEstimatedSeconds = rgunSeconds[unHops * unNodeCount + unNode] - rgunSeconds[(unHops - 1) * unNodeCount + pEdge->unSourceNode];
+			unSize = RG_LEN(pHop->wszSourceVersion);
+			unReturnValue = Platform_StringCopy(pHop->wszSourceVersion, &unSize, rgsNodes[pEdge->unSourceNode].pwszVersion);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+			unSize = RG_LEN(pHop->wszTargetVersion);
+			unReturnValue = Platform_StringCopy(pHop->wszTargetVersion, &unSize, pImage->wszTargetVersion);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+			unSize = RG_LEN(pHop->wszFileName);
+			unReturnValue = Platform_StringCopy(pHop->wszFileName, &unSize, pImage->wszFileName);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			unNode = pEdge->unSourceNode;
+		}
+		if (RC_SUCCESS != unReturnValue)
+		{
+			ERROR_STORE(unReturnValue, L"Platform_StringCopy returned an unexpected value while composing the upgrade plan.");
+			break;
+		}
+
+		for (unHops = 0; unHops < PpsPlan->unHopCount; unHops++)
+		{
+			LOGGING_WRITE_LEVEL2_FMT(L"Upgrade plan: %d. %ls -> %ls (%ls, about %d s)", unHops + 1, PpsPlan->rgsHops[unHops].wszSourceVersion,
+									PpsPlan->rgsHops[unHops].wszTargetVersion, PpsPlan->rgsHops[unHops].wszFileName, PpsPlan->rgsHops[unHops].unEstimatedSeconds);
+		}
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	Platform_MemoryFree((void**)&rgunPredecessorEdge);
+	Platform_MemoryFree((void**)&rgunSeconds);
+	Platform_MemoryFree((void**)&rgunImageTargetNode);
+	Platform_MemoryFree((void**)&rgsEdges);
+	Platform_MemoryFree((void**)&rgsNodes);
+	Platform_MemoryFree((void**)&rgsImages);
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
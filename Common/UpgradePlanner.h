@@ -0,0 +1,95 @@
+﻿/**
+ *	@brief		Declares the firmware upgrade planner
+ *	@details	Computes the sequence of firmware images from the current TPM firmware to a target version
+ *	@file		UpgradePlanner.h
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "StdInclude.h"
+#include "FirmwareCatalog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Maximum number of firmware updates in one upgrade plan
+#define UPGRADE_PLANNER_MAX_HOPS				8
+/// Estimated fixed duration of one firmware update in seconds (preparation, TPM restart and self-test)
+#define UPGRADE_PLANNER_HOP_SECONDS				30
+/// Estimated transfer rate of the firmware image to the TPM in bytes per second
+#define UPGRADE_PLANNER_BYTES_PER_SECOND		8192
+
+/// One firmware update of an upgrade plan
+typedef struct tdIfxUpgradePlanHop
+{
+	/// TPM family before the update
+	BYTE bSourceTpmFamily;
+	/// TPM family after the update
+	BYTE bTargetTpmFamily;
+	/// The TPM is reset to factory defaults by the update
+	BOOL fFactoryDefaults;
+	/// TPM firmware version before the update
+	wchar_t wszSourceVersion[MAX_NAME];
+	/// TPM firmware version after the update
+	wchar_t wszTargetVersion[FIRMWARE_CATALOG_MAX_VERSION];
+	/// File name of the firmware image without the folder part
+	wchar_t wszFileName[FIRMWARE_CATALOG_MAX_FILE_NAME];
+	/// Estimated duration of the update in seconds
+	unsigned int unEstimatedSeconds;
+} IfxUpgradePlanHop;
+
+/// Sequence of firmware updates from the current TPM firmware to a target firmware
+typedef struct tdIfxUpgradePlan
+{
+	/// Number of firmware updates
+	unsigned int unHopCount;
+	/// Estimated duration of all updates in seconds
+	unsigned int unEstimatedSeconds;
+	/// Firmware updates in the order they must be applied
+	IfxUpgradePlanHop rgsHops[UPGRADE_PLANNER_MAX_HOPS];
+} IfxUpgradePlan;
+
+/**
+ *	@brief		Compute the upgrade plan from the current TPM firmware to a target firmware version
+ *	@details	Builds a graph of all current images in the catalog index of the firmware folder. The nodes are the TPM
+ *				family and firmware version pairs, each image is an edge from every source version to its target version.
+ *				Source versions match with and without subversion.minor like in FirmwareUpdate_IsFirmwareUpdatable.
+ *				Every update uses up one of the remaining field upgrades, so the plan with the fewest updates wins and the
+ *				estimated duration (UPGRADE_PLANNER_HOP_SECONDS plus the image size at UPGRADE_PLANNER_BYTES_PER_SECOND)
+ *				decides between plans with the same number of updates. Plans with more updates than PunRemainingUpdates
+ *				are rejected.
+ *
+ *	@param		PwszFolder				Firmware folder with the catalog index
+ *	@param		PbSourceFamily			Current TPM family (DEVICE_TYPE_TPM_12 or DEVICE_TYPE_TPM_20)
+ *	@param		PwszSourceVersion		Current TPM firmware version (e.g. "7.85.4555.0")
+ *	@param		PwszTargetVersion		Target TPM firmware version
+ *	@param		PunRemainingUpdates		Remaining field upgrades of the TPM or REMAINING_UPDATES_UNAVAILABLE
+ *	@param		PpsPlan					Receives the upgrade plan
+ *	@retval		RC_SUCCESS						The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER				An invalid parameter was passed to the function.
+ *	@retval		RC_E_FILE_NOT_FOUND				The folder does not contain a valid catalog index.
+ *	@retval		RC_E_FIRMWARE_UPDATE_NOT_FOUND	No plan reaches the target version within the remaining field upgrades.
+ *	@retval		RC_E_FAIL						An unexpected error occurred.
+ */
+_Check_return_
+unsigned int
+UpgradePlanner_Plan(
+	_In_z_	const wchar_t*		PwszFolder,
+	_In_	BYTE				PbSourceFamily,
+	_In_z_	const wchar_t*		PwszSourceVersion,
+	_In_z_	const wchar_t*		PwszTargetVersion,
+	_In_	unsigned int		PunRemainingUpdates,
+	_Out_	IfxUpgradePlan*		PpsPlan);
+
+#ifdef __cplusplus
+}
+#endif
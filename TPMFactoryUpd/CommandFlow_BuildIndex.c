@@ -0,0 +1,80 @@
+﻿/**
+ *	@brief		Implements the command flow to build the firmware catalog index.
+ *	@details	This module parses the firmware images of a folder and writes the catalog index used for the image selection.
+ *	@file		CommandFlow_BuildIndex.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CommandFlow_BuildIndex.h"
+#include "FirmwareCatalog.h"
+
+/**
+ *	@brief		Builds the catalog index of a firmware folder.
+ *	@details	This function parses all firmware images in the folder given with the build-index option and writes the
+ *				catalog index used by the config-file update to select the firmware image. The TPM is not accessed.
+ *
+ *	@param		PpBuildIndex					Pointer to an initialized IfxBuildIndex structure to be filled in
+ *
+ *	@retval		RC_SUCCESS						The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER				An invalid parameter was passed to the function. PpBuildIndex was invalid.
+ *	@retval		RC_E_INVALID_BUILD_INDEX_OPTION	The firmware folder does not exist.
+ *	@retval		RC_E_FAIL						An unexpected error occurred.
+ *	@retval		...								Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+CommandFlow_BuildIndex_Execute(
+	_Inout_ IfxBuildIndex* PpBuildIndex)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		unsigned int unFolderSize = 0;
+
+		// Parameter check
+		if (NULL == PpBuildIndex || STRUCT_TYPE_BuildIndex != PpBuildIndex->unType || sizeof(IfxBuildIndex) != PpBuildIndex->unSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Bad parameter detected.");
+			break;
+		}
+
+		// Get the firmware folder
+		unFolderSize = RG_LEN(PpBuildIndex->wszFolder);
+		if (FALSE == PropertyStorage_GetValueByKey(PROPERTY_BUILD_INDEX_PATH, PpBuildIndex->wszFolder, &unFolderSize))
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE_FMT(unReturnValue, L"PropertyStorage_GetValueByKey failed to get property '%ls'.", PROPERTY_BUILD_INDEX_PATH);
+			break;
+		}
+
+		// Build the index
+		unReturnValue = FirmwareCatalog_Build(PpBuildIndex->wszFolder, &PpBuildIndex->unImageCount, &PpBuildIndex->unSkippedCount);
+		if (RC_E_FILE_NOT_FOUND == unReturnValue)
+		{
+			unReturnValue = RC_E_INVALID_BUILD_INDEX_OPTION;
+			ERROR_STORE_FMT(unReturnValue, L"The firmware folder '%ls' does not exist.", PpBuildIndex->wszFolder);
+			break;
+		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		PpBuildIndex->unReturnCode = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
@@ -141,6 +141,7 @@ CommandFlow_Tpm12ClearOwnership_Execute(
 
 			// Clear TPM1.2 Ownership
 			unReturnValue = TSS_TPM_OwnerClear(unAuthHandle, &sNonceEven, FALSE, &ownerAuthData);
+			FirmwareUpdate_InvalidateTpmStateCache();
 			if (RC_SUCCESS != unReturnValue)
 			{
 				ERROR_STORE(unReturnValue, L"TPMOwnerClear returned an unexpected value");
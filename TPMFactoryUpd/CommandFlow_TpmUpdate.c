@@ -24,6 +24,9 @@
 #include "TPMFactoryUpdStruct.h"
 #include "Resource.h"
 #include "FileIO.h"
+#include "ImageCache.h"
+#include "FirmwareCatalog.h"
+#include "UpgradePlanner.h"
 
 #include <TPM2_FlushContext.h>
 #include <TPM2_StartAuthSession.h>
@@ -56,6 +59,9 @@ TPM_AUTHDATA s_ownerAuthData = {{
 // Flag to remember that firmware update is done through config file option
 BOOL s_fUpdateThroughConfigFile = FALSE;
 
+// Firmware version the TPM reports after the update of the upgrade plan started in this run
+static wchar_t s_wszUpgradePlanExpectedVersion[FIRMWARE_CATALOG_MAX_VERSION] = {0};
+
 /**
  *	@brief		Callback function to save the used firmware image path to TPM_FACTORY_UPD_RUNDATA_FILE (once an update has been started successfully)
  *	@details	The function is called by FirmwareUpdate_UpdateImage() to create the TPM_FACTORY_UPD_RUNDATA_FILE.
@@ -127,7 +133,7 @@ CommandFlow_TpmUpdate_IsTpmUpdatableWithFirmware(
 		}
 
 		// Call CheckImage
-		unReturnValue = FirmwareUpdate_CheckImage(PpTpmUpdate->rgbFirmwareImage, PpTpmUpdate->unFirmwareImageSize, &PpTpmUpdate->fValid, &PpTpmUpdate->bfNewTpmFirmwareInfo, &PpTpmUpdate->unErrorDetails);
+		unReturnValue = FirmwareUpdate_CheckImage(&PpTpmUpdate->sParsedImage, &PpTpmUpdate->fValid, &PpTpmUpdate->bfNewTpmFirmwareInfo, &PpTpmUpdate->unErrorDetails);
 		if (RC_SUCCESS != unReturnValue)
 			break;
 
@@ -159,28 +165,18 @@ CommandFlow_TpmUpdate_IsTpmUpdatableWithFirmware(
 			break;
 		}
 
-		// Parse the new image and get the target version and the target family
+		// Get the target version and the target family from the parsed image
 		{
-			BYTE* rgbIfxFirmwareImageStream = PpTpmUpdate->rgbFirmwareImage;
-			IfxFirmwareImage sIfxFirmwareImage = {{0}};
-			INT32 nIfxFirmwareImageSize = (INT32)PpTpmUpdate->unFirmwareImageSize;
 			unsigned int unNewFirmwareVersionSize = RG_LEN(PpTpmUpdate->wszNewFirmwareVersion);
 
-			unReturnValue = FirmwareImage_Unmarshal(&sIfxFirmwareImage, &rgbIfxFirmwareImageStream, &nIfxFirmwareImageSize);
-			if (RC_SUCCESS != unReturnValue)
-			{
-				ERROR_STORE(unReturnValue, L"Firmware image cannot be parsed.");
-				break;
-			}
-
-			unReturnValue = Platform_StringCopy(PpTpmUpdate->wszNewFirmwareVersion, &unNewFirmwareVersionSize, sIfxFirmwareImage.wszTargetVersion);
+			unReturnValue = Platform_StringCopy(PpTpmUpdate->wszNewFirmwareVersion, &unNewFirmwareVersionSize, PpTpmUpdate->sParsedImage.sHeader.wszTargetVersion);
 			if (RC_SUCCESS != unReturnValue)
 			{
 				ERROR_STORE(unReturnValue, L"Platform_StringCopy returned an unexpected value while copying the target firmware version.");
 				break;
 			}
 
-			PpTpmUpdate->bTargetFamily = sIfxFirmwareImage.bTargetTpmFamily;
+			PpTpmUpdate->bTargetFamily = PpTpmUpdate->sParsedImage.sHeader.bTargetTpmFamily;
 		}
 	}
 	WHILE_FALSE_END;
@@ -250,6 +246,9 @@ CommandFlow_TpmUpdate_PrepareTPM12PhysicalPresence()
 	}
 	WHILE_FALSE_END;
 
+	// The physical presence flags may have changed
+	FirmwareUpdate_InvalidateTpmStateCache();
+
 	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
 
 	return unReturnValue;
@@ -327,8 +326,7 @@ CommandFlow_TpmUpdate_UpdateFirmware(
 		// Update firmware
 		sFirmwareUpdateData.fnProgressCallback = &Response_ProgressCallback;
 		sFirmwareUpdateData.fnUpdateStartedCallback = &CommandFlow_TpmUpdate_UpdateStartedCallback;
-		sFirmwareUpdateData.rgbFirmwareImage = PpTpmUpdate->rgbFirmwareImage;
-		sFirmwareUpdateData.unFirmwareImageSize = PpTpmUpdate->unFirmwareImageSize;
+		sFirmwareUpdateData.pParsedImage = &PpTpmUpdate->sParsedImage;
 		if (TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_DRY_RUN, &fValue) && TRUE == fValue)
 		{
 			PpTpmUpdate->unReturnCode = RC_SUCCESS;
@@ -592,6 +590,7 @@ CommandFlow_TpmUpdate_IsFirmwareUpdatable(
 				break;
 			}
 
+			// Read the image into memory, a file mapping could change under the running update
 			unReturnValue = FileIO_ReadFileToBuffer(wszFirmwareImagePath, &PpTpmUpdate->rgbFirmwareImage, &PpTpmUpdate->unFirmwareImageSize);
 			if (RC_SUCCESS != unReturnValue)
 			{
@@ -599,6 +598,14 @@ CommandFlow_TpmUpdate_IsFirmwareUpdatable(
 				unReturnValue = RC_E_INVALID_FW_OPTION;
 				break;
 			}
+
+			// Look up earlier verification results of the image file
+			ImageCache_RegisterImage(wszFirmwareImagePath, PpTpmUpdate->rgbFirmwareImage, PpTpmUpdate->unFirmwareImageSize);
+
+			// Parse the image once; the checks and the update use the parsed image
+			unReturnValue = FirmwareUpdate_ParseImage(PpTpmUpdate->rgbFirmwareImage, PpTpmUpdate->unFirmwareImageSize, &PpTpmUpdate->sParsedImage);
+			if (RC_SUCCESS != unReturnValue)
+				break;
 		}
 
 		unReturnValue = CommandFlow_TpmUpdate_IsTpmUpdatableWithFirmware(PpTpmUpdate);
@@ -725,6 +732,7 @@ CommandFlow_TpmUpdate_PrepareTPM12Ownership()
 							rgbEncryptedSrkHash, unEncryptedSrkHashSize, // Encrypted SRK authentication hash
 							&sSrkParams, unAuthHandle, &s_ownerAuthData,
 							&sAuthLastNonceEven, &sSrkKey);
+		FirmwareUpdate_InvalidateTpmStateCache();
 
 		if (RC_SUCCESS != unReturnValue || 0 == sSrkKey.pubKey.keyLength)
 		{
@@ -960,7 +968,12 @@ CommandFlow_TpmUpdate_InitializeParsing()
 	unsigned int unReturnValue = RC_SUCCESS;
 
 	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
-	// Nothing to initialize here
+	// Remove the settings of a previous parse run (the config file is parsed again for every update of an upgrade plan)
+	IGNORE_RETURN_VALUE(PropertyStorage_RemoveElement(PROPERTY_CONFIG_FILE_UPDATE_TYPE12));
+	IGNORE_RETURN_VALUE(PropertyStorage_RemoveElement(PROPERTY_CONFIG_FILE_UPDATE_TYPE20));
+	IGNORE_RETURN_VALUE(PropertyStorage_RemoveElement(PROPERTY_CONFIG_TARGET_FIRMWARE_VERSION_LPC));
+	IGNORE_RETURN_VALUE(PropertyStorage_RemoveElement(PROPERTY_CONFIG_TARGET_FIRMWARE_VERSION_SPI));
+	IGNORE_RETURN_VALUE(PropertyStorage_RemoveElement(PROPERTY_CONFIG_FIRMWARE_FOLDER_PATH));
 	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
 
 	return unReturnValue;
@@ -1016,21 +1029,25 @@ CommandFlow_TpmUpdate_FinalizeParsing(
 }
 
 /**
- *	@brief		Parse the update config settings file
- *	@details
+ *	@brief		Parse the update config settings file and select the firmware image
+ *	@details	Selects the image which updates to the configured target version directly or, for an upgrade plan, the first
+ *				image of the plan computed by UpgradePlanner_Plan.
  *
  *	@param		PpTpmUpdate							Contains information about the current TPM and can be filled up with information for the
  *													corresponding Current return code which can be overwritten here.
- *	@retval		PunReturnValue						In case PunReturnValue is not equal to RC_SUCCESS
+ *	@param		PfUpgradePlan						TRUE for -update plan, FALSE for -update config-file
  *	@retval		RC_SUCCESS							The operation completed successfully.
  *	@retval		RC_E_FAIL							An unexpected error occurred.
  *	@retval		RC_E_INVALID_CONFIG_OPTION			An config file was given that cannot be opened.
  *	@retval		RC_E_FIRMWARE_UPDATE_NOT_FOUND		A firmware update for the current TPM version cannot be found.
+ *	@retval		RC_E_RESTART_REQUIRED				The TPM does not report the firmware version of the previous update of the upgrade plan.
  */
 _Check_return_
+static
 unsigned int
-CommandFlow_TpmUpdate_ProceedUpdateConfig(
-	_Inout_ IfxUpdate* PpTpmUpdate)
+CommandFlow_TpmUpdate_ProceedConfigFile(
+	_Inout_	IfxUpdate*	PpTpmUpdate,
+	_In_	BOOL		PfUpgradePlan)
 {
 	unsigned int unReturnValue = RC_E_FAIL;
 
@@ -1092,12 +1109,24 @@ CommandFlow_TpmUpdate_ProceedUpdateConfig(
 			unsigned int unSourceFamilySize = RG_LEN(wszSourceFamily);
 			wchar_t wszTargetFamily[MAX_NAME] = {0};
 			unsigned int unTargetFamilySize = RG_LEN(wszTargetFamily);
+			BYTE bSourceFamily = 0;
 			ENUM_UPDATE_TYPES unUpdateType = UPDATE_TYPE_NONE;
 
 			#define TPM_FIRMWARE_FILE_NAME_PATTERN L"%ls_%ls_to_%ls_%ls.BIN"
 
 			if (!PpTpmUpdate->sTpmState.attribs.bootLoader)
 			{
+				// Continue an upgrade plan only if the TPM is running the firmware of the previous update
+				if (PfUpgradePlan && L'\0' != s_wszUpgradePlanExpectedVersion[0] &&
+					(PpTpmUpdate->sTpmState.attribs.tpm20restartRequired ||
+					0 != Platform_StringCompare(s_wszUpgradePlanExpectedVersion, PpTpmUpdate->wszVersionName, RG_LEN(s_wszUpgradePlanExpectedVersion), FALSE)))
+				{
+					unReturnValue = RC_E_RESTART_REQUIRED;
+					ERROR_STORE_FMT(unReturnValue, L"The TPM reports firmware version %ls after the update to %ls. Restart the system and run -update plan again to continue the upgrade plan.",
+						PpTpmUpdate->wszVersionName, s_wszUpgradePlanExpectedVersion);
+					break;
+				}
+
 				// Check if TPM is SPI or LPC
 				if ((PpTpmUpdate->wszVersionName[0] == L'6' || PpTpmUpdate->wszVersionName[0] == L'7') && PpTpmUpdate->wszVersionName[1] == L'.')
 				{
@@ -1145,9 +1174,15 @@ CommandFlow_TpmUpdate_ProceedUpdateConfig(
 
 				// Detect TPM source family
 				if (PpTpmUpdate->sTpmState.attribs.tpm12)
+				{
+					bSourceFamily = DEVICE_TYPE_TPM_12;
 					unReturnValue = Platform_StringCopy(wszSourceFamily, &unSourceFamilySize, TPM12_FAMILY_STRING);
+				}
 				else if (PpTpmUpdate->sTpmState.attribs.tpm20)
+				{
+					bSourceFamily = DEVICE_TYPE_TPM_20;
 					unReturnValue = Platform_StringCopy(wszSourceFamily, &unSourceFamilySize, TPM20_FAMILY_STRING);
+				}
 				else
 					unReturnValue = RC_E_FAIL;
 				if (RC_SUCCESS != unReturnValue)
@@ -1175,29 +1210,12 @@ CommandFlow_TpmUpdate_ProceedUpdateConfig(
 					break;
 				}
 
-				// Construct firmware binary file path regarding the naming convention of update images
-				// Fill in the firmware file name template
-				unReturnValue = Platform_StringFormat(
-									PpTpmUpdate->wszUsedFirmwareImage,
-									&unUsedFirmwareImageSize,
-									TPM_FIRMWARE_FILE_NAME_PATTERN,
-									wszSourceFamily,
-									PpTpmUpdate->wszVersionName,
-									wszTargetFamily,
-									wszTargetVersion);
-
-				if (RC_SUCCESS != unReturnValue)
-				{
-					unReturnValue = RC_E_FAIL;
-					ERROR_STORE(unReturnValue, L"Platform_StringFormat returned an unexpected value while composing the firmware image file path.");
-					break;
-				}
-
 				// Compose firmware folder
 				{
 					wchar_t wszFirmwareFilePath[MAX_STRING_1024] = {0};
 					unsigned int unFirmwareFilePathSize = RG_LEN(wszFirmwareFilePath);
 					unsigned int unIndex = 0, unLastFolderIndex = 0;
+					BOOL fCatalogHit = FALSE;
 
 					// Copy config file path to destination buffer
 					unReturnValue = Platform_StringCopy(wszFirmwareFilePath, &unFirmwareFilePathSize, wszConfigFilePath);
@@ -1243,7 +1261,69 @@ CommandFlow_TpmUpdate_ProceedUpdateConfig(
 						}
 					}
 
-					// Add the filled firmware file name template to the composed folder
+					if (PfUpgradePlan)
+					{
+						// Select the first image of the upgrade plan, the catalog index has already checked the image files
+						unReturnValue = UpgradePlanner_Plan(
+											wszFirmwareFilePath,
+											bSourceFamily,
+											PpTpmUpdate->wszVersionName,
+											wszTargetVersion,
+											PpTpmUpdate->unRemainingUpdates,
+											&PpTpmUpdate->sUpgradePlan);
+						if (RC_SUCCESS != unReturnValue)
+						{
+							if (RC_E_FILE_NOT_FOUND == unReturnValue)
+								unReturnValue = RC_E_FIRMWARE_UPDATE_NOT_FOUND;
+							ERROR_STORE_FMT(unReturnValue, L"No upgrade plan found to update the current TPM firmware. (%ls)", wszFirmwareFilePath);
+							break;
+						}
+						unReturnValue = Platform_StringCopy(PpTpmUpdate->wszUsedFirmwareImage, &unUsedFirmwareImageSize, PpTpmUpdate->sUpgradePlan.rgsHops[0].wszFileName);
+						if (RC_SUCCESS == unReturnValue)
+						{
+							unsigned int unExpectedVersionSize = RG_LEN(s_wszUpgradePlanExpectedVersion);
+							unReturnValue = Platform_StringCopy(s_wszUpgradePlanExpectedVersion, &unExpectedVersionSize, PpTpmUpdate->sUpgradePlan.rgsHops[0].wszTargetVersion);
+						}
+						if (RC_SUCCESS != unReturnValue)
+						{
+							ERROR_STORE(unReturnValue, L"Platform_StringCopy returned an unexpected value.");
+							break;
+						}
+						fCatalogHit = TRUE;
+					}
+					else
+					{
+						// Select the firmware image through the catalog index of the folder if it is current
+						fCatalogHit = FirmwareCatalog_Lookup(
+										wszFirmwareFilePath,
+										bSourceFamily,
+										PpTpmUpdate->wszVersionName,
+										wszTargetVersion,
+										PpTpmUpdate->wszUsedFirmwareImage,
+										&unUsedFirmwareImageSize);
+					}
+					if (!fCatalogHit)
+					{
+						// Construct firmware binary file path regarding the naming convention of update images
+						// Fill in the firmware file name template
+						unUsedFirmwareImageSize = RG_LEN(PpTpmUpdate->wszUsedFirmwareImage);
+						unReturnValue = Platform_StringFormat(
+											PpTpmUpdate->wszUsedFirmwareImage,
+											&unUsedFirmwareImageSize,
+											TPM_FIRMWARE_FILE_NAME_PATTERN,
+											wszSourceFamily,
+											PpTpmUpdate->wszVersionName,
+											wszTargetFamily,
+											wszTargetVersion);
+						if (RC_SUCCESS != unReturnValue)
+						{
+							unReturnValue = RC_E_FAIL;
+							ERROR_STORE(unReturnValue, L"Platform_StringFormat returned an unexpected value while composing the firmware image file path.");
+							break;
+						}
+					}
+
+					// Add the firmware file name to the composed folder
 					unFirmwareFilePathSize = RG_LEN(wszFirmwareFilePath);
 					unReturnValue = Platform_StringConcatenatePaths(wszFirmwareFilePath, &unFirmwareFilePathSize, PpTpmUpdate->wszUsedFirmwareImage);
 					if (RC_SUCCESS != unReturnValue)
@@ -1252,8 +1332,8 @@ CommandFlow_TpmUpdate_ProceedUpdateConfig(
 						break;
 					}
 
-					// Check if firmware image exists
-					if (!FileIO_Exists(wszFirmwareFilePath))
+					// Check if firmware image exists, the catalog index already checked the file of a hit
+					if (!fCatalogHit && !FileIO_Exists(wszFirmwareFilePath))
 					{
 						unReturnValue = RC_E_FIRMWARE_UPDATE_NOT_FOUND;
 						ERROR_STORE_FMT(unReturnValue, L"No firmware image found to update the current TPM firmware. (%ls)", wszFirmwareFilePath);
@@ -1289,7 +1369,8 @@ CommandFlow_TpmUpdate_ProceedUpdateConfig(
 						ERROR_STORE_FMT(unReturnValue, L"PropertyStorage_ChangeUIntegerValueByKey failed to change property '%ls'.", PROPERTY_UPDATE_TYPE);
 						break;
 					}
-					// Set the firmware file path
+					// Set the firmware file path (replaces the path of the previous update of an upgrade plan)
+					IGNORE_RETURN_VALUE(PropertyStorage_RemoveElement(PROPERTY_FIRMWARE_PATH));
 					if (!PropertyStorage_AddKeyValuePair(PROPERTY_FIRMWARE_PATH, wszFirmwareFilePath))
 					{
 						unReturnValue = RC_E_FAIL;
@@ -1364,3 +1445,45 @@ CommandFlow_TpmUpdate_ProceedUpdateConfig(
 
 	return unReturnValue;
 }
+
+/**
+ *	@brief		Parse the update config settings file
+ *	@details
+ *
+ *	@param		PpTpmUpdate							Contains information about the current TPM and can be filled up with information for the
+ *													corresponding Current return code which can be overwritten here.
+ *	@retval		PunReturnValue						In case PunReturnValue is not equal to RC_SUCCESS
+ *	@retval		RC_SUCCESS							The operation completed successfully.
+ *	@retval		RC_E_FAIL							An unexpected error occurred.
+ *	@retval		RC_E_INVALID_CONFIG_OPTION			An config file was given that cannot be opened.
+ *	@retval		RC_E_FIRMWARE_UPDATE_NOT_FOUND		A firmware update for the current TPM version cannot be found.
+ */
+_Check_return_
+unsigned int
+CommandFlow_TpmUpdate_ProceedUpdateConfig(
+	_Inout_ IfxUpdate* PpTpmUpdate)
+{
+	return CommandFlow_TpmUpdate_ProceedConfigFile(PpTpmUpdate, FALSE);
+}
+
+/**
+ *	@brief		Parse the update config settings file and select the next firmware image of the upgrade plan
+ *	@details	Computes the upgrade plan from the current TPM firmware to the configured target version with
+ *				UpgradePlanner_Plan and selects its first image. Called again after each update of the plan; the plan is then
+ *				computed from the firmware the TPM reports, so an interrupted plan continues with the next run.
+ *
+ *	@param		PpTpmUpdate							Contains information about the current TPM and can be filled up with information for the
+ *													corresponding Current return code which can be overwritten here.
+ *	@retval		RC_SUCCESS							The operation completed successfully.
+ *	@retval		RC_E_FAIL							An unexpected error occurred.
+ *	@retval		RC_E_INVALID_CONFIG_OPTION			An config file was given that cannot be opened.
+ *	@retval		RC_E_FIRMWARE_UPDATE_NOT_FOUND		No upgrade plan reaches the target version within the remaining updates.
+ *	@retval		RC_E_RESTART_REQUIRED				The TPM does not report the firmware version of the previous update of the plan.
+ */
+_Check_return_
+unsigned int
+CommandFlow_TpmUpdate_ProceedUpdatePlan(
+	_Inout_ IfxUpdate* PpTpmUpdate)
+{
+	return CommandFlow_TpmUpdate_ProceedConfigFile(PpTpmUpdate, TRUE);
+}
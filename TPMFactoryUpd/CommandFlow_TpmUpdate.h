@@ -114,6 +114,25 @@ unsigned int
 CommandFlow_TpmUpdate_ProceedUpdateConfig(
 	_Inout_ IfxUpdate* PpTpmUpdate);
 
+/**
+ *	@brief		Parse the update config settings file and select the next firmware image of the upgrade plan
+ *	@details	Computes the upgrade plan from the current TPM firmware to the configured target version with
+ *				UpgradePlanner_Plan and selects its first image. Called again after each update of the plan; the plan is then
+ *				computed from the firmware the TPM reports, so an interrupted plan continues with the next run.
+ *
+ *	@param		PpTpmUpdate							Contains information about the current TPM and can be filled up with information for the
+ *													corresponding Current return code which can be overwritten here.
+ *	@retval		RC_SUCCESS							The operation completed successfully.
+ *	@retval		RC_E_FAIL							An unexpected error occurred.
+ *	@retval		RC_E_INVALID_CONFIG_OPTION			An config file was given that cannot be opened.
+ *	@retval		RC_E_FIRMWARE_UPDATE_NOT_FOUND		No upgrade plan reaches the target version within the remaining updates.
+ *	@retval		RC_E_RESTART_REQUIRED				The TPM does not report the firmware version of the previous update of the plan.
+ */
+_Check_return_
+unsigned int
+CommandFlow_TpmUpdate_ProceedUpdatePlan(
+	_Inout_ IfxUpdate* PpTpmUpdate);
+
 #ifdef __cplusplus
 }
 #endif
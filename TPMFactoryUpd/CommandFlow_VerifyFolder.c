@@ -0,0 +1,112 @@
+﻿/**
+ *	@brief		Implements the command flow to verify the firmware images of a folder.
+ *	@details	This module checks the firmware images of a folder in parallel and reports the result of every file.
+ *	@file		CommandFlow_VerifyFolder.c
+ *	@copyright	Copyright 2014 - 2017 Infineon Technologies AG ( www.infineon.com )
+ *
+ *	@copyright	All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CommandFlow_VerifyFolder.h"
+#include "FolderVerifier.h"
+
+/**
+ *	@brief		Verifies all firmware images of a firmware folder.
+ *	@details	This function checks the integrity of all firmware images in the folder given with the verify-folder option
+ *				on one worker thread per processor and writes the optional JSON report. The TPM is not accessed.
+ *
+ *	@param		PpVerifyFolder						Pointer to an initialized IfxVerifyFolder structure to be filled in
+ *
+ *	@retval		RC_SUCCESS							The operation completed successfully. unReturnCode is RC_E_CORRUPT_FW_IMAGE if any file is invalid.
+ *	@retval		RC_E_BAD_PARAMETER					An invalid parameter was passed to the function. PpVerifyFolder was invalid.
+ *	@retval		RC_E_INVALID_VERIFY_FOLDER_OPTION	The firmware folder does not exist.
+ *	@retval		RC_E_FAIL							An unexpected error occurred.
+ *	@retval		...									Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+CommandFlow_VerifyFolder_Execute(
+	_Inout_ IfxVerifyFolder* PpVerifyFolder)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		unsigned int unFolderSize = 0;
+		unsigned int unReportSize = 0;
+		unsigned int unIndex = 0;
+		unsigned long long ullStart = 0;
+
+		// Parameter check
+		if (NULL == PpVerifyFolder || STRUCT_TYPE_VerifyFolder != PpVerifyFolder->unType || sizeof(IfxVerifyFolder) != PpVerifyFolder->unSize)
+		{
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Bad parameter detected.");
+			break;
+		}
+
+		// Get the firmware folder
+		unFolderSize = RG_LEN(PpVerifyFolder->wszFolder);
+		if (FALSE == PropertyStorage_GetValueByKey(PROPERTY_VERIFY_FOLDER_PATH, PpVerifyFolder->wszFolder, &unFolderSize))
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE_FMT(unReturnValue, L"PropertyStorage_GetValueByKey failed to get property '%ls'.", PROPERTY_VERIFY_FOLDER_PATH);
+			break;
+		}
+
+		// Verify all files of the folder
+		ullStart = Platform_GetMonotonicTimeMicroSeconds();
+		unReturnValue = FolderVerifier_Verify(PpVerifyFolder->wszFolder, 0, &PpVerifyFolder->rgsResults, &PpVerifyFolder->unResultCount, &PpVerifyFolder->unThreadCount);
+		PpVerifyFolder->ullDurationUs = Platform_GetMonotonicTimeMicroSeconds() - ullStart;
+		if (RC_E_FILE_NOT_FOUND == unReturnValue)
+		{
+			unReturnValue = RC_E_INVALID_VERIFY_FOLDER_OPTION;
+			ERROR_STORE_FMT(unReturnValue, L"The firmware folder '%ls' does not exist.", PpVerifyFolder->wszFolder);
+			break;
+		}
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		for (unIndex = 0; unIndex < PpVerifyFolder->unResultCount; unIndex++)
+		{
+			if (RC_SUCCESS == PpVerifyFolder->rgsResults[unIndex].unResult)
+				PpVerifyFolder->unValidCount++;
+		}
+		LOGGING_WRITE_LEVEL1_FMT(L"Verified %d files in '%ls' on %d threads: %d valid (%llu us).",
+			PpVerifyFolder->unResultCount, PpVerifyFolder->wszFolder, PpVerifyFolder->unThreadCount,
+			PpVerifyFolder->unValidCount, PpVerifyFolder->ullDurationUs);
+
+		// Write the report if requested
+		unReportSize = RG_LEN(PpVerifyFolder->wszReportFile);
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_VERIFY_REPORT_PATH))
+		{
+			if (FALSE == PropertyStorage_GetValueByKey(PROPERTY_VERIFY_REPORT_PATH, PpVerifyFolder->wszReportFile, &unReportSize))
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE_FMT(unReturnValue, L"PropertyStorage_GetValueByKey failed to get property '%ls'.", PROPERTY_VERIFY_REPORT_PATH);
+				break;
+			}
+			unReturnValue = FolderVerifier_WriteReport(PpVerifyFolder->wszReportFile, PpVerifyFolder->wszFolder, PpVerifyFolder->rgsResults, PpVerifyFolder->unResultCount);
+			if (RC_SUCCESS != unReturnValue)
+			{
+				ERROR_STORE_FMT(unReturnValue, L"The verification report '%ls' cannot be written.", PpVerifyFolder->wszReportFile);
+				break;
+			}
+		}
+
+		PpVerifyFolder->unReturnCode = PpVerifyFolder->unValidCount == PpVerifyFolder->unResultCount ? RC_SUCCESS : RC_E_CORRUPT_FW_IMAGE;
+	}
+	WHILE_FALSE_END;
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
@@ -120,6 +120,10 @@ CommandLineParser_Parse(
 				{
 					unUpdateType = UPDATE_TYPE_CONFIG_FILE;
 				}
+				else if (0 == Platform_StringCompare(wszValue, CMD_UPDATE_OPTION_PLAN, RG_LEN(CMD_UPDATE_OPTION_PLAN), TRUE))
+				{
+					unUpdateType = UPDATE_TYPE_PLAN;
+				}
 				else if (0 == Platform_StringCompare(wszValue, CMD_UPDATE_OPTION_TPM12_OWNERAUTH, RG_LEN(CMD_UPDATE_OPTION_TPM12_OWNERAUTH), TRUE))
 				{
 					unUpdateType = UPDATE_TYPE_TPM12_OWNERAUTH;
@@ -168,6 +172,7 @@ CommandLineParser_Parse(
 				ERROR_STORE(unReturnValue, L"Setting PROPERTY_LOGGING_LEVEL failed.");
 				break;
 			}
+			Logging_UpdateLevel();
 
 			// Read parameter Logging path (optional)
 			unReturnValue = CommandLineParser_ReadParameter(PrgwszArgv, PnMaxArg, PpunCurrentArgIndex, wszValue, &unValueSize);
@@ -264,9 +269,10 @@ CommandLineParser_Parse(
 				break;
 			}
 
-			// Check if value is 1 or 3 for the TPM device access mode
+			// Check if value is 1, 3, 4 or 5 for the TPM device access mode
 			if (!PropertyStorage_GetUIntegerValueByKey(PROPERTY_TPM_DEVICE_ACCESS_MODE, &unAccessMode) ||
-					(TPM_DEVICE_ACCESS_DRIVER != unAccessMode && TPM_DEVICE_ACCESS_MEMORY_BASED != unAccessMode))
+					(TPM_DEVICE_ACCESS_DRIVER != unAccessMode && TPM_DEVICE_ACCESS_MEMORY_BASED != unAccessMode &&
+					TPM_DEVICE_ACCESS_SIMULATOR != unAccessMode && TPM_DEVICE_ACCESS_SIMULATOR_TIS != unAccessMode))
 			{
 				unReturnValue = RC_E_INVALID_ACCESS_MODE;
 				ERROR_STORE_FMT(unReturnValue, L"An invalid value (%ls) was passed in the <access-mode> command line option.", wszValue);
@@ -348,6 +354,150 @@ CommandLineParser_Parse(
 			break;
 		}
 
+		// **** -timing
+		if (0 == Platform_StringCompare(PwszCommandLineOption, CMD_TIMING, RG_LEN(CMD_TIMING), TRUE))
+		{
+			unReturnValue = CommandLineParser_CheckCommandLineOptions(PwszCommandLineOption);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			// Read parameter timing report path
+			unReturnValue = CommandLineParser_ReadParameter(PrgwszArgv, PnMaxArg, PpunCurrentArgIndex, wszValue, &unValueSize);
+			if (RC_SUCCESS != unReturnValue)
+			{
+				ERROR_STORE(unReturnValue, L"Missing timing file path for command line parameter <timing>.");
+				break;
+			}
+
+			// Check if path fits into property storage
+			if (PROPERTY_STORAGE_MAX_VALUE <= unValueSize)
+			{
+				unReturnValue = RC_E_BAD_COMMANDLINE;
+				ERROR_STORE_FMT(unReturnValue, L"Timing file (%ls) path is too long.", wszValue);
+				break;
+			}
+
+			// Set timing report path
+			if (!PropertyStorage_AddKeyValuePair(PROPERTY_TIMING_PATH, wszValue) &&
+					!PropertyStorage_ChangeValueByKey(PROPERTY_TIMING_PATH, wszValue))
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE_FMT(unReturnValue, L"PropertyStorage_AddKeyValuePair failed to add property '%ls'.", PROPERTY_TIMING_PATH);
+				break;
+			}
+
+			unReturnValue = CommandLineParser_IncrementOptionCount();
+			break;
+		}
+
+		// **** -build-index
+		if (0 == Platform_StringCompare(PwszCommandLineOption, CMD_BUILD_INDEX, RG_LEN(CMD_BUILD_INDEX), TRUE))
+		{
+			unReturnValue = CommandLineParser_CheckCommandLineOptions(PwszCommandLineOption);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			// Read parameter firmware folder path
+			unReturnValue = CommandLineParser_ReadParameter(PrgwszArgv, PnMaxArg, PpunCurrentArgIndex, wszValue, &unValueSize);
+			if (RC_SUCCESS != unReturnValue)
+			{
+				ERROR_STORE(unReturnValue, L"Missing firmware folder path for command line parameter <build-index>.");
+				break;
+			}
+
+			// Check if path fits into property storage
+			if (PROPERTY_STORAGE_MAX_VALUE <= unValueSize)
+			{
+				unReturnValue = RC_E_BAD_COMMANDLINE;
+				ERROR_STORE_FMT(unReturnValue, L"Firmware folder (%ls) path is too long.", wszValue);
+				break;
+			}
+
+			// Set firmware folder path
+			if (!PropertyStorage_AddKeyValuePair(PROPERTY_BUILD_INDEX_PATH, wszValue) &&
+					!PropertyStorage_ChangeValueByKey(PROPERTY_BUILD_INDEX_PATH, wszValue))
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE_FMT(unReturnValue, L"PropertyStorage_AddKeyValuePair failed to add property '%ls'.", PROPERTY_BUILD_INDEX_PATH);
+				break;
+			}
+
+			unReturnValue = CommandLineParser_IncrementOptionCount();
+			break;
+		}
+
+		// **** -verify-folder
+		if (0 == Platform_StringCompare(PwszCommandLineOption, CMD_VERIFY_FOLDER, RG_LEN(CMD_VERIFY_FOLDER), TRUE))
+		{
+			unReturnValue = CommandLineParser_CheckCommandLineOptions(PwszCommandLineOption);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			// Read parameter firmware folder path
+			unReturnValue = CommandLineParser_ReadParameter(PrgwszArgv, PnMaxArg, PpunCurrentArgIndex, wszValue, &unValueSize);
+			if (RC_SUCCESS != unReturnValue)
+			{
+				ERROR_STORE(unReturnValue, L"Missing firmware folder path for command line parameter <verify-folder>.");
+				break;
+			}
+
+			// Check if path fits into property storage
+			if (PROPERTY_STORAGE_MAX_VALUE <= unValueSize)
+			{
+				unReturnValue = RC_E_BAD_COMMANDLINE;
+				ERROR_STORE_FMT(unReturnValue, L"Firmware folder (%ls) path is too long.", wszValue);
+				break;
+			}
+
+			// Set firmware folder path
+			if (!PropertyStorage_AddKeyValuePair(PROPERTY_VERIFY_FOLDER_PATH, wszValue) &&
+					!PropertyStorage_ChangeValueByKey(PROPERTY_VERIFY_FOLDER_PATH, wszValue))
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE_FMT(unReturnValue, L"PropertyStorage_AddKeyValuePair failed to add property '%ls'.", PROPERTY_VERIFY_FOLDER_PATH);
+				break;
+			}
+
+			unReturnValue = CommandLineParser_IncrementOptionCount();
+			break;
+		}
+
+		// **** -verify-report
+		if (0 == Platform_StringCompare(PwszCommandLineOption, CMD_VERIFY_REPORT, RG_LEN(CMD_VERIFY_REPORT), TRUE))
+		{
+			unReturnValue = CommandLineParser_CheckCommandLineOptions(PwszCommandLineOption);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			// Read parameter verification report path
+			unReturnValue = CommandLineParser_ReadParameter(PrgwszArgv, PnMaxArg, PpunCurrentArgIndex, wszValue, &unValueSize);
+			if (RC_SUCCESS != unReturnValue)
+			{
+				ERROR_STORE(unReturnValue, L"Missing report file path for command line parameter <verify-report>.");
+				break;
+			}
+
+			// Check if path fits into property storage
+			if (PROPERTY_STORAGE_MAX_VALUE <= unValueSize)
+			{
+				unReturnValue = RC_E_BAD_COMMANDLINE;
+				ERROR_STORE_FMT(unReturnValue, L"Report file (%ls) path is too long.", wszValue);
+				break;
+			}
+
+			// Set verification report path
+			if (!PropertyStorage_AddKeyValuePair(PROPERTY_VERIFY_REPORT_PATH, wszValue) &&
+					!PropertyStorage_ChangeValueByKey(PROPERTY_VERIFY_REPORT_PATH, wszValue))
+			{
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE_FMT(unReturnValue, L"PropertyStorage_AddKeyValuePair failed to add property '%ls'.", PROPERTY_VERIFY_REPORT_PATH);
+				break;
+			}
+
+			unReturnValue = CommandLineParser_IncrementOptionCount();
+			break;
+		}
+
 		unReturnValue = RC_E_BAD_COMMANDLINE;
 		ERROR_STORE_FMT(unReturnValue, L"Unknown command line parameter (%ls).", PwszCommandLineOption);
 	}
@@ -427,13 +577,24 @@ CommandLineParser_FinalizeParsing(
 		if ((FALSE == PropertyStorage_GetBooleanValueByKey(PROPERTY_UPDATE, &fValue) || FALSE == fValue) &&
 				(FALSE == PropertyStorage_GetBooleanValueByKey(PROPERTY_INFO, &fValue) || FALSE == fValue) &&
 				(FALSE == PropertyStorage_GetBooleanValueByKey(PROPERTY_HELP, &fValue) || FALSE == fValue) &&
-				(FALSE == PropertyStorage_GetBooleanValueByKey(PROPERTY_TPM12_CLEAROWNERSHIP, &fValue) || FALSE == fValue))
+				(FALSE == PropertyStorage_GetBooleanValueByKey(PROPERTY_TPM12_CLEAROWNERSHIP, &fValue) || FALSE == fValue) &&
+				FALSE == PropertyStorage_ExistsElement(PROPERTY_BUILD_INDEX_PATH) &&
+				FALSE == PropertyStorage_ExistsElement(PROPERTY_VERIFY_FOLDER_PATH))
 		{
 			PunReturnValue = RC_E_BAD_COMMANDLINE;
 			ERROR_STORE(PunReturnValue, L"No mandatory command line option found.");
 			break;
 		}
 
+		// The verify-report option is only valid with the verify-folder option
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_VERIFY_REPORT_PATH) &&
+				FALSE == PropertyStorage_ExistsElement(PROPERTY_VERIFY_FOLDER_PATH))
+		{
+			PunReturnValue = RC_E_BAD_COMMANDLINE;
+			ERROR_STORE(PunReturnValue, L"Command line option verify-report requires command line option verify-folder.");
+			break;
+		}
+
 		// Check that when update option is set ...
 		if (TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_UPDATE, &fValue) && TRUE == fValue)
 		{
@@ -444,9 +605,9 @@ CommandLineParser_FinalizeParsing(
 				ERROR_STORE(PunReturnValue, L"An internal error occurred while parsing the -update option.");
 				break;
 			}
-			if (UPDATE_TYPE_CONFIG_FILE == unUpdateType)
+			if (UPDATE_TYPE_CONFIG_FILE == unUpdateType || UPDATE_TYPE_PLAN == unUpdateType)
 			{
-				// The config option is set for -update config-file
+				// The config option is set for -update config-file and -update plan
 				if (FALSE == PropertyStorage_ExistsElement(PROPERTY_CONFIG_FILE_PATH))
 				{
 					PunReturnValue = RC_E_BAD_COMMANDLINE;
@@ -676,6 +837,10 @@ CommandLineParser_CheckCommandLineOptions(
 		BOOL fConfigFileOption = FALSE;
 		BOOL fDryRunOption = FALSE;
 		BOOL fIgnoreErrorOnComplete = FALSE;
+		BOOL fTimingOption = FALSE;
+		BOOL fBuildIndexOption = FALSE;
+		BOOL fVerifyFolderOption = FALSE;
+		BOOL fVerifyReportOption = FALSE;
 
 		// Read Property storage
 		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_HELP))
@@ -698,12 +863,20 @@ CommandLineParser_CheckCommandLineOptions(
 			fDryRunOption = TRUE;
 		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_IGNORE_ERROR_ON_COMPLETE))
 			fIgnoreErrorOnComplete = TRUE;
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_TIMING_PATH))
+			fTimingOption = TRUE;
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_BUILD_INDEX_PATH))
+			fBuildIndexOption = TRUE;
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_VERIFY_FOLDER_PATH))
+			fVerifyFolderOption = TRUE;
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_VERIFY_REPORT_PATH))
+			fVerifyReportOption = TRUE;
 
 		// **** -help [Help]
 		if (0 == Platform_StringCompare(PwszCommand, CMD_HELP, RG_LEN(CMD_HELP), TRUE) ||
 				0 == Platform_StringCompare(PwszCommand, CMD_HELP_ALT, RG_LEN(CMD_HELP_ALT), FALSE))
 		{
-			// Command line parameter 'help' combined with parameters 'info', 'update', 'firmware', 'log', 'tpm12-clearownership', 'access-mode' or 'config' is a bad command line
+			// Command line parameter 'help' combined with parameters 'info', 'update', 'firmware', 'log', 'tpm12-clearownership', 'access-mode', 'config', 'timing', 'build-index', 'verify-folder' or 'verify-report' is a bad command line
 			if (TRUE == fHelpOption || // Parameter should not be given twice
 					TRUE == fInfoOption ||
 					TRUE == fUpdateOption ||
@@ -711,7 +884,11 @@ CommandLineParser_CheckCommandLineOptions(
 					TRUE == fLogOption ||
 					TRUE == fClearOwnership ||
 					TRUE == fAccessMode ||
-					TRUE == fConfigFileOption)
+					TRUE == fConfigFileOption ||
+					TRUE == fTimingOption ||
+					TRUE == fBuildIndexOption ||
+					TRUE == fVerifyFolderOption ||
+					TRUE == fVerifyReportOption)
 				unReturnValue = RC_E_BAD_COMMANDLINE;
 			break;
 		}
@@ -719,13 +896,15 @@ CommandLineParser_CheckCommandLineOptions(
 		// **** -info [Info]
 		if (0 == Platform_StringCompare(PwszCommand, CMD_INFO, RG_LEN(CMD_INFO), TRUE))
 		{
-			// Command line parameter 'info' combined with parameters 'help', 'update', 'firmware', 'tpm12-clearownership' or 'config' is a bad command line
+			// Command line parameter 'info' combined with parameters 'help', 'update', 'firmware', 'tpm12-clearownership', 'config', 'build-index' or 'verify-folder' is a bad command line
 			if (TRUE == fInfoOption || // And parameter 'info' should not be given twice
 					TRUE == fHelpOption ||
 					TRUE == fUpdateOption ||
 					TRUE == fFwPathUpdateOption ||
 					TRUE == fClearOwnership ||
-					TRUE == fConfigFileOption)
+					TRUE == fConfigFileOption ||
+					TRUE == fBuildIndexOption ||
+					TRUE == fVerifyFolderOption)
 				unReturnValue = RC_E_BAD_COMMANDLINE;
 			break;
 		}
@@ -733,12 +912,14 @@ CommandLineParser_CheckCommandLineOptions(
 		// **** -update [Update]
 		if (0 == Platform_StringCompare(PwszCommand, CMD_UPDATE, RG_LEN(CMD_UPDATE), TRUE))
 		{
-			// Command line parameter 'update' combined with parameters 'help', 'info', 'tpm12-clearownership', or 'config' is a bad command line
+			// Command line parameter 'update' combined with parameters 'help', 'info', 'tpm12-clearownership', 'config', 'build-index' or 'verify-folder' is a bad command line
 			if (TRUE == fUpdateOption || // And parameter 'update' should not be given twice
 					TRUE == fHelpOption ||
 					TRUE == fInfoOption ||
 					TRUE == fClearOwnership ||
-					TRUE == fConfigFileOption)
+					TRUE == fConfigFileOption ||
+					TRUE == fBuildIndexOption ||
+					TRUE == fVerifyFolderOption)
 				unReturnValue = RC_E_BAD_COMMANDLINE;
 			break;
 		}
@@ -756,12 +937,14 @@ CommandLineParser_CheckCommandLineOptions(
 		// **** -firmware [Firmware]
 		if (0 == Platform_StringCompare(PwszCommand, CMD_FIRMWARE, RG_LEN(CMD_FIRMWARE), TRUE))
 		{
-			// Command line parameter 'firmware' combined with parameters 'help', 'info', 'tpm12-clearownership' or 'config' is a bad command line
+			// Command line parameter 'firmware' combined with parameters 'help', 'info', 'tpm12-clearownership', 'config', 'build-index' or 'verify-folder' is a bad command line
 			if (TRUE == fFwPathUpdateOption || // And parameter 'firmware' should not be given twice
 					TRUE == fHelpOption ||
 					TRUE == fInfoOption ||
 					TRUE == fClearOwnership ||
-					TRUE == fConfigFileOption)
+					TRUE == fConfigFileOption ||
+					TRUE == fBuildIndexOption ||
+					TRUE == fVerifyFolderOption)
 				unReturnValue = RC_E_BAD_COMMANDLINE;
 			break;
 		}
@@ -769,13 +952,15 @@ CommandLineParser_CheckCommandLineOptions(
 		// **** -tpm12-clearownership [TPM12-ClearOwnership]
 		if (0 == Platform_StringCompare(PwszCommand, CMD_TPM12_CLEAROWNERSHIP, RG_LEN(CMD_TPM12_CLEAROWNERSHIP), TRUE))
 		{
-			// Command line parameter 'tpm12-clearownership' combined with parameters 'help', 'info', 'update', 'firmware' or 'config' is a bad command line
+			// Command line parameter 'tpm12-clearownership' combined with parameters 'help', 'info', 'update', 'firmware', 'config', 'build-index' or 'verify-folder' is a bad command line
 			if (TRUE == fClearOwnership || // And parameter 'tpm12-clearownership' should not be given twice
 					TRUE == fHelpOption ||
 					TRUE == fInfoOption ||
 					TRUE == fUpdateOption ||
 					TRUE == fFwPathUpdateOption ||
-					TRUE == fConfigFileOption)
+					TRUE == fConfigFileOption ||
+					TRUE == fBuildIndexOption ||
+					TRUE == fVerifyFolderOption)
 				unReturnValue = RC_E_BAD_COMMANDLINE;
 			break;
 		}
@@ -793,12 +978,14 @@ CommandLineParser_CheckCommandLineOptions(
 		// **** -config [Configuration File]
 		if (0 == Platform_StringCompare(PwszCommand, CMD_CONFIG, RG_LEN(CMD_CONFIG), TRUE))
 		{
-			// Command line parameter 'config' combined with parameters 'help', 'info', 'tpm12-clearownership' or 'firmware' is a bad command line
+			// Command line parameter 'config' combined with parameters 'help', 'info', 'tpm12-clearownership', 'firmware', 'build-index' or 'verify-folder' is a bad command line
 			if (TRUE == fConfigFileOption || // And parameter 'config' should not be given twice
 					TRUE == fHelpOption ||
 					TRUE == fInfoOption ||
 					TRUE == fClearOwnership ||
-					TRUE == fFwPathUpdateOption)
+					TRUE == fFwPathUpdateOption ||
+					TRUE == fBuildIndexOption ||
+					TRUE == fVerifyFolderOption)
 				unReturnValue = RC_E_BAD_COMMANDLINE;
 			break;
 		}
@@ -821,6 +1008,58 @@ CommandLineParser_CheckCommandLineOptions(
 			break;
 		}
 
+		// **** -timing [Timing]
+		if (0 == Platform_StringCompare(PwszCommand, CMD_TIMING, RG_LEN(CMD_TIMING), TRUE))
+		{
+			// Command line parameter 'timing' combined with parameter 'help' is a bad command line
+			if (TRUE == fTimingOption || // And parameter 'timing' should not be given twice
+					TRUE == fHelpOption)
+				unReturnValue = RC_E_BAD_COMMANDLINE;
+			break;
+		}
+
+		// **** -build-index [BuildIndex]
+		if (0 == Platform_StringCompare(PwszCommand, CMD_BUILD_INDEX, RG_LEN(CMD_BUILD_INDEX), TRUE))
+		{
+			// Command line parameter 'build-index' combined with parameters 'help', 'info', 'update', 'firmware', 'tpm12-clearownership', 'config' or 'verify-folder' is a bad command line
+			if (TRUE == fBuildIndexOption || // And parameter 'build-index' should not be given twice
+					TRUE == fHelpOption ||
+					TRUE == fInfoOption ||
+					TRUE == fUpdateOption ||
+					TRUE == fFwPathUpdateOption ||
+					TRUE == fClearOwnership ||
+					TRUE == fConfigFileOption ||
+					TRUE == fVerifyFolderOption)
+				unReturnValue = RC_E_BAD_COMMANDLINE;
+			break;
+		}
+
+		// **** -verify-folder [VerifyFolder]
+		if (0 == Platform_StringCompare(PwszCommand, CMD_VERIFY_FOLDER, RG_LEN(CMD_VERIFY_FOLDER), TRUE))
+		{
+			// Command line parameter 'verify-folder' combined with parameters 'help', 'info', 'update', 'firmware', 'tpm12-clearownership', 'config' or 'build-index' is a bad command line
+			if (TRUE == fVerifyFolderOption || // And parameter 'verify-folder' should not be given twice
+					TRUE == fHelpOption ||
+					TRUE == fInfoOption ||
+					TRUE == fUpdateOption ||
+					TRUE == fFwPathUpdateOption ||
+					TRUE == fClearOwnership ||
+					TRUE == fConfigFileOption ||
+					TRUE == fBuildIndexOption)
+				unReturnValue = RC_E_BAD_COMMANDLINE;
+			break;
+		}
+
+		// **** -verify-report [VerifyReport]
+		if (0 == Platform_StringCompare(PwszCommand, CMD_VERIFY_REPORT, RG_LEN(CMD_VERIFY_REPORT), TRUE))
+		{
+			// Command line parameter 'verify-report' combined with parameter 'help' is a bad command line
+			if (TRUE == fVerifyReportOption || // And parameter 'verify-report' should not be given twice
+					TRUE == fHelpOption)
+				unReturnValue = RC_E_BAD_COMMANDLINE;
+			break;
+		}
+
 		unReturnValue = RC_E_BAD_COMMANDLINE;
 	}
 	WHILE_FALSE_END;
@@ -15,6 +15,8 @@
 
 #include "ConfigSettings.h"
 #include "IConfigSettings.h"
+#include "TpmSimulator.h"
+#include "ImageCache.h"
 
 /**
  *	@brief		Initialize configuration settings parsing
@@ -44,6 +46,7 @@ ConfigSettings_InitializeParsing()
 			ERROR_STORE_FMT(unReturnValue, wszErrorMsgFormat, PROPERTY_LOGGING_LEVEL);
 			break;
 		}
+		Logging_UpdateLevel();
 
 		// Set default LogPath
 		if (PropertyStorage_ExistsElement(PROPERTY_LOGGING_PATH))
@@ -67,6 +70,17 @@ ConfigSettings_InitializeParsing()
 			break;
 		}
 
+		// Set default asynchronous logging
+		if (PropertyStorage_ExistsElement(PROPERTY_LOGGING_ASYNC))
+			fReturnValue = PropertyStorage_ChangeUIntegerValueByKey(PROPERTY_LOGGING_ASYNC, LOGGING_ASYNC_DEFAULT);
+		else
+			fReturnValue = PropertyStorage_AddKeyUIntegerValuePair(PROPERTY_LOGGING_ASYNC, LOGGING_ASYNC_DEFAULT);
+		if (!fReturnValue)
+		{
+			ERROR_STORE_FMT(unReturnValue, wszErrorMsgFormat, PROPERTY_LOGGING_ASYNC);
+			break;
+		}
+
 		// Set default console mode: CONSOLE_BUFFER_NONE
 		if (PropertyStorage_ExistsElement(PROPERTY_CONSOLE_MODE))
 			fReturnValue = PropertyStorage_ChangeUIntegerValueByKey(PROPERTY_CONSOLE_MODE, CONSOLE_BUFFER_NONE);
@@ -170,6 +184,7 @@ ConfigSettings_Parse(
 					ERROR_STORE_FMT(unReturnValue, wszErrorMsgFormat, PROPERTY_LOGGING_LEVEL);
 					break;
 				}
+				Logging_UpdateLevel();
 
 				unReturnValue = RC_SUCCESS;
 				break;
@@ -203,6 +218,20 @@ ConfigSettings_Parse(
 				break;
 			}
 
+			// Check asynchronous logging
+			if (0 == Platform_StringCompare(PwszKey, CONFIG_KEY_LOGGING_ASYNC, PunKeySize, FALSE))
+			{
+				// Store setting value
+				if (FALSE == PropertyStorage_ChangeValueByKey(PROPERTY_LOGGING_ASYNC, PwszValue))
+				{
+					ERROR_STORE_FMT(unReturnValue, wszErrorMsgFormat, PROPERTY_LOGGING_ASYNC);
+					break;
+				}
+
+				unReturnValue = RC_SUCCESS;
+				break;
+			}
+
 			// Unknown setting in current section
 			unReturnValue = RC_SUCCESS;
 			break;
@@ -272,6 +301,63 @@ ConfigSettings_Parse(
 			unReturnValue = RC_SUCCESS;
 			break;
 		}
+
+		// Check section SIMULATOR options
+		if (0 == Platform_StringCompare(PwszSection, CONFIG_SECTION_SIMULATOR, PunSectionSize, FALSE))
+		{
+			// Settings and the properties they are stored in
+			const wchar_t* rgwszSettings[][2] =
+			{
+				{ CONFIG_KEY_SIMULATOR_LATENCY, PROPERTY_SIMULATOR_LATENCY },
+				{ CONFIG_KEY_SIMULATOR_FAIL_COMMAND, PROPERTY_SIMULATOR_FAIL_COMMAND },
+				{ CONFIG_KEY_SIMULATOR_FAIL_RC, PROPERTY_SIMULATOR_FAIL_RESPONSE_CODE },
+				{ CONFIG_KEY_SIMULATOR_FAIL_AFTER, PROPERTY_SIMULATOR_FAIL_AFTER },
+				{ CONFIG_KEY_SIMULATOR_FIRMWARE_VERSION_1, PROPERTY_SIMULATOR_FIRMWARE_VERSION_1 },
+				{ CONFIG_KEY_SIMULATOR_FIRMWARE_VERSION_2, PROPERTY_SIMULATOR_FIRMWARE_VERSION_2 },
+				{ CONFIG_KEY_SIMULATOR_FIELD_UPGRADE_COUNTER, PROPERTY_SIMULATOR_FIELD_UPGRADE_COUNTER },
+				{ CONFIG_KEY_SIMULATOR_DECRYPT_KEY_ID, PROPERTY_SIMULATOR_DECRYPT_KEY_ID }
+			};
+			unsigned int unIndex = 0;
+
+			// Unknown settings in the current section are ignored
+			unReturnValue = RC_SUCCESS;
+			for (unIndex = 0; unIndex < RG_LEN(rgwszSettings); unIndex++)
+			{
+				if (0 != Platform_StringCompare(PwszKey, rgwszSettings[unIndex][0], PunKeySize, FALSE))
+					continue;
+
+				// Store setting value
+				if (!PropertyStorage_AddKeyValuePair(rgwszSettings[unIndex][1], PwszValue) &&
+						!PropertyStorage_ChangeValueByKey(rgwszSettings[unIndex][1], PwszValue))
+				{
+					unReturnValue = RC_E_FAIL;
+					ERROR_STORE_FMT(unReturnValue, wszErrorMsgFormat, rgwszSettings[unIndex][1]);
+				}
+				break;
+			}
+			break;
+		}
+
+		// Check section IMAGE_CACHE options
+		if (0 == Platform_StringCompare(PwszSection, CONFIG_SECTION_IMAGE_CACHE, PunSectionSize, FALSE))
+		{
+			// Check cache file path
+			if (0 == Platform_StringCompare(PwszKey, CONFIG_KEY_IMAGE_CACHE_PATH, PunKeySize, FALSE))
+			{
+				// Store setting value
+				if (!PropertyStorage_AddKeyValuePair(PROPERTY_IMAGE_CACHE_PATH, PwszValue) &&
+						!PropertyStorage_ChangeValueByKey(PROPERTY_IMAGE_CACHE_PATH, PwszValue))
+				{
+					ERROR_STORE_FMT(unReturnValue, wszErrorMsgFormat, PROPERTY_IMAGE_CACHE_PATH);
+					break;
+				}
+			}
+
+			// Unknown settings in the current section are ignored
+			unReturnValue = RC_SUCCESS;
+			break;
+		}
+
 		// Unknown section
 		unReturnValue = RC_SUCCESS;
 	}
@@ -337,6 +423,14 @@ ConfigSettings_FinalizeParsing(
 			}
 			LOGGING_WRITE_LEVEL4_FMT(L"%ls: %ls", PROPERTY_LOGGING_MAXSIZE, wszValue);
 
+			unValueSize = RG_LEN(wszValue);
+			if (FALSE == PropertyStorage_GetValueByKey(PROPERTY_LOGGING_ASYNC, wszValue, &unValueSize))
+			{
+				ERROR_STORE_FMT(unReturnValue, wszErrorMsgFormat, PROPERTY_LOGGING_ASYNC);
+				break;
+			}
+			LOGGING_WRITE_LEVEL4_FMT(L"%ls: %ls", PROPERTY_LOGGING_ASYNC, wszValue);
+
 			unValueSize = RG_LEN(wszValue);
 			if (FALSE == PropertyStorage_GetValueByKey(PROPERTY_LOCALITY, wszValue, &unValueSize))
 			{
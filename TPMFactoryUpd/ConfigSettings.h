@@ -28,6 +28,8 @@ extern "C" {
 #define CONFIG_KEY_LOGGING_PATH			L"PATH"
 /// Define for LOGGING section setting MAXSIZE
 #define CONFIG_KEY_LOGGING_MAXSIZE		L"MAXSIZE"
+/// Define for LOGGING section setting ASYNC
+#define CONFIG_KEY_LOGGING_ASYNC		L"ASYNC"
 
 /// Define for configuration section ACCESS_MODE
 #define CONFIG_SECTION_ACCESS_MODE		L"ACCESS_MODE"
@@ -43,6 +45,30 @@ extern "C" {
 /// Define for TPM_DEVICE_ACCESS section setting MODE
 #define CONFIG_KEY_TPM_DEVICE_ACCESS_MODE	L"MODE"
 
+/// Define for configuration section SIMULATOR
+#define CONFIG_SECTION_SIMULATOR				L"SIMULATOR"
+/// Define for SIMULATOR section setting LATENCY
+#define CONFIG_KEY_SIMULATOR_LATENCY			L"LATENCY"
+/// Define for SIMULATOR section setting FAIL_COMMAND
+#define CONFIG_KEY_SIMULATOR_FAIL_COMMAND		L"FAIL_COMMAND"
+/// Define for SIMULATOR section setting FAIL_RC
+#define CONFIG_KEY_SIMULATOR_FAIL_RC			L"FAIL_RC"
+/// Define for SIMULATOR section setting FAIL_AFTER
+#define CONFIG_KEY_SIMULATOR_FAIL_AFTER			L"FAIL_AFTER"
+/// Define for SIMULATOR section setting FIRMWARE_VERSION_1
+#define CONFIG_KEY_SIMULATOR_FIRMWARE_VERSION_1	L"FIRMWARE_VERSION_1"
+/// Define for SIMULATOR section setting FIRMWARE_VERSION_2
+#define CONFIG_KEY_SIMULATOR_FIRMWARE_VERSION_2	L"FIRMWARE_VERSION_2"
+/// Define for SIMULATOR section setting FIELD_UPGRADE_COUNTER
+#define CONFIG_KEY_SIMULATOR_FIELD_UPGRADE_COUNTER	L"FIELD_UPGRADE_COUNTER"
+/// Define for SIMULATOR section setting DECRYPT_KEY_ID
+#define CONFIG_KEY_SIMULATOR_DECRYPT_KEY_ID		L"DECRYPT_KEY_ID"
+
+/// Define for configuration section IMAGE_CACHE
+#define CONFIG_SECTION_IMAGE_CACHE		L"IMAGE_CACHE"
+/// Define for IMAGE_CACHE section setting PATH
+#define CONFIG_KEY_IMAGE_CACHE_PATH		L"PATH"
+
 /// Define for update-file config section UpdateType
 #define CONFIG_SECTION_UPDATE_TYPE		L"UpdateType"
 /// Define for UpdateType section setting tpm12
@@ -64,6 +90,9 @@ extern "C" {
 /// Set to 0 to disable and ensure log file is opened in O_APPEND mode.
 #define LOGGING_FILE_MAX_SIZE			0
 
+/// Default for asynchronous logging (0: disabled, 1: enabled)
+#define LOGGING_ASYNC_DEFAULT			0
+
 /// Definition of Locality 0 for accessing TPM
 #define LOCALITY_0						0
 
@@ -19,6 +19,8 @@
 #include "CommandFlow_TpmInfo.h"
 #include "CommandFlow_TpmUpdate.h"
 #include "CommandFlow_Tpm12ClearOwnership.h"
+#include "CommandFlow_BuildIndex.h"
+#include "CommandFlow_VerifyFolder.h"
 
 /**
  *	@brief		This function shows the response output
@@ -107,6 +109,10 @@ Controller_Proceed(
 	if (NULL != pResponseData && STRUCT_TYPE_TpmUpdate == pResponseData->unType)
 		Platform_MemoryFree((void**) & (((IfxUpdate*)pResponseData)->rgbFirmwareImage));
 
+	// Check if structure type is VerifyFolder to free the verification results
+	if (NULL != pResponseData && STRUCT_TYPE_VerifyFolder == pResponseData->unType)
+		Platform_MemoryFree((void**)&((IfxVerifyFolder*)pResponseData)->rgsResults);
+
 	// Free allocated memory
 	Platform_MemoryFree((void**)&pResponseData);
 
@@ -144,6 +150,142 @@ Controller_Proceed(
 
 	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
 
+	// Write all buffered log messages to the log file before exiting
+	IGNORE_RETURN_VALUE(Logging_Close());
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		This function runs one firmware update
+ *	@details	Gets the TPM information, selects the firmware image and updates the TPM firmware. For an upgrade plan only
+ *				the first update of the plan is done; PpfContinuePlan reports whether further updates of the plan remain.
+ *
+ *	@param		PppResponseData		Pointer to a IfxToolHeader structure; inner pointer
+ *									must be initialized with NULL or allocated on the heap!
+ *	@param		PunUpdateType		Update type from the command line
+ *	@param		PpfContinuePlan		Receives TRUE if the update of an upgrade plan succeeded and the plan has further updates
+ *	@retval		RC_SUCCESS			The operation completed successfully.
+ *	@retval		...					Error codes from called functions.
+ */
+_Check_return_
+static
+unsigned int
+Controller_ProceedUpdate(
+	_Inout_	IfxToolHeader**	PppResponseData,
+	_In_	unsigned int	PunUpdateType,
+	_Out_	BOOL*			PpfContinuePlan)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		BOOL fDryRun = FALSE;
+
+		*PpfContinuePlan = FALSE;
+
+		// Release the firmware image of a previous update of the upgrade plan
+		if (NULL != *PppResponseData && STRUCT_TYPE_TpmUpdate == (*PppResponseData)->unType)
+			Platform_MemoryFree((void**) & (((IfxUpdate*)*PppResponseData)->rgbFirmwareImage));
+
+		// Allocate memory
+		Platform_MemoryFree((void**)PppResponseData);
+		*PppResponseData = (IfxToolHeader*)Platform_MemoryAllocateZero(sizeof(IfxUpdate));
+		if (NULL == *PppResponseData)
+		{
+			unReturnValue = RC_E_FAIL;
+			ERROR_STORE(unReturnValue, L"Error detected in Controller_ProceedUpdate: Memory allocation failed.");
+			break;
+		}
+
+		// Get the TPM information and use the update structure to store the data
+		(*PppResponseData)->unType = STRUCT_TYPE_TpmInfo;
+		(*PppResponseData)->unSize = sizeof(IfxInfo);
+		unReturnValue = CommandFlow_TpmInfo_Execute((IfxInfo*)*PppResponseData);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		// Execute command
+		(*PppResponseData)->unSize = sizeof(IfxUpdate);
+		(*PppResponseData)->unType = STRUCT_TYPE_TpmUpdate;
+
+		// If update type is config file parse configuration file
+		if (UPDATE_TYPE_CONFIG_FILE == PunUpdateType)
+		{
+			unReturnValue = CommandFlow_TpmUpdate_ProceedUpdateConfig((IfxUpdate*)*PppResponseData);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+		}
+		// If update type is plan parse configuration file and compute the upgrade plan
+		else if (UPDATE_TYPE_PLAN == PunUpdateType)
+		{
+			unReturnValue = CommandFlow_TpmUpdate_ProceedUpdatePlan((IfxUpdate*)*PppResponseData);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+		}
+
+		// Check if firmware is updatable with the given image
+		if(RC_E_ALREADY_UP_TO_DATE != (*PppResponseData)->unReturnCode)
+		{
+			unReturnValue = CommandFlow_TpmUpdate_IsFirmwareUpdatable((IfxUpdate*)*PppResponseData);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+		}
+
+		unReturnValue = Controller_ShowResponse(*PppResponseData);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		if (RC_SUCCESS != (*PppResponseData)->unReturnCode)
+		{
+			if (RC_E_ALREADY_UP_TO_DATE == (*PppResponseData)->unReturnCode)
+				unReturnValue = RC_SUCCESS;
+			else
+				unReturnValue = (*PppResponseData)->unReturnCode;
+			break;
+		}
+
+		// Do preparation steps
+		unReturnValue = CommandFlow_TpmUpdate_PrepareFirmwareUpdate((IfxUpdate*)*PppResponseData);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+		unReturnValue = Controller_ShowResponse(*PppResponseData);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		if (RC_SUCCESS != (*PppResponseData)->unReturnCode)
+		{
+			unReturnValue = (*PppResponseData)->unReturnCode;
+			break;
+		}
+
+		// Do a firmware update
+		unReturnValue = CommandFlow_TpmUpdate_UpdateFirmware((IfxUpdate*)*PppResponseData);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		unReturnValue = Controller_ShowResponse(*PppResponseData);
+		if (RC_SUCCESS != unReturnValue)
+			break;
+
+		if (RC_SUCCESS != (*PppResponseData)->unReturnCode)
+		{
+			unReturnValue = (*PppResponseData)->unReturnCode;
+			break;
+		}
+
+		// Continue with the next update if the upgrade plan has more than the update just done. A dry run does not change
+		// the TPM firmware, so it stops after the first update of the plan.
+		if (UPDATE_TYPE_PLAN == PunUpdateType && ((IfxUpdate*)*PppResponseData)->sUpgradePlan.unHopCount > 1 &&
+				!(TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_DRY_RUN, &fDryRun) && TRUE == fDryRun))
+			*PpfContinuePlan = TRUE;
+	}
+	WHILE_FALSE_END;
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
 	return unReturnValue;
 }
 
@@ -230,27 +372,8 @@ Controller_ProceedWork(
 		if (TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_UPDATE, &fValue) && TRUE == fValue)
 		{
 			unsigned int unUpdateType = UPDATE_TYPE_NONE;
-
-			// Allocate memory
-			Platform_MemoryFree((void**)PppResponseData);
-			*PppResponseData = (IfxToolHeader*)Platform_MemoryAllocateZero(sizeof(IfxUpdate));
-			if (NULL == *PppResponseData)
-			{
-				unReturnValue = RC_E_FAIL;
-				ERROR_STORE(unReturnValue, L"Error detected in Controller_ProceedWork: Memory allocation failed.");
-				break;
-			}
-
-			// Get the TPM information and use the update structure to store the data
-			(*PppResponseData)->unType = STRUCT_TYPE_TpmInfo;
-			(*PppResponseData)->unSize = sizeof(IfxInfo);
-			unReturnValue = CommandFlow_TpmInfo_Execute((IfxInfo*)*PppResponseData);
-			if (RC_SUCCESS != unReturnValue)
-				break;
-
-			// Execute command
-			(*PppResponseData)->unSize = sizeof(IfxUpdate);
-			(*PppResponseData)->unType = STRUCT_TYPE_TpmUpdate;
+			unsigned int unUpdateCount = 0;
+			BOOL fContinuePlan = FALSE;
 
 			// Get property "update type"
 			if (FALSE == PropertyStorage_GetUIntegerValueByKey(PROPERTY_UPDATE_TYPE, &unUpdateType))
@@ -260,39 +383,38 @@ Controller_ProceedWork(
 				break;
 			}
 
-			// If update type is config file parse configuration file
-			if (UPDATE_TYPE_CONFIG_FILE == unUpdateType)
+			// Run the update; an upgrade plan continues with its next update as long as the TPM can proceed without a restart
+			do
 			{
-				unReturnValue = CommandFlow_TpmUpdate_ProceedUpdateConfig((IfxUpdate*)*PppResponseData);
-				if (RC_SUCCESS != unReturnValue)
-					break;
+				unReturnValue = Controller_ProceedUpdate(PppResponseData, unUpdateType, &fContinuePlan);
+				unUpdateCount++;
 			}
+			while (RC_SUCCESS == unReturnValue && fContinuePlan && unUpdateCount < UPGRADE_PLANNER_MAX_HOPS);
 
-			// Check if firmware is updatable with the given image
-			if(RC_E_ALREADY_UP_TO_DATE != (*PppResponseData)->unReturnCode)
-			{
-				unReturnValue = CommandFlow_TpmUpdate_IsFirmwareUpdatable((IfxUpdate*)*PppResponseData);
-				if (RC_SUCCESS != unReturnValue)
-					break;
-			}
-
-			unReturnValue = Controller_ShowResponse(*PppResponseData);
-			if (RC_SUCCESS != unReturnValue)
-				break;
+			break;
+		}
 
-			if (RC_SUCCESS != (*PppResponseData)->unReturnCode)
+		// Check if TPM12-ClearOwnership is set
+		if (TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_TPM12_CLEAROWNERSHIP, &fValue) && TRUE == fValue)
+		{
+			// Allocate memory
+			Platform_MemoryFree((void**)PppResponseData);
+			*PppResponseData = (IfxToolHeader*)Platform_MemoryAllocateZero(sizeof(IfxTpm12ClearOwnership));
+			if (NULL == *PppResponseData)
 			{
-				if (RC_E_ALREADY_UP_TO_DATE == (*PppResponseData)->unReturnCode)
-					unReturnValue = RC_SUCCESS;
-				else
-					unReturnValue = (*PppResponseData)->unReturnCode;
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE(unReturnValue, L"Error detected in Controller_ProceedWork: Memory allocation failed.");
 				break;
 			}
+			// Execute command
+			(*PppResponseData)->unSize = sizeof(IfxTpm12ClearOwnership);
+			(*PppResponseData)->unType = STRUCT_TYPE_Tpm12ClearOwnership;
 
-			// Do preparation steps
-			unReturnValue = CommandFlow_TpmUpdate_PrepareFirmwareUpdate((IfxUpdate*)*PppResponseData);
+			unReturnValue = CommandFlow_Tpm12ClearOwnership_Execute((IfxToolHeader*)*PppResponseData);
 			if (RC_SUCCESS != unReturnValue)
 				break;
+
+			// Show command response
 			unReturnValue = Controller_ShowResponse(*PppResponseData);
 			if (RC_SUCCESS != unReturnValue)
 				break;
@@ -303,30 +425,42 @@ Controller_ProceedWork(
 				break;
 			}
 
-			// Do a firmware update
-			unReturnValue = CommandFlow_TpmUpdate_UpdateFirmware((IfxUpdate*)*PppResponseData);
-			if (RC_SUCCESS != unReturnValue)
-				break;
-
-			unReturnValue = Controller_ShowResponse(*PppResponseData);
-			if (RC_SUCCESS != unReturnValue)
-				break;
+			break;
+		}
 
-			if (RC_SUCCESS != (*PppResponseData)->unReturnCode)
+		// Check if BuildIndex is set
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_BUILD_INDEX_PATH))
+		{
+			// Allocate memory
+			Platform_MemoryFree((void**)PppResponseData);
+			*PppResponseData = (IfxToolHeader*)Platform_MemoryAllocateZero(sizeof(IfxBuildIndex));
+			if (NULL == *PppResponseData)
 			{
-				unReturnValue = (*PppResponseData)->unReturnCode;
+				unReturnValue = RC_E_FAIL;
+				ERROR_STORE(unReturnValue, L"Error detected in Controller_ProceedWork: Memory allocation failed.");
 				break;
 			}
+			// Execute command
+			(*PppResponseData)->unSize = sizeof(IfxBuildIndex);
+			(*PppResponseData)->unType = STRUCT_TYPE_BuildIndex;
 
+			unReturnValue = CommandFlow_BuildIndex_Execute((IfxBuildIndex*)*PppResponseData);
+			if (RC_SUCCESS != unReturnValue)
+				break;
+
+			// Show command response
+			unReturnValue = Controller_ShowResponse(*PppResponseData);
 			break;
 		}
 
-		// Check if TPM12-ClearOwnership is set
-		if (TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_TPM12_CLEAROWNERSHIP, &fValue) && TRUE == fValue)
+		// Check if VerifyFolder is set
+		if (TRUE == PropertyStorage_ExistsElement(PROPERTY_VERIFY_FOLDER_PATH))
 		{
+			IfxVerifyFolder* pVerifyFolder = NULL;
+
 			// Allocate memory
 			Platform_MemoryFree((void**)PppResponseData);
-			*PppResponseData = (IfxToolHeader*)Platform_MemoryAllocateZero(sizeof(IfxTpm12ClearOwnership));
+			*PppResponseData = (IfxToolHeader*)Platform_MemoryAllocateZero(sizeof(IfxVerifyFolder));
 			if (NULL == *PppResponseData)
 			{
 				unReturnValue = RC_E_FAIL;
@@ -334,10 +468,11 @@ Controller_ProceedWork(
 				break;
 			}
 			// Execute command
-			(*PppResponseData)->unSize = sizeof(IfxTpm12ClearOwnership);
-			(*PppResponseData)->unType = STRUCT_TYPE_Tpm12ClearOwnership;
+			(*PppResponseData)->unSize = sizeof(IfxVerifyFolder);
+			(*PppResponseData)->unType = STRUCT_TYPE_VerifyFolder;
+			pVerifyFolder = (IfxVerifyFolder*)*PppResponseData;
 
-			unReturnValue = CommandFlow_Tpm12ClearOwnership_Execute((IfxToolHeader*)*PppResponseData);
+			unReturnValue = CommandFlow_VerifyFolder_Execute(pVerifyFolder);
 			if (RC_SUCCESS != unReturnValue)
 				break;
 
@@ -346,9 +481,11 @@ Controller_ProceedWork(
 			if (RC_SUCCESS != unReturnValue)
 				break;
 
-			if (RC_SUCCESS != (*PppResponseData)->unReturnCode)
+			if (RC_SUCCESS != pVerifyFolder->unReturnCode)
 			{
-				unReturnValue = (*PppResponseData)->unReturnCode;
+				unReturnValue = pVerifyFolder->unReturnCode;
+				ERROR_STORE_FMT(unReturnValue, L"%d of %d files in the firmware folder are not valid firmware images.",
+					pVerifyFolder->unResultCount - pVerifyFolder->unValidCount, pVerifyFolder->unResultCount);
 				break;
 			}
 
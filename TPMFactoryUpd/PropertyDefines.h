@@ -31,6 +31,8 @@ extern "C" {
 #define PROPERTY_LOGGING_PATH			L"LoggingPath"
 /// Define for logging max file size configuration setting property
 #define PROPERTY_LOGGING_MAXSIZE		L"LoggingMaxSize"
+/// Define for asynchronous logging configuration setting property
+#define PROPERTY_LOGGING_ASYNC			L"LoggingAsync"
 /// Define for console mode configuration setting property
 #define PROPERTY_CONSOLE_MODE			L"ConsoleMode"
 /// Define for locality configuration setting property
@@ -70,6 +72,14 @@ extern "C" {
 #define PROPERTY_DRY_RUN				L"DryRun"
 /// Define for IgnoreErrorOnComplete property
 #define PROPERTY_IGNORE_ERROR_ON_COMPLETE		L"IgnoreErrorOnComplete"
+/// Define for timing report path property
+#define PROPERTY_TIMING_PATH			L"TimingPath"
+/// Define for build index firmware folder property
+#define PROPERTY_BUILD_INDEX_PATH		L"BuildIndex"
+/// Define for verify folder firmware folder property
+#define PROPERTY_VERIFY_FOLDER_PATH		L"VerifyFolder"
+/// Define for verify folder report path property
+#define PROPERTY_VERIFY_REPORT_PATH		L"VerifyReport"
 
 #ifdef __cplusplus
 }
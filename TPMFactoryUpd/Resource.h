@@ -91,6 +91,11 @@
 #define RES_TPM_UPDATE_FAIL							L"       TPM Firmware Update failed."
 #define RES_TPM_UPDATE_PROGRESS						L"       Completion: %d %%\r"
 #define RES_TPM_UPDATE_FACTORYDEFAULT				L"       TPM chip state after update       :    reset to factory defaults"
+#define RES_TPM_UPDATE_PLAN							L"       Update plan                       :    %d update(s), about %d minute(s)"
+#define RES_TPM_UPDATE_PLAN_HOP						L"         %d. TPM%ls %ls -> TPM%ls %ls%ls"
+#define RES_TPM_UPDATE_PLAN_HOP_FACTORYDEFAULT		L" (reset to factory defaults)"
+#define RES_TPM_UPDATE_PLAN_HOP_FILE				L"            %ls"
+#define RES_TPM_UPDATE_PLAN_DRY_RUN					L"         Dry run: Only update 1 of the plan is simulated."
 
 //---------------- Tpm12_ClearOwnership response ------------
 #define RES_TPM12_CLEAR_OWNER_INFORMATION			L"       TPM1.2 Clear Ownership:"
@@ -98,6 +103,29 @@
 #define RES_TPM12_CLEAR_OWNER_SUCCESS				L"       Clear TPM1.2 Ownership operation completed successfully."
 #define RES_TPM12_CLEAR_OWNER_FAILED				L"       Clear TPM1.2 Ownership operation failed. (0x%.8X)"
 
+//---------------- BuildIndex response ------------
+#define RES_BUILD_INDEX_INFORMATION					L"       Firmware Catalog Index:"
+#define RES_BUILD_INDEX_DASHED_LINE					L"       -----------------------"
+#define RES_BUILD_INDEX_FOLDER						L"       Firmware folder                   :    %ls"
+#define RES_BUILD_INDEX_IMAGES						L"       Indexed firmware images           :    %d"
+#define RES_BUILD_INDEX_SKIPPED						L"       Skipped files                     :    %d"
+#define RES_BUILD_INDEX_SUCCESS						L"       Firmware catalog index written successfully."
+
+//---------------- VerifyFolder response ------------
+#define RES_VERIFY_FOLDER_INFORMATION				L"       Firmware Folder Verification:"
+#define RES_VERIFY_FOLDER_DASHED_LINE				L"       -----------------------------"
+#define RES_VERIFY_FOLDER_FOLDER					L"       Firmware folder                   :    %ls"
+#define RES_VERIFY_FOLDER_FILES						L"       Verified files                    :    %d"
+#define RES_VERIFY_FOLDER_VALID						L"       Valid firmware images             :    %d"
+#define RES_VERIFY_FOLDER_INVALID					L"       Invalid files                     :    %d"
+#define RES_VERIFY_FOLDER_THREADS					L"       Worker threads                    :    %d"
+#define RES_VERIFY_FOLDER_DURATION					L"       Duration                          :    %llu ms"
+#define RES_VERIFY_FOLDER_REPORT					L"       Report file                       :    %ls"
+#define RES_VERIFY_FOLDER_TABLE_HEADER				L"       File                                             Result   Details"
+#define RES_VERIFY_FOLDER_TABLE_LINE				L"       ------------------------------------------------ -------- -------"
+#define RES_VERIFY_FOLDER_ROW_VALID					L"       %-48ls Valid    TPM%ls -> TPM%ls %ls"
+#define RES_VERIFY_FOLDER_ROW_INVALID				L"       %-48ls Invalid  %ls (0x%.8X)"
+
 // --------------- Command line options ---------------------
 #define CMD_HELP									L"help"
 #define CMD_HELP_ALT								L"?"
@@ -108,6 +136,7 @@
 #define CMD_UPDATE_OPTION_TPM12_OWNERAUTH		L"tpm12-ownerauth"
 #define CMD_UPDATE_OPTION_TPM20_EMPTYPLATFORMAUTH	L"tpm20-emptyplatformauth"
 #define CMD_UPDATE_OPTION_CONFIG_FILE				L"config-file"
+#define CMD_UPDATE_OPTION_PLAN						L"plan"
 #define CMD_FIRMWARE								L"firmware"
 #define CMD_LOG										L"log"
 #define CMD_TPM12_CLEAROWNERSHIP					L"tpm12-clearownership"
@@ -115,6 +144,10 @@
 #define CMD_CONFIG									L"config"
 #define CMD_DRY_RUN									L"dry-run"
 #define CMD_IGNORE_ERROR_ON_COMPLETE				L"ignore-error-on-complete"
+#define CMD_TIMING									L"timing"
+#define CMD_BUILD_INDEX								L"build-index"
+#define CMD_VERIFY_FOLDER							L"verify-folder"
+#define CMD_VERIFY_REPORT							L"verify-report"
 
 // --------------- Help Output ---------------------
 #define HELP_LINE1		L"Call: TPMFactoryUpd [parameter] [parameter] ..."
@@ -142,7 +175,7 @@
 #define HELP_LINE23		L"  Cannot be used with -%ls, -%ls or -%ls parameter." /* Use with format CMD_INFO, CMD_CONFIG and CMD_TPM12_CLEAROWNERSHIP*/
 #define HELP_LINE24		L"\n-%ls <config-file>" /* Use with format CMD_CONFIG */
 #define HELP_LINE25		L"  Specifies the path to the configuration file to be used for TPM Firmware Update."
-#define HELP_LINE26		L"  Required if -%ls parameter is given with value %ls." /* Use with format CMD_UPDATE, CMD_UPDATE_OPTION_CONFIG_FILE */
+#define HELP_LINE26		L"  Required if -%ls parameter is given with value %ls or %ls." /* Use with format CMD_UPDATE, CMD_UPDATE_OPTION_CONFIG_FILE, CMD_UPDATE_OPTION_PLAN */
 #define HELP_LINE27		L"  Cannot be used with -%ls, -%ls or -%ls parameter." /* Use with format CMD_INFO, CMD_FIRMWARE and CMD_TPM12_CLEAROWNERSHIP*/
 #define HELP_LINE28		L"\n-%ls [<log-file>]" /* Use with format CMD_LOG */
 #define HELP_LINE29		L"  Optional parameter. Activates logging for TPMFactoryUpd to the log file"
@@ -160,10 +193,31 @@
 #define HELP_LINE41		L"      with PCH TPM support)"
 #define HELP_LINE42		L"  3 - Linux TPM driver. The <path> option can be set to define a device path"
 #define HELP_LINE43		L"      (default value: /dev/tpm0)"
-#define HELP_LINE44		L"\n-%ls" /* use with format CMD_DRY_RUN */
-#define HELP_LINE45		L"  Optional parameter. Do everything except actually updating the image."
-#define HELP_LINE46		L"\n-%ls" /* use with format CMD_IGNORE_ERROR_ON_COMPLETE */
-#define HELP_LINE47		L"  Optional parameter. Ignores TPM_FAIL errors from FieldUpgradeComplete."
+#define HELP_LINE44		L"  4 - TPM simulator. Runs the tool against an in-process model of an Infineon"
+#define HELP_LINE45		L"      TPM2.0, configured in the [SIMULATOR] section of TPMFactoryUpd.cfg"
+#define HELP_LINE46		L"  5 - TPM simulator with TIS register level access (like 1, but against the"
+#define HELP_LINE47		L"      simulated TIS registers)"
+#define HELP_LINE48		L"\n-%ls" /* use with format CMD_DRY_RUN */
+#define HELP_LINE49		L"  Optional parameter. Do everything except actually updating the image."
+#define HELP_LINE50		L"\n-%ls" /* use with format CMD_IGNORE_ERROR_ON_COMPLETE */
+#define HELP_LINE51		L"  Optional parameter. Ignores TPM_FAIL errors from FieldUpgradeComplete."
+#define HELP_LINE52		L"\n-%ls <timing-file>" /* use with format CMD_TIMING */
+#define HELP_LINE53		L"  Optional parameter. Writes the duration of the update phases and the"
+#define HELP_LINE54		L"  latency statistics of all TPM commands and TPM state waits as JSON to <timing-file>."
+#define HELP_LINE55		L"\n-%ls <firmware-folder>" /* use with format CMD_BUILD_INDEX */
+#define HELP_LINE56		L"  Parses all firmware images in <firmware-folder> and writes the catalog index"
+#define HELP_LINE57		L"  used by -%ls %ls to select the firmware image. Does not access the TPM." /* use with format CMD_UPDATE, CMD_UPDATE_OPTION_CONFIG_FILE */
+#define HELP_LINE58		L"  Cannot be used with -%ls, -%ls, -%ls, -%ls, -%ls or -%ls parameter." /* use with format CMD_INFO, CMD_UPDATE, CMD_FIRMWARE, CMD_CONFIG, CMD_TPM12_CLEAROWNERSHIP and CMD_VERIFY_FOLDER */
+#define HELP_LINE59		L"   %ls - Like %ls, but updates over several firmware images if no single" /* use with format CMD_UPDATE_OPTION_PLAN, CMD_UPDATE_OPTION_CONFIG_FILE */
+#define HELP_LINE60		L"          image reaches the configured firmware version. Selects the plan with the"
+#define HELP_LINE61		L"          fewest updates from the catalog index of the firmware folder (see -%ls)" /* use with format CMD_BUILD_INDEX */
+#define HELP_LINE62		L"          and runs the updates in sequence. Requires the -config parameter."
+#define HELP_LINE63		L"\n-%ls <firmware-folder>" /* use with format CMD_VERIFY_FOLDER */
+#define HELP_LINE64		L"  Checks GUID, CRC, signature and firmware digest of all firmware images in"
+#define HELP_LINE65		L"  <firmware-folder> on one thread per processor. Does not access the TPM."
+#define HELP_LINE66		L"  Cannot be used with -%ls, -%ls, -%ls, -%ls, -%ls or -%ls parameter." /* use with format CMD_INFO, CMD_UPDATE, CMD_FIRMWARE, CMD_CONFIG, CMD_TPM12_CLEAROWNERSHIP and CMD_BUILD_INDEX */
+#define HELP_LINE67		L"\n-%ls <report-file>" /* use with format CMD_VERIFY_REPORT */
+#define HELP_LINE68		L"  Optional parameter. Writes the results of -%ls as JSON to <report-file>." /* use with format CMD_VERIFY_FOLDER */
 
 //{{NO_DEPENDENCIES}}
 // Microsoft Visual C++ generated include file.
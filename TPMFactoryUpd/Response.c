@@ -186,6 +186,20 @@ Response_Show(
 				unReturnValue = Response_ShowClearOwnership((IfxTpm12ClearOwnership*)PpHeader);
 				break;
 			}
+			case STRUCT_TYPE_BuildIndex:
+			{
+				LOGGING_WRITE_LEVEL4(L"Showing BuildIndex command output.");
+				// Show the build index response
+				unReturnValue = Response_ShowBuildIndex((IfxBuildIndex*)PpHeader);
+				break;
+			}
+			case STRUCT_TYPE_VerifyFolder:
+			{
+				LOGGING_WRITE_LEVEL4(L"Showing VerifyFolder command output.");
+				// Show the folder verification response
+				unReturnValue = Response_ShowVerifyFolder((IfxVerifyFolder*)PpHeader);
+				break;
+			}
 			default:
 			{
 				LOGGING_WRITE_LEVEL1(L"Skipped display of an unrecognized command.");
@@ -457,6 +471,31 @@ Response_ShowUpdate(
 					CONSOLEIO_WRITE_BREAK(FALSE, MENU_NEWLINE);
 					CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_TPM_USED_FIRMWARE_FILE, PpTpmUpdate->wszUsedFirmwareImage);
 				}
+				if (0 != PpTpmUpdate->sUpgradePlan.unHopCount)
+				{
+					unsigned int unHop = 0;
+					BOOL fDryRun = FALSE;
+
+					CONSOLEIO_WRITE_BREAK(FALSE, MENU_NEWLINE);
+					CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_TPM_UPDATE_PLAN, PpTpmUpdate->sUpgradePlan.unHopCount, (PpTpmUpdate->sUpgradePlan.unEstimatedSeconds + 59) / 60);
+					for (unHop = 0; unHop < PpTpmUpdate->sUpgradePlan.unHopCount; unHop++)
+					{
+						const IfxUpgradePlanHop* pHop = &PpTpmUpdate->sUpgradePlan.rgsHops[unHop];
+
+						CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_TPM_UPDATE_PLAN_HOP, unHop + 1,
+							pHop->bSourceTpmFamily == DEVICE_TYPE_TPM_12 ? RES_TPM_INFO_1_2 : RES_TPM_INFO_2_0, pHop->wszSourceVersion,
+							pHop->bTargetTpmFamily == DEVICE_TYPE_TPM_12 ? RES_TPM_INFO_1_2 : RES_TPM_INFO_2_0, pHop->wszTargetVersion,
+							pHop->fFactoryDefaults ? RES_TPM_UPDATE_PLAN_HOP_FACTORYDEFAULT : L"");
+						CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_TPM_UPDATE_PLAN_HOP_FILE, pHop->wszFileName);
+					}
+					if (RC_SUCCESS != unReturnValueWrite)
+						break;
+					if (PpTpmUpdate->sUpgradePlan.unHopCount > 1 &&
+							TRUE == PropertyStorage_GetBooleanValueByKey(PROPERTY_DRY_RUN, &fDryRun) && TRUE == fDryRun)
+					{
+						CONSOLEIO_WRITE_BREAK(FALSE, RES_TPM_UPDATE_PLAN_DRY_RUN);
+					}
+				}
 				break;
 			}
 			case STRUCT_SUBTYPE_PREPARE:
@@ -647,6 +686,152 @@ Response_ShowClearOwnership(
 	return unReturnValue;
 }
 
+/**
+ *	@brief		Show firmware catalog index build output
+ *	@details	Format the firmware catalog index build output and display
+ *
+ *	@param		PpBuildIndex			Pointer to a IfxBuildIndex response structure
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. PpBuildIndex was invalid.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Response_ShowBuildIndex(
+	_In_	const IfxBuildIndex* PpBuildIndex)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned int unReturnValueWrite = RC_SUCCESS;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		// Check parameters
+		if (NULL == PpBuildIndex || PpBuildIndex->unType != STRUCT_TYPE_BuildIndex)
+		{
+			LOGGING_WRITE_LEVEL1(L"Error while checking object PpBuildIndex: was invalid or NULL.");
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized (PpBuildIndex)");
+			break;
+		}
+
+		CONSOLEIO_WRITE_BREAK(FALSE, RES_BUILD_INDEX_INFORMATION);
+		CONSOLEIO_WRITE_BREAK(FALSE, RES_BUILD_INDEX_DASHED_LINE);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_BUILD_INDEX_FOLDER, PpBuildIndex->wszFolder);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_BUILD_INDEX_IMAGES, PpBuildIndex->unImageCount);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_BUILD_INDEX_SKIPPED, PpBuildIndex->unSkippedCount);
+		CONSOLEIO_WRITE_BREAK(FALSE, MENU_NEWLINE);
+		CONSOLEIO_WRITE_BREAK(FALSE, RES_BUILD_INDEX_SUCCESS);
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	// Check if a ConsoleIO_Write error occurred and no other error has occurred then store it
+	if (RC_SUCCESS == unReturnValue && RC_SUCCESS != unReturnValueWrite)
+	{
+		ERROR_STORE(unReturnValueWrite, L"ConsoleIO_Write returned an error");
+		unReturnValue = unReturnValueWrite;
+	}
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
+
+/**
+ *	@brief		Show firmware folder verification output
+ *	@details	Format the firmware folder verification summary and the result table and display
+ *
+ *	@param		PpVerifyFolder			Pointer to a IfxVerifyFolder response structure
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. PpVerifyFolder was invalid.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Response_ShowVerifyFolder(
+	_In_	const IfxVerifyFolder* PpVerifyFolder)
+{
+	unsigned int unReturnValue = RC_E_FAIL;
+	unsigned int unReturnValueWrite = RC_SUCCESS;
+
+	LOGGING_WRITE_LEVEL4(LOGGING_METHOD_ENTRY_STRING);
+
+	do
+	{
+		unsigned int unIndex = 0;
+
+		// Check parameters
+		if (NULL == PpVerifyFolder || PpVerifyFolder->unType != STRUCT_TYPE_VerifyFolder)
+		{
+			LOGGING_WRITE_LEVEL1(L"Error while checking object PpVerifyFolder: was invalid or NULL.");
+			unReturnValue = RC_E_BAD_PARAMETER;
+			ERROR_STORE(unReturnValue, L"Parameter not initialized (PpVerifyFolder)");
+			break;
+		}
+
+		CONSOLEIO_WRITE_BREAK(FALSE, RES_VERIFY_FOLDER_INFORMATION);
+		CONSOLEIO_WRITE_BREAK(FALSE, RES_VERIFY_FOLDER_DASHED_LINE);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_FOLDER, PpVerifyFolder->wszFolder);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_FILES, PpVerifyFolder->unResultCount);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_VALID, PpVerifyFolder->unValidCount);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_INVALID, PpVerifyFolder->unResultCount - PpVerifyFolder->unValidCount);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_THREADS, PpVerifyFolder->unThreadCount);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_DURATION, PpVerifyFolder->ullDurationUs / 1000);
+		if (L'\0' != PpVerifyFolder->wszReportFile[0])
+		{
+			CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_REPORT, PpVerifyFolder->wszReportFile);
+		}
+
+		if (0 != PpVerifyFolder->unResultCount)
+		{
+			CONSOLEIO_WRITE_BREAK(FALSE, MENU_NEWLINE);
+			CONSOLEIO_WRITE_BREAK(FALSE, RES_VERIFY_FOLDER_TABLE_HEADER);
+			CONSOLEIO_WRITE_BREAK(FALSE, RES_VERIFY_FOLDER_TABLE_LINE);
+		}
+		for (unIndex = 0; unIndex < PpVerifyFolder->unResultCount; unIndex++)
+		{
+			const IfxFolderVerifierResult* pResult = &PpVerifyFolder->rgsResults[unIndex];
+
+			if (RC_SUCCESS == pResult->unResult)
+			{
+				CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_ROW_VALID,
+					pResult->wszFileName,
+					DEVICE_TYPE_TPM_20 == pResult->bSourceTpmFamily ? L"2.0" : L"1.2",
+					DEVICE_TYPE_TPM_20 == pResult->bTargetTpmFamily ? L"2.0" : L"1.2",
+					pResult->wszTargetVersion);
+			}
+			else
+			{
+				CONSOLEIO_WRITE_BREAK_FMT(FALSE, RES_VERIFY_FOLDER_ROW_INVALID,
+					pResult->wszFileName,
+					NULL != pResult->pwszMessage ? pResult->pwszMessage : L"A newer version of the tool is required",
+					pResult->unResult);
+			}
+		}
+		if (RC_SUCCESS != unReturnValueWrite)
+			break;
+
+		unReturnValue = RC_SUCCESS;
+	}
+	WHILE_FALSE_END;
+
+	// Check if a ConsoleIO_Write error occurred and no other error has occurred then store it
+	if (RC_SUCCESS == unReturnValue && RC_SUCCESS != unReturnValueWrite)
+	{
+		ERROR_STORE(unReturnValueWrite, L"ConsoleIO_Write returned an error");
+		unReturnValue = unReturnValueWrite;
+	}
+
+	LOGGING_WRITE_LEVEL4_FMT(LOGGING_METHOD_EXIT_STRING_RET_VAL, unReturnValue);
+
+	return unReturnValue;
+}
+
 /**
  *	@brief		Show Unknown Action info
  *	@details	Displays the output for an unknown action to the console
@@ -1029,6 +1214,10 @@ Response_ShowHelp()
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE16, CMD_UPDATE_OPTION_TPM20_EMPTYPLATFORMAUTH);
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE17, CMD_UPDATE_OPTION_CONFIG_FILE);
 		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE18)
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE59, CMD_UPDATE_OPTION_PLAN, CMD_UPDATE_OPTION_CONFIG_FILE);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE60);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE61, CMD_BUILD_INDEX);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE62);
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE19, CMD_INFO, CMD_TPM12_CLEAROWNERSHIP);
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE20, CMD_FIRMWARE);
 		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE21);
@@ -1036,7 +1225,7 @@ Response_ShowHelp()
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE23, CMD_INFO, CMD_CONFIG, CMD_TPM12_CLEAROWNERSHIP);
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE24, CMD_CONFIG);
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE25, CMD_UPDATE, CMD_UPDATE_OPTION_CONFIG_FILE);
-		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE26, CMD_UPDATE, CMD_UPDATE_OPTION_CONFIG_FILE);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE26, CMD_UPDATE, CMD_UPDATE_OPTION_CONFIG_FILE, CMD_UPDATE_OPTION_PLAN);
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE27, CMD_INFO, CMD_FIRMWARE, CMD_TPM12_CLEAROWNERSHIP);
 		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE28, CMD_LOG);
 		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE29);
@@ -1055,11 +1244,28 @@ Response_ShowHelp()
 		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE41);
 		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE42);
 		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE43);
-#endif
-		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE44, CMD_DRY_RUN);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE44);
 		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE45);
-		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE46, CMD_IGNORE_ERROR_ON_COMPLETE);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE46);
 		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE47);
+#endif
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE48, CMD_DRY_RUN);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE49);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE50, CMD_IGNORE_ERROR_ON_COMPLETE);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE51);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE52, CMD_TIMING);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE53);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE54);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE55, CMD_BUILD_INDEX);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE56);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE57, CMD_UPDATE, CMD_UPDATE_OPTION_CONFIG_FILE);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE58, CMD_INFO, CMD_UPDATE, CMD_FIRMWARE, CMD_CONFIG, CMD_TPM12_CLEAROWNERSHIP, CMD_VERIFY_FOLDER);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE63, CMD_VERIFY_FOLDER);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE64);
+		CONSOLEIO_WRITE_BREAK(FALSE, HELP_LINE65);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE66, CMD_INFO, CMD_UPDATE, CMD_FIRMWARE, CMD_CONFIG, CMD_TPM12_CLEAROWNERSHIP, CMD_BUILD_INDEX);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE67, CMD_VERIFY_REPORT);
+		CONSOLEIO_WRITE_BREAK_FMT(FALSE, HELP_LINE68, CMD_VERIFY_FOLDER);
 	}
 	WHILE_FALSE_END;
 
@@ -81,6 +81,36 @@ unsigned int
 Response_ShowClearOwnership(
 	_In_	const IfxTpm12ClearOwnership* PpTpm12ClearOwnership);
 
+/**
+ *	@brief		Show firmware catalog index build output
+ *	@details	Format the firmware catalog index build output and display
+ *
+ *	@param		PpBuildIndex			Pointer to a IfxBuildIndex response structure
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. PpBuildIndex was invalid.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Response_ShowBuildIndex(
+	_In_	const IfxBuildIndex* PpBuildIndex);
+
+/**
+ *	@brief		Show firmware folder verification output
+ *	@details	Format the firmware folder verification summary and the result table and display
+ *
+ *	@param		PpVerifyFolder			Pointer to a IfxVerifyFolder response structure
+ *
+ *	@retval		RC_SUCCESS				The operation completed successfully.
+ *	@retval		RC_E_BAD_PARAMETER		An invalid parameter was passed to the function. PpVerifyFolder was invalid.
+ *	@retval		...						Error codes from called functions.
+ */
+_Check_return_
+unsigned int
+Response_ShowVerifyFolder(
+	_In_	const IfxVerifyFolder* PpVerifyFolder);
+
 /**
  *	@brief		Show Unknown Action info
  *	@details	Displays the output for an unknown action to the console
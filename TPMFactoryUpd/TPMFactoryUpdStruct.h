@@ -17,6 +17,8 @@
 #include "StdInclude.h"
 #include "FirmwareImage.h"
 #include "FirmwareUpdate.h"
+#include "UpgradePlanner.h"
+#include "FolderVerifier.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,7 +40,11 @@ typedef enum td_ENUM_STRUCT_TYPES
 	/// Structure tdTpmUpdate
 	STRUCT_TYPE_TpmUpdate,
 	/// Structure tdTpm12ClearOwnership
-	STRUCT_TYPE_Tpm12ClearOwnership
+	STRUCT_TYPE_Tpm12ClearOwnership,
+	/// Structure tdIfxBuildIndex
+	STRUCT_TYPE_BuildIndex,
+	/// Structure tdIfxVerifyFolder
+	STRUCT_TYPE_VerifyFolder
 } ENUM_STRUCT_TYPES;
 
 /**
@@ -74,7 +80,9 @@ typedef enum td_ENUM_UPDATE_TYPES
 	/// Update type for using settings from configuration file
 	UPDATE_TYPE_CONFIG_FILE = 4,
 	/// Update type for TPM1.2 using owner auth
-	UPDATE_TYPE_TPM12_OWNERAUTH = 5
+	UPDATE_TYPE_TPM12_OWNERAUTH = 5,
+	/// Update type for using settings from configuration file with an upgrade plan over several firmware images
+	UPDATE_TYPE_PLAN = 6
 } ENUM_UPDATE_TYPES;
 
 /**
@@ -161,14 +169,66 @@ typedef struct tdIfxUpdate
 	unsigned int					unFirmwareImageSize;
 	/// FirmwareImage pointer. The allocated memory must be freed after usage.
 	BYTE*							rgbFirmwareImage;
+	/// Parsed firmware image. Created once after loading rgbFirmwareImage and used by all checks and the update itself.
+	IfxParsedFirmwareImage			sParsedImage;
 	/// TPM2.0 Policy session handle
 	TPMI_SH_AUTH_SESSION			hPolicySession;
 	/// New firmware valid state
 	ENUM_GENERIC_TRISTATE			unNewFirmwareValid;
 	/// Used firmware image
 	wchar_t							wszUsedFirmwareImage[MAX_NAME];
+	/// Upgrade plan from the current firmware to the target firmware (only set for UPDATE_TYPE_PLAN)
+	IfxUpgradePlan					sUpgradePlan;
 } IfxUpdate;
 
+/**
+ *	@brief		Structure for the firmware catalog index build utilizing generic structure IfxToolHeader
+ *	@details
+ */
+typedef struct tdIfxBuildIndex
+{
+	/// Type of structure according to ENUM_STRUCT_TYPES
+	ENUM_STRUCT_TYPES		unType;
+	/// Size of complete structure
+	unsigned int			unSize;
+	/// Return code
+	unsigned int			unReturnCode;
+	/// Firmware folder
+	wchar_t					wszFolder[MAX_PATH];
+	/// Number of indexed firmware images
+	unsigned int			unImageCount;
+	/// Number of skipped files
+	unsigned int			unSkippedCount;
+} IfxBuildIndex;
+
+/**
+ *	@brief		Structure for the firmware folder verification utilizing generic structure IfxToolHeader
+ *	@details
+ */
+typedef struct tdIfxVerifyFolder
+{
+	/// Type of structure according to ENUM_STRUCT_TYPES
+	ENUM_STRUCT_TYPES		unType;
+	/// Size of complete structure
+	unsigned int			unSize;
+	/// Return code
+	unsigned int			unReturnCode;
+	/// Firmware folder
+	wchar_t					wszFolder[MAX_PATH];
+	/// Report file (empty if no report was requested)
+	wchar_t					wszReportFile[MAX_PATH];
+	/// Number of worker threads used
+	unsigned int			unThreadCount;
+	/// Duration of the verification in microseconds
+	unsigned long long		ullDurationUs;
+	/// Number of verified files
+	unsigned int			unResultCount;
+	/// Number of valid firmware images
+	unsigned int			unValidCount;
+	/// Verification results (allocated, free with Platform_MemoryFree)
+	IfxFolderVerifierResult*	rgsResults;
+} IfxVerifyFolder;
+
 #ifdef __cplusplus
 }
 #endif